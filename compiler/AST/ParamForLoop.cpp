@@ -21,12 +21,16 @@
 #include "ParamForLoop.h"
 
 #include "AstVisitor.h"
+#include "astutil.h"
 #include "build.h"
+#include "driver.h"
 #include "passes.h"
 #include "resolution.h"
 #include "resolveFunction.h"
 #include "stringutil.h"
 
+#include <cinttypes>
+
 /************************************ | *************************************
 *                                                                           *
 * Factory methods for the Parser                                            *
@@ -385,10 +389,12 @@ Expr* ParamForLoop::getNextExpr(Expr* expr)
    * continueSym is the symbol for the loop's continue label.
      This function will replace that with a new continue label
      local to this iteration.
+   * numCopies counts the stamped-out iterations, for the unroll-size
+     warning in foldForResolve().
 */
 static void copyBodyHelper(Expr* beforeHere, int64_t i,
                            SymbolMap* map, ParamForLoop* loop,
-                           Symbol* continueSym)
+                           Symbol* continueSym, int64_t* numCopies)
 {
   // Replace the continue label with a per-iteration label
   // that is at the end of that iteration.
@@ -401,6 +407,8 @@ static void copyBodyHelper(Expr* beforeHere, int64_t i,
   map->put(continueSym, continueLabel);
 
   defContinueLabel->insertBefore(loop->copyBody(map));
+
+  (*numCopies)++;
 }
 
 CallExpr* ParamForLoop::foldForResolve()
@@ -416,6 +424,7 @@ CallExpr* ParamForLoop::foldForResolve()
   Type*        idxType = indexType();
 
   bool emptyLoop = true;
+  int64_t numCopies = 0;
   Symbol*      continueSym = continueLabelGet();
 
   if (!is_enum_type(idxType)) {
@@ -443,7 +452,7 @@ CallExpr* ParamForLoop::foldForResolve()
         SymbolMap map;
 
         map.put(idxSym, new_IntSymbol(i, idxSize));
-        copyBodyHelper(noop, i, &map, this, continueSym);
+        copyBodyHelper(noop, i, &map, this, continueSym, &numCopies);
         emptyLoop = false;
       }
     }
@@ -454,7 +463,7 @@ CallExpr* ParamForLoop::foldForResolve()
         SymbolMap map;
 
         map.put(idxSym, new_IntSymbol(i, idxSize));
-        copyBodyHelper(noop, i, &map, this, continueSym);
+        copyBodyHelper(noop, i, &map, this, continueSym, &numCopies);
         emptyLoop = false;
       }
     }
@@ -479,7 +488,7 @@ CallExpr* ParamForLoop::foldForResolve()
           map.put(idxSym, new_UIntSymbol(i, idxSize));
         }
 
-        copyBodyHelper(noop, i, &map, this, continueSym);
+        copyBodyHelper(noop, i, &map, this, continueSym, &numCopies);
         emptyLoop = false;
       }
     }
@@ -495,7 +504,7 @@ CallExpr* ParamForLoop::foldForResolve()
           map.put(idxSym, new_UIntSymbol(i, idxSize));
         }
 
-        copyBodyHelper(noop, i, &map, this, continueSym);
+        copyBodyHelper(noop, i, &map, this, continueSym, &numCopies);
         emptyLoop = false;
       }
     }
@@ -552,7 +561,7 @@ CallExpr* ParamForLoop::foldForResolve()
             SymbolMap map;
 
             map.put(idxSym, constant->sym);
-            copyBodyHelper(noop, i, &map, this, continueSym);
+            copyBodyHelper(noop, i, &map, this, continueSym, &numCopies);
             emptyLoop = false;
           }
 
@@ -582,7 +591,7 @@ CallExpr* ParamForLoop::foldForResolve()
             SymbolMap map;
 
             map.put(idxSym, constant->sym);
-            copyBodyHelper(noop, i, &map, this, continueSym);
+            copyBodyHelper(noop, i, &map, this, continueSym, &numCopies);
             emptyLoop = false;
           }
 
@@ -604,6 +613,26 @@ CallExpr* ParamForLoop::foldForResolve()
   if (emptyLoop)
     addMentionToEndOfStatement(this, NULL);
 
+  // Param loops must be fully unrolled -- each copy needs its param
+  // index -- so all we can do about a huge expansion is point at it.
+  if (param_loop_unroll_limit > 0 && numCopies > 0) {
+    std::vector<BaseAST*> asts;
+
+    collect_asts(this, asts);
+
+    int64_t expansion = numCopies * (int64_t) asts.size();
+
+    if (expansion > param_loop_unroll_limit) {
+      USR_WARN(this,
+               "param loop unrolls %" PRId64 " copies of its body "
+               "(~%" PRId64 " AST nodes, limit %d); consider a non-param "
+               "loop or a smaller range",
+               numCopies,
+               expansion,
+               param_loop_unroll_limit);
+    }
+  }
+
   // Remove the "insertion marker"
   noop->remove();
 
@@ -674,6 +674,7 @@ void parent_insert_help(BaseAST* parent, Expr* ast) {
 void insert_help(BaseAST* ast,
                  Expr* parentExpr,
                  Symbol* parentSymbol) {
+  markVerifyDirty(parentSymbol);
   if (Symbol* sym = toSymbol(ast)) {
     parentSymbol = sym;
     parentExpr = NULL;
@@ -695,7 +696,10 @@ void insert_help(BaseAST* ast,
 
 
 void remove_help(BaseAST* ast, int trace_flag) {
+  if (Expr* expr = toExpr(ast))
+    markVerifyDirty(expr->parentSymbol);
   trace_remove(ast, trace_flag);
+  noteRemovedForClean(ast);
   AST_CHILDREN_CALL(ast, remove_help, trace_flag);
   if (Expr* expr = toExpr(ast)) {
     if (SymExpr* se = toSymExpr(expr)) {
@@ -1121,6 +1125,26 @@ prune() {
 // Done this way to make the pass name for each pass unique.
 void prune2() { prune(); } // Synonym for prune.
 
+
+// A final, functions-only prune just before code generation.  The
+// passes that run after prune2 (wide-reference insertion, on-clause
+// optimization, denormalization, ...) can leave functions with no
+// remaining callers, and every function still in the tree gets emitted
+// and handed to the backend compiler and linker.  Type removal is
+// deliberately skipped this late: by now some types are referenced
+// from codegen itself rather than from the AST.
+void prune3() {
+  Vec<FnSymbol*> fns;     // This receives the set of used functions.
+  Vec<TypeSymbol*> types; // This receives the set of used types.
+
+  visitVisibleFunctions(fns, types);
+
+  forv_Vec(FnSymbol, fn, gFnSymbols) {
+    if (!fns.set_in(fn))
+      fn->defPoint->remove();
+  }
+}
+
 /*
  * Takes a call that is a PRIM_SVEC_GET_MEMBER* and returns the symbol of the
  * field. Normally the call is something of the form PRIM_SVEC_GET_MEMBER(p, 0)
@@ -20,6 +20,7 @@
 
 #include "baseAST.h"
 
+#include "arena.h"
 #include "astutil.h"
 #include "CForLoop.h"
 #include "CatchStmt.h"
@@ -39,6 +40,7 @@
 #include "passes.h"
 #include "runpasses.h"
 #include "scopeResolve.h"
+#include "stlUtil.h"
 #include "stmt.h"
 #include "stringutil.h"
 #include "symbol.h"
@@ -47,8 +49,10 @@
 #include "WhileStmt.h"
 
 #include <ostream>
+#include <set>
 #include <sstream>
 #include <string>
+#include <vector>
 
 //
 // declare global vectors gSymExprs, gCallExprs, gFnSymbols, ...
@@ -56,8 +60,51 @@
 #define decl_gvecs(type) Vec<type*> g##type##s
 foreach_ast(decl_gvecs);
 
+//
+// generational state for cleanAst(): between sweeps the global
+// vectors only grow, so every node below the previous sweep's
+// watermark was alive when last scanned.  Such a node can only have
+// died since if remove_help() -- the funnel all tree removal goes
+// through, which visits every node of a removed subtree -- saw a node
+// of its type, so when the per-type removal count is zero we scan
+// just the suffix of nodes allocated since the last sweep.  In-place
+// mutations that bypass the funnel cannot kill a node, since
+// isAlive() is purely a property of tree membership.
+//
+#define decl_genstate(type)                     \
+  static int cleanWatermark##type = 0;          \
+  static int removedSinceClean##type = 0
+foreach_ast(decl_genstate);
+
+void noteRemovedForClean(BaseAST* ast) {
+  switch (ast->astTag) {
+    #define case_note_removed(type)             \
+      case E_##type:                            \
+        removedSinceClean##type++;              \
+        break
+    foreach_ast(case_note_removed);
+    #undef case_note_removed
+    default:
+      break;
+  }
+}
+
 static int uid = 1;
 
+//
+// the arena all BaseAST nodes are allocated from; see the comments on
+// BaseAST::operator new in baseAST.h
+//
+static Arena astArena;
+
+void* BaseAST::operator new(size_t size) {
+  return astArena.allocate(size);
+}
+
+void BaseAST::operator delete(void* ptr) {
+  // arena storage is reclaimed in bulk by destroyAst()
+}
+
 #define decl_counters(type)                                             \
   int n##type = g##type##s.n, k##type = n##type*sizeof(type)/1024
 
@@ -201,8 +248,11 @@ void trace_remove(BaseAST* ast, char flag) {
 }
 
 #define clean_gvec(type)                        \
-  int i##type = 0;                              \
-  forv_Vec(type, ast, g##type##s) {             \
+  int i##type = (removedSinceClean##type == 0)  \
+                ? cleanWatermark##type : 0;     \
+  for (int j##type = i##type;                   \
+       j##type < g##type##s.n; j##type++) {     \
+    type* ast = g##type##s.v[j##type];          \
     if (isAlive(ast) || isRootModuleWithType(ast, type)) { \
       g##type##s.v[i##type++] = ast;            \
     } else {                                    \
@@ -212,7 +262,9 @@ void trace_remove(BaseAST* ast, char flag) {
       delete ast; ast = 0;                      \
     }                                           \
   }                                             \
-  g##type##s.n = i##type
+  g##type##s.n = i##type;                       \
+  removedSinceClean##type = 0;                  \
+  cleanWatermark##type = i##type
 
 
 static void clean_modvec(Vec<ModuleSymbol*>& modvec) {
@@ -301,14 +353,64 @@ void destroyAst() {
       delete ast;                               \
     }
   foreach_ast(destroy_gvec);
+
+  // all nodes are destructed now; release the arena in one shot
+  astArena.clear();
+}
+
+
+//
+// Incremental --verify support.  insert_help()/remove_help() are the
+// funnels all tree restructuring goes through; they report the
+// enclosing symbol here, and with --incremental-verify we re-verify
+// only the subtrees of symbols dirtied since the last verification
+// instead of walking every live node after every pass.  Mutations that
+// bypass those helpers (direct field writes) are not caught, which is
+// why plain --verify keeps the full walk.
+//
+static std::set<Symbol*> verifyDirtySyms;
+static Symbol* lastVerifyDirtySym = NULL;
+
+void markVerifyDirty(Symbol* sym) {
+  if (!fVerify || !fIncrementalVerify || sym == NULL)
+    return;
+
+  // removals and insertions dirty the same symbol many times in a row
+  if (sym == lastVerifyDirtySym)
+    return;
+
+  lastVerifyDirtySym = sym;
+  verifyDirtySyms.insert(sym);
 }
 
+static void verifyDirtySubtrees() {
+  for_set(Symbol, sym, verifyDirtySyms) {
+    if (isAlive(sym) && sym->defPoint != NULL && sym->defPoint->inTree()) {
+      std::vector<BaseAST*> asts;
+      collect_asts(sym->defPoint, asts);
+      for_vector(BaseAST, ast, asts) {
+        ast->verify();
+      }
+    }
+  }
+
+  verifyDirtySyms.clear();
+  lastVerifyDirtySym = NULL;
+}
 
 void
 verify() {
   verifyRemovedIterResumeGotos();
   verifyCopiedIterResumeGotos();
 
+  if (fIncrementalVerify) {
+    verifyDirtySubtrees();
+
+    // rootModule is cheap to verify and easy to miss via the hooks
+    rootModule->verify();
+    return;
+  }
+
   #define verify_gvec(type)                       \
     forv_Vec(type, ast, g##type##s) {             \
      if (isAlive(ast)) {                          \
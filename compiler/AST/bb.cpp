@@ -619,45 +619,98 @@ void BasicBlock::computeBackwardOrder(FnSymbol* fn,
   }
 }
 
+// Seed the worklist queue with every basic block, visiting them in 'seed'
+// order first. 'seed' comes from computeForwardOrder()/computeBackwardOrder(),
+// which only number reachable blocks, so it may contain duplicates and omit
+// some ids; the bbs bitset screens the former and the trailing loop adds
+// the latter.
+static void seedFlowWorkQueue(size_t nbbq, std::vector<int>& seed,
+                              std::vector<int>& bbq, BitVec& bbs) {
+  for (size_t k = 0; k < seed.size(); k++) {
+    int i = seed[k];
+
+    if (!bbs.get(i)) {
+      bbq.push_back(i);
+      bbs.set(i);
+    }
+  }
+
+  for (size_t i = 0; i < nbbq; i++) {
+    if (!bbs.get(i)) {
+      bbq.push_back(i);
+      bbs.set(i);
+    }
+  }
+}
+
 //#define DEBUG_FLOW
 void BasicBlock::backwardFlowAnalysis(FnSymbol*             fn,
                                       std::vector<BitVec*>& GEN,
                                       std::vector<BitVec*>& KILL,
                                       std::vector<BitVec*>& IN,
                                       std::vector<BitVec*>& OUT) {
-  bool iterate = true;
+  size_t           nbbq = fn->basicBlocks->size(); // size of bb queue
+  std::vector<int> seed;
+  std::vector<int> bbq;
+  BitVec           bbs(nbbq);
+  int              iq = -1;
+  int              nq = nbbq - 1;
 
-  while (iterate) {
-    int i = 0;
+  // Visit successors before predecessors, so that most OUT sets are
+  // complete the first time their block is processed.
+  computeBackwardOrder(fn, seed);
+  seedFlowWorkQueue(nbbq, seed, bbq, bbs);
 
-    iterate = false;
+  while (iq != nq) {
+    iq = (iq + 1) % nbbq;
 
-    for_vector(BasicBlock, bb, *fn->basicBlocks) {
-      for (size_t j = 0; j < IN[i]->ndata; j++) {
-        unsigned int new_in  = (OUT[i]->data[j] & ~KILL[i]->data[j]) | GEN[i]->data[j];
-        unsigned int new_out = 0;
+    int i = bbq[iq];
 
-        if (new_in != IN[i]->data[j]) {
-          IN[i]->data[j] = new_in;
-          iterate = true;
-        }
+    bbs.unset(i);
+
+#ifdef DEBUG_FLOW
+    if (iq == 0) {
+      printf("IN\n");  printBitVectorSets(IN);
+      printf("OUT\n"); printBitVectorSets(OUT);
+    }
+#endif
+
+    BasicBlock* bb     = (*fn->basicBlocks)[i];
+    bool        change = false;
+
+    for (size_t j = 0; j < IN[i]->ndata; j++) {
+      if (bb->outs.size() > 0) {
+        unsigned int new_out = 0;
 
         for_vector(BasicBlock, bbout, bb->outs) {
-          new_out = new_out | IN[bbout->id]->data[j];
+          new_out |= IN[bbout->id]->data[j];
         }
 
         if (new_out != OUT[i]->data[j]) {
           OUT[i]->data[j] = new_out;
-          iterate = true;
+          change          = true;
         }
       }
 
-      i++;
+      unsigned int new_in = (OUT[i]->data[j] & ~KILL[i]->data[j]) | GEN[i]->data[j];
+
+      if (new_in != IN[i]->data[j]) {
+        IN[i]->data[j] = new_in;
+        change         = true;
+      }
+    }
+
+    if (change) {
+      for_vector(BasicBlock, bbin, bb->ins) {
+        if (!bbs.get(bbin->id)) {
+          nq      = (nq + 1) % nbbq;
+
+          bbs.set(bbin->id);
+
+          bbq[nq] = bbin->id;
+        }
+      }
     }
-#ifdef DEBUG_FLOW
-    printf("IN\n");  printBitVectorSets(IN);
-    printf("OUT\n"); printBitVectorSets(OUT);
-#endif
   }
 }
 
@@ -669,15 +722,16 @@ void BasicBlock::forwardFlowAnalysis(FnSymbol*             fn,
                                      std::vector<BitVec*>& OUT,
                                      bool                  intersect) {
   size_t           nbbq = fn->basicBlocks->size(); // size of bb queue
+  std::vector<int> seed;
   std::vector<int> bbq;
   BitVec           bbs(nbbq);
   int              iq = -1;
   int              nq = nbbq - 1;
 
-  for (size_t i = 0; i < nbbq; i++) {
-    bbq.push_back(i);
-    bbs.set(i);
-  }
+  // Visit predecessors before successors, so that most IN sets are
+  // complete the first time their block is processed.
+  computeForwardOrder(fn, seed);
+  seedFlowWorkQueue(nbbq, seed, bbq, bbs);
 
   while (iq != nq) {
     iq = (iq + 1) % nbbq;
@@ -720,6 +720,9 @@ initPrimitive() {
   // like PRIM_ASSIGN but the operation can be put off until end of
   // the enclosing task or forall.
   prim_def(PRIM_UNORDERED_ASSIGN, "unordered=", returnInfoVoid, true, true);
+  // like PRIM_ASSIGN but a remote read may yield to other tasks while
+  // it waits for the data to arrive.
+  prim_def(PRIM_YIELDING_ASSIGN, "yielding=", returnInfoVoid, true, true);
 
   prim_def(PRIM_ADD_ASSIGN, "+=", returnInfoVoid, true);
   prim_def(PRIM_SUBTRACT_ASSIGN, "-=", returnInfoVoid, true);
@@ -1033,6 +1036,10 @@ initPrimitive() {
   prim_def(PRIM_RT_ERROR, "chpl_error", returnInfoVoid, true, true);
   prim_def(PRIM_RT_WARNING, "chpl_warning", returnInfoVoid, true, true);
 
+  // Instrumentation hooks emitted around foralls by --instrument-foralls
+  prim_def(PRIM_FORALL_ENTER, "chpl_forall_enter", returnInfoVoid, true, true);
+  prim_def(PRIM_FORALL_EXIT, "chpl_forall_exit", returnInfoVoid, true, true);
+
   prim_def(PRIM_NEW_PRIV_CLASS, "chpl_newPrivatizedClass", returnInfoVoid);
 
   prim_def(PRIM_GET_USER_LINE, "_get_user_line", returnInfoDefaultInt, true, true);
@@ -1105,6 +1112,18 @@ initPrimitive() {
   prim_def(PRIM_GET_COMPILER_VAR, "get compiler variable", returnInfoString);
   prim_def(PRIM_GET_VISIBLE_SYMBOLS, "get visible symbols", returnInfoVoid);
 
+  // Compile-time writef() format compilation.  Given a format string,
+  // "writef format ok" folds to whether the compiler can break it into
+  // segments (it must be a param and use only conversions the scanner
+  // knows); "writef format count" folds to the number of segments; and
+  // "writef format segment" (format, idx) folds to segment idx, which
+  // is either literal text or one conversion specifier starting with
+  // '%'.  writef uses these to unroll a param format into typed writes
+  // and falls back to the runtime format interpreter otherwise.
+  prim_def(PRIM_WRITEF_FMT_OK, "writef format ok", returnInfoBool);
+  prim_def(PRIM_WRITEF_FMT_COUNT, "writef format count", returnInfoDefaultInt);
+  prim_def(PRIM_WRITEF_FMT_SEGMENT, "writef format segment", returnInfoString);
+
   // Allocate a class instance on the stack (where normally it
   // would be allocated on the heap). The only argument is the class type.
   prim_def(PRIM_STACK_ALLOCATE_CLASS, "stack allocate class", returnInfoFirst);
@@ -253,33 +253,11 @@ BlockStmt* Symbol::getDeclarationScope() const {
 }
 
 
-bool Symbol::hasFlag(Flag flag) const {
-  CHECK_FLAG(flag);
-  return flags[flag];
-}
-
-
-void Symbol::addFlag(Flag flag) {
-  CHECK_FLAG(flag);
-  flags.set(flag);
-}
-
-
 void Symbol::copyFlags(const Symbol* other) {
   flags |= other->flags;
   qual   = other->qual;
 }
 
-
-void Symbol::removeFlag(Flag flag) {
-  CHECK_FLAG(flag);
-  flags.reset(flag);
-}
-
-bool Symbol::hasEitherFlag(Flag aflag, Flag bflag) const {
-  return hasFlag(aflag) || hasFlag(bflag);
-}
-
 bool Symbol::isKnownToBeGeneric() {
   if (FnSymbol* fn = toFnSymbol(this))
     return fn->isGenericIsValid() && fn->isGeneric();
@@ -2097,13 +2075,9 @@ void resetTempID() {
 }
 
 FlagSet getRecordWrappedFlags(Symbol* s) {
-  static FlagSet mask;
-  if (mask.none()) {
-    // Initialize the function-scope static variable.
-    mask.set(FLAG_ARRAY);
-    mask.set(FLAG_DOMAIN);
-    mask.set(FLAG_DISTRIBUTION);
-  }
+  static constexpr FlagSet mask = makeFlagSet(FLAG_ARRAY,
+                                              FLAG_DOMAIN,
+                                              FLAG_DISTRIBUTION);
 
   return s->flags & mask;
 }
@@ -92,8 +92,12 @@ FnSymbol *gChplBuildLocaleId;
 
 
 void gatherIteratorTags() {
+  // Symbol names are astrs, so once the name we're looking for is an
+  // astr too a pointer comparison suffices.
+  const char* astrIterKind = astr(iterKindTypename);
+
   forv_Vec(TypeSymbol, ts, gTypeSymbols) {
-    if (strcmp(ts->name, iterKindTypename) == 0) {
+    if (ts->name == astrIterKind) {
       if (EnumType* enumType = toEnumType(ts->type)) {
         for_alist(expr, enumType->constants) {
           if (DefExpr* def = toDefExpr(expr)) {
@@ -110,6 +114,8 @@ void gatherIteratorTags() {
             }
           }
         }
+
+        return;
       }
     }
   }
@@ -544,6 +550,8 @@ void gatherWellKnownFns() {
 
           *wkfn.fn = fn;
         }
+
+        break; // the entries' names are distinct, so this fn is done
       }
     }
   }
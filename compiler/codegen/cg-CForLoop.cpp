@@ -301,6 +301,10 @@ std::string CForLoop::codegenCForLoopHeader(BlockStmt* block)
   GenInfo*    info = gGenInfo;
   std::string seg  = "";
 
+  // We pop codegenned statements back off of cStatements below, so the
+  // buffers must not spill to disk out from under us.
+  ++gCStatementsPinned;
+
   for_alist(expr, block->body)
   {
     CallExpr* call = toCallExpr(expr);
@@ -368,6 +372,8 @@ std::string CForLoop::codegenCForLoopHeader(BlockStmt* block)
     }
   }
 
+  --gCStatementsPinned;
+
   // replace all the semicolons (from "statements") with commas
   std::replace(seg.begin(), seg.end(), ';', ',');
 
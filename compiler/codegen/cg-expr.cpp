@@ -406,13 +406,21 @@ GenRet codegenWideAddr(GenRet locale, GenRet raddr, Type* wideType = NULL)
     // of the appropriate type.
     ret = createTempVar(wideRefType);
     if( info->cfile ) {
-      std::string localeAssign;
-      std::string addrAssign;
       ret = codegenValue(ret); // remove the & part.
-      localeAssign = ret.c + ".locale = " + locale.c + ";\n";
-      info->cStatements.push_back(localeAssign);
-      addrAssign = ret.c + ".addr = " + raddr.c + ";\n";
-      info->cStatements.push_back(addrAssign);
+      if (fWidePtrNodeBits > 0) {
+        std::string packAssign;
+        packAssign = ret.c + " = chpl_wide_ptr_pack(" + locale.c +
+                     ", (void*)(" + raddr.c + "), " +
+                     istr(fWidePtrNodeBits) + ");\n";
+        info->cStatements.push_back(packAssign);
+      } else {
+        std::string localeAssign;
+        std::string addrAssign;
+        localeAssign = ret.c + ".locale = " + locale.c + ";\n";
+        info->cStatements.push_back(localeAssign);
+        addrAssign = ret.c + ".addr = " + raddr.c + ";\n";
+        info->cStatements.push_back(addrAssign);
+      }
     } else {
 #ifdef HAVE_LLVM
       llvm::Value* adr = info->irBuilder->CreateStructGEP(
@@ -696,9 +704,9 @@ GenRet codegenLocaleForNode(GenRet node)
 static
 GenRet codegenUseCid(Type* classType)
 {
-  std::string varname;
-  varname = varname + "chpl__cid_" + classType->symbol->cname;
-  GenRet ret = codegenUseGlobal(varname.c_str());
+  // Use an interned name so that repeated references to the same cid
+  // don't each build a fresh std::string.
+  GenRet ret = codegenUseGlobal(astr("chpl__cid_", classType->symbol->cname));
   ret.chplType = CLASS_ID_TYPE;
   return ret;
 }
@@ -733,12 +741,6 @@ GenRet codegenGetLocaleID(void)
 }
 
 
-static
-GenRet codegenUseGlobal(std::string str)
-{
-  return codegenUseGlobal(str.c_str());
-}
-
 static
 GenRet codegenWideHere(GenRet addr, Type* wideType = NULL)
 {
@@ -824,6 +826,16 @@ static GenRet codegenCastWideToVoid(GenRet wide) {
 //
 // Works for wide strings or wide pointers.
 //
+// With --packed-wide-pointers a wide pointer is a single 64-bit word with
+// no addressable parts; produce the r-value expression for it so that its
+// parts can be extracted by the runtime's unpacking functions.
+static std::string codegenPackedWideVal(GenRet ws)
+{
+  if (ws.isLVPtr == GEN_PTR)
+    return "*(" + ws.c + ")";
+  return ws.c;
+}
+
 // field is WIDE_GEP_LOC, WIDE_GEP_ADDR
 static GenRet codegenWideThingField(GenRet ws, WideThingField field)
 {
@@ -845,7 +857,20 @@ static GenRet codegenWideThingField(GenRet ws, WideThingField field)
   const char* fname = wide_fields[field];
 
   if( info->cfile ) {
-    if (ws.isLVPtr == GEN_PTR) {
+    if (fWidePtrNodeBits > 0) {
+      // Packed wide pointers have no addressable parts; extract the
+      // requested part as an r-value instead.
+      ret.isLVPtr = GEN_VAL;
+      if( field == WIDE_GEP_LOC ) {
+        ret.c = "chpl_wide_ptr_get_localeID_packed(" +
+                codegenPackedWideVal(ws) + ", " +
+                istr(fWidePtrNodeBits) + ")";
+      } else {
+        ret.c = "chpl_wide_ptr_get_address_packed(" +
+                codegenPackedWideVal(ws) + ", " +
+                istr(fWidePtrNodeBits) + ")";
+      }
+    } else if (ws.isLVPtr == GEN_PTR) {
       ret.isLVPtr = GEN_PTR;
       ret.c += "&((" + ws.c + ")->" + fname + ")";
     } else {
@@ -903,6 +928,10 @@ GenRet codegenRaddr(GenRet wide)
 
   if( !fLLVMWideOpt ) {
     ret = codegenValue(codegenWideThingField(wide, WIDE_GEP_ADDR));
+    if (fWidePtrNodeBits > 0 && gGenInfo->cfile) {
+      // The unpacking function returns a void*; cast to the right type.
+      ret = codegenCast(type, ret);
+    }
   } else {
 #ifdef HAVE_LLVM
     GenInfo* info = gGenInfo;
@@ -954,10 +983,19 @@ static GenRet codegenRnode(GenRet wide){
   Type* type = NODE_ID_TYPE;
 
   if( !fLLVMWideOpt ) {
-    ret = codegenCallExpr("chpl_nodeFromLocaleID",
-                          codegenValue(
-                              codegenWideThingField(wide, WIDE_GEP_LOC)),
-                          /*ln*/codegenZero(), /*fn*/codegenZero32());
+    if (fWidePtrNodeBits > 0 && gGenInfo->cfile) {
+      // Get the node id straight from the packed pointer, without
+      // building an intermediate locale id.
+      ret.isLVPtr = GEN_VAL;
+      ret.c = "chpl_wide_ptr_get_node_packed(" +
+              codegenPackedWideVal(wide) + ", " +
+              istr(fWidePtrNodeBits) + ")";
+    } else {
+      ret = codegenCallExpr("chpl_nodeFromLocaleID",
+                            codegenValue(
+                                codegenWideThingField(wide, WIDE_GEP_LOC)),
+                            /*ln*/codegenZero(), /*fn*/codegenZero32());
+    }
   } else {
 #ifdef HAVE_LLVM
     Type* wideRefType = NULL;
@@ -3321,6 +3359,106 @@ GenRet codegenCastPtrToInt(Type* toType, GenRet value)
 }
 */
 
+//
+// Generate the call into the comm layer for the GET or PUT half of an
+// assignment involving one wide pointer.
+//
+static
+void codegenCommCall(bool isGet, GenRet to_ptr, GenRet from, Type* type)
+{
+  GenInfo* info = gGenInfo;
+  if (isGet) {
+    codegenCall("chpl_gen_comm_get",
+                codegenCastToVoidStar(to_ptr),
+                codegenRnode(from),
+                codegenRaddr(from),
+                codegenSizeof(type),
+                genCommID(info),
+                info->lineno, gFilenameLookupCache[info->filename]);
+  } else {
+    codegenCall("chpl_gen_comm_put",
+                codegenCastToVoidStar(codegenValuePtr(from)),
+                codegenRnode(to_ptr),
+                codegenRaddr(to_ptr),
+                codegenSizeof(type),
+                genCommID(info),
+                info->lineno, gFilenameLookupCache[info->filename]);
+  }
+}
+
+//
+// The node-local equivalent of the same GET or PUT: a plain copy
+// through the wide pointer's address field.
+//
+static
+void codegenCommLocalCopy(bool isGet, GenRet to_ptr, GenRet from, Type* type)
+{
+  if (isGet)
+    codegenCopy(to_ptr, codegenDeref(codegenRaddr(from)), type);
+  else
+    codegenCopy(codegenDeref(codegenRaddr(to_ptr)), from, type);
+}
+
+//
+// Generate the GET or PUT for codegenAssign().  Under
+// --comm-local-fast-path we first emit an inline test comparing the
+// wide pointer's node against chpl_nodeID and perform a direct copy
+// when they match, only falling into the comm layer for genuinely
+// remote accesses.  Most wide dereferences in balanced codes turn out
+// to be node-local, so the remote branch is marked unlikely; this
+// recovers most of the cost of wide pointers without requiring 'local'
+// blocks around the accesses.
+//
+static
+void codegenCommAssign(bool isGet, GenRet to_ptr, GenRet from, Type* type)
+{
+  GenInfo* info = gGenInfo;
+
+  if (!fCommLocalFastPath) {
+    codegenCommCall(isGet, to_ptr, from, type);
+    return;
+  }
+
+  GenRet wide = isGet ? from : to_ptr;
+  GenRet isLocal = codegenEquals(codegenRnode(wide), codegenGetNodeID());
+
+  if (info->cfile) {
+    info->cStatements.push_back("if " + isLocal.c + " {\n");
+    codegenCommLocalCopy(isGet, to_ptr, from, type);
+    info->cStatements.push_back("} else {\n");
+    codegenCommCall(isGet, to_ptr, from, type);
+    info->cStatements.push_back("}\n");
+  } else {
+#ifdef HAVE_LLVM
+    llvm::Function* func = info->irBuilder->GetInsertBlock()->getParent();
+
+    llvm::BasicBlock* blockLocal = llvm::BasicBlock::Create(
+        info->module->getContext(), "commLocal");
+    llvm::BasicBlock* blockRemote = llvm::BasicBlock::Create(
+        info->module->getContext(), "commRemote");
+    llvm::BasicBlock* blockDone = llvm::BasicBlock::Create(
+        info->module->getContext(), "commDone");
+
+    info->irBuilder->CreateCondBr(
+        isLocal.val, blockLocal, blockRemote,
+        info->mdBuilder->createBranchWeights(/*local*/ 100, /*remote*/ 1));
+
+    func->getBasicBlockList().push_back(blockLocal);
+    info->irBuilder->SetInsertPoint(blockLocal);
+    codegenCommLocalCopy(isGet, to_ptr, from, type);
+    info->irBuilder->CreateBr(blockDone);
+
+    func->getBasicBlockList().push_back(blockRemote);
+    info->irBuilder->SetInsertPoint(blockRemote);
+    codegenCommCall(isGet, to_ptr, from, type);
+    info->irBuilder->CreateBr(blockDone);
+
+    func->getBasicBlockList().push_back(blockDone);
+    info->irBuilder->SetInsertPoint(blockDone);
+#endif
+  }
+}
+
 // Generates code to perform an "assignment" operation, given
 //  a destination pointer and a value.
 // That's basically
@@ -3472,13 +3610,7 @@ void codegenAssign(GenRet to_ptr, GenRet from)
           // Make sure that from is a pointer
           codegenCopy(to_ptr, from, type);
         } else {
-          codegenCall("chpl_gen_comm_get",
-                      codegenCastToVoidStar(to_ptr),
-                      codegenRnode(from),
-                      codegenRaddr(from),
-                      codegenSizeof(type),
-                      genCommID(info),
-                      info->lineno, gFilenameLookupCache[info->filename]);
+          codegenCommAssign(/*isGet*/ true, to_ptr, from, type);
         }
       }
     } else { // PUT
@@ -3494,13 +3626,7 @@ void codegenAssign(GenRet to_ptr, GenRet from)
           // Make sure that from is a pointer
           codegenCopy(to_ptr, from, type);
         } else {
-          codegenCall("chpl_gen_comm_put",
-                      codegenCastToVoidStar(codegenValuePtr(from)),
-                      codegenRnode(to_ptr),
-                      codegenRaddr(to_ptr),
-                      codegenSizeof(type),
-                      genCommID(info),
-                      info->lineno, gFilenameLookupCache[info->filename]);
+          codegenCommAssign(/*isGet*/ false, to_ptr, from, type);
         }
       }
     }
@@ -3528,9 +3654,10 @@ void codegenOpAssign(GenRet a, GenRet b, const char* op,
 
   // deref 'a' if it is a 'ref' argument
   GenRet ap;
-  if (a.chplType->symbol->hasFlag(FLAG_REF) ||
-      a.chplType->symbol->hasFlag(FLAG_WIDE_REF) ||
-      a.chplType->symbol->hasFlag(FLAG_WIDE_CLASS)) {
+  static constexpr FlagSet refOrWideFlags = makeFlagSet(FLAG_REF,
+                                                        FLAG_WIDE_REF,
+                                                        FLAG_WIDE_CLASS);
+  if (a.chplType->symbol->hasAnyFlag(refOrWideFlags)) {
     ap = codegenDeref(a);
   } else {
     ap = a;
@@ -4434,6 +4561,46 @@ DEFINE_PRIM(PRIM_UNORDERED_ASSIGN) {
                 ln, fn);
   }
 }
+DEFINE_PRIM(PRIM_YIELDING_ASSIGN) {
+
+  Expr* lhsExpr = call->get(1);
+  Expr* rhsExpr = call->get(2);
+  bool lhsWide = lhsExpr->isWideRef();
+  bool rhsWide = rhsExpr->isWideRef();
+
+  // Only a GET into a local destination can usefully yield while it
+  // waits; generate everything else as a normal assign.
+  if (lhsWide || !rhsWide) {
+    FORWARD_PRIM(PRIM_ASSIGN);
+    return;
+  }
+
+  GenRet dst = lhsExpr;
+  bool dstRef = lhsExpr->typeInfo()->symbol->hasFlag(FLAG_REF);
+  GenRet src = rhsExpr;
+  GenRet ln = call->get(3);
+  GenRet fn = call->get(4);
+  TypeSymbol* dt = lhsExpr->typeInfo()->getValType()->symbol;
+  GenRet size = codegenSizeof(dt->typeInfo());
+
+  // do a GET that yields to other tasks until the data arrives
+  // chpl_gen_comm_get_yielding(void *dst,
+  //   c_nodeid_t src_locale, void* src_raddr,
+  //   size_t size, int32_t commID,
+  //   int ln, int32_t fn);
+
+  dst = codegenValuePtr(dst);
+  if (dstRef)
+    dst = codegenDeref(dst);
+
+  codegenCall("chpl_gen_comm_get_yielding",
+              codegenCastToVoidStar(codegenAddrOf(dst)),
+              codegenRnode(src),
+              codegenRaddr(src),
+              size,
+              genCommID(gGenInfo),
+              ln, fn);
+}
 DEFINE_PRIM(PRIM_ADD_ASSIGN) {
     codegenOpAssign(call->get(1), call->get(2), " += ", codegenAdd);
 }
@@ -4473,29 +4640,24 @@ DEFINE_PRIM(PRIM_MIN) {
 
     if (is_arithmetic_type( t)) {
       if (is_int_type( t)) {
-        ret = codegenUseGlobal("MIN_INT" + numToString(get_width(t)));
+        ret = codegenUseGlobal(astr("MIN_INT", istr(get_width(t))));
 
       } else if (is_uint_type( t)) {
-        ret = codegenUseGlobal("MIN_UINT" + numToString(get_width(t)));
+        ret = codegenUseGlobal(astr("MIN_UINT", istr(get_width(t))));
 
       } else if (is_real_type( t)) {
-        std::string width = numToString(get_width(t));
-
-        ret = codegenNeg(codegenUseGlobal("MAX_FLOAT" + width));
+        ret = codegenNeg(codegenUseGlobal(astr("MAX_FLOAT",
+                                               istr(get_width(t)))));
 
       } else if (is_imag_type( t)) {
-        std::string width = numToString(get_width(t));
-
-        ret = codegenNeg(codegenUseGlobal("MAX_FLOAT" + width));
+        ret = codegenNeg(codegenUseGlobal(astr("MAX_FLOAT",
+                                               istr(get_width(t)))));
 
       } else if (is_complex_type( t)) {
-        std::string width     = numToString(get_width(t));
-        std::string halfWidth = numToString(get_width(t) / 2);
-
-        std::string fname     = "_chpl_complex" + width;
-        std::string maxFloat  = "MAX_FLOAT"     + halfWidth;
+        const char* fname    = astr("_chpl_complex", istr(get_width(t)));
+        const char* maxFloat = astr("MAX_FLOAT", istr(get_width(t) / 2));
 
-        ret = codegenCallExpr(fname.c_str(),
+        ret = codegenCallExpr(fname,
                               codegenNeg(codegenUseGlobal(maxFloat)),
                               codegenNeg(codegenUseGlobal(maxFloat)));
 
@@ -4512,27 +4674,22 @@ DEFINE_PRIM(PRIM_MAX) {
 
     if (is_arithmetic_type( t)) {
       if (is_int_type( t)) {
-        ret = codegenUseGlobal("MAX_INT" + numToString(get_width(t)));
+        ret = codegenUseGlobal(astr("MAX_INT", istr(get_width(t))));
 
       } else if (is_uint_type( t)) {
-        ret = codegenUseGlobal("MAX_UINT" + numToString(get_width(t)));
+        ret = codegenUseGlobal(astr("MAX_UINT", istr(get_width(t))));
 
       } else if (is_real_type( t)) {
-        ret = codegenUseGlobal("MAX_FLOAT" + numToString(get_width(t)));
+        ret = codegenUseGlobal(astr("MAX_FLOAT", istr(get_width(t))));
 
       } else if (is_imag_type( t)) {
-        ret = codegenUseGlobal("MAX_FLOAT" + numToString(get_width(t)));
+        ret = codegenUseGlobal(astr("MAX_FLOAT", istr(get_width(t))));
 
       } else if (is_complex_type( t)) {
-        std::string width     = numToString(get_width(t));
-        std::string halfWidth = numToString(get_width(t) / 2);
+        const char* fname    = astr("_chpl_complex", istr(get_width(t)));
+        const char* maxFloat = astr("MAX_FLOAT", istr(get_width(t) / 2));
 
-        std::string fname     = "_chpl_complex" + width;
-        std::string maxFloat  = "MAX_FLOAT"     + halfWidth;
-
-
-
-        ret = codegenCallExpr(fname.c_str(),
+        ret = codegenCallExpr(fname,
                               codegenUseGlobal(maxFloat),
                               codegenUseGlobal(maxFloat));
       } else {
@@ -5358,6 +5515,13 @@ DEFINE_PRIM(PRIM_RT_WARNING) {
     ret = call->codegenBasicPrimitiveExpr();
 }
 
+DEFINE_PRIM(PRIM_FORALL_ENTER) {
+    ret = call->codegenBasicPrimitiveExpr();
+}
+DEFINE_PRIM(PRIM_FORALL_EXIT) {
+    ret = call->codegenBasicPrimitiveExpr();
+}
+
 DEFINE_PRIM(PRIM_START_RMEM_FENCE) {
     ret = call->codegenBasicPrimitiveExpr();
 }
@@ -5476,8 +5640,9 @@ DEFINE_PRIM(PRIM_VIRTUAL_METHOD_CALL) {
     fn = toFnSymbol(se->symbol());
     INT_ASSERT(fn);
 
+    GenRet cid = codegenValue(call->get(2));    // the cid
+
     {
-      GenRet  i           = codegenValue(call->get(2));    // the cid
       int64_t fnId       = virtualMethodMap.get(fn);
       GenRet j           = new_IntSymbol(fnId,    INT_SIZE_64);
       GenRet maxVMTConst = new_IntSymbol(gMaxVMT, INT_SIZE_64);
@@ -5485,11 +5650,33 @@ DEFINE_PRIM(PRIM_VIRTUAL_METHOD_CALL) {
       INT_ASSERT(gMaxVMT >= 0);
 
       // indexExpr = maxVMT * classId + fnId
-      index = codegenAdd(codegenMul(maxVMTConst, i), j);
+      index = codegenAdd(codegenMul(maxVMTConst, cid), j);
     }
 
     if (gGenInfo->cfile){
-      fnPtr.c = std::string("chpl_vmtable") + "[" + index.c + "]";
+      if (!fNoVirtualCallCache) {
+        // Emit a per-call-site inline cache: remember the last class id
+        // dispatched here and the vtable entry it selected, and skip the
+        // table lookup when the id repeats.  The class hierarchy is fixed
+        // once the program is compiled, so a cached entry never goes
+        // stale; keeping the cache in thread-local storage ensures one
+        // task's id is never paired with another task's target.
+        static int vmtCacheSiteNum = 0;
+
+        std::string site   = istr(++vmtCacheSiteNum);
+        std::string cidVar = std::string("chpl_vmtCacheCid") + site;
+        std::string fnVar  = std::string("chpl_vmtCacheFn") + site;
+
+        gGenInfo->cLocalDecls.push_back("static __thread int64_t " +
+                                        cidVar + " = -1");
+        gGenInfo->cLocalDecls.push_back("static __thread chpl_fn_p " + fnVar);
+
+        fnPtr.c = "(" + cidVar + " == (" + cid.c + ") ? (void)0 : (void)(" +
+                  fnVar + " = chpl_vmtable[" + index.c + "], " +
+                  cidVar + " = (" + cid.c + ")), " + fnVar + ")";
+      } else {
+        fnPtr.c = std::string("chpl_vmtable") + "[" + index.c + "]";
+      }
     } else {
 #ifdef HAVE_LLVM
       GenRet       table = gGenInfo->lvt->getValue("chpl_vmtable");
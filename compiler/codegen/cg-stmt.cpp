@@ -51,6 +51,8 @@ void codegenStmt(Expr* stmt) {
   info->filename = stmt->fname();
 
   if( outfile ) {
+    // statement boundaries are safe points to spill oversized buffers
+    maybeSpillStatements();
     if (printCppLineno && stmt->linenum() > 0)
         info->cStatements.push_back(zlineToString(stmt));
     if (fGenIDS)
@@ -747,6 +747,10 @@ void VarSymbol::codegenDefC(bool global, bool isHeader) {
     str = (isStatic ? "static " : "") + typestr + " " + cname;
   }
 
+  // CHPL_CACHELINE_ALIGNED is #defined in the runtime's chpltypes.h.
+  if (hasFlag(FLAG_CACHELINE_ALIGN))
+    str += " CHPL_CACHELINE_ALIGNED";
+
   if (ct) {
     if (ct->isClass()) {
       if (isFnSymbol(defPoint->parentSymbol)) {
@@ -904,6 +908,16 @@ void VarSymbol::codegenDef() {
 
     alignment = getAlignment(type);
 
+    if (hasFlag(FLAG_CACHELINE_ALIGN)) {
+#if HAVE_LLVM_VER >= 100
+      if (!alignment.hasValue() || alignment.getValue().value() < 64)
+        alignment = llvm::MaybeAlign(64);
+#else
+      if (alignment < 64)
+        alignment = 64;
+#endif
+    }
+
     llvm::Type *varType = type->codegen().type;
     llvm::AllocaInst *varAlloca = createVarLLVM(varType, cname);
 
@@ -2121,6 +2135,11 @@ void FnSymbol::codegenHeaderC(void) {
   if (fGenIDS)
     fprintf(outfile, "%s", idCommentTemp(this));
 
+  // error/halt paths: let the backend lay them out away from hot code
+  // (chpl_cold_fn is defined in sys_basic.h)
+  if (hasFlag(FLAG_FUNCTION_TERMINATES_PROGRAM))
+    fprintf(outfile, "chpl_cold_fn ");
+
   if (!fIncrementalCompilation && !hasFlag(FLAG_EXPORT) && !hasFlag(FLAG_EXTERN)) {
     fprintf(outfile, "static ");
   }
@@ -2363,8 +2382,7 @@ void FnSymbol::codegenDef() {
 
   if( hasFlag(FLAG_GPU_CODEGEN) != gCodegenGPU ) return;
 
-  info->cStatements.clear();
-  info->cLocalDecls.clear();
+  clearStatementBuffers();
 
   if( outfile ) {
     if (strcmp(saveCDir, "")) {
@@ -2412,6 +2430,9 @@ void FnSymbol::codegenDef() {
 
     if (this->hasFlag(FLAG_FUNCTION_TERMINATES_PROGRAM)) {
       func->addFnAttr(llvm::Attribute::NoReturn);
+      // also cold, so the optimizer sizes it down and keeps it (and
+      // the blocks leading to it) out of the hot code layout
+      func->addFnAttr(llvm::Attribute::Cold);
     }
 
     if (specializeCCode) {
@@ -3155,8 +3176,7 @@ void ModuleSymbol::codegenDef() {
   info->lineno   = linenum();
   commIDMap[info->filename] = 0;
 
-  info->cStatements.clear();
-  info->cLocalDecls.clear();
+  clearStatementBuffers();
 
   std::vector<FnSymbol*> fns;
 
@@ -271,6 +271,14 @@ void AggregateType::codegenDef() {
     }
   } else {
     if( outfile ) {
+      if (fWidePtrNodeBits > 0 && this->isWidePtrType()) {
+        // With --packed-wide-pointers, a wide pointer is a single 64-bit
+        // word with the node id in the upper bits, not a struct; the
+        // accessors in cg-expr.cpp pack and unpack it.
+        fprintf(outfile, "typedef chpl_packed_wide_ptr_t %s;\n\n",
+                this->classStructName(true));
+        return;
+      }
       fprintf(outfile, "typedef struct %s", this->classStructName(false));
       if (aggregateTag == AGGREGATE_CLASS && dispatchParents.n > 0) {
         /* Add a comment to class definitions listing super classes */
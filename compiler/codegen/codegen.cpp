@@ -64,6 +64,7 @@
 #include <cmath>
 #include <cstring>
 #include <cstdio>
+#include <thread>
 #include <vector>
 
 #include <sys/types.h>
@@ -607,6 +608,64 @@ genFtable(std::vector<FnSymbol*> & fSymbols, bool isHeader) {
   codegenGlobalConstArray(name, eltType, &ftable, false);
 }
 
+// Parallel to chpl_ftable: for each entry, whether the task function is
+// expected to run to completion without blocking (FLAG_TASK_FN_NON_BLOCKING).
+// The tasking layer uses this to route such tasks to a preallocated
+// descriptor pool.
+static void
+genFtableNonBlocking(std::vector<FnSymbol*> & fSymbols, bool isHeader) {
+  GenInfo* info = gGenInfo;
+
+  const char* eltType = "chpl_bool";
+  const char* name = "chpl_ftableNonBlocking";
+
+  if (isHeader) {
+    // Just pass NULL when generating header
+    codegenGlobalConstArray(name, eltType, NULL, true);
+    return;
+  }
+
+  if (gCodegenGPU == true) {
+    return;
+  }
+
+  GenRet boolType = codegenTypeByName(eltType);
+
+  // Construct the table elements
+  std::vector<GenRet> table;
+  table.reserve(fSymbols.size());
+
+  forv_Vec(FnSymbol, fn, fSymbols) {
+    bool nonBlocking = fn->hasFlag(FLAG_TASK_FN_NON_BLOCKING);
+    GenRet gen;
+    if (info->cfile) {
+      gen.c = nonBlocking ? "true" : "false";
+    } else {
+#ifdef HAVE_LLVM
+      INT_ASSERT(boolType.type);
+      gen.val = llvm::ConstantInt::get(boolType.type, nonBlocking ? 1 : 0);
+#endif
+    }
+    table.push_back(gen);
+  }
+
+  // make sure the table always contains at least 1 element
+  if (table.empty()) {
+    GenRet f;
+    if (info->cfile) {
+      f.c = "false";
+    } else {
+#ifdef HAVE_LLVM
+      f.val = llvm::ConstantInt::get(boolType.type, 0);
+#endif
+    }
+    table.push_back(f);
+  }
+
+  // Now emit the global array declaration
+  codegenGlobalConstArray(name, eltType, &table, false);
+}
+
 static void
 genFinfo(std::vector<FnSymbol*> & fSymbols, bool isHeader) {
   GenInfo* info = gGenInfo;
@@ -789,20 +848,20 @@ genVirtualMethodTable(std::vector<TypeSymbol*>& types, bool isHeader) {
 }
 
 static void genFilenameTable() {
-  const char *name = "chpl_filenameTable";
+  const char *dataName = "chpl_filenameTableData";
+  const char *offsetsName = "chpl_filenameTableOffsets";
   const char *sizeName = "chpl_filenameTableSize";
-  const char *eltType = "c_string";
 
-  // Compute the element type
-  GenRet cstringType = codegenTypeByName(eltType);
-
-  // Construct the table elements
-  std::vector<GenRet> table;
-  table.reserve(gFilenameLookup.size());
+  // Concatenate the null-terminated paths into a single character blob
+  // and record the offset of each path within it.  Compared with an
+  // array of string pointers, the blob needs no load-time relocations
+  // and saves a pointer per entry in the generated binary.
+  std::string blob;
+  std::vector<GenRet> offsets;
+  offsets.reserve(gFilenameLookup.size());
 
   for (std::vector<std::string>::iterator it = gFilenameLookup.begin();
        it != gFilenameLookup.end(); it++) {
-    GenRet gen;
     std::string & path = (*it);
     std::string genPath;
 
@@ -813,12 +872,23 @@ static void genFilenameTable() {
       genPath = path;
     }
 
-    gen = codegenStringForTable(genPath);
-    table.push_back(gen);
+    offsets.push_back( new_IntSymbol(blob.size(), INT_SIZE_32)->codegen() );
+    blob.append(genPath);
+    blob.push_back('\0');
   }
 
-  // Now emit the global array declaration
-  codegenGlobalConstArray(name, eltType, &table, false);
+  // Construct the blob elements
+  std::vector<GenRet> data;
+  data.reserve(blob.size());
+
+  for (size_t i = 0; i < blob.size(); i++) {
+    data.push_back( new_IntSymbol((unsigned char)blob[i],
+                                  INT_SIZE_8)->codegen() );
+  }
+
+  // Now emit the global array declarations
+  codegenGlobalConstArray(dataName, "c_char", &data, false);
+  codegenGlobalConstArray(offsetsName, "c_int", &offsets, false);
 
   // Now emit the size
   genGlobalInt32(sizeName, gFilenameLookup.size());
@@ -1082,9 +1152,10 @@ static inline bool shouldCodegenAggregate(AggregateType* ct)
   // ..except for classes with FLAG_REF or FLAG_DATA_CLASS.. which
   //   we do visit.
   if( isClass(ct) ) { // is it actually a class?
-    if( ct->symbol->hasFlag(FLAG_REF) ||
-        ct->symbol->hasFlag(FLAG_WIDE_REF) ||
-        ct->symbol->hasFlag(FLAG_DATA_CLASS)) return true;
+    static constexpr FlagSet refOrDataClass = makeFlagSet(FLAG_REF,
+                                                          FLAG_WIDE_REF,
+                                                          FLAG_DATA_CLASS);
+    if( ct->symbol->hasAnyFlag(refOrDataClass)) return true;
     else return false;
   }
 
@@ -1148,6 +1219,7 @@ static void genConfigGlobalsAndAbout() {
   genGlobalInt("CHPL_STACK_CHECKS", !fNoStackChecks, false);
   genGlobalInt("CHPL_CACHE_REMOTE", fCacheRemote, false);
   genGlobalInt("CHPL_INTERLEAVE_MEM", fEnableMemInterleaving, false);
+  genGlobalInt("CHPL_WIDE_POINTERS_NODE_BITS", fWidePtrNodeBits, false);
 
   for (std::map<std::string, const char*>::iterator env=envMap.begin(); env!=envMap.end(); ++env) {
     if (env->first != "CHPL_HOME") {
@@ -1406,6 +1478,7 @@ static void codegen_defn(std::set<const char*> & cnames, std::vector<TypeSymbol*
 
   genComment("Function Pointer Table");
   genFtable(ftableVec, false);
+  genFtableNonBlocking(ftableVec, false);
   genFinfo(ftableVec, false);
 
   genComment("Virtual Method Table");
@@ -1845,6 +1918,7 @@ static void codegen_header(std::set<const char*> & cnames,
   }
 
   genFtable(ftableVec,true);
+  genFtableNonBlocking(ftableVec,true);
   genFinfo(ftableVec,true);
 
   genComment("Virtual Method Table");
@@ -2385,6 +2459,14 @@ static void codegenPartOne() {
       USR_FATAL("--llvm-wide-opt requires CHPL_TARGET_COMPILER=llvm");
   }
 
+  if (fWidePtrNodeBits != 0) {
+    if (fLlvmCodegen)
+      USR_FATAL("--packed-wide-pointers is not supported with the "
+                "LLVM code generator");
+    if (fWidePtrNodeBits < 1 || fWidePtrNodeBits > 31)
+      USR_FATAL("--packed-wide-pointers requires between 1 and 31 node bits");
+  }
+
   // Prepare primitives for codegen
   CallExpr::registerPrimitivesForCodegen();
 
@@ -2653,6 +2735,16 @@ void makeBinary(void) {
 #endif
   } else {
     const char* makeflags = printSystemCommands ? "-f " : "-s -f ";
+    // Compile the per-module translation units concurrently when the
+    // user requested parallel back-end jobs (mainly useful with
+    // --incremental, which is what splits the generated code up).
+    int parMakeJobs = fParMakeJobs;
+    // A job runner such as distcc implies parallel jobs; default to
+    // the local core count when no explicit job count was given.
+    if (parMakeJobs == 0 && fBackendJobRunner[0] != '\0')
+      parMakeJobs = (int) std::thread::hardware_concurrency();
+    if (parMakeJobs > 0)
+      makeflags = astr("-j", istr(parMakeJobs), " ", makeflags);
     const char* command = astr(astr(CHPL_MAKE, " "),
                                makeflags,
                                getIntermediateDirName(), "/Makefile");
@@ -2736,14 +2828,98 @@ void genComment(const char* comment, bool push) {
   }
 }
 
+//
+// Support for streaming generated C out of memory.
+//
+// cLocalDecls/cStatements have to buffer an entire function because the
+// hoisted local declarations must be printed before the body (see the
+// comments in GenInfo).  For very large generated functions that
+// buffering used to be the C backend's peak-memory driver, scaling with
+// the size of the function being generated.  To bound it, once the
+// in-memory buffers grow past a fixed limit we spill them, in order, to
+// anonymous temporary files, and flushStatements() drains each spill
+// file ahead of the corresponding in-memory buffer.  Because the spilled
+// entries are always a prefix of the entries generated so far, the
+// emitted order is unchanged.
+//
+// CForLoop header codegen pops statements back off of cStatements to
+// build comma-separated loop clauses, so it pins the buffers in memory
+// while it runs (see CForLoop::codegenCForLoopHeader()).
+//
+
+int gCStatementsPinned = 0;
+
+static FILE* cLocalDeclsSpill = NULL;
+static FILE* cStatementsSpill = NULL;
+
+// Spill once this many entries are buffered.  Statements are typically
+// well under a hundred bytes each, so this bounds the buffers at a few
+// MiB no matter how large the function being generated is.
+static const size_t maxBufferedCStatements = 16384;
+
+static void appendToSpill(FILE** spill, std::vector<std::string>& buf,
+                          const char* fmt) {
+  if( *spill == NULL ) {
+    *spill = tmpfile();
+    if( *spill == NULL )
+      USR_FATAL("unable to create temporary file for code generation");
+  }
+  for(size_t i = 0; i < buf.size(); ++i) {
+    fprintf(*spill, fmt, buf[i].c_str());
+  }
+  buf.clear();
+}
+
+static void drainSpill(FILE** spill, FILE* outfile) {
+  if( *spill == NULL ) return;
+  char buf[16384];
+  size_t got;
+  rewind(*spill);
+  while( (got = fread(buf, 1, sizeof(buf), *spill)) > 0 ) {
+    fwrite(buf, 1, got, outfile);
+  }
+  fclose(*spill);
+  *spill = NULL;
+}
+
+void maybeSpillStatements(void)
+{
+  GenInfo* info = gGenInfo;
+  if( info->cfile == NULL ) return;
+  if( gCStatementsPinned > 0 ) return;
+  if( info->cLocalDecls.size() + info->cStatements.size() <
+      maxBufferedCStatements ) return;
+  appendToSpill(&cLocalDeclsSpill, info->cLocalDecls, "%s;\n");
+  appendToSpill(&cStatementsSpill, info->cStatements, "%s");
+}
+
+// Discards anything buffered or spilled without emitting it; used where
+// codegen starts a fresh function or module.
+void clearStatementBuffers(void)
+{
+  GenInfo* info = gGenInfo;
+  if( cLocalDeclsSpill != NULL ) {
+    fclose(cLocalDeclsSpill);
+    cLocalDeclsSpill = NULL;
+  }
+  if( cStatementsSpill != NULL ) {
+    fclose(cStatementsSpill);
+    cStatementsSpill = NULL;
+  }
+  info->cLocalDecls.clear();
+  info->cStatements.clear();
+}
+
 void flushStatements(void)
 {
   GenInfo* info = gGenInfo;
   size_t i;
   if( info->cfile ) {
+    drainSpill(&cLocalDeclsSpill, info->cfile);
     for(i = 0; i < info->cLocalDecls.size(); ++i) {
       fprintf(info->cfile, "%s;\n", info->cLocalDecls[i].c_str());
     }
+    drainSpill(&cStatementsSpill, info->cfile);
     for(i = 0; i < info->cStatements.size(); ++i) {
       fprintf(info->cfile, "%s", info->cStatements[i].c_str());
     }
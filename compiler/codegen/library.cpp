@@ -40,6 +40,79 @@ std::map<TypeSymbol*, std::pair<std::string, std::string> > pythonNames;
 std::map<TypeSymbol*, std::string> fortranKindNames;
 std::map<TypeSymbol*, std::string> fortranTypeNames;
 
+//
+// --library-async support: for an exported function 'foo' this emits,
+// into the generated library header, a capture struct and static
+// inline submit/poll/wait variants that run the blocking call as a
+// Chapel task through the chpl_async_export_* runtime interface
+// (chpl-export-wrappers.h):
+//
+//   foo_async_t* foo_submit(...same formals...);
+//   int          foo_poll(foo_async_t*);    // nonzero when complete
+//   <ret>        foo_wait(foo_async_t*);    // blocks, then frees
+//
+static void genAsyncExportWrappers(FILE* hdr, FnSymbol* fn) {
+  const char* name = fn->cname;
+  bool hasRet = (fn->retType != dtVoid);
+  std::string retType = hasRet ? fn->retType->codegen().c : "void";
+
+  // the capture struct: one field per formal, plus handle and result
+  fprintf(hdr, "\ntypedef struct %s_async_s {\n", name);
+  fprintf(hdr, "  chpl_async_handle_t* _handle;\n");
+  for_formals(formal, fn) {
+    fprintf(hdr, "  %s %s;\n", formal->type->codegen().c.c_str(),
+            formal->cname);
+  }
+  if (hasRet) {
+    fprintf(hdr, "  %s _retval;\n", retType.c_str());
+  }
+  fprintf(hdr, "} %s_async_t;\n", name);
+
+  // the task body: unpack the capture and make the blocking call
+  fprintf(hdr, "static inline void %s_async_body(void* _arg) {\n", name);
+  fprintf(hdr, "  %s_async_t* _a = (%s_async_t*) _arg;\n", name, name);
+  fprintf(hdr, "  %s%s(", hasRet ? "_a->_retval = " : "", name);
+  bool first = true;
+  for_formals(formal, fn) {
+    fprintf(hdr, "%s_a->%s", first ? "" : ", ", formal->cname);
+    first = false;
+  }
+  fprintf(hdr, ");\n}\n");
+
+  // submit: capture the arguments and start the task
+  fprintf(hdr, "static inline %s_async_t* %s_submit(", name, name);
+  first = true;
+  for_formals(formal, fn) {
+    fprintf(hdr, "%s%s %s", first ? "" : ", ",
+            formal->type->codegen().c.c_str(), formal->cname);
+    first = false;
+  }
+  fprintf(hdr, "%s) {\n", first ? "void" : "");
+  fprintf(hdr, "  %s_async_t* _a = (%s_async_t*) malloc(sizeof(*_a));\n",
+          name, name);
+  for_formals(formal, fn) {
+    fprintf(hdr, "  _a->%s = %s;\n", formal->cname, formal->cname);
+  }
+  fprintf(hdr, "  _a->_handle = chpl_async_export_submit(%s_async_body, _a);\n",
+          name);
+  fprintf(hdr, "  return _a;\n}\n");
+
+  fprintf(hdr, "static inline int %s_poll(%s_async_t* _a) {\n", name, name);
+  fprintf(hdr, "  return chpl_async_export_poll(_a->_handle);\n}\n");
+
+  fprintf(hdr, "static inline %s %s_wait(%s_async_t* _a) {\n",
+          retType.c_str(), name, name);
+  fprintf(hdr, "  chpl_async_export_wait(_a->_handle);\n");
+  fprintf(hdr, "  chpl_async_export_free(_a->_handle);\n");
+  if (hasRet) {
+    fprintf(hdr, "  %s _ret = _a->_retval;\n", retType.c_str());
+    fprintf(hdr, "  free(_a);\n");
+    fprintf(hdr, "  return _ret;\n}\n\n");
+  } else {
+    fprintf(hdr, "  free(_a);\n}\n\n");
+  }
+}
+
 //
 // Generates a .h file to complement the library file created using --library
 // This .h file will contain necessary #includes, any explicitly exported
@@ -82,12 +155,23 @@ void codegen_library_header(std::vector<FnSymbol*> functions) {
       }
       // Maybe need something here to support LLVM extern blocks?
 
+      if (fLibraryAsync) {
+        // the async submit wrappers capture arguments with malloc/free
+        fprintf(libhdrfile.fptr, "#include <stdlib.h>\n");
+      }
+
       // Print out the module initialization function headers and the exported
       // functions
       for_vector(FnSymbol, fn, functions) {
         if (fn->hasFlag(FLAG_EXPORT) &&
             isUserRoutine(fn)) {
           fn->codegenPrototype();
+
+          // --library-async: a multilocale library routes calls through
+          // the mli client instead, which has its own blocking protocol
+          if (fLibraryAsync && !fMultiLocaleInterop) {
+            genAsyncExportWrappers(libhdrfile.fptr, fn);
+          }
         }
       }
 
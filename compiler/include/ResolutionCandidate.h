@@ -93,6 +93,11 @@ class ResolutionCandidate {
 public:
                           ResolutionCandidate(FnSymbol* fn);
 
+  // Return a candidate to its freshly-constructed state so the same
+  // object can be reused for another function, retaining the capacity
+  // of its vectors.
+  void                    reset(FnSymbol* fn);
+
   bool                    isApplicable(CallInfo& info,
                                        VisibilityInfo* visInfo);
 
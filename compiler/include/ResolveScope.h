@@ -24,6 +24,7 @@
 #include <map>
 #include <set>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 class astlocT;
@@ -122,7 +123,10 @@ private:
 
   typedef std::set<const ResolveScope*>  ScopeSet;
 
-  typedef std::map<const char*, Symbol*> Bindings;
+  // The names are astrs, so they hash and compare as pointers;
+  // bindings are only iterated to count or describe them, never in
+  // an order-sensitive way.
+  typedef std::unordered_map<const char*, Symbol*> Bindings;
   typedef std::map<Symbol*, UseImportList> UseImportMap;
 
                         ResolveScope();
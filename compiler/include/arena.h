@@ -0,0 +1,67 @@
+/*
+ * Copyright 2020-2021 Hewlett Packard Enterprise Development LP
+ * Copyright 2004-2019 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ARENA_H_
+#define _ARENA_H_
+
+#include <cstddef>
+
+//
+// A simple chunked bump-pointer arena.
+//
+// Allocations are carved sequentially out of large malloc'd chunks, so
+// consecutively allocated objects end up adjacent in memory and there is
+// no per-object free.  Memory is reclaimed in bulk by destroying the
+// arena (or calling clear()).
+//
+// This is used for BaseAST nodes: the compiler allocates tens of
+// millions of them and deletes them only during cleanAst() sweeps, so
+// individual frees are pure overhead.  See baseAST.cpp.
+//
+class Arena {
+public:
+                 Arena();
+                ~Arena();
+
+  // Return 'size' bytes aligned suitably for any object.
+  void*          allocate(size_t size);
+
+  // Release every chunk.  All outstanding allocations become invalid.
+  void           clear();
+
+  // Total bytes handed out since construction (or the last clear()).
+  size_t         bytesAllocated()                                 const;
+
+private:
+  struct Chunk {
+    Chunk*       next;
+  };
+
+  void*          allocateFromNewChunk(size_t size);
+
+  Chunk*         chunks;        // singly-linked list of live chunks
+  char*          cur;           // next free byte in the newest chunk
+  char*          limit;         // one past the end of the newest chunk
+  size_t         allocated;     // running total of bytes handed out
+
+  static const size_t chunkSize = 1024 * 1024;
+};
+
+#endif
@@ -22,6 +22,7 @@
 #define _ASTLOCS_H_
 
 #include <cassert>
+#include <cstdint>
 #include <cstring>
 
 #include "chpl/queries/ID.h"
@@ -30,24 +31,46 @@
 class BaseAST;
 class Expr;
 
+// Intern a compiler/next ID for use in an astlocT; returns nullptr for
+// an empty ID.  Many nodes share a location, and an astlocT is embedded
+// in every AST node and copied freely, so the IDs live in a shared side
+// table and astlocT carries only a pointer into it.
+const chpl::ID* internAstlocId(chpl::ID id);
+
+// The empty ID that astlocT::id() returns when there is no interned one.
+extern const chpl::ID emptyAstlocId;
+
+// A compressed (filename, line number) location.  An astlocT is embedded
+// in every AST node and there are many more nodes than distinct
+// locations, so a location is packed into 32 bits: the high bits index a
+// side table of filenames and the low bits hold the line number.  The
+// rare location that does not fit is interned in an overflow table and
+// referred to by index.  The encoding is canonical -- equal ids mean
+// equal locations -- and 0 encodes "no location".
+typedef uint32_t astlocIdT;
+
+astlocIdT   encodeAstloc(const char* filename, int lineno);
+const char* astlocFilename(astlocIdT loc);
+int         astlocLineno(astlocIdT loc);
+
 // how an AST node knows its location in the source code
 // (assumed to get copied upon assignment and parameter passing)
 class astlocT {
 private:
-  mutable const char* filename_;  // filename of location
-  mutable int         lineno_;    // line number of location
-  chpl::ID            id_;        // id from compiler/next
+  mutable astlocIdT   loc_;       // compressed filename/line; 0 = none
+  const chpl::ID*     id_;        // interned id from compiler/next
 
 public:
   astlocT(int linenoArg, const char* filenameArg)
-    : filename_(filenameArg), lineno_(linenoArg), id_()
+    : loc_(encodeAstloc(filenameArg, linenoArg)), id_(nullptr)
   {
+    // the filename side table relies on filenames being astrs
     if (filenameArg != nullptr)
-      assert(astr(filename_) == filename_);
+      assert(astr(filenameArg) == filenameArg);
   }
 
   astlocT(chpl::ID id)
-    : filename_(nullptr), lineno_(0), id_(std::move(id))
+    : loc_(0), id_(internAstlocId(std::move(id)))
   { }
 
   int compare(const astlocT& other) const;
@@ -55,20 +78,20 @@ public:
   const char* stringLoc() const;
 
   bool isEmpty() const {
-    if (filename_ != nullptr)
+    if (astlocFilename(loc_) != nullptr)
       return false;
 
-    return id_.isEmpty();
+    return id_ == nullptr;
   }
 
   const chpl::ID& id() const {
-    return id_;
+    return (id_ != nullptr) ? *id_ : emptyAstlocId;
   }
 
   // always returns an astr or nullptr
   const char* filename() const {
-    if (filename_ != nullptr || id_.isEmpty())
-      return filename_;
+    if (loc_ != 0 || id_ == nullptr)
+      return astlocFilename(loc_);
 
     // otherwise, get the filename from the id
     const char* name = nullptr;
@@ -78,8 +101,8 @@ public:
   }
 
   int lineno() const {
-    if (filename_ != nullptr || id_.isEmpty())
-      return lineno_;
+    if (loc_ != 0 || id_ == nullptr)
+      return astlocLineno(loc_);
 
     // otherwise, get the lineno from the id
     const char* name = nullptr;
@@ -89,8 +112,9 @@ public:
   }
 
   bool operator==(const astlocT& other) const {
-    return this->filename_ == other.filename_ &&
-           this->lineno_ == other.lineno_ &&
+    // the location encoding is canonical and interning makes pointer
+    // equality on id_ mean value equality
+    return this->loc_ == other.loc_ &&
            this->id_ == other.id_;
   }
   bool operator!=(const astlocT& other) const {
@@ -275,6 +275,15 @@ public:
 
   const char*       astTagAsString()                             const;
 
+  //
+  // AST nodes are bump-allocated out of a shared arena, so nodes
+  // created together are adjacent in memory and the per-node delete
+  // performed by cleanAst() runs only the destructor; the backing
+  // memory is released in bulk by destroyAst().
+  //
+  static void*      operator new(size_t size);
+  static void       operator delete(void* ptr);
+
   AstTag            astTag;     // BaseAST subclass
   int               id;         // Unique ID
   astlocT           astloc;     // Location of this node in the source code
@@ -307,6 +316,10 @@ int    lastNodeIDUsed();
 
 // trace various AST node removals
 void   trace_remove(BaseAST* ast, char flag);
+void   noteRemovedForClean(BaseAST* ast);
+
+// note that the subtree under 'sym' changed, for --incremental-verify
+void   markVerifyDirty(Symbol* sym);
 
 void verifyInTree(BaseAST* ast, const char* msg);
 
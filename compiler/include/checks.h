@@ -53,15 +53,21 @@ void check_scalarReplace();
 void check_refPropagation();
 void check_copyPropagation();
 void check_deadCodeElimination();
+void check_stackAllocateClasses();
 void check_removeEmptyRecords();
 void check_localizeGlobals();
+void check_loopFusion();
+void check_loopTiling();
 void check_loopInvariantCodeMotion();
 void check_prune2();
+void check_prune3();
+void check_reorderFields();
 void check_returnStarTuplesByRefArgs();
 void check_insertWideReferences();
 void check_optimizeOnClauses();
 void check_addInitCalls();
 void check_insertLineNumbers();
+void check_globalValueNumbering();
 void check_denormalize();
 void check_codegen();
 void check_makeBinary();
@@ -171,6 +171,11 @@ void zlineToFileIfNeeded(BaseAST* ast, FILE* outfile);
 const char* idCommentTemp(BaseAST* ast);
 void genComment(const char* comment, bool push=false);
 void flushStatements(void);
+void maybeSpillStatements(void);
+void clearStatementBuffers(void);
+// When positive, cLocalDecls/cStatements must stay in memory because a
+// caller intends to pop entries back off of them.
+extern int gCStatementsPinned;
 
 GenRet codegenCallExpr(const char* fnName);
 GenRet codegenCallExpr(const char* fnName, GenRet a1);
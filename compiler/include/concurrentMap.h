@@ -0,0 +1,276 @@
+/*
+ * Copyright 2020-2021 Hewlett Packard Enterprise Development LP
+ * Copyright 2004-2019 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _CONCURRENT_MAP_H_
+#define _CONCURRENT_MAP_H_
+
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <vector>
+
+//
+// ConcurrentMap: an open-addressing hash map intended to replace Map in
+// the hotter compiler caches.
+//
+// The table is split into NumShards independent sub-tables selected by
+// the upper bits of the key hash.  Each shard uses linear probing over a
+// power-of-two slot array, grows locally when it passes a 70% load
+// factor (so there is never a global rehash), and deletes by shifting
+// the probe chain backward rather than leaving tombstones.  When
+// Concurrent is true each shard is guarded by its own mutex, giving
+// striped locking for future parallel resolution; with Concurrent false
+// the locks compile away.
+//
+// As with Map, the key (K)0 is reserved to mark empty slots and must
+// not be used, and get() returns C() for absent keys.
+//
+
+template <class K> class ConcurrentMapHashFns {
+ public:
+  static uintptr_t hash(K key) { return (uintptr_t) key; }
+  static bool equal(K a, K b)  { return a == b; }
+};
+
+template <class K,
+          class C,
+          class AHashFns  = ConcurrentMapHashFns<K>,
+          int   NumShards = 16,
+          bool  Concurrent = true>
+class ConcurrentMap {
+ public:
+  ConcurrentMap() { }
+
+  C    get(K key);
+  void put(K key, C value);
+  bool remove(K key);
+
+  // Visit every entry; takes fn(K key, C& value).  Holds each shard's
+  // lock while visiting it, so fn must not touch the map.
+  template <class Fn>
+  void forEach(Fn fn);
+
+  void clear();
+
+  size_t size() const;
+
+ private:
+  struct Slot {
+    K key;
+    C value;
+
+    Slot() : key((K) 0), value() { }
+  };
+
+  struct Shard {
+    std::vector<Slot>  slots;
+    size_t             count;
+    mutable std::mutex lock;
+
+    Shard() : count(0) { }
+  };
+
+  // scramble the hash so that shard selection (high bits) and probe
+  // position (low bits) stay uncorrelated for pointer-ish keys
+  static uintptr_t mix(uintptr_t h) {
+    h *= (uintptr_t) 0x9e3779b97f4a7c15ULL;
+    h ^= h >> 32;
+    return h;
+  }
+
+  Shard& shardFor(uintptr_t h) {
+    return mShards[(h >> 24) % NumShards];
+  }
+
+  struct Guard {
+    std::mutex* mtx;
+
+    Guard(std::mutex& m) : mtx(Concurrent ? &m : NULL) {
+      if (mtx != NULL) mtx->lock();
+    }
+
+    ~Guard() {
+      if (mtx != NULL) mtx->unlock();
+    }
+  };
+
+  // index of the slot 'key' hashes to in a table of capacity 'cap'
+  static size_t homeIndex(K key, size_t cap) {
+    return mix(AHashFns::hash(key)) & (cap - 1);
+  }
+
+  // probe for 'key'; returns its slot, or the empty slot ending its chain
+  static size_t findSlot(const std::vector<Slot>& slots, K key) {
+    size_t mask = slots.size() - 1;
+    size_t idx  = homeIndex(key, slots.size());
+
+    while (slots[idx].key != (K) 0 &&
+           AHashFns::equal(slots[idx].key, key) == false) {
+      idx = (idx + 1) & mask;
+    }
+
+    return idx;
+  }
+
+  static void growShard(Shard& shard) {
+    size_t            newCap = (shard.slots.empty() == true)
+                               ? 16 : 2 * shard.slots.size();
+    std::vector<Slot> old;
+
+    old.swap(shard.slots);
+    shard.slots.resize(newCap);
+
+    for (size_t i = 0; i < old.size(); i++) {
+      if (old[i].key != (K) 0) {
+        shard.slots[findSlot(shard.slots, old[i].key)] = old[i];
+      }
+    }
+  }
+
+  Shard mShards[NumShards];
+};
+
+
+template <class K, class C, class AHashFns, int NumShards, bool Concurrent>
+C ConcurrentMap<K, C, AHashFns, NumShards, Concurrent>::get(K key) {
+  assert(key != (K) 0);
+
+  Shard& shard = shardFor(mix(AHashFns::hash(key)));
+  Guard  guard(shard.lock);
+
+  if (shard.slots.empty() == true)
+    return C();
+
+  size_t idx = findSlot(shard.slots, key);
+
+  return (shard.slots[idx].key != (K) 0) ? shard.slots[idx].value : C();
+}
+
+
+template <class K, class C, class AHashFns, int NumShards, bool Concurrent>
+void ConcurrentMap<K, C, AHashFns, NumShards, Concurrent>::put(K key,
+                                                               C value) {
+  assert(key != (K) 0);
+
+  Shard& shard = shardFor(mix(AHashFns::hash(key)));
+  Guard  guard(shard.lock);
+
+  // keep the load factor under 70%
+  if (10 * (shard.count + 1) >= 7 * shard.slots.size())
+    growShard(shard);
+
+  size_t idx = findSlot(shard.slots, key);
+
+  if (shard.slots[idx].key == (K) 0) {
+    shard.slots[idx].key = key;
+    shard.count++;
+  }
+
+  shard.slots[idx].value = value;
+}
+
+
+template <class K, class C, class AHashFns, int NumShards, bool Concurrent>
+bool ConcurrentMap<K, C, AHashFns, NumShards, Concurrent>::remove(K key) {
+  assert(key != (K) 0);
+
+  Shard& shard = shardFor(mix(AHashFns::hash(key)));
+  Guard  guard(shard.lock);
+
+  if (shard.slots.empty() == true)
+    return false;
+
+  size_t mask = shard.slots.size() - 1;
+  size_t idx  = findSlot(shard.slots, key);
+
+  if (shard.slots[idx].key == (K) 0)
+    return false;
+
+  //
+  // Tombstone-free deletion: walk the probe chain after the vacated
+  // slot and shift back any entry whose home position precedes the
+  // hole, so later probes never need a tombstone to keep searching.
+  //
+  size_t hole = idx;
+  size_t scan = idx;
+
+  while (true) {
+    scan = (scan + 1) & mask;
+
+    if (shard.slots[scan].key == (K) 0)
+      break;
+
+    size_t home = homeIndex(shard.slots[scan].key, shard.slots.size());
+
+    // is 'home' outside the cyclic range (hole, scan]?
+    if (((scan - home) & mask) >= ((scan - hole) & mask)) {
+      shard.slots[hole] = shard.slots[scan];
+      hole = scan;
+    }
+  }
+
+  shard.slots[hole] = Slot();
+  shard.count--;
+
+  return true;
+}
+
+
+template <class K, class C, class AHashFns, int NumShards, bool Concurrent>
+template <class Fn>
+void ConcurrentMap<K, C, AHashFns, NumShards, Concurrent>::forEach(Fn fn) {
+  for (int s = 0; s < NumShards; s++) {
+    Guard guard(mShards[s].lock);
+
+    for (size_t i = 0; i < mShards[s].slots.size(); i++) {
+      if (mShards[s].slots[i].key != (K) 0) {
+        fn(mShards[s].slots[i].key, mShards[s].slots[i].value);
+      }
+    }
+  }
+}
+
+
+template <class K, class C, class AHashFns, int NumShards, bool Concurrent>
+void ConcurrentMap<K, C, AHashFns, NumShards, Concurrent>::clear() {
+  for (int s = 0; s < NumShards; s++) {
+    Guard guard(mShards[s].lock);
+
+    mShards[s].slots.clear();
+    mShards[s].count = 0;
+  }
+}
+
+
+template <class K, class C, class AHashFns, int NumShards, bool Concurrent>
+size_t ConcurrentMap<K, C, AHashFns, NumShards, Concurrent>::size() const {
+  size_t retval = 0;
+
+  for (int s = 0; s < NumShards; s++) {
+    Guard guard(mShards[s].lock);
+
+    retval += mShards[s].count;
+  }
+
+  return retval;
+}
+
+#endif
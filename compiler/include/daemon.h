@@ -0,0 +1,43 @@
+/*
+ * Copyright 2020-2021 Hewlett Packard Enterprise Development LP
+ * Copyright 2004-2019 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _DAEMON_H_
+#define _DAEMON_H_
+
+class PhaseTracker;
+
+// The per-compile entry point the daemon runs for each request; in
+// driver.cpp this is everything main() does after the warm front-end
+// setup (argument parsing onward).  It does not return on success --
+// the compile ends in clean_exit().
+typedef int (*chpldCompileFn)(int argc, char* argv[], PhaseTracker& tracker);
+
+// Scan argv for '--daemon-socket <path>' and return the path, or NULL
+// when not running as a daemon.  Handled before regular argument
+// parsing since the daemon serves many argument vectors.
+const char* chpldDaemonSocketArg(int argc, char* argv[]);
+
+// Serve compile requests on the given unix-domain socket, running
+// 'compile' in a forked child per request so each compile starts from
+// the warm front-end state built before this call.  Does not return.
+void chpldServe(const char* socketPath, const char* argv0,
+                chpldCompileFn compile, PhaseTracker& tracker);
+
+#endif
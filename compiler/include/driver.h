@@ -40,9 +40,15 @@ extern bool fNoDeadCodeElimination;
 extern bool fNoGlobalConstOpt;
 extern bool fNoFastFollowers;
 extern bool fNoInlineIterators;
+extern bool fNoGlobalValueNumbering;
 extern bool fNoLoopInvariantCodeMotion;
+extern bool fLoopFusion;
+extern bool fLoopTiling;
+extern int  fLoopTileSize;
+extern bool fCommLocalFastPath;
 extern bool fNoInterproceduralAliasAnalysis;
 extern bool fNoInline;
+extern bool fNoVirtualCallCache;
 extern bool fNoLiveAnalysis;
 extern bool fNoFormalDomainChecks;
 extern bool fNoLocalChecks;
@@ -54,10 +60,18 @@ extern bool fNoCastChecks;
 extern bool fNoDivZeroChecks;
 extern bool fMungeUserIdents;
 extern bool fEnableTaskTracking;
+extern bool fInstrumentForalls;
+extern bool fParallelModuleInit;
+extern bool fDevirtualize;
 extern bool fEnableMemInterleaving;
 extern bool fLLVMWideOpt;
 
+// Pack wide pointers into 64 bits, using this many bits for the node id;
+// 0 means the usual (locale, addr) struct representation.  C back end only.
+extern int fWidePtrNodeBits;
+
 extern bool fAutoLocalAccess;
+extern bool fAutoBoundsCheckElim;
 extern bool fDynamicAutoLocalAccess;
 extern bool fReportAutoLocalAccess;
 
@@ -69,6 +83,10 @@ extern bool fNoInferConstRefs;
 extern bool fNoRemoteSerialization;
 extern bool fNoRemoveCopyCalls;
 extern bool fNoScalarReplacement;
+extern bool fNoElideArrayDefaultInit;
+extern bool fNoStackAllocateClasses;
+extern bool fNoStackAllocateIterators;
+extern bool fNoReorderFields;
 extern bool fNoTupleCopyOpt;
 extern bool fNoOptimizeRangeIteration;
 extern bool fNoOptimizeLoopIterators;
@@ -76,16 +94,21 @@ extern bool fNoVectorize;
 extern bool fForceVectorize;
 extern bool fNoPrivatization;
 extern bool fNoOptimizeOnClauses;
+extern bool fNoEarlyModulePrune;
 extern bool fNoRemoveEmptyRecords;
 extern bool fNoInferLocalFields;
+extern bool fNoInferLocalCalls;
 extern bool fRemoveUnreachableBlocks;
 extern bool fReplaceArrayAccessesWithRefTemps;
 extern int  optimize_on_clause_limit;
+extern int  param_loop_unroll_limit;
 extern int  scalar_replace_limit;
 extern int  inline_iter_yield_limit;
 extern int  tuple_copy_limit;
 
 extern bool fNoOptimizeForallUnordered;
+extern bool fOptimizeForallYieldingGets;
+extern bool fInlineSmallFunctions;
 extern bool fReportOptimizeForallUnordered;
 
 extern bool report_inlining;
@@ -193,6 +216,7 @@ extern int  fLinkStyle;
 extern int  debugParserLevel;
 extern int  debugShortLoc;
 extern bool fLibraryCompile;
+extern bool fLibraryAsync;
 extern bool fLibraryFortran;
 extern bool fLibraryMakefile;
 extern bool fLibraryPython;
@@ -203,6 +227,7 @@ extern bool fMultiLocaleLibraryDebug;
 extern bool no_codegen;
 extern bool developer;
 extern bool fVerify;
+extern bool fIncrementalVerify;
 extern int  num_constants_per_variable;
 extern bool printCppLineno;
 
@@ -217,12 +242,16 @@ extern int  squelch_header_errors;
 extern bool fWarnConstLoops;
 extern bool fWarnUnstable;
 
+extern bool fPerfReport;
 extern bool fReportAliases;
 extern bool fReportBlocking;
 extern bool fReportOptimizedLoopIterators;
 extern bool fReportInlinedIterators;
 extern bool fReportVectorizedLoops;
+extern bool fReportLoopFusion;
+extern bool fReportLoopTiling;
 extern bool fReportOptimizedOn;
+extern bool fReportInstantiations;
 extern bool fReportPromotion;
 extern bool fReportScalarReplace;
 extern bool fReportDeadBlocks;
@@ -245,6 +274,7 @@ extern int fGPUBlockSize;
 extern char fCUDAArch[16];
 
 extern char stopAfterPass[128];
+extern char fResumeCheckpointDir[FILENAME_MAX+1];
 
 // code generation strings
 extern const char* compileCommand;
@@ -257,9 +287,23 @@ extern bool fMinimalModules;
 // Set to true if we want to enable incremental compilation.
 extern bool fIncrementalCompilation;
 
+// Number of parallel back-end compilation jobs, 0 for serial make.
+extern int fParMakeJobs;
+// Launcher prefixed to each back-end compile command (e.g. distcc);
+// empty means compile locally.
+extern char fBackendJobRunner[256];
+// Shared directory for content-addressed caching of back-end objects;
+// empty disables caching.
+extern char fBackendCacheDir[FILENAME_MAX+1];
+extern int fParallelPasses;
+
 // LLVM flags (-mllvm)
 extern std::string llvmFlags;
 
+// Extra target CPUs to multiversion vectorizable kernels for,
+// comma-separated; empty means no multiversioning.  LLVM back end only.
+extern char fTargetCpuVersions[256];
+
 extern bool fPrintAdditionalErrors;
 
 extern bool fCompilerLibraryParser;
@@ -42,6 +42,8 @@
 
 #include "chpl.h"
 
+#include <cstdint>
+
 
 class BaseAST;
 class Symbol;
@@ -63,6 +65,84 @@ enum Flag {
   INT_ASSERT(FLAG_FIRST <= (FLAG) && (FLAG) <= FLAG_LAST)
 
 
+//
+// Packed storage for a symbol's flags.  This replaces std::bitset so
+// that the hot single-flag test - the most frequent operation in a
+// compiler profile - inlines down to a shift and AND on one 64-bit
+// word, and so that masks combining several flags can be built at
+// compile time (see makeFlagSet() below and Symbol::hasAnyFlag()).
+//
+class FlagSet {
+public:
+  static const int nWords = (NUM_FLAGS + 63) / 64;
+
+  constexpr FlagSet() : words() { }
+
+  constexpr bool test(int flag) const {
+    return (words[flag >> 6] >> (flag & 63)) & 1;
+  }
+
+  constexpr bool operator[](int flag) const {
+    return test(flag);
+  }
+
+  constexpr void set(int flag) {
+    words[flag >> 6] |= (uint64_t)1 << (flag & 63);
+  }
+
+  constexpr void reset(int flag) {
+    words[flag >> 6] &= ~((uint64_t)1 << (flag & 63));
+  }
+
+  bool any() const {
+    uint64_t accum = 0;
+    for (int i = 0; i < nWords; i++)
+      accum |= words[i];
+    return accum != 0;
+  }
+
+  bool none() const {
+    return !any();
+  }
+
+  // Does this set have any flag in common with 'mask'?  With a
+  // compile-time mask the loop reduces to one AND per non-zero mask
+  // word - usually just one.
+  bool hasAny(const FlagSet& mask) const {
+    uint64_t accum = 0;
+    for (int i = 0; i < nWords; i++)
+      accum |= words[i] & mask.words[i];
+    return accum != 0;
+  }
+
+  FlagSet& operator|=(const FlagSet& other) {
+    for (int i = 0; i < nWords; i++)
+      words[i] |= other.words[i];
+    return *this;
+  }
+
+  FlagSet operator&(const FlagSet& other) const {
+    FlagSet ret;
+    for (int i = 0; i < nWords; i++)
+      ret.words[i] = words[i] & other.words[i];
+    return ret;
+  }
+
+private:
+  uint64_t words[nWords];
+};
+
+// Build a FlagSet mask from a list of flags at compile time, e.g.
+//   static constexpr FlagSet mask = makeFlagSet(FLAG_ARRAY, FLAG_DOMAIN);
+template <typename... Flags>
+constexpr FlagSet makeFlagSet(Flags... fs) {
+  FlagSet ret;
+  int dummy[] = { 0, (ret.set(fs), 0)... };
+  (void)dummy;
+  return ret;
+}
+
+
 Flag pragma2flag(const char* str);
 void initFlags();
 void viewFlags(BaseAST* sym);
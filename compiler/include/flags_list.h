@@ -84,6 +84,9 @@ symbolFlag( FLAG_CHAPEL_BYTES_LITERAL, npr, "chapel bytes literal id" , "mark Ch
 symbolFlag( FLAG_CHPL__ITER , npr, "chpl__iter", "used as a marker to implement forall intents" )
 // Marks chpl__iter things created for ForallStmt.
 symbolFlag( FLAG_CHPL__ITER_NEWSTYLE , npr, "chpl__iter_newstyle", ncm )
+// Codegen the variable's declaration aligned to a cache line, to keep
+// per-task state (e.g. reduce-intent accumulators) from false sharing.
+symbolFlag( FLAG_CACHELINE_ALIGN , npr, "cacheline align" , "codegen declaration aligned to a cache line" )
 symbolFlag( FLAG_COBEGIN_OR_COFORALL , npr, "cobegin or coforall" , ncm )
 symbolFlag( FLAG_COBEGIN_OR_COFORALL_BLOCK , npr, "cobegin or coforall block" , ncm )
 symbolFlag( FLAG_COERCE_TEMP , npr, "coerce temp" , "a temporary that was stores the result of a coercion" )
@@ -449,6 +452,7 @@ symbolFlag( FLAG_SYNC , ypr, "sync" , ncm )
 
 symbolFlag( FLAG_SYNTACTIC_DISTRIBUTION , ypr, "syntactic distribution" , ncm )
 symbolFlag( FLAG_TASK_FN_FROM_ITERATOR_FN , npr, "task fn from iterator fn" , ncm )
+symbolFlag( FLAG_TASK_FN_NON_BLOCKING , ypr, "task fn non blocking" , "task function expected to run to completion without blocking; lets the tasking layer run it on a preallocated descriptor" )
 symbolFlag( FLAG_TASK_SPAWN_IMPL_FN , ypr, "task spawn impl fn" , ncm )
 symbolFlag( FLAG_TASK_COMPLETE_IMPL_FN , ypr, "task complete impl fn" , ncm )
 symbolFlag( FLAG_TASK_JOIN_IMPL_FN , ypr, "task join impl fn" , ncm )
@@ -501,6 +505,7 @@ symbolFlag( OPT_INFO_LHS_OUTLIVES_FORALL , npr, "lhs outlives forall" , "lhs or
 symbolFlag( OPT_INFO_RHS_OUTLIVES_FORALL , npr, "rhs outlives forall" , "rhs or sourceoutlives forall" )
 symbolFlag( OPT_INFO_FLAG_NO_TASK_PRIVATE , npr, "forall no task private" , "forall does not use task private storage" )
 symbolFlag( OPT_INFO_FLAG_NO_BLOCKING , npr, "forall not blocking" , "forall does not have blocking synchronization" )
+symbolFlag( OPT_INFO_FLAG_YIELDING_GET , npr, "forall yielding get" , "read in a forall that may yield while waiting" )
 
 #undef ypr
 #undef npr
@@ -25,7 +25,7 @@
 #include <string>
 #include <vector>
 
-// used to generate chpl_filenameTable
+// used to generate chpl_filenameTableData/Offsets
 extern std::vector<std::string> gFilenameLookup;
 
 // Caches the location of filenames in gFilenameLookup
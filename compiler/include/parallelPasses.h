@@ -0,0 +1,164 @@
+/*
+ * Copyright 2020-2021 Hewlett Packard Enterprise Development LP
+ * Copyright 2004-2019 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _PARALLEL_PASSES_H_
+#define _PARALLEL_PASSES_H_
+
+//
+// Parallel traversal support for embarrassingly parallel passes.
+//
+// parForVec() and parReduceVec() run a visitor over the elements of
+// one of the global AST vectors (gFnSymbols, gCallExprs, ...), on up
+// to --parallel-passes worker threads.  Workers claim chunks of the
+// vector from a shared atomic cursor, so uneven elements (one huge
+// function among many small ones) rebalance automatically.
+//
+// The visitor contracts are deliberately narrow:
+//
+//  * parForVec(): the visitor may read the AST freely but must not
+//    create, move, or delete nodes, must not touch memoizing caches,
+//    and must funnel any global side effect -- in practice, issuing
+//    diagnostics -- through a ParDiagGuard.  With the guard held it
+//    is safe to call the USR_* routines and anything they drag in
+//    (astr(), toString()).
+//
+//  * parReduceVec(): as above, plus each worker accumulates into its
+//    own copy of the caller's state, and the caller's combine
+//    function folds the per-worker states together after the join.
+//    Reduction visitors therefore need no guard at all unless they
+//    also emit diagnostics.
+//
+// With --parallel-passes unset (or 1) both calls degenerate to the
+// plain serial loop, preserving today's behavior and diagnostic
+// order exactly.  In parallel runs the set of diagnostics is the
+// same but their interleaving may differ.
+//
+
+#include "vec.h"
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Worker thread count: --parallel-passes, clamped to the hardware.
+int parallelPassThreads();
+
+// The mutex behind ParDiagGuard; exposed for the guard only.
+std::mutex& parallelPassDiagMutex();
+
+// Holds the diagnostics lock for the enclosing scope.
+class ParDiagGuard {
+public:
+  ParDiagGuard() : guard(parallelPassDiagMutex()) { }
+
+private:
+  std::lock_guard<std::mutex> guard;
+};
+
+// How many vector elements a worker claims per visit to the shared
+// cursor; coarse enough to keep the cursor cool, fine enough to
+// rebalance around the occasional huge element.
+static const int parPassChunk = 64;
+
+template <typename T, typename VisitFn>
+void parForVec(Vec<T*>& vec, VisitFn visit) {
+  int nThreads = parallelPassThreads();
+
+  if (nThreads <= 1 || vec.n < 2 * parPassChunk) {
+    forv_Vec(T, elem, vec) {
+      if (elem != NULL) {
+        visit(elem);
+      }
+    }
+    return;
+  }
+
+  std::atomic<int> cursor(0);
+
+  auto worker = [&vec, &cursor, &visit]() {
+    int start;
+    while ((start = cursor.fetch_add(parPassChunk)) < vec.n) {
+      int end = (start + parPassChunk < vec.n) ? start + parPassChunk : vec.n;
+      for (int i = start; i < end; i++) {
+        if (vec.v[i] != NULL) {
+          visit(vec.v[i]);
+        }
+      }
+    }
+  };
+
+  std::vector<std::thread> helpers;
+  for (int t = 1; t < nThreads; t++) {
+    helpers.emplace_back(worker);
+  }
+  worker();
+  for (size_t t = 0; t < helpers.size(); t++) {
+    helpers[t].join();
+  }
+}
+
+template <typename T, typename State, typename VisitFn, typename CombineFn>
+State parReduceVec(Vec<T*>& vec, State identity,
+                   VisitFn visit, CombineFn combine) {
+  int nThreads = parallelPassThreads();
+
+  if (nThreads <= 1 || vec.n < 2 * parPassChunk) {
+    State state = identity;
+    forv_Vec(T, elem, vec) {
+      if (elem != NULL) {
+        visit(state, elem);
+      }
+    }
+    return state;
+  }
+
+  std::atomic<int> cursor(0);
+  std::vector<State> states(nThreads, identity);
+
+  auto worker = [&vec, &cursor, &visit, &states](int me) {
+    int start;
+    while ((start = cursor.fetch_add(parPassChunk)) < vec.n) {
+      int end = (start + parPassChunk < vec.n) ? start + parPassChunk : vec.n;
+      for (int i = start; i < end; i++) {
+        if (vec.v[i] != NULL) {
+          visit(states[me], vec.v[i]);
+        }
+      }
+    }
+  };
+
+  std::vector<std::thread> helpers;
+  for (int t = 1; t < nThreads; t++) {
+    helpers.emplace_back(worker, t);
+  }
+  worker(0);
+  for (size_t t = 0; t < helpers.size(); t++) {
+    helpers[t].join();
+  }
+
+  State result = states[0];
+  for (int t = 1; t < nThreads; t++) {
+    combine(result, states[t]);
+  }
+  return result;
+}
+
+#endif
@@ -0,0 +1,63 @@
+/*
+ * Copyright 2020-2021 Hewlett Packard Enterprise Development LP
+ * Copyright 2004-2019 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _PASS_RESOURCES_H_
+#define _PASS_RESOURCES_H_
+
+#include <cstddef>
+
+//
+// A registry of pass-owned side structures -- caches, maps and sets that
+// a pass builds up but that no pass after some point ever reads.  Left
+// alone they live until exit and contribute to the compile's high-water
+// memory mark.
+//
+// A pass registers each such structure along with the name of its last
+// consuming pass and a function that frees it; runPass() retires every
+// resource whose last consumer just finished.  An optional size callback
+// lets the --print-passes report show how many bytes registered
+// resources still hold after each pass.
+//
+
+// Frees the resource; must be safe to call once after the last consumer.
+typedef void   (*PassResourceRetireFn)();
+
+// Approximate bytes currently held by the resource.
+typedef size_t (*PassResourceSizeFn)();
+
+// Register 'name' to be retired after pass 'lastConsumer' runs.
+// Re-registering an already-known name is a no-op, so passes can
+// register at their entry point even when run more than once.
+void   registerPassResource(const char*          name,
+                            const char*          lastConsumer,
+                            PassResourceRetireFn retireFn,
+                            PassResourceSizeFn   sizeFn);
+
+// Retire every resource whose last consumer is 'passName'.
+void   retirePassResources(const char* passName);
+
+// Retire anything still live, e.g. after an early --stop-after-pass exit.
+void   retireAllPassResources();
+
+// Bytes still held by live registered resources (0 for resources
+// without a size callback).
+size_t passResourcesRetainedBytes();
+
+#endif
@@ -51,10 +51,13 @@ void docs();
 void expandExternArrayCalls();
 void flattenClasses();
 void flattenFunctions();
+void globalValueNumbering();
 void inlineFunctions();
 void insertLineNumbers();
 void insertWideReferences();
 void localizeGlobals();
+void loopFusion();
+void loopTiling();
 void loopInvariantCodeMotion();
 void lowerErrorHandling();
 void lowerIterators();
@@ -64,7 +67,9 @@ void optimizeOnClauses();
 void parallel();
 void prune();
 void prune2();
+void prune3();
 void readExternC();
+void reorderFields();
 void refPropagation();
 void removeEmptyRecords();
 void removeUnnecessaryAutoCopyCalls();
@@ -73,6 +78,7 @@ void resolve();
 void resolveIntents();
 void returnStarTuplesByRefArgs();
 void scalarReplace();
+void stackAllocateClasses();
 void scopeResolve();
 void verify();
 
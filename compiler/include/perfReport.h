@@ -0,0 +1,53 @@
+/*
+ * Copyright 2020-2021 Hewlett Packard Enterprise Development LP
+ * Copyright 2004-2019 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _PERF_REPORT_H_
+#define _PERF_REPORT_H_
+
+class BaseAST;
+
+//
+// --perf-report: a consolidated per-loop performance report.
+//
+// The individual --report-* flags each print their findings as the
+// relevant pass runs, which makes it hard to see, for one forall, what
+// the compiler did to it overall.  When --perf-report is set, passes
+// record their per-loop findings here (keyed by source location) and a
+// single table is printed at the end of compilation.
+//
+// Recording is a no-op unless --perf-report was given, and only loops
+// in user modules are recorded (all modules with --devel).  Entries
+// store formatted strings, not AST pointers, so printing is safe after
+// the AST has been destroyed.
+//
+
+// Record whether the loop at 'ast' is eligible for vectorization hints;
+// 'reason' explains a hazard (may be NULL when vectorizable).
+void perfReportVectorization(BaseAST* ast, bool vectorizable,
+                             const char* reason);
+
+// Record that the named optimization fired for the loop at 'ast'.
+void perfReportOptimization(BaseAST* ast, const char* optimization);
+
+// Print the consolidated table to stdout; called once after the passes
+// have run.
+void perfReportPrint();
+
+#endif
@@ -79,6 +79,7 @@
   PRIMITIVE_G(PRIM_ASSIGN)
   PRIMITIVE_R(PRIM_ASSIGN_ELIDED_COPY)
   PRIMITIVE_G(PRIM_UNORDERED_ASSIGN)
+  PRIMITIVE_G(PRIM_YIELDING_ASSIGN)
   PRIMITIVE_G(PRIM_ADD_ASSIGN)
   PRIMITIVE_G(PRIM_SUBTRACT_ASSIGN)
   PRIMITIVE_G(PRIM_MULT_ASSIGN)
@@ -247,6 +248,9 @@
   PRIMITIVE_G(PRIM_RT_ERROR)
   PRIMITIVE_G(PRIM_RT_WARNING)
 
+  PRIMITIVE_G(PRIM_FORALL_ENTER)
+  PRIMITIVE_G(PRIM_FORALL_EXIT)
+
   PRIMITIVE_G(PRIM_NEW_PRIV_CLASS)
 
   PRIMITIVE_R(PRIM_GET_USER_LINE)
@@ -313,6 +317,10 @@
   PRIMITIVE_R(PRIM_GET_COMPILER_VAR)
   PRIMITIVE_R(PRIM_GET_VISIBLE_SYMBOLS)
 
+  PRIMITIVE_R(PRIM_WRITEF_FMT_OK)
+  PRIMITIVE_R(PRIM_WRITEF_FMT_COUNT)
+  PRIMITIVE_R(PRIM_WRITEF_FMT_SEGMENT)
+
   PRIMITIVE_G(PRIM_STACK_ALLOCATE_CLASS)
 
   PRIMITIVE_R(PRIM_ZIP)
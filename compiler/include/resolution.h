@@ -208,6 +208,9 @@ FnSymbol* instantiateSignature(FnSymbol* fn, SymbolMap& subs,
                                VisibilityInfo* info);
 void      instantiateBody(FnSymbol* fn);
 
+// support for --report-instantiations
+void      reportInstantiations();
+
 // generics support
 void checkInfiniteWhereInstantiation(FnSymbol* fn);
 void popInstantiationLimit(FnSymbol* fn);
@@ -24,6 +24,7 @@
 class PhaseTracker;
 
 void runPasses(PhaseTracker& tracker, bool isChpldoc);
+void resumeFromCheckpoint(PhaseTracker& tracker);
 void initPassesForLogging();
 
 extern int currentPassNo;
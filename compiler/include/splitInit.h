@@ -41,6 +41,13 @@ bool findInitPoints(CallExpr* defaultInit,
                     Expr*& usePreventingSplitInit,
                     bool allowReturns);
 
+// 'def' declares a variable with a type expression and no initializer,
+// and 'firstUse' is the use that prevented split init for it (if any).
+// Returns true if the declaration can skip default initialization
+// because 'firstUse' is a loop proven to assign every element before
+// any read; see the comment on the implementation.
+bool elideArrayDefaultInit(DefExpr* def, Expr* firstUse);
+
 void elideCopies(FnSymbol* fn);
 
 void splitInitMissingTypeError(Symbol* sym, Expr* mention, bool unresolved);
@@ -28,7 +28,6 @@
 #include "library.h"
 #include "type.h"
 
-#include <bitset>
 #include <iostream>
 #include <string>
 #include <vector>
@@ -77,8 +76,6 @@ enum IntentTag {
   INTENT_BLANK           = INTENT_FLAG_BLANK
 };
 
-typedef std::bitset<NUM_FLAGS> FlagSet;
-
 /*
 enum ForallIntentTag : task- or forall-intent tags
 
@@ -180,6 +177,7 @@ public:
 
   bool               hasFlag(Flag flag)                        const;
   bool               hasEitherFlag(Flag aflag, Flag bflag)     const;
+  bool               hasAnyFlag(const FlagSet& mask)           const;
 
   void               addFlag(Flag flag);
   void               removeFlag(Flag flag);
@@ -257,6 +255,32 @@ private:
   SymExpr*           symExprsTail;
 };
 
+// These are the most frequently called functions in the compiler, so
+// they are defined inline here rather than in symbol.cpp; for a flag
+// known at compile time each reduces to a single-word shift and AND.
+inline bool Symbol::hasFlag(Flag flag) const {
+  CHECK_FLAG(flag);
+  return flags.test(flag);
+}
+
+inline bool Symbol::hasEitherFlag(Flag aflag, Flag bflag) const {
+  return hasFlag(aflag) || hasFlag(bflag);
+}
+
+inline bool Symbol::hasAnyFlag(const FlagSet& mask) const {
+  return flags.hasAny(mask);
+}
+
+inline void Symbol::addFlag(Flag flag) {
+  CHECK_FLAG(flag);
+  flags.set(flag);
+}
+
+inline void Symbol::removeFlag(Flag flag) {
+  CHECK_FLAG(flag);
+  flags.reset(flag);
+}
+
 #define forv_Symbol(_p, _v) forv_Vec(Symbol, _p, _v)
 
 #define for_SymbolSymExprs(se, symbol)                                  \
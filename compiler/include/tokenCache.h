@@ -0,0 +1,61 @@
+/*
+ * Copyright 2020-2021 Hewlett Packard Enterprise Development LP
+ * Copyright 2004-2019 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _TOKEN_CACHE_H_
+#define _TOKEN_CACHE_H_
+
+#include "bison-chapel.h"
+
+#include "ModuleSymbol.h"
+
+#include <cstdio>
+
+//
+// A cache of post-lex token streams for internal and standard module
+// files, keyed by a hash of the file contents and enabled with
+// --token-cache <dir>.  On a hit the recorded tokens are pushed straight
+// into the bison push parser, skipping the lexer entirely; on a miss the
+// parse loop in parser.cpp records the stream as it lexes so the next
+// compile can replay it.
+//
+
+// Directory holding cached token streams; empty when the cache is off
+extern char tokenCacheDir[FILENAME_MAX + 1];
+
+// Is the cache usable for this file in this compilation mode?
+bool tokenCacheIsEligible(const char* path, ModTag modTag);
+
+// Push a cached token stream for 'path' into 'parser'.  Returns true and
+// sets *parserStatus if the file was replayed from the cache.
+bool tokenCacheReplay(const char*    path,
+                      ModTag         modTag,
+                      yypstate*      parser,
+                      ParserContext* context,
+                      int*           parserStatus);
+
+// Recording a stream during a normal lex+parse of an eligible file
+void tokenCacheStartRecording();
+void tokenCacheRecordToken(int            lexerStatus,
+                           const YYSTYPE* yylval,
+                           const YYLTYPE* yylloc,
+                           const char*    rawText);
+void tokenCacheStopRecording(const char* path, ModTag modTag, bool keep);
+
+#endif
@@ -380,12 +380,12 @@ Vec<C,S>::addx() {
       while (!(l&1)) { l = l >> 1; nl++; }
       l = l >> 1;
       if (!l) {
-        void *vv = (void*)v;
+        // Grow in place when the allocator permits; elements are PODs or
+        // pointers (we memcpy them freely elsewhere), so realloc is safe
+        // and avoids the copy that malloc+memcpy+free would always pay.
         nl = 1 << nl;
-        v = (C*)malloc(nl * sizeof(C));
-        memcpy((void*)v, vv, n * sizeof(C));
+        v = (C*)realloc((void*)v, nl * sizeof(C));
         memset((void*)&v[n], 0, (nl - n) * sizeof(C));
-        free(vv);
       }
     }
   }
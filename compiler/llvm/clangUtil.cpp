@@ -57,6 +57,7 @@
 #include "llvm/Analysis/TargetLibraryInfo.h"
 #include "llvm/Analysis/TargetTransformInfo.h"
 #include "llvm/Bitcode/BitcodeWriter.h"
+#include "llvm/IR/IRBuilder.h"
 #include "llvm/IR/LegacyPassManager.h"
 #include "llvm/IR/Verifier.h"
 #include "llvm/MC/SubtargetFeature.h"
@@ -70,6 +71,8 @@
 #include "llvm/Transforms/IPO.h"
 #include "llvm/Transforms/IPO/AlwaysInliner.h"
 #include "llvm/Transforms/IPO/PassManagerBuilder.h"
+#include "llvm/Transforms/Utils/Cloning.h"
+#include "llvm/Transforms/Utils/ModuleUtils.h"
 
 #if HAVE_LLVM_VER >= 90
 #include "llvm/Support/CodeGen.h"
@@ -85,6 +88,7 @@
 #include "driver.h"
 #include "expr.h"
 #include "files.h"
+#include "LoopStmt.h"
 #include "mli.h"
 #include "mysystem.h"
 #include "passes.h"
@@ -1265,6 +1269,42 @@ void readMacrosClang(void) {
   }
 };
 
+// Register a top-level C declaration with the layered value table so
+// extern block resolution can find it by name.  Called from the AST
+// consumer as declarations are parsed, and again over the whole
+// translation unit when the declarations were deserialized from a
+// cached PCH (those bypass HandleTopLevelDecl).
+static void lvtRegisterExternDecl(GenInfo* info, Decl* d) {
+  if (TypedefDecl *td = dyn_cast<TypedefDecl>(d)) {
+    const clang::Type *ctype= td->getUnderlyingType().getTypePtrOrNull();
+    if(ctype != NULL) {
+      info->lvt->addGlobalCDecl(td);
+    }
+  } else if (FunctionDecl *fd = dyn_cast<FunctionDecl>(d)) {
+    info->lvt->addGlobalCDecl(fd);
+  } else if (VarDecl *vd = dyn_cast<VarDecl>(d)) {
+    info->lvt->addGlobalCDecl(vd);
+  } else if (RecordDecl *rd = dyn_cast<RecordDecl>(d)) {
+    info->lvt->addGlobalCDecl(rd);
+  } else if (UsingDecl* ud = dyn_cast<UsingDecl>(d)) {
+    for (auto shadow : ud->shadows()) {
+      NamedDecl* nd = shadow->getTargetDecl();
+      lvtRegisterExternDecl(info, nd);
+    }
+  } else if (LinkageSpecDecl* ld = dyn_cast<LinkageSpecDecl>(d)) {
+    // Handles extern "C" { }
+    for (auto sub : ld->decls()) {
+      lvtRegisterExternDecl(info, sub);
+    }
+  } else if (ExternCContextDecl *ed = dyn_cast<ExternCContextDecl>(d)) {
+    // TODO: is this an alternative extern "C"?
+    // do we need to handle it?
+    for (auto sub : ed->decls()) {
+      lvtRegisterExternDecl(info, sub);
+    }
+  }
+}
+
 // This ASTConsumer helps us to:
 // 1: parse code only in certain configurations
 // 2: Convert C code to LLVM IR in others
@@ -1326,34 +1366,7 @@ class CCodeGenConsumer final : public ASTConsumer {
     }
 
     void doHandleDecl(Decl* d) {
-      if (TypedefDecl *td = dyn_cast<TypedefDecl>(d)) {
-        const clang::Type *ctype= td->getUnderlyingType().getTypePtrOrNull();
-        if(ctype != NULL) {
-          info->lvt->addGlobalCDecl(td);
-        }
-      } else if (FunctionDecl *fd = dyn_cast<FunctionDecl>(d)) {
-        info->lvt->addGlobalCDecl(fd);
-      } else if (VarDecl *vd = dyn_cast<VarDecl>(d)) {
-        info->lvt->addGlobalCDecl(vd);
-      } else if (RecordDecl *rd = dyn_cast<RecordDecl>(d)) {
-        info->lvt->addGlobalCDecl(rd);
-      } else if (UsingDecl* ud = dyn_cast<UsingDecl>(d)) {
-        for (auto shadow : ud->shadows()) {
-          NamedDecl* nd = shadow->getTargetDecl();
-          doHandleDecl(nd);
-        }
-      } else if (LinkageSpecDecl* ld = dyn_cast<LinkageSpecDecl>(d)) {
-        // Handles extern "C" { }
-        for (auto sub : ld->decls()) {
-          doHandleDecl(sub);
-        }
-      } else if (ExternCContextDecl *ed = dyn_cast<ExternCContextDecl>(d)) {
-        // TODO: is this an alternative extern "C"?
-        // do we need to handle it?
-        for (auto sub : ed->decls()) {
-          doHandleDecl(sub);
-        }
-      }
+      lvtRegisterExternDecl(info, d);
     }
 
     // HandleTopLevelDecl - Handle the specified top-level declaration.
@@ -2028,6 +2041,221 @@ static void setupModule()
       /*IsConstant=*/true);
 }
 
+//
+// --target-cpu-versions: per-CPU multiversioning of vectorizable
+// kernels.
+//
+// We generate one binary but it often runs on several CPU generations;
+// compiling for the oldest loses the wider SIMD of the newest.  For
+// each function containing a loop the compiler marked vectorizable,
+// clone the function once per requested CPU with a matching target-cpu
+// attribute, so the vectorizer can use that CPU's full vector width in
+// the clone.  Calls to the function are routed through an internal
+// function pointer that a global constructor sets at program start by
+// testing, in the order given on the command line, whether the running
+// CPU supports each version's gate feature (chpl_sys_cpuSupportsFeature
+// in the runtime); versions should therefore be listed newest first.
+// If no version matches, the pointer keeps the original function, so
+// the dispatch is safe on any CPU including non-x86.
+//
+
+struct MultiversionTarget {
+  std::string cpu;     // for the clone's target-cpu attribute
+  std::string feature; // runtime feature test gating the clone
+};
+
+// The CPU feature implied by compiling for a given CPU, i.e. the
+// feature to test at program start before selecting that version.
+// Entries the runtime feature test knows about; see
+// chpl_sys_cpuSupportsFeature().
+static const struct {
+  const char* cpu;
+  const char* feature;
+} multiversionCpuGates[] = {
+  { "sandybridge",    "avx"     },
+  { "ivybridge",      "avx"     },
+  { "haswell",        "avx2"    },
+  { "broadwell",      "avx2"    },
+  { "skylake",        "avx2"    },
+  { "znver1",         "avx2"    },
+  { "znver2",         "avx2"    },
+  { "znver3",         "avx2"    },
+  { "skylake-avx512", "avx512f" },
+  { "cascadelake",    "avx512f" },
+  { "icelake-client", "avx512f" },
+  { "icelake-server", "avx512f" },
+};
+
+static std::vector<MultiversionTarget> parseMultiversionTargets() {
+  std::vector<MultiversionTarget> targets;
+  std::stringstream ss(fTargetCpuVersions);
+  std::string entry;
+
+  while (std::getline(ss, entry, ',')) {
+    if (entry.empty())
+      continue;
+
+    MultiversionTarget target;
+
+    // a "cpu:feature" entry names its gate feature explicitly
+    size_t colon = entry.find(':');
+    if (colon != std::string::npos) {
+      target.cpu = entry.substr(0, colon);
+      target.feature = entry.substr(colon + 1);
+    } else {
+      target.cpu = entry;
+      for (size_t i = 0;
+           i < sizeof(multiversionCpuGates)/sizeof(multiversionCpuGates[0]);
+           i++) {
+        if (target.cpu == multiversionCpuGates[i].cpu) {
+          target.feature = multiversionCpuGates[i].feature;
+          break;
+        }
+      }
+      if (target.feature.empty())
+        USR_FATAL("--target-cpu-versions: unknown CPU '%s'; "
+                  "use '%s:<feature>' to name its gate feature",
+                  target.cpu.c_str(), target.cpu.c_str());
+    }
+
+    targets.push_back(target);
+  }
+
+  return targets;
+}
+
+// Does this function contain a loop the compiler considers
+// vectorizable?  Those are the kernels worth multiversioning.
+static bool fnHasVectorizableLoop(FnSymbol* fn) {
+  std::vector<Expr*> stmts;
+  collect_stmts(fn->body, stmts);
+  for_vector(Expr, stmt, stmts) {
+    if (BlockStmt* block = toBlockStmt(stmt))
+      if (block->isLoopStmt())
+        if (toLoopStmt(block)->isVectorizable())
+          return true;
+  }
+  return false;
+}
+
+static void multiversionFunctions() {
+  GenInfo* info = gGenInfo;
+
+  if (fTargetCpuVersions[0] == '\0')
+    return;
+  if (gCodegenGPU)
+    return;
+
+  std::vector<MultiversionTarget> targets = parseMultiversionTargets();
+  if (targets.empty())
+    return;
+
+  llvm::Module* M = info->module;
+  llvm::LLVMContext& ctx = M->getContext();
+
+  llvm::FunctionType* supportsTy =
+    llvm::FunctionType::get(llvm::Type::getInt32Ty(ctx),
+                            { llvm::Type::getInt8PtrTy(ctx) },
+                            /* isVarArg */ false);
+  llvm::FunctionCallee supportsFn =
+    M->getOrInsertFunction("chpl_sys_cpuSupportsFeature", supportsTy);
+
+  forv_Vec(FnSymbol, fn, gFnSymbols) {
+    if (fn->hasFlag(FLAG_EXTERN) || fn->hasFlag(FLAG_EXPORT))
+      continue;
+    if (!fnHasVectorizableLoop(fn))
+      continue;
+
+    llvm::Function* F = M->getFunction(fn->cname);
+    if (F == NULL || F->isDeclaration() || F->isVarArg())
+      continue;
+
+    // Clone the kernel once per requested CPU.  The clone inherits the
+    // body but compiles for its own CPU; clearing target-features lets
+    // the back end derive them from the CPU name.
+    std::vector<llvm::Function*> clones;
+    for (size_t i = 0; i < targets.size(); i++) {
+      llvm::ValueToValueMapTy vmap;
+      llvm::Function* C = llvm::CloneFunction(F, vmap);
+      C->setName(F->getName() + "." + targets[i].cpu);
+      C->setLinkage(llvm::GlobalValue::InternalLinkage);
+      C->removeFnAttr("target-cpu");
+      C->removeFnAttr("target-features");
+      C->addFnAttr("target-cpu", targets[i].cpu);
+      clones.push_back(C);
+    }
+
+    // The dispatcher takes over the original name; existing call sites
+    // keep working, including indirect ones.
+    std::string origName = F->getName().str();
+    F->setName(origName + ".default");
+
+    llvm::Function* W = llvm::Function::Create(F->getFunctionType(),
+                                               F->getLinkage(),
+                                               origName, M);
+    W->copyAttributesFrom(F);
+    W->setCallingConv(F->getCallingConv());
+    F->replaceAllUsesWith(W);
+
+    // The function pointer the dispatcher calls through, defaulting to
+    // the original version.
+    llvm::GlobalVariable* fnPtr =
+      new llvm::GlobalVariable(*M, F->getType(), /* isConstant */ false,
+                               llvm::GlobalValue::InternalLinkage,
+                               F, origName + ".version.ptr");
+
+    // Constructor: take the first version whose gate feature the
+    // running CPU supports.
+    llvm::FunctionType* ctorTy =
+      llvm::FunctionType::get(llvm::Type::getVoidTy(ctx), false);
+    llvm::Function* ctor =
+      llvm::Function::Create(ctorTy, llvm::GlobalValue::InternalLinkage,
+                             origName + ".version.select", M);
+    llvm::BasicBlock* done = llvm::BasicBlock::Create(ctx, "done", ctor);
+    llvm::IRBuilder<> cb(llvm::BasicBlock::Create(ctx, "entry", ctor, done));
+    for (size_t i = 0; i < targets.size(); i++) {
+      llvm::Value* feature =
+        cb.CreateGlobalStringPtr(targets[i].feature);
+      llvm::Value* supported = cb.CreateCall(supportsFn, feature);
+      llvm::Value* cond =
+        cb.CreateICmpNE(supported,
+                        llvm::ConstantInt::get(supported->getType(), 0));
+      llvm::BasicBlock* hit = llvm::BasicBlock::Create(ctx, "", ctor, done);
+      llvm::BasicBlock* next = llvm::BasicBlock::Create(ctx, "", ctor, done);
+      cb.CreateCondBr(cond, hit, next);
+      cb.SetInsertPoint(hit);
+      cb.CreateStore(clones[i], fnPtr);
+      cb.CreateBr(done);
+      cb.SetInsertPoint(next);
+    }
+    cb.CreateBr(done);
+    cb.SetInsertPoint(done);
+    cb.CreateRetVoid();
+    llvm::appendToGlobalCtors(*M, ctor, 0);
+
+    // Dispatcher body: forward through the pointer.
+    llvm::IRBuilder<> wb(llvm::BasicBlock::Create(ctx, "entry", W));
+    llvm::Value* target = wb.CreateLoad(F->getType(), fnPtr);
+    std::vector<llvm::Value*> args;
+    for (llvm::Function::arg_iterator it = W->arg_begin();
+         it != W->arg_end();
+         ++it) {
+      args.push_back(&*it);
+    }
+    llvm::CallInst* call = wb.CreateCall(F->getFunctionType(), target, args);
+    call->setCallingConv(F->getCallingConv());
+    call->setTailCall(true);
+    if (W->getReturnType()->isVoidTy())
+      wb.CreateRetVoid();
+    else
+      wb.CreateRet(call);
+
+    if (developer)
+      printf("multiversioned %s for %d target CPUs\n",
+             origName.c_str(), (int) targets.size());
+  }
+}
+
 void finishCodegenLLVM() {
   GenInfo* info = gGenInfo;
 
@@ -2044,6 +2272,10 @@ void finishCodegenLLVM() {
   // Now finish any Clang code generation.
   finishClang(info->clangInfo);
 
+  // Clone hot kernels for the requested target CPUs and route calls
+  // through per-kernel dispatchers (--target-cpu-versions).
+  multiversionFunctions();
+
   // Now overwrite the value of llvm.ident to show Chapel
   char version[128];
   char chapel_string[256];
@@ -2230,7 +2462,107 @@ bool setAlreadyConvertedExtern(ModuleSymbol* module, const char* name)
 }
 
 
+// --extern-c-cache support: reuse a clang PCH for extern block parsing
+// across compiles, so heavy system headers (HDF5, MPI, ...) are
+// deserialized instead of reparsed.  Disabled for the rest of the
+// compile once a stale cache entry is hit.
+static bool gExternCCacheDisabled = false;
+
+// FNV-1a over the clang configuration and the extern block source.
+// The source contains the #include directives, so changing which
+// headers are pulled in changes the key; edits to the headers
+// themselves are caught by clang's own PCH dependency validation.
+static uint64_t hashExternBlock(const std::string& clangCC,
+                                const std::vector<std::string>& clangCCArgs,
+                                const char* filename) {
+  uint64_t h = UINT64_C(0xcbf29ce484222325);
+  auto hashMem = [&h](const void* p, size_t len) {
+    const unsigned char* s = (const unsigned char*) p;
+    for (size_t i = 0; i < len; i++) {
+      h ^= s[i];
+      h *= UINT64_C(0x100000001b3);
+    }
+  };
+
+  // include the terminating NULs so adjacent strings don't collide
+  hashMem(clangCC.c_str(), clangCC.size() + 1);
+  for (size_t i = 0; i < clangCCArgs.size(); i++)
+    hashMem(clangCCArgs[i].c_str(), clangCCArgs[i].size() + 1);
+
+  if (FILE* f = fopen(filename, "rb")) {
+    char buf[4096];
+    size_t got;
+    while ((got = fread(buf, 1, sizeof(buf), f)) > 0)
+      hashMem(buf, got);
+    fclose(f);
+  }
+
+  return h;
+}
+
+// Returns the path of a PCH covering this extern block, building it on
+// a cache miss, or "" if the cache cannot be used.  The PCH is built
+// from a stable copy of the extern block source kept in the cache
+// directory: clang validates PCH dependencies by size and mtime, and
+// the per-compile temp file would fail that check every time.
+static std::string setupExternBlockPCH(const std::string& clangCC,
+                            const std::vector<std::string>& clangCCArgs,
+                            const char* just_parse_filename) {
+  if (llvm::sys::fs::create_directories(externCCacheDir))
+    return "";
+
+  uint64_t h = hashExternBlock(clangCC, clangCCArgs, just_parse_filename);
+  char entry[64];
+  snprintf(entry, sizeof(entry), "/extern-%016llx",
+           (unsigned long long) h);
+  std::string stem = std::string(externCCacheDir) + entry;
+  std::string pchPath = stem + ".pch";
+  std::string srcPath = stem + ".h";
+
+  if (llvm::sys::fs::exists(pchPath))
+    return pchPath;
+
+  // Miss: stash the stable copy, with sys_basic.h included first to
+  // mirror the real parse, then shell out to clang to build the PCH.
+  {
+    FILE* in = fopen(just_parse_filename, "rb");
+    if (in == NULL)
+      return "";
+    FILE* out = fopen(srcPath.c_str(), "w");
+    if (out == NULL) {
+      fclose(in);
+      return "";
+    }
+    fputs("#include \"sys_basic.h\"\n", out);
+    char buf[4096];
+    size_t got;
+    while ((got = fread(buf, 1, sizeof(buf), in)) > 0)
+      fwrite(buf, 1, got, out);
+    fclose(in);
+    fclose(out);
+  }
+
+  std::string cmd = clangCC;
+  for (size_t i = 0; i < clangCCArgs.size(); i++) {
+    cmd += " ";
+    cmd += clangCCArgs[i];
+  }
+  cmd += " -x c-header ";
+  cmd += srcPath;
+  cmd += " -o ";
+  cmd += pchPath;
+
+  if (mysystem(cmd.c_str(), "building extern block PCH",
+               /* ignorestatus */ true) != 0) {
+    llvm::sys::fs::remove(pchPath);
+    return "";
+  }
+
+  return pchPath;
+}
+
 void runClang(const char* just_parse_filename) {
+  std::string externBlockPCH;
   static bool is_installed_fatal_error_handler = false;
 
   const char* clang_warn[] = {"-Wall", "-Werror", "-Wpointer-arith",
@@ -2388,6 +2720,14 @@ void runClang(const char* just_parse_filename) {
   if (ffloatOpt < 0) // --ieee-float
     args.push_back(clang_ieee_float); // -fno-fast-math
 
+  // --perf-report: have the back end print its loop-vectorization
+  // remarks so the per-loop report can be checked against what the
+  // optimizer actually did (the front end only reports hazards).
+  if (fPerfReport) {
+    args.push_back("-Rpass=loop-vectorize");
+    args.push_back("-Rpass-missed=loop-vectorize");
+  }
+
   // Gather information from readargsfrom into clangArgs.
 
   // Note that these CC arguments will be saved in info->clangCCArgs
@@ -2507,8 +2847,20 @@ void runClang(const char* just_parse_filename) {
     }
   } else {
     // Just running clang to parse the extern blocks for this module.
-    clangOtherArgs.push_back("-include");
-    clangOtherArgs.push_back(just_parse_filename);
+    if (externCCacheDir[0] && !gExternCCacheDisabled)
+      externBlockPCH = setupExternBlockPCH(clangCC, clangCCArgs,
+                                           just_parse_filename);
+
+    if (!externBlockPCH.empty()) {
+      // Start from the cached, pre-parsed headers; the -include of
+      // sys_basic.h above degenerates to a guard check against the
+      // macros the PCH brings in.
+      clangOtherArgs.push_back("-include-pch");
+      clangOtherArgs.push_back(externBlockPCH);
+    } else {
+      clangOtherArgs.push_back("-include");
+      clangOtherArgs.push_back(just_parse_filename);
+    }
   }
 
   if( printSystemCommands ) {
@@ -2574,6 +2926,17 @@ void runClang(const char* just_parse_filename) {
     clangInfo->cCodeGenAction = new CCodeGenAction();
     if (!clangInfo->Clang->ExecuteAction(*clangInfo->cCodeGenAction)) {
       if (just_parse_filename) {
+        if (!externBlockPCH.empty()) {
+          // Most likely a header changed underneath the cached PCH and
+          // clang rejected it; drop the entry and reparse from source.
+          USR_WARN("stale extern block cache entry for %s; reparsing",
+                   just_parse_filename);
+          llvm::sys::fs::remove(externBlockPCH);
+          gExternCCacheDisabled = true;
+          runClang(just_parse_filename);
+          gExternCCacheDisabled = false;
+          return;
+        }
         USR_FATAL("error running clang on extern block");
       } else {
         USR_FATAL("error running clang during code generation");
@@ -2602,6 +2965,16 @@ void runClang(const char* just_parse_filename) {
         llvm::BasicBlock::Create(info->module->getContext(), "entry", F);
       info->irBuilder->SetInsertPoint(block);
     }
+    if (parseOnly && !externBlockPCH.empty()) {
+      // Declarations deserialized from the cached PCH bypass
+      // HandleTopLevelDecl, so register them with the layered value
+      // table here; walking them is what forces deserialization.
+      ASTContext* Ctx = clangInfo->Ctx;
+      INT_ASSERT(Ctx);
+      for (auto d : Ctx->getTranslationUnitDecl()->decls())
+        lvtRegisterExternDecl(gGenInfo, d);
+    }
+
     // read macros. May call IRBuilder methods to codegen a string,
     // so needs to happen after we set the insert point.
     readMacrosClang();
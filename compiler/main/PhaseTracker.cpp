@@ -22,11 +22,33 @@
 
 #include "baseAST.h"
 #include "driver.h"
+#include "passResources.h"
 
 #include <cstdlib>
 #include <cstring>
 #include <algorithm>
 
+#include <sys/resource.h>
+
+//
+// The process's memory high-water mark, in kilobytes, as reported by
+// getrusage().  Sampled at each phase boundary so the pass report can
+// show which pass first drove memory to its peak.
+//
+static unsigned long maxRssKb()
+{
+  struct rusage usage;
+
+  if (getrusage(RUSAGE_SELF, &usage) != 0)
+    return 0;
+
+#ifdef __APPLE__
+  return (unsigned long) (usage.ru_maxrss / 1024); // bytes on macOS
+#else
+  return (unsigned long) usage.ru_maxrss;          // kilobytes elsewhere
+#endif
+}
+
 // Used to collect the times as the program runs
 class Phase
 {
@@ -49,6 +71,8 @@ public:
   int                      mPassId;
   PhaseTracker::SubPhase   mSubPhase;
   unsigned long            mStartTime;  // Elapsed time from main() usecs
+  int                      mNodeCount;  // lastNodeIDUsed() at phase start
+  unsigned long            mRssKb;      // maxRssKb() at phase start
 
 private:
   Phase();
@@ -83,6 +107,8 @@ public:
   unsigned long  mPrimary;          // usecs()
   unsigned long  mVerify;           // usecs()
   unsigned long  mCleanAst;         // usecs()
+  int            mNodeCount;        // lastNodeIDUsed() at end of pass
+  unsigned long  mRssKb;            // maxRssKb() at end of pass
 };
 
 struct SortByTime
@@ -196,6 +222,10 @@ void PhaseTracker::PassesCollect(std::vector<Pass>& passes) const
       // Check if it's time to push an completed pass
       if (i > 0 && mPhases[i]->mSubPhase == PhaseTracker::kPrimary)
       {
+        // the start of this phase is the end of the previous pass
+        pass.mNodeCount = mPhases[i]->mNodeCount;
+        pass.mRssKb     = mPhases[i]->mRssKb;
+
         passes.push_back(pass);
         pass.Reset();
       }
@@ -224,6 +254,10 @@ void PhaseTracker::PassesCollect(std::vector<Pass>& passes) const
       }
     }
 
+    // the final pass is still "live"; sample its end state now
+    pass.mNodeCount = lastNodeIDUsed();
+    pass.mRssKb     = maxRssKb();
+
     passes.push_back(pass);
   }
 }
@@ -287,6 +321,8 @@ Phase::Phase(const char*            name,
   mPassId    = passId;
   mSubPhase  = subPhase;
   mStartTime = startTime;
+  mNodeCount = lastNodeIDUsed();
+  mRssKb     = maxRssKb();
 }
 
 Phase::~Phase()
@@ -311,11 +347,16 @@ void Phase::ReportPass(unsigned long now) const
 
   if (developer == true)
   {
-    char text[32];
+    char text[64];
 
     sprintf(text, "  [%9d]", lastNodeIDUsed());
 
     ReportText(text);
+
+    // bytes still held by registered pass resources (see passResources.h)
+    sprintf(text, "  [%7zu KB retained]", passResourcesRetainedBytes() / 1024);
+
+    ReportText(text);
   }
 
   ReportText("\n");
@@ -363,12 +404,14 @@ Pass::~Pass()
 
 void Pass::Reset()
 {
-  mName     = 0;
-  mPassId   = 0;
-  mIndex    = 0;
-  mPrimary  = 0;
-  mVerify   = 0;
-  mCleanAst = 0;
+  mName      = 0;
+  mPassId    = 0;
+  mIndex     = 0;
+  mPrimary   = 0;
+  mVerify    = 0;
+  mCleanAst  = 0;
+  mNodeCount = 0;
+  mRssKb     = 0;
 }
 
 unsigned long Pass::TotalTime() const
@@ -403,6 +446,8 @@ void Pass::Header(FILE* fp)
 
   fprintf(fp, "    Time    %%  ");
   fprintf(fp, "   Accum    %%  ");
+  fprintf(fp, "  AST nodes");
+  fprintf(fp, "   RSS (MB)");
   fprintf(fp, "\n");
 
 
@@ -415,6 +460,8 @@ void Pass::Header(FILE* fp)
 
   fprintf(fp, "  ------- -----");
   fprintf(fp, "  ------- -----");
+  fprintf(fp, "  ---------");
+  fprintf(fp, "  ---------");
   fprintf(fp, "\n");
 }
 
@@ -439,6 +486,8 @@ void Pass::Print(FILE*         fp,
   fprintf(fp, "  %7.3f  %7.3f  %7.3f", primary, verify, clean);
   fprintf(fp, "  %7.3f %5.1f", passTime  / 1e6, passFrac );
   fprintf(fp, "  %7.3f %5.1f", accumTime / 1e6, accumFrac);
+  fprintf(fp, "  %9d",         mNodeCount);
+  fprintf(fp, "  %9.1f",       mRssKb / 1024.0);
   fprintf(fp, "\n");
 }
 
@@ -319,6 +319,16 @@ void check_deadCodeElimination()
   // Suggestion: Ensure no dead code.
 }
 
+void check_stackAllocateClasses()
+{
+  check_afterEveryPass();
+  check_afterNormalization();
+  check_afterCallDestructors();
+  check_afterLowerIterators();
+  check_afterResolveIntents();
+  check_afterInlineFunctions();
+}
+
 void check_removeEmptyRecords()
 {
   check_afterEveryPass();
@@ -350,6 +360,26 @@ void check_loopInvariantCodeMotion()
   check_afterInlineFunctions();
 }
 
+void check_loopFusion()
+{
+  check_afterEveryPass();
+  check_afterNormalization();
+  check_afterCallDestructors();
+  check_afterLowerIterators();
+  check_afterResolveIntents();
+  check_afterInlineFunctions();
+}
+
+void check_loopTiling()
+{
+  check_afterEveryPass();
+  check_afterNormalization();
+  check_afterCallDestructors();
+  check_afterLowerIterators();
+  check_afterResolveIntents();
+  check_afterInlineFunctions();
+}
+
 void check_prune2()
 {
   check_afterEveryPass();
@@ -410,11 +440,32 @@ void check_insertLineNumbers()
   check_afterInlineFunctions();
 }
 
+void check_globalValueNumbering()
+{
+  check_afterEveryPass();
+  check_afterNormalization();
+  check_afterCallDestructors();
+  check_afterLowerIterators();
+  check_afterInlineFunctions();
+}
+
 void check_denormalize() {
   //do we need to call any checks here ?
   //or implement new checks ?
 }
 
+void check_reorderFields()
+{
+  check_afterEveryPass();
+  // Suggestion: Ensure every record still defines all of its fields.
+}
+
+void check_prune3()
+{
+  check_afterEveryPass();
+  // Suggestion: Ensure no dead functions.
+}
+
 void check_codegen()
 {
   // This pass should not change the AST, so no checks are required.
@@ -0,0 +1,353 @@
+/*
+ * Copyright 2020-2021 Hewlett Packard Enterprise Development LP
+ * Copyright 2004-2019 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//
+// chpld: persistent daemon mode for the compiler.
+//
+// Starting the compiler costs noticeable time before it looks at any
+// user code: argument table setup, the internal root module, primitive
+// and type initialization, and the string literal module.  Build farms
+// that run thousands of small compiles pay that cost every time.
+//
+// With '--daemon-socket <path>' the compiler performs that warm setup
+// once, then listens on a unix-domain socket.  Each connection carries
+// one compile request; the daemon forks a child which inherits the warm
+// front-end state by copy-on-write, replays the request's argument
+// vector through the normal per-compile path (process_args onward in
+// driver.cpp), and exits with the compile's status.  Requests are
+// served concurrently since each compile lives in its own process.
+//
+// Between requests the daemon warms up speculatively: it remembers
+// which source files recent requests compiled (in <socket>.history,
+// persisted across restarts) and reads them while idle, so the next
+// compile's parser streams from the page cache instead of a cold
+// filesystem.  See the "Speculative warm-up" section below.
+//
+// Wire protocol, one request per connection:
+//
+//   client -> daemon:  cwd '\0' arg1 '\0' arg2 '\0' ... '\0' '\0'
+//   daemon -> client:  the compile's stdout/stderr, interleaved, then
+//                      '\0' "CHPLD-EXIT:" <decimal status> '\n'
+//
+// The thin client lives in util/chpld.
+//
+
+#include "daemon.h"
+
+#include "misc.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+const char* chpldDaemonSocketArg(int argc, char* argv[]) {
+  for (int i = 1; i < argc - 1; i++) {
+    if (strcmp(argv[i], "--daemon-socket") == 0)
+      return argv[i + 1];
+  }
+  return NULL;
+}
+
+// Read one request off the connection: cwd then the argument vector,
+// NUL-separated, ended by an empty string.  Returns false on a
+// malformed or truncated request.
+static bool readRequest(int conn, std::string& cwd,
+                        std::vector<std::string>& args) {
+  std::string buf;
+  char chunk[4096];
+
+  for (;;) {
+    ssize_t n = read(conn, chunk, sizeof(chunk));
+    if (n < 0) {
+      if (errno == EINTR)
+        continue;
+      return false;
+    }
+    if (n == 0)
+      return false;   // closed before the terminating empty string
+    buf.append(chunk, n);
+    size_t len = buf.size();
+    if (len >= 2 && buf[len - 1] == '\0' && buf[len - 2] == '\0')
+      break;
+  }
+
+  size_t pos = 0;
+  bool haveCwd = false;
+  while (pos < buf.size()) {
+    size_t end = buf.find('\0', pos);
+    std::string field = buf.substr(pos, end - pos);
+    pos = end + 1;
+    if (field.empty())
+      break;
+    if (!haveCwd) {
+      cwd = field;       // the first field is the client's directory
+      haveCwd = true;
+    } else {
+      args.push_back(field);
+    }
+  }
+
+  return haveCwd;
+}
+
+static void writeAll(int fd, const char* data, size_t len) {
+  while (len > 0) {
+    ssize_t n = write(fd, data, len);
+    if (n < 0) {
+      if (errno == EINTR)
+        continue;
+      return;
+    }
+    data += n;
+    len -= n;
+  }
+}
+
+//
+// Speculative warm-up.
+//
+// Between requests the daemon sits idle while the developer edits; the
+// next compile then re-reads much the same source.  Each compile runs
+// in its own freshly forked child, so the only front-end cache every
+// request shares -- whatever its flags -- is the parent's warm setup
+// plus the kernel's page cache.  The daemon therefore keeps a history
+// of the source files recent requests named (persisted beside the
+// socket, so it survives restarts) and, whenever no connection is
+// pending, reads those files end to end.  By the time the next request
+// arrives its parser streams from memory instead of faulting through a
+// cold (possibly network-mounted) filesystem.  Warming proceeds one
+// file per idle poll tick, so a pending connection cancels further
+// work at the next file boundary.
+//
+
+static std::string sHistoryPath;     // <socket>.history, shared with handlers
+static off_t sHistoryIngested = 0;   // bytes of the history file consumed
+static std::deque<std::string> sWarmQueue;
+static std::set<std::string> sWarmSeen;
+
+// Append the request's Chapel source files to the shared history.
+// Handlers run concurrently, so each request goes out as one O_APPEND
+// write.  Paths are absolutized against the request's directory; the
+// daemon's own cwd is unrelated to any client's.
+static void recordRequestSources(const std::string& cwd,
+                                 const std::vector<std::string>& args) {
+  std::string lines;
+
+  for (size_t i = 0; i < args.size(); i++) {
+    const std::string& arg = args[i];
+    size_t len = arg.size();
+    if (len > 5 && arg.compare(len - 5, 5, ".chpl") == 0) {
+      if (arg[0] != '/')
+        lines += cwd + "/";
+      lines += arg;
+      lines += '\n';
+    }
+  }
+
+  if (lines.empty() || sHistoryPath.empty())
+    return;
+
+  int fd = open(sHistoryPath.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+  if (fd >= 0) {
+    writeAll(fd, lines.data(), lines.size());
+    close(fd);
+  }
+}
+
+// Pull any history entries appended since the last call into the warm
+// queue.  Each path is queued once per daemon lifetime; the page cache
+// keeps it warm from there.
+static void ingestHistory() {
+  FILE* f = fopen(sHistoryPath.c_str(), "r");
+  if (f == NULL)
+    return;
+
+  if (fseeko(f, sHistoryIngested, SEEK_SET) == 0) {
+    char line[4096];
+    while (fgets(line, sizeof(line), f) != NULL) {
+      size_t len = strlen(line);
+      if (len == 0 || line[len - 1] != '\n')
+        break;   // a handler's append is still in flight; retry next tick
+      line[len - 1] = '\0';
+      sHistoryIngested = ftello(f);
+      if (sWarmSeen.insert(line).second)
+        sWarmQueue.push_back(line);
+    }
+  }
+
+  fclose(f);
+}
+
+// Warm one queued file: read it end to end and drop the bytes.  The
+// point is the side effect -- the kernel pulls the file into its page
+// cache, where the next request's forked compile finds it.
+static void warmOneFile() {
+  if (sWarmQueue.empty())
+    return;
+
+  std::string path = sWarmQueue.front();
+  sWarmQueue.pop_front();
+
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0)
+    return;   // deleted or moved since; the history is advisory
+
+  char buf[65536];
+  while (read(fd, buf, sizeof(buf)) > 0)
+    ;
+  close(fd);
+}
+
+// The per-connection handler (runs in its own process): fork the
+// compile, relay its exit status as the protocol trailer, and exit.
+static void handleRequest(int conn, const char* argv0,
+                          chpldCompileFn compile, PhaseTracker& tracker) {
+  std::string cwd;
+  std::vector<std::string> args;
+  int status = 1;
+
+  if (readRequest(conn, cwd, args)) {
+    recordRequestSources(cwd, args);   // feed the idle-time warm-up
+
+    pid_t pid = fork();
+    if (pid == 0) {
+      // the compile itself: run from the request's directory with its
+      // output going back over the connection
+      if (chdir(cwd.c_str()) != 0)
+        _exit(1);
+      dup2(conn, fileno(stdout));
+      dup2(conn, fileno(stderr));
+
+      std::vector<char*> argv;
+      argv.push_back((char*) argv0);
+      for (size_t i = 0; i < args.size(); i++)
+        argv.push_back((char*) args[i].c_str());
+      argv.push_back(NULL);
+
+      compile((int) argv.size() - 1, &argv[0], tracker);
+      _exit(0);   // not reached; the compile ends in clean_exit()
+    }
+
+    if (pid > 0) {
+      int wstatus = 0;
+      while (waitpid(pid, &wstatus, 0) < 0 && errno == EINTR)
+        ;
+      if (WIFEXITED(wstatus))
+        status = WEXITSTATUS(wstatus);
+      else
+        status = 128 + (WIFSIGNALED(wstatus) ? WTERMSIG(wstatus) : 0);
+    }
+  }
+
+  char trailer[64];
+  int len = snprintf(trailer, sizeof(trailer), "%cCHPLD-EXIT:%d\n",
+                     '\0', status);
+  writeAll(conn, trailer, len);
+  close(conn);
+  _exit(0);
+}
+
+void chpldServe(const char* socketPath, const char* argv0,
+                chpldCompileFn compile, PhaseTracker& tracker) {
+  struct sockaddr_un addr;
+
+  if (strlen(socketPath) >= sizeof(addr.sun_path))
+    USR_FATAL("--daemon-socket path is too long: %s", socketPath);
+
+  int sock = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (sock < 0)
+    USR_FATAL("could not create daemon socket: %s", strerror(errno));
+
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  strncpy(addr.sun_path, socketPath, sizeof(addr.sun_path) - 1);
+
+  // a previous daemon instance may have left its socket file behind
+  unlink(socketPath);
+
+  if (bind(sock, (struct sockaddr*) &addr, sizeof(addr)) != 0 ||
+      listen(sock, 64) != 0)
+    USR_FATAL("could not listen on daemon socket %s: %s",
+              socketPath, strerror(errno));
+
+  // clients learn about compile failures from the protocol trailer,
+  // not from broken pipes
+  signal(SIGPIPE, SIG_IGN);
+
+  fprintf(stderr, "chpld: serving compiles on %s\n", socketPath);
+
+  sHistoryPath = std::string(socketPath) + ".history";
+  ingestHistory();   // files from previous sessions warm first
+
+  for (;;) {
+    // Idle between requests is warm-up time: poll rather than block in
+    // accept, and spend each timeout reading one recently used file.
+    struct pollfd pfd;
+    pfd.fd = sock;
+    pfd.events = POLLIN;
+
+    int ready = poll(&pfd, 1, sWarmQueue.empty() ? 1000 : 0);
+    if (ready < 0) {
+      if (errno == EINTR)
+        continue;
+      USR_FATAL("daemon poll failed: %s", strerror(errno));
+    }
+    if (ready == 0) {
+      ingestHistory();
+      warmOneFile();
+      continue;
+    }
+
+    int conn = accept(sock, NULL, NULL);
+    if (conn < 0) {
+      if (errno == EINTR)
+        continue;
+      USR_FATAL("daemon accept failed: %s", strerror(errno));
+    }
+
+    // reap finished request handlers
+    while (waitpid(-1, NULL, WNOHANG) > 0)
+      ;
+
+    pid_t pid = fork();
+    if (pid == 0) {
+      close(sock);
+      handleRequest(conn, argv0, compile, tracker);   // does not return
+    }
+    close(conn);
+    if (pid < 0)
+      fprintf(stderr, "chpld: fork failed: %s\n", strerror(errno));
+  }
+}
@@ -30,6 +30,7 @@
 #include "commonFlags.h"
 #include "config.h"
 #include "countTokens.h"
+#include "daemon.h"
 #include "docsDriver.h"
 #include "files.h"
 #include "library.h"
@@ -38,6 +39,7 @@
 #include "misc.h"
 #include "mysystem.h"
 #include "parser.h"
+#include "tokenCache.h"
 #include "PhaseTracker.h"
 #include "primitive.h"
 #include "runpasses.h"
@@ -114,6 +116,7 @@ static bool fBaseline = false;
 // interfaces (C, Fortran, Python)? Then there'd be no need to
 // specify each one separately.
 //
+bool fLibraryAsync = false;
 bool fLibraryCompile = false;
 bool fLibraryFortran = false;
 bool fLibraryMakefile = false;
@@ -124,6 +127,7 @@ bool fMultiLocaleLibraryDebug = false;
 bool no_codegen = false;
 int  debugParserLevel = 0;
 bool fVerify = false;
+bool fIncrementalVerify = false;
 bool ignore_errors = false;
 bool ignore_user_errors = false;
 bool ignore_errors_for_pass = false;
@@ -134,6 +138,9 @@ bool fFastFlag = false;
 bool fNoCopyPropagation = false;
 bool fNoDeadCodeElimination = false;
 bool fNoScalarReplacement = false;
+bool fNoElideArrayDefaultInit = false;
+bool fNoStackAllocateClasses = false;
+bool fNoReorderFields = true;
 bool fNoTupleCopyOpt = false;
 bool fNoRemoteValueForwarding = false;
 bool fNoInferConstRefs = false;
@@ -157,14 +164,19 @@ bool fIgnoreNilabilityErrors = false;
 bool fOverloadSetsChecks = true;
 bool fNoStackChecks = false;
 bool fNoInferLocalFields = false;
+bool fNoInferLocalCalls = false;
 bool fReplaceArrayAccessesWithRefTemps = false;
 bool fUserSetStackChecks = false;
 bool fNoCastChecks = false;
 bool fMungeUserIdents = true;
 bool fEnableTaskTracking = false;
+bool fInstrumentForalls = false;
+bool fParallelModuleInit = false;
+bool fDevirtualize = false;
 bool fEnableMemInterleaving = false;
 
 bool fAutoLocalAccess = true;
+bool fAutoBoundsCheckElim = true;
 bool fDynamicAutoLocalAccess = true;
 bool fReportAutoLocalAccess= false;
 
@@ -177,6 +189,10 @@ FILE* printPassesFile = NULL;
 // flag for llvmWideOpt
 bool fLLVMWideOpt = false;
 
+// Pack wide pointers into 64 bits, using this many bits for the node id.
+// 0 means use the usual (locale, addr) struct representation.
+int fWidePtrNodeBits = 0;
+
 bool fWarnConstLoops = true;
 bool fWarnUnstable = false;
 
@@ -185,19 +201,33 @@ static bool fNoWarnSpecial = true;
 static bool fNoWarnDomainLiteral = true;
 static bool fNoWarnTupleIteration = true;
 
+bool fNoGlobalValueNumbering = false;
 bool fNoLoopInvariantCodeMotion = false;
+bool fLoopFusion = false;
+bool fLoopTiling = false;
+int fLoopTileSize = 0;
+bool fCommLocalFastPath = false;
 bool fNoInterproceduralAliasAnalysis = true;
 bool fNoChecks = false;
 bool fNoInline = false;
+bool fNoVirtualCallCache = false;
 bool fNoPrivatization = false;
 bool fNoOptimizeOnClauses = false;
+bool fNoEarlyModulePrune = false;
 bool fNoRemoveEmptyRecords = true;
 bool fRemoveUnreachableBlocks = true;
 bool fMinimalModules = false;
 bool fIncrementalCompilation = false;
+int fParMakeJobs = 0;
+char fBackendJobRunner[256] = "";
+char fBackendCacheDir[FILENAME_MAX+1] = "";
+int fParallelPasses = 0;
 bool fNoOptimizeForallUnordered = false;
+bool fOptimizeForallYieldingGets = false;
+bool fInlineSmallFunctions = false;
 
 int optimize_on_clause_limit = 20;
+int param_loop_unroll_limit = 0;
 int scalar_replace_limit = 8;
 int inline_iter_yield_limit = 10;
 int tuple_copy_limit = scalar_replace_limit;
@@ -237,13 +267,17 @@ char fPrintStatistics[256] = "";
 bool fPrintDispatch = false;
 bool fPrintUnusedFns = false;
 bool fPrintUnusedInternalFns = false;
+bool fPerfReport = false;
 bool fReportAliases = false;
 bool fReportBlocking = false;
 bool fReportOptimizedLoopIterators = false;
 bool fReportInlinedIterators = false;
 bool fReportVectorizedLoops = false;
+bool fReportLoopFusion = false;
+bool fReportLoopTiling = false;
 bool fReportOptimizedOn = false;
 bool fReportOptimizeForallUnordered = false;
+bool fReportInstantiations = false;
 bool fReportPromotion = false;
 bool fReportScalarReplace = false;
 bool fReportDeadBlocks = false;
@@ -281,11 +315,13 @@ int numGlobalsOnHeap = 0;
 bool preserveInlinedLineNumbers = false;
 
 char stopAfterPass[128];
+char fResumeCheckpointDir[FILENAME_MAX+1] = "";
 
 const char* compileCommand = NULL;
 char compileVersion[64];
 
 std::string llvmFlags;
+char fTargetCpuVersions[256] = "";
 
 bool fPrintAdditionalErrors;
 
@@ -777,11 +813,14 @@ static void setFastFlag(const ArgumentDescription* desc, const char* unused) {
   // an appropriate level of optimization.
   fNoCopyPropagation = false;
   fNoDeadCodeElimination = false;
+  fNoElideArrayDefaultInit = false;
   fNoFastFollowers = false;
+  fNoGlobalValueNumbering = false;
   fNoLoopInvariantCodeMotion= false;
   fNoInterproceduralAliasAnalysis = false;
   fNoInline = false;
   fNoInlineIterators = false;
+  fNoVirtualCallCache = false;
   fNoOptimizeRangeIteration = false;
   fNoOptimizeLoopIterators = false;
   fNoLiveAnalysis = false;
@@ -790,10 +829,14 @@ static void setFastFlag(const ArgumentDescription* desc, const char* unused) {
   fNoRemoteSerialization = false;
   fNoRemoveCopyCalls = false;
   fNoScalarReplacement = false;
+  fNoStackAllocateClasses = false;
+  fNoStackAllocateIterators = false;
+  fNoReorderFields = false;
   fNoTupleCopyOpt = false;
   fNoPrivatization = false;
   fNoChecks = true;
   fNoInferLocalFields = false;
+  fNoInferLocalCalls = false;
   fIgnoreLocalClasses = false;
   fNoOptimizeOnClauses = false;
   //fReplaceArrayAccessesWithRefTemps = true; // don't tie this to --fast yet
@@ -826,12 +869,16 @@ static void setBaselineFlag(const ArgumentDescription* desc, const char* unused)
 
   fNoCopyPropagation = true;          // --no-copy-propagation
   fNoDeadCodeElimination = true;      // --no-dead-code-elimination
+                                      // --no-elide-array-default-init
+  fNoElideArrayDefaultInit = true;
   fNoFastFollowers = true;            // --no-fast-followers
+  fNoGlobalValueNumbering = true;     // --no-global-value-numbering
   fNoLoopInvariantCodeMotion = true;  // --no-loop-invariant-code-motion
                                       // --no-interprocedural-alias-analysis
   fNoInterproceduralAliasAnalysis = true;
   fNoInline = true;                   // --no-inline
   fNoInlineIterators = true;          // --no-inline-iterators
+  fNoVirtualCallCache = true;         // --no-virtual-call-cache
   fNoLiveAnalysis = true;             // --no-live-analysis
   fNoOptimizeRangeIteration = true;   // --no-optimize-range-iteration
   fNoOptimizeLoopIterators = true;    // --no-optimize-loop-iterators
@@ -841,11 +888,15 @@ static void setBaselineFlag(const ArgumentDescription* desc, const char* unused)
   fNoRemoteSerialization = true;      // --no-remote-serialization
   fNoRemoveCopyCalls = true;          // --no-remove-copy-calls
   fNoScalarReplacement = true;        // --no-scalar-replacement
+  fNoStackAllocateClasses = true;     // --no-stack-allocate-classes
+  fNoStackAllocateIterators = true;   // --no-stack-allocate-iterators
+  fNoReorderFields = true;            // --no-reorder-fields
   fNoTupleCopyOpt = true;             // --no-tuple-copy-opt
   fNoPrivatization = true;            // --no-privatization
   fNoOptimizeOnClauses = true;        // --no-optimize-on-clauses
   fIgnoreLocalClasses = true;         // --ignore-local-classes
   fNoInferLocalFields = true;         // --no-infer-local-fields
+  fNoInferLocalCalls = true;          // --no-infer-local-calls
   //fReplaceArrayAccessesWithRefTemps = false; // don't tie this to --baseline yet
   fDenormalize = false;               // --no-denormalize
   fNoOptimizeForallUnordered = true;  // --no-optimize-forall-unordered-ops
@@ -972,34 +1023,50 @@ static ArgumentDescription arg_desc[] = {
  {"", ' ', NULL, "Optimization Control Options", NULL, NULL, NULL, NULL},
  {"baseline", ' ', NULL, "Disable all Chapel optimizations", "F", &fBaseline, "CHPL_BASELINE", setBaselineFlag},
  {"cache-remote", ' ', NULL, "[Don't] enable cache for remote data", "N", &fCacheRemote, "CHPL_CACHE_REMOTE", NULL},
+ {"comm-local-fast-path", ' ', NULL, "Enable [disable] inline locality tests with direct local accesses on wide pointer dereferences", "N", &fCommLocalFastPath, "CHPL_COMM_LOCAL_FAST_PATH", NULL},
  {"copy-propagation", ' ', NULL, "Enable [disable] copy propagation", "n", &fNoCopyPropagation, "CHPL_DISABLE_COPY_PROPAGATION", NULL},
  {"dead-code-elimination", ' ', NULL, "Enable [disable] dead code elimination", "n", &fNoDeadCodeElimination, "CHPL_DISABLE_DEAD_CODE_ELIMINATION", NULL},
+ {"early-module-prune", ' ', NULL, "Enable [disable] pruning unreferenced standard modules before scope resolution", "n", &fNoEarlyModulePrune, "CHPL_DISABLE_EARLY_MODULE_PRUNE", NULL},
+ {"elide-array-default-init", ' ', NULL, "Enable [disable] eliding default initialization of arrays that are fully assigned before any read", "n", &fNoElideArrayDefaultInit, "CHPL_DISABLE_ELIDE_ARRAY_DEFAULT_INIT", NULL},
  {"fast", ' ', NULL, "Disable checks; optimize/specialize code", "F", &fFastFlag, "CHPL_FAST", setFastFlag},
  {"fast-followers", ' ', NULL, "Enable [disable] fast followers", "n", &fNoFastFollowers, "CHPL_DISABLE_FAST_FOLLOWERS", NULL},
  {"ieee-float", ' ', NULL, "Generate code that is strict [lax] with respect to IEEE compliance", "N", &fieeefloat, "CHPL_IEEE_FLOAT", setFloatOptFlag},
  {"ignore-local-classes", ' ', NULL, "Disable [enable] local classes", "N", &fIgnoreLocalClasses, NULL, NULL},
  {"inline", ' ', NULL, "Enable [disable] function inlining", "n", &fNoInline, NULL, NULL},
  {"inline-iterators", ' ', NULL, "Enable [disable] iterator inlining", "n", &fNoInlineIterators, "CHPL_DISABLE_INLINE_ITERATORS", NULL},
+ {"inline-small-functions", ' ', NULL, "Enable [disable] inlining of small leaf functions not marked inline", "N", &fInlineSmallFunctions, "CHPL_INLINE_SMALL_FUNCTIONS", NULL},
  {"inline-iterators-yield-limit", ' ', "<limit>", "Limit number of yields permitted in inlined iterators", "I", &inline_iter_yield_limit, "CHPL_INLINE_ITER_YIELD_LIMIT", NULL},
  {"live-analysis", ' ', NULL, "Enable [disable] live variable analysis", "n", &fNoLiveAnalysis, "CHPL_DISABLE_LIVE_ANALYSIS", NULL},
+ {"global-value-numbering", ' ', NULL, "Enable [disable] reuse of redundant array element addresses", "n", &fNoGlobalValueNumbering, "CHPL_DISABLE_GLOBAL_VALUE_NUMBERING", NULL},
  {"loop-invariant-code-motion", ' ', NULL, "Enable [disable] loop invariant code motion", "n", &fNoLoopInvariantCodeMotion, NULL, NULL},
+ {"loop-fusion", ' ', NULL, "Enable [disable] fusion of adjacent order-independent loops", "N", &fLoopFusion, "CHPL_LOOP_FUSION", NULL},
+ {"loop-tiling", ' ', NULL, "Enable [disable] cache tiling of nested order-independent loops", "N", &fLoopTiling, "CHPL_LOOP_TILING", NULL},
+ {"loop-tile-size", ' ', "<elements>", "Tile inner loops in strips of this many iterations (default: derived from host cache size)", "I", &fLoopTileSize, "CHPL_LOOP_TILE_SIZE", NULL},
  {"optimize-forall-unordered-ops", ' ', NULL, "Enable [disable] optimization of foralls to unordered operations", "n", &fNoOptimizeForallUnordered, "CHPL_DISABLE_OPTIMIZE_FORALL_UNORDERED_OPS", NULL},
+ {"optimize-forall-yielding-gets", ' ', NULL, "Enable [disable] optimization of remote reads in foralls to yield while waiting", "N", &fOptimizeForallYieldingGets, "CHPL_OPTIMIZE_FORALL_YIELDING_GETS", NULL},
  {"optimize-range-iteration", ' ', NULL, "Enable [disable] optimization of iteration over anonymous ranges", "n", &fNoOptimizeRangeIteration, "CHPL_DISABLE_OPTIMIZE_RANGE_ITERATION", NULL},
  {"optimize-loop-iterators", ' ', NULL, "Enable [disable] optimization of iterators composed of a single loop", "n", &fNoOptimizeLoopIterators, "CHPL_DISABLE_OPTIMIZE_LOOP_ITERATORS", NULL},
  {"optimize-on-clauses", ' ', NULL, "Enable [disable] optimization of on clauses", "n", &fNoOptimizeOnClauses, "CHPL_DISABLE_OPTIMIZE_ON_CLAUSES", NULL},
  {"optimize-on-clause-limit", ' ', "<limit>", "Limit recursion depth of on clause optimization search", "I", &optimize_on_clause_limit, "CHPL_OPTIMIZE_ON_CLAUSE_LIMIT", NULL},
+ {"param-loop-unroll-limit", ' ', "<limit>", "Warn when a param loop unrolls into more than this many AST nodes (0 to disable)", "I", &param_loop_unroll_limit, "CHPL_PARAM_LOOP_UNROLL_LIMIT", NULL},
  {"privatization", ' ', NULL, "Enable [disable] privatization of distributed arrays and domains", "n", &fNoPrivatization, "CHPL_DISABLE_PRIVATIZATION", NULL},
  {"remote-value-forwarding", ' ', NULL, "Enable [disable] remote value forwarding", "n", &fNoRemoteValueForwarding, "CHPL_DISABLE_REMOTE_VALUE_FORWARDING", NULL},
  {"remote-serialization", ' ', NULL, "Enable [disable] serialization for remote consts", "n", &fNoRemoteSerialization, "CHPL_DISABLE_REMOTE_SERIALIZATION", NULL},
  {"remove-copy-calls", ' ', NULL, "Enable [disable] remove copy calls", "n", &fNoRemoveCopyCalls, "CHPL_DISABLE_REMOVE_COPY_CALLS", NULL},
  {"scalar-replacement", ' ', NULL, "Enable [disable] scalar replacement", "n", &fNoScalarReplacement, "CHPL_DISABLE_SCALAR_REPLACEMENT", NULL},
+ {"stack-allocate-classes", ' ', NULL, "Enable [disable] stack allocation of non-escaping classes", "n", &fNoStackAllocateClasses, "CHPL_DISABLE_STACK_ALLOCATE_CLASSES", NULL},
+ {"stack-allocate-iterators", ' ', NULL, "Enable [disable] stack allocation of non-escaping iterator records", "n", &fNoStackAllocateIterators, "CHPL_DISABLE_STACK_ALLOCATE_ITERATORS", NULL},
+ {"reorder-fields", ' ', NULL, "Enable [disable] record field reordering", "n", &fNoReorderFields, "CHPL_DISABLE_REORDER_FIELDS", NULL},
  {"scalar-replace-limit", ' ', "<limit>", "Limit on the size of tuples being replaced during scalar replacement", "I", &scalar_replace_limit, "CHPL_SCALAR_REPLACE_TUPLE_LIMIT", NULL},
  {"tuple-copy-opt", ' ', NULL, "Enable [disable] tuple (memcpy) optimization", "n", &fNoTupleCopyOpt, "CHPL_DISABLE_TUPLE_COPY_OPT", NULL},
  {"tuple-copy-limit", ' ', "<limit>", "Limit on the size of tuples considered for optimization", "I", &tuple_copy_limit, "CHPL_TUPLE_COPY_LIMIT", NULL},
  {"infer-local-fields", ' ', NULL, "Enable [disable] analysis to infer local fields in classes and records", "n", &fNoInferLocalFields, "CHPL_DISABLE_INFER_LOCAL_FIELDS", NULL},
+ {"infer-local-calls", ' ', NULL, "Enable [disable] inference that functions called only under 'local' blocks take local arguments", "n", &fNoInferLocalCalls, "CHPL_DISABLE_INFER_LOCAL_CALLS", NULL},
+ {"virtual-call-cache", ' ', NULL, "Enable [disable] per-call-site caching of virtual method targets", "n", &fNoVirtualCallCache, "CHPL_DISABLE_VIRTUAL_CALL_CACHE", NULL},
  {"vectorize", ' ', NULL, "Enable [disable] generation of vectorization hints", "n", &fNoVectorize, "CHPL_DISABLE_VECTORIZATION", setVectorize},
 
  {"auto-local-access", ' ', NULL, "Enable [disable] using local access automatically", "N", &fAutoLocalAccess, "CHPL_DISABLE_AUTO_LOCAL_ACCESS", NULL},
+ {"auto-bounds-check-elim", ' ', NULL, "Enable [disable] eliminating bounds checks automatically", "N", &fAutoBoundsCheckElim, "CHPL_DISABLE_AUTO_BOUNDS_CHECK_ELIM", NULL},
  {"dynamic-auto-local-access", ' ', NULL, "Enable [disable] using local access automatically (dynamic only)", "N", &fDynamicAutoLocalAccess, "CHPL_DISABLE_DYNAMIC_AUTO_LOCAL_ACCESS", NULL},
 
  {"auto-aggregation", ' ', NULL, "Enable [disable] automatically aggregating remote accesses in foralls", "N", &fAutoAggregation, "CHPL_AUTO_AGGREGATION", NULL},
@@ -1020,11 +1087,13 @@ static ArgumentDescription arg_desc[] = {
  {"max-c-ident-len", ' ', NULL, "Maximum length of identifiers in generated code, 0 for unlimited", "I", &fMaxCIdentLen, "CHPL_MAX_C_IDENT_LEN", NULL},
  {"munge-user-idents", ' ', NULL, "[Don't] Munge user identifiers to avoid naming conflicts with external code", "N", &fMungeUserIdents, "CHPL_MUNGE_USER_IDENTS"},
  {"savec", ' ', "<directory>", "Save generated C code in directory", "P", saveCDir, "CHPL_SAVEC_DIR", verifySaveCDir},
+ {"resume-from-checkpoint", ' ', "<directory>", "Rerun only the back end on generated code saved with --savec", "P", fResumeCheckpointDir, NULL, NULL},
 
  {"", ' ', NULL, "C Code Compilation Options", NULL, NULL, NULL, NULL},
  {"ccflags", ' ', "<flags>", "Back-end C compiler flags (can be specified multiple times)", "S", NULL, "CHPL_CC_FLAGS", setCCFlags},
  {"debug", 'g', NULL, "[Don't] Support debugging of generated C code", "N", &debugCCode, "CHPL_DEBUG", setChapelDebug},
  {"dynamic", ' ', NULL, "Generate a dynamically linked binary", "F", &fLinkStyle, NULL, setDynamicLink},
+ {"extern-c-cache", ' ', "<directory>", "Cache parsed extern block headers (clang PCH) in directory across compiles", "P", externCCacheDir, "CHPL_EXTERN_C_CACHE", NULL},
  {"hdr-search-path", 'I', "<directory>", "C header search path", "P", incFilename, "CHPL_INCLUDE_PATH", handleIncDir},
  {"ldflags", ' ', "<flags>", "Back-end C linker flags (can be specified multiple times)", "S", NULL, "CHPL_LD_FLAGS", setLDFlags},
  {"lib-linkage", 'l', "<library>", "C library linkage", "P", libraryFilename, "CHPL_LIB_NAME", handleLibrary},
@@ -1032,12 +1101,14 @@ static ArgumentDescription arg_desc[] = {
  {"optimize", 'O', NULL, "[Don't] Optimize generated C code", "N", &optimizeCCode, "CHPL_OPTIMIZE", NULL},
  {"specialize", ' ', NULL, "[Don't] Specialize generated C code for CHPL_TARGET_CPU", "N", &specializeCCode, "CHPL_SPECIALIZE", NULL},
  {"output", 'o', "<filename>", "Name output executable", "P", executableFilename, "CHPL_EXE_NAME", NULL},
+ {"packed-wide-pointers", ' ', "<node-bits>", "Pack wide pointers into 64 bits, using this many bits for the node id, 0 for the struct representation", "I", &fWidePtrNodeBits, "CHPL_PACKED_WIDE_POINTERS", NULL},
  {"static", ' ', NULL, "Generate a statically linked binary", "F", &fLinkStyle, NULL, NULL},
 
  {"", ' ', NULL, "LLVM Code Generation Options", NULL, NULL, NULL, NULL},
  {"llvm", ' ', NULL, "[Don't] use the LLVM code generator", "N", &fYesLlvmCodegen, "CHPL_LLVM_CODEGEN", setLlvmCodegen},
  {"llvm-wide-opt", ' ', NULL, "Enable [disable] LLVM wide pointer optimizations", "N", &fLLVMWideOpt, "CHPL_LLVM_WIDE_OPTS", NULL},
  {"mllvm", ' ', "<flags>", "LLVM flags (can be specified multiple times)", "S", NULL, "CHPL_MLLVM", setLLVMFlags},
+ {"target-cpu-versions", ' ', "<cpu[,cpu...]>", "Also generate vectorizable kernels for these target CPUs, selected at program start; list newest first", "S256", fTargetCpuVersions, "CHPL_TARGET_CPU_VERSIONS", NULL},
 
  {"", ' ', NULL, "Compilation Trace Options", NULL, NULL, NULL, NULL},
  {"print-commands", ' ', NULL, "[Don't] print system commands", "N", &printSystemCommands, "CHPL_PRINT_COMMANDS", NULL},
@@ -1046,16 +1117,21 @@ static ArgumentDescription arg_desc[] = {
 
  {"", ' ', NULL, "Miscellaneous Options", NULL, NULL, NULL, NULL},
  DRIVER_ARG_DEVELOPER,
+ {"devirtualize", ' ', NULL, "Enable [disable] devirtualizing dynamic dispatch using class instantiation analysis", "N", &fDevirtualize, "CHPL_DEVIRTUALIZE", NULL},
  {"explain-call", ' ', "<call>[:<module>][:<line>]", "Explain resolution of call", "S256", fExplainCall, NULL, NULL},
  {"explain-instantiation", ' ', "<function|type>[:<module>][:<line>]", "Explain instantiation of type", "S256", fExplainInstantiation, NULL, NULL},
  {"explain-verbose", ' ', NULL, "Enable [disable] tracing of disambiguation with 'explain' options", "N", &fExplainVerbose, "CHPL_EXPLAIN_VERBOSE", NULL},
  {"instantiate-max", ' ', "<max>", "Limit number of instantiations", "I", &instantiation_limit, "CHPL_INSTANTIATION_LIMIT", NULL},
+ {"instrument-foralls", ' ', NULL, "Enable [disable] forall entry/exit instrumentation hooks (see CHPL_RT_INSTRUMENT_FORALLS)", "N", &fInstrumentForalls, "CHPL_INSTRUMENT_FORALLS", NULL},
+ {"parallel-module-init", ' ', NULL, "Enable [disable] initializing independent modules in parallel", "N", &fParallelModuleInit, "CHPL_PARALLEL_MODULE_INIT", NULL},
+ {"perf-report", ' ', NULL, "Print a consolidated per-loop performance report (vectorization, forall optimizations)", "F", &fPerfReport, "CHPL_PERF_REPORT", NULL},
  {"print-all-candidates", ' ', NULL, "[Don't] print all candidates for a resolution failure", "N", &fPrintAllCandidates, "CHPL_PRINT_ALL_CANDIDATES", NULL},
  {"print-callgraph", ' ', NULL, "[Don't] print a representation of the callgraph for the program", "N", &fPrintCallGraph, "CHPL_PRINT_CALLGRAPH", NULL},
  {"print-callstack-on-error", ' ', NULL, "[Don't] print the Chapel call stack leading to each error or warning", "N", &fPrintCallStackOnError, "CHPL_PRINT_CALLSTACK_ON_ERROR", setPrintCallstackOnErrorFlag},
  {"print-unused-functions", ' ', NULL, "[Don't] print the name and location of unused functions", "N", &fPrintUnusedFns, NULL, NULL},
  {"set", 's', "<name>[=<value>]", "Set config value", "S", NULL, NULL, readConfig},
  {"task-tracking", ' ', NULL, "Enable [disable] runtime task tracking", "N", &fEnableTaskTracking, "CHPL_TASK_TRACKING", NULL},
+ {"token-cache", ' ', "<directory>", "Cache lexed token streams for internal/standard modules in directory", "P", tokenCacheDir, "CHPL_TOKEN_CACHE", NULL},
 
  {"", ' ', NULL, "Compiler Configuration Options", NULL, NULL, NULL, NULL},
  {"home", ' ', "<path>", "Path to Chapel's home directory", "S", NULL, "_CHPL_HOME", setHome},
@@ -1108,6 +1184,7 @@ static ArgumentDescription arg_desc[] = {
  {"llvm-print-ir", ' ', "<name>", "Dump LLVM Intermediate Representation of given function to stdout", "S", NULL, "CHPL_LLVM_PRINT_IR", &setPrintIr},
  {"llvm-print-ir-stage", ' ', "<stage>", "Specifies from which LLVM optimization stage to print function: none, basic, full", "S", NULL, "CHPL_LLVM_PRINT_IR_STAGE", &verifyStageAndSetStageNum},
  {"verify", ' ', NULL, "Run consistency checks during compilation", "N", &fVerify, "CHPL_VERIFY", NULL},
+ {"incremental-verify", ' ', NULL, "Restrict [do not restrict] --verify to subtrees changed by each pass", "N", &fIncrementalVerify, "CHPL_INCREMENTAL_VERIFY", NULL},
  {"parse-only", ' ', NULL, "Stop compiling after 'parse' pass for syntax checking", "N", &fParseOnly, NULL, NULL},
  {"parser-debug", ' ', NULL, "Set parser debug level", "+", &debugParserLevel, "CHPL_PARSER_DEBUG", NULL},
  {"debug-short-loc", ' ', NULL, "Display long [short] location in certain debug outputs", "N", &debugShortLoc, "CHPL_DEBUG_SHORT_LOC", NULL},
@@ -1123,10 +1200,13 @@ static ArgumentDescription arg_desc[] = {
  {"report-optimized-loop-iterators", ' ', NULL, "Print stats on optimized single loop iterators", "F", &fReportOptimizedLoopIterators, NULL, NULL},
  {"report-inlined-iterators", ' ', NULL, "Print stats on inlined iterators", "F", &fReportInlinedIterators, NULL, NULL},
  {"report-vectorized-loops", ' ', NULL, "Show which loops have vectorization hints", "F", &fReportVectorizedLoops, NULL, NULL},
+ {"report-loop-fusion", ' ', NULL, "Show which loops have been fused", "F", &fReportLoopFusion, NULL, NULL},
+ {"report-loop-tiling", ' ', NULL, "Show which loop nests have been tiled", "F", &fReportLoopTiling, NULL, NULL},
  {"report-optimized-on", ' ', NULL, "Print information about on clauses that have been optimized for potential fast remote fork operation", "F", &fReportOptimizedOn, NULL, NULL},
  {"report-auto-local-access", ' ', NULL, "Enable compiler logs for auto local access optimization", "N", &fReportAutoLocalAccess, "CHPL_REPORT_AUTO_LOCAL_ACCESS", NULL},
  {"report-auto-aggregation", ' ', NULL, "Enable compiler logs for automatic aggregation", "N", &fReportAutoAggregation, "CHPL_REPORT_AUTO_AGGREGATION", NULL},
  {"report-optimized-forall-unordered-ops", ' ', NULL, "Show which statements in foralls have been converted to unordered operations", "F", &fReportOptimizeForallUnordered, NULL, NULL},
+ {"report-instantiations", ' ', NULL, "Print per-generic instantiation counts after resolution", "F", &fReportInstantiations, NULL, NULL},
  {"report-promotion", ' ', NULL, "Print information about scalar promotion", "F", &fReportPromotion, NULL, NULL},
  {"report-scalar-replace", ' ', NULL, "Print scalar replacement stats", "F", &fReportScalarReplace, NULL, NULL},
 
@@ -1160,6 +1240,7 @@ static ArgumentDescription arg_desc[] = {
  {"library-dir", ' ', "<directory>", "Save generated library helper files in directory", "P", libDir, "CHPL_LIB_SAVE_DIR", verifySaveLibDir},
  {"library-header", ' ', "<filename>", "Name generated header file", "P", libmodeHeadername, NULL, setLibmode},
  {"library-makefile", ' ', NULL, "Generate a makefile to help use the generated library", "F", &fLibraryMakefile, NULL, setLibmode},
+ {"library-async", ' ', NULL, "Generate submit/poll/wait variants for exported functions", "F", &fLibraryAsync, NULL, setLibmode},
  {"library-fortran", ' ', NULL, "Generate a module compatible with Fortran", "F", &fLibraryFortran, NULL, setLibmode},
  {"library-fortran-name", ' ', "<modulename>", "Name generated Fortran module", "P", fortranModulename, NULL, setFortranAndLibmode},
  {"library-python", ' ', NULL, "Generate a module compatible with Python", "F", &fLibraryPython, NULL, setLibmode},
@@ -1180,6 +1261,10 @@ static ArgumentDescription arg_desc[] = {
  {"remove-unreachable-blocks", ' ', NULL, "[Don't] remove unreachable blocks after resolution", "N", &fRemoveUnreachableBlocks, "CHPL_REMOVE_UNREACHABLE_BLOCKS", NULL},
  {"replace-array-accesses-with-ref-temps", ' ', NULL, "Enable [disable] replacing array accesses with reference temps (experimental)", "N", &fReplaceArrayAccessesWithRefTemps, NULL, NULL },
  {"incremental", ' ', NULL, "Enable [disable] using incremental compilation", "N", &fIncrementalCompilation, "CHPL_INCREMENTAL_COMP", NULL},
+ {"parallel-make", ' ', "<jobs>", "Run this many back-end compilation jobs in parallel, 0 for serial", "I", &fParMakeJobs, "CHPL_PAR_MAKE_JOBS", NULL},
+ {"backend-job-runner", ' ', "<command>", "Launch back-end compile jobs through this command (e.g. distcc)", "S256", fBackendJobRunner, "CHPL_BACKEND_JOB_RUNNER", NULL},
+ {"backend-cache-dir", ' ', "<directory>", "Cache back-end object files in this directory, keyed by preprocessed source and flags", "P", fBackendCacheDir, "CHPL_BACKEND_CACHE_DIR", NULL},
+ {"parallel-passes", ' ', "<threads>", "Run embarrassingly parallel compiler passes on this many threads, 0 for serial", "I", &fParallelPasses, "CHPL_PARALLEL_PASSES", NULL},
  {"minimal-modules", ' ', NULL, "Enable [disable] using minimal modules",               "N", &fMinimalModules, "CHPL_MINIMAL_MODULES", NULL},
  {"print-chpl-settings", ' ', NULL, "Print current chapel settings and exit", "F", &fPrintChplSettings, NULL,NULL},
  {"print-additional-errors", ' ', NULL, "Print additional errors", "F", &fPrintAdditionalErrors, NULL,NULL},
@@ -1686,43 +1771,14 @@ static void validateSettings() {
   checkUnsupportedConfigs();
 }
 
-int main(int argc, char* argv[]) {
-  PhaseTracker tracker;
-
-  startCatchingSignals();
-
-  // create the compiler context
-  gContext = new chpl::Context();
-
+// Everything main() does after the warm front-end setup: per-compile
+// argument handling and the pass loop.  In daemon mode (see daemon.cpp)
+// this runs once per request in a forked child; otherwise main() calls
+// it directly.  Ends in clean_exit().
+static int compileOne(int argc, char* argv[], PhaseTracker& tracker) {
   {
     astlocMarker markAstLoc(0, "<internal>");
 
-    tracker.StartPhase("init");
-
-    init_args(&sArgState, argv[0]);
-
-    fDocs   = (strcmp(sArgState.program_name, "chpldoc")  == 0) ? true : false;
-
-    // Initialize the arguments for argument state. If chpldoc, use the docs
-    // specific arguments. Otherwise, use the regular arguments.
-    if (fDocs) {
-      init_arg_desc(&sArgState, docs_arg_desc);
-    } else {
-      init_arg_desc(&sArgState, arg_desc);
-    }
-
-
-    initFlags();
-    initAstrConsts();
-    initTypeHelperNames();
-    initRootModule();
-    initPrimitive();
-    initPrimitiveTypes();
-
-    initChplProgram();
-
-    initStringLiteralModule();
-
     process_args(&sArgState, argc, argv);
 
     setupChplGlobals(argv[0]);
@@ -1754,9 +1810,14 @@ int main(int argc, char* argv[]) {
   if (fRunlldb)
     runCompilerInLLDB(argc, argv);
 
-  addSourceFiles(sArgState.nfile_arguments, sArgState.file_argument);
+  if (fResumeCheckpointDir[0] != '\0') {
+    // no source files; the back end reruns on the saved generated code
+    resumeFromCheckpoint(tracker);
+  } else {
+    addSourceFiles(sArgState.nfile_arguments, sArgState.file_argument);
 
-  runPasses(tracker, fDocs);
+    runPasses(tracker, fDocs);
+  }
 
   tracker.StartPhase("driverCleanup");
 
@@ -1778,3 +1839,51 @@ int main(int argc, char* argv[]) {
 
   return 0;
 }
+
+int main(int argc, char* argv[]) {
+  PhaseTracker tracker;
+
+  startCatchingSignals();
+
+  // create the compiler context
+  gContext = new chpl::Context();
+
+  {
+    astlocMarker markAstLoc(0, "<internal>");
+
+    tracker.StartPhase("init");
+
+    init_args(&sArgState, argv[0]);
+
+    fDocs   = (strcmp(sArgState.program_name, "chpldoc")  == 0) ? true : false;
+
+    // Initialize the arguments for argument state. If chpldoc, use the docs
+    // specific arguments. Otherwise, use the regular arguments.
+    if (fDocs) {
+      init_arg_desc(&sArgState, docs_arg_desc);
+    } else {
+      init_arg_desc(&sArgState, arg_desc);
+    }
+
+
+    initFlags();
+    initAstrConsts();
+    initTypeHelperNames();
+    initRootModule();
+    initPrimitive();
+    initPrimitiveTypes();
+
+    initChplProgram();
+
+    initStringLiteralModule();
+  } // astlocMarker scope
+
+  // Daemon mode: everything above is compile-independent warm state;
+  // serve per-request argument vectors through compileOne() instead of
+  // compiling here.  Handled outside the regular argument table since
+  // it must be decided before process_args runs.
+  if (const char* socketPath = chpldDaemonSocketArg(argc, argv))
+    chpldServe(socketPath, argv[0], compileOne, tracker); // does not return
+
+  return compileOne(argc, argv, tracker);
+}
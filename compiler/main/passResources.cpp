@@ -0,0 +1,93 @@
+/*
+ * Copyright 2020-2021 Hewlett Packard Enterprise Development LP
+ * Copyright 2004-2019 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "passResources.h"
+
+#include <cstring>
+#include <vector>
+
+struct PassResource {
+  const char*          name;
+  const char*          lastConsumer;
+  PassResourceRetireFn retireFn;
+  PassResourceSizeFn   sizeFn;
+  bool                 retired;
+};
+
+static std::vector<PassResource> sPassResources;
+
+void registerPassResource(const char*          name,
+                          const char*          lastConsumer,
+                          PassResourceRetireFn retireFn,
+                          PassResourceSizeFn   sizeFn) {
+  for (size_t i = 0; i < sPassResources.size(); i++) {
+    if (strcmp(sPassResources[i].name, name) == 0) {
+      return;
+    }
+  }
+
+  PassResource res;
+
+  res.name         = name;
+  res.lastConsumer = lastConsumer;
+  res.retireFn     = retireFn;
+  res.sizeFn       = sizeFn;
+  res.retired      = false;
+
+  sPassResources.push_back(res);
+}
+
+void retirePassResources(const char* passName) {
+  for (size_t i = 0; i < sPassResources.size(); i++) {
+    PassResource& res = sPassResources[i];
+
+    if (res.retired == false && strcmp(res.lastConsumer, passName) == 0) {
+      res.retireFn();
+
+      res.retired = true;
+    }
+  }
+}
+
+void retireAllPassResources() {
+  for (size_t i = 0; i < sPassResources.size(); i++) {
+    PassResource& res = sPassResources[i];
+
+    if (res.retired == false) {
+      res.retireFn();
+
+      res.retired = true;
+    }
+  }
+}
+
+size_t passResourcesRetainedBytes() {
+  size_t retval = 0;
+
+  for (size_t i = 0; i < sPassResources.size(); i++) {
+    const PassResource& res = sPassResources[i];
+
+    if (res.retired == false && res.sizeFn != NULL) {
+      retval += res.sizeFn();
+    }
+  }
+
+  return retval;
+}
@@ -22,12 +22,18 @@
 
 #include "checks.h"
 #include "driver.h"
+#include "files.h"
 #include "log.h"
+#include "misc.h"
 #include "parser.h"
 #include "passes.h"
+#include "passResources.h"
+#include "perfReport.h"
 #include "PhaseTracker.h"
+#include "stringutil.h"
 
 #include <cstdio>
+#include <cstring>
 #include <sys/time.h>
 
 int   currentPassNo   = 1;
@@ -70,16 +76,22 @@ struct PassInfo {
 #define LOG_refPropagation                     LOG_NO_SHORT
 #define LOG_copyPropagation                    LOG_NO_SHORT
 #define LOG_deadCodeElimination                LOG_NO_SHORT
+#define LOG_stackAllocateClasses               LOG_NO_SHORT
 #define LOG_removeEmptyRecords                 LOG_NO_SHORT
 #define LOG_localizeGlobals                    LOG_NO_SHORT
 #define LOG_loopInvariantCodeMotion            LOG_NO_SHORT
+#define LOG_loopFusion                         LOG_NO_SHORT
+#define LOG_loopTiling                         LOG_NO_SHORT
 #define LOG_prune2                             LOG_NO_SHORT
 #define LOG_returnStarTuplesByRefArgs          LOG_NO_SHORT
 #define LOG_insertWideReferences               LOG_NO_SHORT
 #define LOG_optimizeOnClauses                  LOG_NO_SHORT
 #define LOG_addInitCalls                       LOG_NO_SHORT
 #define LOG_insertLineNumbers                  LOG_NO_SHORT
+#define LOG_globalValueNumbering               LOG_NO_SHORT
 #define LOG_denormalize                        LOG_NO_SHORT
+#define LOG_reorderFields                      LOG_NO_SHORT
+#define LOG_prune3                             LOG_NO_SHORT
 #define LOG_codegen                            'c'
 #define LOG_makeBinary                         LOG_NEVER
 
@@ -137,9 +149,12 @@ static PassInfo sPassList[] = {
   RUN(refPropagation),          // reference propagation
   RUN(copyPropagation),         // copy propagation
   RUN(deadCodeElimination),     // eliminate dead code
+  RUN(stackAllocateClasses),    // stack-allocate non-escaping classes
   RUN(removeEmptyRecords),      // remove empty records
   RUN(localizeGlobals),         // pull out global constants from loop runs
   RUN(loopInvariantCodeMotion), // move loop invariant code above loop runs
+  RUN(loopFusion),              // fuse adjacent order-independent loops
+  RUN(loopTiling),              // cache-tile order-independent loop nests
   RUN(prune2),                  // prune AST of dead functions and types again
 
   RUN(returnStarTuplesByRefArgs),
@@ -150,7 +165,10 @@ static PassInfo sPassList[] = {
 
   // AST to C or LLVM
   RUN(insertLineNumbers),       // insert line numbers for error messages
+  RUN(globalValueNumbering),    // reuse redundant array element addresses
   RUN(denormalize),             // denormalize -- remove local temps
+  RUN(reorderFields),           // reorder record fields for tighter layout
+  RUN(prune3),                  // prune dead functions before emitting them
   RUN(codegen),                 // generate C code
   RUN(makeBinary)               // invoke underlying C compiler
 };
@@ -189,6 +207,60 @@ void runPasses(PhaseTracker& tracker, bool isChpldoc) {
     }
   }
 
+  // Retire anything still registered, e.g. after an early break above
+  retireAllPassResources();
+
+  perfReportPrint();
+
+  destroyAst();
+  teardownLogfiles();
+}
+
+//
+// Resume a compile from its generated-code checkpoint: run only the
+// makeBinary pass against a directory saved with --savec.  Pairing
+// --savec with --stop-after-pass codegen makes a checkpoint at the
+// codegen boundary in one compile; resuming then skips the whole
+// middle end, which is what you want when the back end ran out of
+// memory or when iterating on back-end flags.  The generated
+// Makefile already records everything makeBinary needs, so nothing
+// is reloaded into the AST; that also means this only works with the
+// C back end, whose makeBinary is driven entirely by that Makefile.
+//
+void resumeFromCheckpoint(PhaseTracker& tracker) {
+  size_t passListSize = sizeof(sPassList) / sizeof(sPassList[0]);
+
+  if (fLlvmCodegen)
+    USR_FATAL("--resume-from-checkpoint requires the C back end");
+
+  const char* makefile = astr(fResumeCheckpointDir, "/Makefile");
+
+  if (FILE* fp = fopen(makefile, "r")) {
+    fclose(fp);
+  } else {
+    USR_FATAL("'%s' is not a checkpoint directory: no generated Makefile "
+              "(save one with --savec)", fResumeCheckpointDir);
+  }
+
+  // Route the intermediate directory at the checkpoint through the
+  // --savec mechanism, which also keeps it from being deleted on exit.
+  strncpy(saveCDir, fResumeCheckpointDir, FILENAME_MAX);
+  saveCDir[FILENAME_MAX] = '\0';
+
+  setupLogfiles();
+
+  for (size_t i = 0; i < passListSize; i++) {
+    if (strcmp(sPassList[i].name, "makeBinary") == 0) {
+      currentPassNo = (int) i + 1;
+      runPass(tracker, i, /* isChpldoc */ false);
+      break;
+    }
+  }
+
+  USR_STOP();
+
+  retireAllPassResources();
+
   destroyAst();
   teardownLogfiles();
 }
@@ -224,6 +296,11 @@ static void runPass(PhaseTracker& tracker, size_t passIndex, bool isChpldoc) {
   tracker.StartPhase(info->name, PhaseTracker::kVerify);
   (*(info->checkFunction))(); // Run per-pass check function.
 
+  //
+  // Free side structures whose declared last consumer was this pass
+  //
+  retirePassResources(info->name);
+
   //
   // Clean up the global pointers to AST.  If we're running chpldoc,
   // there's no real reason to run this step (and at the time of this
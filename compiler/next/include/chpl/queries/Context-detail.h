@@ -25,8 +25,10 @@
 #include "chpl/util/memory.h"
 #include "chpl/util/hash.h"
 
+#include <atomic>
 #include <cstdint>
 #include <cstring>
+#include <thread>
 #include <tuple>
 #include <unordered_set>
 #include <utility>
@@ -178,10 +180,20 @@ class QueryMapResultBase {
   //  * if it is a previous revision, dependencies need to be checked
   //    and re-run if they are out of date.
   //  * if it is the current revision, the result can be reused
-  mutable RevisionNumber lastChecked;
+  //  * if it is -1, the query is currently being computed
+  //
+  // It is atomic so that threads can check for a completed result
+  // without locking; it is only written while holding the Context's
+  // query lock (or before the entry is visible to other threads).
+  mutable std::atomic<RevisionNumber> lastChecked;
   // lastChanged indicates the last revision in which the query result
   // has changed
-  mutable RevisionNumber lastChanged;
+  mutable std::atomic<RevisionNumber> lastChanged;
+
+  // when lastChecked == -1, the thread computing (or about to compute)
+  // this result. Read and written while holding the Context's query
+  // lock, except for the initialization here.
+  mutable std::thread::id computingThread;
 
   mutable QueryDependencyVec dependencies;
   mutable QueryErrorVec errors;
@@ -193,6 +205,7 @@ class QueryMapResultBase {
                      QueryMapBase* parentQueryMap)
     : lastChecked(lastChecked),
       lastChanged(lastChanged),
+      computingThread(std::this_thread::get_id()),
       dependencies(),
       errors(),
       parentQueryMap(parentQueryMap) {
@@ -26,7 +26,11 @@
 #include "chpl/util/memory.h"
 #include "chpl/util/hash.h"
 
+#include <atomic>
+#include <condition_variable>
 #include <memory>
+#include <mutex>
+#include <thread>
 #include <tuple>
 #include <unordered_map>
 #include <unordered_set>
@@ -203,7 +207,23 @@ class Context {
  private:
   // map that supports uniqueCString / UniqueString
   using UniqueStringsTableType = std::unordered_set<chpl::detail::StringAndLength, chpl::detail::UniqueStrHash, chpl::detail::UniqueStrEqual>;
-  UniqueStringsTableType uniqueStringsTable;
+
+  // The interning table is split into a fixed number of shards, each
+  // guarded by its own mutex, so UniqueString construction can scale
+  // across threads once parsing runs in parallel.  A string's shard is
+  // chosen from its hash, so lookups for the same string always visit
+  // the same shard.
+  static const size_t nUniqueStringsShards = 16;
+  struct UniqueStringsShard {
+    std::mutex mutex;
+    UniqueStringsTableType table;
+  };
+  UniqueStringsShard uniqueStringsShards[nUniqueStringsShards];
+
+  UniqueStringsShard& shardForUniqueString(chpl::detail::StringAndLength key) {
+    size_t h = chpl::detail::UniqueStrHash()(key);
+    return uniqueStringsShards[h & (nUniqueStringsShards - 1)];
+  }
 
   // Map from a query function pointer to appropriate QueryMap object.
   // Maps to an 'owned' heap-allocated thing to manage having subclasses
@@ -217,11 +237,42 @@ class Context {
   //  start including file path in IDs).
   std::unordered_map<UniqueString, UniqueString> modNameToFilepath;
 
-  std::vector<const querydetail::QueryMapResultBase*> queryStack;
+  // Thread safety for queries works as follows:
+  //  * queryMutex_ guards queryDB, the per-query maps, and the
+  //    bookkeeping fields (lastChecked, lastChanged, dependencies,
+  //    errors) of results this thread is not currently computing
+  //  * while a thread computes a query body, it owns that result entry
+  //    (the entry's lastChecked is -1 and computingThread identifies
+  //    it); the query body itself runs without the lock held
+  //  * another thread asking for the same query key waits on
+  //    queryCondVar_ until the computation finishes, so concurrent
+  //    threads computing the same query deduplicate the work
+  //  * results already checked in the current revision are immutable
+  //    until the next revision, so reusing them needs no lock at all
+  //    (see queryCanUseSavedResultAndPushIfNot)
+  //  * waitingOn_ records, for each waiting thread, the result it is
+  //    waiting for, so a cycle of threads waiting on each other's
+  //    queries is detected rather than deadlocking
+  //
+  // Revisions may only be advanced and garbage collected while no
+  // queries are running on any thread.
+  std::mutex queryMutex_;
+  std::condition_variable queryCondVar_;
+  std::unordered_map<std::thread::id,
+                     const querydetail::QueryMapResultBase*> waitingOn_;
+
+  // The stack of queries being computed, per thread, used to record
+  // dependencies and to attribute errors. Kept per-context (rather
+  // than thread_local) so that a thread working with several contexts
+  // does not mix their dependencies.
+  using QueryStackType = std::vector<const querydetail::QueryMapResultBase*>;
+  std::unordered_map<std::thread::id, QueryStackType> queryStacks;
+  std::mutex queryStacksMutex_;
+  QueryStackType& threadQueryStack();
 
   querydetail::RevisionNumber currentRevisionNumber = 1;
   bool enableDebugTracing = false;
-  int numQueriesRunThisRevision_ = 0;
+  std::atomic<int> numQueriesRunThisRevision_{0};
 
   static void defaultReportError(const ErrorMessage& err);
   void (*reportError)(const ErrorMessage& err) = defaultReportError;
@@ -237,10 +288,16 @@ class Context {
   const char* getOrCreateUniqueString(const char* str, size_t len);
 
   // saves the dependency in the parent query, which is assumed
-  // to be at queryStack.back().
+  // to be at the back of this thread's query stack.
   void saveDependencyInParent(const querydetail::QueryMapResultBase* resultEntry);
   void endQueryHandleDependency(const querydetail::QueryMapResultBase* result);
 
+  // Waits until another thread finishes computing 'resultEntry'.
+  // Halts if doing so would create a cycle of waiting threads.
+  // Expects 'guard' to hold queryMutex_; it is held again on return.
+  void waitForInFlightResult(const querydetail::QueryMapResultBase* resultEntry,
+                             std::unique_lock<std::mutex>& guard);
+
   template<typename ResultType,
            typename... ArgTs>
   querydetail::QueryMap<ResultType, ArgTs...>*
@@ -298,15 +355,16 @@ class Context {
        const std::tuple<ArgTs...>& tupleOfArgs,
        const char* traceQueryName);
 
-  void recomputeIfNeeded(const querydetail::QueryMapResultBase* resultEntry);
+  // Expects 'guard' to hold queryMutex_; it is released around any
+  // query recomputation and held again on return.
+  void recomputeIfNeeded(const querydetail::QueryMapResultBase* resultEntry,
+                         std::unique_lock<std::mutex>& guard);
   void updateForReuse(const querydetail::QueryMapResultBase* resultEntry);
 
   bool queryCanUseSavedResultAndPushIfNot(
             const void* queryFunction,
             const querydetail::QueryMapResultBase* resultEntry);
 
-  // Future Work: make the context thread-safe
-
   // Future Work: allow moving some AST to a different context
   //              (or, at least, that can handle the unique strings)
 
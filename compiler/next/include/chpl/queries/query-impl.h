@@ -135,6 +135,8 @@ Context::getMap(const ResultType& (*queryFunc)(Context* context, ArgTs...),
 
   const void* queryFuncV = (const void*) queryFunc;
 
+  std::lock_guard<std::mutex> guard(queryMutex_);
+
   // Look up the map entry for this query
   auto search = this->queryDB.find(queryFuncV);
   if (search != this->queryDB.end()) {
@@ -177,6 +179,8 @@ const QueryMapResult<ResultType, ArgTs...>*
 Context::getResult(QueryMap<ResultType, ArgTs...>* queryMap,
                    const std::tuple<ArgTs...>& tupleOfArgs) {
 
+  std::unique_lock<std::mutex> guard(queryMutex_);
+
   // Run the constructor QueryMapResult(queryMap, tupleOfArgs)
   // and insert the result into the map if it is not already present.
   auto pair = queryMap->map.emplace(queryMap, tupleOfArgs);
@@ -191,7 +195,14 @@ Context::getResult(QueryMap<ResultType, ArgTs...>* queryMap,
   }
 
   if (newElementWasAdded == false && savedElement->lastChecked == -1) {
-    haltForRecursiveQuery(savedElement);
+    if (savedElement->computingThread == std::this_thread::get_id()) {
+      // this thread is already computing this query: recursion
+      haltForRecursiveQuery(savedElement);
+    } else {
+      // another thread is computing this query; wait for its result
+      // so that concurrent requests for the same query deduplicate
+      waitForInFlightResult(savedElement, guard);
+    }
   }
 
   return savedElement;
@@ -243,6 +254,9 @@ const ResultType* Context::queryGetRunningQueryPartialResult(
              const char* traceQueryName) {
   // Look up the map entry for this query name
   const void* queryFuncV = (const void*) queryFunction;
+
+  std::lock_guard<std::mutex> guard(queryMutex_);
+
   // Look up the map entry for this query
   auto search = this->queryDB.find(queryFuncV);
   if (search == this->queryDB.end()) {
@@ -252,7 +266,7 @@ const ResultType* Context::queryGetRunningQueryPartialResult(
   // found an entry for this query
   QueryMapBase* base = search->second.get();
   auto queryMap = (QueryMap<ResultType, ArgTs...>*)base;
-  auto key = QueryMapResult<ResultType, ArgTs...>(queryMap, tupleOfArgs);
+  QueryMapResult<ResultType, ArgTs...> key(queryMap, tupleOfArgs);
   auto search2 = queryMap->map.find(key);
   if (search2 == queryMap->map.end()) {
     return nullptr;
@@ -263,6 +277,12 @@ const ResultType* Context::queryGetRunningQueryPartialResult(
     return nullptr;
   }
 
+  // a partial result is only meaningful for natural recursion within
+  // this thread; another thread's in-progress result is off limits
+  if (search2->computingThread != std::this_thread::get_id()) {
+    return nullptr;
+  }
+
   // query is currently running so return the partial result
   return &search2->result;
 }
@@ -274,6 +294,9 @@ Context::QueryStatus Context::queryStatus(
              const std::tuple<ArgTs...>& tupleOfArgs) {
   // Look up the map entry for this query name
   const void* queryFuncV = (const void*) queryFunction;
+
+  std::lock_guard<std::mutex> guard(queryMutex_);
+
   // Look up the map entry for this query
   auto search = this->queryDB.find(queryFuncV);
   if (search == this->queryDB.end()) {
@@ -283,7 +306,7 @@ Context::QueryStatus Context::queryStatus(
   // found an entry for this query
   QueryMapBase* base = search->second.get();
   auto queryMap = (QueryMap<ResultType, ArgTs...>*)base;
-  auto key = QueryMapResult<ResultType, ArgTs...>(queryMap, tupleOfArgs);
+  QueryMapResult<ResultType, ArgTs...> key(queryMap, tupleOfArgs);
   auto search2 = queryMap->map.find(key);
   if (search2 == queryMap->map.end()) {
     return NOT_CHECKED_NOT_CHANGED;
@@ -310,7 +333,7 @@ Context::queryEnd(
               const char* traceQueryName) {
 
   // must be in a query to be running one!
-  assert(queryStack.size() > 0);
+  assert(threadQueryStack().size() > 0);
 
   const QueryMapResult<ResultType, ArgTs...>* ret =
     this->updateResultForQueryMapR(queryMap, r, tupleOfArgs,
@@ -342,6 +365,8 @@ Context::updateResultForQueryMapR(QueryMap<ResultType, ArgTs...>* queryMap,
                                   bool forSetter) {
   assert(r != nullptr);
 
+  std::unique_lock<std::mutex> guard(queryMutex_);
+
   // If we already have found a result, use that.
   //
   // Call a chpl::update function. That leaves the result in the 1st argument
@@ -375,6 +400,11 @@ Context::updateResultForQueryMapR(QueryMap<ResultType, ArgTs...>* queryMap,
   if (changed || initialResult) {
     r->lastChanged  = currentRevision;
   }
+
+  // wake up any threads waiting for this result to be computed
+  guard.unlock();
+  queryCondVar_.notify_all();
+
   return r;
 }
 
@@ -423,6 +453,9 @@ Context::hasResultForQuery(
 
   // Look up the map entry for this query name
   const void* queryFuncV = (const void*) queryFunction;
+
+  std::lock_guard<std::mutex> guard(queryMutex_);
+
   // Look up the map entry for this query
   auto search = this->queryDB.find(queryFuncV);
   if (search == this->queryDB.end()) {
@@ -432,7 +465,7 @@ Context::hasResultForQuery(
   // found an entry for this query
   QueryMapBase* base = search->second.get();
   auto queryMap = (QueryMap<ResultType, ArgTs...>*)base;
-  auto key = QueryMapResult<ResultType, ArgTs...>(queryMap, tupleOfArgs);
+  QueryMapResult<ResultType, ArgTs...> key(queryMap, tupleOfArgs);
   auto search2 = queryMap->map.find(key);
   if (search2 == queryMap->map.end()) {
     return false;
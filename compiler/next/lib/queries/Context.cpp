@@ -68,10 +68,12 @@ void Context::defaultReportError(const ErrorMessage& err) {
 
 Context::~Context() {
   // free all of the unique'd strings
-  for (auto& item: uniqueStringsTable) {
-    char* buf = (char*) item.str;
-    buf -= UNIQUED_STRING_METADATA_BYTES;
-    free(buf);
+  for (auto& shard: uniqueStringsShards) {
+    for (auto& item: shard.table) {
+      char* buf = (char*) item.str;
+      buf -= UNIQUED_STRING_METADATA_BYTES;
+      free(buf);
+    }
   }
 }
 
@@ -127,8 +129,10 @@ char* Context::setupStringMetadata(char* buf, size_t len) {
 // allocates new storage for the string if it was not found
 const char* Context::getOrCreateUniqueString(const char* str, size_t len) {
   chpl::detail::StringAndLength key = {str, len};
-  auto search = this->uniqueStringsTable.find(key);
-  if (search != this->uniqueStringsTable.end()) {
+  auto& shard = shardForUniqueString(key);
+  std::lock_guard<std::mutex> guard(shard.mutex);
+  auto search = shard.table.find(key);
+  if (search != shard.table.end()) {
     const char* ret = search->str;
     // update the GC mark
     this->markUniqueCString(ret);
@@ -145,7 +149,7 @@ const char* Context::getOrCreateUniqueString(const char* str, size_t len) {
   s[len] = 0x0;
   // Add it to the table
   chpl::detail::StringAndLength ret = {s, len};
-  this->uniqueStringsTable.insert(search, ret);
+  shard.table.insert(search, ret);
   return s;
 }
 
@@ -159,25 +163,20 @@ const char* Context::uniqueCString(const char* str) {
   return this->getOrCreateUniqueString(str, strlen(str));
 }
 
-const char* Context::uniqueCStringConcatLen(const char* s1, size_t len1,
-                                            const char* s2, size_t len2,
-                                            const char* s3, size_t len3,
-                                            const char* s4, size_t len4,
-                                            const char* s5, size_t len5,
-                                            const char* s6, size_t len6,
-                                            const char* s7, size_t len7,
-                                            const char* s8, size_t len8,
-                                            const char* s9, size_t len9) {
-  size_t len = len1 + len2 + len3 + len4 + len5 + len6 + len7 + len8 + len9;
+// Copies each non-empty string into s, which must have room for the
+// total length plus a null terminator, and null terminates.
+static void concatIntoBuffer(char* s,
+                             const char* s1, size_t len1,
+                             const char* s2, size_t len2,
+                             const char* s3, size_t len3,
+                             const char* s4, size_t len4,
+                             const char* s5, size_t len5,
+                             const char* s6, size_t len6,
+                             const char* s7, size_t len7,
+                             const char* s8, size_t len8,
+                             const char* s9, size_t len9) {
+  size_t len = 0;
 
-  size_t allocLen = UNIQUED_STRING_METADATA_BYTES+len+1; // metadata, len, null
-  char* buf = allocateEvenAligned(allocLen);
-  // setup metadata
-  char* s = setupStringMetadata(buf, len);
-
-  len = 0;
-
-  // copy each non-empty string
   if (len1 > 0) {
     memcpy(&s[len], s1, len1);
     len += len1;
@@ -217,11 +216,45 @@ const char* Context::uniqueCStringConcatLen(const char* s1, size_t len1,
 
   // null terminate
   s[len] = '\0';
+}
+
+const char* Context::uniqueCStringConcatLen(const char* s1, size_t len1,
+                                            const char* s2, size_t len2,
+                                            const char* s3, size_t len3,
+                                            const char* s4, size_t len4,
+                                            const char* s5, size_t len5,
+                                            const char* s6, size_t len6,
+                                            const char* s7, size_t len7,
+                                            const char* s8, size_t len8,
+                                            const char* s9, size_t len9) {
+  size_t len = len1 + len2 + len3 + len4 + len5 + len6 + len7 + len8 + len9;
+
+  // Most concatenations (e.g. from name mangling) produce a string
+  // that is already in the table, so when the result is small enough,
+  // assemble it on the stack and only allocate on a miss.
+  char stackBuf[512];
+  if (len < sizeof(stackBuf)) {
+    concatIntoBuffer(stackBuf,
+                     s1, len1, s2, len2, s3, len3, s4, len4, s5, len5,
+                     s6, len6, s7, len7, s8, len8, s9, len9);
+    return this->getOrCreateUniqueString(stackBuf, len);
+  }
+
+  size_t allocLen = UNIQUED_STRING_METADATA_BYTES+len+1; // metadata, len, null
+  char* buf = allocateEvenAligned(allocLen);
+  // setup metadata
+  char* s = setupStringMetadata(buf, len);
+
+  concatIntoBuffer(s,
+                   s1, len1, s2, len2, s3, len3, s4, len4, s5, len5,
+                   s6, len6, s7, len7, s8, len8, s9, len9);
 
   // Check for it in the table
   chpl::detail::StringAndLength key = {s, len};
-  auto search = this->uniqueStringsTable.find(key);
-  if (search != this->uniqueStringsTable.end()) {
+  auto& shard = shardForUniqueString(key);
+  std::lock_guard<std::mutex> guard(shard.mutex);
+  auto search = shard.table.find(key);
+  if (search != shard.table.end()) {
     const char* ret = search->str;
     // update the GC mark
     this->markUniqueCString(ret);
@@ -231,7 +264,7 @@ const char* Context::uniqueCStringConcatLen(const char* s1, size_t len1,
 
   // Add it to the table
   chpl::detail::StringAndLength ret = {s, len};
-  this->uniqueStringsTable.insert(search, ret);
+  shard.table.insert(search, ret);
   return s;
 }
 
@@ -370,6 +403,13 @@ bool Context::hasFilePathForId(ID id) {
   return false;
 }
 
+Context::QueryStackType& Context::threadQueryStack() {
+  // The map's nodes are stable, so the returned reference remains
+  // valid while other threads add their own stacks.
+  std::lock_guard<std::mutex> guard(queryStacksMutex_);
+  return queryStacks[std::this_thread::get_id()];
+}
+
 void Context::advanceToNextRevision(bool prepareToGC) {
   this->currentRevisionNumber++;
   this->numQueriesRunThisRevision_ = 0;
@@ -386,56 +426,62 @@ void Context::advanceToNextRevision(bool prepareToGC) {
 }
 
 void Context::collectGarbage() {
-  // if there are no parent queries, collect some garbage
-  assert(queryStack.size() == 0);
+  // if there are no parent queries, collect some garbage.
+  // (queries must not be running on any thread; see queryMutex_)
+  assert(threadQueryStack().size() == 0);
 
   if (enableDebugTracing) {
     printf("COLLECTING GARBAGE\n");
   }
 
-  // clear out the saved old results
-  // warning: this loop proceeds in a nondeterministic order
-  for (auto& dbEntry: queryDB) {
-    QueryMapBase* queryMapBase = dbEntry.second.get();
-    queryMapBase->clearOldResults(this->currentRevisionNumber);
+  {
+    std::lock_guard<std::mutex> guard(queryMutex_);
+    // clear out the saved old results
+    // warning: this loop proceeds in a nondeterministic order
+    for (auto& dbEntry: queryDB) {
+      QueryMapBase* queryMapBase = dbEntry.second.get();
+      queryMapBase->clearOldResults(this->currentRevisionNumber);
+    }
   }
 
   if (this->lastPrepareToGCRevisionNumber == this->currentRevisionNumber) {
     // remove UniqueStrings that have not been marked
 
-    size_t nUniqueStringsBefore = uniqueStringsTable.size();
+    size_t nUniqueStringsBefore = 0;
+    size_t nUniqueStringsAfter = 0;
 
-    // Performance: Would it be better to modify the table in-place
-    // rather than creating a new table as is done here?
+    // Erase unmarked entries in-place; erasing during iteration is
+    // safe for unordered_set and avoids rehashing the survivors into
+    // a fresh table on every GC revision.
     char gcMark = this->gcCounter & 0xff;
-    UniqueStringsTableType newTable;
-    std::vector<char*> toFree;
-    // warning: this loop proceeds in a nondeterministic order
-    for (auto& e: uniqueStringsTable) {
-      const char* key = e.str;
-      char* buf = (char*)key;
-      buf -= UNIQUED_STRING_METADATA_BYTES; // find start of allocation
-      char* allocation = buf;
-      buf += UNIQUED_STRING_METADATA_LEN; // pass the length
-      if (buf[0] == gcMark) {
-        newTable.insert(e);
-        if (enableDebugTracing) {
-          printf("COPYING OVER UNIQUESTRING %s\n", key);
-        }
-      } else {
-        toFree.push_back(allocation);
-        if (enableDebugTracing) {
-          printf("WILL FREE UNIQUESTRING %s\n", key);
+    // warning: these loops proceed in a nondeterministic order
+    for (auto& shard: uniqueStringsShards) {
+      std::lock_guard<std::mutex> guard(shard.mutex);
+      nUniqueStringsBefore += shard.table.size();
+      for (auto it = shard.table.begin();
+           it != shard.table.end(); ) {
+        const char* key = it->str;
+        char* buf = (char*)key;
+        buf -= UNIQUED_STRING_METADATA_BYTES; // find start of allocation
+        char* allocation = buf;
+        buf += UNIQUED_STRING_METADATA_LEN; // pass the length
+        if (buf[0] == gcMark) {
+          if (enableDebugTracing) {
+            printf("KEEPING UNIQUESTRING %s\n", key);
+          }
+          ++it;
+        } else {
+          if (enableDebugTracing) {
+            printf("FREEING UNIQUESTRING %s\n", key);
+          }
+          it = shard.table.erase(it);
+          free(allocation);
         }
       }
+      nUniqueStringsAfter += shard.table.size();
     }
-    for (char* allocation: toFree) {
-      free(allocation);
-    }
-    uniqueStringsTable.swap(newTable);
 
     if (enableDebugTracing) {
-      size_t nUniqueStringsAfter = uniqueStringsTable.size();
       printf("COLLECTED %i UniqueStrings\n",
              (int)(nUniqueStringsBefore-nUniqueStringsAfter));
     }
@@ -460,6 +506,7 @@ void Context::setFilePathForModuleID(ID moduleID, UniqueString path) {
 }
 
 void Context::error(ErrorMessage error) {
+  auto& queryStack = threadQueryStack();
   if (queryStack.size() > 0) {
     queryStack.back()->errors.push_back(std::move(error));
     reportError(queryStack.back()->errors.back());
@@ -511,7 +558,8 @@ void Context::error(const resolution::TypedFnSignature* inFn,
 }
 
 
-void Context::recomputeIfNeeded(const QueryMapResultBase* resultEntry) {
+void Context::recomputeIfNeeded(const QueryMapResultBase* resultEntry,
+                                std::unique_lock<std::mutex>& guard) {
 
   if (enableDebugTracing) {
     printf("RECOMPUTING IF NEEDED FOR %p %s\n", resultEntry,
@@ -528,7 +576,11 @@ void Context::recomputeIfNeeded(const QueryMapResultBase* resultEntry) {
     // For an input query, compute it once per revision, ignoring
     // dependencies (e.g. if it is reading a file, we need to check that the
     // file has not changed.)
+    // Run the query without holding the lock; it takes the lock itself
+    // as needed (and another thread might finish it for us).
+    guard.unlock();
     resultEntry->recompute(this);
+    guard.lock();
     assert(resultEntry->lastChecked == this->currentRevisionNumber);
     return;
   }
@@ -544,7 +596,7 @@ void Context::recomputeIfNeeded(const QueryMapResultBase* resultEntry) {
     } else if (this->currentRevisionNumber == dependency->lastChecked) {
       // No need to check the dependency again; already did and it was OK
     } else {
-      recomputeIfNeeded(dependency);
+      recomputeIfNeeded(dependency, guard);
       // we might have recomputed the dependency, so check its lastChanged
       if (dependency->lastChanged > resultEntry->lastChanged) {
         useSaved = false;
@@ -554,7 +606,9 @@ void Context::recomputeIfNeeded(const QueryMapResultBase* resultEntry) {
   }
 
   if (useSaved == false) {
+    guard.unlock();
     resultEntry->recompute(this);
+    guard.lock();
     assert(resultEntry->lastChecked == this->currentRevisionNumber);
     if (enableDebugTracing) {
       printf("DONE RECOMPUTING IF NEEDED -- RECOMPUTED FOR %s\n",
@@ -599,6 +653,23 @@ bool Context::queryCanUseSavedResultAndPushIfNot(
 
   assert(resultEntry != nullptr);
 
+  // Lock-free fast path: a result already checked in this revision is
+  // immutable until the next revision, so it can be reused without
+  // taking the lock.
+  if (this->currentRevisionNumber == resultEntry->lastChecked) {
+    return true;
+  }
+
+  std::unique_lock<std::mutex> guard(queryMutex_);
+
+  if (resultEntry->lastChecked == -1) {
+    // Another thread started computing this query after our entry
+    // lookup; wait for its result rather than computing it again.
+    // (Recursion by this thread is detected at the entry lookup.)
+    waitForInFlightResult(resultEntry, guard);
+    return true;
+  }
+
   if (resultEntry->lastChanged == -1) {
     // If it is a new entry, we can't reuse it
     useSaved = false;
@@ -611,13 +682,22 @@ bool Context::queryCanUseSavedResultAndPushIfNot(
   } else {
     useSaved = true;
     for (const QueryMapResultBase* dependency : resultEntry->dependencies) {
-      recomputeIfNeeded(dependency);
+      recomputeIfNeeded(dependency, guard);
       assert(dependency->lastChecked == this->currentRevisionNumber);
       if (dependency->lastChanged > resultEntry->lastChanged) {
         useSaved = false;
         break;
       }
     }
+    // recomputing a dependency released the lock, so this query might
+    // have been computed by another thread in the meantime
+    if (resultEntry->lastChecked == -1) {
+      waitForInFlightResult(resultEntry, guard);
+      return true;
+    }
+    if (this->currentRevisionNumber == resultEntry->lastChecked) {
+      return true;
+    }
     if (useSaved == true) {
       updateForReuse(resultEntry);
     }
@@ -626,10 +706,11 @@ bool Context::queryCanUseSavedResultAndPushIfNot(
   if (useSaved == false) {
     // Since the result cannot be reused, the query will be evaluated.
     // So, push something to queryDeps
-    queryStack.push_back(resultEntry);
+    threadQueryStack().push_back(resultEntry);
     // Record that this query is being recomputed
-    // (to enable detecting recursion)
+    // (to enable detecting recursion, including from other threads)
     resultEntry->lastChecked = -1;
+    resultEntry->computingThread = std::this_thread::get_id();
     // Clear out the dependencies and errors since these will be recomputed
     // by evaluating the query.
     resultEntry->dependencies.clear();
@@ -641,11 +722,40 @@ bool Context::queryCanUseSavedResultAndPushIfNot(
   return useSaved;
 }
 
+void Context::waitForInFlightResult(const QueryMapResultBase* resultEntry,
+                                    std::unique_lock<std::mutex>& guard) {
+  auto self = std::this_thread::get_id();
+
+  // Cycle detection across threads: follow the chain of computations
+  // this wait would depend on. If some thread in the chain is waiting
+  // for a result this thread is computing, the queries form a cycle
+  // and waiting would deadlock, so halt as for recursion.
+  const QueryMapResultBase* cur = resultEntry;
+  while (cur != nullptr && cur->lastChecked == -1) {
+    if (cur->computingThread == self) {
+      haltForRecursiveQuery(resultEntry);
+    }
+    auto search = waitingOn_.find(cur->computingThread);
+    cur = (search != waitingOn_.end()) ? search->second : nullptr;
+  }
+
+  waitingOn_[self] = resultEntry;
+  queryCondVar_.wait(guard, [resultEntry]() {
+    return resultEntry->lastChecked != -1;
+  });
+  waitingOn_.erase(self);
+
+  assert(resultEntry->lastChecked == this->currentRevisionNumber);
+}
+
 void Context::saveDependencyInParent(const QueryMapResultBase* resultEntry) {
   // Record that the parent query depends upon this one.
   //
   // We haven't pushed the query beginning yet; on already popped it.
-  // So, the parent query is at queryDeps.back().
+  // So, the parent query is at the back of this thread's query stack.
+  // The parent's dependency vector is owned by this thread while the
+  // parent is being computed, so no lock is needed.
+  auto& queryStack = threadQueryStack();
   if (queryStack.size() > 0) {
     assert(queryStack.back() != resultEntry); // should be parent query
     queryStack.back()->dependencies.push_back(resultEntry);
@@ -653,6 +763,7 @@ void Context::saveDependencyInParent(const QueryMapResultBase* resultEntry) {
 }
 void Context::endQueryHandleDependency(const QueryMapResultBase* resultEntry) {
   // Remove the current query from the stack
+  auto& queryStack = threadQueryStack();
   assert(queryStack.back() == resultEntry);
   queryStack.pop_back();
 
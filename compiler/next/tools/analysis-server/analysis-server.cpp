@@ -0,0 +1,270 @@
+/*
+ * Copyright 2021 Hewlett Packard Enterprise Development LP
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+  A long-lived analysis server over the query framework.
+
+  Editor integrations pay the full cost of resolution on every request
+  when each request is a fresh process.  This server instead keeps one
+  Context warm across edits: each `check` advances the Context to a new
+  revision, replays the current buffer contents as the revision's
+  inputs, and re-runs parsing and resolution, so the generation
+  mechanism reuses every result whose inputs didn't change and only
+  work downstream of the edited declarations is redone.
+
+  The protocol is line-oriented on stdin, one reply block per command
+  on stdout:
+
+    load <path>            read the file from disk into the buffer set
+    edit <path> <nbytes>   replace the buffer with the next nbytes
+    check                  re-resolve all buffers in a new revision;
+                           reports diagnostics, queries re-run, and ms
+    hover <path> <line> <col>
+                           describe the innermost AST node there,
+                           with its resolved type when available
+    gc                     like check, but also collect garbage from
+                           results orphaned by past revisions
+    quit                   exit
+
+  The `queries=` figure in check replies is the interesting one for
+  latency work: after an edit local to one function it should be a
+  small fraction of the initial run's count.
+*/
+
+#include "chpl/parsing/parsing-queries.h"
+#include "chpl/queries/query-impl.h"
+#include "chpl/resolution/resolution-queries.h"
+#include "chpl/resolution/scope-queries.h"
+#include "chpl/uast/Identifier.h"
+#include "chpl/uast/Module.h"
+#include "chpl/uast/NamedDecl.h"
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+
+using namespace chpl;
+using namespace parsing;
+using namespace resolution;
+using namespace uast;
+
+// the buffer set: path -> current contents, replayed every revision
+static std::map<std::string, std::string> gBuffers;
+
+static int gErrorCount = 0;
+
+static void reportDiagnostic(const ErrorMessage& err) {
+  gErrorCount++;
+  printf("diag %s:%d: %s\n",
+         err.path().c_str(), err.line(), err.message().c_str());
+}
+
+static double msSince(std::chrono::steady_clock::time_point start) {
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  return std::chrono::duration<double, std::milli>(elapsed).count();
+}
+
+//
+// Advance to the next revision, replay the buffers as inputs, and
+// re-run parsing and module resolution over everything loaded.  The
+// query framework compares the replayed inputs against the previous
+// revision and reuses all unchanged downstream results.
+//
+static void check(Context* ctx, bool gc) {
+  auto start = std::chrono::steady_clock::now();
+
+  gErrorCount = 0;
+  ctx->advanceToNextRevision(gc);
+
+  for (const auto& buf : gBuffers) {
+    auto path = UniqueString::build(ctx, buf.first);
+    setFileText(ctx, path, buf.second);
+  }
+
+  int nModules = 0;
+  for (const auto& buf : gBuffers) {
+    auto path = UniqueString::build(ctx, buf.first);
+    const ModuleVec& mods = parse(ctx, path);
+    for (const auto mod : mods) {
+      resolveModule(ctx, mod->id());
+      nModules++;
+    }
+  }
+
+  if (gc) {
+    ctx->collectGarbage();
+  }
+
+  printf("checked files=%d modules=%d errors=%d queries=%d ms=%.1f\n",
+         (int) gBuffers.size(), nModules, gErrorCount,
+         ctx->numQueriesRunThisRevision(), msSince(start));
+}
+
+static bool locationContains(const Location& loc, int line, int col) {
+  if (line < loc.firstLine() || line > loc.lastLine())
+    return false;
+  if (line == loc.firstLine() && col < loc.firstColumn())
+    return false;
+  if (line == loc.lastLine() && col > loc.lastColumn())
+    return false;
+  return true;
+}
+
+// the innermost non-comment node whose location contains the position
+static const ASTNode* findNodeAt(Context* ctx, const ASTNode* ast,
+                                 int line, int col) {
+  if (ast->isComment())
+    return nullptr;
+
+  for (const ASTNode* child : ast->children()) {
+    if (const ASTNode* found = findNodeAt(ctx, child, line, col))
+      return found;
+  }
+
+  const Location& loc = locateAst(ctx, ast);
+  return locationContains(loc, line, col) ? ast : nullptr;
+}
+
+//
+// The ResolvedExpression for an AST node, from the resolution of its
+// enclosing module or (concrete) function.
+//
+static const ResolvedExpression* resolvedExprFor(Context* ctx,
+                                                 const ASTNode* ast) {
+  if (ast->isLoop() || ast->isBlock())
+    return nullptr;
+  if (ast->id().postOrderId() < 0)
+    return nullptr;
+
+  ID parentId = ast->id().parentSymbolId(ctx);
+  const ASTNode* parentAst = idToAst(ctx, parentId);
+  if (parentAst == nullptr)
+    return nullptr;
+
+  if (parentAst->isModule()) {
+    const auto& byId = resolveModule(ctx, parentAst->id());
+    return &byId.byAst(ast);
+  } else if (parentAst->isFunction()) {
+    auto untyped = untypedSignature(ctx, parentAst->id());
+    auto typed = typedSignatureInitial(ctx, untyped);
+    if (!typed->needsInstantiation) {
+      auto rFn = resolveFunction(ctx, typed, nullptr);
+      return &rFn->resolutionById.byAst(ast);
+    }
+  }
+
+  return nullptr;
+}
+
+static void hover(Context* ctx, const std::string& path, int line, int col) {
+  auto ustrPath = UniqueString::build(ctx, path);
+  const ModuleVec& mods = parse(ctx, ustrPath);
+
+  const ASTNode* found = nullptr;
+  for (const auto mod : mods) {
+    if ((found = findNodeAt(ctx, mod, line, col)) != nullptr)
+      break;
+  }
+
+  if (found == nullptr) {
+    printf("hover none\n");
+    return;
+  }
+
+  printf("hover %s", found->id().toString().c_str());
+  if (auto ident = found->toIdentifier()) {
+    printf(" name=%s", ident->name().c_str());
+  } else if (auto decl = found->toNamedDecl()) {
+    printf(" name=%s", decl->name().c_str());
+  }
+  if (const ResolvedExpression* r = resolvedExprFor(ctx, found)) {
+    printf(" %s", r->toString().c_str());
+  }
+  printf("\n");
+}
+
+static bool loadFromDisk(const std::string& path) {
+  std::ifstream in(path);
+  if (!in) {
+    printf("error cannot read %s\n", path.c_str());
+    return false;
+  }
+  std::stringstream contents;
+  contents << in.rdbuf();
+  gBuffers[path] = contents.str();
+  return true;
+}
+
+int main(int argc, char** argv) {
+  Context context;
+  Context* ctx = &context;
+
+  ctx->setErrorHandler(reportDiagnostic);
+
+  // files on the command line are loaded up front
+  for (int i = 1; i < argc; i++) {
+    loadFromDisk(argv[i]);
+  }
+  if (argc > 1) {
+    check(ctx, /* gc */ false);
+  }
+
+  std::string cmdLine;
+  while (std::getline(std::cin, cmdLine)) {
+    std::istringstream cmd(cmdLine);
+    std::string verb;
+    cmd >> verb;
+
+    if (verb == "load") {
+      std::string path;
+      cmd >> path;
+      if (loadFromDisk(path)) {
+        printf("loaded %s\n", path.c_str());
+      }
+    } else if (verb == "edit") {
+      std::string path;
+      size_t nBytes = 0;
+      cmd >> path >> nBytes;
+      std::string contents(nBytes, '\0');
+      std::cin.read(&contents[0], nBytes);
+      gBuffers[path] = contents;
+      printf("edited %s\n", path.c_str());
+    } else if (verb == "check") {
+      check(ctx, /* gc */ false);
+    } else if (verb == "gc") {
+      check(ctx, /* gc */ true);
+    } else if (verb == "hover") {
+      std::string path;
+      int line = 0, col = 0;
+      cmd >> path >> line >> col;
+      hover(ctx, path, line, col);
+    } else if (verb == "quit") {
+      break;
+    } else if (!verb.empty()) {
+      printf("error unknown command %s\n", verb.c_str());
+    }
+
+    fflush(stdout);
+  }
+
+  return 0;
+}
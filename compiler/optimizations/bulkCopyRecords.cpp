@@ -68,14 +68,63 @@ static bool typeContainsRef(Type* t, bool isRoot = true)
   return hasRef;
 }
 
+// Map each value type to its assignment function, so we can reason
+// about the assignments a record's fields would use.
+static std::map<Type*, FnSymbol*> assignForType;
+
+static std::map<Type*, bool> trivialAssign;
+
+/* Is assignment for this type equivalent to a bit copy?
+
+   POD types qualify directly.  Beyond those, a compiler-generated
+   record assignment is a memberwise copy, so if every field's own
+   assignment is also trivial, the whole assignment writes exactly the
+   bytes a bit copy would (padding aside, which doesn't matter).  This
+   lets records that miss POD-hood only because of, say, a custom
+   initializer or deinit still be copied in bulk, instead of falling
+   back to per-field moves.
+ */
+static bool typeHasTrivialAssign(Type* t)
+{
+  t = t->getValType();
+
+  if (trivialAssign.count(t))
+    return trivialAssign[t];
+
+  // Break cycles conservatively.
+  trivialAssign[t] = false;
+
+  bool retval = false;
+
+  if (isPOD(t)) {
+    retval = true;
+  } else if (AggregateType* at = toAggregateType(t)) {
+    if (at->isRecord()) {
+      FnSymbol* assign = assignForType[t];
+      if (assign != NULL && assign->hasFlag(FLAG_COMPILER_GENERATED)) {
+        retval = true;
+        for_fields(field, at) {
+          retval = retval && typeHasTrivialAssign(field->type);
+        }
+      }
+    }
+  }
+
+  trivialAssign[t] = retval;
+
+  return retval;
+}
+
 /* Find assignment functions that this optimization
    should replace with bit copies.
 
    This function returns true if all of these conditions are met:
     - fn is an assignment function
     - the lhs and rhs arguments have the same type
-    - the lhs and rhs arguments are POD types
     - the lhs and rhs arguments do not contain references
+    - assignment for the argument type amounts to a bit copy, either
+      because it is POD or because it is a compiler-generated
+      memberwise copy of fields whose assignments are all trivial
  */
 static bool isTrivialAssignment(FnSymbol* fn)
 {
@@ -100,9 +149,9 @@ static bool isTrivialAssignment(FnSymbol* fn)
   if (typeContainsRef(lhs->type) || typeContainsRef(rhs->type))
     return false;
 
-  // Both argument types must be POD types
-  // (but at this point they are the same type, so we only check one)
-  if (isPOD(argType))
+  // Assignment of the argument type must amount to a bit copy
+  // (but at this point both arguments are the same type, so we only check one)
+  if (typeHasTrivialAssign(argType))
     return true;
 
   return false;
@@ -127,6 +176,19 @@ static void replaceSimpleAssignment(FnSymbol* fn)
 
 void bulkCopyRecords()
 {
+  // Record each type's assignment function up front, so that
+  // typeHasTrivialAssign() can look up the assignments of field types.
+  forv_Vec(FnSymbol, fn, gFnSymbols)
+  {
+    if (isAssignment(fn) && ! fn->hasFlag(FLAG_WRAPPER)) {
+      ArgSymbol* lhs = fn->getFormal(1);
+      ArgSymbol* rhs = fn->getFormal(2);
+      Type* argType = lhs->type->getValType();
+      if (argType == rhs->type->getValType())
+        assignForType[argType] = fn;
+    }
+  }
+
   forv_Vec(FnSymbol, fn, gFnSymbols)
   {
     // We do not convert wrapper functions (only the functions that do the
@@ -139,4 +201,6 @@ void bulkCopyRecords()
   }
 
   containsRef.clear();
+  assignForType.clear();
+  trivialAssign.clear();
 }
@@ -101,10 +101,15 @@ void deadVariableElimination(FnSymbol* fn) {
   std::set<Symbol*> symSet;
   collectSymbolSet(fn, symSet);
 
-  // Use 'symSet' and 'todo' together for a unique queue of symbols to process
+  // Use 'symSet' and 'todo' together for a unique queue of symbols to process.
+  // Only VarSymbols are candidates, and a method must keep its _this symbol
+  // even if it is unused, so don't queue the rest at all; most of the
+  // collected symbols (formals, labels, called functions, ...) are skipped
+  // this way.
   std::queue<Symbol*> todo;
   for_set(Symbol, sym, symSet) {
-    todo.push(sym);
+    if (isVarSymbol(sym) && sym != fn->_this)
+      todo.push(sym);
   }
 
   while(todo.empty() == false) {
@@ -112,14 +117,6 @@ void deadVariableElimination(FnSymbol* fn) {
     todo.pop();
     symSet.erase(sym);
 
-    // We're interested only in VarSymbols.
-    if (!isVarSymbol(sym))
-      continue;
-
-    // A method must have a _this symbol, even if it is not used.
-    if (sym == fn->_this)
-      continue;
-
     if (isDeadVariable(sym)) {
       std::set<Symbol*> potentiallyChanged;
       for_SymbolDefs(se, sym) {
@@ -147,7 +144,9 @@ void deadVariableElimination(FnSymbol* fn) {
       // If we just removed a symbol, let's (re)visit the other symbols in
       // this statement in case they are now dead.
       for_set(Symbol, otherSym, potentiallyChanged) {
-        if (otherSym != sym && symSet.find(otherSym) == symSet.end()) {
+        if (otherSym != sym && isVarSymbol(otherSym) &&
+            otherSym != fn->_this &&
+            symSet.find(otherSym) == symSet.end()) {
           symSet.insert(otherSym);
           todo.push(otherSym);
         }
@@ -29,6 +29,7 @@
 #include "preFold.h"
 #include "forallOptimizations.h"
 #include "optimizations.h"
+#include "perfReport.h"
 #include "resolution.h"
 #include "stlUtil.h"
 #include "stringutil.h"
@@ -44,6 +45,16 @@
 // - automatic local access: Use `localAccess` instead of `this` for array
 //                           accesses that can be proven to be local
 //
+// - automatic bounds check elimination: the same domain analysis that proves
+//                                       locality also proves the access is
+//                                       in-bounds (the loop runs over the
+//                                       array's own domain), so confirmed
+//                                       accesses use a non-bounds-checked
+//                                       accessor; the residual cost is the
+//                                       single hoisted pre-loop domain
+//                                       comparison the dynamic check already
+//                                       performs
+//
 // - automatic aggregation: Use aggregation instead of regular assignments for
 //                          applicable last statements within `forall` bodies
 
@@ -138,8 +149,15 @@ static void removeAggregatorFromFunction(Symbol *aggregator, FnSymbol *parent);
 static void removeAggregationFromRecursiveForallHelp(BlockStmt *block);
 static void autoAggregation(ForallStmt *forall);
 
+// Bounds check elimination piggybacks on the auto-local-access domain
+// analysis, but only pays off when bounds checks are actually enabled.
+static bool usingBoundsCheckElim() {
+  return fAutoBoundsCheckElim && !fNoBoundsChecks;
+}
+
 void doPreNormalizeArrayOptimizations() {
   const bool anyAnalysisNeeded = fAutoLocalAccess ||
+                                 usingBoundsCheckElim() ||
                                  fAutoAggregation ||
                                  !fNoFastFollowers;
   if (anyAnalysisNeeded) {
@@ -148,7 +166,7 @@ void doPreNormalizeArrayOptimizations() {
         symbolicFastFollowerAnalysis(forall);
       }
 
-      if (fAutoLocalAccess) {
+      if (fAutoLocalAccess || usingBoundsCheckElim()) {
         autoLocalAccess(forall);
       }
 
@@ -222,7 +240,16 @@ Expr *preFoldMaybeLocalThis(CallExpr *call) {
     INT_FATAL("Misconfigured PRIM_MAYBE_LOCAL_THIS");
   }
 
-  if (fAutoLocalAccess) {
+  if (confirmed && fAutoLocalAccess) {
+    bool staticallyDetermined = false;
+    if (SymExpr* se = toSymExpr(call->get(call->argList.length)))
+      staticallyDetermined = (se->symbol() == gTrue);
+    perfReportOptimization(call, staticallyDetermined ?
+                                 "auto local access (static)" :
+                                 "auto local access (dynamic)");
+  }
+
+  if (fAutoLocalAccess || usingBoundsCheckElim()) {
     ret = confirmed ? confirmAccess(call) : revertAccess(call);
   }
   else {
@@ -1545,15 +1572,31 @@ static CallExpr *revertAccess(CallExpr *call) {
 }
 
 static CallExpr *confirmAccess(CallExpr *call) {
+  // The analysis proved the loop runs over the array's own domain
+  // (statically, or guarded by the hoisted pre-loop domain comparison),
+  // so the access is both local and in-bounds; use the cheapest
+  // accessor the enabled optimizations allow.
+  const char *accessorName = NULL;
+  if (fAutoLocalAccess && usingBoundsCheckElim()) {
+    accessorName = "localNoBoundsCheckAccess";
+  }
+  else if (fAutoLocalAccess) {
+    accessorName = "localAccess";
+  }
+  else {
+    accessorName = "noBoundsCheckAccess";
+  }
+
   if (toSymExpr(call->get(call->argList.length))->symbol() == gTrue) {
-    LOG_ALA(0, "Static check successful. Using localAccess", call,
+    LOG_ALA(0, astr("Static check successful. Using ", accessorName), call,
             /*forallDetails=*/true);
   }
   else {
-    LOG_ALA(0, "Static check successful. Using localAccess with dynamic check", call);
+    LOG_ALA(0, astr("Static check successful. Using ", accessorName,
+                    " with dynamic check"), call);
   }
 
-  CallExpr *repl = new CallExpr(new UnresolvedSymExpr("localAccess"),
+  CallExpr *repl = new CallExpr(new UnresolvedSymExpr(accessorName),
                                 gMethodToken);
 
   // Don't take the last two args; they are the static control symbol, and flag
@@ -2396,7 +2439,8 @@ static bool isLocalAccess(CallExpr *call) {
       if (SymExpr *secondArgSE = toSymExpr(baseCall->get(2))) {
         if (VarSymbol *secondArgSym = toVarSymbol(secondArgSE->symbol())) {
           if (Immediate *imm = secondArgSym->immediate) {
-            if(strcmp(imm->string_value(), "localAccess") == 0) {
+            if(strcmp(imm->string_value(), "localAccess") == 0 ||
+               strcmp(imm->string_value(), "localNoBoundsCheckAccess") == 0) {
               return true;
             }
           }
@@ -0,0 +1,351 @@
+/*
+ * Copyright 2020-2021 Hewlett Packard Enterprise Development LP
+ * Copyright 2004-2019 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// globalValueNumbering.cpp
+//
+// Eliminate redundant element address computations (PRIM_ARRAY_GET) within
+// a function.
+//
+// Multidimensional array indexing and repeated accesses to the same element
+// often leave several identical ('_array_get' base idx) computations in the
+// lowered AST.  Each one lands in its own single-use temp, so denormalize
+// folds each into its use site and the backend compiler cannot always prove
+// they are the same address (e.g. across calls, or when the base is a wide
+// pointer).
+//
+// This pass computes available expressions over the function's basic blocks
+// (a forward, intersecting dataflow problem, using the flow framework in
+// bb.cpp) and replaces each PRIM_ARRAY_GET whose value is already available
+// with a copy from a temp that holds the previously computed address.  Only
+// computations whose base and index operands cannot change between the two
+// occurrences are considered: operands must be immediates or non-reference
+// symbols local to the function whose addresses are never taken, so every
+// modification appears as a direct def and is visible to the kill sets.
+//
+// The pass runs after the other AST optimizations and just before
+// denormalize: the shared temps it introduces have multiple uses, so
+// denormalize leaves them as named locals in the generated code.
+
+#include "passes.h"
+
+#include "astutil.h"
+#include "bb.h"
+#include "bitVec.h"
+#include "driver.h"
+#include "expr.h"
+#include "stlUtil.h"
+#include "stmt.h"
+#include "symbol.h"
+
+#include <map>
+#include <set>
+#include <utility>
+#include <vector>
+
+// One candidate ('move' dst ('_array_get' base idx)) statement.
+typedef struct {
+  CallExpr* move;       // the whole move statement
+  SymExpr*  dst;        // destination of the move
+  size_t    key;        // index of the (base, idx) pair this computes
+  bool      redundant;  // is the value already available here?
+} ArrayGetOcc;
+
+// The (base, idx) operand pair identifying an address computation.
+typedef std::pair<Symbol*, Symbol*> ArrayGetKey;
+
+
+/*
+ * Can we rely on every change to this operand appearing as a direct def
+ * within the function?  If so, the kill sets below capture all the ways the
+ * computed address could change, and reusing it is sound.
+ */
+static bool isStableOperand(Symbol* sym,
+                            FnSymbol* fn,
+                            std::set<Symbol*>& addrTaken) {
+  if (VarSymbol* var = toVarSymbol(sym)) {
+    if (var->isImmediate() || var->isParameter())
+      return true;
+  }
+
+  if (sym->isRef() || sym->isWideRef())
+    return false;
+
+  if (sym->defPoint == NULL || sym->defPoint->parentSymbol != fn)
+    return false;
+
+  if (addrTaken.count(sym) != 0)
+    return false;
+
+  return true;
+}
+
+/*
+ * Collect the symbols in fn whose address is taken.  A def through such an
+ * address does not show up in the def map, so symbols in this set cannot be
+ * treated as stable operands.
+ */
+static void collectAddrTakenSymbols(FnSymbol* fn, std::set<Symbol*>& addrTaken)
+{
+  std::vector<SymExpr*> symExprs;
+
+  collectSymExprs(fn, symExprs);
+
+  for_vector(SymExpr, se, symExprs) {
+    if (CallExpr* call = toCallExpr(se->parentExpr)) {
+      if (call->isPrimitive(PRIM_ADDR_OF) ||
+          call->isPrimitive(PRIM_SET_REFERENCE)) {
+        addrTaken.insert(se->symbol());
+      }
+    }
+  }
+}
+
+static void freeBitVecs(std::vector<BitVec*>& vecs)
+{
+  for_vector(BitVec, vec, vecs)
+    delete vec;
+
+  vecs.clear();
+}
+
+/*
+ * Find the redundant PRIM_ARRAY_GET computations in fn and replace them with
+ * copies from shared temps.  Returns the number of computations eliminated.
+ */
+static size_t gvnFn(FnSymbol* fn)
+{
+  BasicBlock::buildBasicBlocks(fn);
+
+  std::set<Symbol*> addrTaken;
+
+  collectAddrTakenSymbols(fn, addrTaken);
+
+  // Gather the candidate statements, numbering each distinct (base, idx)
+  // operand pair, and remember which statement computes which pair.
+  std::map<ArrayGetKey, size_t>  keyIds;
+  std::map<Symbol*, std::vector<size_t> > keysUsing;
+  std::map<Expr*, size_t>        stmtComputes;
+  std::vector<ArrayGetOcc>       occs;
+
+  for_vector(BasicBlock, bb, *fn->basicBlocks) {
+    for_vector(Expr, stmt, bb->exprs) {
+      CallExpr* move = toCallExpr(stmt);
+
+      if (move == NULL || move->isPrimitive(PRIM_MOVE) == false)
+        continue;
+
+      SymExpr*  dst = toSymExpr(move->get(1));
+      CallExpr* src = toCallExpr(move->get(2));
+
+      if (dst == NULL || src == NULL ||
+          src->isPrimitive(PRIM_ARRAY_GET) == false)
+        continue;
+
+      SymExpr* base = toSymExpr(src->get(1));
+      SymExpr* idx  = toSymExpr(src->get(2));
+
+      if (base == NULL || idx == NULL)
+        continue;
+
+      if (isStableOperand(base->symbol(), fn, addrTaken) == false ||
+          isStableOperand(idx->symbol(),  fn, addrTaken) == false)
+        continue;
+
+      // The destination must be a local we can mirror into a shared temp.
+      if (isVarSymbol(dst->symbol()) == false ||
+          dst->symbol()->defPoint->parentSymbol != fn)
+        continue;
+
+      ArrayGetKey key(base->symbol(), idx->symbol());
+
+      if (keyIds.count(key) == 0) {
+        size_t id = keyIds.size();
+
+        keyIds[key] = id;
+        keysUsing[base->symbol()].push_back(id);
+        keysUsing[idx->symbol()].push_back(id);
+      }
+
+      ArrayGetOcc occ = { move, dst, keyIds[key], false };
+
+      stmtComputes[stmt] = occs.size();
+      occs.push_back(occ);
+    }
+  }
+
+  size_t nKeys = keyIds.size();
+
+  // No pair is computed twice, so there is nothing to reuse.
+  if (occs.size() <= nKeys)
+    return 0;
+
+  // Map each statement that defs an operand to the keys it invalidates.
+  Map<Symbol*, Vec<SymExpr*>*> defMap;
+  Map<Symbol*, Vec<SymExpr*>*> useMap;
+
+  buildDefUseMaps(fn, defMap, useMap);
+
+  std::map<Expr*, std::vector<size_t> > stmtKills;
+
+  for (std::map<Symbol*, std::vector<size_t> >::iterator it = keysUsing.begin();
+       it != keysUsing.end();
+       ++it) {
+    if (Vec<SymExpr*>* defs = defMap.get(it->first)) {
+      forv_Vec(SymExpr, def, *defs) {
+        if (Expr* stmt = def->getStmtExpr()) {
+          std::vector<size_t>& kills = stmtKills[stmt];
+
+          kills.insert(kills.end(), it->second.begin(), it->second.end());
+        }
+      }
+    }
+  }
+
+  // Set up the available-expressions dataflow problem.  GEN holds the pairs
+  // a block computes and does not subsequently invalidate; KILL holds the
+  // pairs whose operands the block defs.
+  size_t nbbs = fn->basicBlocks->size();
+
+  std::vector<BitVec*> GEN;
+  std::vector<BitVec*> KILL;
+  std::vector<BitVec*> IN;
+  std::vector<BitVec*> OUT;
+
+  for (size_t i = 0; i < nbbs; i++) {
+    GEN.push_back(new BitVec(nKeys));
+    KILL.push_back(new BitVec(nKeys));
+    IN.push_back(new BitVec(nKeys));
+    OUT.push_back(new BitVec(nKeys));
+  }
+
+  size_t i = 0;
+
+  for_vector(BasicBlock, bb, *fn->basicBlocks) {
+    for_vector(Expr, stmt, bb->exprs) {
+      if (stmtComputes.count(stmt) != 0)
+        GEN[i]->set(occs[stmtComputes[stmt]].key);
+
+      if (stmtKills.count(stmt) != 0) {
+        std::vector<size_t>& kills = stmtKills[stmt];
+
+        for (size_t k = 0; k < kills.size(); k++) {
+          GEN[i]->reset(kills[k]);
+          KILL[i]->set(kills[k]);
+        }
+      }
+    }
+
+    // Start blocks with predecessors from all ones, so the intersection
+    // converges from the optimistic side; entry (and any dead) blocks have
+    // nothing available.
+    if (bb->ins.size() > 0)
+      IN[i]->set();
+
+    i++;
+  }
+
+  BasicBlock::forwardFlowAnalysis(fn, GEN, KILL, IN, OUT, true);
+
+  // Walk each block again, tracking availability statement by statement, to
+  // decide which computations are redundant.
+  i = 0;
+
+  for_vector(BasicBlock, bb, *fn->basicBlocks) {
+    BitVec avail(nKeys);
+
+    avail.disjunction(*IN[i]);
+
+    for_vector(Expr, stmt, bb->exprs) {
+      if (stmtComputes.count(stmt) != 0) {
+        ArrayGetOcc& occ = occs[stmtComputes[stmt]];
+
+        occ.redundant = avail.test(occ.key);
+        avail.set(occ.key);
+      }
+
+      if (stmtKills.count(stmt) != 0) {
+        std::vector<size_t>& kills = stmtKills[stmt];
+
+        for (size_t k = 0; k < kills.size(); k++)
+          avail.reset(kills[k]);
+      }
+    }
+
+    i++;
+  }
+
+  // For each pair with a redundant computation, create a shared temp that
+  // every remaining computation copies its result into, and replace the
+  // redundant computations with reads of the temp.
+  std::map<size_t, VarSymbol*> sharedTemp;
+  size_t                       numEliminated = 0;
+
+  for (size_t oi = 0; oi < occs.size(); oi++) {
+    ArrayGetOcc& occ = occs[oi];
+
+    if (occ.redundant == false)
+      continue;
+
+    if (sharedTemp.count(occ.key) == 0) {
+      SET_LINENO(occ.move);
+
+      VarSymbol* temp = newTemp("gvn_elt_addr", occ.dst->symbol()->qualType());
+
+      fn->body->insertAtHead(new DefExpr(temp));
+
+      sharedTemp[occ.key] = temp;
+    }
+
+    SET_LINENO(occ.move);
+    occ.move->get(2)->replace(new SymExpr(sharedTemp[occ.key]));
+    numEliminated++;
+  }
+
+  for (size_t oi = 0; oi < occs.size(); oi++) {
+    ArrayGetOcc& occ = occs[oi];
+
+    if (occ.redundant || sharedTemp.count(occ.key) == 0)
+      continue;
+
+    SET_LINENO(occ.move);
+    occ.move->insertAfter(new CallExpr(PRIM_MOVE,
+                                       new SymExpr(sharedTemp[occ.key]),
+                                       new SymExpr(occ.dst->symbol())));
+  }
+
+  freeBitVecs(GEN);
+  freeBitVecs(KILL);
+  freeBitVecs(IN);
+  freeBitVecs(OUT);
+  freeDefUseMaps(defMap, useMap);
+
+  return numEliminated;
+}
+
+
+void globalValueNumbering()
+{
+  if (fNoGlobalValueNumbering)
+    return;
+
+  forv_Vec(FnSymbol, fn, gFnSymbols) {
+    gvnFn(fn);
+  }
+}
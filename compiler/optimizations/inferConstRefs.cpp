@@ -726,6 +726,27 @@ static bool inferRefToConst(Symbol* sym) {
   return isRefToConst;
 }
 
+//
+// Collect the SymExprs for 'sym' into a ConstInfo entry. Creates the
+// entry only if at least one SymExpr qualifies, like the gSymExprs scan
+// this replaced did.
+//
+static void gatherConstInfo(Symbol* sym) {
+  ConstInfo* info = NULL;
+
+  for_SymbolSymExprs(se, sym) {
+    // TODO: BHARSH: Skip classes for now. Not sure how to deal with aliasing
+    if (!se->isRef() && isClass(se->typeInfo())) continue;
+
+    if (info == NULL) {
+      info = new ConstInfo(sym);
+      infoMap[sym] = info;
+    }
+
+    info->todo.push_back(se);
+  }
+}
+
 //
 // For each VarSymbol and ArgSymbol, determine whether or not any of these
 // properties can be applied:
@@ -736,24 +757,14 @@ static bool inferRefToConst(Symbol* sym) {
 void inferConstRefs() {
   // Build a map from Symbols to ConstInfo. This is somewhat like
   // buildDefUseMaps, except we don't want to put defs and uses in different
-  // lists (for simplicity).
-  //
-  // TODO: Can we use for_SymbolSymExprs here instead?
-  forv_Vec(SymExpr, se, gSymExprs) {
-    if (!(isVarSymbol(se->symbol()) || isArgSymbol(se->symbol()))) continue;
-    // TODO: BHARSH: Skip classes for now. Not sure how to deal with aliasing
-    if (!se->isRef() && isClass(se->typeInfo())) continue;
-
-    ConstInfo* info = NULL;
-    ConstInfoIter it = infoMap.find(se->symbol());
-    if (it == infoMap.end()) {
-      info = new ConstInfo(se->symbol());
-      infoMap[se->symbol()] = info;
-    } else {
-      info = it->second;
-    }
-
-    info->todo.push_back(se);
+  // lists (for simplicity). The SymExpr list each Symbol already maintains
+  // gives us exactly that, so gather from it directly rather than scanning
+  // gSymExprs and looking each SymExpr's symbol up in the map.
+  forv_Vec(VarSymbol, var, gVarSymbols) {
+    gatherConstInfo(var);
+  }
+  forv_Vec(ArgSymbol, arg, gArgSymbols) {
+    gatherConstInfo(arg);
   }
 
   for (ConstInfoIter it = infoMap.begin(); it != infoMap.end(); ++it) {
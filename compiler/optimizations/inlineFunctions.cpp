@@ -65,10 +65,71 @@ void inlineFunctions() {
 *                                                                             *
 ************************************** | *************************************/
 
+// With --inline-small-functions, a leaf function whose body has at most
+// this many AST nodes is inlined as if the user had marked it inline.
+// Big enough for field/element accessors, small enough that code size
+// doesn't get away from us.
+static const size_t smallFnMaxSize = 40;
+
+//
+// Should --inline-small-functions treat 'fn' as if it were marked
+// inline?  Only small leaf functions qualify: a leaf cannot be part of
+// a recursive cycle, so the cycle errors in inlineBody can never fire
+// for one, and the cost of duplicating its body is bounded.
+//
+static bool shouldInlineSmallFunction(FnSymbol* fn) {
+  if (fn->hasFlag(FLAG_INLINE)  == true  ||
+      fn->hasFlag(FLAG_EXPORT)  == true  ||
+      fn->hasFlag(FLAG_EXTERN)  == true  ||
+      fn->hasFlag(FLAG_VIRTUAL) == true)
+    return false;
+
+  // Task functions must remain outlined for the tasking layer.
+  if (isTaskFun(fn)                                  == true ||
+      fn->hasFlag(FLAG_ON_BLOCK)                     == true ||
+      fn->hasFlag(FLAG_BEGIN_BLOCK)                  == true ||
+      fn->hasFlag(FLAG_COBEGIN_OR_COFORALL_BLOCK)    == true)
+    return false;
+
+  if (fn->calledBy == NULL || fn->calledBy->n == 0)
+    return false;
+
+  // The definition goes away after inlining, so every mention of the
+  // function must be a direct call; a name that escapes (e.g. into a
+  // first-class function value) keeps the function out.
+  for_SymbolSymExprs(se, fn) {
+    CallExpr* call = toCallExpr(se->parentExpr);
+
+    if (call == NULL || call->baseExpr != se)
+      return false;
+  }
+
+  std::vector<CallExpr*> calls;
+
+  collectFnCalls(fn, calls);
+
+  if (calls.size() > 0)
+    return false;
+
+  std::vector<BaseAST*> asts;
+
+  collect_asts(fn->body, asts);
+
+  return asts.size() <= smallFnMaxSize;
+}
+
 static void inlineFunctionsImpl() {
   if (fNoInline == false) {
     std::set<FnSymbol*> inlinedSet;
 
+    if (fInlineSmallFunctions == true) {
+      forv_Vec(FnSymbol, fn, gFnSymbols) {
+        if (shouldInlineSmallFunction(fn) == true) {
+          fn->addFlag(FLAG_INLINE);
+        }
+      }
+    }
+
     forv_Vec(FnSymbol, fn, gFnSymbols) {
       if (fn->hasFlag(FLAG_INLINE) == true &&
           inlinedSet.find(fn)      == inlinedSet.end()) {
@@ -0,0 +1,981 @@
+/*
+ * Copyright 2020-2021 Hewlett Packard Enterprise Development LP
+ * Copyright 2004-2019 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// loopFusion.cpp
+//
+// Fuse adjacent order-independent C-for loops that run over the same
+// iteration sequence.
+//
+// Chained whole-array statements such as
+//
+//   A = B + C;
+//   D = A * E;
+//
+// lower to separate foralls, and by this point in compilation each one is a
+// CForLoop that streams its arrays through memory once.  Fusing the bodies
+// halves the memory traffic on bandwidth-bound code and gives the backend a
+// larger window for scalar reuse (the store to A[i] forwards to the load in
+// the second body instead of round-tripping through the cache).
+//
+// The pass runs after loopInvariantCodeMotion -- whose computeNoAliasSets()
+// leaves PRIM_NO_ALIAS_SET / PRIM_COPIES_NO_ALIAS_SET calls in the AST that
+// we consult for array independence -- and before denormalize.
+//
+// Two adjacent loops are fused only when all of the following hold, bailing
+// out conservatively whenever a statement form is not recognized:
+//
+// * both loops are marked order independent, i.e. they were lowered from
+//   foralls (or loops proven order independent), so neither has a
+//   loop-carried dependence of its own;
+//
+// * their init/test/incr clauses are structurally identical, with the
+//   second loop's header-written symbols (index variable and temps) mapped
+//   onto the first's, so both loops produce the same index sequence;
+//
+// * neither body writes a symbol declared outside itself, all memory
+//   traffic is through recognized ('move' ref ('_array_get' base idx)) /
+//   PRIM_ASSIGN patterns, and for every pair of accesses from different
+//   bodies where one is a write, either the no-alias sets prove the arrays
+//   independent or both accesses are to the same array at exactly the loop
+//   index (a same-iteration dependence, which fusion preserves).
+//
+// The fused loop keeps the first loop's header and remains order
+// independent: cross-body dependences are same-iteration only, so distinct
+// iterations still touch disjoint data.
+//
+// After fusion (and on any other loop whose body the same classification
+// fully recognizes) we additionally forward stored element values to later
+// loads of the same element in the body, so a consumer fused behind its
+// producer reads the produced value from a scalar instead of reloading the
+// intermediate array.  Dead-code elimination then cleans up loads and
+// temporaries that lost their last use.
+
+#include "passes.h"
+
+#include "astutil.h"
+#include "CForLoop.h"
+#include "driver.h"
+#include "expr.h"
+#include "misc.h"
+#include "stlUtil.h"
+#include "stmt.h"
+#include "symbol.h"
+
+#include <map>
+#include <set>
+#include <utility>
+#include <vector>
+
+// One access to an array element: ('_array_get' base idx), read or written.
+typedef struct {
+  Symbol* base;
+  Symbol* idx;
+  bool    isWrite;
+} EltAccess;
+
+// A ref temp's provenance: ('move' ref ('_array_get' base idx)).
+typedef std::map<Symbol*, std::pair<Symbol*, Symbol*> > RefInfoMap;
+
+// What one loop body touches.  'ok' is false when the body contains a
+// statement the analysis does not recognize.
+typedef struct {
+  std::set<Symbol*>      privates;   // symbols declared inside the body
+  std::vector<EltAccess> accesses;   // element reads and writes
+  RefInfoMap             refs;       // element-ref provenance
+  bool                   ok;
+} BodySummary;
+
+// The no-alias facts computeNoAliasSets() recorded for one function.
+typedef struct {
+  std::map<Symbol*, Symbol*>             copyOf;  // sym -> its scope root
+  std::set<Symbol*>                      roots;   // syms with their own set
+  std::set<std::pair<Symbol*, Symbol*> > noAlias; // proven-independent roots
+} AliasInfo;
+
+
+static void buildAliasInfo(FnSymbol* fn, AliasInfo& info) {
+  std::vector<CallExpr*> calls;
+
+  collectCallExprs(fn, calls);
+
+  for_vector(CallExpr, call, calls) {
+    if (call->isPrimitive(PRIM_NO_ALIAS_SET)) {
+      Symbol* sym = toSymExpr(call->get(1))->symbol();
+
+      info.roots.insert(sym);
+
+      for (int i = 2; i <= call->numActuals(); i++) {
+        Symbol* other = toSymExpr(call->get(i))->symbol();
+
+        info.noAlias.insert(std::make_pair(sym,   other));
+        info.noAlias.insert(std::make_pair(other, sym));
+      }
+
+    } else if (call->isPrimitive(PRIM_COPIES_NO_ALIAS_SET)) {
+      Symbol* to   = toSymExpr(call->get(1))->symbol();
+      Symbol* from = toSymExpr(call->get(2))->symbol();
+
+      info.copyOf[to] = from;
+    }
+  }
+}
+
+// The alias-scope root for sym, or NULL if noAliasSets knows nothing.
+static Symbol* aliasRoot(const AliasInfo& info, Symbol* sym) {
+  std::map<Symbol*, Symbol*>::const_iterator it;
+
+  while ((it = info.copyOf.find(sym)) != info.copyOf.end())
+    sym = it->second;
+
+  return (info.roots.count(sym) != 0) ? sym : NULL;
+}
+
+static bool provedNoAlias(const AliasInfo& info, Symbol* b1, Symbol* b2) {
+  Symbol* r1 = aliasRoot(info, b1);
+  Symbol* r2 = aliasRoot(info, b2);
+
+  if (r1 == NULL || r2 == NULL || r1 == r2)
+    return false;
+
+  return info.noAlias.count(std::make_pair(r1, r2)) != 0;
+}
+
+// Do b1 and b2 certainly name the same array's data?
+static bool sameArray(const AliasInfo& info, Symbol* b1, Symbol* b2) {
+  if (b1 == b2)
+    return true;
+
+  Symbol* r1 = aliasRoot(info, b1);
+
+  return r1 != NULL && r1 == aliasRoot(info, b2);
+}
+
+
+static bool isInside(BaseAST* ast, Expr* scope) {
+  for (Expr* cur = toExpr(ast); cur != NULL; cur = cur->parentExpr)
+    if (cur == scope)
+      return true;
+
+  return false;
+}
+
+static bool allSymExprsInside(Symbol* sym, Expr* scope) {
+  for_SymbolSymExprs(se, sym) {
+    if (isInside(se, scope) == false)
+      return false;
+  }
+
+  return true;
+}
+
+
+/************************************* | **************************************
+*                                                                             *
+* Header comparison                                                           *
+*                                                                             *
+************************************** | *************************************/
+
+// Symbols a header clause writes: 'move'/PRIM_ASSIGN destinations and the
+// targets of op= primitives such as the index increment.
+static void collectClauseWrites(BlockStmt* clause, std::set<Symbol*>& writes) {
+  std::vector<CallExpr*> calls;
+
+  collectCallExprs(clause, calls);
+
+  for_vector(CallExpr, call, calls) {
+    if (call->isPrimitive(PRIM_MOVE)         ||
+        call->isPrimitive(PRIM_ASSIGN)       ||
+        call->isPrimitive(PRIM_ADD_ASSIGN)   ||
+        call->isPrimitive(PRIM_SUBTRACT_ASSIGN) ||
+        call->isPrimitive(PRIM_MULT_ASSIGN)  ||
+        call->isPrimitive(PRIM_DIV_ASSIGN)   ||
+        call->isPrimitive(PRIM_MOD_ASSIGN)   ||
+        call->isPrimitive(PRIM_LSH_ASSIGN)   ||
+        call->isPrimitive(PRIM_RSH_ASSIGN)) {
+      if (SymExpr* lhs = toSymExpr(call->get(1)))
+        writes.insert(lhs->symbol());
+    }
+  }
+}
+
+// Can sym2, written by loop2's header, stand in for sym1?  Its every
+// occurrence must be within loop2 -- loop2's header is deleted by fusion,
+// so nothing outside may observe sym2 -- and the types must agree.
+static bool isMappableHeaderSym(Symbol* sym1, Symbol* sym2, CForLoop* loop2) {
+  VarSymbol* var2 = toVarSymbol(sym2);
+
+  if (var2 == NULL || var2->isImmediate() || var2->isParameter())
+    return false;
+
+  if (sym2->isRef() || sym2->isWideRef())
+    return false;
+
+  if (sym1->type != sym2->type)
+    return false;
+
+  return allSymExprsInside(sym2, loop2);
+}
+
+// Structurally compare two header expressions, extending map with the
+// pairing sym2 -> sym1 for loop2's header-written symbols.  mappedTo keeps
+// the pairing injective.
+static bool headerExprsMatch(Expr*                      e1,
+                             Expr*                      e2,
+                             CForLoop*                  loop2,
+                             const std::set<Symbol*>&   writes2,
+                             std::map<Symbol*, Symbol*>& map,
+                             std::set<Symbol*>&         mappedTo) {
+  if (SymExpr* se1 = toSymExpr(e1)) {
+    SymExpr* se2 = toSymExpr(e2);
+
+    if (se2 == NULL)
+      return false;
+
+    Symbol* s1 = se1->symbol();
+    Symbol* s2 = se2->symbol();
+
+    if (s1 == s2)
+      return map.count(s2) == 0;
+
+    std::map<Symbol*, Symbol*>::iterator it = map.find(s2);
+
+    if (it != map.end())
+      return it->second == s1;
+
+    // Only symbols the second header itself produces may differ.
+    if (writes2.count(s2) == 0)
+      return false;
+
+    if (isMappableHeaderSym(s1, s2, loop2) == false)
+      return false;
+
+    if (mappedTo.count(s1) != 0)
+      return false;
+
+    map[s2] = s1;
+    mappedTo.insert(s1);
+
+    return true;
+  }
+
+  if (CallExpr* c1 = toCallExpr(e1)) {
+    CallExpr* c2 = toCallExpr(e2);
+
+    if (c2 == NULL)
+      return false;
+
+    if (c1->primitive != c2->primitive)
+      return false;
+
+    if (c1->primitive == NULL) {
+      // Calls in a lowered header should be primitives; don't try to
+      // reason about anything else.
+      return false;
+    }
+
+    if (c1->numActuals() != c2->numActuals())
+      return false;
+
+    for (int i = 1; i <= c1->numActuals(); i++)
+      if (headerExprsMatch(c1->get(i), c2->get(i), loop2,
+                           writes2, map, mappedTo) == false)
+        return false;
+
+    return true;
+  }
+
+  return false;
+}
+
+static bool headerClausesMatch(BlockStmt*                 b1,
+                               BlockStmt*                 b2,
+                               CForLoop*                  loop2,
+                               const std::set<Symbol*>&   writes2,
+                               std::map<Symbol*, Symbol*>& map,
+                               std::set<Symbol*>&         mappedTo) {
+  Expr* e1 = b1->body.head;
+  Expr* e2 = b2->body.head;
+
+  while (e1 != NULL && e2 != NULL) {
+    if (headerExprsMatch(e1, e2, loop2, writes2, map, mappedTo) == false)
+      return false;
+
+    e1 = e1->next;
+    e2 = e2->next;
+  }
+
+  return e1 == NULL && e2 == NULL;
+}
+
+
+/************************************* | **************************************
+*                                                                             *
+* Body analysis                                                               *
+*                                                                             *
+************************************** | *************************************/
+
+static bool isSafeValuePrim(CallExpr* call) {
+  return call->isPrimitive(PRIM_UNARY_MINUS)      ||
+         call->isPrimitive(PRIM_UNARY_PLUS)       ||
+         call->isPrimitive(PRIM_UNARY_NOT)        ||
+         call->isPrimitive(PRIM_UNARY_LNOT)       ||
+         call->isPrimitive(PRIM_ADD)              ||
+         call->isPrimitive(PRIM_SUBTRACT)         ||
+         call->isPrimitive(PRIM_MULT)             ||
+         call->isPrimitive(PRIM_DIV)              ||
+         call->isPrimitive(PRIM_MOD)              ||
+         call->isPrimitive(PRIM_LSH)              ||
+         call->isPrimitive(PRIM_RSH)              ||
+         call->isPrimitive(PRIM_EQUAL)            ||
+         call->isPrimitive(PRIM_NOTEQUAL)         ||
+         call->isPrimitive(PRIM_LESSOREQUAL)      ||
+         call->isPrimitive(PRIM_GREATEROREQUAL)   ||
+         call->isPrimitive(PRIM_LESS)             ||
+         call->isPrimitive(PRIM_GREATER)          ||
+         call->isPrimitive(PRIM_AND)              ||
+         call->isPrimitive(PRIM_OR)               ||
+         call->isPrimitive(PRIM_XOR)              ||
+         call->isPrimitive(PRIM_POW);
+}
+
+// Record a read or use of operand se.  Reads of element refs become element
+// accesses; reads of plain symbols need no record since bodies that write a
+// non-private symbol are rejected outright.
+static bool noteOperandRead(SymExpr*          se,
+                            const RefInfoMap& refInfo,
+                            BodySummary&      out) {
+  Symbol* sym = se->symbol();
+
+  if (sym->isRef() || sym->isWideRef()) {
+    RefInfoMap::const_iterator it = refInfo.find(sym);
+
+    if (it == refInfo.end())
+      return false;
+
+    EltAccess access = { it->second.first, it->second.second, false };
+
+    out.accesses.push_back(access);
+  }
+
+  return true;
+}
+
+/*
+ * Summarize what the body of 'loop' reads and writes.  Sets out.ok to false
+ * if the body contains gotos, calls to functions, or any statement shape the
+ * classification below does not recognize.
+ */
+static void summarizeBody(CForLoop* loop, BodySummary& out) {
+  out.ok = false;
+
+  std::vector<BaseAST*> asts;
+
+  for_alist(stmt, loop->body)
+    collect_asts(stmt, asts);
+
+  std::vector<CallExpr*> calls;
+
+  for_vector(BaseAST, ast, asts) {
+    if (isGotoStmt(ast))
+      return;
+
+    if (DefExpr* def = toDefExpr(ast))
+      out.privates.insert(def->sym);
+
+    if (CallExpr* call = toCallExpr(ast))
+      calls.push_back(call);
+  }
+
+  // First pass: the defining moves of element refs.
+  RefInfoMap& refInfo = out.refs;
+
+  for_vector(CallExpr, call, calls) {
+    if (call->isPrimitive(PRIM_MOVE) == false)
+      continue;
+
+    SymExpr* lhs = toSymExpr(call->get(1));
+
+    if (lhs == NULL || lhs->symbol()->isRef() == false)
+      continue;
+
+    CallExpr* rhs = toCallExpr(call->get(2));
+
+    if (rhs == NULL || rhs->isPrimitive(PRIM_ARRAY_GET) == false)
+      return;
+
+    SymExpr* base = toSymExpr(rhs->get(1));
+    SymExpr* idx  = toSymExpr(rhs->get(2));
+
+    if (base == NULL || idx == NULL ||
+        base->symbol()->isRef()     ||
+        base->symbol()->isWideRef() ||
+        idx->symbol()->isRef())
+      return;
+
+    // The ref must be per-iteration and single-def for its (base, idx) to
+    // describe every use.
+    if (out.privates.count(lhs->symbol()) == 0 ||
+        refInfo.count(lhs->symbol())      != 0)
+      return;
+
+    refInfo[lhs->symbol()] =
+      std::make_pair(base->symbol(), idx->symbol());
+  }
+
+  // Second pass: classify every statement-level call; approve the nested
+  // calls a classification accounts for and reject anything left over.
+  std::set<CallExpr*> approved;
+
+  for_vector(CallExpr, call, calls) {
+    if (isCallExpr(call->parentExpr))
+      continue;                       // handled with its parent
+
+    if (call->isPrimitive(PRIM_NOOP)) {
+      approved.insert(call);
+      continue;
+    }
+
+    bool isMove   = call->isPrimitive(PRIM_MOVE);
+    bool isAssign = call->isPrimitive(PRIM_ASSIGN);
+
+    if (isMove == false && isAssign == false)
+      return;
+
+    SymExpr* lhs = toSymExpr(call->get(1));
+
+    if (lhs == NULL)
+      return;
+
+    Symbol* lhsSym = lhs->symbol();
+    Expr*   rhs    = call->get(2);
+
+    if (lhsSym->isRef() || lhsSym->isWideRef()) {
+      if (isMove) {
+        // The defining move of an element ref, vetted above.
+        CallExpr* rhsCall = toCallExpr(rhs);
+
+        if (rhsCall == NULL ||
+            rhsCall->isPrimitive(PRIM_ARRAY_GET) == false ||
+            refInfo.count(lhsSym) == 0)
+          return;
+
+        approved.insert(call);
+        approved.insert(rhsCall);
+
+      } else {
+        // A store through an element ref.
+        RefInfoMap::iterator it = refInfo.find(lhsSym);
+        SymExpr*             src = toSymExpr(rhs);
+
+        if (it == refInfo.end() || src == NULL)
+          return;
+
+        EltAccess access = { it->second.first, it->second.second, true };
+
+        out.accesses.push_back(access);
+
+        if (noteOperandRead(src, refInfo, out) == false)
+          return;
+
+        approved.insert(call);
+      }
+
+      continue;
+    }
+
+    // Value destination: writing anything declared outside the body would
+    // be a cross-iteration (and cross-loop) hazard.
+    if (out.privates.count(lhsSym) == 0)
+      return;
+
+    if (SymExpr* src = toSymExpr(rhs)) {
+      if (noteOperandRead(src, refInfo, out) == false)
+        return;
+
+      approved.insert(call);
+
+    } else if (CallExpr* rhsCall = toCallExpr(rhs)) {
+      if (rhsCall->isPrimitive(PRIM_DEREF)) {
+        SymExpr* src = toSymExpr(rhsCall->get(1));
+
+        if (src == NULL || noteOperandRead(src, refInfo, out) == false)
+          return;
+
+      } else if (rhsCall->isPrimitive(PRIM_ARRAY_GET)) {
+        // An element load directly into a value temp.
+        SymExpr* base = toSymExpr(rhsCall->get(1));
+        SymExpr* idx  = toSymExpr(rhsCall->get(2));
+
+        if (base == NULL || idx == NULL ||
+            base->symbol()->isRef() || base->symbol()->isWideRef())
+          return;
+
+        EltAccess access = { base->symbol(), idx->symbol(), false };
+
+        out.accesses.push_back(access);
+
+      } else if (rhsCall->isPrimitive(PRIM_GET_MEMBER_VALUE)) {
+        // Reads a descriptor field; element stores cannot change it.
+        SymExpr* obj = toSymExpr(rhsCall->get(1));
+
+        if (obj == NULL || obj->symbol()->isRef())
+          return;
+
+      } else if (rhsCall->isPrimitive(PRIM_CAST)) {
+        SymExpr* src = toSymExpr(rhsCall->get(2));
+
+        if (src == NULL || noteOperandRead(src, refInfo, out) == false)
+          return;
+
+      } else if (isSafeValuePrim(rhsCall)) {
+        for_actuals(actual, rhsCall) {
+          SymExpr* src = toSymExpr(actual);
+
+          if (src == NULL || noteOperandRead(src, refInfo, out) == false)
+            return;
+        }
+
+      } else {
+        return;
+      }
+
+      approved.insert(call);
+      approved.insert(rhsCall);
+
+    } else {
+      return;
+    }
+  }
+
+  // Anything not accounted for above -- a call nested somewhere
+  // unexpected, a conditional on a call, etc. -- disqualifies the body.
+  for_vector(CallExpr, call, calls)
+    if (approved.count(call) == 0)
+      return;
+
+  out.ok = true;
+}
+
+
+/************************************* | **************************************
+*                                                                             *
+* Fusion legality and transformation                                          *
+*                                                                             *
+************************************** | *************************************/
+
+/*
+ * May loop2's body run interleaved, iteration by iteration, after loop1's?
+ * For every write in one body and access to potentially the same data in
+ * the other, either the arrays are proven independent or both accesses are
+ * to the same array at exactly the loop index, which makes the dependence
+ * same-iteration and therefore fusion-safe.
+ */
+static bool bodiesIndependent(const BodySummary&         sum1,
+                              const BodySummary&         sum2,
+                              Symbol*                    idx1,
+                              Symbol*                    idx2,
+                              const AliasInfo&           aliases) {
+  for (size_t i = 0; i < sum1.accesses.size(); i++) {
+    for (size_t j = 0; j < sum2.accesses.size(); j++) {
+      const EltAccess& a1 = sum1.accesses[i];
+      const EltAccess& a2 = sum2.accesses[j];
+
+      if (a1.isWrite == false && a2.isWrite == false)
+        continue;
+
+      if (provedNoAlias(aliases, a1.base, a2.base))
+        continue;
+
+      if (sameArray(aliases, a1.base, a2.base) &&
+          a1.idx == idx1 && a2.idx == idx2)
+        continue;
+
+      return false;
+    }
+  }
+
+  return true;
+}
+
+// The index variable: written by both the init and incr clauses.
+static Symbol* findIndexVar(CForLoop* loop) {
+  std::set<Symbol*> initWrites;
+  std::set<Symbol*> incrWrites;
+
+  collectClauseWrites(loop->initBlockGet(), initWrites);
+  collectClauseWrites(loop->incrBlockGet(), incrWrites);
+
+  Symbol* retval = NULL;
+
+  for (std::set<Symbol*>::iterator it = incrWrites.begin();
+       it != incrWrites.end();
+       ++it) {
+    if (initWrites.count(*it) != 0) {
+      if (retval != NULL)
+        return NULL;              // ambiguous; give up
+
+      retval = *it;
+    }
+  }
+
+  return retval;
+}
+
+// Drop a loop-control label that fusion has made unreferenced.
+static void removeDeadLabel(LabelSymbol* label) {
+  if (label == NULL || label->defPoint == NULL)
+    return;
+
+  for_SymbolSymExprs(se, label) {
+    if (se->inTree())
+      return;
+  }
+
+  if (label->defPoint->inTree())
+    label->defPoint->remove();
+}
+
+/*
+ * Fuse loop2 into loop1: retarget loop2's body to loop1's header symbols,
+ * append its statements to loop1's body, and remove loop2.
+ */
+static void fuseLoops(CForLoop*                         loop1,
+                      CForLoop*                         loop2,
+                      const std::map<Symbol*, Symbol*>& map) {
+  SET_LINENO(loop1);
+
+  for (std::map<Symbol*, Symbol*>::const_iterator it = map.begin();
+       it != map.end();
+       ++it) {
+    std::vector<SymExpr*> symExprs;
+
+    for_SymbolSymExprs(se, it->first)
+      symExprs.push_back(se);
+
+    for_vector(SymExpr, se, symExprs)
+      se->setSymbol(it->second);
+  }
+
+  std::vector<Expr*> stmts;
+
+  for_alist(stmt, loop2->body)
+    stmts.push_back(stmt);
+
+  for_vector(Expr, stmt, stmts) {
+    stmt->remove();
+
+    // The continue label is dead -- bodies with gotos are never fused.
+    if (DefExpr* def = toDefExpr(stmt))
+      if (isLabelSymbol(def->sym))
+        continue;
+
+    loop1->insertAtTail(stmt);
+  }
+
+  LabelSymbol* breakLabel = loop2->breakLabelGet();
+
+  loop2->remove();
+
+  removeDeadLabel(breakLabel);
+}
+
+/************************************* | **************************************
+*                                                                             *
+* Store-to-load forwarding                                                    *
+*                                                                             *
+************************************** | *************************************/
+
+// The value symbols known to sit in array elements at the current point of
+// the walk below: (base, idx) -> the symbol most recently stored there.
+typedef std::map<std::pair<Symbol*, Symbol*>, Symbol*> StoredValueMap;
+
+// 'sym' is being redefined; forget stores that recorded it as the stored
+// value or that named the element through it (as base or index).
+static void dropStoresOfValue(StoredValueMap& stored, Symbol* sym) {
+  for (StoredValueMap::iterator it = stored.begin(); it != stored.end(); ) {
+    if (it->second == sym || it->first.first == sym || it->first.second == sym)
+      stored.erase(it++);
+    else
+      ++it;
+  }
+}
+
+// A store to (base, idx) is about to happen; forget every entry it might
+// overwrite.  The (base, idx) element itself is re-recorded by the caller.
+static void dropStoresThatMayAlias(StoredValueMap& stored,
+                                   const AliasInfo& aliases,
+                                   Symbol*          base,
+                                   Symbol*          idx) {
+  for (StoredValueMap::iterator it = stored.begin(); it != stored.end(); ) {
+    Symbol* itsBase = it->first.first;
+    Symbol* itsIdx  = it->first.second;
+
+    if ((itsBase == base && itsIdx == idx) ||
+        provedNoAlias(aliases, itsBase, base))
+      ++it;
+    else
+      stored.erase(it++);
+  }
+}
+
+/*
+ * Forward stored element values to later loads of the same element within
+ * the body of 'loop'.  After fusion the producer's store to T[i] and the
+ * consumer's load of T[i] sit in the same body, so the load can read the
+ * stored symbol directly instead of round-tripping through the temporary
+ * array.  Runs only on bodies summarizeBody() fully recognizes; within
+ * those, every statement is a recognized move/assign, so walking them in
+ * order and invalidating on redefinitions and possibly-aliasing stores is
+ * a sound (if local) dataflow.  Returns the number of loads rewritten.
+ */
+static int forwardStoresInLoop(CForLoop* loop, const AliasInfo& aliases) {
+  BodySummary sum;
+
+  summarizeBody(loop, sum);
+
+  if (sum.ok == false)
+    return 0;
+
+  StoredValueMap stored;
+  int            nForwarded = 0;
+
+  for_alist(stmt, loop->body) {
+    CallExpr* call = toCallExpr(stmt);
+
+    if (call == NULL || call->isPrimitive(PRIM_NOOP))
+      continue;
+
+    SymExpr* lhs    = toSymExpr(call->get(1));
+    Symbol*  lhsSym = lhs->symbol();
+    Expr*    rhs    = call->get(2);
+
+    if (lhsSym->isRef() || lhsSym->isWideRef()) {
+      if (call->isPrimitive(PRIM_MOVE))
+        continue;                     // the defining move of an element ref
+
+      // A store through an element ref.
+      RefInfoMap::iterator it  = sum.refs.find(lhsSym);
+      SymExpr*             src = toSymExpr(rhs);
+
+      INT_ASSERT(it != sum.refs.end() && src != NULL);
+
+      Symbol* base = it->second.first;
+      Symbol* idx  = it->second.second;
+
+      dropStoresThatMayAlias(stored, aliases, base, idx);
+
+      std::pair<Symbol*, Symbol*> elt(base, idx);
+
+      if (src->symbol()->isRef())
+        stored.erase(elt);            // stored value not tracked by symbol
+      else
+        stored[elt] = src->symbol();
+
+      continue;
+    }
+
+    // A value definition.  Look the read side up before invalidating on
+    // the write side, since the statement reads before it writes.
+    if (CallExpr* rhsCall = toCallExpr(rhs)) {
+      if (rhsCall->isPrimitive(PRIM_ARRAY_GET)) {
+        Symbol* base = toSymExpr(rhsCall->get(1))->symbol();
+        Symbol* idx  = toSymExpr(rhsCall->get(2))->symbol();
+
+        StoredValueMap::iterator f =
+          stored.find(std::pair<Symbol*, Symbol*>(base, idx));
+
+        if (f != stored.end()) {
+          SET_LINENO(call);
+          rhsCall->replace(new SymExpr(f->second));
+          nForwarded++;
+        }
+
+      } else if (rhsCall->isPrimitive(PRIM_DEREF)) {
+        SymExpr* src = toSymExpr(rhsCall->get(1));
+
+        RefInfoMap::iterator it = sum.refs.find(src->symbol());
+
+        if (it != sum.refs.end()) {
+          StoredValueMap::iterator f = stored.find(it->second);
+
+          if (f != stored.end()) {
+            SET_LINENO(call);
+            rhsCall->replace(new SymExpr(f->second));
+            nForwarded++;
+          }
+        }
+      }
+    }
+
+    dropStoresOfValue(stored, lhsSym);
+  }
+
+  return nForwarded;
+}
+
+// The next statement after 'loop' that is not a plain declaration.
+// Declarations between two loops carry no code and can stay where they are.
+static Expr* nextStatement(Expr* expr) {
+  Expr* cur = expr->next;
+
+  while (cur != NULL) {
+    DefExpr* def = toDefExpr(cur);
+
+    if (def == NULL || def->init != NULL || def->exprType != NULL)
+      break;
+
+    cur = cur->next;
+  }
+
+  return cur;
+}
+
+/*
+ * Try to fuse the loop following loop1 into it.  Returns true on success,
+ * leaving loop1 as the fused loop so chains of three or more fusable loops
+ * collapse iteratively.
+ */
+static bool tryFuseWithNext(CForLoop* loop1, const AliasInfo& aliases) {
+  CForLoop* loop2 = toCForLoop(nextStatement(loop1));
+
+  if (loop2 == NULL)
+    return false;
+
+  if (loop1->isOrderIndependent() == false ||
+      loop2->isOrderIndependent() == false)
+    return false;
+
+  if (loop1->initBlockGet() == NULL || loop2->initBlockGet() == NULL)
+    return false;
+
+  std::set<Symbol*> writes1;
+  std::set<Symbol*> writes2;
+
+  collectClauseWrites(loop1->initBlockGet(), writes1);
+  collectClauseWrites(loop1->testBlockGet(), writes1);
+  collectClauseWrites(loop1->incrBlockGet(), writes1);
+
+  collectClauseWrites(loop2->initBlockGet(), writes2);
+  collectClauseWrites(loop2->testBlockGet(), writes2);
+  collectClauseWrites(loop2->incrBlockGet(), writes2);
+
+  // Shared header state would make the headers interfere.
+  for (std::set<Symbol*>::iterator it = writes1.begin();
+       it != writes1.end();
+       ++it)
+    if (writes2.count(*it) != 0)
+      return false;
+
+  std::map<Symbol*, Symbol*> map;
+  std::set<Symbol*>          mappedTo;
+
+  if (headerClausesMatch(loop1->initBlockGet(), loop2->initBlockGet(),
+                         loop2, writes2, map, mappedTo) == false ||
+      headerClausesMatch(loop1->testBlockGet(), loop2->testBlockGet(),
+                         loop2, writes2, map, mappedTo) == false ||
+      headerClausesMatch(loop1->incrBlockGet(), loop2->incrBlockGet(),
+                         loop2, writes2, map, mappedTo) == false)
+    return false;
+
+  Symbol* idx1 = findIndexVar(loop1);
+  Symbol* idx2 = findIndexVar(loop2);
+
+  if (idx1 == NULL || idx2 == NULL)
+    return false;
+
+  std::map<Symbol*, Symbol*>::iterator idxPair = map.find(idx2);
+
+  if (idxPair == map.end() || idxPair->second != idx1)
+    return false;
+
+  BodySummary sum1;
+  BodySummary sum2;
+
+  summarizeBody(loop1, sum1);
+
+  if (sum1.ok == false)
+    return false;
+
+  summarizeBody(loop2, sum2);
+
+  if (sum2.ok == false)
+    return false;
+
+  // The index variables may not be modified behind the headers' backs.
+  if (sum1.privates.count(idx1) != 0 || sum2.privates.count(idx2) != 0)
+    return false;
+
+  if (bodiesIndependent(sum1, sum2, idx1, idx2, aliases) == false)
+    return false;
+
+  if (fReportLoopFusion) {
+    FnSymbol* fn = loop1->getFunction();
+
+    printf("loopFusion: fused loop at %s:%d into loop at %s:%d (in %s)\n",
+           cleanFilename(loop2), loop2->linenum(),
+           cleanFilename(loop1), loop1->linenum(),
+           fn->name);
+  }
+
+  fuseLoops(loop1, loop2, map);
+
+  return true;
+}
+
+
+void loopFusion() {
+  if (fLoopFusion == false)
+    return;
+
+  forv_Vec(FnSymbol, fn, gFnSymbols) {
+    std::vector<BaseAST*> asts;
+
+    collect_asts(fn, asts);
+
+    std::vector<CForLoop*> loops;
+
+    for_vector(BaseAST, ast, asts)
+      if (CForLoop* loop = toCForLoop(ast))
+        loops.push_back(loop);
+
+    if (loops.size() < 2)
+      continue;
+
+    AliasInfo aliases;
+
+    buildAliasInfo(fn, aliases);
+
+    for_vector(CForLoop, loop, loops) {
+      if (loop->inTree() == false)
+        continue;                   // already fused away
+
+      while (tryFuseWithNext(loop, aliases) == true)
+        ;
+
+      int nForwarded = forwardStoresInLoop(loop, aliases);
+
+      if (nForwarded > 0 && fReportLoopFusion)
+        printf("loopFusion: forwarded %d element load%s in loop at %s:%d "
+               "(in %s)\n",
+               nForwarded, (nForwarded == 1) ? "" : "s",
+               cleanFilename(loop), loop->linenum(), fn->name);
+    }
+  }
+}
@@ -0,0 +1,543 @@
+/*
+ * Copyright 2020-2021 Hewlett Packard Enterprise Development LP
+ * Copyright 2004-2019 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// loopTiling.cpp
+//
+// Cache-tile two-deep nests of C-for loops lowered from foralls.
+//
+// A stencil such as
+//
+//   forall (i, j) in D do
+//     A[i, j] = (B[i-1, j] + B[i+1, j] + B[i, j-1] + B[i, j+1]) / 4;
+//
+// lowers to a nest whose inner loop streams whole rows of B through the
+// cache, so the reuse between row i and row i+1 is gone by the time the
+// outer loop comes back for it.  Tiling strip-mines the inner loop and
+// hoists the strip loop above the outer one:
+//
+//   for (jj = lo; jj <= hi; jj += T)
+//     for (i ...)
+//       for (j = jj; j <= min(jj + T - 1, hi); j += 1)
+//         ...
+//
+// so each outer sweep touches only a T-element band and the row-to-row
+// reuse is live when it is needed.
+//
+// Every (i, j) body instance still executes exactly once; only the order
+// changes, and within any fixed i the j's still ascend.  So the transform
+// is legal whenever reordering outer iterations is, i.e. when the outer
+// loop is marked order independent.  What does need care is everything
+// that executes more often afterward -- the inner loop's header and the
+// outer body's statements around the inner loop now run once per (strip,
+// i) instead of once per i -- so the pass recognizes a nest only when,
+// conservatively:
+//
+// * the outer loop is order independent and contains no gotos;
+//
+// * the inner loop's header has the canonical shape direct range
+//   iteration leaves behind -- init 'move'(j, lo), test j < hi or
+//   j <= hi, increment by literal 1 -- with 'lo' and 'hi' defined
+//   outside the outer loop and written nowhere inside it;
+//
+// * the statements around the inner loop are only DefExprs and 'move's
+//   that write symbols local to the outer body, with side-effect-free
+//   primitive right-hand sides (index temps, getValue field reads, and
+//   loop-control labels all qualify; anything else bails out).
+//
+// The strip size comes from --loop-tile-size, or by default is derived
+// from the compiling host's L2 cache on the usual assumption that host
+// and target match: half the cache, 8-byte elements, two streams.
+//
+// The pass runs right after loopFusion, so fused stencil statements are
+// tiled as one nest.  Off by default; enable with --loop-tiling and
+// inspect decisions with --report-loop-tiling.
+
+#include "passes.h"
+
+#include "astutil.h"
+#include "CForLoop.h"
+#include "driver.h"
+#include "expr.h"
+#include "misc.h"
+#include "stlUtil.h"
+#include "stmt.h"
+#include "symbol.h"
+
+#include <cinttypes>
+#include <set>
+#include <vector>
+
+#include <unistd.h>
+
+// The recognized canonical inner-loop header:
+//   init:  ('move' j lo)
+//   test:  ('<' j hi) or ('<=' j hi), possibly through a bool temp
+//   incr:  ('+=' j 1) or ('move' j ('+' j 1))
+typedef struct {
+  Symbol*   idx;        // j
+  Symbol*   lo;         // initial value
+  SymExpr*  limit;      // the hi operand inside the test comparison
+  bool      inclusive;  // test is <= rather than <
+} InnerHeader;
+
+
+// The strip size, in iterations of the inner loop.
+static int64_t tileSize() {
+  static int64_t size = 0;
+
+  if (size == 0) {
+    if (fLoopTileSize > 0) {
+      size = fLoopTileSize;
+    } else {
+      long cacheBytes = 0;
+
+#ifdef _SC_LEVEL2_CACHE_SIZE
+      cacheBytes = sysconf(_SC_LEVEL2_CACHE_SIZE);
+#endif
+
+      if (cacheBytes <= 0)
+        cacheBytes = 256 * 1024;
+
+      // Half the cache for the tiled band, 8-byte elements, and assume
+      // the body streams a second array alongside the reused one.
+      size = cacheBytes / (2 * 8 * 2);
+    }
+
+    if (size < 2)
+      size = 2;
+  }
+
+  return size;
+}
+
+// An integral literal of idx's type, so the strip arithmetic stays in the
+// index's own type.  NULL if the type is not a plain int/uint.
+static Symbol* intLiteral(int64_t v, Type* t) {
+  IF1_int_type size;
+
+  switch (get_width(t)) {
+  case  8: size = INT_SIZE_8;  break;
+  case 16: size = INT_SIZE_16; break;
+  case 32: size = INT_SIZE_32; break;
+  case 64: size = INT_SIZE_64; break;
+  default: return NULL;
+  }
+
+  if (is_int_type(t))
+    return new_IntSymbol(v, size);
+
+  if (is_uint_type(t))
+    return new_UIntSymbol(v, size);
+
+  return NULL;
+}
+
+// Symbols written by assignment primitives anywhere under ast.
+static void collectWrites(BaseAST* ast, std::set<Symbol*>& writes) {
+  std::vector<CallExpr*> calls;
+
+  collectCallExprs(ast, calls);
+
+  for_vector(CallExpr, call, calls) {
+    if (call->isPrimitive(PRIM_MOVE)            ||
+        call->isPrimitive(PRIM_ASSIGN)          ||
+        call->isPrimitive(PRIM_ADD_ASSIGN)      ||
+        call->isPrimitive(PRIM_SUBTRACT_ASSIGN) ||
+        call->isPrimitive(PRIM_MULT_ASSIGN)     ||
+        call->isPrimitive(PRIM_DIV_ASSIGN)      ||
+        call->isPrimitive(PRIM_MOD_ASSIGN)      ||
+        call->isPrimitive(PRIM_LSH_ASSIGN)      ||
+        call->isPrimitive(PRIM_RSH_ASSIGN)) {
+      if (SymExpr* lhs = toSymExpr(call->get(1)))
+        writes.insert(lhs->symbol());
+    }
+  }
+}
+
+// The sole statement of a one-statement clause, or NULL.
+static Expr* soleStmt(BlockStmt* clause) {
+  if (clause == NULL || clause->body.length != 1)
+    return NULL;
+
+  return clause->body.head;
+}
+
+static bool parseInnerHeader(CForLoop* loop, InnerHeader& hdr) {
+  // init: ('move' j lo)
+  CallExpr* init = toCallExpr(soleStmt(loop->initBlockGet()));
+
+  if (init == NULL ||
+      (init->isPrimitive(PRIM_MOVE) == false &&
+       init->isPrimitive(PRIM_ASSIGN) == false))
+    return false;
+
+  SymExpr* idxSe = toSymExpr(init->get(1));
+  SymExpr* loSe  = toSymExpr(init->get(2));
+
+  if (idxSe == NULL || loSe == NULL)
+    return false;
+
+  Symbol* idx = idxSe->symbol();
+
+  if (idx->isRef() == true ||
+      (is_int_type(idx->type) == false && is_uint_type(idx->type) == false))
+    return false;
+
+  // incr: ('+=' j 1) or ('move' j ('+' j 1))
+  CallExpr* incr = toCallExpr(soleStmt(loop->incrBlockGet()));
+  int64_t   step = 0;
+
+  if (incr == NULL)
+    return false;
+
+  if (incr->isPrimitive(PRIM_ADD_ASSIGN) == true) {
+    if (toSymExpr(incr->get(1)) == NULL               ||
+        toSymExpr(incr->get(1))->symbol() != idx      ||
+        get_int(incr->get(2), &step) == false)
+      return false;
+
+  } else if (incr->isPrimitive(PRIM_MOVE) == true ||
+             incr->isPrimitive(PRIM_ASSIGN) == true) {
+    CallExpr* add = toCallExpr(incr->get(2));
+
+    if (toSymExpr(incr->get(1)) == NULL          ||
+        toSymExpr(incr->get(1))->symbol() != idx ||
+        add == NULL                              ||
+        add->isPrimitive(PRIM_ADD) == false      ||
+        toSymExpr(add->get(1)) == NULL           ||
+        toSymExpr(add->get(1))->symbol() != idx  ||
+        get_int(add->get(2), &step) == false)
+      return false;
+
+  } else {
+    return false;
+  }
+
+  if (step != 1)
+    return false;
+
+  // test: ('<' j hi) / ('<=' j hi), directly or through a bool temp
+  BlockStmt* testBlock = loop->testBlockGet();
+  CallExpr*  cmp       = NULL;
+
+  if (testBlock == NULL) {
+    return false;
+
+  } else if (testBlock->body.length == 1) {
+    cmp = toCallExpr(testBlock->body.head);
+
+  } else if (testBlock->body.length == 2) {
+    CallExpr* move = toCallExpr(testBlock->body.head);
+    SymExpr*  cond = toSymExpr(testBlock->body.tail);
+
+    if (move == NULL || cond == NULL         ||
+        move->isPrimitive(PRIM_MOVE) == false ||
+        toSymExpr(move->get(1)) == NULL      ||
+        toSymExpr(move->get(1))->symbol() != cond->symbol())
+      return false;
+
+    cmp = toCallExpr(move->get(2));
+
+  } else {
+    return false;
+  }
+
+  if (cmp == NULL ||
+      (cmp->isPrimitive(PRIM_LESS) == false &&
+       cmp->isPrimitive(PRIM_LESSOREQUAL) == false))
+    return false;
+
+  SymExpr* cmpIdx = toSymExpr(cmp->get(1));
+  SymExpr* limit  = toSymExpr(cmp->get(2));
+
+  if (cmpIdx == NULL || limit == NULL || cmpIdx->symbol() != idx)
+    return false;
+
+  hdr.idx       = idx;
+  hdr.lo        = loSe->symbol();
+  hdr.limit     = limit;
+  hdr.inclusive = cmp->isPrimitive(PRIM_LESSOREQUAL);
+
+  return true;
+}
+
+// Is ast (a defPoint, typically) contained within scope?
+static bool isWithin(Expr* ast, Expr* scope) {
+  for (Expr* p = ast; p != NULL; p = p->parentExpr)
+    if (p == scope)
+      return true;
+
+  return false;
+}
+
+// A header operand we will read once per strip, outside the outer loop:
+// an immediate, or a non-ref symbol defined outside the loop and written
+// nowhere inside it.
+static bool isStripInvariant(Symbol*                  sym,
+                             CForLoop*                outer,
+                             const std::set<Symbol*>& outerWrites) {
+  if (VarSymbol* var = toVarSymbol(sym))
+    if (var->immediate != NULL)
+      return true;
+
+  if (sym->isRef() == true)
+    return false;
+
+  if (sym->defPoint == NULL || isWithin(sym->defPoint, outer) == true)
+    return false;
+
+  return outerWrites.count(sym) == 0;
+}
+
+// May stmt run once per (strip, outer-iteration) instead of once per
+// outer iteration?  Yes for DefExprs and for 'move's that write a symbol
+// declared in the outer body through side-effect-free primitives only.
+static bool isRepeatableStmt(Expr* stmt, const std::set<Symbol*>& privates) {
+  if (isDefExpr(stmt) == true)
+    return true;
+
+  CallExpr* call = toCallExpr(stmt);
+
+  if (call == NULL || call->isPrimitive(PRIM_MOVE) == false)
+    return false;
+
+  SymExpr* lhs = toSymExpr(call->get(1));
+
+  if (lhs == NULL || privates.count(lhs->symbol()) == 0)
+    return false;
+
+  std::vector<CallExpr*> calls;
+
+  collectCallExprs(call->get(2), calls);
+
+  for_vector(CallExpr, sub, calls) {
+    if (sub->primitive == NULL || sub->primitive->isEssential == true)
+      return false;
+  }
+
+  return true;
+}
+
+// The single CForLoop directly in the body of loop, provided every other
+// top-level statement is repeatable; NULL otherwise.
+static CForLoop* findSoleNestedLoop(CForLoop* outer) {
+  std::set<Symbol*> privates;
+
+  for_alist(stmt, outer->body)
+    if (DefExpr* def = toDefExpr(stmt))
+      privates.insert(def->sym);
+
+  CForLoop* inner = NULL;
+
+  for_alist(stmt, outer->body) {
+    if (CForLoop* loop = toCForLoop(stmt)) {
+      if (inner != NULL)
+        return NULL;              // two loops side by side
+
+      inner = loop;
+
+    } else if (isRepeatableStmt(stmt, privates) == false) {
+      return NULL;
+    }
+  }
+
+  return inner;
+}
+
+/*
+ * Tile the nest: strip-mine inner and hoist the strip loop above outer.
+ * The strip loop is a gutted copy of inner, so it inherits inner's flags
+ * and its header already has the right shape -- only the symbols change.
+ */
+static void tileNest(CForLoop*          outer,
+                     CForLoop*          inner,
+                     const InnerHeader& hdr,
+                     int64_t            size) {
+  SET_LINENO(outer);
+
+  Type*      idxType = hdr.idx->type;
+  VarSymbol* stripLo = newTemp("tile_strip_lo", idxType);
+  VarSymbol* stripHi = newTemp("tile_strip_hi", idxType);
+  VarSymbol* clampTo = newTemp("tile_clamp", dtBool);
+
+  Symbol* stepImm = intLiteral(size, idxType);
+  Symbol* spanImm = intLiteral(hdr.inclusive ? size - 1 : size, idxType);
+
+  CForLoop* strip = inner->copy();
+
+  // Gut the copied body; only the header shape is wanted.
+  {
+    std::vector<Expr*> stmts;
+
+    for_alist(stmt, strip->body)
+      stmts.push_back(stmt);
+
+    for_vector(Expr, stmt, stmts)
+      stmt->remove();
+  }
+
+  // The strip loop runs the same range, by strides of the tile size.
+  {
+    std::vector<SymExpr*> symExprs;
+
+    collectSymExprs(strip->initBlockGet(), symExprs);
+    collectSymExprs(strip->testBlockGet(), symExprs);
+
+    for_vector(SymExpr, se, symExprs)
+      if (se->symbol() == hdr.idx)
+        se->setSymbol(stripLo);
+  }
+
+  {
+    std::vector<Expr*> stmts;
+
+    for_alist(stmt, strip->incrBlockGet()->body)
+      stmts.push_back(stmt);
+
+    for_vector(Expr, stmt, stmts)
+      stmt->remove();
+
+    strip->incrBlockGet()->insertAtTail(new CallExpr(PRIM_ADD_ASSIGN,
+                                                     stripLo, stepImm));
+  }
+
+  outer->insertBefore(new DefExpr(stripLo));
+  outer->insertBefore(new DefExpr(stripHi));
+  outer->insertBefore(new DefExpr(clampTo));
+  outer->insertBefore(strip);
+
+  // stripHi = min(stripLo + span, hi), in the strip loop's body.
+  strip->insertAtTail(new CallExpr(PRIM_MOVE, stripHi,
+                                   new CallExpr(PRIM_ADD,
+                                                stripLo, spanImm)));
+  strip->insertAtTail(new CallExpr(PRIM_MOVE, clampTo,
+                                   new CallExpr(PRIM_LESS,
+                                                hdr.limit->symbol(),
+                                                stripHi)));
+  strip->insertAtTail(new CondStmt(new SymExpr(clampTo),
+                                   new CallExpr(PRIM_MOVE, stripHi,
+                                                hdr.limit->symbol())));
+  strip->insertAtTail(outer->remove());
+
+  // The inner loop now covers just the strip.
+  {
+    CallExpr* init = toCallExpr(soleStmt(inner->initBlockGet()));
+
+    init->get(2)->replace(new SymExpr(stripLo));
+
+    hdr.limit->setSymbol(stripHi);
+  }
+}
+
+// Tile outer's nest if the whole pattern is recognized; report either way
+// when asked to.
+static bool tryTileLoop(CForLoop* outer, FnSymbol* fn) {
+  if (outer->isOrderIndependent() == false)
+    return false;
+
+  CForLoop* inner = findSoleNestedLoop(outer);
+
+  if (inner == NULL)
+    return false;
+
+  InnerHeader hdr;
+
+  if (parseInnerHeader(inner, hdr) == false)
+    return false;
+
+  if (hdr.idx->defPoint == NULL ||
+      isWithin(hdr.idx->defPoint, inner) == true)
+    return false;
+
+  // Gotos would jump between strips; bail on any.
+  {
+    std::vector<GotoStmt*> gotos;
+
+    collectGotoStmts(outer, gotos);
+
+    if (gotos.size() != 0)
+      return false;
+  }
+
+  // 'lo' and 'hi' are read once per strip, above the outer loop.
+  {
+    std::set<Symbol*> outerWrites;
+
+    collectWrites(outer, outerWrites);
+
+    if (isStripInvariant(hdr.lo,              outer, outerWrites) == false ||
+        isStripInvariant(hdr.limit->symbol(), outer, outerWrites) == false)
+      return false;
+  }
+
+  // Only the inner header may write the index: a body that steers its own
+  // index would resume each strip in the wrong place.
+  {
+    std::set<Symbol*> writes;
+
+    for_alist(stmt, outer->body)
+      if (stmt != inner)
+        collectWrites(stmt, writes);
+
+    for_alist(stmt, inner->body)
+      collectWrites(stmt, writes);
+
+    if (writes.count(hdr.idx) != 0)
+      return false;
+  }
+
+  int64_t size = tileSize();
+
+  if (intLiteral(size, hdr.idx->type) == NULL)
+    return false;
+
+  tileNest(outer, inner, hdr, size);
+
+  if (fReportLoopTiling)
+    printf("loopTiling: tiled %" PRId64 "-element strips into loop nest "
+           "at %s:%d (in %s)\n",
+           size, cleanFilename(outer), outer->linenum(), fn->name);
+
+  return true;
+}
+
+void loopTiling() {
+  if (fLoopTiling == false)
+    return;
+
+  forv_Vec(FnSymbol, fn, gFnSymbols) {
+    std::vector<BaseAST*> asts;
+
+    collect_asts(fn, asts);
+
+    std::vector<CForLoop*> loops;
+
+    for_vector(BaseAST, ast, asts)
+      if (CForLoop* loop = toCForLoop(ast))
+        loops.push_back(loop);
+
+    for_vector(CForLoop, loop, loops) {
+      if (loop->inTree() == false)
+        continue;
+
+      tryTileLoop(loop, fn);
+    }
+  }
+}
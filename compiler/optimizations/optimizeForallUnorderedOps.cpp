@@ -28,6 +28,7 @@
 #include "optimizations.h"
 #include "passes.h"
 #include "forallOptimizations.h"
+#include "perfReport.h"
 #include "resolution.h"
 #include "stlUtil.h"
 #include "stmt.h"
@@ -36,6 +37,8 @@
 #include "virtualDispatch.h"
 #include "wellknown.h"
 
+#include <algorithm>
+#include <set>
 #include <stack>
 
 /*
@@ -180,6 +183,55 @@ static void helpGetLastStmts(Expr* last, std::vector<Expr*>& stmts) {
   stmts.push_back(last);
 }
 
+// ---- trailing independent updates
+//
+// The last statement is not the only candidate: a loop body may end in a
+// run of updates that touch unrelated memory (e.g. several scatter
+// updates into different arrays). Any member of such a run may complete
+// in any order, provided that no statement after it in the iteration
+// reads or writes what it touches. These helpers support walking such a
+// run backward from the last statement, in both the early marking phase
+// and the late transformation.
+
+static void gatherUpdateSymbols(Expr* stmt, std::set<Symbol*>& syms) {
+  std::vector<SymExpr*> symExprs;
+  collectSymExprs(stmt, symExprs);
+  for_vector(SymExpr, se, symExprs) {
+    if (isFnSymbol(se->symbol()) == false)
+      syms.insert(se->symbol());
+  }
+}
+
+// Returns true if 'stmt' shares no symbols with the (already gathered)
+// statements that run after it, i.e. reordering its completion past them
+// cannot be observed within the iteration.
+static bool updateIsIndependent(Expr* stmt,
+                                const std::set<Symbol*>& laterSyms) {
+  std::vector<SymExpr*> symExprs;
+  collectSymExprs(stmt, symExprs);
+  for_vector(SymExpr, se, symExprs) {
+    if (isFnSymbol(se->symbol()) == false &&
+        laterSyms.count(se->symbol()) != 0)
+      return false;
+  }
+  return true;
+}
+
+// For a guarded update, returns the only real statement in a conditional
+// branch (tolerating compiler-added fences and optimization-info
+// markers), or NULL if the branch holds anything else.
+static Expr* soleUpdateInBranch(BlockStmt* branch) {
+  if (branch == NULL)
+    return NULL;
+
+  Expr* last = skipIgnoredStmts(branch->body.last());
+
+  if (last != NULL && skipIgnoredStmts(last->prev) == NULL)
+    return last;
+
+  return NULL;
+}
+
 std::vector<Expr *> getLastStmtsForForallUnorderedOps(ForallStmt *forall) {
   std::vector<Expr *> lastStmts;
   for_vector(BlockStmt, block, forall->loopBodies()) {
@@ -270,6 +322,91 @@ static bool forallNoTaskPrivate(ForallStmt* forall) {
   return true;
 }
 
+// Marks one trailing update with the same optimization info the last
+// statement receives, attached adjacent to the statement itself so the
+// late transformation can consult this statement's own properties.
+static void markOneTrailingUpdate(BlockStmt* block, Expr* stmt,
+                                  LifetimeInformation* lifetimeInfo,
+                                  bool addNoTaskPrivate) {
+  SymExpr* lhs = NULL;
+  SymExpr* rhs = NULL;
+
+  if (CallExpr* call = toCallExpr(stmt)) {
+    if (call->numActuals() >= 1)
+      lhs = toSymExpr(call->get(1));
+    if (call->numActuals() >= 2)
+      rhs = toSymExpr(call->get(2));
+  }
+
+  if (lhs && symbolOutlivesLoop(block, lhs->symbol(), lifetimeInfo))
+    addOptimizationFlag(stmt, OPT_INFO_LHS_OUTLIVES_FORALL);
+  if (rhs && symbolOutlivesLoop(block, rhs->symbol(), lifetimeInfo))
+    addOptimizationFlag(stmt, OPT_INFO_RHS_OUTLIVES_FORALL);
+  if (addNoTaskPrivate)
+    addOptimizationFlag(stmt, OPT_INFO_FLAG_NO_TASK_PRIVATE);
+}
+
+// Walks backward from an optimizable last statement and marks any run of
+// further trailing updates that are themselves optimizable and
+// independent of everything after them. A guarded update -- a
+// conditional whose branches each hold a single optimizable update -- is
+// handled by marking the branch statements in place: the guard stays and
+// the update under it becomes eligible for the unordered transformation.
+static void markTrailingUpdates(BlockStmt* block, Expr* lastStmt,
+                                LifetimeInformation* lifetimeInfo,
+                                bool addNoTaskPrivate) {
+  std::set<Symbol*> laterSyms;
+  gatherUpdateSymbols(lastStmt, laterSyms);
+
+  Expr* prev = lastStmt->prev;
+  while (prev != NULL) {
+    prev = skipIgnoredStmts(prev);
+    if (prev == NULL)
+      break;
+
+    if (CondStmt* cond = toCondStmt(prev)) {
+      Expr* thenUpd = soleUpdateInBranch(cond->thenStmt);
+      Expr* elseUpd = NULL;
+
+      bool ok = thenUpd != NULL &&
+                exprIsOptimizable(block, thenUpd, lifetimeInfo) &&
+                updateIsIndependent(thenUpd, laterSyms);
+
+      if (ok && cond->elseStmt != NULL) {
+        if (shouldCheckElseStmtForLastStmts(cond)) {
+          elseUpd = soleUpdateInBranch(cond->elseStmt);
+          ok = elseUpd != NULL &&
+               exprIsOptimizable(block, elseUpd, lifetimeInfo) &&
+               updateIsIndependent(elseUpd, laterSyms);
+        } else {
+          // an aggregation conditional; leave it for that transformation
+          ok = false;
+        }
+      }
+
+      if (ok == false)
+        break;
+
+      markOneTrailingUpdate(block, thenUpd, lifetimeInfo, addNoTaskPrivate);
+      gatherUpdateSymbols(thenUpd, laterSyms);
+      if (elseUpd != NULL) {
+        markOneTrailingUpdate(block, elseUpd, lifetimeInfo, addNoTaskPrivate);
+        gatherUpdateSymbols(elseUpd, laterSyms);
+      }
+
+    } else if (exprIsOptimizable(block, prev, lifetimeInfo) &&
+               updateIsIndependent(prev, laterSyms)) {
+      markOneTrailingUpdate(block, prev, lifetimeInfo, addNoTaskPrivate);
+      gatherUpdateSymbols(prev, laterSyms);
+
+    } else {
+      break;
+    }
+
+    prev = prev->prev;
+  }
+}
+
 class MarkOptimizableForallLastStmts final : public AstVisitorTraverse {
 
   public:
@@ -280,8 +417,8 @@ class MarkOptimizableForallLastStmts final : public AstVisitorTraverse {
 };
 
 bool MarkOptimizableForallLastStmts::enterForallStmt(ForallStmt* forall) {
-  if (fNoOptimizeForallUnordered == false) {
-    // If the optimization is enabled, do this
+  if (fNoOptimizeForallUnordered == false || fOptimizeForallYieldingGets) {
+    // If the optimizations are enabled, do this
     markLoopsInForall(forall);
   }
 
@@ -321,7 +458,9 @@ void MarkOptimizableForallLastStmts::markLoopsInForall(ForallStmt* forall) {
   }
 
   // Consider the last statements
-  for (int stmtNum = 0; stmtNum < numLastStmts; stmtNum++) {
+  for (int stmtNum = 0;
+       fNoOptimizeForallUnordered == false && stmtNum < numLastStmts;
+       stmtNum++) {
 
     int loopNum;
 
@@ -372,11 +511,40 @@ void MarkOptimizableForallLastStmts::markLoopsInForall(ForallStmt* forall) {
           addOptimizationFlag(stmt, OPT_INFO_RHS_OUTLIVES_FORALL);
         if (addNoTaskPrivate)
           addOptimizationFlag(stmt, OPT_INFO_FLAG_NO_TASK_PRIVATE);
+
+        // Also mark any trailing independent updates before it.
+        markTrailingUpdates(block, stmt, lifetimeInfo, addNoTaskPrivate);
       }
 
       loopNum++;
     }
   }
+
+  // Optionally mark the other reads in the bodies so that they can
+  // yield to another task while waiting for remote data, overlapping
+  // the network round trip.  The last statements are skipped: they are
+  // candidates for the stronger unordered transformation above.
+  if (fOptimizeForallYieldingGets) {
+    size_t loopNum = 0;
+    for_vector(BlockStmt, block, bodies) {
+      std::vector<Expr*>& lastStmts = lastStatementsPerBody[loopNum];
+      std::vector<CallExpr*> calls;
+      collectCallExprs(block, calls);
+      for_vector(CallExpr, call, calls) {
+        if (call->isPrimitive(PRIM_ASSIGN) &&
+            std::find(lastStmts.begin(), lastStmts.end(),
+                      (Expr*) call) == lastStmts.end()) {
+          SymExpr* lhs = toSymExpr(call->get(1));
+          SymExpr* rhs = toSymExpr(call->get(2));
+          if (lhs != NULL && rhs != NULL &&
+              lhs->symbol()->isRef() && rhs->symbol()->isRef() &&
+              lhs->getValType() == rhs->getValType())
+            addOptimizationFlag(call, OPT_INFO_FLAG_YIELDING_GET);
+        }
+      }
+      loopNum++;
+    }
+  }
 }
 
 void checkLifetimesForForallUnorderedOps(FnSymbol* fn,
@@ -693,6 +861,26 @@ CallExpr* findMarkerNear(Expr* stmt) {
   return NULL;
 }
 
+// Returns the marker created for 'stmt' itself (it directly follows the
+// statement, possibly after the marker symbol's DefExpr), or NULL.
+// Trailing updates must use this rather than findMarkerNear: scanning
+// forward from one of them would reach some later statement's marker and
+// borrow that statement's lifetime properties.
+static
+CallExpr* findOwnMarker(Expr* stmt) {
+  if (stmt->next != NULL)
+    if (CallExpr* call = toCallExpr(stmt->next))
+      if (call->isPrimitive(PRIM_OPTIMIZATION_INFO))
+        return call;
+
+  if (stmt->next != NULL && isDefExpr(stmt->next))
+    if (CallExpr* call = toCallExpr(stmt->next->next))
+      if (call->isPrimitive(PRIM_OPTIMIZATION_INFO))
+        return call;
+
+  return NULL;
+}
+
 static const char* optimizableFunctionTable[] =
  {
    "chpl_comm_atomic_add_", "chpl_comm_atomic_add_unordered_",
@@ -728,7 +916,8 @@ static bool isOptimizableAtomicFunction(const char* cname) {
   return false;
 }
 
-static bool isOptimizableAtomicStmt(Expr* stmt, BlockStmt* loop) {
+static bool isOptimizableAtomicStmt(Expr* stmt, BlockStmt* loop,
+                                    bool ownMarkerOnly) {
   // If this were to change, we'd need conditionals below to check
   // that the call is not within a PRIM_MOVE, since we can't do the
   // optimization if the return value is used.
@@ -749,14 +938,17 @@ static bool isOptimizableAtomicStmt(Expr* stmt, BlockStmt* loop) {
     }
   }
 
+  CallExpr* marker = NULL;
   if (refAtomic != NULL)
+    marker = ownMarkerOnly ? findOwnMarker(stmt) : findMarkerNear(stmt);
+
+  if (marker != NULL)
     if (BlockStmt* defInBlock = toBlockStmt(refAtomic->defPoint->parentExpr))
       if (isBlockWithinBlock(defInBlock, loop))
-        if (CallExpr* marker = findMarkerNear(stmt))
-          if (hasOptimizationFlag(marker, OPT_INFO_LHS_OUTLIVES_FORALL) &&
-              hasOptimizationFlag(marker, OPT_INFO_FLAG_NO_TASK_PRIVATE))
-            if (loopContainsBlocking(loop) == false)
-              return true;
+        if (hasOptimizationFlag(marker, OPT_INFO_LHS_OUTLIVES_FORALL) &&
+            hasOptimizationFlag(marker, OPT_INFO_FLAG_NO_TASK_PRIVATE))
+          if (loopContainsBlocking(loop) == false)
+            return true;
 
   return false;
 }
@@ -791,6 +983,8 @@ static void transformAtomicStmt(Expr* stmt) {
   if (fReportOptimizeForallUnordered)
     USR_PRINT(call, "Optimized atomic call to be unordered");
 
+  perfReportOptimization(call, "unordered atomic operation");
+
   // We might have newFnCName == NULL if we just wanted
   // to test the compiler optimization but there is no
   // runtime support / value in the optimization
@@ -883,20 +1077,24 @@ static void transformAtomicStmt(Expr* stmt) {
 
 }
 
-static bool isOptimizableAssignStmt(Expr* stmt, BlockStmt* loop) {
+static bool isOptimizableAssignStmt(Expr* stmt, BlockStmt* loop,
+                                    bool ownMarkerOnly) {
   Symbol* lhs = NULL;
   if (CallExpr* call = toCallExpr(stmt))
     if (call->isPrimitive(PRIM_ASSIGN))
       if (SymExpr* lhsSe = toSymExpr(call->get(1)))
         lhs = lhsSe->symbol();
 
+  CallExpr* marker = NULL;
   if (lhs)
+    marker = ownMarkerOnly ? findOwnMarker(stmt) : findMarkerNear(stmt);
+
+  if (marker != NULL)
     if (BlockStmt* defInBlock = toBlockStmt(lhs->defPoint->parentExpr))
       if (isBlockWithinBlock(defInBlock, loop))
-        if (CallExpr* marker = findMarkerNear(stmt))
-          if (hasOptimizationFlag(marker, OPT_INFO_LHS_OUTLIVES_FORALL) &&
-              hasOptimizationFlag(marker, OPT_INFO_FLAG_NO_TASK_PRIVATE))
-            return true;
+        if (hasOptimizationFlag(marker, OPT_INFO_LHS_OUTLIVES_FORALL) &&
+            hasOptimizationFlag(marker, OPT_INFO_FLAG_NO_TASK_PRIVATE))
+          return true;
 
   return false;
 }
@@ -925,7 +1123,85 @@ static CondStmt *getAggregationCondStmt(Expr *stmt) {
   return NULL;
 }
 
-static void transformAssignStmt(Expr* stmt) {
+// Extends the transformation backward from an optimizable last statement
+// over a run of further trailing updates. A statement joins the run only
+// if it will itself be converted and shares no symbols with the
+// (converted) statements after it; the walk stops at the first statement
+// that stays ordered, so an ordered op later in the body can still act
+// as a publication point for anything before it. A conditional joins the
+// run when each of its branches is a single convertible update: the
+// guard is left in place and the update under it becomes unordered.
+static void gatherTrailingUpdates(Expr* lastStmt, BlockStmt* loop,
+                                  std::vector<Expr*>& atomics,
+                                  std::vector<Expr*>& assigns) {
+  std::set<Symbol*> laterSyms;
+  gatherUpdateSymbols(lastStmt, laterSyms);
+
+  Expr* prev = lastStmt->prev;
+  while (prev != NULL) {
+    prev = skipIgnoredStmts(prev);
+    if (prev == NULL)
+      break;
+
+    if (CondStmt* cond = toCondStmt(prev)) {
+      Expr* branchUpds[2];
+      branchUpds[0] = soleUpdateInBranch(cond->thenStmt);
+      branchUpds[1] = cond->elseStmt != NULL ?
+                      soleUpdateInBranch(cond->elseStmt) : NULL;
+
+      bool ok = branchUpds[0] != NULL;
+
+      if (ok && cond->elseStmt != NULL) {
+        if (shouldCheckElseStmtForLastStmts(cond) == false)
+          ok = false; // an aggregation conditional; leave it alone
+        else
+          ok = branchUpds[1] != NULL;
+      }
+
+      for (int i = 0; ok && i < 2; i++) {
+        if (Expr* upd = branchUpds[i]) {
+          bool convertible =
+            isOptimizableAtomicStmt(upd, loop, /* ownMarkerOnly */ true) ||
+            isOptimizableAssignStmt(upd, loop, /* ownMarkerOnly */ true);
+
+          if (convertible == false || updateIsIndependent(upd, laterSyms) == false)
+            ok = false;
+        }
+      }
+
+      if (ok == false)
+        break;
+
+      for (int i = 0; i < 2; i++) {
+        if (Expr* upd = branchUpds[i]) {
+          if (isOptimizableAtomicStmt(upd, loop, /* ownMarkerOnly */ true))
+            atomics.push_back(upd);
+          else
+            assigns.push_back(upd);
+          gatherUpdateSymbols(upd, laterSyms);
+        }
+      }
+
+    } else if (isOptimizableAtomicStmt(prev, loop, /* ownMarkerOnly */ true) &&
+               updateIsIndependent(prev, laterSyms)) {
+      atomics.push_back(prev);
+      gatherUpdateSymbols(prev, laterSyms);
+
+    } else if (isOptimizableAssignStmt(prev, loop, /* ownMarkerOnly */ true) &&
+               updateIsIndependent(prev, laterSyms) &&
+               getAggregationCondStmt(prev) == NULL) {
+      assigns.push_back(prev);
+      gatherUpdateSymbols(prev, laterSyms);
+
+    } else {
+      break;
+    }
+
+    prev = prev->prev;
+  }
+}
+
+static void transformAssignStmt(Expr* stmt, PrimitiveTag newPrim) {
   SET_LINENO(stmt);
 
   CallExpr* call = toCallExpr(stmt);
@@ -976,11 +1252,18 @@ static void transformAssignStmt(Expr* stmt) {
     // add the call to getput
     if (fReportOptimizeForallUnordered) {
       if (developer || printsUserLocation(call)) {
-        USR_PRINT(call, "Optimized assign to be unordered");
+        if (newPrim == PRIM_UNORDERED_ASSIGN)
+          USR_PRINT(call, "Optimized assign to be unordered");
+        else
+          USR_PRINT(call, "Optimized assign to yield while waiting");
       }
     }
 
-    call->insertBefore(new CallExpr(PRIM_UNORDERED_ASSIGN, lhs, rhs->copy()));
+    perfReportOptimization(call, newPrim == PRIM_UNORDERED_ASSIGN ?
+                                 "unordered assignment" :
+                                 "yielding assignment");
+
+    call->insertBefore(new CallExpr(newPrim, lhs, rhs->copy()));
     call->remove();
     if (callToRemove)
       callToRemove->remove();
@@ -1004,7 +1287,52 @@ void optimizeForallUnorderedOps() {
     }
   }
 
-  if (fNoOptimizeForallUnordered)
+  // Confirm the run-to-completion candidates that createTaskFunctions
+  // marked before resolution. Now that the bodies are resolved, prune
+  // any candidate that may spawn, join, yield, or otherwise block; the
+  // surviving marks are emitted into chpl_ftableNonBlocking for the
+  // tasking layer. This is only a performance hint -- a mismarked task
+  // still runs correctly -- so the pruning errs on the side of keeping
+  // atomics and critical sections.
+  forv_Vec(FnSymbol, fn, gFnSymbols) {
+    if (fn->hasFlag(FLAG_TASK_FN_NON_BLOCKING) &&
+        !fn->hasFlag(FLAG_BEGIN_BLOCK)) {
+      int state = mayBlock(fn);
+      int reject = STATE_CREATES_TASKS  |
+                   STATE_YIELDS_TASKS   |
+                   STATE_JOINS_TASKS    |
+                   STATE_MAYBE_BLOCKING |
+                   STATE_EXTERN_ANYTHING;
+      if ((state & reject) != 0)
+        fn->removeFlag(FLAG_TASK_FN_NON_BLOCKING);
+    }
+  }
+
+  // The argument-bundling wrappers created by parallel() inherit the
+  // mark from the task function they wrap, and they are what the
+  // ftable -- and so the tasking layer -- actually sees. Keep each
+  // wrapper consistent with the decision just made for its wrapped
+  // function.
+  forv_Vec(FnSymbol, fn, gFnSymbols) {
+    if (fn->hasFlag(FLAG_TASK_FN_NON_BLOCKING) &&
+        fn->hasFlag(FLAG_BEGIN_BLOCK)) {
+      bool wrappedStillMarked = false;
+      std::vector<CallExpr*> calls;
+      collectCallExprs(fn->body, calls);
+      for_vector(CallExpr, call, calls) {
+        if (FnSymbol* callee = call->resolvedFunction()) {
+          if (callee->hasFlag(FLAG_BEGIN)) {
+            wrappedStillMarked = callee->hasFlag(FLAG_TASK_FN_NON_BLOCKING);
+            break;
+          }
+        }
+      }
+      if (!wrappedStillMarked)
+        fn->removeFlag(FLAG_TASK_FN_NON_BLOCKING);
+    }
+  }
+
+  if (fNoOptimizeForallUnordered && !fOptimizeForallYieldingGets)
     return;
 
   forv_Vec(FnSymbol, fn, gFnSymbols) {
@@ -1018,6 +1346,7 @@ void optimizeForallUnorderedOps() {
   std::vector<Expr*> atomicsToOptimize;
   std::vector<CondStmt*> aggCondsToTransform;
   std::vector<Expr*> assignsToOptimize;
+  std::vector<Expr*> yieldingAssignsToOptimize;
 
   // Gather expressions to optimize. This is done separately from
   // doing the transformation so that the transformation itself does
@@ -1032,15 +1361,21 @@ void optimizeForallUnorderedOps() {
         std::vector<Expr*> lastStmts;
         getLastStmts(loop, lastStmts);
         for_vector(Expr, lastStmt, lastStmts) {
-          if (isOptimizableAtomicStmt(lastStmt, loop)) {
+          if (isOptimizableAtomicStmt(lastStmt, loop,
+                                      /* ownMarkerOnly */ false)) {
             atomicsToOptimize.push_back(lastStmt);
+            gatherTrailingUpdates(lastStmt, loop,
+                                  atomicsToOptimize, assignsToOptimize);
           }
-          else if (isOptimizableAssignStmt(lastStmt, loop)) {
+          else if (isOptimizableAssignStmt(lastStmt, loop,
+                                           /* ownMarkerOnly */ false)) {
             if (CondStmt *aggCond = getAggregationCondStmt(lastStmt)) {
               aggCondsToTransform.push_back(aggCond);
             }
             else {
               assignsToOptimize.push_back(lastStmt);
+              gatherTrailingUpdates(lastStmt, loop,
+                                    atomicsToOptimize, assignsToOptimize);
             }
           }
         }
@@ -1048,6 +1383,15 @@ void optimizeForallUnorderedOps() {
     }
   }
 
+  // Gather the reads marked to yield while waiting for remote data.
+  if (fOptimizeForallYieldingGets) {
+    forv_Vec(CallExpr, call, gCallExprs) {
+      if (call->inTree() && call->isPrimitive(PRIM_ASSIGN))
+        if (hasOptimizationFlag(call, OPT_INFO_FLAG_YIELDING_GET))
+          yieldingAssignsToOptimize.push_back(call);
+    }
+  }
+
   // Now apply the transformation
   for_vector(Expr, atomic, atomicsToOptimize) {
     transformAtomicStmt(atomic);
@@ -1056,7 +1400,13 @@ void optimizeForallUnorderedOps() {
     transformConditionalAggregation(cond);
   }
   for_vector(Expr, assign, assignsToOptimize) {
-    transformAssignStmt(assign);
+    transformAssignStmt(assign, PRIM_UNORDERED_ASSIGN);
+  }
+  for_vector(Expr, assign, yieldingAssignsToOptimize) {
+    // An assign can be both a candidate here and the last statement of
+    // some inner loop; the unordered transformation wins in that case.
+    if (assign->inTree())
+      transformAssignStmt(assign, PRIM_YIELDING_ASSIGN);
   }
 
   cleanupRemainingAggCondStmts();
@@ -152,6 +152,7 @@ classifyPrimitive(CallExpr *call) {
   case PRIM_MOVE:
   case PRIM_ASSIGN:
   case PRIM_UNORDERED_ASSIGN:
+  case PRIM_YIELDING_ASSIGN:
   case PRIM_ADD_ASSIGN:
   case PRIM_SUBTRACT_ASSIGN:
   case PRIM_MULT_ASSIGN:
@@ -580,6 +581,15 @@ optimizeOnClauses(void) {
   compute_call_sites();
 
   forv_Vec(FnSymbol, fn, gFnSymbols) {
+    //
+    // Without --cache-remote there are no rmem fences to remove, so
+    // classification only pays off for on-body wrappers; those pull in
+    // their callees recursively.  Small programs with no on-statements
+    // then skip the whole analysis.
+    //
+    if (!fCacheRemote && !fn->hasFlag(FLAG_ON_BLOCK))
+      continue;
+
     std::set<FnSymbol*> visited;
 
     int is = markFastSafeFn(fn, optimize_on_clause_limit, visited);
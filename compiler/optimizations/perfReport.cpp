@@ -0,0 +1,113 @@
+/*
+ * Copyright 2020-2021 Hewlett Packard Enterprise Development LP
+ * Copyright 2004-2019 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "perfReport.h"
+
+#include "baseAST.h"
+#include "driver.h"
+#include "symbol.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <map>
+#include <string>
+#include <vector>
+
+//
+// See the comment in perfReport.h for an overview.
+//
+
+struct PerfReportEntry {
+  // -1: no pass reported on vectorization for this loop
+  //  0: hazard found, will not get vectorization hints
+  //  1: eligible for vectorization hints
+  int vectorized;
+  std::string vectorizeReason;
+  std::vector<std::string> optimizations;
+
+  PerfReportEntry() : vectorized(-1) { }
+};
+
+// Keyed (and later sorted) by the loop's formatted source location.
+static std::map<std::string, PerfReportEntry> perfReportEntries;
+
+static PerfReportEntry* entryFor(BaseAST* ast) {
+  if (!fPerfReport || ast == NULL)
+    return NULL;
+
+  // Match the --report-* flags: user code only, unless --devel.
+  ModuleSymbol* mod = ast->getModule();
+  if (mod == NULL || (!developer && mod->modTag != MOD_USER))
+    return NULL;
+
+  return &perfReportEntries[ast->stringLoc()];
+}
+
+void perfReportVectorization(BaseAST* ast, bool vectorizable,
+                             const char* reason) {
+  if (PerfReportEntry* entry = entryFor(ast)) {
+    // A loop can be visited more than once (e.g. after cloning); a
+    // hazard found on any visit keeps the loop unvectorized.
+    if (entry->vectorized != 0) {
+      entry->vectorized = vectorizable ? 1 : 0;
+    }
+    if (!vectorizable && reason != NULL && entry->vectorizeReason.empty()) {
+      entry->vectorizeReason = reason;
+    }
+  }
+}
+
+void perfReportOptimization(BaseAST* ast, const char* optimization) {
+  if (PerfReportEntry* entry = entryFor(ast)) {
+    // The same rewrite can fire repeatedly for one loop (once per
+    // access, say); report each optimization once.
+    std::vector<std::string>& opts = entry->optimizations;
+    if (std::find(opts.begin(), opts.end(), optimization) == opts.end()) {
+      opts.push_back(optimization);
+    }
+  }
+}
+
+void perfReportPrint() {
+  if (!fPerfReport || perfReportEntries.empty())
+    return;
+
+  printf("Performance report:\n");
+
+  std::map<std::string, PerfReportEntry>::iterator it;
+  for (it = perfReportEntries.begin(); it != perfReportEntries.end(); ++it) {
+    const PerfReportEntry& entry = it->second;
+
+    printf("  %s\n", it->first.c_str());
+
+    if (entry.vectorized == 1) {
+      printf("    vectorizable: yes\n");
+    } else if (entry.vectorized == 0) {
+      if (entry.vectorizeReason.empty())
+        printf("    vectorizable: no\n");
+      else
+        printf("    vectorizable: no -- %s\n", entry.vectorizeReason.c_str());
+    }
+
+    for (size_t i = 0; i < entry.optimizations.size(); i++) {
+      printf("    optimized: %s\n", entry.optimizations[i].c_str());
+    }
+  }
+}
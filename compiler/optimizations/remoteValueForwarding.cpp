@@ -28,6 +28,8 @@
 #include "stmt.h"
 #include "stringutil.h"
 
+#include <unordered_map>
+
 //#define DEBUG_SYNC_ACCESS_FUNCTION_SET
 
 static void updateLoopBodyClasses(Map<Symbol*, Vec<SymExpr*>*>& defMap,
@@ -52,8 +54,10 @@ class DotInfo {
 };
 DotInfo::DotInfo() : finalized(false), usesDotLocale(false) { }
 
-static std::map<Symbol*, DotInfo*> dotLocaleMap;
-typedef std::map<Symbol*, DotInfo*>::iterator DotInfoIter;
+// This map sees one lookup per ref SymExpr in the program and is keyed
+// by pointer, so hash it rather than paying for ordering we never use.
+static std::unordered_map<Symbol*, DotInfo*> dotLocaleMap;
+typedef std::unordered_map<Symbol*, DotInfo*>::iterator DotInfoIter;
 
 static void computeUsesDotLocale();
 
@@ -312,7 +316,8 @@ static bool canForwardValue(Map<Symbol*, Vec<SymExpr*>*>& defMap,
 
   } else if (arg->isRef()) {
     // can forward if the actual is a QUAL_CONST_VAL or a ref-to-const
-    DotInfo* info = dotLocaleMap[arg];
+    DotInfoIter infoIt = dotLocaleMap.find(arg);
+    DotInfo* info = (infoIt != dotLocaleMap.end()) ? infoIt->second : NULL;
     if (info && info->usesDotLocale) {
       retval = false;
     } else if (arg->intent == INTENT_CONST_REF) {
@@ -923,7 +928,8 @@ static bool isSafeToDeref(Map<Symbol*, Vec<SymExpr*>*>& defMap,
 static bool computeDotLocale(Symbol* sym) {
   INT_ASSERT(sym->isRef());
 
-  DotInfo* info = dotLocaleMap[sym];
+  DotInfoIter infoIt = dotLocaleMap.find(sym);
+  DotInfo* info = (infoIt != dotLocaleMap.end()) ? infoIt->second : NULL;
 
   if (info == NULL) {
     // No uses of this symbol, so definitely no uses of dot-locale
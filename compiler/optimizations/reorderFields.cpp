@@ -0,0 +1,190 @@
+/*
+ * Copyright 2020-2021 Hewlett Packard Enterprise Development LP
+ * Copyright 2004-2019 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//
+// reorderFields
+//
+// Records code-generate their fields in declaration order, which can
+// waste space to padding between fields of mixed alignment and can
+// scatter frequently accessed fields across cache lines.  This pass
+// rewrites the field order of eligible records late in compilation,
+// sorting fields by decreasing (estimated) alignment so that padding
+// only appears at the end of the struct, and breaking alignment ties
+// by putting more frequently accessed fields first so hot fields
+// cluster at the front.
+//
+// By this point in compilation every member access refers to the field
+// Symbol itself -- positional reflection primitives were folded during
+// resolution -- so permuting the DefExprs in a record's fields list
+// only changes the generated struct layout, not program behavior.
+//
+// Types whose layout is visible outside this compilation are left
+// alone: extern and exported records must match their C declarations,
+// and runtime-interface types are all extern.  Tuples and unions are
+// also skipped, as is anything flagged as a reference or runtime type.
+//
+// Access counts are estimated statically: each SymExpr mentioning a
+// field at this late stage is a member access in some function that
+// survived pruning.
+//
+
+#include "optimizations.h"
+
+#include "astutil.h"
+#include "driver.h"
+#include "expr.h"
+#include "stlUtil.h"
+#include "stmt.h"
+#include "symbol.h"
+
+#include <algorithm>
+#include <vector>
+
+//
+// Estimate the code-generated alignment of a type, in bytes.  This
+// only steers the sort; a wrong guess can cost padding but never
+// correctness.  Pointers (classes, refs, c_ptrs, wide pointers) and
+// anything unrecognized count as pointer-aligned.
+//
+static int estimatedAlignment(Type* t, int depth) {
+  if (t == NULL || depth > 8)
+    return sizeof(void*);
+
+  if (is_bool_type(t) || is_enum_type(t))
+    return 1;
+
+  if (is_int_type(t) || is_uint_type(t) ||
+      is_real_type(t) || is_imag_type(t)) {
+    int bytes = get_width(t) / 8;
+    if (bytes < 1) bytes = 1;
+    if (bytes > 16) bytes = 16;
+    return bytes;
+  }
+
+  // complex(2w) aligns like real(w)
+  if (is_complex_type(t)) {
+    int bytes = get_width(t) / 16;
+    if (bytes < 1) bytes = 1;
+    if (bytes > 16) bytes = 16;
+    return bytes;
+  }
+
+  if (isClassLikeOrPtr(t) || t->symbol->hasFlag(FLAG_REF))
+    return sizeof(void*);
+
+  // a nested record aligns like its most-aligned field
+  if (AggregateType* at = toAggregateType(t)) {
+    if (at->isRecord() && !at->isUnion()) {
+      int align = 1;
+      for_fields(field, at) {
+        int fieldAlign = estimatedAlignment(field->type, depth + 1);
+        if (fieldAlign > align)
+          align = fieldAlign;
+      }
+      return align;
+    }
+  }
+
+  return sizeof(void*);
+}
+
+static bool isReorderableRecord(AggregateType* at) {
+  TypeSymbol* ts = at->symbol;
+
+  if (!at->isRecord() || at->isUnion())
+    return false;
+
+  if (at->fields.length <= 1)
+    return false;
+
+  // layout is part of the type's interface to foreign code
+  if (ts->hasFlag(FLAG_EXTERN) || ts->hasFlag(FLAG_EXPORT))
+    return false;
+
+  // star tuples may be indexed positionally during codegen
+  if (ts->hasFlag(FLAG_TUPLE) || ts->hasFlag(FLAG_STAR_TUPLE))
+    return false;
+
+  if (ts->hasFlag(FLAG_REF) || ts->hasFlag(FLAG_RUNTIME_TYPE_VALUE))
+    return false;
+
+  return true;
+}
+
+struct FieldOrderInfo {
+  DefExpr* def;
+  int      alignment;
+  int      accessCount;
+  int      declIndex;
+};
+
+static bool fieldOrderLess(const FieldOrderInfo& a, const FieldOrderInfo& b) {
+  if (a.alignment != b.alignment)
+    return a.alignment > b.alignment;        // most aligned first
+  if (a.accessCount != b.accessCount)
+    return a.accessCount > b.accessCount;    // then hottest first
+  return a.declIndex < b.declIndex;          // then declaration order
+}
+
+static void reorderRecordFields(AggregateType* at) {
+  std::vector<FieldOrderInfo> infos;
+  int index = 0;
+
+  for_fields(field, at) {
+    FieldOrderInfo info;
+    info.def = field->defPoint;
+    info.alignment = estimatedAlignment(field->type, 0);
+    info.accessCount = 0;
+    for_SymbolSymExprs(se, field) {
+      (void) se;
+      info.accessCount++;
+    }
+    info.declIndex = index++;
+    infos.push_back(info);
+  }
+
+  std::stable_sort(infos.begin(), infos.end(), fieldOrderLess);
+
+  // already in the desired order?
+  bool changed = false;
+  for (size_t i = 0; i < infos.size(); i++) {
+    if (infos[i].declIndex != (int) i) {
+      changed = true;
+      break;
+    }
+  }
+  if (!changed)
+    return;
+
+  for (size_t i = 0; i < infos.size(); i++) {
+    infos[i].def->remove();
+    at->fields.insertAtTail(infos[i].def);
+  }
+}
+
+void reorderFields() {
+  if (fNoReorderFields)
+    return;
+
+  forv_Vec(AggregateType, at, gAggregateTypes) {
+    if (at->inTree() && isReorderableRecord(at))
+      reorderRecordFields(at);
+  }
+}
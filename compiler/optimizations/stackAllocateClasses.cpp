@@ -0,0 +1,530 @@
+/*
+ * Copyright 2020-2021 Hewlett Packard Enterprise Development LP
+ * Copyright 2004-2019 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//
+// stackAllocateClasses
+//
+// Rewrite 'new C()' allocations whose objects provably never escape
+// their allocating function to use stack storage instead of the heap,
+// eliminating allocator pressure for short-lived objects.
+//
+// The analysis is interprocedural but deliberately conservative.  For
+// every function formal of class type we compute a summary saying
+// whether the formal's pointer value can escape that function: be
+// stored into an object field or a non-local variable, be returned,
+// have its address taken, or flow to a callee formal that itself
+// escapes (computed to a fixpoint over the call graph).  Task and on
+// functions, extern functions, and virtual dispatch are treated as
+// escaping.
+//
+// A '_new wrapper' call is a candidate when the result lands in a local
+// variable whose value (through moves and casts) never escapes the
+// function per the summaries, and is passed to chpl__delete exactly
+// once.  The delete is the object's death point, so using it as the
+// boundary is sound relative to the original program: any use after it
+// was already a use after free.
+//
+// The rewrite allocates the object's storage with
+// PRIM_STACK_ALLOCATE_CLASS (the same mechanism parallel.cpp uses for
+// task argument bundles) and redirects the site to cloned variants of
+// the wrapper and of chpl__delete: the wrapper clone takes the
+// preallocated storage in place of its locale-model alloc call, and the
+// delete clone still runs the deinitializer but skips the locale-model
+// free.
+//
+
+#include "optimizations.h"
+
+#include "astutil.h"
+#include "driver.h"
+#include "expr.h"
+#include "DecoratedClassType.h"
+#include "passes.h"
+#include "stlUtil.h"
+#include "stmt.h"
+#include "symbol.h"
+
+#include <map>
+#include <utility>
+#include <vector>
+
+// The result of tracing one pointer value's uses within one function.
+struct EscapeInfo {
+  EscapeInfo() : escapes(false) { }
+
+  bool escapes;
+
+  // callee formals the value flows to; escape depends on their summaries
+  std::vector<std::pair<FnSymbol*, int> > flowsTo;
+
+  // calls passing the value to chpl__delete (collected only when the
+  // caller asked for them; otherwise they count as ordinary calls)
+  std::vector<CallExpr*> deleteCalls;
+};
+
+// formal index -> can the formal's value escape the function?
+static std::map<FnSymbol*, std::vector<bool> > escapeSummaries;
+
+
+// Return the canonical class type allocated/carried by 't', or NULL if
+// 't' isn't a class pointer.
+static AggregateType* trackedClassType(Type* t) {
+  if (DecoratedClassType* dt = toDecoratedClassType(t)) {
+    return dt->getCanonicalClass();
+  }
+
+  if (AggregateType* at = toAggregateType(t)) {
+    if (isClass(at) == true) {
+      return at;
+    }
+  }
+
+  return NULL;
+}
+
+static bool isDeleteFn(FnSymbol* fn) {
+  return strcmp(fn->name, "chpl__delete") == 0;
+}
+
+//
+// Trace the uses of 'root' within 'fn', following moves and casts into
+// local aliases.  Sets info.escapes on anything the analysis can't
+// prove safe, and records value flow into callee formals for the
+// interprocedural fixpoint.  When 'findDeletes' is set, calls to
+// chpl__delete on the value are collected instead of being treated as
+// ordinary calls.
+//
+static void analyzeUses(FnSymbol* fn, Symbol* root, EscapeInfo& info,
+                        bool findDeletes) {
+  std::vector<SymExpr*> symExprs;
+  collectSymExprs(fn->body, symExprs);
+
+  std::map<Symbol*, std::vector<SymExpr*> > uses;
+  for_vector(SymExpr, se, symExprs) {
+    uses[se->symbol()].push_back(se);
+  }
+
+  std::vector<Symbol*> aliases;
+  std::map<Symbol*, int> defCounts;
+  std::map<Symbol*, bool> inSet;
+
+  aliases.push_back(root);
+  inSet[root] = true;
+
+  for (size_t ai = 0; ai < aliases.size() && !info.escapes; ai++) {
+    Symbol* alias = aliases[ai];
+
+    for_vector(SymExpr, se, uses[alias]) {
+      CallExpr* call = toCallExpr(se->parentExpr);
+
+      if (call == NULL) {
+        // a use we don't understand (condition, def expr init, ...)
+        if (isDefExpr(se->parentExpr) == false) {
+          info.escapes = true;
+        }
+        continue;
+      }
+
+      // A cast propagates the pointer to the enclosing move's target.
+      if ((call->isPrimitive(PRIM_CAST) && se == call->get(2)) ||
+          call->isPrimitive(PRIM_CAST_TO_VOID_STAR)) {
+        CallExpr* outer = toCallExpr(call->parentExpr);
+        if (outer != NULL && outer->isPrimitive(PRIM_MOVE)) {
+          if (SymExpr* lhs = toSymExpr(outer->get(1))) {
+            Symbol* tgt = lhs->symbol();
+            if (tgt->defPoint->getFunction() == fn &&
+                tgt != fn->getReturnSymbol()) {
+              defCounts[tgt]++;
+              if (!inSet[tgt]) {
+                inSet[tgt] = true;
+                aliases.push_back(tgt);
+              }
+              continue;
+            }
+          }
+        }
+        info.escapes = true;
+        continue;
+      }
+
+      if (call->isPrimitive(PRIM_MOVE)) {
+        if (se == call->get(1)) {
+          // our alias is overwritten; nothing escapes through that
+          continue;
+        }
+        if (se == call->get(2)) {
+          if (SymExpr* lhs = toSymExpr(call->get(1))) {
+            Symbol* tgt = lhs->symbol();
+            if (tgt->defPoint->getFunction() == fn &&
+                tgt != fn->getReturnSymbol()) {
+              defCounts[tgt]++;
+              if (!inSet[tgt]) {
+                inSet[tgt] = true;
+                aliases.push_back(tgt);
+              }
+              continue;
+            }
+          }
+        }
+        info.escapes = true;
+        continue;
+      }
+
+      if (call->isPrimitive()) {
+        switch (call->primitive->tag) {
+        case PRIM_SET_MEMBER:
+        case PRIM_SET_SVEC_MEMBER:
+          // writing into our object's fields is fine; storing our
+          // pointer into some object's field is an escape
+          if (se == call->get(1)) {
+            continue;
+          }
+          info.escapes = true;
+          continue;
+
+        case PRIM_GET_MEMBER:
+        case PRIM_GET_MEMBER_VALUE:
+        case PRIM_GET_SVEC_MEMBER:
+        case PRIM_GET_SVEC_MEMBER_VALUE:
+        case PRIM_GETCID:
+        case PRIM_TESTCID:
+        case PRIM_SETCID:
+        case PRIM_EQUAL:
+        case PRIM_NOTEQUAL:
+        case PRIM_LOCAL_CHECK:
+        case PRIM_NOOP:
+          continue;
+
+        default:
+          // returns, addr-of, assigns through references, and anything
+          // else we haven't vetted
+          info.escapes = true;
+          continue;
+        }
+      }
+
+      // a non-primitive call: the value flows into a callee
+      FnSymbol* callee = call->resolvedFunction();
+
+      if (callee == NULL ||
+          callee->hasFlag(FLAG_EXTERN) ||
+          isTaskFun(callee)) {
+        info.escapes = true;
+        continue;
+      }
+
+      if (findDeletes && isDeleteFn(callee)) {
+        info.deleteCalls.push_back(call);
+        continue;
+      }
+
+      bool found = false;
+      int idx = 0;
+      for_formals_actuals(formal, actual, call) {
+        if (actual == se) {
+          // passing by ref hands out the variable's address
+          if (formal->isRef() == true) {
+            info.escapes = true;
+          } else {
+            info.flowsTo.push_back(std::make_pair(callee, idx));
+          }
+          found = true;
+        }
+        idx++;
+      }
+
+      if (!found) {
+        info.escapes = true;
+      }
+    }
+  }
+
+  // An alias with more than one definition can carry some other value
+  // to the uses we vetted (including a delete), so give up on it.
+  for (std::map<Symbol*, int>::iterator it = defCounts.begin();
+       it != defCounts.end();
+       ++it) {
+    if (it->second > 1) {
+      info.escapes = true;
+    }
+  }
+}
+
+//
+// Compute, to a fixpoint, whether each class-type formal can escape its
+// function.
+//
+static void computeEscapeSummaries() {
+  std::map<FnSymbol*, std::vector<EscapeInfo> > details;
+
+  forv_Vec(FnSymbol, fn, gFnSymbols) {
+    if (fn->inTree() == false || fn->hasFlag(FLAG_EXTERN)) {
+      continue;
+    }
+
+    std::vector<bool> summary(fn->numFormals(), false);
+    std::vector<EscapeInfo> infos(fn->numFormals());
+
+    int idx = 0;
+    for_formals(formal, fn) {
+      if (trackedClassType(formal->type) != NULL && !formal->isRef()) {
+        analyzeUses(fn, formal, infos[idx], false);
+        summary[idx] = infos[idx].escapes;
+      } else {
+        // not a tracked pointer; never reported as escaping
+        summary[idx] = false;
+      }
+      idx++;
+    }
+
+    escapeSummaries[fn] = summary;
+    details[fn] = infos;
+  }
+
+  bool changed = true;
+  while (changed) {
+    changed = false;
+
+    for (std::map<FnSymbol*, std::vector<EscapeInfo> >::iterator it =
+           details.begin();
+         it != details.end();
+         ++it) {
+      FnSymbol* fn = it->first;
+      std::vector<EscapeInfo>& infos = it->second;
+      std::vector<bool>& summary = escapeSummaries[fn];
+
+      for (size_t i = 0; i < infos.size(); i++) {
+        if (summary[i]) {
+          continue;
+        }
+        for (size_t j = 0; j < infos[i].flowsTo.size(); j++) {
+          FnSymbol* callee = infos[i].flowsTo[j].first;
+          int calleeIdx = infos[i].flowsTo[j].second;
+          std::map<FnSymbol*, std::vector<bool> >::iterator cit =
+            escapeSummaries.find(callee);
+          if (cit == escapeSummaries.end() ||
+              calleeIdx >= (int) cit->second.size() ||
+              cit->second[calleeIdx]) {
+            summary[i] = true;
+            changed = true;
+            break;
+          }
+        }
+      }
+    }
+  }
+}
+
+// Is every callee formal this value flows to proven non-escaping?
+static bool flowsToAreSafe(const EscapeInfo& info) {
+  for (size_t i = 0; i < info.flowsTo.size(); i++) {
+    FnSymbol* callee = info.flowsTo[i].first;
+    int idx = info.flowsTo[i].second;
+    std::map<FnSymbol*, std::vector<bool> >::iterator it =
+      escapeSummaries.find(callee);
+    if (it == escapeSummaries.end() ||
+        idx >= (int) it->second.size() ||
+        it->second[idx]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+//
+// Clone a _new wrapper into a variant taking preallocated storage,
+// replacing its locale-model alloc call with the extra formal.  Returns
+// NULL (and caches the failure) if the wrapper doesn't have the
+// expected shape.
+//
+static FnSymbol* stackNewVariant(FnSymbol* newFn, AggregateType* ct) {
+  static std::map<FnSymbol*, FnSymbol*> cache;
+
+  std::map<FnSymbol*, FnSymbol*>::iterator it = cache.find(newFn);
+  if (it != cache.end()) {
+    return it->second;
+  }
+
+  SET_LINENO(newFn);
+
+  FnSymbol* variant = newFn->copy();
+  variant->name = astr("_new_stack");
+  variant->cname = astr(variant->cname, "_stack");
+  newFn->defPoint->insertAfter(new DefExpr(variant));
+
+  ArgSymbol* memArg = new ArgSymbol(INTENT_BLANK, "stack_mem", ct);
+  variant->insertFormalAtTail(memArg);
+
+  CallExpr* alloc = NULL;
+  std::vector<CallExpr*> calls;
+  collectCallExprs(variant->body, calls);
+  for_vector(CallExpr, call, calls) {
+    if (FnSymbol* rf = call->resolvedFunction()) {
+      if (rf->hasFlag(FLAG_LOCALE_MODEL_ALLOC)) {
+        alloc = call;
+        break;
+      }
+    }
+  }
+
+  if (alloc == NULL || toCallExpr(alloc->parentExpr) == NULL) {
+    variant->defPoint->remove();
+    cache[newFn] = NULL;
+    return NULL;
+  }
+
+  Type* expected = alloc->typeInfo();
+  if (expected == ct) {
+    alloc->replace(new SymExpr(memArg));
+  } else if (expected == dtCVoidPtr) {
+    alloc->replace(new CallExpr(PRIM_CAST_TO_VOID_STAR, memArg));
+  } else {
+    alloc->replace(new CallExpr(PRIM_CAST, expected->symbol, memArg));
+  }
+
+  cache[newFn] = variant;
+  return variant;
+}
+
+//
+// Clone chpl__delete into a variant that still runs the deinitializer
+// but skips the locale-model free, since the storage isn't the
+// allocator's to reclaim.
+//
+static FnSymbol* stackDeleteVariant(FnSymbol* deleteFn) {
+  static std::map<FnSymbol*, FnSymbol*> cache;
+
+  std::map<FnSymbol*, FnSymbol*>::iterator it = cache.find(deleteFn);
+  if (it != cache.end()) {
+    return it->second;
+  }
+
+  SET_LINENO(deleteFn);
+
+  FnSymbol* variant = deleteFn->copy();
+  variant->name = astr("chpl__delete_stack");
+  variant->cname = astr(variant->cname, "_stack");
+  deleteFn->defPoint->insertAfter(new DefExpr(variant));
+
+  int removed = 0;
+  bool badShape = false;
+  std::vector<CallExpr*> calls;
+  collectCallExprs(variant->body, calls);
+  for_vector(CallExpr, call, calls) {
+    if (FnSymbol* rf = call->resolvedFunction()) {
+      if (rf->hasFlag(FLAG_LOCALE_MODEL_FREE)) {
+        if (call->parentExpr != NULL) {
+          badShape = true;
+        } else {
+          call->convertToNoop();
+          removed++;
+        }
+      }
+    }
+  }
+
+  if (removed == 0 || badShape) {
+    variant->defPoint->remove();
+    cache[deleteFn] = NULL;
+    return NULL;
+  }
+
+  cache[deleteFn] = variant;
+  return variant;
+}
+
+void stackAllocateClasses() {
+  if (fNoStackAllocateClasses) {
+    return;
+  }
+
+  computeEscapeSummaries();
+
+  forv_Vec(CallExpr, call, gCallExprs) {
+    if (call->inTree() == false) {
+      continue;
+    }
+
+    FnSymbol* newFn = call->resolvedFunction();
+    if (newFn == NULL || newFn->hasFlag(FLAG_NEW_WRAPPER) == false) {
+      continue;
+    }
+
+    CallExpr* move = toCallExpr(call->parentExpr);
+    if (move == NULL || move->isPrimitive(PRIM_MOVE) == false) {
+      continue;
+    }
+
+    SymExpr* lhs = toSymExpr(move->get(1));
+    VarSymbol* var = (lhs != NULL) ? toVarSymbol(lhs->symbol()) : NULL;
+    FnSymbol* parentFn = toFnSymbol(move->parentSymbol);
+    if (var == NULL || parentFn == NULL ||
+        var->defPoint->getFunction() != parentFn) {
+      continue;
+    }
+
+    AggregateType* ct = trackedClassType(newFn->retType);
+    if (ct == NULL) {
+      continue;
+    }
+
+    EscapeInfo info;
+    analyzeUses(parentFn, var, info, true);
+
+    if (info.escapes || flowsToAreSafe(info) == false) {
+      continue;
+    }
+
+    // Exactly one delete: it is the object's death point, and with it
+    // present the stack slot can't be observed holding a stale object
+    // any more than recycled heap memory could be.
+    if (info.deleteCalls.size() != 1) {
+      continue;
+    }
+
+    CallExpr* deleteCall = info.deleteCalls[0];
+    FnSymbol* deleteFn = deleteCall->resolvedFunction();
+
+    FnSymbol* newVariant = stackNewVariant(newFn, ct);
+    if (newVariant == NULL) {
+      continue;
+    }
+
+    FnSymbol* deleteVariant = stackDeleteVariant(deleteFn);
+    if (deleteVariant == NULL) {
+      continue;
+    }
+
+    SET_LINENO(move);
+
+    VarSymbol* stackVar = newTemp("stack_new_tmp", ct);
+    move->insertBefore(new DefExpr(stackVar));
+    move->insertBefore(new CallExpr(PRIM_MOVE, stackVar,
+                                    new CallExpr(PRIM_STACK_ALLOCATE_CLASS,
+                                                 ct->symbol)));
+
+    call->baseExpr->replace(new SymExpr(newVariant));
+    call->insertAtTail(new SymExpr(stackVar));
+
+    deleteCall->baseExpr->replace(new SymExpr(deleteVariant));
+  }
+
+  escapeSummaries.clear();
+}
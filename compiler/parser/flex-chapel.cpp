@@ -3408,6 +3408,7 @@ static void  addCharEscapeNonprint(char c);
 static void  addCharEscapingC(yyscan_t scanner, char c);
 
 static int   getNextYYChar(yyscan_t scanner);
+static void  eatBufferedSpan(yyscan_t scanner, char stop);
 
 static std::string stringBuffer;
 
@@ -3854,8 +3855,14 @@ static int processSingleLineComment(yyscan_t scanner) {
   newString();
   countCommentLine();
 
-  // Read until the end of the line
-  while ((c = getNextYYChar(scanner)) != '\n' && c != 0) {
+  // Read until the end of the line, consuming buffered characters in
+  // whole spans and falling back to one at a time across refills.
+  for (;;) {
+    eatBufferedSpan(scanner, '\n');
+
+    if ((c = getNextYYChar(scanner)) == '\n' || c == 0)
+      break;
+
     addChar(c);
   }
 
@@ -4124,6 +4131,36 @@ static char toHex(char c) {
   return (0 <= c && c <= 9) ? '0' + c : 'A' + (c - 10);
 }
 
+//
+// Append to stringBuffer everything already buffered in the scanner up
+// to (not including) 'stop', a NUL, or the end of the buffered input,
+// advancing the scanner past the appended span.  This consumes long
+// comment spans in one step instead of one yyinput() call per
+// character; the caller picks up with getNextYYChar(), whose normal
+// buffer-refill machinery runs at the span's end.  The hold-character
+// discipline here matches yyinput()'s.
+//
+static void eatBufferedSpan(yyscan_t scanner, char stop) {
+  struct yyguts_t* yyg = (struct yyguts_t*) scanner;
+
+  *yyg->yy_c_buf_p = yyg->yy_hold_char;
+
+  char* beg = yyg->yy_c_buf_p;
+  char* end = &YY_CURRENT_BUFFER_LVALUE->yy_ch_buf[yyg->yy_n_chars];
+  char* cur = beg;
+
+  while (cur < end && *cur != stop && *cur != YY_END_OF_BUFFER_CHAR) {
+    cur++;
+  }
+
+  if (cur != beg) {
+    stringBuffer.append(beg, cur - beg);
+    yyg->yy_c_buf_p = cur;
+  }
+
+  yyg->yy_hold_char = *yyg->yy_c_buf_p;
+}
+
 static int getNextYYChar(yyscan_t scanner) {
   int retval = yyinput(scanner);
 
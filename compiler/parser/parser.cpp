@@ -33,6 +33,7 @@
 #include "flex-chapel.h"
 #include "insertLineNumbers.h"
 #include "stringutil.h"
+#include "tokenCache.h"
 #include "symbol.h"
 #include "wellknown.h"
 
@@ -46,6 +47,7 @@
 #endif
 
 #include <cstdlib>
+#include <map>
 
 BlockStmt*           yyblock                       = NULL;
 const char*          yyfilename                    = NULL;
@@ -92,9 +94,9 @@ static void uASTParseFile(const char* fileName,
 static const char*   stdModNameToPath(const char* modName,
                                       bool*       isStandard);
 
-static const char*   searchThePath(const char*      modName,
-                                   bool             isInternal,
-                                   Vec<const char*> searchPath);
+static const char*   searchThePath(const char*       modName,
+                                   bool              isInternal,
+                                   Vec<const char*>& searchPath);
 
 /************************************* | **************************************
 *                                                                             *
@@ -679,22 +681,47 @@ static ModuleSymbol* parseFile(const char* path,
 
     yyset_in(fp, context.scanner);
 
-    while (lexerStatus != 0 && parserStatus == YYPUSH_MORE) {
-      YYSTYPE yylval;
+    bool cacheEligible = tokenCacheIsEligible(path, modTag);
+    bool replayed      = false;
 
-      lexerStatus = yylex(&yylval, &yylloc, context.scanner);
+    if (cacheEligible == true) {
+      replayed = tokenCacheReplay(path, modTag, parser,
+                                  &context, &parserStatus);
+    }
+
+    if (replayed == false) {
+      if (cacheEligible == true) {
+        tokenCacheStartRecording();
+      }
+
+      while (lexerStatus != 0 && parserStatus == YYPUSH_MORE) {
+        YYSTYPE yylval;
 
-      if        (lexerStatus >= 0) {
-        parserStatus          = yypush_parse(parser,
-                                             lexerStatus,
-                                             &yylval,
-                                             &yylloc,
-                                             &context);
+        lexerStatus = yylex(&yylval, &yylloc, context.scanner);
 
-      } else if (lexerStatus == YYLEX_BLOCK_COMMENT) {
-        context.latestComment = yylval.pch;
-      } else if (lexerStatus == YYLEX_SINGLE_LINE_COMMENT) {
-        context.latestComment = NULL;
+        if (cacheEligible == true) {
+          tokenCacheRecordToken(lexerStatus, &yylval, &yylloc,
+                                yyget_text(context.scanner));
+        }
+
+        if        (lexerStatus >= 0) {
+          parserStatus          = yypush_parse(parser,
+                                               lexerStatus,
+                                               &yylval,
+                                               &yylloc,
+                                               &context);
+
+        } else if (lexerStatus == YYLEX_BLOCK_COMMENT) {
+          context.latestComment = yylval.pch;
+        } else if (lexerStatus == YYLEX_SINGLE_LINE_COMMENT) {
+          context.latestComment = NULL;
+        }
+      }
+
+      if (cacheEligible == true) {
+        // Only keep complete streams; an early parser stop would leave
+        // a truncated entry behind.
+        tokenCacheStopRecording(path, modTag, lexerStatus == 0);
       }
     }
 
@@ -1059,12 +1086,27 @@ static const char* stdModNameToPath(const char* modName,
   return retval;
 }
 
-static const char* searchThePath(const char*      modName,
-                                 bool             isInternal,
-                                 Vec<const char*> searchPath) {
+static const char* searchThePath(const char*       modName,
+                                 bool              isInternal,
+                                 Vec<const char*>& searchPath) {
   const char* fileName = astr(modName, ".chpl");
   const char* retval   = NULL;
 
+  // The same module is commonly requested once per file that uses it,
+  // and each search probes every directory on the path, so memoize the
+  // result.  astr() canonicalizes the strings, and the search paths
+  // are fixed before parsing starts, so pointer keys suffice.
+  typedef std::pair<const void*, const char*> SearchKey;
+  static std::map<SearchKey, const char*> cache;
+
+  SearchKey key(&searchPath, fileName);
+
+  std::map<SearchKey, const char*>::iterator it = cache.find(key);
+
+  if (it != cache.end()) {
+    return it->second;
+  }
+
   forv_Vec(const char*, dirName, searchPath) {
     const char* path = astr(dirName, "/", fileName);
 
@@ -1086,5 +1128,7 @@ static const char* searchThePath(const char*      modName,
     }
   }
 
+  cache[key] = retval;
+
   return retval;
 }
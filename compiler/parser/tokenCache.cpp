@@ -0,0 +1,403 @@
+/*
+ * Copyright 2020-2021 Hewlett Packard Enterprise Development LP
+ * Copyright 2004-2019 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "tokenCache.h"
+
+#include "countTokens.h"
+#include "docsDriver.h"
+#include "driver.h"
+#include "files.h"
+#include "misc.h"
+#include "parser.h"
+#include "stringutil.h"
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+char tokenCacheDir[FILENAME_MAX + 1] = "";
+
+//
+// Cache entries are versioned so that format changes (or lexer changes
+// that alter what a record carries) just read as misses.
+//
+#define TOKEN_CACHE_MAGIC   0x534b4f544c504843ULL  // "CHPLTOKS"
+#define TOKEN_CACHE_VERSION 1
+
+//
+// One lexer result.  'pch' is the semantic value handed to the parser;
+// 'raw' is the text flex matched, kept so that replay can reproduce the
+// captureString bookkeeping that processToken() and friends perform for
+// function signature capture.  'line' is chplLineno after the token.
+//
+struct CachedToken {
+  int         status;
+  int         line;
+  YYLTYPE     loc;
+  const char* pch;
+  std::string raw;
+};
+
+static std::vector<CachedToken> sRecorded;
+static bool                     sRecording = false;
+
+/************************************* | **************************************
+*                                                                             *
+* Cache keying and file IO                                                    *
+*                                                                             *
+************************************** | *************************************/
+
+static bool hashFileContents(const char* path, uint64_t* hashOut) {
+  FILE* fp = fopen(path, "rb");
+
+  if (fp == NULL)
+    return false;
+
+  uint64_t hash = 0xcbf29ce484222325ULL;
+  char     buf[4096];
+  size_t   got;
+
+  while ((got = fread(buf, 1, sizeof(buf), fp)) > 0) {
+    for (size_t i = 0; i < got; i++) {
+      hash ^= (unsigned char) buf[i];
+      hash *= 0x100000001b3ULL;
+    }
+  }
+
+  fclose(fp);
+
+  *hashOut = hash;
+
+  return true;
+}
+
+static std::string cacheEntryPath(const char* path, ModTag modTag) {
+  uint64_t hash = 0;
+
+  if (hashFileContents(path, &hash) == false)
+    return "";
+
+  char name[64];
+
+  snprintf(name, sizeof(name), "/tok-%d-%016llx.bin",
+           (int) modTag, (unsigned long long) hash);
+
+  return std::string(tokenCacheDir) + name;
+}
+
+static void writeU32(FILE* fp, uint32_t v) {
+  fwrite(&v, sizeof(v), 1, fp);
+}
+
+static bool readU32(FILE* fp, uint32_t* v) {
+  return fread(v, sizeof(*v), 1, fp) == 1;
+}
+
+static void writeStr(FILE* fp, const char* s, size_t len) {
+  writeU32(fp, (uint32_t) len);
+  if (len > 0)
+    fwrite(s, 1, len, fp);
+}
+
+/************************************* | **************************************
+*                                                                             *
+* Eligibility                                                                 *
+*                                                                             *
+************************************** | *************************************/
+
+bool tokenCacheIsEligible(const char* path, ModTag modTag) {
+  if (tokenCacheDir[0] == '\0')
+    return false;
+
+  // Only module code that ships with the compiler is stable enough to
+  // be worth caching; user files change on nearly every compile.
+  if (modTag != MOD_INTERNAL && modTag != MOD_STANDARD)
+    return false;
+
+  // Token counting and chpldoc want the lexer's side effects, not just
+  // the token stream.
+  if (countTokens == true || printTokens == true || fDocs == true)
+    return false;
+
+  return true;
+}
+
+/************************************* | **************************************
+*                                                                             *
+* Recording                                                                   *
+*                                                                             *
+************************************** | *************************************/
+
+void tokenCacheStartRecording() {
+  sRecorded.clear();
+  sRecording = true;
+}
+
+void tokenCacheRecordToken(int            lexerStatus,
+                           const YYSTYPE* yylval,
+                           const YYLTYPE* yylloc,
+                           const char*    rawText) {
+  if (sRecording == false)
+    return;
+
+  // Newlines only advance chplLineno, which the next record restores.
+  if (lexerStatus == YYLEX_NEWLINE)
+    return;
+
+  CachedToken tok;
+
+  tok.status = lexerStatus;
+  tok.line   = chplLineno;
+  tok.loc    = *yylloc;
+  tok.raw    = (rawText != NULL) ? rawText : "";
+
+  if (lexerStatus > 0 || lexerStatus == YYLEX_BLOCK_COMMENT)
+    tok.pch = yylval->pch;
+  else
+    tok.pch = NULL;
+
+  sRecorded.push_back(tok);
+}
+
+void tokenCacheStopRecording(const char* path, ModTag modTag, bool keep) {
+  if (sRecording == false)
+    return;
+
+  sRecording = false;
+
+  if (keep == true) {
+    std::string entry = cacheEntryPath(path, modTag);
+
+    if (entry.empty() == false) {
+      ensureDirExists(tokenCacheDir, "ensuring token cache directory exists");
+
+      // Write to a temporary name and rename so that racing compiles
+      // never observe a partial entry.
+      std::string tmp = entry + ".tmp";
+
+      if (FILE* fp = fopen(tmp.c_str(), "wb")) {
+        uint64_t magic = TOKEN_CACHE_MAGIC;
+
+        fwrite(&magic, sizeof(magic), 1, fp);
+        writeU32(fp, TOKEN_CACHE_VERSION);
+        writeU32(fp, (uint32_t) sRecorded.size());
+
+        for (size_t i = 0; i < sRecorded.size(); i++) {
+          const CachedToken& tok = sRecorded[i];
+
+          writeU32(fp, (uint32_t) tok.status);
+          writeU32(fp, (uint32_t) tok.line);
+          writeU32(fp, (uint32_t) tok.loc.first_line);
+          writeU32(fp, (uint32_t) tok.loc.first_column);
+          writeU32(fp, (uint32_t) tok.loc.last_line);
+          writeU32(fp, (uint32_t) tok.loc.last_column);
+
+          if (tok.pch != NULL)
+            writeStr(fp, tok.pch, strlen(tok.pch));
+          else
+            writeU32(fp, 0xffffffffu);
+
+          writeStr(fp, tok.raw.c_str(), tok.raw.size());
+        }
+
+        bool ok = (ferror(fp) == 0);
+
+        fclose(fp);
+
+        if (ok == true)
+          rename(tmp.c_str(), entry.c_str());
+        else
+          remove(tmp.c_str());
+      }
+    }
+  }
+
+  sRecorded.clear();
+}
+
+/************************************* | **************************************
+*                                                                             *
+* Replay                                                                      *
+*                                                                             *
+************************************** | *************************************/
+
+static bool readStr(FILE* fp, const char** sOut, std::string* raw) {
+  uint32_t len = 0;
+
+  if (readU32(fp, &len) == false)
+    return false;
+
+  if (sOut != NULL && len == 0xffffffffu) {
+    *sOut = NULL;
+    return true;
+  }
+
+  std::string buf(len, '\0');
+
+  if (len > 0 && fread(&buf[0], 1, len, fp) != len)
+    return false;
+
+  if (sOut != NULL)
+    *sOut = astr(buf.c_str());
+  else
+    *raw = buf;
+
+  return true;
+}
+
+static bool loadEntry(const char* entry, std::vector<CachedToken>& toks) {
+  FILE* fp = fopen(entry, "rb");
+
+  if (fp == NULL)
+    return false;
+
+  uint64_t magic   = 0;
+  uint32_t version = 0;
+  uint32_t count   = 0;
+  bool     ok      = fread(&magic, sizeof(magic), 1, fp) == 1 &&
+                     magic == TOKEN_CACHE_MAGIC               &&
+                     readU32(fp, &version)                    &&
+                     version == TOKEN_CACHE_VERSION           &&
+                     readU32(fp, &count);
+
+  for (uint32_t i = 0; ok == true && i < count; i++) {
+    CachedToken tok;
+    uint32_t    field = 0;
+
+    ok = readU32(fp, &field);
+    tok.status = (int) field;
+
+    ok = ok && readU32(fp, &field);
+    tok.line = (int) field;
+
+    ok = ok && readU32(fp, &field);
+    tok.loc.first_line = (int) field;
+
+    ok = ok && readU32(fp, &field);
+    tok.loc.first_column = (int) field;
+
+    ok = ok && readU32(fp, &field);
+    tok.loc.last_line = (int) field;
+
+    ok = ok && readU32(fp, &field);
+    tok.loc.last_column = (int) field;
+
+    ok = ok && readStr(fp, &tok.pch, NULL);
+    ok = ok && readStr(fp, NULL, &tok.raw);
+
+    if (ok == true)
+      toks.push_back(tok);
+  }
+
+  fclose(fp);
+
+  return ok;
+}
+
+//
+// Reproduce the captureString side effects of processToken() and
+// processStringLiteral() for one replayed token; see chapel.lex.
+//
+static void emulateCapture(const CachedToken& tok) {
+  if (captureTokens == 0)
+    return;
+
+  if (tok.status == STRINGLITERAL  ||
+      tok.status == BYTESLITERAL   ||
+      tok.status == CSTRINGLITERAL) {
+    captureString.append(tok.raw);
+    captureString.append(tok.pch);
+    captureString.append(tok.raw);
+    return;
+  }
+
+  if (tok.status == TASSIGN ||
+      tok.status == TDOTDOTDOT) {
+    captureString.push_back(' ');
+  }
+
+  if (tok.status != TLCBR && tok.status != TRETURN) {
+    captureString.append(tok.raw);
+  }
+
+  if (tok.status == TCOMMA  ||
+      tok.status == TPARAM  ||
+      tok.status == TZIP    ||
+      tok.status == TTYPE   ||
+      tok.status == TCONST  ||
+      tok.status == TIN     ||
+      tok.status == TINOUT  ||
+      tok.status == TOUT    ||
+      tok.status == TREF    ||
+      tok.status == TCOLON  ||
+      tok.status == TASSIGN ||
+      tok.status == TRSBR ||
+      tok.status == TBORROWED ||
+      tok.status == TUNMANAGED ||
+      tok.status == TOWNED ||
+      tok.status == TSHARED) {
+    captureString.push_back(' ');
+  }
+}
+
+bool tokenCacheReplay(const char*    path,
+                      ModTag         modTag,
+                      yypstate*      parser,
+                      ParserContext* context,
+                      int*           parserStatus) {
+  std::string entry = cacheEntryPath(path, modTag);
+
+  if (entry.empty() == true)
+    return false;
+
+  std::vector<CachedToken> toks;
+
+  if (loadEntry(entry.c_str(), toks) == false)
+    return false;
+
+  for (size_t i = 0; i < toks.size() && *parserStatus == YYPUSH_MORE; i++) {
+    const CachedToken& tok = toks[i];
+    YYLTYPE            yylloc = tok.loc;
+
+    chplLineno = tok.line;
+
+    if (tok.status >= 0) {
+      YYSTYPE yylval;
+
+      yylval.pch = tok.pch;
+
+      emulateCapture(tok);
+
+      *parserStatus = yypush_parse(parser,
+                                   tok.status,
+                                   &yylval,
+                                   &yylloc,
+                                   context);
+
+    } else if (tok.status == YYLEX_BLOCK_COMMENT) {
+      context->latestComment = tok.pch;
+    } else if (tok.status == YYLEX_SINGLE_LINE_COMMENT) {
+      context->latestComment = NULL;
+    }
+  }
+
+  return true;
+}
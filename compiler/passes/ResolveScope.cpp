@@ -53,9 +53,13 @@
 #include "stringutil.h"
 #include "view.h"
 
+#include <unordered_map>
+
 ResolveScope* rootScope;
 
-static std::map<BaseAST*, ResolveScope*> sScopeMap;
+// Keyed by pointer and queried for every lookup chain the pass walks,
+// so use a hash map; nothing iterates it in an order-sensitive way.
+static std::unordered_map<BaseAST*, ResolveScope*> sScopeMap;
 
 ResolveScope* ResolveScope::getRootModule() {
   ResolveScope* retval = new ResolveScope(theProgram, NULL);
@@ -102,8 +106,8 @@ ResolveScope* ResolveScope::findOrCreateScopeFor(DefExpr* def) {
 }
 
 ResolveScope* ResolveScope::getScopeFor(BaseAST* ast) {
-  std::map<BaseAST*, ResolveScope*>::iterator it;
-  ResolveScope*                               retval = NULL;
+  std::unordered_map<BaseAST*, ResolveScope*>::iterator it;
+  ResolveScope*                                         retval = NULL;
 
   it = sScopeMap.find(ast);
 
@@ -115,7 +119,7 @@ ResolveScope* ResolveScope::getScopeFor(BaseAST* ast) {
 }
 
 void ResolveScope::destroyAstMap() {
-  std::map<BaseAST*, ResolveScope*>::iterator it;
+  std::unordered_map<BaseAST*, ResolveScope*>::iterator it;
 
   for (it = sScopeMap.begin(); it != sScopeMap.end(); it++) {
     delete it->second;
@@ -30,16 +30,28 @@
 //
 // This pass must be run after parallel().
 //
+// Under --parallel-module-init, the chains of initializer calls are
+// replaced for most modules by a runtime task graph (chpl-taskgraph.h)
+// so that modules with no use/import relationship initialize
+// concurrently.  See addParallelInitDriver() below.
+//
 
 #include "passes.h"
 
 #include "astutil.h"
 #include "build.h"
+#include "driver.h"
 #include "stmt.h"
 #include "stringutil.h"
 #include "wellknown.h"
 
+#include <map>
+#include <set>
+#include <vector>
+
 static void addModuleInitBlocks();
+static void collectSerialInitModules(std::set<ModuleSymbol*>& serial);
+static void addParallelInitDriver();
 static void addInitGuards();
 static void addInitGuard(FnSymbol* fn, FnSymbol* preInitFn);
 static void addPrintModInitOrder(FnSymbol* fn);
@@ -47,11 +59,21 @@ static void addPrintModInitOrder(FnSymbol* fn);
 void addInitCalls()
 {
   addModuleInitBlocks();
+  if (fParallelModuleInit)
+    addParallelInitDriver();
   addInitGuards();
 }
 
 
 void addModuleInitBlocks() {
+  ModuleSymbol* mainMod = NULL;
+  std::set<ModuleSymbol*> serialMods;
+
+  if (fParallelModuleInit) {
+    mainMod = ModuleSymbol::mainModule();
+    collectSerialInitModules(serialMods);
+  }
+
   forv_Vec(ModuleSymbol, mod, gModuleSymbols) {
     // Not for the root module
     if (mod == rootModule) continue;
@@ -65,6 +87,13 @@ void addModuleInitBlocks() {
     }
 
     SET_LINENO(mod);
+
+    // Modules handed to the init task graph get their ordering (and
+    // their addModule() calls, which must stay serialized) from the
+    // driver inserted by addParallelInitDriver() instead of here.
+    if (fParallelModuleInit && mod != mainMod && serialMods.count(mod) == 0)
+      continue;
+
     if (mod->deinitFn)
       // This needs to go after initBlock: we want addModule(mod)
       // to be called *after* addModule on modules used by mod.
@@ -94,6 +123,276 @@ void addModuleInitBlocks() {
 }
 
 
+//
+// The initializer for theProgram is called from main.c before
+// chpl_gen_main() runs, so it and everything it reaches must keep the
+// serial call-chain treatment; collect that closure here.  By
+// construction every dependence of a serial module is itself serial,
+// so serial initializers never reach into the task graph.
+//
+static void collectSerialInitModules(std::set<ModuleSymbol*>& serial) {
+  std::vector<ModuleSymbol*> work;
+
+  serial.insert(theProgram);
+  work.push_back(theProgram);
+
+  // The dependence chains skip standardModule (see addModuleInitBlocks),
+  // so keep its initializer on the serial side as well.
+  if (standardModule && standardModule->initFn &&
+      serial.insert(standardModule).second)
+    work.push_back(standardModule);
+
+  while (!work.empty()) {
+    ModuleSymbol* mod = work.back();
+    work.pop_back();
+
+    std::vector<ModuleSymbol*> deps;
+    if (ModuleSymbol* parent = mod->defPoint->getModule())
+      if (parent != rootModule)
+        deps.push_back(parent);
+    for_vector(ModuleSymbol, usedMod, mod->modUseList)
+      deps.push_back(usedMod);
+
+    for_vector(ModuleSymbol, dep, deps)
+      if (dep->initFn && serial.insert(dep).second)
+        work.push_back(dep);
+  }
+}
+
+
+//
+// --parallel-module-init: initialize independent modules concurrently.
+//
+// The serial scheme makes module initialization a single chain of
+// calls even though most modules only depend on a few others.  Here
+// we build the dependence graph over the remaining (non-serial, non-
+// main) module initializers and hand it to the runtime's dependence-
+// aware task graph (chpl-taskgraph.h).  Cyclic use/import chains are
+// condensed into strongly connected components; each component
+// becomes one graph node whose wrapper function calls its members'
+// initializers in program order.  The driver -- create the graph, add
+// nodes and edges, start them, wait -- is inserted at the head of the
+// main module's initializer, so every initializer has completed
+// before the main module's own statements run.  Any initializer calls
+// remaining elsewhere (e.g. the main module's dependence block) are
+// made harmless by the idempotency guards added below.
+//
+// addModule() maintains a Chapel-side list that is not thread-safe,
+// so for graph modules those calls are issued serially after the
+// wait, dependences first, preserving the serial scheme's
+// deinitialization order (dependences deinitialize last).
+//
+
+static FnSymbol* buildTaskgraphExternFn(const char* name, Type* retType,
+                                        const std::vector<Type*>& formals) {
+  FnSymbol* fn = new FnSymbol(name);
+  fn->addFlag(FLAG_EXTERN);
+  fn->addFlag(FLAG_LOCAL_ARGS);
+  fn->retType = retType;
+  fn->cname = fn->name;
+  for (size_t i = 0; i < formals.size(); i++)
+    fn->insertFormalAtTail(new ArgSymbol(INTENT_BLANK,
+                                         astr("arg", istr((int) i)),
+                                         formals[i]));
+  theProgram->block->insertAtTail(new DefExpr(fn));
+  return fn;
+}
+
+//
+// Tarjan's algorithm.  Because adjacency points from a module to its
+// dependences, components are emitted dependences-first, which is a
+// valid serialization order for the addModule() calls and guarantees
+// that every edge's endpoints exist by the time we wire it.
+//
+static void tarjanVisit(int v,
+                        const std::vector<std::vector<int> >& deps,
+                        std::vector<int>& index,
+                        std::vector<int>& lowlink,
+                        std::vector<bool>& onStack,
+                        std::vector<int>& stack,
+                        std::vector<int>& sccOf,
+                        int& nextIndex,
+                        int& numSccs) {
+  index[v] = lowlink[v] = nextIndex++;
+  stack.push_back(v);
+  onStack[v] = true;
+
+  for (size_t i = 0; i < deps[v].size(); i++) {
+    int w = deps[v][i];
+    if (index[w] == -1) {
+      tarjanVisit(w, deps, index, lowlink, onStack, stack, sccOf,
+                  nextIndex, numSccs);
+      if (lowlink[w] < lowlink[v]) lowlink[v] = lowlink[w];
+    } else if (onStack[w]) {
+      if (index[w] < lowlink[v]) lowlink[v] = index[w];
+    }
+  }
+
+  if (lowlink[v] == index[v]) {
+    int w;
+    do {
+      w = stack.back();
+      stack.pop_back();
+      onStack[w] = false;
+      sccOf[w] = numSccs;
+    } while (w != v);
+    numSccs++;
+  }
+}
+
+static void addParallelInitDriver() {
+  ModuleSymbol* mainMod = ModuleSymbol::mainModule();
+  FnSymbol* mainFn = toFnSymbol(mainMod->initFn);
+  INT_ASSERT(mainFn);
+
+  std::set<ModuleSymbol*> serialMods;
+  collectSerialInitModules(serialMods);
+
+  // The graph covers every initializer not already run serially
+  // before chpl_gen_main() and not the main module's own, which runs
+  // inline after the graph completes.
+  std::vector<ModuleSymbol*> graphMods;
+  std::map<ModuleSymbol*, int> graphIdx;
+  forv_Vec(ModuleSymbol, mod, gModuleSymbols) {
+    if (mod == rootModule || mod == mainMod) continue;
+    if (!toFnSymbol(mod->initFn)) continue;
+    if (serialMods.count(mod)) continue;
+    graphIdx[mod] = (int) graphMods.size();
+    graphMods.push_back(mod);
+  }
+
+  if (graphMods.empty()) return;
+
+  int n = (int) graphMods.size();
+  std::vector<std::vector<int> > deps(n);
+  for (int v = 0; v < n; v++) {
+    ModuleSymbol* mod = graphMods[v];
+    std::set<int> seen;
+    if (ModuleSymbol* parent = mod->defPoint->getModule()) {
+      std::map<ModuleSymbol*, int>::iterator it = graphIdx.find(parent);
+      if (it != graphIdx.end()) seen.insert(it->second);
+    }
+    for_vector(ModuleSymbol, usedMod, mod->modUseList) {
+      std::map<ModuleSymbol*, int>::iterator it = graphIdx.find(usedMod);
+      if (it != graphIdx.end()) seen.insert(it->second);
+    }
+    seen.erase(v);
+    deps[v].assign(seen.begin(), seen.end());
+  }
+
+  // Condense cyclic use/import chains into components.
+  std::vector<int> index(n, -1);
+  std::vector<int> lowlink(n, 0);
+  std::vector<int> stack;
+  std::vector<int> sccOf(n, -1);
+  std::vector<bool> onStack(n, false);
+  int nextIndex = 0;
+  int numSccs = 0;
+  for (int v = 0; v < n; v++)
+    if (index[v] == -1)
+      tarjanVisit(v, deps, index, lowlink, onStack, stack, sccOf,
+                  nextIndex, numSccs);
+
+  // Members per component, in program order, and the component-level
+  // dependences, deduplicated.
+  std::vector<std::vector<ModuleSymbol*> > members(numSccs);
+  std::vector<std::set<int> > sccDeps(numSccs);
+  for (int v = 0; v < n; v++) {
+    members[sccOf[v]].push_back(graphMods[v]);
+    for (size_t i = 0; i < deps[v].size(); i++)
+      if (sccOf[deps[v][i]] != sccOf[v])
+        sccDeps[sccOf[v]].insert(sccOf[deps[v][i]]);
+  }
+
+  SET_LINENO(mainFn);
+
+  // One wrapper function per component.  FLAG_EXPORT without
+  // FLAG_INSERT_LINE_FILE_INFO keeps insertLineNumbers from adding
+  // formals, so the generated signature matches chpl_fn_p.
+  std::vector<FnSymbol*> wrappers(numSccs);
+  for (int s = 0; s < numSccs; s++) {
+    FnSymbol* wrap = new FnSymbol(astr("chpl__init_task", istr(s)));
+    wrap->retType = dtVoid;
+    wrap->cname = wrap->name;
+    wrap->addFlag(FLAG_EXPORT);
+    wrap->addFlag(FLAG_LOCAL_ARGS);
+    wrap->addFlag(FLAG_COMPILER_GENERATED);
+    wrap->insertFormalAtTail(new ArgSymbol(INTENT_BLANK, "arg", dtCVoidPtr));
+    theProgram->block->insertAtTail(new DefExpr(wrap));
+    normalize(wrap);
+    for_vector(ModuleSymbol, member, members[s])
+      wrap->insertBeforeEpilogue(new CallExpr(member->initFn));
+    wrappers[s] = wrap;
+  }
+
+  std::vector<Type*> noArgs;
+  std::vector<Type*> oneArg(1, dtCVoidPtr);
+  std::vector<Type*> twoArgs(2, dtCVoidPtr);
+  std::vector<Type*> nodeArgs;
+  nodeArgs.push_back(dtCVoidPtr);
+  nodeArgs.push_back(dtCFnPtr);
+  nodeArgs.push_back(dtCVoidPtr);
+  nodeArgs.push_back(dtInt[INT_SIZE_32]);
+
+  FnSymbol* createFn =
+    buildTaskgraphExternFn("chpl_taskgraph_create", dtCVoidPtr, noArgs);
+  FnSymbol* nodeFn =
+    buildTaskgraphExternFn("chpl_taskgraph_node", dtCVoidPtr, nodeArgs);
+  FnSymbol* edgeFn =
+    buildTaskgraphExternFn("chpl_taskgraph_edge", dtVoid, twoArgs);
+  FnSymbol* startFn =
+    buildTaskgraphExternFn("chpl_taskgraph_start", dtVoid, oneArg);
+  FnSymbol* waitFn =
+    buildTaskgraphExternFn("chpl_taskgraph_wait", dtVoid, oneArg);
+  FnSymbol* destroyFn =
+    buildTaskgraphExternFn("chpl_taskgraph_destroy", dtVoid, oneArg);
+
+  BlockStmt* driver = new BlockStmt();
+
+  VarSymbol* graphTmp = newTemp("init_graph", dtCVoidPtr);
+  driver->insertAtTail(new DefExpr(graphTmp));
+  driver->insertAtTail(new CallExpr(PRIM_MOVE, graphTmp,
+                                    new CallExpr(createFn)));
+
+  std::vector<VarSymbol*> nodeTmps(numSccs);
+  for (int s = 0; s < numSccs; s++) {
+    VarSymbol* nodeTmp = newTemp(astr("init_node", istr(s)), dtCVoidPtr);
+    driver->insertAtTail(new DefExpr(nodeTmp));
+    driver->insertAtTail(
+      new CallExpr(PRIM_MOVE, nodeTmp,
+                   new CallExpr(nodeFn, graphTmp, wrappers[s], gNil,
+                                new_IntSymbol((int) sccDeps[s].size(),
+                                              INT_SIZE_32))));
+    nodeTmps[s] = nodeTmp;
+  }
+
+  for (int s = 0; s < numSccs; s++)
+    for (std::set<int>::iterator it = sccDeps[s].begin();
+         it != sccDeps[s].end(); ++it)
+      driver->insertAtTail(new CallExpr(edgeFn, nodeTmps[*it], nodeTmps[s]));
+
+  for (int s = 0; s < numSccs; s++)
+    driver->insertAtTail(new CallExpr(startFn, nodeTmps[s]));
+
+  driver->insertAtTail(new CallExpr(waitFn, graphTmp));
+
+  if (gAddModuleFn != NULL) {
+    for (int s = 0; s < numSccs; s++) {
+      for_vector(ModuleSymbol, member, members[s]) {
+        if (member->deinitFn)
+          driver->insertAtTail(new CallExpr(gAddModuleFn,
+                                            buildCStringLiteral(member->name),
+                                            member->deinitFn));
+      }
+    }
+  }
+
+  driver->insertAtTail(new CallExpr(destroyFn, graphTmp));
+
+  mainFn->insertAtHead(driver);
+}
+
+
 // This function makes the initialization functions idempotent --
 // meaning that they can be executed any number of times, but the net
 // effect is as if they were only called once.  That is done using the
@@ -28,6 +28,7 @@
 #include "driver.h"
 #include "expr.h"
 #include "iterator.h"
+#include "parallelPasses.h"
 #include "stmt.h"
 #include "stlUtil.h"
 #include "stringutil.h"
@@ -67,6 +68,7 @@ static void checkForClassAssignOps(FnSymbol* fn) {
       Type* formalType = formal->type->getValType();
       if (isOwnedOrSharedOrBorrowed(formalType) ||
           isUnmanagedClass(formalType)) {
+        ParDiagGuard guard;
         USR_FATAL_CONT(fn, "Can't overload assignments for class types");
       }
     }
@@ -75,7 +77,10 @@ static void checkForClassAssignOps(FnSymbol* fn) {
 
 void
 checkResolved() {
-  forv_Vec(FnSymbol, fn, gFnSymbols) {
+  // The per-function and per-type checks below are read-only apart
+  // from issuing diagnostics, so they run under parForVec(); every
+  // USR_* call in their call trees holds a ParDiagGuard.
+  parForVec(gFnSymbols, [](FnSymbol* fn) {
     checkForClassAssignOps(fn);
     checkReturnPaths(fn);
     if (fn->retType->symbol->hasFlag(FLAG_ITERATOR_RECORD) &&
@@ -89,14 +94,17 @@ checkResolved() {
         // to generate it. (Otherwise the iterator expression is turned
         // into an array in the process of being returned).
         // If we remove FLAG_FN_RETURNS_ITERATOR, we should remove this error.
+        ParDiagGuard guard;
         USR_FATAL_CONT(fn, "functions cannot return nested iterators or loop expressions");
       }
     }
-    if (fn->hasFlag(FLAG_ASSIGNOP) && fn->retType != dtVoid)
+    if (fn->hasFlag(FLAG_ASSIGNOP) && fn->retType != dtVoid) {
+      ParDiagGuard guard;
       USR_FATAL(fn, "The return value of an assignment operator must be 'void'.");
-  }
+    }
+  });
 
-  forv_Vec(TypeSymbol, type, gTypeSymbols) {
+  parForVec(gTypeSymbols, [](TypeSymbol* type) {
     if (EnumType* et = toEnumType(type->type)) {
       std::set<std::string> enumVals;
       for_enums(def, et) {
@@ -104,12 +112,14 @@ checkResolved() {
           SymExpr* sym = toSymExpr(def->init);
           if (!sym || (!sym->symbol()->hasFlag(FLAG_PARAM) &&
                        !toVarSymbol(sym->symbol())->immediate)) {
+            ParDiagGuard guard;
             USR_FATAL_CONT(def, "enumerator '%s' is not an integer param value",
                            def->sym->name);
           } else if (fWarnUnstable) {
             Immediate* imm = toVarSymbol(sym->symbol())->immediate;
             std::string enumVal = imm->to_string();
             if (enumVals.count(enumVal) != 0) {
+              ParDiagGuard guard;
               USR_WARN(sym, "it has been suggested that support for enums "
                        "with duplicate integer values should be deprecated, "
                        "so this enum could be considered unstable; if you "
@@ -121,7 +131,7 @@ checkResolved() {
         }
       }
     }
-  }
+  });
   // check for no record deletes, no invalid PRIM_ADDR_OF
   checkCalls();
   checkConstLoops();
@@ -405,12 +415,14 @@ checkBadLocalReturn(FnSymbol* fn, Symbol* retVar) {
             // Check: Are we returning a local variable by ref?
             if (ret->symbol()->defPoint->getFunction() == fn &&
                 !returnsRefArgumentByRef(rhsCall, fn)) {
+              ParDiagGuard guard;
               USR_FATAL_CONT(ret, "illegal expression to return by ref");
             } else {
               // Check: Are we returning a constant by ref?
               if (fn->retTag == RET_REF &&
                   (ret->symbol()->isConstant() ||
                    ret->symbol()->isParameter())) {
+                ParDiagGuard guard;
                 USR_FATAL_CONT(rhs, "function cannot return constant by ref");
               }
             }
@@ -437,6 +449,7 @@ checkBadLocalReturn(FnSymbol* fn, Symbol* retVar) {
           isVarSymbol(rhsSe->symbol()) &&
           rhsSe->symbol()->defPoint->getFunction() == fn &&
           !rhsSe->isRef()) {
+        ParDiagGuard guard;
         USR_FATAL_CONT(rhsSe, "illegal return of array aliasing a local array");
       }
     }
@@ -475,8 +488,10 @@ checkReturnPaths(FnSymbol* fn) {
   //
   // Issue a warning if there is a path that has zero definitions.
   //
-  if (result == 0)
+  if (result == 0) {
+    ParDiagGuard guard;
     USR_FATAL_CONT(fn->body, "control reaches end of function that returns a value");
+  }
 
   //
   // Issue an error if returning a local variable by ref.
@@ -522,11 +537,14 @@ checkBadAddrOf(CallExpr* call)
           rhsType = true;
 
         if (lhsRef && rhsType) {
+          ParDiagGuard guard;
           USR_FATAL_CONT(call, "Cannot set a reference to a type variable.");
         } else if (lhsRef && rhsParam) {
+          ParDiagGuard guard;
           USR_FATAL_CONT(call, "Cannot set a reference to a param variable.");
         } else if (lhsRef && !lhsConst) {
           if (rhsExprTemp || rhs->symbol()->isConstant()) {
+            ParDiagGuard guard;
             USR_FATAL_CONT(call, "Cannot set a non-const reference to a const variable.");
           }
         }
@@ -539,8 +557,7 @@ checkBadAddrOf(CallExpr* call)
 static void
 checkCalls()
 {
-  forv_Vec(CallExpr, call, gCallExprs)
-    checkBadAddrOf(call);
+  parForVec(gCallExprs, checkBadAddrOf);
 }
 
 
@@ -677,6 +677,38 @@ bool isAtomicFunctionWithOrderArgument(FnSymbol* fnSymbol, ArgSymbol** order = N
   return false;
 }
 
+//
+// Is this outlined 'begin' body a plausible candidate for the tasking
+// layer's run-to-completion fast path? At this point in compilation we
+// can only screen syntactically: reject bodies that contain further
+// task or on constructs, since those certainly spawn or communicate.
+// The surviving candidates are re-checked against the resolved AST late
+// in compilation (see optimizeForallUnorderedOps.cpp), which prunes the
+// ones that may actually block.
+//
+static bool taskFnLooksNonBlocking(FnSymbol* fn) {
+  std::vector<BaseAST*> asts;
+  collect_asts(fn->body, asts);
+  for_vector(BaseAST, ast, asts) {
+    if (BlockStmt* block = toBlockStmt(ast)) {
+      if (block->isLoopStmt())
+        continue; // loops are not task constructs; guards blockInfoGet()
+      if (CallExpr* info = block->blockInfoGet()) {
+        if (info->isPrimitive(PRIM_BLOCK_BEGIN)       ||
+            info->isPrimitive(PRIM_BLOCK_COBEGIN)     ||
+            info->isPrimitive(PRIM_BLOCK_COFORALL)    ||
+            info->isPrimitive(PRIM_BLOCK_ON)          ||
+            info->isPrimitive(PRIM_BLOCK_ELIDED_ON)   ||
+            info->isPrimitive(PRIM_BLOCK_BEGIN_ON)    ||
+            info->isPrimitive(PRIM_BLOCK_COBEGIN_ON)  ||
+            info->isPrimitive(PRIM_BLOCK_COFORALL_ON))
+          return false;
+      }
+    }
+  }
+  return true;
+}
+
 //
 // Converts blocks implementing various task constructs into
 // functions, so they can be invoked by a separate task.
@@ -927,6 +959,13 @@ void createTaskFunctions(void) {
           addVarsToFormalsActuals(fn, uses, call, isCoforall);
           replaceVarUses(fn->body, uses);
         }
+
+        // Mark plain 'begin' bodies that look like ultra-fine
+        // non-blocking work, so the tasking layer can run them on a
+        // preallocated descriptor instead of a heap-allocated one.
+        if (info->isPrimitive(PRIM_BLOCK_BEGIN) &&
+            taskFnLooksNonBlocking(fn))
+          fn->addFlag(FLAG_TASK_FN_NON_BLOCKING);
       } // if fn
     } // if blockInfo
 
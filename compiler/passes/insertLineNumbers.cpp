@@ -24,6 +24,7 @@
 #include "driver.h"
 #include "expr.h"
 #include "passes.h"
+#include "passResources.h"
 #include "stlUtil.h"
 #include "stmt.h"
 #include "stringutil.h"
@@ -87,6 +88,32 @@ static std::queue<FnSymbol*> queue;
 static Map<FnSymbol*,ArgSymbol*> linenoMap; // fn to line number argument
 static Map<FnSymbol*,ArgSymbol*> filenameMap; // fn to filename argument
 
+static void retireLineFileMaps() {
+  linenoMap.clear();
+  filenameMap.clear();
+}
+
+static size_t lineFileMapsSize() {
+  return (linenoMap.count() + filenameMap.count()) *
+         sizeof(MapElem<FnSymbol*, ArgSymbol*>);
+}
+
+static void retireFilenameLookupCache() {
+  gFilenameLookupCache.clear();
+}
+
+static size_t filenameLookupCacheSize() {
+  size_t retval = 0;
+
+  for (std::map<std::string, int>::iterator it = gFilenameLookupCache.begin();
+       it != gFilenameLookupCache.end();
+       ++it) {
+    retval += it->first.capacity() + sizeof(int) + 4 * sizeof(void*);
+  }
+
+  return retval;
+}
+
 static ArgSymbol* newLine(FnSymbol* fn) {
   ArgSymbol* line = new ArgSymbol(INTENT_CONST_IN, "_ln", dtInt[INT_SIZE_DEFAULT]);
   fn->insertFormalAtTail(line);
@@ -291,6 +318,12 @@ static void insertNilChecks() {
 }
 
 void insertLineNumbers() {
+  registerPassResource("insertLineNumbers line/file maps", "insertLineNumbers",
+                       retireLineFileMaps, lineFileMapsSize);
+
+  registerPassResource("filename lookup cache", "codegen",
+                       retireFilenameLookupCache, filenameLookupCacheSize);
+
   compute_call_sites();
 
   // Temporary vector that stores some constant filenames that are used
@@ -579,9 +579,52 @@ static void printCauses(Symbol* sym) {
 }
 
 
+//
+// Interprocedural locality inference: functions whose every call site
+// sits under a 'local' block -- directly, or transitively inside
+// another such function -- can only ever execute on data the user has
+// asserted to be local.  Their class-typed formals are kept narrow
+// when the wideness would otherwise arrive from a caller's actual;
+// narrowWideClassesThroughCalls() bridges any remaining wide actuals
+// at the call sites with a checked narrowing temp, the same way
+// 'local' blocks themselves localize communication primitives.
+// Wideness arising inside the function's own body (e.g. from a
+// module-scope variable used in an on-statement) still propagates
+// normally, so this never manufactures a narrow variable holding
+// possibly-remote data.
+//
+static std::set<FnSymbol*> localCallGraphFns;
+
+static bool isLocalCallGraphFn(FnSymbol* fn) {
+  return localCallGraphFns.count(fn) != 0;
+}
+
+//
+// Is 'cause' an actual at a call site of the function defining the
+// formal 'sym'?  If so, the wideness is flowing in from a caller
+// rather than from the function's own body.
+//
+static bool isWideningFromCaller(BaseAST* cause, Symbol* sym) {
+  if (SymExpr* act = toSymExpr(cause)) {
+    if (CallExpr* call = toCallExpr(act->parentExpr)) {
+      if (act != call->baseExpr &&
+          call->resolvedFunction() == sym->defPoint->parentSymbol) {
+        return actual_to_formal(act) == sym;
+      }
+    }
+  }
+  return false;
+}
+
 static void setWide(BaseAST* cause, Symbol* sym) {
   if (!typeCanBeWide(sym)) return;
   if (isArgSymbol(sym) && sym->defPoint->parentSymbol->hasFlag(FLAG_LOCAL_ARGS)) return;
+  if (isArgSymbol(sym) && !sym->isRefOrWideRef() &&
+      isLocalCallGraphFn(toFnSymbol(sym->defPoint->parentSymbol)) &&
+      isWideningFromCaller(cause, sym)) {
+    debug(sym, "formal of a local-only fn, stays narrow\n");
+    return;
+  }
   if (isVarSymbol(sym) && sym->defPoint->parentSymbol->hasFlag(FLAG_ARRAY) && !fNoInferLocalFields) {
     // Do not widen the '_instance' field of an _array record
     return;
@@ -867,6 +910,81 @@ static void widenSubAggregateTypes(BaseAST* cause, Type* parent) {
 }
 
 
+//
+// Is this call nested somewhere under a 'local' block?
+//
+static bool callIsUnderLocalBlock(CallExpr* call) {
+  for (Expr* cur = call->parentExpr; cur != NULL; cur = cur->parentExpr) {
+    if (isLocalBlock(cur)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+//
+// Populate localCallGraphFns with the functions that can only execute
+// under a 'local' block.  Candidates are ordinary resolved functions
+// with known call sites; anything callable from outside the visible
+// call graph -- exported functions, ftable-invoked task and on-stmt
+// wrappers, virtually dispatched methods -- never qualifies.  The set
+// then shrinks to a fixed point: a function stays in only while every
+// one of its call sites is under a local block or inside another
+// function still in the set, so whole call trees hanging off a local
+// block qualify together (including mutual recursion).
+//
+static void inferLocalCallGraphFns() {
+  if (fNoInferLocalCalls) return;
+
+  std::set<FnSymbol*> candidates;
+
+  forv_Vec(FnSymbol, fn, gFnSymbols) {
+    if (fn->hasEitherFlag(FLAG_EXTERN, FLAG_EXPORT)) continue;
+    if (fn->hasFlag(FLAG_VIRTUAL)) continue;
+    if (fn->hasFlag(FLAG_ON_BLOCK) ||
+        fn->hasFlag(FLAG_BEGIN_BLOCK) ||
+        fn->hasFlag(FLAG_COBEGIN_OR_COFORALL_BLOCK)) continue;
+    if (fn->calledBy->n == 0) continue;
+    candidates.insert(fn);
+  }
+
+  forv_Vec(FnSymbol, fn, ftableVec) {
+    candidates.erase(fn);
+  }
+
+  bool changed = true;
+  while (changed) {
+    changed = false;
+
+    std::set<FnSymbol*> survivors;
+    for_set(FnSymbol, fn, candidates) {
+      bool allLocal = true;
+      forv_Vec(CallExpr, call, *fn->calledBy) {
+        if (!isAlive(call)) continue;
+        if (call->isPrimitive(PRIM_VIRTUAL_METHOD_CALL) ||
+            (!callIsUnderLocalBlock(call) &&
+             candidates.count(call->getFunction()) == 0)) {
+          allLocal = false;
+          break;
+        }
+      }
+      if (allLocal) {
+        survivors.insert(fn);
+      } else {
+        changed = true;
+      }
+    }
+    candidates.swap(survivors);
+  }
+
+  localCallGraphFns.swap(candidates);
+
+  for_set(FnSymbol, fn, localCallGraphFns) {
+    DEBUG_PRINTF("%s (%d) is callable only from local contexts\n",
+                 fn->cname, fn->id);
+  }
+}
+
 //
 // Widen variables that we don't know how to keep narrow.
 //
@@ -895,22 +1013,26 @@ static void addKnownWides() {
       }
     }
   }
-  forv_Vec(VarSymbol, var, gVarSymbols) {
-    //if (!typeCanBeWide(var)) continue;
-    Symbol* defParent = var->defPoint->parentSymbol;
-
-    //
-    // FLAG_LOCALE_PRIVATE variables can be used within an on-statement without
-    // needing to be wide.
-    //
-    if (isModuleSymbol(defParent) && !var->hasFlag(FLAG_LOCALE_PRIVATE)) {
-      if (FnSymbol* fn = usedInOn(var)) {
-        debug(var, "Module scope variable used in on-statement\n");
-        if (typeCanBeWide(var)) {
-          setWide(fn, var);
-        }
-        if (isRecord(var->type) && !canWidenRecord(var)) {
-          widenSubAggregateTypes(fn, var->type);
+  // If the program has no on-statements at all, no module variable
+  // can be used in one, so skip the per-variable scans entirely.
+  if (!downstreamFromOn.empty()) {
+    forv_Vec(VarSymbol, var, gVarSymbols) {
+      //if (!typeCanBeWide(var)) continue;
+      Symbol* defParent = var->defPoint->parentSymbol;
+
+      //
+      // FLAG_LOCALE_PRIVATE variables can be used within an on-statement
+      // without needing to be wide.
+      //
+      if (isModuleSymbol(defParent) && !var->hasFlag(FLAG_LOCALE_PRIVATE)) {
+        if (FnSymbol* fn = usedInOn(var)) {
+          debug(var, "Module scope variable used in on-statement\n");
+          if (typeCanBeWide(var)) {
+            setWide(fn, var);
+          }
+          if (isRecord(var->type) && !canWidenRecord(var)) {
+            widenSubAggregateTypes(fn, var->type);
+          }
         }
       }
     }
@@ -1449,13 +1571,18 @@ static void narrowWideClassesThroughCalls()
   // that in the call.  After the call, copy the value back into the
   // wide class.
   //
-  // TODO: Can we use this for local functions?
+  // Calls to functions the locality inference proved reachable only
+  // from under 'local' blocks get the same treatment for the
+  // class-typed formals that inference kept narrow.
   //
   forv_Vec(CallExpr, call, gCallExprs) {
     FnSymbol* fn = call->resolvedFunction();
+    bool localOnlyFn = fn != NULL &&
+                       !fn->hasFlag(FLAG_LOCAL_ARGS) &&
+                       isLocalCallGraphFn(fn);
 
     // Find calls to functions expecting local arguments.
-    if (fn && fn->hasFlag(FLAG_LOCAL_ARGS)) {
+    if (fn && (fn->hasFlag(FLAG_LOCAL_ARGS) || localOnlyFn)) {
       SET_LINENO(call);
       Expr* stmt = call->getStmtExpr();
 
@@ -1465,6 +1592,18 @@ static void narrowWideClassesThroughCalls()
         SymExpr* sym = toSymExpr(arg);
         INT_ASSERT(sym);
 
+        if (localOnlyFn) {
+          // Only wide class actuals landing on formals the locality
+          // inference kept narrow need the bridge; references matched
+          // the formal's wideness during propagation.  The call site
+          // is under a local block, so assert locality the way the
+          // block's own localized primitives do.
+          if (sym->isRef() || hasSomeWideness(actual_to_formal(sym)))
+            continue;
+          if (isFullyWide(sym) && !fNoLocalChecks)
+            stmt->insertBefore(new CallExpr(PRIM_LOCAL_CHECK, sym->copy(), buildCStringLiteral("cannot access remote data in local block")));
+        }
+
         // Select symbols with wide types.
         if (isFullyWide(sym)) {
           if (sym->isRef()) {
@@ -2453,17 +2592,22 @@ insertWideReferences(void) {
   buildDefUseMaps(defMap, useMap);
   buildTupleDefsUses();
 
+  inferLocalCallGraphFns();
+
   //
-  // Track functions downstream in the call-chain from a wrapon_fn
+  // Track functions downstream in the call-chain from a wrapon_fn.
+  // Compute each wrapon_fn's closure from its body once, rather than
+  // re-collecting it at every call site.
   //
-  forv_Vec(CallExpr, call, gCallExprs) {
-    if (FnSymbol* fn = call->resolvedFunction()) {
-      if (fn->hasFlag(FLAG_ON_BLOCK) && !fn->hasFlag(FLAG_LOCAL_ON)) { // wrapon_fn
-        std::set<FnSymbol*> downstream;
-        collectUsedFnSymbols(call, downstream);
-        for_set(FnSymbol, on, downstream) {
-          downstreamFromOn[on] = true;
-        }
+  forv_Vec(FnSymbol, fn, gFnSymbols) {
+    if (fn->hasFlag(FLAG_ON_BLOCK) && !fn->hasFlag(FLAG_LOCAL_ON) && // wrapon_fn
+        fn->calledBy->n > 0) {
+      downstreamFromOn[fn] = true;
+
+      std::set<FnSymbol*> downstream;
+      collectUsedFnSymbols(fn->body, downstream);
+      for_set(FnSymbol, on, downstream) {
+        downstreamFromOn[on] = true;
       }
     }
   }
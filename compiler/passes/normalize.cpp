@@ -36,6 +36,7 @@
 #include "library.h"
 #include "LoopExpr.h"
 #include "forallOptimizations.h"
+#include "passResources.h"
 #include "scopeResolve.h"
 #include "splitInit.h"
 #include "stlUtil.h"
@@ -119,6 +120,9 @@ static TypeSymbol* expandTypeAlias(SymExpr* se);
 
 static bool        firstConstructorWarning = true;
 
+static void        retireGlobalTemps();
+static size_t      globalTempsSize();
+
 /************************************* | **************************************
 *                                                                             *
 *                                                                             *
@@ -127,6 +131,9 @@ static bool        firstConstructorWarning = true;
 
 void normalize() {
 
+  registerPassResource("normalize global temps", "normalize",
+                       retireGlobalTemps, globalTempsSize);
+
   insertModuleInit();
 
   doPreNormalizeArrayOptimizations();
@@ -882,6 +889,15 @@ static Symbol* theDefinedSymbol(BaseAST* ast) {
 
 static std::set<VarSymbol*> globalTemps;
 
+static void retireGlobalTemps() {
+  globalTemps.clear();
+}
+
+static size_t globalTempsSize() {
+  // std::set node: key plus parent/child pointers and color
+  return globalTemps.size() * (sizeof(VarSymbol*) + 4 * sizeof(void*));
+}
+
 static void moveGlobalDeclarationsToModuleScope() {
 
   forv_Vec(ModuleSymbol, mod, allModules) {
@@ -2817,7 +2833,9 @@ void normalizeVariableDefinition(DefExpr* defExpr) {
       normVarTypeInference(defExpr);
 
     } else if (type != NULL && init == NULL) {
-      normVarTypeWoutInit(defExpr, false);
+      // Skip default initialization when a loop provably overwrites
+      // every element before any read (see elideArrayDefaultInit).
+      normVarTypeWoutInit(defExpr, elideArrayDefaultInit(defExpr, prevent));
 
     } else if (type != NULL && init != NULL) {
       if (init->isNoInitExpr() == true) {
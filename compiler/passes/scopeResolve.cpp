@@ -2864,6 +2864,129 @@ static void removeUnusedModules() {
   }
 }
 
+/************************************* | **************************************
+*                                                                             *
+* Early use-reachability pruning: before any symbol tables are built, drop    *
+* top-level standard modules that no use/import closure reaches.              *
+*                                                                             *
+* The parser only reads standard modules named by some use/import, but that  *
+* someone may itself end up unreferenced (modules parsed eagerly for          *
+* bootstrapping reasons, or named only from other pruned modules), and every  *
+* parsed module otherwise pays full scope-resolution and normalization        *
+* costs.  A standard module's symbols are only visible through use/import,    *
+* so the syntactic closure is the complete set of ways resolution can reach   *
+* one; internal and user modules are never pruned here.                       *
+*                                                                             *
+************************************** | *************************************/
+
+// The outermost module name a use/import source expression mentions before
+// anything has been resolved: 'use M.N' and 'use M as X' both name M.  When
+// the parser inserted the statement with the module already in hand (the
+// internal auto-uses), it is returned through 'resolved' instead.
+static const char* visStmtOuterName(Expr* src, ModuleSymbol** resolved) {
+  if (UnresolvedSymExpr* use = toUnresolvedSymExpr(src))
+    return use->unresolved;
+
+  if (SymExpr* se = toSymExpr(src)) {
+    *resolved = toModuleSymbol(se->symbol());
+    return NULL;
+  }
+
+  if (CallExpr* call = toCallExpr(src))
+    if (call->isNamedAstr(astrSdot))
+      return visStmtOuterName(call->get(1), resolved);
+
+  return NULL;
+}
+
+static void markReachableModule(
+         std::set<ModuleSymbol*>&                          keep,
+         const std::multimap<const char*, ModuleSymbol*>&  byName,
+         ModuleSymbol*                                     mod) {
+  if (keep.insert(mod).second == false)
+    return;
+
+  std::vector<BaseAST*> asts;
+
+  collect_asts(mod, asts);
+
+  for_vector(BaseAST, ast, asts) {
+    Expr* src = NULL;
+
+    if (UseStmt* use = toUseStmt(ast))
+      src = use->src;
+    else if (ImportStmt* import = toImportStmt(ast))
+      src = import->src;
+
+    if (src == NULL)
+      continue;
+
+    ModuleSymbol* resolved = NULL;
+    const char*   name     = visStmtOuterName(src, &resolved);
+
+    if (resolved != NULL)
+      markReachableModule(keep, byName, resolved);
+
+    if (name != NULL) {
+      // Names can be ambiguous before resolution; keep every candidate.
+      std::pair<std::multimap<const char*, ModuleSymbol*>::const_iterator,
+                std::multimap<const char*, ModuleSymbol*>::const_iterator>
+        range = byName.equal_range(astr(name));
+
+      for (std::multimap<const char*, ModuleSymbol*>::const_iterator it =
+             range.first; it != range.second; ++it)
+        markReachableModule(keep, byName, it->second);
+    }
+  }
+}
+
+static void pruneUnusedStandardModules() {
+  if (fNoEarlyModulePrune)
+    return;
+
+  std::multimap<const char*, ModuleSymbol*> byName;
+  std::vector<ModuleSymbol*>                candidates;
+  std::set<ModuleSymbol*>                   keep;
+
+  forv_Vec(ModuleSymbol, mod, gModuleSymbols) {
+    if (mod->defPoint == NULL || mod->inTree() == false)
+      continue;
+
+    if (mod->defPoint->getModule() == theProgram) {
+      byName.insert(std::make_pair(mod->name, mod));
+
+      if (mod->modTag == MOD_STANDARD &&
+          mod->hasFlag(FLAG_MODULE_INCLUDED_BY_DEFAULT) == false)
+        candidates.push_back(mod);
+    }
+  }
+
+  // Seed with everything that is not a candidate for pruning; only the
+  // use/import closure from there can make a standard module visible.
+  forv_Vec(ModuleSymbol, mod, gModuleSymbols) {
+    if (mod->defPoint == NULL || mod->inTree() == false)
+      continue;
+
+    if (mod->modTag != MOD_STANDARD ||
+        mod->hasFlag(FLAG_MODULE_INCLUDED_BY_DEFAULT) == true)
+      markReachableModule(keep, byName, mod);
+  }
+
+  int nPruned = 0;
+
+  for_vector(ModuleSymbol, mod, candidates) {
+    if (keep.count(mod) == 0) {
+      mod->defPoint->remove();
+
+      nPruned++;
+    }
+  }
+
+  if (fReportDeadModules && nPruned > 0)
+    printf("Pruned %d standard module%s never used nor imported.\n",
+           nPruned, (nPruned == 1) ? "" : "s");
+}
+
 static void detectUserDefinedBorrowMethods() {
   forv_Vec(FnSymbol, fn, gFnSymbols) {
     if (fn->isMethod() && fn->name == astrBorrow) {
@@ -3026,6 +3149,8 @@ static void processGetVisibleSymbols() {
 
 
 void scopeResolve() {
+  pruneUnusedStandardModules();
+
   addToSymbolTable();
 
   processImportExprs();
@@ -31,11 +31,14 @@
 
 #include "splitInit.h"
 
+#include "astutil.h"
 #include "CatchStmt.h"
+#include "driver.h"
 #include "ForallStmt.h"
 #include "expr.h"
 #include "errorHandling.h"
 #include "optimizations.h"
+#include "perfReport.h"
 #include "resolution.h"
 #include "stmt.h"
 #include "symbol.h"
@@ -452,6 +455,112 @@ static found_init_t doFindInitPoints(Symbol* sym,
   return FOUND_NOTHING;
 }
 
+/************************************* | **************************************
+*                                                                             *
+*   array default-init elision                                                *
+*                                                                             *
+************************************** | *************************************/
+
+// Is 'e' a mention of a numeric or bool type?  Element default-init for
+// these is a plain zeroing write, and reading an unwritten element can
+// at worst produce a garbage value, never a memory hazard, so they are
+// the element types for which eliding default init is safe.
+static bool isTrivialEltTypeExpr(Expr* e) {
+  if (SymExpr* se = toSymExpr(e)) {
+    if (TypeSymbol* ts = toTypeSymbol(se->symbol())) {
+      Type* t = ts->type;
+      return is_bool_type(t) || is_int_type(t)  || is_uint_type(t) ||
+             is_real_type(t) || is_imag_type(t) || is_complex_type(t);
+    }
+  }
+
+  return false;
+}
+
+bool elideArrayDefaultInit(DefExpr* def, Expr* firstUse) {
+  if (fNoElideArrayDefaultInit)
+    return false;
+
+  // 'firstUse' is the use that prevented split init for 'def', which
+  // declares a variable with a type expression and no initializer.  If
+  // the declared type is an array of trivial elements and 'firstUse' is
+  // a forall over the whole array whose body definitely assigns the
+  // induction variable -- a reference to the element -- before reading
+  // it, then every element is overwritten before any element can be
+  // read and default initialization of the elements is unobservable.
+  // The variable can then be lowered as if it were declared 'noinit':
+  // large arrays skip a full zeroing pass over the element memory, and
+  // the pages are first-touched by the tasks that run the loop rather
+  // than at the allocation point.
+
+  if (def->getModule()->modTag != MOD_USER)
+    return false;
+
+  // config variables can be initialized from the command line
+  if (def->sym->hasFlag(FLAG_CONFIG) || def->sym->hasFlag(FLAG_EXTERN))
+    return false;
+
+  SymExpr* use = toSymExpr(firstUse);
+  if (use == NULL || use->symbol() != def->sym)
+    return false;
+
+  // The declared type must be a literal array type over trivial
+  // elements; an alias could name an array of records, say, whose
+  // default init is not elidable.
+  CallExpr* typeCall = toCallExpr(def->exprType);
+  if (typeCall == NULL ||
+      typeCall->isNamed("chpl__buildArrayRuntimeType") == false ||
+      typeCall->numActuals() < 2 ||
+      isTrivialEltTypeExpr(typeCall->get(2)) == false)
+    return false;
+
+  // The use must be the sole iterand of a non-zippered forall, so that
+  // the loop visits every element of the array exactly once.
+  ForallStmt* forall = toForallStmt(use->parentExpr);
+  if (forall == NULL ||
+      forall->numIteratedExprs() != 1 ||
+      forall->firstIteratedExpr() != use ||
+      forall->numInductionVars() != 1)
+    return false;
+
+  // The loop must not otherwise mention the array -- not in the body
+  // (which could read unwritten elements), not in a shadow variable
+  // (which could alias it).
+  std::vector<SymExpr*> mentions;
+  collectSymExprsFor(forall, def->sym, mentions);
+  if (mentions.size() != 1)
+    return false;
+
+  // A throwing iteration would leave its element unassigned while the
+  // array remains visible to whoever catches, so the body must not
+  // throw.  (Task constructs in the body already prevent the definite
+  // assignment check below from succeeding.)
+  std::vector<CallExpr*> calls;
+  collectCallExprs(forall->loopBody(), calls);
+  for_vector(CallExpr, call, calls) {
+    if (call->isPrimitive(PRIM_THROW))
+      return false;
+  }
+
+  // Finally, the element reference must be definitely assigned before
+  // any read on every path through the loop body.
+  DefExpr* idxDef = toDefExpr(forall->inductionVariables().head);
+  std::vector<CallExpr*> initAssigns;
+  Expr* prevent = NULL;
+  BlockStmt* ignoreFirstEndInBlock = NULL;
+  found_init_t found = doFindInitPoints(idxDef->sym,
+                                        forall->loopBody()->body.first(),
+                                        initAssigns, prevent,
+                                        /* allowReturns */ false,
+                                        ignoreFirstEndInBlock);
+  if (found != FOUND_INIT)
+    return false;
+
+  perfReportOptimization(forall, "elided array zero-initialization");
+
+  return true;
+}
+
 void splitInitMissingTypeError(Symbol* sym, Expr* mention, bool unresolved) {
   const char* name = toString(sym, false);
   ArgSymbol* arg = toArgSymbol(sym);
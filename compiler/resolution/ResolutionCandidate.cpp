@@ -55,6 +55,16 @@ ResolutionCandidate::ResolutionCandidate(FnSymbol* function) {
   reason = RESOLUTION_CANDIDATE_MATCH;
 }
 
+void ResolutionCandidate::reset(FnSymbol* function) {
+  fn = function;
+  formalIdxToActual.clear();
+  actualIdxToFormal.clear();
+  witnessIstms.clear();
+  isInterimInstantiation = false;
+  failingArgument = NULL;
+  reason = RESOLUTION_CANDIDATE_MATCH;
+}
+
 /************************************* | **************************************
 *                                                                             *
 *                                                                             *
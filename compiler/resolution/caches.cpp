@@ -38,8 +38,53 @@ SymbolMapCache promotionsCache;
 
 static bool isCacheEntryMatch(SymbolMap* s1, SymbolMap* s2);
 
+//
+// Substitution maps can reach the same instantiation through value
+// symbols that are distinct but interchangeable -- e.g. a TypeSymbol
+// that is no longer its type's canonical symbol, or a param constant
+// that duplicates an entry in the interned-literals table.  Reduce each
+// value to a canonical representative so that the fingerprint and the
+// map comparison unify such substitutions instead of creating another
+// copy of the function.
+//
+static Symbol* canonicalSubstitution(Symbol* value) {
+  if (value == NULL)
+    return value;
+
+  if (TypeSymbol* ts = toTypeSymbol(value))
+    return ts->type->symbol;
+
+  if (VarSymbol* var = toVarSymbol(value))
+    if (var->immediate != NULL)
+      if (VarSymbol* interned = uniqueConstantsHash.get(var->immediate))
+        if (interned->type == var->type)
+          return interned;
+
+  return value;
+}
+
+//
+// Computes an order-independent fingerprint of a SymbolMap by summing
+// a hash of each key-value pair.  Two maps with the same entries in
+// any order get the same fingerprint, so a fingerprint mismatch rules
+// out a cache hit without walking either map.  Values are fingerprinted
+// through their canonical representatives.
+//
+static uintptr_t hashSymbolMap(SymbolMap* map) {
+  uintptr_t retval = 0;
+
+  form_Map(SymbolMapElem, e, *map) {
+    if (e->key != NULL) {
+      retval += _vec_hasher(e->key) ^
+                (_vec_hasher(canonicalSubstitution(e->value)) << 1);
+    }
+  }
+
+  return retval;
+}
+
 SymbolMapCacheEntry::SymbolMapCacheEntry(FnSymbol* ifn, SymbolMap* imap) :
-  fn(ifn), map(*imap) { }
+  fn(ifn), map(*imap), mapHash(hashSymbolMap(imap)) { }
 
 
 void
@@ -64,8 +109,10 @@ addCache(SymbolMapCache& cache,
 FnSymbol*
 checkCache(SymbolMapCache& cache, FnSymbol* oldFn, SymbolMap* map) {
   if (Vec<SymbolMapCacheEntry*>* entries = cache.get(oldFn)) {
+    uintptr_t mapHash = hashSymbolMap(map);
+
     forv_Vec(SymbolMapCacheEntry, entry, *entries) {
-      if (isCacheEntryMatch(map, &entry->map))
+      if (entry->mapHash == mapHash && isCacheEntryMatch(map, &entry->map))
         return entry->fn;
     }
   }
@@ -75,24 +122,26 @@ checkCache(SymbolMapCache& cache, FnSymbol* oldFn, SymbolMap* map) {
 
 void
 freeCache(SymbolMapCache& cache) {
-  form_Map(SymbolMapCacheElem, elem, cache) {
-    forv_Vec(SymbolMapCacheEntry, entry, *elem->value) {
+  cache.forEach([](FnSymbol* key, Vec<SymbolMapCacheEntry*>*& entries) {
+    forv_Vec(SymbolMapCacheEntry, entry, *entries) {
       delete entry;
     }
-    delete elem->value;
-  }
+    delete entries;
+  });
   cache.clear();
 }
 
 static bool isCacheEntryMatch(SymbolMap* s1, SymbolMap* s2) {
   form_Map(SymbolMapElem, e, *s1) {
-    if (s2->get(e->key) != e->value) {
+    if (canonicalSubstitution(s2->get(e->key)) !=
+        canonicalSubstitution(e->value)) {
       return false;
     }
   }
 
   form_Map(SymbolMapElem, e, *s2) {
-    if (s1->get(e->key) != e->value) {
+    if (canonicalSubstitution(s1->get(e->key)) !=
+        canonicalSubstitution(e->value)) {
       return false;
     }
   }
@@ -236,7 +285,7 @@ void genericsCacheSummary(BaseAST* ast) {
 SymbolMapScopeCache genericsCache;
 
 SymbolMapScopeCacheEntry::SymbolMapScopeCacheEntry(FnSymbol* ifn, SymbolMap* imap) :
-  fn(ifn), map(*imap) { }
+  fn(ifn), map(*imap), mapHash(hashSymbolMap(imap)) { }
 
 void
 addCache(SymbolMapScopeCache& cache,
@@ -265,8 +314,11 @@ checkCache(SymbolMapScopeCache& cache, FnSymbol* oldFn,
            VisibilityInfo* visInfo, SymbolMap* map)
 {
   if (Vec<SymbolMapScopeCacheEntry*>* entries = cache.get(oldFn)) {
+    uintptr_t mapHash = hashSymbolMap(map);
+
     forv_Vec(SymbolMapScopeCacheEntry, entry, *entries) {
-      if (isCacheEntryMatch(map, &entry->map) &&
+      if (entry->mapHash == mapHash &&
+          isCacheEntryMatch(map, &entry->map) &&
           (visInfo == NULL || isApplicableInstantiation(*visInfo, entry->fn)) )
         return entry->fn;
     }
@@ -278,12 +330,12 @@ checkCache(SymbolMapScopeCache& cache, FnSymbol* oldFn,
 
 void
 freeCache(SymbolMapScopeCache& cache) {
-  form_Map(SymbolMapScopeCacheElem, elem, cache) {
-    forv_Vec(SymbolMapScopeCacheEntry, entry, *elem->value) {
+  cache.forEach([](FnSymbol* key, Vec<SymbolMapScopeCacheEntry*>*& entries) {
+    forv_Vec(SymbolMapScopeCacheEntry, entry, *entries) {
       delete entry;
     }
-    delete elem->value;
-  }
+    delete entries;
+  });
   cache.clear();
 }
 
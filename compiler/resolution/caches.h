@@ -22,6 +22,7 @@
 #define _CACHES_H_
 
 #include "baseAST.h"
+#include "concurrentMap.h"
 
 class CalledFunInfo;
 class VisibilityInfo;
@@ -47,10 +48,14 @@ public:
 
   FnSymbol* fn;
   SymbolMap map;
+
+  // order-independent fingerprint of 'map'; entries whose fingerprints
+  // differ cannot match, which lets checkCache() skip the full
+  // key-by-key comparison for almost all entries
+  uintptr_t mapHash;
 };
 
-typedef Map<FnSymbol*,     Vec<SymbolMapCacheEntry*>*> SymbolMapCache;
-typedef MapElem<FnSymbol*, Vec<SymbolMapCacheEntry*>*> SymbolMapCacheElem;
+typedef ConcurrentMap<FnSymbol*, Vec<SymbolMapCacheEntry*>*> SymbolMapCache;
 
 
 void      addCache(SymbolMapCache& cache,
@@ -95,10 +100,13 @@ public:
 
   FnSymbol* fn;
   SymbolMap map;
+
+  // order-independent fingerprint of 'map'; see SymbolMapCacheEntry
+  uintptr_t mapHash;
 };
 
-typedef Map<FnSymbol*,     Vec<SymbolMapScopeCacheEntry*>*> SymbolMapScopeCache;
-typedef MapElem<FnSymbol*, Vec<SymbolMapScopeCacheEntry*>*> SymbolMapScopeCacheElem;
+typedef ConcurrentMap<FnSymbol*, Vec<SymbolMapScopeCacheEntry*>*>
+        SymbolMapScopeCache;
 
 void      addCache(SymbolMapScopeCache& cache,
                    FnSymbol*       oldFn,
@@ -642,6 +642,7 @@ public:
 private:
 
   std::vector<GraphNode> collectedSymbols;
+  std::set<GraphNode> visitedSymbols;
   revisitUnknowns_t unknownConstSyms;
   revisitGraph_t revisitGraph;
   std::map<BaseAST*, BaseAST*> reasonNotConst;
@@ -768,7 +769,13 @@ void CullRefCtx::collectOrLowerContextCallExprs(void) {
 void CullRefCtx::visitCollectedSymbols(void) {
   for (size_t i = 0; i < collectedSymbols.size(); i++) {
     GraphNode node = collectedSymbols[i];
-    visitCollectedSymbol(node);
+
+    // The same node can be pushed onto collectedSymbols once per
+    // dependency discovered, but nothing mutates its SymExprs during the
+    // analysis, so a revisit would just re-derive the same classification
+    // and re-add the same graph edges. One walk per node suffices.
+    if (visitedSymbols.insert(node).second)
+      visitCollectedSymbol(node);
   }
 }
 
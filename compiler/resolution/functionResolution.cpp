@@ -51,6 +51,7 @@
 #include "ParamForLoop.h"
 #include "PartialCopyData.h"
 #include "passes.h"
+#include "passResources.h"
 #include "postFold.h"
 #include "preFold.h"
 #include "ResolutionCandidate.h"
@@ -75,6 +76,7 @@
 #include <cmath>
 #include <inttypes.h>
 #include <map>
+#include <set>
 #include <sstream>
 #include <string>
 #include <vector>
@@ -138,6 +140,31 @@ static std::map<FnSymbol*, const char*> outerCompilerErrorMap;
 
 static CapturedValueMap            capturedValues;
 
+//
+// These side maps have no consumers after the resolve pass itself; they
+// are registered with the pass-resource registry (see passResources.h)
+// so runPass() frees them once resolve is done.
+//
+static void retireResolveSideMaps() {
+  runtimeTypeMap.clear();
+
+  innerCompilerWarningMap.clear();
+  outerCompilerWarningMap.clear();
+
+  innerCompilerErrorMap.clear();
+  outerCompilerErrorMap.clear();
+}
+
+static size_t resolveSideMapsSize() {
+  size_t mapNodeSize = sizeof(FnSymbol*) + sizeof(const char*) +
+                       4 * sizeof(void*);
+
+  return runtimeTypeMap.count() * sizeof(MapElem<Type*, Type*>) +
+         (innerCompilerWarningMap.size() + outerCompilerWarningMap.size() +
+          innerCompilerErrorMap.size()   + outerCompilerErrorMap.size()) *
+         mapNodeSize;
+}
+
 // Enable coercions from nilable -> non-nilable to have easier errors
 static int generousResolutionForErrors;
 
@@ -315,11 +342,13 @@ void makeRefType(Type* type) {
     return;
   }
 
+  static constexpr FlagSet refOrGeneric = makeFlagSet(FLAG_REF,
+                                                      FLAG_GENERIC);
+
   if (type == dtMethodToken ||
       type == dtUnknown ||
       type == dtSplitInitType ||
-      type->symbol->hasFlag(FLAG_REF) ||
-      type->symbol->hasFlag(FLAG_GENERIC)) {
+      type->symbol->hasAnyFlag(refOrGeneric)) {
 
     return;
   }
@@ -4040,8 +4069,9 @@ void resolveNormalCallCompilerWarningStuff(CallExpr* call,
       FnSymbol* inFn = call->getFunction();
       bool inCopyIsh = false;
       if (inFn != NULL) {
-        inCopyIsh = inFn->hasFlag(FLAG_INIT_COPY_FN) ||
-                    inFn->hasFlag(FLAG_AUTO_COPY_FN) ||
+        static constexpr FlagSet copyIshFlags = makeFlagSet(FLAG_INIT_COPY_FN,
+                                                            FLAG_AUTO_COPY_FN);
+        inCopyIsh = inFn->hasAnyFlag(copyIshFlags) ||
                     inFn->name == astrInitEquals;
       }
       if (inCopyIsh) {
@@ -4835,11 +4865,33 @@ static void gatherLastResortCandidates(CallInfo&                  info,
   numVisited = ++idx;
 }
 
+//
+// A rejected candidate matters only if the call ultimately fails to
+// resolve, and in that case the failure explanations are rebuilt from
+// scratch by re-running isApplicable() (see explainCandidateRejection()
+// and sortExampleCandidates()).  So on the path where the call succeeds
+// the only trace a rejection leaves is its discarded descriptor.  Reuse
+// a single scratch descriptor for consecutive rejections rather than
+// heap-allocating one per visible function per call; successful calls
+// dominate a compilation, so this churn adds up.  The scratch is
+// detached while in use because isApplicable() can recursively resolve
+// other calls, re-entering filterCandidate().
+//
+static ResolutionCandidate* scratchCandidate = NULL;
+
 static void filterCandidate(CallInfo&                  info,
                             VisibilityInfo&            visInfo,
                             FnSymbol*                  fn,
                             Vec<ResolutionCandidate*>& candidates) {
-  ResolutionCandidate* candidate = new ResolutionCandidate(fn);
+  ResolutionCandidate* candidate = NULL;
+
+  if (scratchCandidate != NULL) {
+    candidate = scratchCandidate;
+    scratchCandidate = NULL;
+    candidate->reset(fn);
+  } else {
+    candidate = new ResolutionCandidate(fn);
+  }
 
   if (fExplainVerbose &&
       ((explainCallLine && explainCallMatch(info.call)) ||
@@ -4853,6 +4905,8 @@ static void filterCandidate(CallInfo&                  info,
 
   if (candidate->isApplicable(info, &visInfo)) {
     candidates.add(candidate);
+  } else if (scratchCandidate == NULL) {
+    scratchCandidate = candidate;
   } else {
     delete candidate;
   }
@@ -9199,9 +9253,10 @@ static void resolveExprMaybeIssueError(CallExpr* call) {
         for (int i = callStack.n-1; i >= 0; i--) {
           CallExpr*     frame  = callStack.v[i];
           FnSymbol*     fn     = frame->getFunction();
-          bool inCopyIsh = fn->hasFlag(FLAG_INIT_COPY_FN) ||
-                           fn->hasFlag(FLAG_AUTO_COPY_FN) ||
-                           fn->hasFlag(FLAG_COERCE_FN) ||
+          static constexpr FlagSet copyIshFlags = makeFlagSet(FLAG_INIT_COPY_FN,
+                                                              FLAG_AUTO_COPY_FN,
+                                                              FLAG_COERCE_FN);
+          bool inCopyIsh = fn->hasAnyFlag(copyIshFlags) ||
                            fn->name == astrInitEquals;
           if (inCopyIsh) {
             fn->addFlag(FLAG_ERRONEOUS_COPY);
@@ -9381,6 +9436,9 @@ static void checkNoVoidFields()
 
 
 void resolve() {
+  registerPassResource("resolve side maps", "resolve",
+                       retireResolveSideMaps, resolveSideMapsSize);
+
   parseExplainFlag(fExplainCall, &explainCallLine, &explainCallModule);
 
   unmarkDefaultedGenerics();
@@ -9447,6 +9505,9 @@ void resolve() {
 
   saveGenericSubstitutions();
 
+  if (fReportInstantiations)
+    reportInstantiations();
+
   checkNoVoidFields();
 
   pruneResolvedTree();
@@ -9521,7 +9582,19 @@ static void unmarkDefaultedGenerics() {
 
 static std::set<ModuleSymbol*> moduleInitResolved;
 
+static void retireModuleInitResolved() {
+  moduleInitResolved.clear();
+}
+
+static size_t moduleInitResolvedSize() {
+  return moduleInitResolved.size() *
+         (sizeof(ModuleSymbol*) + 4 * sizeof(void*));
+}
+
 static void resolveUses(ModuleSymbol* mod, const char* path) {
+  registerPassResource("resolved module init set", "resolve",
+                       retireModuleInitResolved, moduleInitResolvedSize);
+
   if (moduleInitResolved.count(mod) == 0) {
     moduleInitResolved.insert(mod);
 
@@ -9841,19 +9914,66 @@ static void resolveDestructors() {
 
 static const char* autoCopyFnForType(AggregateType* at);
 
+// Collect the value types the program can actually demand copy-init/deinit
+// machinery for: the types of live variables, formals, and function return
+// values, plus the well-known types.  Fields are VarSymbols, so the field
+// types of any demanded record are collected as well.  A record instantiation
+// with no entry here has no value anywhere in the tree, so nothing can ever
+// copy or destroy one.
+static void computeValueDemandedTypes(std::set<Type*>& demanded) {
+  for_alive_in_Vec(VarSymbol, var, gVarSymbols) {
+    demanded.insert(var->type->getValType());
+  }
+
+  for_alive_in_Vec(ArgSymbol, arg, gArgSymbols) {
+    demanded.insert(arg->type->getValType());
+  }
+
+  for_alive_in_Vec(ShadowVarSymbol, svar, gShadowVarSymbols) {
+    demanded.insert(svar->type->getValType());
+  }
+
+  for_alive_in_Vec(FnSymbol, fn, gFnSymbols) {
+    if (fn->retType != NULL) {
+      demanded.insert(fn->retType->getValType());
+    }
+  }
+
+  std::set<Type*> wellknown = getWellKnownTypesSet();
+
+  demanded.insert(wellknown.begin(), wellknown.end());
+}
+
 static void resolveAutoCopies() {
-  for_alive_in_Vec(TypeSymbol, ts, gTypeSymbols) {
-    if (! ts->hasFlag(FLAG_GENERIC)                 &&
-        ! ts->hasFlag(FLAG_SYNTACTIC_DISTRIBUTION)) {
-      if (AggregateType* at = toAggregateType(ts->type)) {
-        if (isRecord(at) || isUnion(at)) {
-          // If we attempt to resolve auto-copy and co. for an infinite record
-          // we may enter an infinite loop and the compiler will crash.
-          checkForInfiniteRecord(at);
-          resolveAutoCopyEtc(at);
-        }
+  // Resolving auto-copy and co. for one record can instantiate functions and
+  // types that demand it for others, so iterate to a fixed point.  Repeat
+  // visits are cheap because resolveAutoCopyEtc() is idempotent per type.
+  int numSymbols = 0;
+
+  while (numSymbols != gVarSymbols.n + gArgSymbols.n + gTypeSymbols.n) {
+    numSymbols = gVarSymbols.n + gArgSymbols.n + gTypeSymbols.n;
+
+    std::set<Type*> demanded;
+
+    computeValueDemandedTypes(demanded);
+
+    for_alive_in_Vec(TypeSymbol, ts, gTypeSymbols) {
+      if (! ts->hasFlag(FLAG_GENERIC)                 &&
+          ! ts->hasFlag(FLAG_SYNTACTIC_DISTRIBUTION)) {
+        if (AggregateType* at = toAggregateType(ts->type)) {
+          // Skip records no value of which can exist; propagateNotPOD() will
+          // still resolve the machinery for any type whose POD-ness depends
+          // on it.
+          if (isUnion(at) || (isRecord(at) && demanded.count(at) != 0)) {
+            // If we attempt to resolve auto-copy and co. for an infinite
+            // record we may enter an infinite loop and the compiler will
+            // crash.
+            checkForInfiniteRecord(at);
+            resolveAutoCopyEtc(at);
+          }
 
-        propagateNotPOD(at);
+          propagateNotPOD(at);
+        }
       }
     }
   }
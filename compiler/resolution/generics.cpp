@@ -41,7 +41,10 @@
 
 #include <inttypes.h>
 
+#include <algorithm>
 #include <cstdlib>
+#include <map>
+#include <vector>
 
 static int             explainInstantiationLine   = -2;
 static ModuleSymbol*   explainInstantiationModule = NULL;
@@ -175,6 +178,78 @@ checkInfiniteWhereInstantiation(FnSymbol* fn) {
 }
 
 
+//
+// Per-root tallies behind --report-instantiations: how many copies of
+// each generic were actually made, how many requests the instantiation
+// cache absorbed, and roughly how much AST those copies contributed.
+// The resulting table identifies the generics every compile pays to
+// re-instantiate -- the curation input for pre-instantiating common
+// standard-library cases.
+//
+struct InstantiationTally {
+  int    created;
+  int    cacheHits;
+  size_t astNodes;
+
+  InstantiationTally() : created(0), cacheHits(0), astNodes(0) { }
+};
+
+static std::map<FnSymbol*, InstantiationTally> instantiationTallies;
+
+static void tallyCacheHit(FnSymbol* root) {
+  if (fReportInstantiations)
+    instantiationTallies[root].cacheHits++;
+}
+
+static void tallyInstantiation(FnSymbol* root, FnSymbol* newFn) {
+  if (fReportInstantiations) {
+    InstantiationTally& tally = instantiationTallies[root];
+
+    std::vector<BaseAST*> asts;
+    collect_asts(newFn, asts);
+
+    tally.created  += 1;
+    tally.astNodes += asts.size();
+  }
+}
+
+static bool tallyGreater(const std::pair<FnSymbol*, InstantiationTally>& a,
+                         const std::pair<FnSymbol*, InstantiationTally>& b) {
+  return a.second.astNodes > b.second.astNodes;
+}
+
+void reportInstantiations() {
+  std::vector<std::pair<FnSymbol*, InstantiationTally> > entries;
+  InstantiationTally totals;
+
+  for (std::map<FnSymbol*, InstantiationTally>::iterator it =
+         instantiationTallies.begin();
+       it != instantiationTallies.end(); ++it) {
+    entries.push_back(*it);
+    totals.created   += it->second.created;
+    totals.cacheHits += it->second.cacheHits;
+    totals.astNodes  += it->second.astNodes;
+  }
+
+  std::sort(entries.begin(), entries.end(), tallyGreater);
+
+  printf("%-40s %-24s %8s %8s %12s\n",
+         "generic function", "module", "copies", "cached", "ast nodes");
+
+  for (size_t i = 0; i < entries.size(); i++) {
+    FnSymbol* root = entries[i].first;
+    const InstantiationTally& tally = entries[i].second;
+
+    printf("%-40s %-24s %8d %8d %12zu\n",
+           root->name, root->getModule()->name,
+           tally.created, tally.cacheHits, tally.astNodes);
+  }
+
+  printf("%-40s %-24s %8d %8d %12zu\n",
+         "total", "", totals.created, totals.cacheHits, totals.astNodes);
+}
+
+
 static Map<FnSymbol*,int> instantiationLimitMap;
 
 
@@ -385,6 +460,8 @@ FnSymbol* instantiateSignature(FnSymbol*  fn,
       if (cached != (FnSymbol*) gVoid) {
         checkInfiniteWhereInstantiation(cached);
 
+        tallyCacheHit(root);
+
         return cached;
       } else {
         INT_FATAL("cache returned gVoid");
@@ -418,6 +495,8 @@ FnSymbol* instantiateSignature(FnSymbol*  fn,
             // were not provided.
             addCache(genericsCache, root, cached, &allSubsBeforeDefaultExprs);
 
+            tallyCacheHit(root);
+
             // Remove the new function
             newFn->defPoint->remove();
 
@@ -436,6 +515,8 @@ FnSymbol* instantiateSignature(FnSymbol*  fn,
       if (hasGenericDefaultExpr)
         addCache(genericsCache, root, newFn, &allSubsBeforeDefaultExprs);
 
+      tallyInstantiation(root, newFn);
+
       // Apply fixups to the function
       if (fixupTupleFunctions(fn, newFn, call) == false) {
         // Fix up chpl__initCopy for user-defined records
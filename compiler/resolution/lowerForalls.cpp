@@ -21,6 +21,7 @@
 #include "astutil.h"
 #include "AstVisitorTraverse.h"
 #include "CForLoop.h"
+#include "driver.h"
 #include "ForLoop.h"
 #include "forallOptimizations.h"
 #include "ForallStmt.h"
@@ -324,6 +325,7 @@ class ExpandVisitor;
 static void expandYield( ExpandVisitor* EV, CallExpr* yield);
 static void expandTaskFn(ExpandVisitor* EV, CallExpr* call, FnSymbol* taskFn);
 static void expandForall(ExpandVisitor* EV, ForallStmt* fs);
+static void instrumentForallBlock(ForallStmt* fs, Expr* lowered);
 
 
 /////////// ExpandVisitor visitor ///////////
@@ -485,6 +487,9 @@ static VarSymbol* createCurrRP(ShadowVarSymbol* RP) {
 static VarSymbol* createCurrAS(ShadowVarSymbol* AS) {
   VarSymbol* currAS = new VarSymbol(astr("AS_", AS->name), AS->type);
   currAS->qual = QUAL_VAL;
+  // Each task updates its accumulation state on every iteration, so
+  // keep the states of different tasks on separate cache lines.
+  currAS->addFlag(FLAG_CACHELINE_ALIGN);
   return currAS;
  }
 
@@ -1216,6 +1221,9 @@ static void handleRecursiveIter(ForallStmt* fs,
   // Move callFreeIter and parIterDef outside of PARBlock?
   PARBlock->insertAtTail(callFreeIter->remove());
 
+  if (fInstrumentForalls)
+    instrumentForallBlock(fs, PARBlock);
+
   fs->remove();
 }
 
@@ -1445,6 +1453,19 @@ static void handleIteratorForwarders(ForallStmt* fs,
 }
 
 
+//
+// Under --instrument-foralls, bracket the lowered forall with the
+// runtime's entry/exit instrumentation hooks.  The primitives carry
+// the forall's astloc, so insertLineNumbers() will pass the loop's
+// line number and filename index to the hooks.
+//
+static void instrumentForallBlock(ForallStmt* fs, Expr* lowered) {
+  SET_LINENO(fs);
+  lowered->insertBefore(new CallExpr(PRIM_FORALL_ENTER));
+  lowered->insertAfter(new CallExpr(PRIM_FORALL_EXIT));
+}
+
+
 /////////// handle one ForallStmt ///////////
 
 static void lowerOneForallStmt(ForallStmt* fs) {
@@ -1501,6 +1522,9 @@ static void lowerOneForallStmt(ForallStmt* fs) {
   // Traverse recursively.
   ibody->accept(&outerVis);
 
+  if (fInstrumentForalls)
+    instrumentForallBlock(fs, iwrap);
+
   fs->remove();
   // We could also do {iwrap,ibody}->flattenAndRemove().
 
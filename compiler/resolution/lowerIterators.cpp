@@ -30,6 +30,7 @@
 #include "oldCollectors.h"
 #include "optimizations.h"
 #include "passes.h"
+#include "perfReport.h"
 #include "resolution.h"
 #include "resolveIntents.h"
 #include "stlUtil.h"
@@ -326,6 +327,46 @@ static bool isCallVectorHazard(CallExpr* call,
   return hazard;
 }
 
+//
+// Is this a reduction the vectorizer is known to handle?
+//
+// The per-task Accumulation State is a local scalar by the time the loop
+// is lowered, so the vectorizer turns the accumulation into a privatized
+// multi-lane recurrence with a final tree combine on its own; all we have
+// to do here is avoid marking such loops as hazards.  That is valid for
+// operations the vectorizer recognizes as reassociable reductions:
+// sum/product/min/max and the bitwise/logical ops over machine numbers.
+//
+static bool isVectorizableReduction(Type* accumType, Type* opType) {
+  const char* opName = opType->symbol->name;
+
+  if (is_int_type(accumType)  ||
+      is_uint_type(accumType) ||
+      is_imag_type(accumType) ||
+      is_real_type(accumType)
+      // TODO: is_complex_type
+     ) {
+    if (startsWith(opName, "SumReduceScanOp")     ||
+        startsWith(opName, "ProductReduceScanOp") ||
+        startsWith(opName, "MaxReduceScanOp")     ||
+        startsWith(opName, "MinReduceScanOp"))
+      return true;
+  }
+
+  if (is_int_type(accumType)  ||
+      is_uint_type(accumType) ||
+      is_bool_type(accumType)) {
+    if (startsWith(opName, "BitwiseAndReduceScanOp") ||
+        startsWith(opName, "BitwiseOrReduceScanOp")  ||
+        startsWith(opName, "BitwiseXorReduceScanOp") ||
+        startsWith(opName, "LogicalAndReduceScanOp") ||
+        startsWith(opName, "LogicalOrReduceScanOp"))
+      return true;
+  }
+
+  return false;
+}
+
 static void markVectorizableForallLoops()
 {
   std::map<FnSymbol*, bool> fnHasVectorHazard;
@@ -400,26 +441,29 @@ static void markVectorizableForallLoops()
     for_shadow_vars (shadow, temp, forall) {
       if (shadow->isReduce()) {
         if (ShadowVarSymbol* op = shadow->ReduceOpForAccumState()) {
-          Type* accumType = shadow->type;
-          Type* opType = op->type;
-          bool ok = false;
-          // Only vectorize + reductions on numbers
-          if (is_int_type(accumType) ||
-              is_uint_type(accumType) ||
-              is_imag_type(accumType) ||
-              is_real_type(accumType)
-              // TODO: is_complex_type
-             ) {
-            if (startsWith(opType->symbol->name, "SumReduceScanOp"))
-              ok = true;
-          }
-          if (ok == false)
+          if (isVectorizableReduction(shadow->type, op->type) == false)
             hazard = true;
         }
       }
     }
     forall->setHasVectorizationHazard(hazard);
 
+    if (fPerfReport) {
+      const char* reason = NULL;
+      if (hazard) {
+        FnSymbol* fn = v.reason ? v.reason->resolvedFunction() : NULL;
+        if (fn)
+          reason = astr("calls synchronizing function ", fn->name);
+        else if (v.reason && v.reason->isPrimitive(PRIM_VIRTUAL_METHOD_CALL))
+          reason = "calls virtual function";
+        else if (v.hazard)
+          reason = "synchronization";
+        else
+          reason = "unvectorizable reduction";
+      }
+      perfReportVectorization(forall, !hazard, reason);
+    }
+
     bool report = false;
     if (fReportVectorizedLoops) {
       ModuleSymbol *mod = toModuleSymbol(forall->getModule());
@@ -2970,6 +3014,248 @@ static void removeUncalledIterators()
   }
 }
 
+//
+// Stack allocation for non-inlined iterator records.
+//
+// A loop over a non-inlined iterator obtains its iterator class
+// instance from _getIterator(), which heap-allocates it, and releases
+// it through _freeIterator() when the loop exits (including the break
+// blocks built above).  When every use of the instance stays within
+// the allocating function - it only ever feeds the AUTO_II iterator
+// methods, field accesses, and _freeIterator() - its lifetime
+// provably ends at loop exit, so the heap round trip per loop entry
+// is pure overhead.  For those sites we redirect the call to a
+// variant of _getIterator() that fills caller-provided stack storage
+// (PRIM_STACK_ALLOCATE_CLASS, as stackAllocateClasses and the task
+// argument bundles use) and each matching _freeIterator() to a
+// variant that skips the locale-model free.
+//
+// Polymorphic iterator classes are skipped: after
+// handlePolymorphicIterators() their _getIterator() picks a subclass
+// at run time, so no statically sized slot fits.  Zippered loops hold
+// their member instances through the tuple built by _getIteratorZip()
+// and are left alone too; the tuple crosses a function boundary.
+//
+
+static FnSymbol* stackGetIteratorVariant(FnSymbol* getIterFn,
+                                         AggregateType* iClass) {
+  static std::map<FnSymbol*, FnSymbol*> cache;
+
+  std::map<FnSymbol*, FnSymbol*>::iterator it = cache.find(getIterFn);
+  if (it != cache.end())
+    return it->second;
+
+  SET_LINENO(getIterFn);
+
+  FnSymbol* variant = getIterFn->copy();
+  variant->cname = astr(variant->cname, "_stack");
+  getIterFn->defPoint->insertAfter(new DefExpr(variant));
+
+  ArgSymbol* memArg = new ArgSymbol(INTENT_BLANK, "stack_mem", iClass);
+  variant->insertFormalAtTail(memArg);
+
+  CallExpr* alloc = NULL;
+  int numAllocs = 0;
+  std::vector<CallExpr*> calls;
+  collectCallExprs(variant->body, calls);
+  for_vector(CallExpr, call, calls) {
+    if (FnSymbol* rf = call->resolvedFunction()) {
+      if (rf->hasFlag(FLAG_LOCALE_MODEL_ALLOC)) {
+        alloc = call;
+        numAllocs++;
+      }
+    }
+  }
+
+  if (numAllocs != 1 || toCallExpr(alloc->parentExpr) == NULL) {
+    variant->defPoint->remove();
+    cache[getIterFn] = NULL;
+    return NULL;
+  }
+
+  Type* expected = alloc->typeInfo();
+  if (expected == iClass) {
+    alloc->replace(new SymExpr(memArg));
+  } else if (expected == dtCVoidPtr) {
+    alloc->replace(new CallExpr(PRIM_CAST_TO_VOID_STAR, memArg));
+  } else {
+    alloc->replace(new CallExpr(PRIM_CAST, expected->symbol, memArg));
+  }
+
+  cache[getIterFn] = variant;
+  return variant;
+}
+
+static FnSymbol* stackFreeIteratorVariant(FnSymbol* freeFn) {
+  static std::map<FnSymbol*, FnSymbol*> cache;
+
+  std::map<FnSymbol*, FnSymbol*>::iterator it = cache.find(freeFn);
+  if (it != cache.end())
+    return it->second;
+
+  SET_LINENO(freeFn);
+
+  FnSymbol* variant = freeFn->copy();
+  variant->cname = astr(variant->cname, "_stack");
+  freeFn->defPoint->insertAfter(new DefExpr(variant));
+
+  int removed = 0;
+  bool badShape = false;
+  std::vector<CallExpr*> calls;
+  collectCallExprs(variant->body, calls);
+  for_vector(CallExpr, call, calls) {
+    if (FnSymbol* rf = call->resolvedFunction()) {
+      if (rf->hasFlag(FLAG_LOCALE_MODEL_FREE)) {
+        if (call->parentExpr != NULL) {
+          badShape = true;
+        } else {
+          call->convertToNoop();
+          removed++;
+        }
+      }
+    }
+  }
+
+  if (removed == 0 || badShape) {
+    variant->defPoint->remove();
+    cache[freeFn] = NULL;
+    return NULL;
+  }
+
+  cache[freeFn] = variant;
+  return variant;
+}
+
+//
+// Trace all uses of iterator class instance 'ic', defined by 'defMove'
+// in 'parentFn'.  Returns true and fills 'freeCalls' if every use is
+// provably confined; a single unexpected use rejects the site.
+//
+static bool icUsesAreConfined(Symbol* ic, CallExpr* defMove,
+                              FnSymbol* parentFn,
+                              std::vector<CallExpr*>& freeCalls) {
+  for_SymbolSymExprs(se, ic) {
+    if (se->getFunction() != parentFn)
+      return false;
+
+    CallExpr* parent = toCallExpr(se->parentExpr);
+    if (parent == NULL)
+      continue;
+
+    if (FnSymbol* rf = parent->resolvedFunction()) {
+      if (strcmp(rf->name, "_freeIterator") == 0) {
+        freeCalls.push_back(parent);
+        continue;
+      }
+
+      // The iterator methods advance the instance but never retain it.
+      if (rf->hasFlag(FLAG_AUTO_II) && se == parent->get(1))
+        continue;
+
+      return false;
+    }
+
+    if (parent == defMove && se == parent->get(1))
+      continue;
+
+    switch (parent->primitive ? parent->primitive->tag : PRIM_UNKNOWN) {
+    case PRIM_GET_MEMBER:
+    case PRIM_GET_MEMBER_VALUE:
+      if (se == parent->get(1))
+        continue;
+      return false;
+
+    case PRIM_SET_MEMBER:
+      // writing a field through 'ic' is fine; storing 'ic' is not
+      if (se == parent->get(1))
+        continue;
+      return false;
+
+    case PRIM_SETCID:
+    case PRIM_GETCID:
+    case PRIM_TESTCID:
+    case PRIM_END_OF_STATEMENT:
+      continue;
+
+    default:
+      return false;
+    }
+  }
+
+  return true;
+}
+
+static void stackAllocateIteratorRecords() {
+  if (fNoStackAllocateIterators)
+    return;
+
+  forv_Vec(CallExpr, call, gCallExprs) {
+    if (call->inTree() == false)
+      continue;
+
+    FnSymbol* getIterFn = call->resolvedFunction();
+    if (getIterFn == NULL ||
+        getIterFn->hasFlag(FLAG_AUTO_II) == false ||
+        strcmp(getIterFn->name, "_getIterator") != 0)
+      continue;
+
+    AggregateType* iClass = toAggregateType(getIterFn->retType);
+    if (iClass == NULL ||
+        iClass->symbol->hasFlag(FLAG_ITERATOR_CLASS) == false)
+      continue;
+
+    // a polymorphic instance needs a run-time-sized slot
+    if (iClass->dispatchChildren.n > 0)
+      continue;
+
+    CallExpr* move = toCallExpr(call->parentExpr);
+    if (move == NULL || move->isPrimitive(PRIM_MOVE) == false)
+      continue;
+
+    SymExpr* lhs = toSymExpr(move->get(1));
+    VarSymbol* ic = (lhs != NULL) ? toVarSymbol(lhs->symbol()) : NULL;
+    FnSymbol* parentFn = toFnSymbol(move->parentSymbol);
+    if (ic == NULL || parentFn == NULL ||
+        ic->defPoint->getFunction() != parentFn ||
+        parentFn->hasFlag(FLAG_AUTO_II))
+      continue;
+
+    std::vector<CallExpr*> freeCalls;
+    if (icUsesAreConfined(ic, move, parentFn, freeCalls) == false ||
+        freeCalls.empty())
+      continue;
+
+    FnSymbol* getVariant = stackGetIteratorVariant(getIterFn, iClass);
+    if (getVariant == NULL)
+      continue;
+
+    bool freesOk = true;
+    std::vector<FnSymbol*> freeVariants;
+    for_vector(CallExpr, freeCall, freeCalls) {
+      FnSymbol* fv = stackFreeIteratorVariant(freeCall->resolvedFunction());
+      if (fv == NULL)
+        freesOk = false;
+      freeVariants.push_back(fv);
+    }
+    if (freesOk == false)
+      continue;
+
+    SET_LINENO(move);
+
+    VarSymbol* stackVar = newTemp("stack_ic_tmp", iClass);
+    move->insertBefore(new DefExpr(stackVar));
+    move->insertBefore(new CallExpr(PRIM_MOVE, stackVar,
+                                    new CallExpr(PRIM_STACK_ALLOCATE_CLASS,
+                                                 iClass->symbol)));
+
+    call->baseExpr->replace(new SymExpr(getVariant));
+    call->insertAtTail(new SymExpr(stackVar));
+
+    for (size_t i = 0; i < freeCalls.size(); i++)
+      freeCalls[i]->baseExpr->replace(new SymExpr(freeVariants[i]));
+  }
+}
+
 void lowerIterators() {
   nonLeaderParCheck();
 
@@ -3050,5 +3336,7 @@ void lowerIterators() {
   cleanupIteratorBreakToken();
   cleanupPrimIRFieldValByFormal();
 
+  stackAllocateIteratorRecords();
+
   iteratorsLowered = true;
 }
@@ -106,6 +106,9 @@ static FnSymbol*      createAndInsertFunParentMethod(CallExpr*      call,
 
 static Type*          getFcfSharedWrapperType(AggregateType* parent);
 
+static bool           scanWritefFormat(const char* fmt,
+                                       std::vector<std::string>* segments);
+
 /************************************* | **************************************
 *                                                                             *
 *                                                                             *
@@ -979,6 +982,62 @@ static Expr* preFoldPrimOp(CallExpr* call) {
     break;
   }
 
+  case PRIM_WRITEF_FMT_OK: {
+    // Folds to true only when the format is a param string the scanner
+    // fully understands; writef guards the unrolled path with this, so
+    // dynamic or exotic formats quietly take the interpreter instead.
+    const char* fmt = NULL;
+    bool ok = get_string(call->get(1), &fmt) &&
+              scanWritefFormat(fmt, NULL);
+
+    retval = new SymExpr(ok ? gTrue : gFalse);
+
+    call->replace(retval);
+
+    break;
+  }
+
+  case PRIM_WRITEF_FMT_COUNT: {
+    const char* fmt = NULL;
+    std::vector<std::string> segments;
+
+    if (get_string(call->get(1), &fmt) == false ||
+        scanWritefFormat(fmt, &segments) == false) {
+      USR_FATAL(call, "'writef format count' requires a format accepted "
+                      "by 'writef format ok'");
+    }
+
+    retval = new SymExpr(new_IntSymbol(segments.size()));
+
+    call->replace(retval);
+
+    break;
+  }
+
+  case PRIM_WRITEF_FMT_SEGMENT: {
+    const char* fmt = NULL;
+    int64_t idx = 0;
+    std::vector<std::string> segments;
+
+    if (get_string(call->get(1), &fmt) == false ||
+        get_int(call->get(2), &idx) == false ||
+        scanWritefFormat(fmt, &segments) == false) {
+      USR_FATAL(call, "'writef format segment' requires a format accepted "
+                      "by 'writef format ok' and a param index");
+    }
+
+    if (idx < 0 || (size_t) idx >= segments.size()) {
+      USR_FATAL(call, "format segment index '%" PRId64 "' out of bounds "
+                      "(0..%d)", idx, (int) segments.size() - 1);
+    }
+
+    retval = new SymExpr(new_StringSymbol(segments[idx].c_str()));
+
+    call->replace(retval);
+
+    break;
+  }
+
   case PRIM_GET_SVEC_MEMBER: {
     // Convert these to PRIM_GET_SVEC_MEMBER_VALUE if the
     // field in question is a reference.
@@ -1659,10 +1718,31 @@ static Expr* preFoldPrimOp(CallExpr* call) {
 
     INT_ASSERT(se && se->symbol()->hasFlag(FLAG_TYPE_VARIABLE));
 
+    // The pretty string for a type never changes once it is computed, but
+    // toString() recomputes it (walking fields, recursing into element and
+    // domain types) every time, and generic library code asks about the
+    // same types over and over.  Memoize the resulting string literal per
+    // type; no invalidation is needed since Type identity is stable.
+    static std::map<Type*, VarSymbol*> typeStringCache;
+
     Type* t = se->symbol()->type;
-    const char* typeName = toString(t);
+    std::map<Type*, VarSymbol*>::iterator it = typeStringCache.find(t);
+    VarSymbol* typeStr = NULL;
+
+    if (it != typeStringCache.end()) {
+      typeStr = it->second;
+    } else {
+      const char* typeName = toString(t);
 
-    retval = new SymExpr(new_StringSymbol(typeName));
+      typeStr = new_StringSymbol(typeName);
+
+      // A partially-instantiated type can still print as "<type unknown>";
+      // don't freeze that answer in the cache.
+      if (strcmp(typeName, "<type unknown>") != 0)
+        typeStringCache[t] = typeStr;
+    }
+
+    retval = new SymExpr(typeStr);
 
     call->replace(retval);
 
@@ -1951,6 +2031,78 @@ static Expr* preFoldPrimOp(CallExpr* call) {
 *                                                                             *
 ************************************** | *************************************/
 
+// Scan a writef() format string into segments: maximal runs of literal
+// text and single conversion specifiers.  '%%' collapses into the
+// surrounding literal.  Returns false for anything the compile-time
+// path does not handle -- malformed specifiers, '*' width/precision
+// arguments, and the binary '%|' conversions -- so that such formats
+// fall back to the runtime format interpreter.  With segments == NULL
+// this just classifies the format.
+static bool scanWritefFormat(const char* fmt,
+                             std::vector<std::string>* segments) {
+  std::string literal;
+
+  for (const char* p = fmt; *p != '\0'; ) {
+    if (*p != '%') {
+      literal.push_back(*p);
+      p++;
+      continue;
+    }
+
+    if (p[1] == '%') {
+      literal.push_back('%');
+      p += 2;
+      continue;
+    }
+
+    if (literal.empty() == false) {
+      if (segments != NULL)
+        segments->push_back(literal);
+      literal.clear();
+    }
+
+    const char* start = p;
+
+    p++; // past '%'
+
+    while (*p == '-' || *p == '+' || *p == ' ' || *p == '0' ||
+           *p == '#' || *p == '~' || *p == '<' || *p == '>' || *p == '^')
+      p++;
+
+    while (isdigit(*p))
+      p++;
+
+    if (*p == '.') {
+      p++;
+      while (isdigit(*p))
+        p++;
+    }
+
+    // optional base, then the conversion proper
+    if (strchr("bdoxX", *p) != NULL && strchr("iu", p[1]) != NULL)
+      p++;
+
+    if (*p == '\0' || strchr("iunrmzsct", *p) == NULL)
+      return false;
+
+    p++;
+
+    if (segments != NULL)
+      segments->push_back(std::string(start, p - start));
+  }
+
+  if (literal.empty() == false && segments != NULL)
+    segments->push_back(literal);
+
+  return true;
+}
+
+/************************************* | **************************************
+*                                                                             *
+*                                                                             *
+*                                                                             *
+************************************** | *************************************/
+
 // This function finds the enum constant that matches imm.
 // imm stores a compile-time constant integer or string.
 // It's used when casting from an param integer or a param string to the
@@ -58,6 +58,7 @@ static child type could end up calling something in the parent.
 #include "symbol.h"
 #include "wrappers.h"
 
+#include <map>
 #include <set>
 #include <vector>
 
@@ -1310,7 +1311,38 @@ static void checkMethodsOverride() {
 
 static bool wasSuperDot(CallExpr* call);
 
+// With --devirtualize, calls whose override set cannot actually be reached
+// at run time are left as (or converted back to) direct calls.  The set of
+// classes the program can instantiate is approximated by scanning for
+// PRIM_SETCID, which every class allocation path inserts; resolved but
+// unreachable code can only add classes, so the approximation is sound.
+static std::set<AggregateType*> instantiatedClassTypes;
+
+static void           computeInstantiatedClassTypes();
+
+static AggregateType* receiverClass(FnSymbol* fn);
+
+static void           collectOverrideClosure(FnSymbol*             fn,
+                                             std::set<FnSymbol*>&  closure);
+
+static bool           isSubClassOrSame(AggregateType* sub,
+                                       AggregateType* super);
+
+static FnSymbol*      dispatchTargetForClass(AggregateType*             ct,
+                                             const std::set<FnSymbol*>& fns);
+
+static bool           tryDevirtualizeCall(CallExpr* call, FnSymbol* fn);
+
+static void           buildDirectCallBranch(BlockStmt* block,
+                                            CallExpr*  call,
+                                            FnSymbol*  target,
+                                            Symbol*    retSym);
+
 void insertDynamicDispatchCalls() {
+  if (fDevirtualize == true) {
+    computeInstantiatedClassTypes();
+  }
+
   forv_Vec(CallExpr, call, gCallExprs) {
     if (call->inTree()) {
       if (FnSymbol* fn = call->resolvedFunction()) {
@@ -1318,6 +1350,11 @@ void insertDynamicDispatchCalls() {
         if (virtualChildrenMap.get(fn) != NULL  &&   // There are overrides
             wasSuperDot(call)          == false &&   // Not super.<foo>()
             call->isNamed("init")      == false) {   // Not an initializer
+
+          if (fDevirtualize == true && tryDevirtualizeCall(call, fn) == true) {
+            continue;
+          }
+
           SET_LINENO(call);
 
           // The variable <cid> must have the same size as the type
@@ -1357,3 +1394,272 @@ static bool wasSuperDot(CallExpr* call) {
 
   return retval;
 }
+
+static void computeInstantiatedClassTypes() {
+  instantiatedClassTypes.clear();
+
+  forv_Vec(CallExpr, call, gCallExprs) {
+    if (call->inTree() == true && call->isPrimitive(PRIM_SETCID) == true) {
+      Type* t = canonicalClassType(call->get(1)->getValType());
+
+      if (AggregateType* at = toAggregateType(t)) {
+        if (isClass(at) == true) {
+          instantiatedClassTypes.insert(at);
+        }
+      }
+    }
+  }
+}
+
+static AggregateType* receiverClass(FnSymbol* fn) {
+  AggregateType* retval = NULL;
+
+  if (fn->_this != NULL) {
+    retval = toAggregateType(canonicalClassType(fn->_this->getValType()));
+  }
+
+  return retval;
+}
+
+// Collect fn together with every method that (transitively) overrides it
+static void collectOverrideClosure(FnSymbol*            fn,
+                                   std::set<FnSymbol*>& closure) {
+  if (closure.insert(fn).second == true) {
+    if (Vec<FnSymbol*>* children = virtualChildrenMap.get(fn)) {
+      forv_Vec(FnSymbol, child, *children) {
+        collectOverrideClosure(child, closure);
+      }
+    }
+  }
+}
+
+static bool isSubClassOrSame(AggregateType* sub, AggregateType* super) {
+  bool retval = false;
+
+  if (sub == super) {
+    retval = true;
+
+  } else {
+    forv_Vec(AggregateType, parent, sub->dispatchParents) {
+      if (isSubClassOrSame(parent, super) == true) {
+        retval = true;
+        break;
+      }
+    }
+  }
+
+  return retval;
+}
+
+// Find the method in 'fns' that an object of dynamic class 'ct' dispatches
+// to i.e. the member of 'fns' defined on the closest ancestor-or-self of 'ct'
+static FnSymbol* dispatchTargetForClass(AggregateType*             ct,
+                                        const std::set<FnSymbol*>& fns) {
+  for (std::set<FnSymbol*>::const_iterator it = fns.begin();
+       it != fns.end();
+       ++it) {
+    if (receiverClass(*it) == ct) {
+      return *it;
+    }
+  }
+
+  forv_Vec(AggregateType, parent, ct->dispatchParents) {
+    if (FnSymbol* target = dispatchTargetForClass(parent, fns)) {
+      return target;
+    }
+  }
+
+  return NULL;
+}
+
+// Emit a direct call to 'target' equivalent to the virtual call 'call',
+// casting the receiver down to the target's receiver class if necessary.
+// The shape follows buildIteratorCall() in lowerIterators.cpp.
+static void buildDirectCallBranch(BlockStmt* block,
+                                  CallExpr*  call,
+                                  FnSymbol*  target,
+                                  Symbol*    retSym) {
+  CallExpr* direct   = call->copy();
+  Type*     thisType = target->_this->getValType();
+  Expr*     thisArg  = direct->get(2);
+
+  direct->baseExpr->replace(new SymExpr(target));
+
+  if (thisArg->getValType() != thisType) {
+    VarSymbol* castThis = newTemp("_devirt_this_tmp_", thisType);
+
+    block->insertAtTail(new DefExpr(castThis));
+    block->insertAtTail(new CallExpr(PRIM_MOVE,
+                                     castThis,
+                                     new CallExpr(PRIM_CAST,
+                                                  thisType->symbol,
+                                                  thisArg->copy())));
+
+    thisArg->replace(new SymExpr(castThis));
+  }
+
+  if (retSym != NULL) {
+    if (target->retType == retSym->type) {
+      block->insertAtTail(new CallExpr(PRIM_MOVE, retSym, direct));
+
+    } else {
+      VarSymbol* retTmp = newTemp("_devirt_ret_tmp_", target->retType);
+
+      block->insertAtTail(new DefExpr(retTmp));
+      block->insertAtTail(new CallExpr(PRIM_MOVE, retTmp, direct));
+      block->insertAtTail(new CallExpr(PRIM_MOVE,
+                                       retSym,
+                                       new CallExpr(PRIM_CAST,
+                                                    retSym->type->symbol,
+                                                    retTmp)));
+    }
+
+  } else {
+    block->insertAtTail(direct);
+  }
+}
+
+// Attempt to avoid converting this call to PRIM_VIRTUAL_METHOD_CALL by
+// intersecting its override set with the instantiated classes.
+//
+//   0 live targets: no receiver class is ever allocated, so the call cannot
+//     execute; the existing static binding is retained.
+//
+//   1 live target: the site is monomorphic.  If the target is the statically
+//     bound method the call is simply left direct; if it is an override, the
+//     call is retargeted at the override with a receiver downcast.
+//
+//   2 live targets: when one target serves exactly one instantiated class,
+//     the site is expanded into a PRIM_TESTCID conditional that calls both
+//     targets directly (a compile-time inline cache); any other cid is
+//     impossible, so no virtual fallback is needed.
+//
+// Returns true if the call no longer requires dynamic dispatch.
+static bool tryDevirtualizeCall(CallExpr* call, FnSymbol* fn) {
+  AggregateType* rcvr = receiverClass(fn);
+
+  if (rcvr == NULL) {
+    return false;
+  }
+
+  std::set<FnSymbol*> closure;
+
+  collectOverrideClosure(fn, closure);
+
+  // Group the instantiated receiver classes by the method they dispatch to
+  std::map<FnSymbol*, std::vector<AggregateType*> > liveTargets;
+
+  for (std::set<AggregateType*>::iterator it = instantiatedClassTypes.begin();
+       it != instantiatedClassTypes.end();
+       ++it) {
+    AggregateType* ct = *it;
+
+    if (isSubClassOrSame(ct, rcvr) == true) {
+      if (FnSymbol* target = dispatchTargetForClass(ct, closure)) {
+        liveTargets[target].push_back(ct);
+
+      } else {
+        return false;
+      }
+    }
+  }
+
+  if (liveTargets.empty() == true) {
+    return true;
+  }
+
+  if (liveTargets.size() == 1) {
+    FnSymbol* target = liveTargets.begin()->first;
+
+    if (target == fn) {
+      return true;
+    }
+
+    // Overrides share the statically bound method's signature, so only the
+    // receiver needs adjusting; anything else is left to dynamic dispatch.
+    if (target->retType != fn->retType) {
+      return false;
+    }
+
+    SET_LINENO(call);
+
+    Type*      thisType = target->_this->getValType();
+    Expr*      thisArg  = call->get(2);
+    Expr*      stmt     = call->getStmtExpr();
+    VarSymbol* castThis = newTemp("_devirt_this_tmp_", thisType);
+
+    stmt->insertBefore(new DefExpr(castThis));
+    stmt->insertBefore(new CallExpr(PRIM_MOVE,
+                                    castThis,
+                                    new CallExpr(PRIM_CAST,
+                                                 thisType->symbol,
+                                                 thisArg->copy())));
+
+    thisArg->replace(new SymExpr(castThis));
+
+    call->baseExpr->replace(new SymExpr(target));
+
+    return true;
+  }
+
+  if (liveTargets.size() == 2) {
+    // The expansion only handles the statement shapes that resolution
+    // produces for method calls: a bare call or the rhs of a move.
+    Expr*     stmt       = call->getStmtExpr();
+    CallExpr* parentCall = toCallExpr(call->parentExpr);
+    Symbol*   retSym     = NULL;
+
+    if (call != stmt) {
+      if (parentCall                          != NULL &&
+          parentCall                          == stmt &&
+          parentCall->isPrimitive(PRIM_MOVE)  == true &&
+          parentCall->get(2)                  == call &&
+          isSymExpr(parentCall->get(1))       == true) {
+        retSym = toSymExpr(parentCall->get(1))->symbol();
+
+      } else {
+        return false;
+      }
+    }
+
+    // The cid test is an exact class comparison, so the tested target must
+    // cover exactly one instantiated class
+    std::map<FnSymbol*, std::vector<AggregateType*> >::iterator t1 =
+      liveTargets.begin();
+    std::map<FnSymbol*, std::vector<AggregateType*> >::iterator t2 = t1;
+
+    ++t2;
+
+    if (t1->second.size() != 1) {
+      std::swap(t1, t2);
+    }
+
+    if (t1->second.size() != 1) {
+      return false;
+    }
+
+    SET_LINENO(call);
+
+    VarSymbol* sel      = newTemp("_devirt_cid_tmp_", dtBool);
+    BlockStmt* thenStmt = new BlockStmt();
+    BlockStmt* elseStmt = new BlockStmt();
+
+    stmt->insertBefore(new DefExpr(sel));
+    stmt->insertBefore(new CallExpr(PRIM_MOVE,
+                                    sel,
+                                    new CallExpr(PRIM_TESTCID,
+                                                 call->get(2)->copy(),
+                                                 t1->second[0]->symbol)));
+
+    buildDirectCallBranch(thenStmt, call, t1->first, retSym);
+    buildDirectCallBranch(elseStmt, call, t2->first, retSym);
+
+    stmt->insertBefore(new CondStmt(new SymExpr(sel), thenStmt, elseStmt));
+
+    stmt->remove();
+
+    return true;
+  }
+
+  return false;
+}
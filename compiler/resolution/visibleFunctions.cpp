@@ -989,14 +989,94 @@ static void getVisibleFunctionsVI(const char*            name,
                           *visited, visibleFns, false);
 }
 
+/*
+   Cache for the full (non-POI) walk done by getVisibleFunctions().
+
+   The walk's result depends only on the starting scope and the name:
+   privacy checks and renames resolve against the call's scope chain,
+   and the starting block determines that chain.  So repeated calls to
+   the same name from the same scope -- by far the common case in
+   resolution profiles -- can reuse the collected set instead of
+   re-walking scopes and use lists.
+
+   The set a scope can see grows only when new functions appear
+   (instantiations, wrappers, ...), so the whole cache is versioned by
+   the function count, the same signal buildVisibleFunctionMap() keys
+   off of: any change throws the cache away.  The incremental POI walk
+   (the visInfo paths) maintains per-call visited state and is not
+   cached here.
+ */
+class VisibleFnsCacheEntry {
+public:
+  Map<const char*, Vec<FnSymbol*>*> fns;
+};
+
+static Map<BlockStmt*, VisibleFnsCacheEntry*> visibleFnsCache;
+
+static int visibleFnsCacheValidAtNFns = -1;
+
+static void visibleFnsCacheClear() {
+  Vec<VisibleFnsCacheEntry*> entries;
+
+  visibleFnsCache.get_values(entries);
+
+  forv_Vec(VisibleFnsCacheEntry, entry, entries) {
+    Vec<Vec<FnSymbol*>*> vfns;
+
+    entry->fns.get_values(vfns);
+
+    forv_Vec(Vec<FnSymbol*>, vfn, vfns) {
+      delete vfn;
+    }
+
+    delete entry;
+  }
+
+  visibleFnsCache.clear();
+}
+
 void getVisibleFunctions(const char*      name,
                          CallExpr*        call,
                          Vec<FnSymbol*>&  visibleFns) {
-  BlockStmt*           block    = getVisibilityScope(call);
+  BlockStmt* block = getVisibilityScope(call);
+
+  // Bypass the cache when tracing a call, so the per-scope output from
+  // the walk still appears.
+  const bool useCache = (call->id != breakOnResolveID);
+
+  if (gFnSymbols.n != visibleFnsCacheValidAtNFns) {
+    visibleFnsCacheClear();
+    visibleFnsCacheValidAtNFns = gFnSymbols.n;
+  }
+
+  VisibleFnsCacheEntry* entry = useCache ? visibleFnsCache.get(block) : NULL;
+
+  if (entry != NULL) {
+    if (Vec<FnSymbol*>* fns = entry->fns.get(name)) {
+      visibleFns.append(*fns);
+      return;
+    }
+  }
+
   std::set<BlockStmt*> visited;
+  Vec<FnSymbol*>       found;
 
   getVisibleFunctionsImpl(name, call, block, NULL,
-                          visited, visibleFns, false);
+                          visited, found, false);
+
+  visibleFns.append(found);
+
+  if (useCache) {
+    if (entry == NULL) {
+      entry = new VisibleFnsCacheEntry();
+      visibleFnsCache.put(block, entry);
+    }
+
+    Vec<FnSymbol*>* store = new Vec<FnSymbol*>();
+
+    store->append(found);
+    entry->fns.put(name, store);
+  }
 }
 
 static BlockStmt* getVisibleFnsInstantiationPt(BlockStmt* block) {
@@ -1381,6 +1461,9 @@ void visibleFunctionsClear() {
   }
 
   visibleFunctionMap.clear();
+
+  visibleFnsCacheClear();
+  visibleFnsCacheValidAtNFns = -1;
 }
 
 /************************************* | **************************************
@@ -0,0 +1,98 @@
+/*
+ * Copyright 2020-2021 Hewlett Packard Enterprise Development LP
+ * Copyright 2004-2019 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "arena.h"
+
+#include "misc.h"
+
+#include <cstdlib>
+
+// Round allocation sizes up so every returned pointer is aligned
+// suitably for any AST node.
+static const size_t arenaAlign = 2 * sizeof(void*);
+
+static inline size_t roundUp(size_t size) {
+  return (size + arenaAlign - 1) & ~(arenaAlign - 1);
+}
+
+Arena::Arena() :
+  chunks(NULL),
+  cur(NULL),
+  limit(NULL),
+  allocated(0) {
+}
+
+Arena::~Arena() {
+  clear();
+}
+
+void* Arena::allocate(size_t size) {
+  size = roundUp(size);
+
+  allocated += size;
+
+  if (cur + size > limit)
+    return allocateFromNewChunk(size);
+
+  void* retval = cur;
+
+  cur += size;
+
+  return retval;
+}
+
+void* Arena::allocateFromNewChunk(size_t size) {
+  // Give oversized requests their own chunk so that the normal chunk
+  // size bounds the waste at the tail of each chunk.
+  size_t payload = (size > chunkSize) ? size : chunkSize;
+
+  Chunk* chunk = (Chunk*) malloc(sizeof(Chunk) + payload);
+
+  if (chunk == NULL)
+    INT_FATAL("arena: out of memory");
+
+  chunk->next = chunks;
+  chunks      = chunk;
+
+  char* base  = (char*) (chunk + 1);
+
+  cur         = base + size;
+  limit       = base + payload;
+
+  return base;
+}
+
+void Arena::clear() {
+  while (chunks != NULL) {
+    Chunk* dead = chunks;
+
+    chunks = chunks->next;
+
+    free(dead);
+  }
+
+  cur       = NULL;
+  limit     = NULL;
+  allocated = 0;
+}
+
+size_t Arena::bytesAllocated() const {
+  return allocated;
+}
@@ -26,6 +26,10 @@
 #include "stringutil.h"
 
 #include <cstddef>
+#include <map>
+#include <set>
+#include <utility>
+#include <vector>
 
 astlocT currentAstLoc(0,NULL);
 
@@ -34,20 +38,112 @@ astlocT currentAstLoc(0,NULL);
 * Definitions for astlocT                                                     *
 *                                                                             *
 ************************************** | *************************************/
+
+const chpl::ID emptyAstlocId;
+
+//
+// The compressed location encoding.  With bit 31 clear, bits 30..20
+// index the filename table and bits 19..0 hold the line number; with
+// bit 31 set, bits 30..0 index the overflow table of full
+// (filename, line) pairs.  A compile sees far fewer than 2047 files
+// and lines beyond ~1M are essentially unheard of, so overflow
+// entries are rare.
+//
+static const uint32_t astlocLineBits    = 20;
+static const uint32_t astlocLineMask    = (1u << astlocLineBits) - 1;
+static const uint32_t astlocMaxFileIdx  = (1u << (31 - astlocLineBits)) - 1;
+static const uint32_t astlocOverflowBit = 1u << 31;
+
+// index 0 is reserved for "no filename" so that 0 encodes "no location"
+static std::vector<const char*> astlocFileTable(1, (const char*)nullptr);
+static std::map<const char*, uint32_t> astlocFileIndex;
+
+static std::vector<std::pair<const char*, int> > astlocOverflowTable;
+static std::map<std::pair<const char*, int>, astlocIdT> astlocOverflowIndex;
+
+astlocIdT encodeAstloc(const char* filename, int lineno) {
+  uint32_t fileIdx = 0;
+
+  if (filename != nullptr) {
+    // filenames are astrs, so the pointer itself is the key
+    std::map<const char*, uint32_t>::iterator it =
+      astlocFileIndex.find(filename);
+    if (it != astlocFileIndex.end()) {
+      fileIdx = it->second;
+    } else {
+      fileIdx = astlocFileTable.size();
+      astlocFileTable.push_back(filename);
+      astlocFileIndex.insert(std::make_pair(filename, fileIdx));
+    }
+  }
+
+  if (fileIdx <= astlocMaxFileIdx &&
+      lineno >= 0 && (uint32_t)lineno <= astlocLineMask)
+    return (fileIdx << astlocLineBits) | (uint32_t)lineno;
+
+  // otherwise, intern the location in the overflow table;
+  // interning keeps the encoding canonical so that equal ids
+  // continue to mean equal locations
+  std::pair<const char*, int> key(filename, lineno);
+  std::map<std::pair<const char*, int>, astlocIdT>::iterator it =
+    astlocOverflowIndex.find(key);
+  if (it != astlocOverflowIndex.end())
+    return it->second;
+
+  astlocIdT id = astlocOverflowBit | (uint32_t)astlocOverflowTable.size();
+  astlocOverflowTable.push_back(key);
+  astlocOverflowIndex.insert(std::make_pair(key, id));
+  return id;
+}
+
+const char* astlocFilename(astlocIdT loc) {
+  if ((loc & astlocOverflowBit) != 0)
+    return astlocOverflowTable[loc & ~astlocOverflowBit].first;
+
+  return astlocFileTable[loc >> astlocLineBits];
+}
+
+int astlocLineno(astlocIdT loc) {
+  if ((loc & astlocOverflowBit) != 0)
+    return astlocOverflowTable[loc & ~astlocOverflowBit].second;
+
+  return (int)(loc & astlocLineMask);
+}
+
+// The side table backing astlocT::id_.  std::set never moves its
+// elements, so the pointers we hand out stay valid for the life of
+// the compile.
+const chpl::ID* internAstlocId(chpl::ID id) {
+  if (id.isEmpty())
+    return nullptr;
+
+  static std::set<chpl::ID> table;
+  return &*table.insert(std::move(id)).first;
+}
+
 int astlocT::compare(const astlocT& other) const {
-  if (this->filename_ == nullptr && other.filename_ == nullptr) {
-    // compare IDs
-    return this->id_.compare(other.id_);
-  } else if (this->filename_ != nullptr && other.filename_ != nullptr) {
+  const char* lhsFilename = astlocFilename(this->loc_);
+  const char* rhsFilename = astlocFilename(other.loc_);
+
+  if (lhsFilename == nullptr && rhsFilename == nullptr) {
+    // compare (possibly null) interned IDs
+    if (this->id_ == other.id_)
+      return 0;
+    if (this->id_ == nullptr)
+      return -1;
+    if (other.id_ == nullptr)
+      return 1;
+    return this->id_->compare(*other.id_);
+  } else if (lhsFilename != nullptr && rhsFilename != nullptr) {
     // compare filename and line
-    int strResult = strcmp(this->filename_, other.filename_);
+    int strResult = strcmp(lhsFilename, rhsFilename);
     if (strResult != 0)
       return strResult;
-    return this->lineno_ - other.lineno_;
+    return astlocLineno(this->loc_) - astlocLineno(other.loc_);
   } else {
     // filename is nullptr in one but not the other
     // (arbitrarily) consider no filename < filename
-    if (this->filename_ == nullptr)
+    if (lhsFilename == nullptr)
       return -1;
     else
       return 1;
@@ -55,9 +151,9 @@ int astlocT::compare(const astlocT& other) const {
 }
 
 void astlocT::convertIdToFileLine(const char*& filename, int& lineno) const {
-  if (!this->id_.isEmpty()) {
+  if (this->id_ != nullptr) {
     // figure out the location from the ID
-    chpl::Location loc = chpl::parsing::locateId(gContext, this->id_);
+    chpl::Location loc = chpl::parsing::locateId(gContext, *this->id_);
     filename = astr(loc.path().c_str());
     lineno = loc.line();
   } else {
@@ -65,9 +161,8 @@ void astlocT::convertIdToFileLine(const char*& filename, int& lineno) const {
     lineno = 0;
   }
 
-  // cache the result in the fields for later use
-  this->filename_ = filename;
-  this->lineno_ = lineno;
+  // cache the result for later use
+  this->loc_ = encodeAstloc(filename, lineno);
 }
 
 const char* astlocT::stringLoc() const {
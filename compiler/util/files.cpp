@@ -62,6 +62,7 @@ char libmodeHeadername[FILENAME_MAX + 1]  = "";
 char fortranModulename[FILENAME_MAX + 1]  = "";
 char pythonModulename[FILENAME_MAX + 1]   = "";
 char saveCDir[FILENAME_MAX + 1]           = "";
+char externCCacheDir[FILENAME_MAX + 1]    = "";
 
 std::string ccflags;
 std::string ldflags;
@@ -635,7 +636,7 @@ static void genCFileBuildRules(FILE* makefile) {
       const char* objFilename = objectFileForCFile(inputFilename);
       fprintf(makefile, "%s: %s FORCE\n", objFilename, inputFilename);
       fprintf(makefile,
-              "\t$(CC) -c -o $@ $(GEN_CFLAGS) $(COMP_GEN_CFLAGS) $(CHPL_RT_INC_DIR) $<\n");
+              "\t$(CHPL_OBJ_CACHE_WRAP) $(CHPL_JOB_RUNNER) $(CC) -c -o $@ $(GEN_CFLAGS) $(COMP_GEN_CFLAGS) $(CHPL_RT_INC_DIR) $<\n");
       fprintf(makefile, "\n");
     }
   }
@@ -694,6 +695,89 @@ static std::string genMakefileEnvCache() {
   return result;
 }
 
+//
+// Write the object-cache wrapper script into the intermediate
+// directory.  The etc/ Makefiles prefix back-end compiles with it when
+// $(CHPL_OBJ_CACHE_DIR) is set; it keys each object on a hash of the
+// preprocessed translation unit plus the compile flags, so unchanged
+// generated code reuses cached objects across builds and build
+// directories, including a cache directory shared between users.
+//
+static void codegen_objcache_script() {
+  static const char* script = R"SH(#!/bin/sh
+#
+# usage: objcache.sh <cachedir> <compile command ...>
+#
+# Content-addressed object cache for back-end compiles, written by
+# chpl --backend-cache-dir.  The cache key is a hash of the
+# preprocessed translation unit and the compile flags, so it is
+# insensitive to the (per-compile) temporary directory names.
+
+cachedir="$1"; shift
+
+# find the object file named by -o; if there is none, just compile
+obj=
+grab=
+for a in "$@"; do
+  if [ -n "$grab" ]; then obj="$a"; grab=; continue; fi
+  [ "$a" = "-o" ] && grab=1
+done
+[ -n "$obj" ] || exec "$@"
+
+sum=
+for s in sha256sum shasum md5sum; do
+  if command -v "$s" > /dev/null 2>&1; then sum="$s"; break; fi
+done
+[ -n "$sum" ] || exec "$@"
+
+# Rebuild the command with -c and -o <obj> replaced by -E -P, and drop
+# arguments naming files in the build directory from the flag part of
+# the key; their contents are covered by the preprocessed output.
+tmpdir=`dirname "$0"`
+pre=
+key=
+skip=
+for a in "$@"; do
+  if [ -n "$skip" ]; then skip=; continue; fi
+  case "$a" in
+    -o) skip=1; continue;;
+    -c) continue;;
+  esac
+  pre="$pre $a"
+  case "$a" in
+    "$tmpdir"/*) ;;
+    *) key="$key $a";;
+  esac
+done
+
+hash=`( echo "$key"; $pre -E -P ) 2> /dev/null | $sum | awk '{print $1}'`
+[ -n "$hash" ] || exec "$@"
+
+mkdir -p "$cachedir" || exec "$@"
+cached="$cachedir/$hash.o"
+
+if [ -f "$cached" ]; then
+  cp "$cached" "$obj" && exit 0
+fi
+
+"$@" || exit $?
+
+# store atomically so concurrent builds sharing the cache don't race
+cp "$obj" "$cached.$$.tmp" && mv -f "$cached.$$.tmp" "$cached"
+exit 0
+)SH";
+
+  const char* scriptPath = genIntermediateFilename("objcache.sh");
+
+  if (FILE* fp = fopen(scriptPath, "w")) {
+    fputs(script, fp);
+    fclose(fp);
+    chmod(scriptPath, 0755);
+  } else {
+    USR_FATAL("unable to write '%s'", scriptPath);
+  }
+}
+
 void codegen_makefile(fileinfo* mainfile, const char** tmpbinname,
                       const char** tmpservername,
                       bool skip_compile_link,
@@ -800,6 +884,20 @@ void codegen_makefile(fileinfo* mainfile, const char** tmpbinname,
   fprintf(makefile.fptr, "COMP_GEN_SPECIALIZE = %i\n", specializeCCode);
   fprintf(makefile.fptr, "COMP_GEN_FLOAT_OPT = %i\n", ffloatOpt);
 
+  // Optional launcher prefix for back-end compile jobs (e.g. distcc),
+  // consumed as $(CHPL_JOB_RUNNER) by the etc/ Makefiles.
+  if (fBackendJobRunner[0] != '\0') {
+    fprintf(makefile.fptr, "CHPL_JOB_RUNNER = %s\n", fBackendJobRunner);
+  }
+
+  // Optional content-addressed object cache, consumed as
+  // $(CHPL_OBJ_CACHE_DIR) by the etc/ Makefiles; the wrapper script
+  // that implements it is written next to the generated Makefile.
+  if (fBackendCacheDir[0] != '\0') {
+    fprintf(makefile.fptr, "CHPL_OBJ_CACHE_DIR = %s\n", fBackendCacheDir);
+    codegen_objcache_script();
+  }
+
   if (fMultiLocaleInterop) {
     const char* loc = "$(CHPL_MAKE_HOME)/runtime/etc/src";
     fprintf(makefile.fptr, "COMP_GEN_MLI_EXTRA_INCLUDES = -I%s\n", loc);
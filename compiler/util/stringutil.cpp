@@ -53,7 +53,7 @@ const char* astr(const char* s1)
 
 const char* astr(const std::string& s)
 {
-  return astr(s.c_str());
+  return gContext->uniqueCString(s.c_str(), s.size());
 }
 const char* astr(UniqueString s)
 {
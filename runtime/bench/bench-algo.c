@@ -0,0 +1,128 @@
+/*
+ * Copyright 2020-2021 Hewlett Packard Enterprise Development LP
+ * Copyright 2004-2019 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//
+// Algorithm-kernel microbenchmarks: radix sort, branchless partition,
+// and parallel merge sort over uint64 keys, against libc qsort as the
+// baseline.  Reported ns-per-iteration is per element sorted or
+// partitioned, so runs with different ALGO_N are comparable.
+//
+
+#include "chplrt.h"
+#include "chpl-bench.h"
+#include "chpl-algorithms.h"
+#include "chpl-mem.h"
+#include "chpl-linefile-support.h"
+#include "chpl-tasks.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define ALGO_N      (1 << 22)          // 4 Mi keys, 32 MiB
+#define ALGO_ROUNDS 8
+
+static uint64_t* input;
+static uint64_t* work;
+
+//
+// A cheap xorshift generator so every round sorts the same data without
+// paying to re-randomize it.
+//
+static void fillInput(void) {
+  uint64_t x = UINT64_C(0x9e3779b97f4a7c15);
+
+  for (int64_t i = 0; i < ALGO_N; i++) {
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    input[i] = x;
+  }
+}
+
+static int cmpU64(const void* a, const void* b) {
+  uint64_t ka = *(const uint64_t*) a;
+  uint64_t kb = *(const uint64_t*) b;
+  return (ka > kb) - (ka < kb);
+}
+
+void chpl_bench_algoSortWorker(void* arg) {
+  chpl_algo_mergeSortWorker((chpl_task_bundle_t*) arg);
+}
+
+void chpl_bench_algo(void) {
+  uint64_t start;
+  uint64_t total;
+
+  input = chpl_mem_allocMany(ALGO_N, sizeof(uint64_t),
+                             CHPL_RT_MD_ALGO_SCRATCH,
+                             0, CHPL_FILE_IDX_INTERNAL);
+  work = chpl_mem_allocMany(ALGO_N, sizeof(uint64_t),
+                            CHPL_RT_MD_ALGO_SCRATCH,
+                            0, CHPL_FILE_IDX_INTERNAL);
+  fillInput();
+
+  // baseline: libc qsort with a comparison callback
+  total = 0;
+  for (int r = 0; r < ALGO_ROUNDS; r++) {
+    memcpy(work, input, ALGO_N * sizeof(uint64_t));
+    start = chpl_bench_now_ns();
+    qsort(work, ALGO_N, sizeof(uint64_t), cmpU64);
+    total += chpl_bench_now_ns() - start;
+  }
+  chpl_bench_report("algo_qsort_u64", (uint64_t) ALGO_ROUNDS * ALGO_N, total);
+
+  // radix sort on the same keys
+  total = 0;
+  for (int r = 0; r < ALGO_ROUNDS; r++) {
+    memcpy(work, input, ALGO_N * sizeof(uint64_t));
+    start = chpl_bench_now_ns();
+    chpl_algo_radixSort(work, ALGO_N, sizeof(uint64_t), 0, 8, false);
+    total += chpl_bench_now_ns() - start;
+  }
+  chpl_bench_report("algo_radix_sort_u64", (uint64_t) ALGO_ROUNDS * ALGO_N,
+                    total);
+
+  // branchless partition around the generator's expected median
+  total = 0;
+  for (int r = 0; r < ALGO_ROUNDS; r++) {
+    memcpy(work, input, ALGO_N * sizeof(uint64_t));
+    start = chpl_bench_now_ns();
+    (void) chpl_algo_partitionU64(work, ALGO_N, UINT64_C(1) << 63);
+    total += chpl_bench_now_ns() - start;
+  }
+  chpl_bench_report("algo_partition_u64", (uint64_t) ALGO_ROUNDS * ALGO_N,
+                    total);
+
+  // parallel merge sort, one chunk per local task
+  total = 0;
+  for (int r = 0; r < ALGO_ROUNDS; r++) {
+    memcpy(work, input, ALGO_N * sizeof(uint64_t));
+    start = chpl_bench_now_ns();
+    chpl_algo_mergeSort(work, ALGO_N, sizeof(uint64_t), cmpU64,
+                        CHPL_BENCH_FID_ALGO_SORT,
+                        chpl_task_getMaxPar());
+    total += chpl_bench_now_ns() - start;
+  }
+  chpl_bench_report("algo_merge_sort_u64", (uint64_t) ALGO_ROUNDS * ALGO_N,
+                    total);
+
+  chpl_mem_free(work, 0, CHPL_FILE_IDX_INTERNAL);
+  chpl_mem_free(input, 0, CHPL_FILE_IDX_INTERNAL);
+}
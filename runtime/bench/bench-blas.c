@@ -0,0 +1,103 @@
+/*
+ * Copyright 2020-2021 Hewlett Packard Enterprise Development LP
+ * Copyright 2004-2019 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//
+// Level-1 kernel microbenchmarks against the equivalent generic
+// element loop over unqualified pointers, which is what promoted
+// operations lower to.  Reported ns-per-iteration is per element.
+//
+
+#include "chplrt.h"
+#include "chpl-bench.h"
+#include "chpl-blas-lite.h"
+#include "chpl-mem.h"
+#include "chpl-linefile-support.h"
+
+#define BLAS_N      (1 << 22)          // 4 Mi elements, 32 MiB each
+#define BLAS_ROUNDS 8
+
+static double* bufX;
+static double* bufY;
+static double* bufZ;
+
+// the generic lowering: no restrict, so the compiler must assume the
+// operands may alias
+static void genericAxpy(double* y, double a, const double* x, int64_t n) {
+  for (int64_t i = 0; i < n; i++)
+    y[i] += a * x[i];
+}
+
+// keep results observable so the kernels aren't optimized away
+static volatile double gBlasSink;
+
+void chpl_bench_blas(void) {
+  uint64_t start, elapsed;
+  const uint64_t perElt = (uint64_t)BLAS_N * BLAS_ROUNDS;
+
+  bufX = chpl_mem_allocMany(BLAS_N, sizeof(double), CHPL_RT_MD_ALGO_SCRATCH,
+                            0, CHPL_FILE_IDX_INTERNAL);
+  bufY = chpl_mem_allocMany(BLAS_N, sizeof(double), CHPL_RT_MD_ALGO_SCRATCH,
+                            0, CHPL_FILE_IDX_INTERNAL);
+  bufZ = chpl_mem_allocMany(BLAS_N, sizeof(double), CHPL_RT_MD_ALGO_SCRATCH,
+                            0, CHPL_FILE_IDX_INTERNAL);
+
+  for (int64_t i = 0; i < BLAS_N; i++) {
+    bufX[i] = (double)i * 0.5;
+    bufY[i] = (double)i * 0.25;
+  }
+
+  start = chpl_bench_now_ns();
+  for (int round = 0; round < BLAS_ROUNDS; round++)
+    genericAxpy(bufY, 1.000001, bufX, BLAS_N);
+  elapsed = chpl_bench_now_ns() - start;
+  gBlasSink = bufY[BLAS_N - 1];
+  chpl_bench_report("blas_generic_axpy", perElt, elapsed);
+
+  start = chpl_bench_now_ns();
+  for (int round = 0; round < BLAS_ROUNDS; round++)
+    chpl_blas_daxpy(bufY, 1.000001, bufX, BLAS_N);
+  elapsed = chpl_bench_now_ns() - start;
+  gBlasSink = bufY[BLAS_N - 1];
+  chpl_bench_report("blas_daxpy", perElt, elapsed);
+
+  start = chpl_bench_now_ns();
+  for (int round = 0; round < BLAS_ROUNDS; round++)
+    chpl_blas_daxpyz(bufZ, 2.0, bufX, bufY, BLAS_N);
+  elapsed = chpl_bench_now_ns() - start;
+  gBlasSink = bufZ[BLAS_N - 1];
+  chpl_bench_report("blas_daxpyz", perElt, elapsed);
+
+  start = chpl_bench_now_ns();
+  for (int round = 0; round < BLAS_ROUNDS; round++)
+    gBlasSink = chpl_blas_ddot(bufX, bufY, BLAS_N);
+  elapsed = chpl_bench_now_ns() - start;
+  chpl_bench_report("blas_ddot", perElt, elapsed);
+
+  start = chpl_bench_now_ns();
+  for (int round = 0; round < BLAS_ROUNDS; round++)
+    chpl_blas_dscal(bufY, 0.999999, BLAS_N);
+  elapsed = chpl_bench_now_ns() - start;
+  gBlasSink = bufY[BLAS_N - 1];
+  chpl_bench_report("blas_dscal", perElt, elapsed);
+
+  chpl_mem_free(bufZ, 0, CHPL_FILE_IDX_INTERNAL);
+  chpl_mem_free(bufY, 0, CHPL_FILE_IDX_INTERNAL);
+  chpl_mem_free(bufX, 0, CHPL_FILE_IDX_INTERNAL);
+}
@@ -0,0 +1,142 @@
+/*
+ * Copyright 2020-2021 Hewlett Packard Enterprise Development LP
+ * Copyright 2004-2019 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//
+// Comm-layer microbenchmarks: executeOn round trips and GET/PUT
+// latency and bandwidth against the next locale over.  All of these
+// are skipped in single-locale runs.
+//
+
+#include "chplrt.h"
+#include "chpl-bench.h"
+#include "chpl-comm.h"
+#include "chpl-comm-compiler-macros.h"
+#include "chpl-linefile-support.h"
+#include "chpl-tasks.h"
+
+// Don't get warning macros for chpl_comm_put etc.
+#include "chpl-comm-no-warning-macros.h"
+
+#include <string.h>
+
+#define COMM_ON_ITERS    10000
+#define COMM_SMALL_ITERS 10000
+#define COMM_LARGE_ITERS 1000
+#define COMM_BUF_SIZE    (1 << 20)
+
+// Transfer source/target on every locale.  Its address is exchanged
+// through the executeOn handler below rather than assumed symmetric,
+// so the benchmarks work under any comm layer's address model.
+static char commBuf[COMM_BUF_SIZE];
+
+typedef struct {
+  chpl_comm_on_bundle_t on;
+  c_nodeid_t replyNode;   // who asked, or -1 for the no-op latency case
+  void* replyAddr;        // where to PUT our commBuf address
+} chpl_bench_on_arg_t;
+
+// ftable[CHPL_BENCH_FID_ON_NOP] (see bench-main.c): a no-op for the
+// executeOn latency benchmarks that doubles as the address exchange.
+void chpl_bench_onNop(chpl_comm_on_bundle_t* bundle) {
+  chpl_bench_on_arg_t* a = (chpl_bench_on_arg_t*) bundle;
+  if (a->replyNode >= 0) {
+    void* addr = commBuf;
+    chpl_comm_put(&addr, a->replyNode, a->replyAddr, sizeof(addr),
+                  CHPL_COMM_UNKNOWN_ID, 0, CHPL_FILE_IDX_INTERNAL);
+  }
+}
+
+// Fetch the peer's commBuf address; the blocking executeOn is the
+// reply fence for the handler's PUT.
+static void* peerBufAddr(c_nodeid_t peer) {
+  chpl_bench_on_arg_t arg;
+  void* addr = NULL;
+
+  memset(&arg, 0, sizeof(arg));
+  arg.replyNode = chpl_nodeID;
+  arg.replyAddr = &addr;
+  chpl_comm_execute_on(peer, c_sublocid_any, CHPL_BENCH_FID_ON_NOP,
+                       &arg.on, sizeof(arg), 0, CHPL_FILE_IDX_INTERNAL);
+  return addr;
+}
+
+static void benchExecuteOn(c_nodeid_t peer, chpl_bool fast) {
+  chpl_bench_on_arg_t arg;
+  uint64_t start;
+
+  memset(&arg, 0, sizeof(arg));
+  arg.replyNode = -1;
+
+  start = chpl_bench_now_ns();
+  for (int i = 0; i < COMM_ON_ITERS; i++) {
+    if (fast)
+      chpl_comm_execute_on_fast(peer, c_sublocid_any, CHPL_BENCH_FID_ON_NOP,
+                                &arg.on, sizeof(arg),
+                                0, CHPL_FILE_IDX_INTERNAL);
+    else
+      chpl_comm_execute_on(peer, c_sublocid_any, CHPL_BENCH_FID_ON_NOP,
+                           &arg.on, sizeof(arg), 0, CHPL_FILE_IDX_INTERNAL);
+  }
+  chpl_bench_report(fast ? "comm_execute_on_fast" : "comm_execute_on",
+                    COMM_ON_ITERS, chpl_bench_now_ns() - start);
+}
+
+static void benchGetPut(c_nodeid_t peer, void* peerBuf,
+                        size_t size, int iters,
+                        const char* getName, const char* putName) {
+  uint64_t start;
+
+  start = chpl_bench_now_ns();
+  for (int i = 0; i < iters; i++)
+    chpl_comm_get(commBuf, peer, peerBuf, size,
+                  CHPL_COMM_UNKNOWN_ID, 0, CHPL_FILE_IDX_INTERNAL);
+  chpl_bench_report(getName, iters, chpl_bench_now_ns() - start);
+
+  start = chpl_bench_now_ns();
+  for (int i = 0; i < iters; i++)
+    chpl_comm_put(commBuf, peer, peerBuf, size,
+                  CHPL_COMM_UNKNOWN_ID, 0, CHPL_FILE_IDX_INTERNAL);
+  chpl_bench_report(putName, iters, chpl_bench_now_ns() - start);
+}
+
+void chpl_bench_comm(void) {
+  c_nodeid_t peer;
+  void* peerBuf;
+
+  if (chpl_numNodes < 2) {
+    chpl_bench_skip("comm_execute_on", "single locale");
+    chpl_bench_skip("comm_execute_on_fast", "single locale");
+    chpl_bench_skip("comm_get_8", "single locale");
+    chpl_bench_skip("comm_put_8", "single locale");
+    chpl_bench_skip("comm_get_1m", "single locale");
+    chpl_bench_skip("comm_put_1m", "single locale");
+    return;
+  }
+
+  peer = (chpl_nodeID + 1) % chpl_numNodes;
+  peerBuf = peerBufAddr(peer);
+
+  benchExecuteOn(peer, false);
+  benchExecuteOn(peer, true);
+  benchGetPut(peer, peerBuf, sizeof(uint64_t), COMM_SMALL_ITERS,
+              "comm_get_8", "comm_put_8");
+  benchGetPut(peer, peerBuf, COMM_BUF_SIZE, COMM_LARGE_ITERS,
+              "comm_get_1m", "comm_put_1m");
+}
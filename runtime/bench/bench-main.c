@@ -0,0 +1,131 @@
+/*
+ * Copyright 2020-2021 Hewlett Packard Enterprise Development LP
+ * Copyright 2004-2019 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//
+// Entry point and generated-code stand-ins for the benchmark
+// executable.  A normal Chapel program gets these symbols from the
+// compiler (chpl_compilation_config.c and the generated module code);
+// here we provide the minimal versions a pure-runtime program needs,
+// so the suite links against the runtime library exactly the way a
+// compiled program does, including main.c's startup path.
+//
+
+#include "chplrt.h"
+#include "chpl-bench.h"
+#include "chpl-comm.h"
+#include "chpl-tasks.h"
+#include "chplcgfns.h"
+#include "config.h"
+
+#include <stddef.h>
+
+void chpl_bench_taskNop(void* arg);                      // bench-tasks.c
+void chpl_bench_onNop(chpl_comm_on_bundle_t* bundle);    // bench-comm.c
+void chpl_bench_algoSortWorker(void* arg);               // bench-algo.c
+
+const chpl_fn_p chpl_ftable[] = {
+  (chpl_fn_p) chpl_bench_taskNop,        // CHPL_BENCH_FID_TASK_NOP
+  (chpl_fn_p) chpl_bench_onNop,          // CHPL_BENCH_FID_ON_NOP
+  (chpl_fn_p) chpl_bench_algoSortWorker, // CHPL_BENCH_FID_ALGO_SORT
+};
+const chpl_bool chpl_ftableNonBlocking[] = { false, false, false };
+const chpl_fn_info chpl_finfo[] = {
+  { "chpl_bench_taskNop", 0, 0 },
+  { "chpl_bench_onNop", 0, 0 },
+  { "chpl_bench_algoSortWorker", 0, 0 },
+};
+
+// compilation configuration normally emitted by the compiler
+const char* chpl_compileCommand = "chpl-bench";
+const char* chpl_compileVersion = "chpl-bench";
+const char* chpl_compileDirectory = ".";
+const char* chpl_saveCDir = "";
+const char* CHPL_HOME = "";
+const char* CHPL_HOST_PLATFORM = "";
+const char* CHPL_HOST_COMPILER = "";
+const char* CHPL_TARGET_PLATFORM = "";
+const char* CHPL_TARGET_COMPILER = "";
+const char* CHPL_TARGET_CPU = "";
+const char* CHPL_LOCALE_MODEL = "flat";
+const char* CHPL_COMM = "";
+const char* CHPL_COMM_SUBSTRATE = "";
+const char* CHPL_GASNET_SEGMENT = "";
+const char* CHPL_LIBFABRIC = "";
+const char* CHPL_TASKS = "";
+const char* CHPL_LAUNCHER = "";
+const char* CHPL_TIMERS = "";
+const char* CHPL_MEM = "";
+const char* CHPL_MAKE = "";
+const char* CHPL_ATOMICS = "";
+const char* CHPL_NETWORK_ATOMICS = "";
+const char* CHPL_GMP = "";
+const char* CHPL_HWLOC = "";
+const char* CHPL_RE2 = "";
+const char* CHPL_LLVM = "";
+const char* CHPL_AUX_FILESYS = "";
+const char* CHPL_UNWIND = "";
+const char* CHPL_RUNTIME_LIB = "";
+const char* CHPL_RUNTIME_INCL = "";
+const char* CHPL_THIRD_PARTY = "";
+const int CHPL_STACK_CHECKS = 0;
+const int CHPL_CACHE_REMOTE = 0;
+const int CHPL_INTERLEAVE_MEM = 0;
+const int CHPL_WIDE_POINTERS_NODE_BITS = 0;
+
+// one entry: the internal "<internal>" filename at index 0
+const c_char chpl_filenameTableData[] = "<internal>";
+const c_int chpl_filenameTableOffsets[] = { 0 };
+const int32_t chpl_filenameTableSize = 1;
+
+const c_string chpl_funSymTable[] = { NULL };
+const int chpl_filenumSymTable[] = { 0 };
+const int32_t chpl_sizeSymTable = 0;
+
+const int mainHasArgs = 0;
+const int mainPreserveDelimiter = 0;
+
+ptr_wide_ptr_t chpl_globals_registry[1];
+const int chpl_numGlobalsOnHeap = 0;
+
+void chpl__initStringLiterals(void) { }
+void chpl__heapAllocateGlobals(void) { }
+void chpl__init_preInit(int64_t _ln, int32_t _fn) { }
+void chpl__init_PrintModuleInitOrder(int64_t _ln, int32_t _fn) { }
+void chpl__init_ChapelStandard(int64_t _ln, int32_t _fn) { }
+void CreateConfigVarTable(void) { }
+void chpl_libraryModuleLevelSetup(void) { }
+void chpl_libraryModuleLevelCleanup(void) { }
+void chpl_deinitModules(void) { }
+
+//
+// The "user program": run the benchmark groups on locale 0.  The other
+// locales sit in the runtime's AM handler loop servicing the comm
+// benchmarks, same as for any compiled Chapel program.
+//
+int64_t chpl_gen_main(chpl_main_argument* const _arg) {
+  chpl_bench_tasks();
+  chpl_bench_comm();
+  chpl_bench_qio();
+  chpl_bench_algo();
+  chpl_bench_queue();
+  chpl_bench_blas();
+  chpl_bench_numarepl();
+  return 0;
+}
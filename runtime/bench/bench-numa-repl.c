@@ -0,0 +1,78 @@
+/*
+ * Copyright 2020-2021 Hewlett Packard Enterprise Development LP
+ * Copyright 2004-2019 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//
+// NUMA-replicated storage microbenchmarks: table lookups through a
+// single shared copy vs. through the local replica.  On one NUMA
+// domain the two are the same memory and should report the same; the
+// replication pays off in the multi-socket configurations.
+//
+
+#include "chplrt.h"
+#include "chpl-bench.h"
+#include "chpl-numa-repl.h"
+#include "chpl-mem.h"
+#include "chpl-linefile-support.h"
+
+#include <stdint.h>
+
+#define REPL_TABLE_LEN   (1 << 16)
+#define REPL_LOOKUPS     (1 << 24)
+
+volatile uint64_t gReplSink;
+
+static uint64_t lookupLoop(const uint64_t* table) {
+  uint64_t sum = 0;
+  uint64_t idx = 12345;
+
+  for (uint64_t i = 0; i < REPL_LOOKUPS; i++) {
+    sum += table[idx & (REPL_TABLE_LEN - 1)];
+    idx = idx * 6364136223846793005ULL + 1442695040888963407ULL;
+  }
+  return sum;
+}
+
+void chpl_bench_numarepl(void) {
+  uint64_t* shared;
+  chpl_numa_repl_t* repl;
+  uint64_t start, elapsed;
+
+  shared = chpl_mem_allocMany(REPL_TABLE_LEN, sizeof(uint64_t),
+                              CHPL_RT_MD_NUMA_REPL_DATA,
+                              0, CHPL_FILE_IDX_INTERNAL);
+  for (uint64_t i = 0; i < REPL_TABLE_LEN; i++) {
+    shared[i] = i * 2654435761ULL;
+  }
+
+  repl = chpl_numa_repl_create(REPL_TABLE_LEN * sizeof(uint64_t), shared);
+
+  start = chpl_bench_now_ns();
+  gReplSink = lookupLoop(shared);
+  elapsed = chpl_bench_now_ns() - start;
+  chpl_bench_report("numarepl_shared_lookup", REPL_LOOKUPS, elapsed);
+
+  start = chpl_bench_now_ns();
+  gReplSink = lookupLoop(chpl_numa_repl_localPtr(repl));
+  elapsed = chpl_bench_now_ns() - start;
+  chpl_bench_report("numarepl_local_lookup", REPL_LOOKUPS, elapsed);
+
+  chpl_numa_repl_destroy(repl);
+  chpl_mem_free(shared, 0, CHPL_FILE_IDX_INTERNAL);
+}
@@ -0,0 +1,104 @@
+/*
+ * Copyright 2020-2021 Hewlett Packard Enterprise Development LP
+ * Copyright 2004-2019 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//
+// qio microbenchmarks: channel write and read throughput in 64 KiB
+// chunks through a temporary file, plus small (8-byte) channel reads
+// to expose the per-call overhead the buffered fast path is meant to
+// hide.  Reported ns-per-iteration is per chunk; divide by the chunk
+// size for per-byte cost.
+//
+
+#include "chplrt.h"
+#include "chpl-bench.h"
+#include "qio.h"
+
+#include <string.h>
+
+#define QIO_CHUNK_SIZE  (64 * 1024)
+#define QIO_NUM_CHUNKS  1024           // 64 MiB total
+#define QIO_SMALL_ITERS 1000000
+
+static unsigned char chunk[QIO_CHUNK_SIZE];
+
+static qioerr openChannel(qio_file_t* f, qio_channel_t** ch,
+                          int readable, int writeable) {
+  return qio_channel_create(ch, f, QIO_HINT_CACHED,
+                            readable, writeable, 0, INT64_MAX, NULL);
+}
+
+void chpl_bench_qio(void) {
+  qio_file_t* f = NULL;
+  qio_channel_t* ch = NULL;
+  uint64_t start;
+  qioerr err;
+
+  err = qio_file_open_tmp(&f, 0, NULL);
+  if (err) {
+    chpl_bench_skip("qio_channel_write", "cannot open tmp file");
+    chpl_bench_skip("qio_channel_read", "cannot open tmp file");
+    chpl_bench_skip("qio_channel_read_8", "cannot open tmp file");
+    return;
+  }
+
+  memset(chunk, 0xa5, sizeof(chunk));
+
+  // write throughput, including the final flush
+  err = openChannel(f, &ch, 0, 1);
+  start = chpl_bench_now_ns();
+  for (int i = 0; i < QIO_NUM_CHUNKS && !err; i++)
+    err = qio_channel_write_amt(false, ch, chunk, sizeof(chunk));
+  if (!err)
+    err = qio_channel_flush(false, ch);
+  if (err)
+    chpl_bench_skip("qio_channel_write", "write error");
+  else
+    chpl_bench_report("qio_channel_write", QIO_NUM_CHUNKS,
+                      chpl_bench_now_ns() - start);
+  qio_channel_release(ch);
+
+  // read throughput over the data just written
+  err = openChannel(f, &ch, 1, 0);
+  start = chpl_bench_now_ns();
+  for (int i = 0; i < QIO_NUM_CHUNKS && !err; i++)
+    err = qio_channel_read_amt(false, ch, chunk, sizeof(chunk));
+  if (err)
+    chpl_bench_skip("qio_channel_read", "read error");
+  else
+    chpl_bench_report("qio_channel_read", QIO_NUM_CHUNKS,
+                      chpl_bench_now_ns() - start);
+  qio_channel_release(ch);
+
+  // small reads: per-call overhead on the buffered path
+  err = openChannel(f, &ch, 1, 0);
+  start = chpl_bench_now_ns();
+  for (int i = 0; i < QIO_SMALL_ITERS && !err; i++) {
+    uint64_t v;
+    err = qio_channel_read_amt(false, ch, &v, sizeof(v));
+  }
+  if (err)
+    chpl_bench_skip("qio_channel_read_8", "read error");
+  else
+    chpl_bench_report("qio_channel_read_8", QIO_SMALL_ITERS,
+                      chpl_bench_now_ns() - start);
+  qio_channel_release(ch);
+
+  qio_file_release(f);
+}
@@ -0,0 +1,64 @@
+/*
+ * Copyright 2020-2021 Hewlett Packard Enterprise Development LP
+ * Copyright 2004-2019 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//
+// MPMC queue microbenchmarks: the uncontended fast path (alternating
+// enqueue/dequeue on a queue that is never full or empty) and the
+// fill/drain pattern that stresses the slot sequence handoff across a
+// whole lap of the ring.
+//
+
+#include "chplrt.h"
+#include "chpl-bench.h"
+#include "chpl-queue.h"
+#include "chpl-linefile-support.h"
+
+#define QUEUE_CAP    1024
+#define QUEUE_OPS    (1 << 22)
+
+void chpl_bench_queue(void) {
+  chpl_queue_t* q = chpl_queue_create(QUEUE_CAP, sizeof(uint64_t));
+  uint64_t start, elapsed;
+  uint64_t v = 0;
+
+  // alternating enqueue/dequeue: each iteration is one op pair
+  start = chpl_bench_now_ns();
+  for (uint64_t i = 0; i < QUEUE_OPS; i++) {
+    chpl_queue_enqueue(q, &i);
+    chpl_queue_dequeue(q, &v);
+  }
+  elapsed = chpl_bench_now_ns() - start;
+  chpl_bench_report("queue_enq_deq", QUEUE_OPS, elapsed);
+
+  // fill to capacity, then drain; each iteration is one op
+  start = chpl_bench_now_ns();
+  for (uint64_t round = 0; round < QUEUE_OPS / QUEUE_CAP; round++) {
+    for (uint64_t i = 0; i < QUEUE_CAP; i++) {
+      chpl_queue_enqueue(q, &i);
+    }
+    for (uint64_t i = 0; i < QUEUE_CAP; i++) {
+      chpl_queue_dequeue(q, &v);
+    }
+  }
+  elapsed = chpl_bench_now_ns() - start;
+  chpl_bench_report("queue_fill_drain", 2 * QUEUE_OPS, elapsed);
+
+  chpl_queue_destroy(q);
+}
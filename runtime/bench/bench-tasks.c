@@ -0,0 +1,114 @@
+/*
+ * Copyright 2020-2021 Hewlett Packard Enterprise Development LP
+ * Copyright 2004-2019 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//
+// Tasking-layer microbenchmarks: task spawn latency through
+// chpl_task_addTask and chpl_task_addTasksBulk, and yield cost.
+//
+
+#include "chplrt.h"
+#include "chpl-bench.h"
+#include "chpl-atomics.h"
+#include "chpl-linefile-support.h"
+#include "chpl-tasks.h"
+
+#include <string.h>
+
+#define TASK_SPAWN_ITERS 100000
+#define YIELD_ITERS      1000000
+
+// The bundle for the no-op task: the standard header plus a pointer
+// to the spawner's completion counter in the payload.
+typedef struct {
+  chpl_task_bundle_t task;
+  atomic_int_least64_t* pending;
+} chpl_bench_task_arg_t;
+
+// ftable[CHPL_BENCH_FID_TASK_NOP] (see bench-main.c)
+void chpl_bench_taskNop(void* arg) {
+  chpl_bench_task_arg_t* a = (chpl_bench_task_arg_t*) arg;
+  atomic_fetch_sub_int_least64_t(a->pending, 1);
+}
+
+static void waitForZero(atomic_int_least64_t* pending) {
+  while (atomic_load_int_least64_t(pending) != 0)
+    chpl_task_yield();
+}
+
+// Time from the first chpl_task_addTask call until every spawned task
+// has run: per-iteration cost covers enqueue, dispatch, and the no-op
+// body.
+static void benchAddTask(void) {
+  atomic_int_least64_t pending;
+  chpl_bench_task_arg_t arg;
+  uint64_t start;
+
+  atomic_init_int_least64_t(&pending, TASK_SPAWN_ITERS);
+  memset(&arg, 0, sizeof(arg));
+  arg.pending = &pending;
+
+  start = chpl_bench_now_ns();
+  for (int i = 0; i < TASK_SPAWN_ITERS; i++) {
+    chpl_task_addTask(CHPL_BENCH_FID_TASK_NOP, &arg.task, sizeof(arg),
+                      c_sublocid_any, 0, CHPL_FILE_IDX_INTERNAL);
+  }
+  waitForZero(&pending);
+  chpl_bench_report("task_addTask", TASK_SPAWN_ITERS,
+                    chpl_bench_now_ns() - start);
+
+  atomic_destroy_int_least64_t(&pending);
+}
+
+// Same work submitted as one bulk call, to expose the per-task entry
+// cost the bulk path amortizes.
+static void benchAddTasksBulk(void) {
+  atomic_int_least64_t pending;
+  static chpl_bench_task_arg_t args[TASK_SPAWN_ITERS];
+  uint64_t start;
+
+  atomic_init_int_least64_t(&pending, TASK_SPAWN_ITERS);
+  memset(args, 0, sizeof(args));
+  for (int i = 0; i < TASK_SPAWN_ITERS; i++)
+    args[i].pending = &pending;
+
+  start = chpl_bench_now_ns();
+  chpl_task_addTasksBulk(CHPL_BENCH_FID_TASK_NOP, &args[0].task,
+                         sizeof(args[0]), TASK_SPAWN_ITERS,
+                         c_sublocid_any, 0, CHPL_FILE_IDX_INTERNAL);
+  waitForZero(&pending);
+  chpl_bench_report("task_addTasksBulk", TASK_SPAWN_ITERS,
+                    chpl_bench_now_ns() - start);
+
+  atomic_destroy_int_least64_t(&pending);
+}
+
+static void benchYield(void) {
+  uint64_t start = chpl_bench_now_ns();
+  for (int i = 0; i < YIELD_ITERS; i++)
+    chpl_task_yield();
+  chpl_bench_report("task_yield", YIELD_ITERS,
+                    chpl_bench_now_ns() - start);
+}
+
+void chpl_bench_tasks(void) {
+  benchAddTask();
+  benchAddTasksBulk();
+  benchYield();
+}
@@ -0,0 +1,48 @@
+/*
+ * Copyright 2020-2021 Hewlett Packard Enterprise Development LP
+ * Copyright 2004-2019 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "chplrt.h"
+#include "chpl-bench.h"
+#include "chpl-comm.h"
+
+#include <stdio.h>
+#include <time.h>
+
+uint64_t chpl_bench_now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t) ts.tv_sec * 1000000000ull + (uint64_t) ts.tv_nsec;
+}
+
+void chpl_bench_report(const char* name, uint64_t iters, uint64_t totalNs) {
+  if (chpl_nodeID != 0)
+    return;
+  printf("CHPL-BENCH,%s,%llu,%llu,%.1f\n", name,
+         (unsigned long long) iters, (unsigned long long) totalNs,
+         iters == 0 ? 0.0 : (double) totalNs / (double) iters);
+  fflush(stdout);
+}
+
+void chpl_bench_skip(const char* name, const char* reason) {
+  if (chpl_nodeID != 0)
+    return;
+  printf("CHPL-SKIP,%s,%s\n", name, reason);
+  fflush(stdout);
+}
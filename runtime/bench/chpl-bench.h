@@ -0,0 +1,72 @@
+/*
+ * Copyright 2020-2021 Hewlett Packard Enterprise Development LP
+ * Copyright 2004-2019 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _chpl_bench_h_
+#define _chpl_bench_h_
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//
+// Shared harness for the runtime microbenchmarks (see README).  Each
+// benchmark times a loop around one runtime entry point and reports
+// one machine-readable line on stdout:
+//
+//   CHPL-BENCH,<name>,<iterations>,<total-ns>,<ns-per-iteration>
+//
+// or, when a benchmark cannot run in the current configuration
+// (e.g. comm benchmarks with a single locale):
+//
+//   CHPL-SKIP,<name>,<reason>
+//
+// Only locale 0 reports, so output can be collected from stdout as is.
+//
+
+// Monotonic wall-clock time.  The timers/ layer headers would be the
+// natural choice here, but the benchmarks want one fixed clock across
+// all configurations so runs are comparable.
+uint64_t chpl_bench_now_ns(void);
+
+void chpl_bench_report(const char* name, uint64_t iters, uint64_t totalNs);
+void chpl_bench_skip(const char* name, const char* reason);
+
+// The benchmark groups, run in this order by bench-main.c.
+void chpl_bench_tasks(void);
+void chpl_bench_comm(void);
+void chpl_bench_qio(void);
+void chpl_bench_algo(void);
+void chpl_bench_queue(void);
+void chpl_bench_blas(void);
+void chpl_bench_numarepl(void);
+
+// ftable layout for the benchmark executable; bench-main.c defines
+// chpl_ftable[] with these entries.
+#define CHPL_BENCH_FID_TASK_NOP   0
+#define CHPL_BENCH_FID_ON_NOP     1
+#define CHPL_BENCH_FID_ALGO_SORT  2
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,100 @@
+/*
+ * Copyright 2020-2021 Hewlett Packard Enterprise Development LP
+ * Copyright 2004-2019 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//
+// Native sorting and partitioning kernels for POD element types.
+//
+// Comparison-callback sorts spend most of their time in the callback;
+// for trivially copyable elements with fixed-width integral keys the
+// runtime can do far better with key-aware kernels.  This library
+// provides:
+//
+// * an LSD radix sort over elements carrying a 1/2/4/8-byte integral
+//   key at a fixed offset, one counting pass and one scatter per key
+//   byte, with constant-byte passes skipped entirely;
+//
+// * a branchless stable partition on 64-bit keys whose counting and
+//   scatter loops are written so the back-end compiler can vectorize
+//   them;
+//
+// * a parallel merge sort that sorts per-task chunks and then merges
+//   them as a tree of tasks, one tasking-layer task per chunk or merge.
+//
+// Tasks must enter through chpl_ftable[], so parallel sorting follows
+// the same contract as the work-stealing engine: the caller registers a
+// wrapper that forwards its bundle to chpl_algo_mergeSortWorker() and
+// passes that wrapper's ftable index in.  Callers without a wrapper (or
+// running serial) pass FID_NONE and get a serial sort.
+//
+
+#ifndef _chpl_algorithms_h_
+#define _chpl_algorithms_h_
+
+#include "chpltypes.h"
+#include "chpl-tasks.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//
+// qsort-compatible comparison: negative/zero/positive for <, ==, >.
+//
+typedef int (*chpl_algo_cmp_t)(const void*, const void*);
+
+//
+// Sort n elements of eltSize bytes each by the keyBytes-wide integral
+// key living keyOff bytes into every element.  keyBytes must be 1, 2,
+// 4, or 8; signed keys are ordered correctly when keyIsSigned is set.
+// Stable; uses an n-element scratch buffer.
+//
+void chpl_algo_radixSort(void* elts, int64_t n, size_t eltSize,
+                         size_t keyOff, int keyBytes,
+                         chpl_bool keyIsSigned);
+
+//
+// Stably partition keys[0..n) so everything less than pivot precedes
+// everything else, returning the number of keys less than pivot.
+//
+int64_t chpl_algo_partitionU64(uint64_t* keys, int64_t n, uint64_t pivot);
+
+//
+// Sort n elements of eltSize bytes each by cmp, using up to nTasks
+// tasks dispatched through workerFid.  With FID_NONE or nTasks <= 1
+// the sort runs serially in the caller's task.
+//
+void chpl_algo_mergeSort(void* elts, int64_t n, size_t eltSize,
+                         chpl_algo_cmp_t cmp,
+                         chpl_fn_int_t workerFid, int64_t nTasks);
+
+//
+// The body of one parallel sort task; the caller's ftable wrapper must
+// forward its argument bundle here unchanged.
+//
+void chpl_algo_mergeSortWorker(chpl_task_bundle_t* bundle);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
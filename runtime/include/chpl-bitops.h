@@ -30,6 +30,7 @@
 #define _chpl_bitops_h_
 
 #include <assert.h>
+#include <stddef.h>
 #include <stdint.h>
 #include <limits.h>
 
@@ -250,6 +251,24 @@ CHPL_BITOPS_ROTR(64)
 #undef CHPL_BITOPS_ROTR
 #undef UI
 
+// chpl_bitops_memeq / chpl_bitops_memhash / chpl_bitops_popcount_mem
+// ------------------------------------------------------------------
+// Bulk memory kernels for the compiler's comparison and hash lowering
+// (record/string equality, associative-domain hashing).  They work a
+// 64-bit word at a time with unaligned-safe loads, which backend
+// compilers turn into SIMD under -O3; byte-at-a-time loops in the
+// generated code do not get that treatment.
+
+// Returns: nonzero if the n bytes at a and b are equal
+int chpl_bitops_memeq(const void* a, const void* b, size_t n);
+
+// MurmurHash64A over the n bytes at p.
+// Returns: a 64-bit hash of the buffer
+uint64_t chpl_bitops_memhash(const void* p, size_t n, uint64_t seed);
+
+// Returns: number of bits set across the n bytes at p
+uint64_t chpl_bitops_popcount_mem(const void* p, size_t n);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,72 @@
+/*
+ * Copyright 2020-2021 Hewlett Packard Enterprise Development LP
+ * Copyright 2004-2019 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//
+// Tuned level-1 kernels for whole-array numeric operations.
+//
+// Promoted scalar operations lower to generic element loops; for the
+// handful of shapes that dominate numeric codes (copy, scale, axpy,
+// dot) a contiguous kernel with restrict-qualified operands lets the
+// back-end compiler vectorize without alias or trip-count worries.
+// All operands must be contiguous and, where annotated restrict,
+// non-overlapping; the caller is responsible for checking both before
+// lowering to these entry points.
+//
+// When CHPL_BLAS_LITE_USE_CBLAS is defined the four standard shapes
+// forward to the vendor cblas instead; the fused out-of-place axpy
+// has no cblas equivalent and always uses the local kernel.
+//
+
+#ifndef _chpl_blas_lite_h_
+#define _chpl_blas_lite_h_
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// dst = src
+void chpl_blas_scopy(float* dst, const float* src, int64_t n);
+void chpl_blas_dcopy(double* dst, const double* src, int64_t n);
+
+// x = a * x
+void chpl_blas_sscal(float* x, float a, int64_t n);
+void chpl_blas_dscal(double* x, double a, int64_t n);
+
+// y = a * x + y
+void chpl_blas_saxpy(float* y, float a, const float* x, int64_t n);
+void chpl_blas_daxpy(double* y, double a, const double* x, int64_t n);
+
+// dst = a * x + y; the common promoted shape 'A = B * a + C'
+void chpl_blas_saxpyz(float* dst, float a, const float* x,
+                      const float* y, int64_t n);
+void chpl_blas_daxpyz(double* dst, double a, const double* x,
+                      const double* y, int64_t n);
+
+// sum(x[i] * y[i])
+float chpl_blas_sdot(const float* x, const float* y, int64_t n);
+double chpl_blas_ddot(const double* x, const double* y, int64_t n);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
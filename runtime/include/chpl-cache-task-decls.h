@@ -28,6 +28,8 @@ extern "C" {
 // This is the type of the task private data used by the cache
 typedef struct {
   int64_t last_acquire; // cache acquire barrier sets this
+  uint64_t shared_min_epoch; // min fill epoch for shared-tier cache hits
+  int8_t policy_pin; // chpl_cache_policy_t; overrides adaptive caching
 } chpl_cache_taskPrvData_t;
 
 #ifdef __cplusplus
@@ -56,7 +56,7 @@ static inline
 void chpl_cache_warn_if_disabled(void)
 {
   if (CHPL_CACHE_REMOTE && chpl_nodeID == 0 &&
-      !chpl_env_rt_get_bool("CACHE_QUIET", false)) {
+      !chpl_env_rt_flag(CHPL_ENV_RT_CACHE_QUIET)) {
     if (CHPL_ASAN) {
       chpl_warning("Disabling --cache-remote due to incompatibility with "
                    "AddressSanitizer (quiet with CHPL_RT_CACHE_QUIET=true)", 0, 0);
@@ -137,6 +137,23 @@ int chpl_cache_mock_get(c_nodeid_t node, uint64_t raddr, size_t size);
 void chpl_cache_invalidate(c_nodeid_t node, void* raddr, size_t size,
                            int ln, int32_t fn);
 
+// Phase-adaptive caching (CHPL_RT_CACHE_REMOTE_ADAPTIVE): the runtime
+// tracks the GET/PUT mix per execution window and bypasses cache
+// consultation during write-heavy phases. A task may pin the policy
+// for a code region instead of relying on the automatic decision;
+// chpl_cache_policy_auto restores adaptive behavior. The pin is task
+// private and does not propagate to child tasks.
+typedef enum {
+  chpl_cache_policy_auto = 0, // follow the adaptive decision (default)
+  chpl_cache_policy_on   = 1, // always consult the cache
+  chpl_cache_policy_off  = 2, // always bypass the cache
+} chpl_cache_policy_t;
+
+void chpl_cache_policy_pin(int policy);
+// Returns the policy in effect for the calling task: the pinned policy
+// if one is set, otherwise the current adaptive decision.
+int chpl_cache_policy_current(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -62,6 +62,35 @@ void chpl_gen_comm_get(void *addr, c_nodeid_t node, void* raddr,
   }
 }
 
+static inline
+void chpl_gen_comm_get_yielding(void *addr, c_nodeid_t node, void* raddr,
+                                size_t size, int32_t commID, int ln, int32_t fn)
+{
+  if (chpl_nodeID == node) {
+    chpl_memmove(addr, raddr, size);
+#ifdef HAS_CHPL_CACHE_FNS
+  } else if( chpl_cache_enabled() ) {
+    // The cache already overlaps and batches remote reads.
+    chpl_cache_comm_get(addr, node, raddr, size, commID, ln, fn);
+#endif
+  } else {
+    chpl_comm_get_yielding(addr, node, raddr, size, commID, ln, fn);
+  }
+}
+
+static inline
+void chpl_gen_comm_get_pipelined(void *addr, c_nodeid_t node, void* raddr,
+                                 size_t size, int32_t commID, int ln, int32_t fn)
+{
+  if (chpl_nodeID == node) {
+    chpl_memmove(addr, raddr, size);
+  } else {
+    // Don't go through the cache: bulk transfers would just flush it,
+    // and the pipeline already overlaps the chunks.
+    chpl_comm_get_pipelined(addr, node, raddr, size, commID, ln, fn);
+  }
+}
+
 static inline
 void chpl_gen_comm_prefetch(c_nodeid_t node, void* raddr,
                             size_t size, int32_t commID, int ln, int32_t fn)
@@ -43,6 +43,15 @@ extern int chpl_verbose_comm_stacktrace;
 extern int chpl_comm_diagnostics; // set via startCommDiagnostics
 extern int chpl_comm_diags_print_unstable;
 
+// Comm heatmap instrumentation: per-(remote node, callsite, op) counts
+// and size histograms, dumped as a binary trace at exit.  Enabled by
+// setting CHPL_RT_COMM_HEATMAP.
+extern int chpl_comm_heatmap;     // set via CHPL_RT_COMM_HEATMAP
+
+void chpl_comm_diags_heatmap_init(void);
+void chpl_comm_diags_heatmap_record(const char* op, int32_t node,
+                                    size_t size, int32_t ln, int32_t fn);
+
 #define CHPL_COMM_DIAGS_VARS_ALL(MACRO) \
   MACRO(get) \
   MACRO(get_nb) \
@@ -100,6 +109,7 @@ void chpl_comm_diags_init(void) {
   CHPL_COMM_DIAGS_VARS_ALL(_COMM_DIAGS_INIT);
 #undef _COMM_DIAGS_INIT
   atomic_init_int_least16_t(&chpl_comm_diags_disable_flag, 0);
+  chpl_comm_diags_heatmap_init();
 }
 
 static inline
@@ -152,18 +162,26 @@ int chpl_comm_diags_is_enabled(void) {
   } while(0)
 
 #define chpl_comm_diags_verbose_rdma(op, node, size, ln, fn, commid)     \
-  chpl_comm_diags_verbose_printf(false,                                  \
-                                 "%s:%d: remote %s, node %d, %zu bytes, " \
-                                 "commid %d",                            \
-                                 chpl_lookupFilename(fn), ln, op,        \
-                                 (int) node, size, (int) commid)
+  do {                                                                   \
+    if (chpl_comm_heatmap)                                               \
+      chpl_comm_diags_heatmap_record(op, (int32_t) node, size, ln, fn);  \
+    chpl_comm_diags_verbose_printf(false,                                \
+                                   "%s:%d: remote %s, node %d, "         \
+                                   "%zu bytes, commid %d",               \
+                                   chpl_lookupFilename(fn), ln, op,      \
+                                   (int) node, size, (int) commid);      \
+  } while(0)
 
 #define chpl_comm_diags_verbose_rdmaStrd(op, node, ln, fn, commid)      \
-  chpl_comm_diags_verbose_printf(false,                                 \
-                                 "%s:%d: remote strided %s, node %d, "  \
-                                 "commid %d",                           \
-                                 chpl_lookupFilename(fn), ln, op,       \
-                                 (int) node, (int) commid)
+  do {                                                                  \
+    if (chpl_comm_heatmap)                                              \
+      chpl_comm_diags_heatmap_record(op, (int32_t) node, 0, ln, fn);    \
+    chpl_comm_diags_verbose_printf(false,                               \
+                                   "%s:%d: remote strided %s, node %d, " \
+                                   "commid %d",                         \
+                                   chpl_lookupFilename(fn), ln, op,     \
+                                   (int) node, (int) commid);           \
+  } while(0)
 
 #define chpl_comm_diags_verbose_amo(op, node, ln, fn)                   \
   chpl_comm_diags_verbose_printf(true,                                  \
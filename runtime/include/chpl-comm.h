@@ -248,6 +248,13 @@ void chpl_comm_rollcall(void);
 //   touch the heap in an interleaved and parallel manner to improve
 //   NUMA affinity and speed up faulting in the memory.
 //
+// chpl_comm_regMemHeapLazyTouch():
+//   Returns true if the user asked (CHPL_RT_LAZY_HEAP_TOUCH) for the
+//   fixed heap to be faulted in on demand as the memory layer maps
+//   pieces of it, instead of all at once at startup.  Trades first-use
+//   latency and possibly NUMA affinity for startup time proportional
+//   to memory actually used rather than heap size.
+//
 // chpl_comm_regMemAllocThreshold():
 //   Allocations smaller than this should be done normally, by the
 //   memory layer.  Those at least this size may be done through this
@@ -292,6 +299,8 @@ size_t chpl_comm_regMemHeapPageSize(void) {
 
 void chpl_comm_regMemHeapTouch(void* start, size_t size);
 
+chpl_bool chpl_comm_regMemHeapLazyTouch(void);
+
 #ifndef CHPL_COMM_IMPL_REG_MEM_ALLOC_THRESHOLD
   #define CHPL_COMM_IMPL_REG_MEM_ALLOC_THRESHOLD() SIZE_MAX
 #endif
@@ -450,6 +459,66 @@ void chpl_comm_put(void* addr, c_nodeid_t node, void* raddr,
 void chpl_comm_get(void *addr, c_nodeid_t node, void* raddr,
                     size_t size, int32_t commID, int ln, int32_t fn);
 
+//
+// like chpl_comm_get(), but yield to the tasking layer while waiting
+// for the data to arrive, so that other tasks on this shepherd can
+// keep the network busy during the round trip.  Implemented once for
+// all comm layers in chpl-comm.c, on top of the nonblocking handle
+// machinery.
+//
+void chpl_comm_get_yielding(void *addr, c_nodeid_t node, void* raddr,
+                            size_t size, int32_t commID, int ln, int32_t fn);
+
+//
+// like chpl_comm_get(), but for large transfers: splits the range into
+// chunks and keeps a bounded number of nonblocking gets in flight so
+// that chunk transfers overlap on the wire instead of completing one
+// round trip at a time.  Implemented once for all comm layers in
+// chpl-comm.c, on top of the nonblocking handle machinery.  Chunking
+// is tuned with CHPL_RT_COMM_PIPELINE_CHUNK_SIZE (bytes) and
+// CHPL_RT_COMM_PIPELINE_DEPTH (chunks in flight).
+//
+void chpl_comm_get_pipelined(void *addr, c_nodeid_t node, void* raddr,
+                             size_t size, int32_t commID, int ln, int32_t fn);
+
+//
+// All-to-all exchange, collective across nodes: every node must call
+// this (from one task), and on each node segment i of the send buffer
+// is delivered to node i, which receives it into segment chpl_nodeID
+// of its receive buffer.  Counts and displacements are in bytes, with
+// chpl_numNodes entries each; sendCounts[i] here must equal
+// recvCounts[chpl_nodeID] on node i.  The send-side arrays and buffer
+// must stay valid until the call returns.  Implemented once for all
+// comm layers in chpl-comm.c: receivers pull their segments in a
+// staggered peer order to avoid incast, batching small segments via
+// the unordered-GET path (threshold tuned with
+// CHPL_RT_COMM_ALLTOALLV_UNORDERED_MAX) and chunking large ones via
+// the pipelined path.
+//
+void chpl_comm_alltoallv(void* recv, const size_t* recvCounts,
+                         const size_t* recvDispls,
+                         const void* send, const size_t* sendCounts,
+                         const size_t* sendDispls,
+                         int32_t commID, int ln, int32_t fn);
+
+//
+// Sum allreduce over a single small scalar, collective across nodes:
+// every node must call this (from one task) with its contribution in
+// *valInOut, and on return *valInOut holds the sum over all nodes.
+// Implemented once for all comm layers in chpl-comm.c as a
+// dissemination exchange -- ceil(log2(numNodes)) rounds of one small
+// PUT each -- so no node is ever the fan-in point of a linear gather.
+//
+typedef enum {
+  chpl_comm_red_int64,
+  chpl_comm_red_uint64,
+  chpl_comm_red_real32,
+  chpl_comm_red_real64,
+} chpl_comm_redType_t;
+
+void chpl_comm_allreduce_sum(void* valInOut, chpl_comm_redType_t dt,
+                             int32_t commID, int ln, int32_t fn);
+
 //
 // put the number of elements pointed out by count array, with strides pointed
 // out by dststrides and srcstrides arrays. These three arrays have to be int32
@@ -492,6 +561,24 @@ void chpl_comm_getput_unordered(c_nodeid_t dstnode, void* dstaddr,
 
 void chpl_comm_getput_unordered_task_fence(void);
 
+//
+// Gather/scatter over arbitrary (node, address) pairs, for irregular
+// indexing like A[Idx] with a random index array.  Element i of the
+// local dense buffer (dst or src) corresponds to the remote element
+// at nodes[i]:raddrs[i]; each element is eltSize bytes.  Implemented
+// once for all comm layers in chpl-comm.c: requests are grouped per
+// target node, contiguous runs are coalesced, and the rest goes
+// through the unordered paths so the comm layer can batch them.
+// Both calls block until all data has landed.
+//
+void chpl_comm_gather(void* dst, const c_nodeid_t* nodes,
+                      void* const* raddrs, size_t eltSize, size_t n,
+                      int32_t commID, int ln, int32_t fn);
+
+void chpl_comm_scatter(const void* src, const c_nodeid_t* nodes,
+                       void* const* raddrs, size_t eltSize, size_t n,
+                       int32_t commID, int ln, int32_t fn);
+
 //
 // Runs a function f on a remote locale, passing it
 // arg where size of arg is stored in arg_size.
@@ -561,6 +648,19 @@ void chpl_comm_task_end(void) {
 }
 
 
+// This is a hook that's called when a task voluntarily yields, so the
+// comm layer can make network progress cooperatively from compute
+// threads instead of relying solely on dedicated progress resources.
+#ifndef CHPL_COMM_IMPL_TASK_YIELD
+#define CHPL_COMM_IMPL_TASK_YIELD() \
+        return
+#endif
+static inline
+void chpl_comm_task_yield(void) {
+  CHPL_COMM_IMPL_TASK_YIELD();
+}
+
+
 void* chpl_get_global_serialize_table(int64_t idx);
 
 // Used to park and wake up the main process
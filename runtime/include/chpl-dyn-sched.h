@@ -0,0 +1,74 @@
+/*
+ * Copyright 2020-2021 Hewlett Packard Enterprise Development LP
+ * Copyright 2004-2019 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//
+// Adaptive chunk scheduling for parallel loops.
+//
+// Statically chunked loops suffer tail latency when per-iteration
+// cost varies: whichever task drew the expensive iterations finishes
+// last while the rest idle.  This scheduler hands out chunks of a
+// shared iteration range through a single atomic cursor, with chunk
+// sizes that shrink as the range drains (guided self-scheduling):
+// early chunks are large to keep claim overhead low, late chunks
+// bottom out at minChunk so no task is left holding a large
+// remainder.  Tasks that finish early simply claim the work that
+// would otherwise strand on slower tasks, giving the load balancing
+// of work stealing without per-task deques.
+//
+// A dynamic iterator initializes one chpl_dynsched_t with the loop
+// bounds and task count, then each task loops on
+// chpl_dynsched_next() until it returns false.
+//
+
+#ifndef _chpl_dyn_sched_h_
+#define _chpl_dyn_sched_h_
+
+#include "chpltypes.h"
+#include "chpl-atomics.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+  atomic_int_least64_t cursor;  // next unclaimed iteration
+  int64_t hi;                   // one past the last iteration
+  int64_t minChunk;
+  int32_t numTasks;
+} chpl_dynsched_t;
+
+void chpl_dynsched_init(chpl_dynsched_t* sched,
+                        int64_t lo, int64_t hi,
+                        int32_t numTasks, int64_t minChunk);
+
+// Claim the next chunk; returns false once the range is exhausted.
+chpl_bool chpl_dynsched_next(chpl_dynsched_t* sched,
+                             int64_t* lo, int64_t* hi);
+
+// How many iterations are still unclaimed (racy, for heuristics only).
+int64_t chpl_dynsched_remaining(chpl_dynsched_t* sched);
+
+void chpl_dynsched_destroy(chpl_dynsched_t* sched);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -77,6 +77,38 @@ size_t chpl_env_rt_get_size(const char* ev, size_t dflt) {
 void chpl_env_set(const char*, const char*, int);
 void chpl_env_set_uint(const char*, uint64_t, int);
 
+//
+// Hot-path runtime flags.
+//
+// A few CHPL_RT_* boolean settings are consulted after startup, some
+// from paths that run often.  chpl_env_rt_init() parses them into one
+// bit each, so a later check is a load and a test instead of a
+// getenv() and a parse.  chpl_rt_init() parses the flags right after
+// it has handled -E options; the guard below parses lazily in case a
+// check runs even earlier.  Cold settings should keep using the
+// parse-on-use helpers above.
+//
+typedef enum {
+  CHPL_ENV_RT_CACHE_QUIET  = 1 << 0,  // CHPL_RT_CACHE_QUIET
+  CHPL_ENV_RT_COMM_HEATMAP = 1 << 1,  // CHPL_RT_COMM_HEATMAP
+  CHPL_ENV_RT_TASK_PROF    = 1 << 2,  // CHPL_RT_TASK_PROF
+  CHPL_ENV_RT_PAGE_MIGRATE = 1 << 3,  // CHPL_RT_PAGE_MIGRATE
+} chpl_env_rt_flag_t;
+
+// bit 31 marks the word as parsed and is never used for a flag
+#define CHPL_ENV_RT_FLAGS_PARSED 0x80000000u
+
+extern uint32_t chpl_env_rt_flags;
+
+void chpl_env_rt_init(void);
+
+static inline
+chpl_bool chpl_env_rt_flag(chpl_env_rt_flag_t flag) {
+  if ((chpl_env_rt_flags & CHPL_ENV_RT_FLAGS_PARSED) == 0)
+    chpl_env_rt_init();
+  return (chpl_env_rt_flags & (uint32_t) flag) != 0;
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -40,6 +40,33 @@ void chpl_byte_buffer_free_server(chpl_byte_buffer cb);
 chpl_byte_buffer chpl_byte_buffer_make(const char* data);
 chpl_byte_buffer chpl_byte_buffer_make_len(const char* data, uint64_t size);
 
+//
+// Async exported-function support (--library-async).
+//
+// For each exported function the generated library header emits
+// submit/poll/wait variants; submit captures the arguments and starts
+// the call as a Chapel task through chpl_async_export_submit, so a
+// client thread can keep many Chapel requests in flight.  The handle
+// is opaque to the client and owned by the runtime until
+// chpl_async_export_free.
+//
+typedef struct chpl_async_handle_s chpl_async_handle_t;
+
+// Start 'fn(arg)' as a Chapel task and return a handle for it.  'arg'
+// is the caller's capture block and must stay valid until the task
+// completes.
+chpl_async_handle_t* chpl_async_export_submit(void (*fn)(void* arg),
+                                              void* arg);
+
+// Nonzero once the submitted call has completed.  Never blocks.
+int chpl_async_export_poll(chpl_async_handle_t* h);
+
+// Block (cooperatively, if called from a Chapel task) until the
+// submitted call has completed.
+void chpl_async_export_wait(chpl_async_handle_t* h);
+
+void chpl_async_export_free(chpl_async_handle_t* h);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,52 @@
+/*
+ * Copyright 2020-2021 Hewlett Packard Enterprise Development LP
+ * Copyright 2004-2019 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//
+// Per-forall instrumentation hooks.
+//
+// When a program is compiled with --instrument-foralls, the compiler
+// emits chpl_forall_enter()/chpl_forall_exit() calls around each
+// lowered forall.  The hooks are dormant (a flag test and return)
+// unless CHPL_RT_INSTRUMENT_FORALLS turns them on at run time, in
+// which case each node prints per-loop execution counts, wall time,
+// and task counts at exit.  See chpl-forall-instrument.c.
+//
+
+#ifndef _chpl_forall_instrument_h_
+#define _chpl_forall_instrument_h_
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+extern int chpl_forall_instrument;   // should we gather forall stats?
+
+void chpl_forall_instrument_init(void);
+
+void chpl_forall_enter(int32_t ln, int32_t fn);
+void chpl_forall_exit(int32_t ln, int32_t fn);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
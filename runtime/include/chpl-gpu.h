@@ -56,6 +56,16 @@ size_t chpl_gpu_get_alloc_size(void* ptr);
 void chpl_gpu_copy_device_to_host(void* dst, void* src, size_t n);
 void chpl_gpu_copy_host_to_device(void* dst, void* src, size_t n);
 
+// Device-side reductions over GPU-resident buffers of n 64-bit
+// elements; only the 8-byte result crosses back to the host.
+uint64_t chpl_gpu_reduce_add_uint64(void* data, size_t n);
+int64_t chpl_gpu_reduce_add_int64(void* data, size_t n);
+double chpl_gpu_reduce_add_real64(void* data, size_t n);
+uint64_t chpl_gpu_reduce_min_uint64(void* data, size_t n);
+uint64_t chpl_gpu_reduce_max_uint64(void* data, size_t n);
+int64_t chpl_gpu_reduce_min_int64(void* data, size_t n);
+int64_t chpl_gpu_reduce_max_int64(void* data, size_t n);
+
 bool chpl_gpu_is_device_ptr(void* ptr);
                            
 #endif // HAS_GPU_LOCALE
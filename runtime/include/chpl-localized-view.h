@@ -0,0 +1,69 @@
+/*
+ * Copyright 2020-2021 Hewlett Packard Enterprise Development LP
+ * Copyright 2004-2019 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _chpl_localized_view_h_
+#define _chpl_localized_view_h_
+
+#include "chpltypes.h"
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//
+// A localized view pins a one-time snapshot of remote metadata (e.g. an
+// array or slice descriptor) on this locale, so that code which would
+// otherwise re-GET the same descriptor on every access or every
+// timestep can fetch it once and read the local copy until it
+// explicitly refreshes or unpins the view.  When the original is
+// already local the view aliases it directly and no copy is made.
+//
+// The snapshot is not kept coherent: it is the caller's contract that
+// the remote metadata doesn't change while the view is pinned, or that
+// the caller refreshes at the points where it may have.
+//
+typedef struct chpl_localizedView_s {
+  c_nodeid_t node;        // locale that owns the original
+  void*      remoteAddr;  // address of the original on that locale
+  size_t     size;        // bytes snapshotted
+  void*      localData;   // local copy, or == remoteAddr when local
+} chpl_localizedView_t;
+
+// Snapshots size bytes at remoteAddr on node into view (one bulk GET).
+void chpl_localizedView_pin(chpl_localizedView_t* view,
+                            c_nodeid_t node, void* remoteAddr, size_t size);
+
+// Re-GETs the snapshot, for callers that know the original changed.
+void chpl_localizedView_refresh(chpl_localizedView_t* view);
+
+// Releases the snapshot; the data pointer is dead after this.
+void chpl_localizedView_unpin(chpl_localizedView_t* view);
+
+static inline void* chpl_localizedView_data(const chpl_localizedView_t* view) {
+  return view->localData;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
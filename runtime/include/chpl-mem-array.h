@@ -102,6 +102,96 @@ void* chpl_mem_array_alloc(size_t nmemb, size_t eltSize,
 }
 
 
+//
+// Placement policies for array memory.  The default leaves placement
+// to the OS (and, for registered memory, to the comm layer's post-alloc
+// localization).  First-touch defers placement to whoever faults the
+// pages in; chpl_mem_array_firstTouch() below can do that on the tasks'
+// behalf, NUMA domain by NUMA domain.  Interleave round-robins pages
+// across the NUMA domains for bandwidth-bound access patterns, and
+// bind places the whole block on one domain for latency-bound ones.
+//
+typedef enum {
+  CHPL_MEM_ARRAY_PLACE_DEFAULT,
+  CHPL_MEM_ARRAY_PLACE_FIRST_TOUCH,
+  CHPL_MEM_ARRAY_PLACE_INTERLEAVE,
+  CHPL_MEM_ARRAY_PLACE_BIND,
+} chpl_mem_arrayPlacement_t;
+
+
+static inline
+void* chpl_mem_array_allocPlaced(size_t nmemb, size_t eltSize,
+                                 c_sublocid_t subloc,
+                                 chpl_mem_arrayPlacement_t placement,
+                                 chpl_bool* callPostAlloc,
+                                 int32_t lineno, int32_t filename) {
+  void* p = chpl_mem_array_alloc(nmemb, eltSize, subloc, callPostAlloc,
+                                 lineno, filename);
+
+#ifdef HAS_GPU_LOCALE
+  if (chpl_gpu_running_on_gpu_locale()) {
+    return p;
+  }
+#endif
+
+  //
+  // Registered memory gets its NUMA locality from first touch plus the
+  // comm layer's post-alloc localization; don't fight that here.
+  //
+  if (p == NULL || *callPostAlloc) {
+    return p;
+  }
+
+  const size_t size = nmemb * eltSize;
+  switch (placement) {
+    case CHPL_MEM_ARRAY_PLACE_INTERLEAVE:
+      chpl_topo_interleaveMemLocality(p, size);
+      break;
+    case CHPL_MEM_ARRAY_PLACE_BIND:
+      if (isActualSublocID(subloc)) {
+        chpl_topo_setMemLocality(p, size, false /*onlyInside*/, subloc);
+      }
+      break;
+    case CHPL_MEM_ARRAY_PLACE_DEFAULT:
+    case CHPL_MEM_ARRAY_PLACE_FIRST_TOUCH:
+      // placement happens when the pages are faulted in
+      break;
+  }
+
+  return p;
+}
+
+
+//
+// Fault an array's pages in, NUMA domain by NUMA domain, on behalf of
+// the tasks that will use them.  The block is split into equal
+// subchunks in domain order, matching how a default forall splits the
+// index space across sublocales, so each domain's pages land where the
+// corresponding tasks run.  Touching an already-faulted page doesn't
+// move it, so overlapping edge pages are harmless.
+//
+static inline
+void chpl_mem_array_firstTouch(void* p, size_t nmemb, size_t eltSize) {
+  const size_t size = nmemb * eltSize;
+  const int nDomains = chpl_topo_getNumNumaDomains();
+  unsigned char* base = (unsigned char*) p;
+  size_t chunk;
+  int i;
+
+  if (nDomains <= 1) {
+    chpl_topo_touchMemFromSubloc(p, size, false /*onlyInside*/, 0);
+    return;
+  }
+
+  chunk = size / nDomains;
+  for (i = 0; i < nDomains; i++) {
+    const size_t len = (i == nDomains - 1) ? size - i * chunk : chunk;
+    chpl_topo_touchMemFromSubloc(base + i * chunk, len, false /*onlyInside*/,
+                                 (c_sublocid_t) i);
+  }
+}
+
+
 static inline
 void chpl_mem_array_postAlloc(void* p, size_t nmemb, size_t eltSize,
                               int32_t lineno, int32_t filename) {
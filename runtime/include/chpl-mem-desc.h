@@ -82,6 +82,7 @@ extern "C" {
   m(TASK_DESC_LINK,       "task descriptor link",                     false), \
   m(TASK_ARG,             "task body argument",                       false), \
   m(TASK_STACK,           "task stack",                               false), \
+  m(TASK_ARENA_CHUNK,     "task arena chunk",                         false), \
   m(MUTEX,                "mutex",                                    false), \
   m(LOCK_REPORT_DATA,     "lock report data",                         false), \
   m(TASK_POOL_DESC,       "task pool descriptor",                     false), \
@@ -94,7 +95,12 @@ extern "C" {
   m(OS_LAYER_TMP_DATA,    "OS layer temporary data",                  true ), \
   m(GMP,                  "gmp data",                                 true ), \
   m(GETS_PUTS_STRIDES,    "put_strd/get_strd array of strides",       true ), \
+  m(LOCALIZED_VIEW,       "localized remote view",                    false), \
   m(MLI_DATA,             "multilocale interop data",                 true ), \
+  m(ALGO_SCRATCH,         "algorithm kernel scratch buffer",          false), \
+  m(QUEUE_DATA,           "mpmc queue data",                          false), \
+  m(NUMA_REPL_DATA,       "NUMA-replicated global data",              false), \
+  m(TRACE_BUFFER,         "distributed tracing event ring",           false), \
   m(NUM,                  "*** this must be the last entry ***",      true )
 
 
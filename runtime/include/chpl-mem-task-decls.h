@@ -0,0 +1,47 @@
+/*
+ * Copyright 2020-2021 Hewlett Packard Enterprise Development LP
+ * Copyright 2004-2019 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _chpl_mem_task_decls_h_
+#define _chpl_mem_task_decls_h_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//
+// This is the memory layer's per-task data, carried in
+// chpl_task_infoRuntime_t on the mem layer's behalf.  It is declared
+// here, separately from chpl-mem.h, so that chpl-tasks.h can embed it
+// without a circular include.  Only the mem layer should touch it.
+//
+// The single member is the head of the task's bump-arena chunk list;
+// see chpl_mem_arena_alloc() and chpl_mem_arena_reset() in chpl-mem.h.
+//
+typedef struct chpl_mem_arenaChunk_s chpl_mem_arenaChunk_t;
+
+typedef struct {
+  chpl_mem_arenaChunk_t* arenaHead;
+} chpl_mem_taskPrvData_t;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -75,6 +75,41 @@ void chpl_mem_exit(void);
 int chpl_mem_inited(void);
 
 
+//
+// Per-task bump arena, for short-lived task-local temporaries.
+// chpl_mem_arena_alloc() hands out memory from chunks owned by the
+// current task; there is no per-allocation free.  Everything the task
+// got from its arena is returned at once by chpl_mem_arena_reset(),
+// which the tasking layer calls when the task body finishes.  Outside
+// a task the alloc falls back to the regular allocator and the memory
+// lives until program exit.
+//
+void* chpl_mem_arena_alloc(size_t size, chpl_mem_descInt_t description,
+                           int32_t lineno, int32_t filename);
+void chpl_mem_arena_reset(void);
+
+
+//
+// Size-classed recycler for doubling growth patterns.
+// chpl_mem_grow() reallocates a buffer whose first oldSize bytes are
+// live to at least newSize bytes, rounding the request up to a
+// power-of-two class and preferring a block cached on the current
+// thread over the underlying allocator.  When the caller already
+// knows how large the buffer will eventually get -- e.g. the element
+// count is known before an append loop -- it passes that as
+// finalSize to skip the intermediate classes; pass 0 when it is not
+// known.  chpl_mem_grow_free() releases a buffer of the returned
+// capacity back to the thread's cache (or the allocator, if the
+// cache is full or the size is out of class range).  Returns the new
+// buffer; the old pointer is consumed.
+//
+void* chpl_mem_grow(void* ptr, size_t oldSize, size_t newSize,
+                    size_t finalSize, chpl_mem_descInt_t description,
+                    int32_t lineno, int32_t filename);
+void chpl_mem_grow_free(void* ptr, size_t size,
+                        int32_t lineno, int32_t filename);
+
+
 static inline
 void* chpl_mem_allocMany(size_t number, size_t size,
                          chpl_mem_descInt_t description,
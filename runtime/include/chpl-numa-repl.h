@@ -0,0 +1,77 @@
+/*
+ * Copyright 2020-2021 Hewlett Packard Enterprise Development LP
+ * Copyright 2004-2019 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//
+// NUMA-replicated storage for read-mostly data.
+//
+// A lookup table or configuration block allocated once per locale
+// lands on whichever NUMA domain faulted it in, and on a big node
+// every other socket's cores then cross the interconnect for each
+// read.  A replicated block keeps one page-aligned copy per NUMA
+// domain, each bound to its domain through the topo layer, so reads
+// through the local replica stay on-socket.
+//
+// The write protocol assumes writes are rare (typically only during
+// initialization): a write is applied to every replica and then
+// published with a release fence.  Readers that must observe a given
+// write should be started (or otherwise synchronized with) after it;
+// concurrent readers may briefly see the old contents, which is the
+// usual contract for read-mostly replication.
+//
+// chpl_numa_repl_localPtr() resolves the calling thread's replica.
+// It costs a topo query, so hoist the pointer out of loops; a task
+// stays on its sublocale, so the pointer remains local for the task's
+// lifetime.
+//
+
+#ifndef _chpl_numa_repl_h_
+#define _chpl_numa_repl_h_
+
+#ifndef LAUNCHER
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct chpl_numa_repl_s chpl_numa_repl_t;
+
+// Create a replicated block of 'size' bytes, one replica per NUMA
+// domain.  When 'init' is non-NULL every replica starts as a copy of
+// it; otherwise the block starts zeroed.
+chpl_numa_repl_t* chpl_numa_repl_create(size_t size, const void* init);
+void chpl_numa_repl_destroy(chpl_numa_repl_t* r);
+
+// The replica bound to the calling thread's NUMA domain.
+void* chpl_numa_repl_localPtr(chpl_numa_repl_t* r);
+
+// Apply a write to every replica, then publish it with a release
+// fence.  See the write protocol above.
+void chpl_numa_repl_write(chpl_numa_repl_t* r, size_t offset,
+                          const void* src, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LAUNCHER
+
+#endif
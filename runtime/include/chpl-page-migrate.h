@@ -0,0 +1,81 @@
+/*
+ * Copyright 2020-2021 Hewlett Packard Enterprise Development LP
+ * Copyright 2004-2019 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _chpl_page_migrate_h_
+#define _chpl_page_migrate_h_
+
+#ifndef LAUNCHER
+
+#include "chpltypes.h"
+#include "chpl-env.h"
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//
+// Page-migration telemetry (opt in with CHPL_RT_PAGE_MIGRATE=true).
+//
+// Long-running jobs develop access skew: data placed at startup ends
+// up mostly accessed from some other locale.  When enabled, the remote
+// cache's miss path feeds per-(node, page) access counters here, and a
+// policy task periodically sweeps them: pages whose miss count passes
+// CHPL_RT_PAGE_MIGRATE_THRESHOLD (default 1024) between sweeps (every
+// CHPL_RT_PAGE_MIGRATE_INTERVAL seconds, default 5) are reported as
+// hot; counts below the threshold decay by half, so the policy tracks
+// slowly-shifting workloads rather than bursts.
+//
+// The runtime cannot re-home a page by itself -- generated wide
+// pointers have no translation step to update -- so acting on the
+// report belongs to whoever owns the data: an array implementation
+// registers a handler with chpl_pagemigrate_register() and performs
+// the migration (and its own pointer updates) when called.  Without a
+// handler the sweep only maintains the counters.
+//
+
+// Called on the locale that observed the remote traffic.  'node' owns
+// the page, 'pageAddr' is its remote address, and 'misses' is the
+// decayed miss count at sweep time.  Runs from the policy task; it may
+// block and communicate.
+typedef void (*chpl_pagemigrate_cb_t)(c_nodeid_t node, void* pageAddr,
+                                      uint64_t misses);
+
+void chpl_pagemigrate_init(void);
+void chpl_pagemigrate_exit(void);
+
+void chpl_pagemigrate_register(chpl_pagemigrate_cb_t cb);
+
+void chpl_pagemigrate_note_remote_impl(c_nodeid_t node, uint64_t pageAddr);
+
+// The cache's miss-path hook: free when the service is disabled.
+static inline
+void chpl_pagemigrate_note_remote(c_nodeid_t node, uint64_t pageAddr) {
+  if (chpl_env_rt_flag(CHPL_ENV_RT_PAGE_MIGRATE))
+    chpl_pagemigrate_note_remote_impl(node, pageAddr);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LAUNCHER
+#endif // _chpl_page_migrate_h_
@@ -23,6 +23,7 @@
 #ifndef LAUNCHER
 #include <stdint.h>
 #include "chpltypes.h"
+#include "chpl-comm.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -48,6 +49,34 @@ void chpl_clearPrivatizedClass(int64_t);
 
 int64_t chpl_numPrivatizedClasses(void);
 
+//
+// Tree-fanout privatization broadcast.
+//
+// Privatized copies used to be installed by locale 0 executing on every
+// other locale in turn, which is linear in the number of locales.
+// chpl_privatization_broadcast() instead propagates the setup function
+// down a binomial tree: each locale forwards to its children with
+// non-blocking executeOns before running the setup itself, so the
+// subtrees install in parallel and the whole broadcast is logarithmic.
+// The call returns once every locale has run the setup.
+//
+// 'innerFid' is the chpl_ftable[] index of the per-locale setup
+// function (typically one that constructs a privatized copy and calls
+// chpl_newPrivatizedClass); it runs on every locale except the caller,
+// which is assumed to have installed its own copy already.  'innerArg'
+// is the setup function's bundle, copied along with each forward.
+// 'treeFid' must be the index of a regular (not fast) on-stmt wrapper
+// that forwards its bundle to chpl_privatization_bcast_handler().
+//
+void chpl_privatization_broadcast(chpl_fn_int_t treeFid,
+                                  chpl_fn_int_t innerFid,
+                                  chpl_comm_on_bundle_t* innerArg,
+                                  size_t innerSize,
+                                  int lineno, int32_t filename);
+
+// The body of the 'treeFid' wrapper above.
+void chpl_privatization_bcast_handler(chpl_comm_on_bundle_t* bundle);
+
 #ifdef __cplusplus
 }
 #endif
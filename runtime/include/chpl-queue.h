@@ -0,0 +1,75 @@
+/*
+ * Copyright 2020-2021 Hewlett Packard Enterprise Development LP
+ * Copyright 2004-2019 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//
+// Bounded multi-producer/multi-consumer queue.
+//
+// Pipeline-parallel code that builds queues out of sync vars serializes
+// every operation on the sync var's lock and collapses under
+// contention.  This queue is a fixed-capacity ring in which each slot
+// carries its own sequence number: producers and consumers claim slots
+// with one atomic increment each and then hand them over through the
+// slot's own sequence number, so the uncontended fast path is two
+// atomic operations and a copy, with no lock anywhere.  Slots are
+// padded to cache lines so neighboring slots never false-share.
+//
+// The blocking operations integrate with the tasking layer by yielding
+// between retries rather than spinning, so a producer blocked on a full
+// queue lets its consumers run (and, with a comm layer that hooks task
+// yields, keeps the network progressing).
+//
+// Elements are fixed-size POD, copied in and out by value.
+//
+
+#ifndef _chpl_queue_h_
+#define _chpl_queue_h_
+
+#include "chpltypes.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct chpl_queue_s chpl_queue_t;
+
+// Capacity is rounded up to a power of two.
+chpl_queue_t* chpl_queue_create(uint64_t capacity, size_t eltSize);
+void chpl_queue_destroy(chpl_queue_t* q);
+
+// Nonblocking; return false when the queue is full/empty.
+chpl_bool chpl_queue_tryEnqueue(chpl_queue_t* q, const void* elt);
+chpl_bool chpl_queue_tryDequeue(chpl_queue_t* q, void* elt);
+
+// Blocking; yield to the tasking layer until the operation succeeds.
+void chpl_queue_enqueue(chpl_queue_t* q, const void* elt);
+void chpl_queue_dequeue(chpl_queue_t* q, void* elt);
+
+// Instantaneously correct only when the queue is quiescent.
+uint64_t chpl_queue_size(chpl_queue_t* q);
+uint64_t chpl_queue_capacity(chpl_queue_t* q);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,76 @@
+/*
+ * Copyright 2020-2021 Hewlett Packard Enterprise Development LP
+ * Copyright 2004-2019 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _chpl_snapshot_h_
+#define _chpl_snapshot_h_
+
+#include "chpltypes.h"
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//
+// Asynchronous checkpoint/snapshot service.
+//
+// Callers register the heap regions that make up a checkpoint once, then
+// kick off snapshots with chpl_snapshot_begin().  Begin captures a private
+// copy of every registered region (a memory-speed pause) and hands the
+// copies to a background writer that streams them through QIO while
+// computation proceeds.  Completion is observable three ways: an optional
+// callback invoked from the writer, chpl_snapshot_test() polling, or a
+// blocking chpl_snapshot_wait().
+//
+// Each snapshot should be retired with chpl_snapshot_wait() or observed
+// via its callback; chpl_snapshot_exit() drains anything still in flight.
+//
+
+// Called from the background writer when a snapshot completes.  'err' is 0
+// on success, else the errno-style code of the first write failure.
+typedef void (*chpl_snapshot_done_fn)(int64_t handle, int32_t err, void* arg);
+
+void chpl_snapshot_init(void);
+void chpl_snapshot_exit(void);
+
+// Add/remove a heap region from the set captured by subsequent snapshots.
+void chpl_snapshot_region_register(void* base, size_t len);
+void chpl_snapshot_region_unregister(void* base);
+
+// Capture the registered regions and start streaming them to 'path' in the
+// background.  'done' (may be NULL) fires when the stream is on disk.
+// Returns a handle for test/wait, or a negative errno-style code.
+int64_t chpl_snapshot_begin(const char* path,
+                            chpl_snapshot_done_fn done, void* arg);
+
+// Nonblocking: has this snapshot finished (successfully or not)?
+chpl_bool chpl_snapshot_test(int64_t handle);
+
+// Block (yielding) until the snapshot finishes; returns its error code and
+// releases the handle.
+int32_t chpl_snapshot_wait(int64_t handle);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
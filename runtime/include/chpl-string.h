@@ -38,7 +38,14 @@ struct chpl_chpl____wide_chpl_string_s;
 
 chpl_string chpl_wide_string_copy(struct chpl_chpl____wide_chpl_string_s* x, int32_t lineno, int32_t filename);
 
-#define CHPL_SHORT_STRING_SIZE 8
+//
+// Strings whose payload fits in this many bytes (including the NUL)
+// can be carried in place, with no heap buffer; the module code's
+// string representation spills to the heap past this size.  16 covers
+// the common run of short strings while keeping the in-place buffer
+// the size of two pointers.
+//
+#define CHPL_SHORT_STRING_SIZE 16
 
 typedef struct chpl__inPlaceBuffer_t {
   uint8_t data[CHPL_SHORT_STRING_SIZE];
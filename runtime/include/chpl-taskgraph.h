@@ -0,0 +1,91 @@
+/*
+ * Copyright 2020-2021 Hewlett Packard Enterprise Development LP
+ * Copyright 2004-2019 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//
+// Dependence-aware task graph execution.
+//
+// begin/sync only expresses fork-join; wavefront-style computations
+// need dataflow ordering and otherwise emulate it with arrays of sync
+// variables, paying a full task plus blocked-task bookkeeping per
+// dependence.  Here a computation is a graph of lightweight nodes,
+// each a function plus a count of unsatisfied dependences.  Finishing
+// a node decrements each successor's count, and a node whose count
+// reaches zero becomes ready: the first ready successor continues on
+// the finishing task, and any others are handed to the tasking layer
+// as fresh tasks, so the graph's critical path runs without spawns
+// and its parallelism still fans out.
+//
+// Usage: create a graph, create its nodes (each declaring how many
+// predecessors it has), connect them with edges, then start the
+// nodes.  A node created with zero dependences is runnable as soon as
+// it is started.  All edges touching a node must be in place before
+// that node or any of its predecessors is started; with that
+// contract the engine needs no locks, only the dependence counters.
+// chpl_taskgraph_wait() blocks (yielding) until every node created in
+// the graph has run, after which the graph can be destroyed.  Nodes
+// are freed by the engine as they complete.
+//
+
+#ifndef _chpl_taskgraph_h_
+#define _chpl_taskgraph_h_
+
+#include "chpltypes.h"
+#include "chpl-atomics.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct chpl_taskgraph_s {
+  atomic_int_least32_t unfinished;  // nodes created but not yet run
+} chpl_taskgraph_t;
+
+typedef struct chpl_taskgraph_node_s {
+  chpl_fn_p fn;
+  void* arg;
+  c_sublocid_t subloc;
+  chpl_taskgraph_t* graph;
+  // unsatisfied dependences, plus one guard dropped by start()
+  atomic_int_least32_t waiting;
+  struct chpl_taskgraph_node_s** succs;
+  int32_t numSuccs;
+  int32_t capSuccs;
+} chpl_taskgraph_node_t;
+
+chpl_taskgraph_t* chpl_taskgraph_create(void);
+
+chpl_taskgraph_node_t* chpl_taskgraph_node(chpl_taskgraph_t* graph,
+                                           chpl_fn_p fn, void* arg,
+                                           int32_t numDeps);
+
+void chpl_taskgraph_edge(chpl_taskgraph_node_t* pred,
+                         chpl_taskgraph_node_t* succ);
+
+void chpl_taskgraph_start(chpl_taskgraph_node_t* node);
+
+void chpl_taskgraph_wait(chpl_taskgraph_t* graph);
+
+void chpl_taskgraph_destroy(chpl_taskgraph_t* graph);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -27,6 +27,7 @@
 #include "chplcgfns.h"
 #include "chpltypes.h"
 #include "chpl-comm-task-decls.h"
+#include "chpl-mem-task-decls.h"
 #include "chpl-tasks-impl.h"
 
 #ifdef __cplusplus
@@ -43,6 +44,7 @@ extern "C" {
 //
 typedef struct {
   chpl_comm_taskPrvData_t comm_data;
+  chpl_mem_taskPrvData_t mem_data;
 } chpl_task_infoRuntime_t;
 
 //
@@ -67,6 +69,10 @@ typedef struct chpl_task_bundle {
   chpl_fn_int_t requested_fid;
   chpl_fn_p requested_fn;
   chpl_taskID_t id;
+  uint64_t trace_span;          // distributed tracing span; 0: untraced.
+                                // Travels with the bundle, so an on-stmt's
+                                // active message carries it to the remote
+                                // side.  See chpl-trace.h.
   chpl_task_infoChapel_t infoChapel;
   uint64_t payload[0];
 } chpl_task_bundle_t;
@@ -205,6 +211,27 @@ void chpl_task_addTask(
          int,                // line at which function begins
          int32_t);           // name of file containing function
 
+//
+// Bulk task creation.  Adds num_tasks tasks whose argument bundles are
+// packed contiguously starting at the given base with a stride of the
+// given bundle length.  Semantically equivalent to calling
+// chpl_task_addTask on each bundle in order, but the tasking layer may
+// amortize per-task entry costs -- for example by spawning the tasks
+// as a tree or by taking its queue lock only once -- which matters
+// when a coforall creates many tasks at once.
+//
+// As with chpl_task_addTask, the bundles are copied before return, so
+// the caller's memory may be reused immediately.
+//
+void chpl_task_addTasksBulk(
+         chpl_fn_int_t,      // function to call for the tasks
+         chpl_task_bundle_t*,// base of the packed argument bundles
+         size_t,             // length of each argument bundle
+         int64_t,            // number of tasks to add
+         c_sublocid_t,       // desired sublocale
+         int,                // line at which function begins
+         int32_t);           // name of file containing function
+
 //
 // Call a chpl_ftable[] function in a task.
 //
@@ -281,6 +308,14 @@ void chpl_task_reset_spawn_order(void) {
 //
 chpl_taskID_t chpl_task_getId(void);
 
+//
+// Get the current task's trace span (0 when untraced, or when the
+// caller is not running in a task).  Reading the span from the task's
+// bundle rather than thread-local state keeps it correct across task
+// migration.  See chpl-trace.h.
+//
+uint64_t chpl_task_getTraceSpan(void);
+
 //
 // Checks whether two task IDs are the same
 //
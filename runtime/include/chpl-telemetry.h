@@ -0,0 +1,45 @@
+/*
+ * Copyright 2020-2021 Hewlett Packard Enterprise Development LP
+ * Copyright 2004-2019 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _chpl_telemetry_h_
+#define _chpl_telemetry_h_
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//
+// Live telemetry endpoint: a per-locale service thread that answers
+// each connection with one compact binary report of the current
+// runtime counters (comm diagnostics, task queue depths, heap usage)
+// and closes, so monitoring can scrape a running job.  Enabled at run
+// time via CHPL_RT_TELEMETRY; see chpl-telemetry.c for the socket and
+// report formats.
+//
+void chpl_telemetry_init(void);
+void chpl_telemetry_exit(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,56 @@
+/*
+ * Copyright 2020-2021 Hewlett Packard Enterprise Development LP
+ * Copyright 2004-2019 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _chpl_text_prefault_h_
+#define _chpl_text_prefault_h_
+
+#ifndef LAUNCHER
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//
+// Startup text prefault (opt in with CHPL_RT_TEXT_PREFAULT=true).
+//
+// Large generated binaries launched at scale demand-fault their way
+// through cold text for the first minutes of execution, and when many
+// ranks fault the same pages over a shared filesystem the faults
+// serialize behind it.  When enabled, startup walks the executable's
+// text mapping once: it advises the kernel to back the range with
+// transparent hugepages and to read it ahead, then touches every page.
+// The deliberate sequential sweep turns the fault storm into one
+// streaming read per node, before user code (or the network fabric)
+// is up and competing for it.
+//
+// CHPL_RT_TEXT_PREFAULT_PROFILE can name a file of hex text-segment
+// offsets, one per line (e.g. distilled from an instrumented or
+// perf-sampled run).  Those pages are touched first, in profile order,
+// so the hot path is resident before the sweep finishes the rest.
+//
+void chpl_text_prefault_init(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LAUNCHER
+
+#endif
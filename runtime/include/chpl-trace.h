@@ -0,0 +1,75 @@
+/*
+ * Copyright 2020-2021 Hewlett Packard Enterprise Development LP
+ * Copyright 2004-2019 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _chpl_trace_h_
+#define _chpl_trace_h_
+
+#ifndef LAUNCHER
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//
+// Distributed tracing (opt in with CHPL_RT_TRACE=true).
+//
+// The comm diagnostics counters say how much communication happened
+// but not which task caused it, and nothing ties a slow remote
+// operation back to the on-stmt that launched it.  When tracing is
+// enabled every task carries a span ID in its bundle: task creation
+// stamps a fresh span whose parent is the spawning task's span, and
+// because the span rides in the bundle, an on-stmt's active message
+// carries it to the remote side unchanged -- the remote body's events
+// land under the originating span with no comm-layer cooperation
+// beyond sending the bundle it already sends.
+//
+// Events (task begin/end, puts/gets, executeOns) are recorded through
+// the existing tasking and comm callbacks into a per-locale ring
+// buffer and dumped at exit as JSON lines, one file per locale; the
+// util/chpltrace tool merges the dumps into Chrome trace format
+// (chrome://tracing, Perfetto).  Timestamps are CLOCK_REALTIME, so
+// cross-locale ordering is only as good as the nodes' clock sync.
+//
+// Knobs: CHPL_RT_TRACE_EVENTS sizes the ring (default 1M events,
+// oldest overwritten); CHPL_RT_TRACE_FILE sets the dump-file prefix
+// (default "chpl-trace", yielding chpl-trace.<node>.jsonl).  Enable
+// tracing on every locale or spans arriving from untraced locales
+// will be garbage.
+//
+
+struct chpl_task_bundle;
+
+void chpl_trace_init(void);
+void chpl_trace_exit(void);
+
+// Stamp a task bundle at creation: a fresh span parented to the
+// current task's span when tracing is on, 0 otherwise.  Always
+// initializes the field, since bundles arrive uninitialized.
+void chpl_trace_stamp_bundle(struct chpl_task_bundle* b);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LAUNCHER
+
+#endif
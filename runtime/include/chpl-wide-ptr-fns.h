@@ -107,6 +107,49 @@ wide_ptr_t chpl_return_wide_ptr_add(wide_ptr_t ptr, size_t amt)
   return ptr;
 }
 
+// Packed wide pointers.  With --packed-wide-pointers <node-bits> the
+// compiler represents a wide pointer as a single 64-bit word holding
+// the node id in the uppermost nodeBits bits and the address in the
+// rest, instead of the (locale, addr) struct.  The generated code
+// calls these to pack and unpack that word; nodeBits arrives as a
+// compile-time constant at every call site.  Sublocale information is
+// not stored, so unpacking produces c_sublocid_any.
+
+typedef uint64_t chpl_packed_wide_ptr_t;
+
+static inline
+chpl_packed_wide_ptr_t chpl_wide_ptr_pack(chpl_localeID_t loc, void* addr,
+                                          int nodeBits)
+{
+  uint64_t node = (uint64_t) chpl_rt_nodeFromLocaleID(loc);
+  uint64_t uaddr = (uint64_t) (uintptr_t) addr;
+  if ((uaddr >> (64 - nodeBits)) != 0)
+    chpl_internal_error("address does not fit in a packed wide pointer");
+  return (node << (64 - nodeBits)) | uaddr;
+}
+
+static inline
+c_nodeid_t chpl_wide_ptr_get_node_packed(chpl_packed_wide_ptr_t ptr,
+                                         int nodeBits)
+{
+  return (c_nodeid_t) (ptr >> (64 - nodeBits));
+}
+
+static inline
+void* chpl_wide_ptr_get_address_packed(chpl_packed_wide_ptr_t ptr,
+                                       int nodeBits)
+{
+  return (void*) (uintptr_t) (ptr & (~(uint64_t) 0 >> nodeBits));
+}
+
+static inline
+chpl_localeID_t chpl_wide_ptr_get_localeID_packed(chpl_packed_wide_ptr_t ptr,
+                                                  int nodeBits)
+{
+  return chpl_rt_buildLocaleID(chpl_wide_ptr_get_node_packed(ptr, nodeBits),
+                               c_sublocid_any);
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,95 @@
+/*
+ * Copyright 2020-2021 Hewlett Packard Enterprise Development LP
+ * Copyright 2004-2019 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//
+// Inter-locale work stealing for distributed parallel loops.
+//
+// A distributed forall assigns each locale a static share of the
+// iteration space; when per-iteration cost varies, the loaded locales
+// finish last while the rest idle.  This engine lets a locale that has
+// drained its share request chunks from peers that still have work.
+//
+// Each locale wraps its share in a chpl_worksteal_t whose local chunks
+// come from the guided scheduler in chpl-dyn-sched.h.  When the local
+// range is empty, chpl_worksteal_next() sweeps the other locales with a
+// small steal request sent as a fast executeOn: the handler runs on the
+// victim, carves a chunk off the victim's own scheduler, and PUTs the
+// bounds back to the thief.  Since thieves and local tasks share one
+// cursor, a stolen chunk is never run twice.
+//
+// The steal handler must be reachable through chpl_ftable[], so the
+// caller registers a wrapper that forwards its bundle to
+// chpl_worksteal_handleSteal() and passes that wrapper's index as
+// 'stealFid'.  Engines on different locales find each other through a
+// caller-chosen id that must be the same on every locale for a given
+// loop instance.
+//
+
+#ifndef _chpl_worksteal_h_
+#define _chpl_worksteal_h_
+
+#include "chpltypes.h"
+#include "chpl-atomics.h"
+#include "chpl-comm.h"
+#include "chpl-dyn-sched.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct chpl_worksteal_s {
+  chpl_dynsched_t sched;          // this locale's share of the iterations
+  int64_t id;                     // loop instance id, equal on all locales
+  chpl_fn_int_t stealFid;         // ftable index of the steal wrapper
+  int64_t minSteal;               // don't steal from ranges smaller than this
+  c_nodeid_t lastVictim;          // where the last steal succeeded
+  struct chpl_worksteal_s* next;  // registry chain
+} chpl_worksteal_t;
+
+// Register this locale's share [lo, hi) of a distributed loop.  Must be
+// called on every locale (with the same id) before any of them can run
+// out of local work and come stealing.
+void chpl_worksteal_init(chpl_worksteal_t* ws, int64_t id,
+                         int64_t lo, int64_t hi,
+                         int32_t numTasks, int64_t minChunk,
+                         int64_t minSteal, chpl_fn_int_t stealFid);
+
+// Claim the next chunk: a local one while any remain, then a stolen one.
+// 'owner' is set to the locale whose share the chunk came from, so the
+// loop body can address that locale's data.  Returns false once this
+// locale and every peer it asked are drained.
+chpl_bool chpl_worksteal_next(chpl_worksteal_t* ws,
+                              int64_t* lo, int64_t* hi,
+                              c_nodeid_t* owner,
+                              int lineno, int32_t filename);
+
+// The victim-side body of the steal wrapper registered in chpl_ftable[].
+void chpl_worksteal_handleSteal(chpl_comm_on_bundle_t* bundle);
+
+// Unregister the engine.  The caller is responsible for making sure no
+// peer will steal from this loop instance afterwards (i.e. all locales
+// have finished iterating).
+void chpl_worksteal_destroy(chpl_worksteal_t* ws);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
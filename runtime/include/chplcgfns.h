@@ -77,10 +77,15 @@ extern const char* CHPL_THIRD_PARTY;
 extern const int CHPL_STACK_CHECKS;
 extern const int CHPL_CACHE_REMOTE;
 extern const int CHPL_INTERLEAVE_MEM;
-
-// Sorted lookup table of filenames used with insertLineNumbers for error
-// messages and logging. Defined in chpl_compilation_config.c (needed by launchers)
-extern const c_string chpl_filenameTable[];
+extern const int CHPL_WIDE_POINTERS_NODE_BITS;
+
+// Lookup table of filenames used with insertLineNumbers for error
+// messages and logging. The null-terminated filenames are concatenated
+// into one character blob, indexed by a table of offsets; this avoids
+// the load-time relocations an array of string pointers would need.
+// Defined in chpl_compilation_config.c (needed by launchers)
+extern const c_char chpl_filenameTableData[];
+extern const c_int chpl_filenameTableOffsets[];
 extern const int32_t chpl_filenameTableSize;
 
 // Lookup tables used as a symbol table by the stack unwinder for translating
@@ -93,6 +98,7 @@ extern char* chpl_executionCommand;
 
 /* generated */
 extern const chpl_fn_p chpl_ftable[];
+extern const chpl_bool chpl_ftableNonBlocking[];
 extern const chpl_fn_info chpl_finfo[];
 
 extern void chpl__initStringLiterals(void);
@@ -40,6 +40,13 @@ int chpl_sys_getNumCPUsLogical(chpl_bool accessible_only);
 //
 c_string chpl_nodeName(void);
 
+//
+// does the running CPU support the named feature (e.g. "avx2")?
+// Used by the kernel-version dispatchers generated under
+// --target-cpu-versions; safe to call from global constructors.
+//
+chpl_bool chpl_sys_cpuSupportsFeature(const char* feature);
+
 #ifdef __cplusplus
 }
 #endif
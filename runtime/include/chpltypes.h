@@ -45,6 +45,18 @@ typedef std::complex<double> _complex128;
 extern "C" {
 #endif
 
+//
+// The cache line size assumed when padding data to avoid false
+// sharing, and an attribute the generated code uses to align
+// per-task state (e.g. reduce-intent accumulation states) to it.
+//
+#define CHPL_CACHE_LINE_SIZE 64
+#if defined(__GNUC__) || defined(__clang__)
+#define CHPL_CACHELINE_ALIGNED __attribute__((aligned(CHPL_CACHE_LINE_SIZE)))
+#else
+#define CHPL_CACHELINE_ALIGNED
+#endif
+
 // C types usable from Chapel.
 typedef char c_char;
 typedef signed char c_schar;
@@ -65,6 +65,13 @@ void chpl_comm_impl_task_create(void);
         chpl_comm_impl_task_end()
 void chpl_comm_impl_task_end(void);
 
+//
+// Cooperative network progress at task yield points.
+//
+#define CHPL_COMM_IMPL_TASK_YIELD() \
+        chpl_comm_impl_task_yield()
+void chpl_comm_impl_task_yield(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -45,6 +45,7 @@ typedef struct {
   void* amo_nf_buff;
   void* get_buff;
   void* put_buff;
+  void* xo_buff;
 } chpl_comm_taskPrvData_t;
 
 //
@@ -35,17 +35,26 @@ extern int verbosity;
 // These functions eventually call out to chpl_exit_any, or try to perform a
 // filename index -> filename lookup, neither of which can be performed while
 // the runtime is being unit tested
+// All of these are marked cold so the backend optimizes them for size
+// and lays them out away from hot code; the error paths additionally
+// never return (they end in chpl_exit_any).
 #ifndef CHPL_RT_UNIT_TEST
-void chpl_warning(const char* message, int32_t lineno, int32_t filenameIdx);
+void chpl_warning(const char* message, int32_t lineno, int32_t filenameIdx)
+       __attribute__((cold));
 void chpl_warning_explicit(const char *message, int32_t lineno,
-                           const char *filename);
-void chpl_error_preformatted(const char* message);
-void chpl_error(const char* message, int32_t lineno, int32_t filenameIdx);
+                           const char *filename)
+       __attribute__((cold));
+void chpl_error_preformatted(const char* message)
+       __attribute__((cold, noreturn));
+void chpl_error(const char* message, int32_t lineno, int32_t filenameIdx)
+       __attribute__((cold, noreturn));
 void chpl_error_explicit(const char *message, int32_t lineno,
-                         const char *filename);
-void chpl_internal_error(const char* message);
+                         const char *filename)
+       __attribute__((cold, noreturn));
+void chpl_internal_error(const char* message)
+       __attribute__((cold, noreturn));
 void chpl_internal_error_v(const char *restrict format, ...)
-       __attribute__((format(printf, 1, 2)));
+       __attribute__((cold, noreturn, format(printf, 1, 2)));
 #else
 // Filename is now an int32_t index into a table that we are not going to have
 // while the runtime is in unit test mode, just print out the message instead
@@ -40,6 +40,42 @@ qbytes_t* bulk_get_bytes(int64_t src_locale, qbytes_t* src_addr);
 qioerr bulk_put_buffer(int64_t dst_locale, void* dst_addr, int64_t dst_len,
                       qbuffer_t* buf, qbuffer_iter_t start, qbuffer_iter_t end);
 
+// A sorted-ops completion engine for many small gets from one source
+// locale.  Queue reads with bulk_get_engine_add, then call
+// bulk_get_engine_finish: it sorts the queued requests by source
+// offset, merges extents separated by no more than max_gap bytes, gets
+// each merged extent with a single large operation into a bounce
+// buffer, and scatters the pieces back to their destinations.  A
+// random-access reader that would otherwise issue thousands of small
+// gets instead issues a few large ones.
+typedef struct bulk_get_request_s {
+  int64_t offset;  // source offset in bytes from src_base
+  void*   dst;     // local destination
+  int64_t len;
+} bulk_get_request_t;
+
+typedef struct bulk_get_engine_s {
+  int64_t src_locale;
+  void*   src_base;
+  int64_t max_gap;     // merge extents separated by <= this many bytes
+  int64_t max_merged;  // upper bound on one merged operation's span
+  bulk_get_request_t* reqs;
+  ssize_t num;
+  ssize_t cap;
+} bulk_get_engine_t;
+
+void bulk_get_engine_init(bulk_get_engine_t* eng,
+                          int64_t src_locale, void* src_base);
+
+qioerr bulk_get_engine_add(bulk_get_engine_t* eng,
+                           void* dst, int64_t offset, int64_t len);
+
+// Issues the merged operations and releases the queued requests.  The
+// engine can be reused for another batch afterwards.
+qioerr bulk_get_engine_finish(bulk_get_engine_t* eng);
+
+void bulk_get_engine_destroy(bulk_get_engine_t* eng);
+
 
 #ifdef __cplusplus
 }
@@ -465,6 +465,54 @@ void deque_pop_back(const ssize_t item_size, deque_t* d)
   }
 }
 
+/* A bounded FIFO layered on the deque, for producer/consumer patterns
+ * where the producer can outrun the consumer.  At most max_items items
+ * are resident in the deque; a push beyond that either reports
+ * backpressure (EAGAIN, so the caller can block or throttle) or spills
+ * the oldest items to an anonymous temp file, keeping memory fixed.
+ *
+ * Spilled items are read back a chunk at a time into a separate refill
+ * buffer, so the consumer drains one buffer while the producer keeps
+ * appending to the deque, and steady state costs one read and one
+ * write syscall per chunk rather than per item.
+ *
+ * Items are raw bytes here just as in the deque itself; items holding
+ * pointers must not be spilled unless the pointed-to data stays valid
+ * (and resident) for the item's lifetime.
+ *
+ * FIFO order is maintained because items only ever move oldest-first:
+ * everything in the refill buffer is older than everything in the
+ * file, which is older than everything in the deque.
+ */
+
+#define DEQUE_BOUND_BLOCK 0 /* full push returns EAGAIN */
+#define DEQUE_BOUND_SPILL 1 /* full push spills oldest items to disk */
+
+typedef struct bounded_deque_s {
+  deque_t deque;
+  ssize_t max_items;    // max items resident in the deque
+  ssize_t chunk_items;  // items spilled/read back per syscall
+  int mode;             // DEQUE_BOUND_BLOCK or DEQUE_BOUND_SPILL
+  int spill_fd;         // temp file; -1 until the first spill
+  int64_t spill_read;   // file offset of the oldest unread item
+  int64_t spill_write;  // file offset for the next spilled item
+  void* refill;         // items read back from the file, oldest first
+  ssize_t refill_pos;   // in items
+  ssize_t refill_cnt;   // in items
+} bounded_deque_t;
+
+// These functions are in the C file.
+qioerr bounded_deque_init(const ssize_t item_size, bounded_deque_t* d,
+                          ssize_t max_items, int mode);
+void bounded_deque_destroy(bounded_deque_t* d);
+ssize_t bounded_deque_size(const ssize_t item_size, bounded_deque_t* d);
+// Returns EAGAIN in DEQUE_BOUND_BLOCK mode when the deque is full.
+qioerr bounded_deque_push_back(const ssize_t item_size, bounded_deque_t* d,
+                               void* value);
+// Copies the oldest item to 'out' and removes it; EEOF when empty.
+qioerr bounded_deque_pop_front(const ssize_t item_size, bounded_deque_t* d,
+                               void* out);
+
 
 #ifdef __cplusplus
 } // end extern "C"
@@ -106,6 +106,15 @@ typedef struct {
 qioerr qio_lock(qio_lock_t* x);
 void qio_unlock(qio_lock_t* x);
 
+// Lock acquire/release for threads outside the tasking layer (e.g.
+// the subprocess drain thread), which have no task ID to record as
+// the owner.  The holder appears as a reserved pseudo-owner no task
+// can match, so tasks contending for the lock wait in qio_lock()
+// until it is released.  Acquire and release must happen on the same
+// thread; these are not re-entrant.
+qioerr qio_lock_extern_thread(qio_lock_t* x);
+void qio_unlock_extern_thread(qio_lock_t* x);
+
 static inline qioerr qio_lock_init(qio_lock_t* x) {
   x->owner = NULL_OWNER;
   x->count = 0;
@@ -145,6 +154,11 @@ static inline qioerr qio_lock(qio_lock_t* x) {
 // and not anything that can reasonably be responded to.
 static inline void qio_unlock(qio_lock_t* x) { int rc = pthread_mutex_unlock(x); if( rc ) { assert(rc == 0); abort(); } }
 
+// In this build the lock is an ordinary recursive pthread mutex, so a
+// thread outside the tasking layer can simply use it directly.
+static inline qioerr qio_lock_extern_thread(qio_lock_t* x) { return qio_lock(x); }
+static inline void qio_unlock_extern_thread(qio_lock_t* x) { qio_unlock(x); }
+
 static inline qioerr qio_lock_init(qio_lock_t* x) {
   pthread_mutexattr_t attr;
   err_t err, newerr;
@@ -432,6 +446,9 @@ qioerr qio_readv(qio_file_t* file, qbuffer_t* buf, qbuffer_iter_t start, qbuffer
 qioerr qio_writev(qio_file_t* file, qbuffer_t* buf, qbuffer_iter_t start, qbuffer_iter_t end, ssize_t* num_written);
 qioerr qio_preadv(qio_file_t* file, qbuffer_t* buf, qbuffer_iter_t start, qbuffer_iter_t end, int64_t seek_to_offset, ssize_t* num_read);
 qioerr qio_pwritev(qio_file_t* file, qbuffer_t* buf, qbuffer_iter_t start, qbuffer_iter_t end, int64_t seek_to_offset, ssize_t* num_written);
+// Reads len bytes at offset into ptr with nstreams concurrent preads,
+// splitting the range on elem_size boundaries.  For bulk binary reads.
+qioerr qio_file_pread_parallel(qio_file_t* file, int64_t offset, void* ptr, int64_t len, int64_t elem_size, int64_t nstreams, int64_t* num_read_out);
 
 // if fp is not null, fd is ignored; if fp is null, we use fd.
 // the QIO file takes ownership of fp or fd, closing it when the QIO file is closed.
@@ -616,6 +633,8 @@ typedef uint64_t qio_bitbuffer_t;
 // for a right shift that zeros if we want 0 bits left...
 #define qio_bitbuffer_topn(x,amt) ( ((amt) != 0)?((x) >> (8*sizeof(qio_bitbuffer_t) - (amt))):(0) )
 
+struct qio_codec_fns_s; // see qio_codec.h
+
 typedef struct qio_channel_s {
   // reference count which is atomically updated
   qbytes_refcnt_t ref_cnt;
@@ -718,6 +737,17 @@ typedef struct qio_channel_s {
   // for the common case of very few marks.
   int64_t mark_space[MARK_INITIAL_STACK_SZ];
 
+  // Optional compression codec (see qio_codec.h); NULL for the normal
+  // uncompressed path.  Attached with qio_channel_set_codec(), along
+  // with scratch buffers for one raw chunk and one encoded frame.
+  const struct qio_codec_fns_s* codec;
+  void* codec_raw;
+  void* codec_enc;
+
+  // Asynchronous readahead state (see qio.c); NULL until the first
+  // refill on a channel eligible for it.
+  struct qio_readahead_s* readahead;
+
   qio_style_t style;
 } qio_channel_t;
 
@@ -777,6 +807,14 @@ qioerr _qio_channel_init_file(qio_channel_t* ch, qio_file_t* file, qio_hint_t hi
 // maybe want to use INT64_MAX for end if it's not to be restricted.
 qioerr qio_channel_create(qio_channel_t** ch_out, qio_file_t* file, qio_hint_t hints, int readable, int writeable, int64_t start, int64_t end, qio_style_t* style);
 
+// Attach a registered compression codec (see qio_codec.h) to a
+// channel, by name.  Must be called before any data moves through the
+// channel, and only sequential (QIO_METHOD_READWRITE) buffered
+// channels can carry one: encoded frames destroy the 1:1 map between
+// channel offsets and file offsets that positional I/O and seeking
+// rely on.
+qioerr qio_channel_set_codec(const int threadsafe, qio_channel_t* ch, const char* name);
+
 
 qioerr qio_relative_path(const char** path_out, const char* cwd, const char* path);
 qioerr qio_shortest_path(qio_file_t* file, const char** path_out, const char* path_in);
@@ -1268,6 +1306,12 @@ qioerr qio_channel_put_bytes(const int threadsafe, qio_channel_t* ch, qbytes_t*
 
 qioerr qio_channel_put_buffer(const int threadsafe, qio_channel_t* ch, qbuffer_t* src, qbuffer_iter_t src_start, qbuffer_iter_t src_end);
 
+// Writes a large contiguous block (e.g. the data of a numeric array)
+// without copying it through the channel buffer, by appending it as a
+// borrowed buffer part and flushing before returning. Falls back to
+// qio_channel_write when the zero-copy path does not apply.
+qioerr qio_channel_write_block_stream(const int threadsafe, qio_channel_t* restrict ch, const void* restrict ptr, ssize_t len, ssize_t* restrict amt_written);
+
 
 static inline
 qioerr qio_channel_flush(const int threadsafe, qio_channel_t* ch)
@@ -0,0 +1,95 @@
+/*
+ * Copyright 2020-2021 Hewlett Packard Enterprise Development LP
+ * Copyright 2004-2019 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* Pluggable compression codecs for QIO channels.
+ *
+ * A codec is a named pair of pure buffer-to-buffer transforms plus a
+ * worst-case output-size bound.  Codecs are attached to a channel with
+ * qio_channel_set_codec() (see qio.h); the channel then encodes each
+ * buffered chunk as it is flushed and decodes frames as the buffer is
+ * refilled, so codec work interleaves with the channel's normal
+ * write-behind/read-ahead rhythm and callers see an ordinary channel.
+ *
+ * One codec, "rle", is built in: a PackBits-style byte run-length
+ * encoder, enough for the zero- and constant-heavy data that makes
+ * checkpoint files compressible.  Heavier codecs (zstd, lz4, ...) are
+ * expected to be registered through qio_codec_register() by glue code
+ * in the configurations that link those libraries; nothing here
+ * depends on them.  Registration is meant to happen during program
+ * startup and is not itself thread-safe.
+ *
+ * On-"disk" format: each encoded chunk is preceded by a
+ * qio_codec_frame_t giving the encoded and raw lengths, so a reader
+ * can size its buffers before decoding and can detect truncation.
+ * The frame stream is sequential by construction; there is no map
+ * from channel offsets to file offsets.
+ */
+
+#ifndef _QIO_CODEC_H_
+#define _QIO_CODEC_H_
+
+#include "sys_basic.h"
+#include "qio_error.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct qio_codec_fns_s {
+  const char* name;
+
+  /* Returns the worst-case encoded size for in_len raw bytes; the
+     channel sizes its scratch buffers with this. */
+  ssize_t (*encode_bound)(ssize_t in_len);
+
+  /* Encode in[0..in_len) into out, which holds out_max bytes (at
+     least encode_bound(in_len)); sets *out_len to the encoded size. */
+  qioerr (*encode)(const void* in, ssize_t in_len,
+                   void* out, ssize_t out_max, ssize_t* out_len);
+
+  /* Decode in[0..in_len) into out, which holds out_max bytes; sets
+     *out_len to the decoded size.  Truncated or malformed input is an
+     error, not a short result. */
+  qioerr (*decode)(const void* in, ssize_t in_len,
+                   void* out, ssize_t out_max, ssize_t* out_len);
+} qio_codec_fns_t;
+
+/* Header preceding each encoded chunk in a codec channel's stream. */
+typedef struct qio_codec_frame_s {
+  uint32_t enc_len;
+  uint32_t raw_len;
+} qio_codec_frame_t;
+
+/* Add a codec to the registry; fns must stay valid for the life of
+   the program.  Fails with EINVAL for an incomplete codec or a
+   duplicate name and with ENOMEM when the registry is full. */
+qioerr qio_codec_register(const qio_codec_fns_t* fns);
+
+/* Returns the codec registered under name, or NULL. */
+const qio_codec_fns_t* qio_codec_lookup(const char* name);
+
+#ifdef __cplusplus
+} // end extern "C"
+#endif
+
+#endif
@@ -61,6 +61,16 @@ qioerr qio_proc_communicate(
     qio_channel_t* output,
     qio_channel_t* error);
 
+// Zero-copy forwarding between descriptor-backed files (e.g. a plain
+// file and a subprocess pipe) for the case where no transformation is
+// applied to the data; see qio_popen.c for the requirements.
+qioerr qio_proc_forward(qio_file_t* from, qio_file_t* to,
+                        int64_t max_bytes, int64_t* amt_forwarded);
+
+// Drain a subprocess output channel (normally stderr) to EOF on a
+// background thread instead of inside qio_proc_communicate.
+qioerr qio_proc_drain_async(qio_channel_t* ch);
+
 qioerr qio_send_signal(int64_t pid, int qio_sig);
 
 #ifdef __cplusplus
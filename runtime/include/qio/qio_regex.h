@@ -129,6 +129,13 @@ qio_bool qio_regex_match(qio_regex_t* regex, const char* str, int64_t str_len, i
 
 int64_t qio_regex_replace(qio_regex_t* regex, const char* repl, int64_t repl_len, const char* str, int64_t str_len, int64_t startpos, int64_t endpos, qio_bool global, const char** str_out, int64_t* len_out);
 
+// Finds up to maxmatches non-overlapping, unanchored matches of regex in
+// str between startpos and endpos, storing each match's span in matches.
+// The spans are offsets into str -- nothing is copied, so str can be an
+// mmap'd channel window or any other caller-owned buffer.  Capture groups
+// are not reported.  Returns the number of matches found.
+int64_t qio_regex_match_all(qio_regex_t* regex, const char* str, int64_t str_len, int64_t startpos, int64_t endpos, qio_regex_string_piece_t* matches, int64_t maxmatches);
+
 
 // Returns ENOERR if we matched, EFORMAT if we did not, or an IO error.
 // Must have a mark already set.
@@ -45,10 +45,12 @@
 #include "chpl-comm.h"
 #include "chpl-comm-diags.h"
 #include "chpldirent.h"
+#include "chpl-dyn-sched.h"
 #include "chplexit.h"
 #include "chpl-export-wrappers.h"
 #include "chpl-external-array.h"
 #include "chpl-file-utils.h"
+#include "chpl-forall-instrument.h"
 #include <chplfp.h>
 #include "chpl-gpu.h"
 #include "chplglob.h"
@@ -61,8 +63,10 @@
 #include "chplmemtrack.h"
 #include "chpl-prefetch.h"
 #include "chpl-privatization.h"
+#include "chpl-snapshot.h"
 #include "chpl-string.h"
 #include "chplsys.h"
+#include "chpl-taskgraph.h"
 #include "chpl-tasks.h"
 #include "chpltimers.h"
 #include "chpl-topo.h"
@@ -103,6 +103,15 @@
 #endif
 
 
+// Marks a generated function as rarely executed: GNU-compatible
+// compilers optimize it for size and place it away from hot code, so
+// error/halt paths don't share icache lines with steady-state loops.
+#if defined(__GNUC__)
+#define chpl_cold_fn __attribute__((cold))
+#else
+#define chpl_cold_fn
+#endif
+
 #ifdef __cplusplus
 // g++ supports restrict in C++ with the name __restrict. For other compilers,
 // we just #define-out restrict.
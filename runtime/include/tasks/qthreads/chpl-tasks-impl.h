@@ -59,9 +59,19 @@ typedef unsigned int chpl_taskID_t;
 //
 // Sync variables
 //
+// The lock word holds 0 (unlocked), 1 (locked, no waiters), or 2
+// (locked, there may be waiters); uncontended transitions are plain
+// CAS and only contended ones touch the FEB machinery, through
+// signal_lock.  The waiter counts are protected by the lock and let
+// the signaling side skip the FEB fill when no one is waiting.  See
+// chpl_sync_lock() and friends in tasks-qthreads.c.
+//
 typedef struct {
     aligned_t lock;
+    aligned_t signal_lock;
     int       is_full;
+    int       num_waiters_full;
+    int       num_waiters_empty;
     aligned_t signal_full;
     aligned_t signal_empty;
 } chpl_sync_aux_t;
@@ -0,0 +1,371 @@
+/*
+ * Copyright 2020-2021 Hewlett Packard Enterprise Development LP
+ * Copyright 2004-2019 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "chplrt.h"
+
+#include "chpl-algorithms.h"
+
+#include "chpl-atomics.h"
+#include "chpl-linefile-support.h"
+#include "chpl-mem.h"
+#include "error.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define RADIX_BITS    8
+#define RADIX_BUCKETS (1 << RADIX_BITS)
+
+
+static void* allocScratch(int64_t n, size_t eltSize) {
+  return chpl_mem_allocMany(n, eltSize, CHPL_RT_MD_ALGO_SCRATCH,
+                            0, CHPL_FILE_IDX_INTERNAL);
+}
+
+static void freeScratch(void* p) {
+  chpl_mem_free(p, 0, CHPL_FILE_IDX_INTERNAL);
+}
+
+
+////////////////////////////////////////
+//
+// Radix sort
+//
+
+//
+// The element's key, widened to uint64_t and bias-flipped so unsigned
+// comparison of the result matches the key's own ordering.  The memcpy
+// through a correctly sized local keeps this byte-order agnostic; it
+// compiles to a plain load.
+//
+static inline
+uint64_t radixKey(const unsigned char* elt, size_t keyOff, int keyBytes,
+                  chpl_bool keyIsSigned) {
+  uint64_t key;
+
+  switch (keyBytes) {
+  case 1: { uint8_t  k; memcpy(&k, elt + keyOff, 1); key = k; } break;
+  case 2: { uint16_t k; memcpy(&k, elt + keyOff, 2); key = k; } break;
+  case 4: { uint32_t k; memcpy(&k, elt + keyOff, 4); key = k; } break;
+  case 8: { uint64_t k; memcpy(&k, elt + keyOff, 8); key = k; } break;
+  default:
+    chpl_internal_error("chpl_algo_radixSort: bad key width");
+    key = 0;
+    break;
+  }
+
+  if (keyIsSigned)
+    key ^= UINT64_C(1) << (8 * keyBytes - 1);
+
+  return key;
+}
+
+void chpl_algo_radixSort(void* elts, int64_t n, size_t eltSize,
+                         size_t keyOff, int keyBytes,
+                         chpl_bool keyIsSigned) {
+  if (n < 2)
+    return;
+
+  if (keyBytes != 1 && keyBytes != 2 && keyBytes != 4 && keyBytes != 8)
+    chpl_internal_error("chpl_algo_radixSort: bad key width");
+
+  unsigned char* src = (unsigned char*) elts;
+  unsigned char* dst = (unsigned char*) allocScratch(n, eltSize);
+
+  for (int pass = 0; pass < keyBytes; pass++) {
+    const int shift = pass * RADIX_BITS;
+    int64_t   count[RADIX_BUCKETS] = { 0 };
+
+    for (int64_t i = 0; i < n; i++) {
+      uint64_t key = radixKey(src + i * eltSize, keyOff, keyBytes,
+                              keyIsSigned);
+      count[(key >> shift) & (RADIX_BUCKETS - 1)]++;
+    }
+
+    //
+    // Skip the scatter when every key agrees on this byte -- common for
+    // the high bytes of small values, and it makes sorting nearly-small
+    // keys with a wide type cost what the narrow type would.
+    //
+    if (count[(radixKey(src, keyOff, keyBytes, keyIsSigned)
+               >> shift) & (RADIX_BUCKETS - 1)] == n)
+      continue;
+
+    int64_t pos = 0;
+    for (int b = 0; b < RADIX_BUCKETS; b++) {
+      int64_t c = count[b];
+      count[b] = pos;
+      pos += c;
+    }
+
+    for (int64_t i = 0; i < n; i++) {
+      uint64_t key = radixKey(src + i * eltSize, keyOff, keyBytes,
+                              keyIsSigned);
+      int64_t  to  = count[(key >> shift) & (RADIX_BUCKETS - 1)]++;
+
+      memcpy(dst + to * eltSize, src + i * eltSize, eltSize);
+    }
+
+    unsigned char* tmp = src;
+    src = dst;
+    dst = tmp;
+  }
+
+  if (src != (unsigned char*) elts) {
+    memcpy(elts, src, n * eltSize);
+    freeScratch(src);
+  } else {
+    freeScratch(dst);
+  }
+}
+
+
+////////////////////////////////////////
+//
+// Partition
+//
+
+int64_t chpl_algo_partitionU64(uint64_t* keys, int64_t n, uint64_t pivot) {
+  if (n <= 0)
+    return 0;
+
+  //
+  // Count first, then scatter to precomputed cursors.  Both loops are
+  // branchless in the key test, so the counting loop vectorizes and the
+  // scatter compiles to conditional moves rather than mispredicted
+  // branches on random input.
+  //
+  int64_t nLess = 0;
+
+  for (int64_t i = 0; i < n; i++)
+    nLess += (keys[i] < pivot) ? 1 : 0;
+
+  if (nLess == 0 || nLess == n)
+    return nLess;
+
+  uint64_t* scratch = (uint64_t*) allocScratch(n, sizeof(uint64_t));
+  int64_t   lo      = 0;
+  int64_t   hi      = nLess;
+
+  for (int64_t i = 0; i < n; i++) {
+    uint64_t k      = keys[i];
+    int64_t  isLess = (k < pivot) ? 1 : 0;
+
+    scratch[isLess ? lo : hi] = k;
+    lo += isLess;
+    hi += 1 - isLess;
+  }
+
+  memcpy(keys, scratch, n * sizeof(uint64_t));
+  freeScratch(scratch);
+
+  return nLess;
+}
+
+
+////////////////////////////////////////
+//
+// Parallel merge sort
+//
+
+//
+// One sort instance, shared by its tasks.  'pending' counts tasks still
+// running in the current phase; the coordinating task spawns, does its
+// own share, then yields until the count drains before starting the
+// next merge level.
+//
+typedef struct {
+  unsigned char*        src;
+  unsigned char*        dst;
+  size_t                eltSize;
+  chpl_algo_cmp_t       cmp;
+  atomic_int_least64_t  pending;
+} chpl_algo_sortDesc_t;
+
+typedef enum {
+  algoOpSortChunk,
+  algoOpMerge
+} chpl_algo_sortOp_t;
+
+//
+// The task argument; the task/bundle header must come first, just as in
+// compiler-generated bundles.
+//
+typedef struct {
+  chpl_task_bundle_t    task;
+  chpl_algo_sortDesc_t* desc;
+  chpl_algo_sortOp_t    op;
+  int64_t               lo;
+  int64_t               mid;
+  int64_t               hi;
+} chpl_algo_sortReq_t;
+
+
+static void mergeRuns(chpl_algo_sortDesc_t* d,
+                      int64_t lo, int64_t mid, int64_t hi) {
+  const size_t   sz = d->eltSize;
+  unsigned char* a  = d->src + lo  * sz;
+  unsigned char* ae = d->src + mid * sz;
+  unsigned char* b  = ae;
+  unsigned char* be = d->src + hi * sz;
+  unsigned char* o  = d->dst + lo * sz;
+
+  while (a < ae && b < be) {
+    if (d->cmp(a, b) <= 0) {
+      memcpy(o, a, sz);
+      a += sz;
+    } else {
+      memcpy(o, b, sz);
+      b += sz;
+    }
+    o += sz;
+  }
+
+  if (a < ae)
+    memcpy(o, a, ae - a);
+  if (b < be)
+    memcpy(o, b, be - b);
+}
+
+static void runSortOp(chpl_algo_sortReq_t* req) {
+  chpl_algo_sortDesc_t* d = req->desc;
+
+  if (req->op == algoOpSortChunk) {
+    qsort(d->src + req->lo * d->eltSize, req->hi - req->lo, d->eltSize,
+          d->cmp);
+  } else {
+    mergeRuns(d, req->lo, req->mid, req->hi);
+  }
+
+  (void) atomic_fetch_sub_int_least64_t(&d->pending, 1);
+}
+
+void chpl_algo_mergeSortWorker(chpl_task_bundle_t* bundle) {
+  runSortOp((chpl_algo_sortReq_t*) bundle);
+}
+
+//
+// Dispatch one phase operation: the last one of a phase runs inline in
+// the coordinating task, the rest go to the tasking layer.
+//
+static void dispatchSortOp(chpl_algo_sortDesc_t* d, chpl_fn_int_t workerFid,
+                           chpl_algo_sortOp_t op,
+                           int64_t lo, int64_t mid, int64_t hi,
+                           chpl_bool inline_) {
+  chpl_algo_sortReq_t req;
+
+  memset(&req, 0, sizeof(req));
+  req.desc = d;
+  req.op   = op;
+  req.lo   = lo;
+  req.mid  = mid;
+  req.hi   = hi;
+
+  if (inline_) {
+    runSortOp(&req);
+  } else {
+    chpl_task_addTask(workerFid, &req.task, sizeof(req), c_sublocid_any,
+                      0, CHPL_FILE_IDX_INTERNAL);
+  }
+}
+
+static void waitForPhase(chpl_algo_sortDesc_t* d) {
+  while (atomic_load_int_least64_t(&d->pending) > 0)
+    chpl_task_yield();
+}
+
+void chpl_algo_mergeSort(void* elts, int64_t n, size_t eltSize,
+                         chpl_algo_cmp_t cmp,
+                         chpl_fn_int_t workerFid, int64_t nTasks) {
+  if (n < 2)
+    return;
+
+  //
+  // Pick the chunk count: a power of two so the merge tree stays
+  // regular, no more than requested, and chunks of at least a few
+  // thousand elements so per-task costs stay in the noise.
+  //
+  int64_t nChunks = 1;
+
+  while (nChunks * 2 <= nTasks && n / (nChunks * 2) >= 4096)
+    nChunks *= 2;
+
+  if (workerFid == FID_NONE || nChunks == 1) {
+    qsort(elts, n, eltSize, cmp);
+    return;
+  }
+
+  chpl_algo_sortDesc_t d;
+
+  d.src     = (unsigned char*) elts;
+  d.dst     = (unsigned char*) allocScratch(n, eltSize);
+  d.eltSize = eltSize;
+  d.cmp     = cmp;
+  atomic_init_int_least64_t(&d.pending, 0);
+
+  unsigned char* scratch = d.dst;
+
+  //
+  // Phase 1: sort each chunk in its own task.
+  //
+  atomic_store_int_least64_t(&d.pending, nChunks);
+
+  for (int64_t c = 0; c < nChunks; c++) {
+    int64_t lo = n * c / nChunks;
+    int64_t hi = n * (c + 1) / nChunks;
+
+    dispatchSortOp(&d, workerFid, algoOpSortChunk, lo, 0, hi,
+                   c == nChunks - 1);
+  }
+
+  waitForPhase(&d);
+
+  //
+  // Phase 2: merge pairs of runs level by level, ping-ponging between
+  // the array and the scratch buffer.
+  //
+  for (int64_t width = 1; width < nChunks; width *= 2) {
+    int64_t nMerges = nChunks / (width * 2);
+
+    atomic_store_int_least64_t(&d.pending, nMerges);
+
+    for (int64_t m = 0; m < nMerges; m++) {
+      int64_t c0  = m * width * 2;
+      int64_t lo  = n * c0 / nChunks;
+      int64_t mid = n * (c0 + width) / nChunks;
+      int64_t hi  = n * (c0 + width * 2) / nChunks;
+
+      dispatchSortOp(&d, workerFid, algoOpMerge, lo, mid, hi,
+                     m == nMerges - 1);
+    }
+
+    waitForPhase(&d);
+
+    unsigned char* tmp = d.src;
+    d.src = d.dst;
+    d.dst = tmp;
+  }
+
+  if (d.src != (unsigned char*) elts)
+    memcpy(elts, d.src, n * eltSize);
+
+  atomic_destroy_int_least64_t(&d.pending);
+  freeScratch(scratch);
+}
@@ -21,6 +21,8 @@
 #include "chplrt.h"
 #include "chpl-bitops.h"
 
+#include <string.h>
+
 const uint8_t chpl_bitops_debruijn32[32] = {
   0, 1, 28, 2, 29, 14, 24, 3, 30, 22, 20, 15, 25, 17, 4, 8, 
   31, 27, 13, 23, 21, 19, 16, 7, 26, 12, 18, 6, 11, 5, 10, 9
@@ -33,3 +35,93 @@ const uint8_t chpl_bitops_debruijn64[64] = {
   56, 62, 11, 23, 32, 36, 44, 52, 55, 61, 22, 43, 51, 60, 42,
   59, 58
 };
+
+// unaligned-safe 64-bit load; compiles to a plain load on the
+// platforms we target
+static inline uint64_t chpl_bitops_load_64(const unsigned char* p) {
+  uint64_t x;
+  memcpy(&x, p, sizeof(x));
+  return x;
+}
+
+int chpl_bitops_memeq(const void* a, const void* b, size_t n) {
+  const unsigned char* pa = (const unsigned char*) a;
+  const unsigned char* pb = (const unsigned char*) b;
+  uint64_t diff = 0;
+
+  // Word-at-a-time with an OR-accumulated difference: branch-free in
+  // the loop body, so the backend compiler can vectorize it.  Short
+  // buffers finish with a pair of (possibly overlapping) word loads.
+  if (n >= 8) {
+    while (n > 8) {
+      diff |= chpl_bitops_load_64(pa) ^ chpl_bitops_load_64(pb);
+      pa += 8;
+      pb += 8;
+      n -= 8;
+    }
+    diff |= chpl_bitops_load_64(pa + n - 8) ^ chpl_bitops_load_64(pb + n - 8);
+    return diff == 0;
+  }
+
+  while (n > 0) {
+    diff |= (uint64_t) (*pa++ ^ *pb++);
+    n--;
+  }
+  return diff == 0;
+}
+
+// MurmurHash64A, by Austin Appleby; placed in the public domain.
+uint64_t chpl_bitops_memhash(const void* p, size_t n, uint64_t seed) {
+  const uint64_t m = 0xc6a4a7935bd1e995ULL;
+  const int r = 47;
+  const unsigned char* data = (const unsigned char*) p;
+  const unsigned char* end = data + (n & ~(size_t) 7);
+  uint64_t h = seed ^ (n * m);
+
+  while (data != end) {
+    uint64_t k = chpl_bitops_load_64(data);
+    data += 8;
+
+    k *= m;
+    k ^= k >> r;
+    k *= m;
+
+    h ^= k;
+    h *= m;
+  }
+
+  switch (n & 7) {
+    case 7: h ^= (uint64_t) data[6] << 48;           // fall through
+    case 6: h ^= (uint64_t) data[5] << 40;           // fall through
+    case 5: h ^= (uint64_t) data[4] << 32;           // fall through
+    case 4: h ^= (uint64_t) data[3] << 24;           // fall through
+    case 3: h ^= (uint64_t) data[2] << 16;           // fall through
+    case 2: h ^= (uint64_t) data[1] << 8;            // fall through
+    case 1: h ^= (uint64_t) data[0];
+            h *= m;
+  }
+
+  h ^= h >> r;
+  h *= m;
+  h ^= h >> r;
+
+  return h;
+}
+
+uint64_t chpl_bitops_popcount_mem(const void* p, size_t n) {
+  const unsigned char* data = (const unsigned char*) p;
+  uint64_t count = 0;
+
+  while (n >= 8) {
+    count += chpl_bitops_popcount_64(chpl_bitops_load_64(data));
+    data += 8;
+    n -= 8;
+  }
+
+  while (n > 0) {
+    count += chpl_bitops_popcount_32(*data++);
+    n--;
+  }
+
+  return count;
+}
@@ -0,0 +1,148 @@
+/*
+ * Copyright 2020-2021 Hewlett Packard Enterprise Development LP
+ * Copyright 2004-2019 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "chplrt.h"
+
+#include "chpl-blas-lite.h"
+
+#include <string.h>
+
+#ifdef CHPL_BLAS_LITE_USE_CBLAS
+#include <cblas.h>
+#endif
+
+//
+// The local kernels are deliberately plain loops over restrict-
+// qualified pointers: with aliasing and contiguity guaranteed by the
+// signature, the back-end compiler vectorizes them directly.  The dot
+// products accumulate into four partial sums so vectorization doesn't
+// depend on the compiler being allowed to reassociate floating-point
+// addition.
+//
+
+void chpl_blas_scopy(float* dst, const float* src, int64_t n) {
+#ifdef CHPL_BLAS_LITE_USE_CBLAS
+  cblas_scopy(n, src, 1, dst, 1);
+#else
+  memcpy(dst, src, n * sizeof(float));
+#endif
+}
+
+void chpl_blas_dcopy(double* dst, const double* src, int64_t n) {
+#ifdef CHPL_BLAS_LITE_USE_CBLAS
+  cblas_dcopy(n, src, 1, dst, 1);
+#else
+  memcpy(dst, src, n * sizeof(double));
+#endif
+}
+
+void chpl_blas_sscal(float* x, float a, int64_t n) {
+#ifdef CHPL_BLAS_LITE_USE_CBLAS
+  cblas_sscal(n, a, x, 1);
+#else
+  for (int64_t i = 0; i < n; i++)
+    x[i] *= a;
+#endif
+}
+
+void chpl_blas_dscal(double* x, double a, int64_t n) {
+#ifdef CHPL_BLAS_LITE_USE_CBLAS
+  cblas_dscal(n, a, x, 1);
+#else
+  for (int64_t i = 0; i < n; i++)
+    x[i] *= a;
+#endif
+}
+
+void chpl_blas_saxpy(float* restrict y, float a, const float* restrict x,
+                     int64_t n) {
+#ifdef CHPL_BLAS_LITE_USE_CBLAS
+  cblas_saxpy(n, a, x, 1, y, 1);
+#else
+  for (int64_t i = 0; i < n; i++)
+    y[i] += a * x[i];
+#endif
+}
+
+void chpl_blas_daxpy(double* restrict y, double a, const double* restrict x,
+                     int64_t n) {
+#ifdef CHPL_BLAS_LITE_USE_CBLAS
+  cblas_daxpy(n, a, x, 1, y, 1);
+#else
+  for (int64_t i = 0; i < n; i++)
+    y[i] += a * x[i];
+#endif
+}
+
+void chpl_blas_saxpyz(float* restrict dst, float a,
+                      const float* restrict x, const float* restrict y,
+                      int64_t n) {
+  for (int64_t i = 0; i < n; i++)
+    dst[i] = a * x[i] + y[i];
+}
+
+void chpl_blas_daxpyz(double* restrict dst, double a,
+                      const double* restrict x, const double* restrict y,
+                      int64_t n) {
+  for (int64_t i = 0; i < n; i++)
+    dst[i] = a * x[i] + y[i];
+}
+
+float chpl_blas_sdot(const float* restrict x, const float* restrict y,
+                     int64_t n) {
+#ifdef CHPL_BLAS_LITE_USE_CBLAS
+  return cblas_sdot(n, x, 1, y, 1);
+#else
+  float s0 = 0.0f, s1 = 0.0f, s2 = 0.0f, s3 = 0.0f;
+  int64_t i;
+
+  for (i = 0; i + 4 <= n; i += 4) {
+    s0 += x[i    ] * y[i    ];
+    s1 += x[i + 1] * y[i + 1];
+    s2 += x[i + 2] * y[i + 2];
+    s3 += x[i + 3] * y[i + 3];
+  }
+  for ( ; i < n; i++)
+    s0 += x[i] * y[i];
+
+  return (s0 + s1) + (s2 + s3);
+#endif
+}
+
+double chpl_blas_ddot(const double* restrict x, const double* restrict y,
+                      int64_t n) {
+#ifdef CHPL_BLAS_LITE_USE_CBLAS
+  return cblas_ddot(n, x, 1, y, 1);
+#else
+  double s0 = 0.0, s1 = 0.0, s2 = 0.0, s3 = 0.0;
+  int64_t i;
+
+  for (i = 0; i + 4 <= n; i += 4) {
+    s0 += x[i    ] * y[i    ];
+    s1 += x[i + 1] * y[i + 1];
+    s2 += x[i + 2] * y[i + 2];
+    s3 += x[i + 3] * y[i + 3];
+  }
+  for ( ; i < n; i++)
+    s0 += x[i] * y[i];
+
+  return (s0 + s1) + (s2 + s3);
+#endif
+}
@@ -274,6 +274,7 @@ use.
 #include "chplrt.h"
 #include "chpl-comm.h"
 #include "chpl-comm-diags.h"
+#include "chpl-env.h"
 #include "chpl-tasks.h"
 #include "chpl-mem.h"
 #include "chpl-atomics.h"
@@ -281,6 +282,8 @@ use.
 #include "chpl-cache.h"
 #include "chpl-comm-strd-xfer.h"
 #include "chpl-linefile-support.h"
+#include "chpl-page-migrate.h"
+#include "chpl-topo.h"
 #include "sys.h" // sys_page_size()
 #include "chpl-comm-compiler-macros.h"
 #include "chpl-comm-no-warning-macros.h" // No warnings for chpl_comm_get etc.
@@ -288,6 +291,8 @@ use.
 
 #include <string.h> // memcpy, memset, etc.
 #include <assert.h>
+#include <pthread.h>
+#include <time.h> // clock_gettime, for peer latency probes
 
 
 #ifdef HAS_CHPL_CACHE_FNS
@@ -480,6 +485,54 @@ struct rdcache_s;
 // Storing a remote address (node number is separate).
 typedef uintptr_t raddr_t;
 
+//
+// Per-peer latency tiers.
+//
+// One fetch granularity does not fit every peer: close peers favor
+// fetching just the requested lines (the access is latency-bound and
+// extra bytes only add transfer time), while distant or
+// oversubscribed peers favor big fetches that amortize their higher
+// round-trip (the access is bandwidth-bound).  When
+// CHPL_RT_CACHE_REMOTE_LATENCY_TIERS is set, the first miss against
+// a peer times a few 1-byte probe GETs (taking the minimum to shed
+// scheduling noise) and classifies the peer against
+// CHPL_RT_CACHE_REMOTE_FAR_NS; misses to far peers are then widened
+// to fetch the surrounding whole cache page.  The page's valid bits
+// track the wider fill, so nearby accesses hit without further
+// traffic.  Widening can refetch or write back lines the page
+// already held, which is the usual tradeoff for bigger lines.
+//
+#define PEER_TIER_UNKNOWN (-1)
+#define PEER_TIER_NEAR 0
+#define PEER_TIER_FAR 1
+
+static chpl_bool cache_latency_tiers = false;
+static uint64_t cache_far_latency_ns;
+static int8_t* peer_tiers; // one entry per node, classified lazily
+
+static int peer_tier(c_nodeid_t node, raddr_t raddr) {
+  if (peer_tiers[node] != PEER_TIER_UNKNOWN)
+    return peer_tiers[node];
+
+  uint64_t best = UINT64_MAX;
+  for (int i = 0; i < 3; i++) {
+    struct timespec t1, t2;
+    uint8_t probe;
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    chpl_comm_get(&probe, node, (void*) raddr, sizeof(probe),
+                  CHPL_COMM_UNKNOWN_ID, 0, 0);
+    clock_gettime(CLOCK_MONOTONIC, &t2);
+    uint64_t ns = (uint64_t) (t2.tv_sec - t1.tv_sec) * 1000000000
+                  + (uint64_t) (t2.tv_nsec - t1.tv_nsec);
+    if (ns < best)
+      best = ns;
+  }
+
+  peer_tiers[node] = (best > cache_far_latency_ns) ? PEER_TIER_FAR
+                                                   : PEER_TIER_NEAR;
+  return peer_tiers[node];
+}
+
 // This type contains the needed entry information to store in a lookup table.
 // 16 bytes.
 struct cache_table_entry_s {
@@ -542,6 +595,172 @@ raddr_t raddr_min(raddr_t a, raddr_t b)
     return (a<b)?a:b;
 }
 
+//////////////// NODE-LEVEL SHARED CACHE TIER ////////////////////
+//
+// The read caches in this file are per-pthread, so tasks running on
+// different threads each fetch their own copy of the same remote lines.
+// When CHPL_RT_CACHE_REMOTE_SHARED is set, clean GET data is also
+// published into a node-wide directory, sharded with one lock-protected
+// partition per core, and a miss in a per-thread cache consults that
+// directory before going to the network.  Read-mostly remote data is
+// then fetched once per node instead of once per thread.
+//
+// Memory consistency: shared entries are tagged with the value a global
+// epoch counter had before their network GET was issued.  A task records
+// the epoch current at its last acquire fence and at the last completed
+// flush of its own PUTs, and only accepts entries at least that fresh.
+// Data in an acceptable entry was therefore fetched from the owning node
+// after everything the task must observe became remotely visible, so a
+// shared-tier hit can return nothing staler than a network GET would.
+
+struct shared_cache_line_s {
+  c_nodeid_t node;      // remote node, or -1 if the slot is empty
+  raddr_t ra_line;      // line-aligned remote address
+  uint64_t fill_epoch;  // global epoch before the fill's GET was issued
+  unsigned char data[CACHELINE_SIZE];
+};
+
+struct shared_cache_shard_s {
+  pthread_mutex_t lock;
+  struct shared_cache_line_s* lines;
+};
+
+static int shared_cache_num_shards = 0;      // power of 2; 0 when disabled
+static int shared_cache_lines_per_shard = 0; // power of 2
+static struct shared_cache_shard_s* shared_cache_shards = NULL;
+static atomic_uint_least64_t shared_cache_epoch;
+
+static inline
+int shared_cache_enabled(void)
+{
+  return shared_cache_num_shards > 0;
+}
+
+static inline
+uint64_t shared_cache_epoch_now(void)
+{
+  return atomic_load_uint_least64_t(&shared_cache_epoch);
+}
+
+// Advance the global epoch and require at least the new value for this
+// task's future shared-tier hits.  Called at acquire fences and after
+// this task's PUTs are known to be remotely visible; over-calling only
+// costs hit rate, never correctness.
+static inline
+void shared_cache_advance_epoch(chpl_cache_taskPrvData_t* task_local)
+{
+  if( shared_cache_enabled() ) {
+    task_local->shared_min_epoch =
+      atomic_fetch_add_uint_least64_t(&shared_cache_epoch, 1) + 1;
+  }
+}
+
+static inline
+struct shared_cache_line_s* shared_cache_slot(c_nodeid_t node,
+                                              raddr_t ra_line,
+                                              struct shared_cache_shard_s** shard)
+{
+  uint64_t h = (uint64_t) ra_line >> CACHELINE_BITS;
+  h = h * UINT64_C(0x9e3779b97f4a7c15) + (uint64_t) node;
+  h ^= h >> 33;
+  *shard = &shared_cache_shards[h & (shared_cache_num_shards - 1)];
+  return &(*shard)->lines[(h >> 16) & (shared_cache_lines_per_shard - 1)];
+}
+
+// Copy the lines in [ra_line, ra_line_end) on node into dst if all of
+// them are present and fresh enough for this task.  Returns 1 for a
+// full hit; on a partial hit, dst may have been partly written.
+static
+int shared_cache_lookup(chpl_cache_taskPrvData_t* task_local,
+                        c_nodeid_t node, raddr_t ra_line, raddr_t ra_line_end,
+                        unsigned char* dst)
+{
+  raddr_t ra;
+
+  for( ra = ra_line; ra < ra_line_end; ra += CACHELINE_SIZE ) {
+    struct shared_cache_shard_s* shard;
+    struct shared_cache_line_s* line = shared_cache_slot(node, ra, &shard);
+    int hit = 0;
+
+    pthread_mutex_lock(&shard->lock);
+    if( line->node == node && line->ra_line == ra &&
+        line->fill_epoch >= task_local->shared_min_epoch ) {
+      chpl_memcpy(dst, line->data, CACHELINE_SIZE);
+      hit = 1;
+    }
+    pthread_mutex_unlock(&shard->lock);
+
+    if( !hit ) return 0;
+    dst += CACHELINE_SIZE;
+  }
+
+  return 1;
+}
+
+// Publish the lines in [ra_line, ra_line_end) fetched from node into
+// the shared directory.  fill_epoch must have been read before the GET
+// that produced src was issued.  Lines migrate on demand: a collision
+// simply replaces the old occupant, unless that occupant is the same
+// line with fresher data.
+static
+void shared_cache_publish(c_nodeid_t node, raddr_t ra_line, raddr_t ra_line_end,
+                          const unsigned char* src, uint64_t fill_epoch)
+{
+  raddr_t ra;
+
+  for( ra = ra_line; ra < ra_line_end; ra += CACHELINE_SIZE ) {
+    struct shared_cache_shard_s* shard;
+    struct shared_cache_line_s* line = shared_cache_slot(node, ra, &shard);
+
+    pthread_mutex_lock(&shard->lock);
+    if( line->node != node || line->ra_line != ra ||
+        line->fill_epoch <= fill_epoch ) {
+      line->node = node;
+      line->ra_line = ra;
+      line->fill_epoch = fill_epoch;
+      chpl_memcpy(line->data, src, CACHELINE_SIZE);
+    }
+    pthread_mutex_unlock(&shard->lock);
+
+    src += CACHELINE_SIZE;
+  }
+}
+
+static
+void shared_cache_init(void)
+{
+  int nshards, nlines, ncores, i, j;
+
+  if( ! chpl_env_rt_get_bool("CACHE_REMOTE_SHARED", false) ) return;
+
+  // one shard per core, rounded up to a power of 2
+  ncores = chpl_topo_getNumCPUsPhysical(true);
+  nshards = 1;
+  while( nshards < ncores ) nshards *= 2;
+
+  nlines = (int) chpl_env_rt_get_uint("CACHE_REMOTE_SHARED_LINES_PER_SHARD",
+                                      1024);
+  i = 1;
+  while( i < nlines ) i *= 2;
+  nlines = i;
+
+  shared_cache_shards = chpl_malloc(nshards *
+                                    sizeof(struct shared_cache_shard_s));
+  for( i = 0; i < nshards; i++ ) {
+    struct shared_cache_shard_s* shard = &shared_cache_shards[i];
+    pthread_mutex_init(&shard->lock, NULL);
+    shard->lines = chpl_calloc(nlines, sizeof(struct shared_cache_line_s));
+    for( j = 0; j < nlines; j++ ) {
+      shard->lines[j].node = -1;
+    }
+  }
+
+  atomic_init_uint_least64_t(&shared_cache_epoch, 0);
+
+  shared_cache_lines_per_shard = nlines;
+  shared_cache_num_shards = nshards;
+}
+
 // This entry stores the main information for the cache.
 // ~88 bytes. TODO: can we shrink it to 64 bytes?
 struct cache_entry_s {
@@ -623,6 +842,14 @@ struct rdcache_s {
   c_nodeid_t last_cache_miss_read_node;
   raddr_t last_cache_miss_read_addr;
 
+  // Readahead statistics, reported by chpl_cache_print_stats():
+  // prefetch GETs issued by readahead, total bytes they covered, and
+  // readahead opportunities abandoned because the target region was
+  // not gettable or the cache was congested.
+  uint64_t num_prefetches;
+  uint64_t prefetch_bytes;
+  uint64_t num_prefetches_blocked;
+
   // Used with the lookup table. This is the number of bits
   // for the number of table slots.
   int table_bits;
@@ -703,6 +930,14 @@ struct rdcache_s {
   chpl_comm_nb_handle_t *pending;
   cache_seqn_t *pending_sequence_numbers;
 
+  // Phase-adaptive caching (see adapt_merits_direct_comm): GET/PUT
+  // counts for the current observation window, and whether the most
+  // recently completed window was write-heavy enough that we should
+  // bypass the cache. Configured in chpl_cache_init.
+  uint64_t adapt_gets;
+  uint64_t adapt_puts;
+  chpl_bool adapt_bypass;
+
   // Lookup table
   __attribute__ ((aligned (64)))
   struct cache_table_slot_s table[];
@@ -754,6 +989,29 @@ static void check_line_aligned(void* ptr)
   assert(((intptr_t) ptr) % 64 == 0);
 }
 
+// Write-combining mode: when flushing a dirty page, try to issue the
+// dirty extents as a single strided PUT instead of one PUT each.
+// See flush_entry.  Configured in chpl_cache_init.
+static chpl_bool cache_write_combine = false;
+// Overrides the default limit on dirty pages held before flushing
+// (the write-combining flush watermark) when > 0.
+static int cache_max_dirty_pages = 0;
+
+// Phase-adaptive caching: track the GET/PUT mix over windows of
+// cache_adaptive_window operations and bypass cache consultation while
+// the workload is write-heavy (the cache mostly helps re-read data, and
+// write-heavy phases pay its bookkeeping for little benefit). The two
+// thresholds provide hysteresis: a window must be at least
+// cache_adaptive_hi_pct percent PUTs to start bypassing and fall below
+// cache_adaptive_lo_pct percent to re-enable caching, so a balanced
+// workload near one threshold does not flap. Tasks can override the
+// automatic decision with chpl_cache_policy_pin. Configured in
+// chpl_cache_init.
+static chpl_bool cache_adaptive = false;
+static uint64_t cache_adaptive_window = 4096;
+static uint64_t cache_adaptive_hi_pct = 75;
+static uint64_t cache_adaptive_lo_pct = 50;
+
 // aka create_cache
 static
 struct rdcache_s* cache_create(void) {
@@ -790,6 +1048,7 @@ struct rdcache_s* cache_create(void) {
                                 // buffer"
   // How many pages can be dirty at once?
   dirty_pages = 16 + cache_pages / 64;
+  if( cache_max_dirty_pages > 0 ) dirty_pages = cache_max_dirty_pages;
 
   // How many cache entries do we need?
   n_entries = cache_pages + aout_pages;
@@ -867,6 +1126,10 @@ struct rdcache_s* cache_create(void) {
   c->last_cache_miss_read_node = -1;
   c->last_cache_miss_read_addr = 0;
 
+  c->num_prefetches = 0;
+  c->prefetch_bytes = 0;
+  c->num_prefetches_blocked = 0;
+
   c->max_pages = cache_pages;
   c->max_entries = n_entries;
 
@@ -932,6 +1195,10 @@ struct rdcache_s* cache_create(void) {
   c->pending_len = MAX_PENDING;
   c->pending_first_entry = -1;
   c->pending_last_entry = -1;
+
+  c->adapt_gets = 0;
+  c->adapt_puts = 0;
+  c->adapt_bypass = false;
   // already set c->pending to allocated region
   // already set c->pending_sequence_numbers to allocated region
 
@@ -2042,8 +2309,63 @@ void flush_entry(struct rdcache_s* cache,
       dirty_bits = dirty->dirty;
       if( len == CACHEPAGE_SIZE ||
           any_set_for_skip_len(dirty_bits, skip, len, CACHEPAGE_BITMASK_WORDS) ) {
+        int combined = 0;
+
+        if( cache_write_combine ) {
+          // Scattered small stores often dirty the page in a regular
+          // pattern (e.g. one element per array record).  If all of the
+          // dirty extents have the same length and a constant stride,
+          // write them back with one strided PUT instead of one PUT per
+          // extent.  Gap bytes are never transmitted, so this does not
+          // change which remote bytes are written.
+          uintptr_t first_skip = 0;
+          uintptr_t run_len = 0;
+          uintptr_t run_stride = 0;
+          uintptr_t prev_skip = 0;
+          uintptr_t nruns = 0;
+          int uniform = 1;
+
+          start = 0;
+          while( get_skip_len_for_valids(dirty_bits, start, &got_skip, &got_len, CACHEPAGE_BITMASK_WORDS) ) {
+            if( nruns == 0 ) {
+              first_skip = got_skip;
+              run_len = got_len;
+            } else {
+              if( got_len != run_len ) { uniform = 0; break; }
+              if( nruns == 1 ) run_stride = got_skip - prev_skip;
+              else if( got_skip - prev_skip != run_stride ) { uniform = 0; break; }
+            }
+            prev_skip = got_skip;
+            nruns++;
+            start = got_skip + got_len;
+          }
+
+          if( uniform && nruns > 1 ) {
+            size_t strides = run_stride;
+            size_t count[2] = { run_len, nruns };
+
+            DEBUG_PRINT(("chpl_comm_put_strd(%p, %i, %p, runs %i of %i by %i)\n",
+                   page+first_skip, entry->base.node,
+                   (void*) (entry->base.raddr+first_skip),
+                   (int) nruns, (int) run_len, (int) run_stride));
+
+            // Note: chpl_comm_put_strd can yield; it completes before
+            // returning, so there is no handle to record as pending.
+            chpl_comm_put_strd((void*)(entry->base.raddr+first_skip),
+                               &strides,
+                               entry->base.node,
+                               page+first_skip,
+                               &strides,
+                               count,
+                               1 /*stridelevels*/, 1 /*elemSize*/,
+                               CHPL_COMM_UNKNOWN_ID, -1, 0);
+            combined = 1;
+          }
+        }
+
         start = 0;
-        while( get_skip_len_for_valids(dirty_bits, start, &got_skip, &got_len, CACHEPAGE_BITMASK_WORDS) ) {
+        while( !combined &&
+               get_skip_len_for_valids(dirty_bits, start, &got_skip, &got_len, CACHEPAGE_BITMASK_WORDS) ) {
 
           start = got_skip;
           // Start a put for len bytes starting at page + start
@@ -2094,6 +2416,12 @@ void flush_entry(struct rdcache_s* cache,
     // wait for it now (since we don't know which region it corresponded to).
     wait_for(cache, entry->max_put_sequence_number);
 
+    // Any of this task's PUTs to the page are now remotely visible, so
+    // shared-tier data fetched before that must no longer be accepted.
+    if( entry->max_put_sequence_number != NO_SEQUENCE_NUMBER ) {
+      shared_cache_advance_epoch(task_local);
+    }
+
     // If the previously valid cache lines overlap with the
     // request, we must wait for them now.
     if( any_valid_lines(entry->valid_lines, skip_lines, num_lines) ) {
@@ -2686,6 +3014,9 @@ void cache_get_trigger_readahead(struct rdcache_s* cache,
                              chpl_nodeID, (int)chpl_task_getId(),
                              (void*) (prefetch_start), (void*) (prefetch_end)));
 
+      cache->num_prefetches++;
+      cache->prefetch_bytes += prefetch_end - prefetch_start;
+
       cache_get(cache, task_local,
                 /* addr */ NULL /* means prefetch */,
                 node, prefetch_start, prefetch_end - prefetch_start,
@@ -2700,6 +3031,8 @@ void cache_get_trigger_readahead(struct rdcache_s* cache,
       //  the tree structure indicating that when that entry is loaded,
       //  it should be prefetched...
 
+      cache->num_prefetches_blocked++;
+
       if( len < 0 )
         miss_addr = prefetch_start + CACHELINE_SIZE;
       else
@@ -2817,8 +3150,10 @@ int cache_get_in_page(struct rdcache_s* cache,
   cache_seqn_t sn = NO_SEQUENCE_NUMBER;
   int isprefetch;
   int entry_after_acquire;
-  chpl_comm_nb_handle_t handle;
+  chpl_comm_nb_handle_t handle = NULL;
   uintptr_t readahead_len, readahead_skip;
+  int shared_hit;
+  uint64_t shared_fill_epoch;
 
   isprefetch = (addr == NULL);
 
@@ -2844,6 +3179,13 @@ int cache_get_in_page(struct rdcache_s* cache,
   ra_line_end = round_down_to_mask(raddr+size-1, CACHELINE_MASK) +
                 CACHELINE_SIZE;
 
+  // For a far peer, amortize the round-trip: fetch the whole page.
+  if (cache_latency_tiers &&
+      peer_tier(node, raddr) == PEER_TIER_FAR) {
+    ra_line = ra_page;
+    ra_line_end = ra_page + CACHEPAGE_SIZE;
+  }
+
   // Try to find this page data in the cache.
   // We will need from ra_line to ra_line_end.
 
@@ -2988,25 +3330,42 @@ int cache_get_in_page(struct rdcache_s* cache,
                (int) chpl_nodeID, page+(ra_line-ra_page), node, (void*) ra_line,
                (int) (ra_line_end - ra_line)));
 
-  // Note: chpl_comm_get_nb could cause a different task body to run.
-  // That should be OK because we marked entry as "reserved".
-  handle = chpl_comm_get_nb(entry->page + (ra_line-ra_page), /*local addr*/
-                            node, (void*) ra_line,
-                            ra_line_end - ra_line /*size*/,
-                            commID, ln, fn);
-  if (EXTRA_YIELDS) {
-    TRACE_YIELD_PRINT(("%d: task %d cache %p yielding in cache_get_in_page "
-                       "for chpl_comm_get_nb\n",
-                       chpl_nodeID, (int) chpl_task_getId(), cache));
+  // First, see if another thread on this node already fetched all of
+  // these lines into the shared cache tier.
+  shared_hit = 0;
+  shared_fill_epoch = 0;
+  if (shared_cache_enabled() && !isprefetch) {
+    shared_hit = shared_cache_lookup(task_local, node, ra_line, ra_line_end,
+                                     entry->page + (ra_line-ra_page));
+    if (!shared_hit) {
+      // Read the epoch before the GET is issued, so that publishing the
+      // fetched lines can't mask anything that becomes remotely visible
+      // while the GET is in flight.
+      shared_fill_epoch = shared_cache_epoch_now();
+    }
+  }
 
-    chpl_task_yield();
+  if (!shared_hit) {
+    // Note: chpl_comm_get_nb could cause a different task body to run.
+    // That should be OK because we marked entry as "reserved".
+    handle = chpl_comm_get_nb(entry->page + (ra_line-ra_page), /*local addr*/
+                              node, (void*) ra_line,
+                              ra_line_end - ra_line /*size*/,
+                              commID, ln, fn);
+    if (EXTRA_YIELDS) {
+      TRACE_YIELD_PRINT(("%d: task %d cache %p yielding in cache_get_in_page "
+                         "for chpl_comm_get_nb\n",
+                         chpl_nodeID, (int) chpl_task_getId(), cache));
 
-    TRACE_YIELD_PRINT(("%d: task %d cache %p back in cache_get_in_page\n",
-                       chpl_nodeID, (int) chpl_task_getId(), cache));
+      chpl_task_yield();
+
+      TRACE_YIELD_PRINT(("%d: task %d cache %p back in cache_get_in_page\n",
+                         chpl_nodeID, (int) chpl_task_getId(), cache));
+    }
+    // note: chpl_comm_get_nb can yield, but entry is locked
+    assert(entry->page && entry->entryReservedByTask == task_local);
+    assert(entry->base.raddr == ra_page && entry->base.node == node);
   }
-  // note: chpl_comm_get_nb can yield, but entry is locked
-  assert(entry->page && entry->entryReservedByTask == task_local);
-  assert(entry->base.raddr == ra_page && entry->base.node == node);
 
   // Set the valid lines
   set_valid_lines(entry->valid_lines,
@@ -3085,21 +3444,30 @@ int cache_get_in_page(struct rdcache_s* cache,
     // If we're not prefetching... wait for the get to complete and copy it
     // back out of the cache.
 
-    chpl_comm_wait_nb_some(&handle, 1);
-    if (EXTRA_YIELDS) {
-      TRACE_YIELD_PRINT(("%d: task %d cache %p yielding in cache_get_in_page "
-                         "for chpl_comm_wait_nb_some\n",
-                         chpl_nodeID, (int) chpl_task_getId(), cache));
+    if (!shared_hit) {
+      chpl_comm_wait_nb_some(&handle, 1);
+      if (EXTRA_YIELDS) {
+        TRACE_YIELD_PRINT(("%d: task %d cache %p yielding in cache_get_in_page "
+                           "for chpl_comm_wait_nb_some\n",
+                           chpl_nodeID, (int) chpl_task_getId(), cache));
 
-      chpl_task_yield();
+        chpl_task_yield();
 
-      TRACE_YIELD_PRINT(("%d: task %d cache %p back in cache_get_in_page\n",
-                         chpl_nodeID, (int) chpl_task_getId(), cache));
-    }
+        TRACE_YIELD_PRINT(("%d: task %d cache %p back in cache_get_in_page\n",
+                           chpl_nodeID, (int) chpl_task_getId(), cache));
+      }
 
-    // note: chpl_comm_wait_nb_some can yield, but entry is locked
-    assert(entry->page && entry->entryReservedByTask == task_local);
-    assert(entry->base.raddr == ra_page && entry->base.node == node);
+      // note: chpl_comm_wait_nb_some can yield, but entry is locked
+      assert(entry->page && entry->entryReservedByTask == task_local);
+      assert(entry->base.raddr == ra_page && entry->base.node == node);
+
+      // Share the fetched lines with the other threads on this node.
+      if (shared_cache_enabled()) {
+        shared_cache_publish(node, ra_line, ra_line_end,
+                             entry->page + (ra_line-ra_page),
+                             shared_fill_epoch);
+      }
+    }
 
     // Then, copy it out.
     chpl_memcpy(addr, entry->page + (raddr-ra_page), size);
@@ -3203,6 +3571,9 @@ int cache_get(struct rdcache_s* cache,
                             commID, ln, fn);
 
     all_hits = all_hits && hit;
+
+    if( !hit && !isprefetch )
+      chpl_pagemigrate_note_remote(node, ra_page);
   }
 
   if( VERIFY ) validate_cache(cache, task_local);
@@ -3620,6 +3991,42 @@ void chpl_cache_init(void) {
     return;
   }
 
+  cache_write_combine =
+    chpl_env_rt_get_bool("CACHE_REMOTE_WRITE_COMBINE", false);
+  cache_max_dirty_pages =
+    (int) chpl_env_rt_get_uint("CACHE_REMOTE_MAX_DIRTY_PAGES", 0);
+
+  cache_adaptive =
+    chpl_env_rt_get_bool("CACHE_REMOTE_ADAPTIVE", false);
+  if (cache_adaptive) {
+    cache_adaptive_window =
+      chpl_env_rt_get_uint("CACHE_REMOTE_ADAPTIVE_WINDOW", 4096);
+    cache_adaptive_hi_pct =
+      chpl_env_rt_get_uint("CACHE_REMOTE_ADAPTIVE_HI_PCT", 75);
+    cache_adaptive_lo_pct =
+      chpl_env_rt_get_uint("CACHE_REMOTE_ADAPTIVE_LO_PCT", 50);
+    if (cache_adaptive_window == 0 ||
+        cache_adaptive_hi_pct > 100 ||
+        cache_adaptive_lo_pct > cache_adaptive_hi_pct) {
+      chpl_warning("Ignoring invalid CHPL_RT_CACHE_REMOTE_ADAPTIVE settings",
+                   0, 0);
+      cache_adaptive = false;
+    }
+  }
+
+  cache_latency_tiers =
+    chpl_env_rt_get_bool("CACHE_REMOTE_LATENCY_TIERS", false);
+  if (cache_latency_tiers) {
+    cache_far_latency_ns =
+      chpl_env_rt_get_uint("CACHE_REMOTE_FAR_NS", 2000);
+    peer_tiers = (int8_t*) chpl_calloc(chpl_numNodes,
+                                       sizeof(peer_tiers[0]));
+    memset(peer_tiers, PEER_TIER_UNKNOWN & 0xff,
+           chpl_numNodes * sizeof(peer_tiers[0]));
+  }
+
+  shared_cache_init();
+
   //printf("CACHE IS ENABLED\n");
   chpl_cache_do_init();
 }
@@ -3652,11 +4059,15 @@ void chpl_cache_fence(int acquire, int release, int ln, int32_t fn)
     if( acquire ) {
       task_local->last_acquire = cache->next_request_number;
       cache->next_request_number++;
+      shared_cache_advance_epoch(task_local);
     }
 
     if( release ) {
       cache_clean_dirty(cache, task_local);
       wait_all(cache);
+      // This task's PUTs are now remotely visible; make sure we don't
+      // accept shared-tier data fetched before they were.
+      shared_cache_advance_epoch(task_local);
     }
 #ifdef DUMP
     DEBUG_PRINT(("%d: task %d after fence\n", chpl_nodeID, (int) chpl_task_getId()));
@@ -3691,6 +4102,72 @@ int size_merits_direct_comm(const struct rdcache_s* cache, size_t size)
   return size >= CACHEPAGE_SIZE;
 }
 
+// Phase-adaptive caching: count this GET or PUT against the current
+// observation window and, when the window fills, decide with hysteresis
+// whether subsequent operations should bypass the cache. Only updates
+// this pthread's counters, so no synchronization is needed.
+static inline
+void adapt_note_op(struct rdcache_s* cache, int is_put)
+{
+  uint64_t total;
+
+  if (is_put) cache->adapt_puts++;
+  else cache->adapt_gets++;
+
+  total = cache->adapt_gets + cache->adapt_puts;
+  if (total >= cache_adaptive_window) {
+    uint64_t put_pct = 100 * cache->adapt_puts / total;
+    if (cache->adapt_bypass) {
+      if (put_pct < cache_adaptive_lo_pct) cache->adapt_bypass = false;
+    } else {
+      if (put_pct >= cache_adaptive_hi_pct) cache->adapt_bypass = true;
+    }
+    cache->adapt_gets = 0;
+    cache->adapt_puts = 0;
+  }
+}
+
+// Should this GET or PUT bypass the cache because of the adaptive
+// policy? A task-pinned policy overrides the automatic decision and is
+// not counted against the window; pinned regions are transient and
+// should not distort the measured phase. Unlike
+// size_merits_direct_comm, this may modify the cache (the window
+// counters), but nothing a concurrent reader of the cache tables could
+// observe.
+static inline
+int adapt_merits_direct_comm(struct rdcache_s* cache,
+                             chpl_cache_taskPrvData_t* task_local,
+                             int is_put)
+{
+  if (task_local->policy_pin != chpl_cache_policy_auto)
+    return task_local->policy_pin == chpl_cache_policy_off;
+  if (!cache_adaptive)
+    return 0;
+  adapt_note_op(cache, is_put);
+  return cache->adapt_bypass;
+}
+
+void chpl_cache_policy_pin(int policy)
+{
+  if (chpl_cache_enabled()) {
+    chpl_cache_taskPrvData_t* task_local = task_private_cache_data();
+    task_local->policy_pin = (int8_t) policy;
+  }
+}
+
+int chpl_cache_policy_current(void)
+{
+  if (chpl_cache_enabled()) {
+    chpl_cache_taskPrvData_t* task_local = task_private_cache_data();
+    if (task_local->policy_pin != chpl_cache_policy_auto)
+      return task_local->policy_pin;
+    if (cache_adaptive && tls_cache_remote_data()->adapt_bypass)
+      return chpl_cache_policy_off;
+    return chpl_cache_policy_on;
+  }
+  return chpl_cache_policy_off;
+}
+
 void chpl_cache_comm_put(void* addr, c_nodeid_t node, void* raddr,
                          size_t size, int32_t commID, int ln, int32_t fn)
 {
@@ -3698,9 +4175,13 @@ void chpl_cache_comm_put(void* addr, c_nodeid_t node, void* raddr,
   chpl_cache_taskPrvData_t* task_local = task_private_cache_data();
   int all_hits;
 
-  if (size_merits_direct_comm(cache, size)) {
+  if (size_merits_direct_comm(cache, size) ||
+      adapt_merits_direct_comm(cache, task_local, 1)) {
     cache_invalidate(cache, task_local, node, (raddr_t)raddr, size);
     chpl_comm_put(addr, node, raddr, size, commID, ln, fn);
+    // The direct PUT is already remotely visible; don't accept
+    // shared-tier data fetched before it.
+    shared_cache_advance_epoch(task_local);
     if (EXTRA_YIELDS) {
       TRACE_YIELD_PRINT(("%d: task %d cache %p yielding for chpl_comm_put\n",
                          chpl_nodeID, (int) chpl_task_getId(), cache));
@@ -3744,7 +4225,8 @@ void chpl_cache_comm_get(void *addr, c_nodeid_t node, void* raddr,
   chpl_cache_taskPrvData_t* task_local = task_private_cache_data();
   int all_hits;
 
-  if (size_merits_direct_comm(cache, size)) {
+  if (size_merits_direct_comm(cache, size) ||
+      adapt_merits_direct_comm(cache, task_local, 0)) {
     cache_invalidate(cache, task_local, node, (raddr_t)raddr, size);
     chpl_comm_get(addr, node, raddr, size, commID, ln, fn);
     if (EXTRA_YIELDS) {
@@ -3905,6 +4387,9 @@ void chpl_cache_comm_put_strd(void *addr, void *dststr, c_nodeid_t node,
   // do the strided put.
   chpl_comm_put_strd(addr, dststr, node, raddr, srcstr, count, strlevels,
                      elemSize, commID, ln, fn);
+  // The direct PUT is already remotely visible; don't accept shared-tier
+  // data fetched before it.
+  shared_cache_advance_epoch(task_private_cache_data());
   if (EXTRA_YIELDS) {
 #ifdef TRACE_YIELDS
     struct rdcache_s* cache = tls_cache_remote_data();
@@ -4060,14 +4545,18 @@ void chpl_cache_print_stats(void) {
          "ain=%i/%i "
          "aout=%i/%i am=%i "
          "table=(%i lists/%i full/%i used/%i slots and %i/%i sub-slots) "
-         "entries=%i/%i\n",
+         "entries=%i/%i "
+         "readahead=(%" PRIu64 " prefetches/%" PRIu64 " bytes/"
+         "%" PRIu64 " blocked)\n",
          chpl_nodeID, (int) chpl_task_getId(),
          cache->ain_current, cache->ain_max,
          cache->aout_current, cache->aout_max,
          cache->am_current,
          n_colliding_slots, n_full_slots, n_used_slots, table_slots,
          n_full_subslots, n_subslots,
-         n_bottom_entries, cache->max_entries);
+         n_bottom_entries, cache->max_entries,
+         cache->num_prefetches, cache->prefetch_bytes,
+         cache->num_prefetches_blocked);
 }
 
 // Returns 1 if the data was already cached
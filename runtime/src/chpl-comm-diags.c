@@ -28,12 +28,16 @@
 #include "chpl-comm.h"
 #include "chpl-comm-diags.h"
 #include "chpl-comm-internal.h"
+#include "chpl-env.h"
+#include "chpl-linefile-support.h"
+#include "chpl-mem.h"
 #include "chpl-mem-consistency.h"
 #include "error.h"
 
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 int chpl_verbose_comm = 0;
 int chpl_verbose_comm_stacktrace = 0;
@@ -45,6 +49,202 @@ chpl_atomic_commDiagnostics chpl_comm_diags_counters;
 
 static pthread_once_t bcastPrintUnstable_once = PTHREAD_ONCE_INIT;
 
+//
+// Comm heatmap instrumentation.
+//
+// When enabled (CHPL_RT_COMM_HEATMAP), every remote op that goes through
+// the chpl_comm_diags_verbose_rdma*() macros is also aggregated into a
+// table keyed by (remote node, callsite, op class), with a count, total
+// bytes, and a log2 size histogram per entry.  Each node dumps its table
+// as a binary trace at exit, so the per-(source,dest) traffic matrix and
+// the callsites responsible for it can be reconstructed offline.
+//
+
+int chpl_comm_heatmap = 0;
+
+#define HM_NUM_BUCKETS 16     // log2 size histogram buckets; last is >= 32k
+#define HM_TABLE_SIZE 4096    // must be a power of 2
+
+typedef struct {
+  atomic_int_least16_t state;  // 0: free, 2: claimed and ready
+  uint8_t op;                  // 0: get, 1: put, 2: other
+  int32_t node;                // remote node
+  int32_t ln;                  // callsite line number
+  int32_t fn;                  // callsite filename index
+  atomic_uint_least64_t count;
+  atomic_uint_least64_t bytes;
+  atomic_uint_least64_t sizeHist[HM_NUM_BUCKETS];
+} hm_entry_t;
+
+static hm_entry_t* hm_table = NULL;
+static atomic_uint_least64_t hm_dropped;
+static pthread_mutex_t hm_claim_lock = PTHREAD_MUTEX_INITIALIZER;
+
+#define HM_MAGIC "CHPLHEAT"
+#define HM_VERSION 1
+
+static
+void hm_dump(void) {
+  const char* prefix;
+  char fname[1024];
+  FILE* f;
+  uint32_t word;
+  uint64_t dropped;
+  int i, b;
+
+  if (!chpl_comm_heatmap || hm_table == NULL)
+    return;
+
+  prefix = chpl_env_rt_get("COMM_HEATMAP_FILE", "chpl_comm_heatmap");
+  snprintf(fname, sizeof(fname), "%s.%d.bin", prefix, (int) chpl_nodeID);
+
+  if ((f = fopen(fname, "wb")) == NULL) {
+    chpl_warning("cannot create comm heatmap file", 0, 0);
+    return;
+  }
+
+  fwrite(HM_MAGIC, 1, 8, f);
+  word = HM_VERSION;           fwrite(&word, sizeof(word), 1, f);
+  word = (uint32_t) chpl_nodeID; fwrite(&word, sizeof(word), 1, f);
+  word = (uint32_t) chpl_numNodes; fwrite(&word, sizeof(word), 1, f);
+  word = HM_NUM_BUCKETS;       fwrite(&word, sizeof(word), 1, f);
+  dropped = atomic_load_uint_least64_t(&hm_dropped);
+  fwrite(&dropped, sizeof(dropped), 1, f);
+
+  for (i = 0; i < HM_TABLE_SIZE; i++) {
+    hm_entry_t* e = &hm_table[i];
+    uint32_t op;
+    int32_t node, ln;
+    const char* file;
+    uint32_t fileLen;
+    uint64_t val;
+
+    if (atomic_load_int_least16_t(&e->state) != 2)
+      continue;
+
+    op = e->op;            fwrite(&op, sizeof(op), 1, f);
+    node = e->node;        fwrite(&node, sizeof(node), 1, f);
+    ln = e->ln;            fwrite(&ln, sizeof(ln), 1, f);
+
+    file = chpl_lookupFilename(e->fn);
+    if (file == NULL)
+      file = "<unknown>";
+    fileLen = (uint32_t) strlen(file);
+    fwrite(&fileLen, sizeof(fileLen), 1, f);
+    fwrite(file, 1, fileLen, f);
+
+    val = atomic_load_uint_least64_t(&e->count); fwrite(&val, sizeof(val), 1, f);
+    val = atomic_load_uint_least64_t(&e->bytes); fwrite(&val, sizeof(val), 1, f);
+    for (b = 0; b < HM_NUM_BUCKETS; b++) {
+      val = atomic_load_uint_least64_t(&e->sizeHist[b]);
+      fwrite(&val, sizeof(val), 1, f);
+    }
+  }
+
+  fclose(f);
+}
+
+void chpl_comm_diags_heatmap_init(void) {
+  int i;
+
+  if (!chpl_env_rt_flag(CHPL_ENV_RT_COMM_HEATMAP))
+    return;
+
+  hm_table = chpl_mem_allocManyZero(HM_TABLE_SIZE, sizeof(hm_entry_t),
+                                    CHPL_RT_MD_COMM_UTIL, 0, 0);
+  for (i = 0; i < HM_TABLE_SIZE; i++) {
+    int b;
+    atomic_init_int_least16_t(&hm_table[i].state, 0);
+    atomic_init_uint_least64_t(&hm_table[i].count, 0);
+    atomic_init_uint_least64_t(&hm_table[i].bytes, 0);
+    for (b = 0; b < HM_NUM_BUCKETS; b++)
+      atomic_init_uint_least64_t(&hm_table[i].sizeHist[b], 0);
+  }
+  atomic_init_uint_least64_t(&hm_dropped, 0);
+
+  if (atexit(hm_dump) != 0)
+    chpl_warning("cannot register comm heatmap dump", 0, 0);
+
+  chpl_comm_heatmap = 1;
+}
+
+static inline
+int hm_size_bucket(size_t size) {
+  int b = 0;
+  while (size > 1 && b < HM_NUM_BUCKETS - 1) {
+    size >>= 1;
+    b++;
+  }
+  return b;
+}
+
+void chpl_comm_diags_heatmap_record(const char* op, int32_t node,
+                                    size_t size, int32_t ln, int32_t fn) {
+  uint8_t opClass;
+  uint32_t h;
+  int i, probes;
+
+  if (strstr(op, "get") != NULL || strcmp(op, "prefetch") == 0)
+    opClass = 0;
+  else if (strstr(op, "put") != NULL)
+    opClass = 1;
+  else
+    opClass = 2;
+
+  h = (uint32_t) ln;
+  h = h * 31 + (uint32_t) fn;
+  h = h * 31 + (uint32_t) node;
+  h = h * 31 + opClass;
+  i = h & (HM_TABLE_SIZE - 1);
+
+  for (probes = 0; probes < HM_TABLE_SIZE; probes++) {
+    hm_entry_t* e = &hm_table[i];
+    int_least16_t state = atomic_load_int_least16_t(&e->state);
+
+    if (state == 2
+        && e->op == opClass && e->node == node
+        && e->ln == ln && e->fn == fn) {
+      break;
+    }
+
+    if (state != 2) {
+      // Probably free; claim it under the lock, where we can re-check.
+      pthread_mutex_lock(&hm_claim_lock);
+      state = atomic_load_int_least16_t(&e->state);
+      if (state == 0) {
+        e->op = opClass;
+        e->node = node;
+        e->ln = ln;
+        e->fn = fn;
+        atomic_store_int_least16_t(&e->state, 2);
+        pthread_mutex_unlock(&hm_claim_lock);
+        break;
+      }
+      pthread_mutex_unlock(&hm_claim_lock);
+      // Someone else claimed it; re-examine this slot from the top.
+      probes--;
+      continue;
+    }
+
+    i = (i + 1) & (HM_TABLE_SIZE - 1);
+  }
+
+  if (probes >= HM_TABLE_SIZE) {
+    // Table is full of other callsites; we can only count the loss.
+    (void) atomic_fetch_add_explicit_uint_least64_t(&hm_dropped, 1,
+                                                    memory_order_relaxed);
+    return;
+  }
+
+  (void) atomic_fetch_add_explicit_uint_least64_t(&hm_table[i].count, 1,
+                                                  memory_order_relaxed);
+  (void) atomic_fetch_add_explicit_uint_least64_t(&hm_table[i].bytes, size,
+                                                  memory_order_relaxed);
+  (void) atomic_fetch_add_explicit_uint_least64_t(
+             &hm_table[i].sizeHist[hm_size_bucket(size)], 1,
+             memory_order_relaxed);
+}
+
 
 static
 void broadcast_print_unstable(void) {
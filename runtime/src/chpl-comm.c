@@ -31,14 +31,18 @@
 #include "chpl-comm-internal.h"
 #include "chpl-env.h"
 #include "chpl-mem.h"
+#include "chpl-tasks.h"
 #include "chpl-topo.h"
 
 // Don't get warning macros for chpl_comm_get etc.
 #include "chpl-comm-no-warning-macros.h"
 
+#include <inttypes.h>
 #include <pthread.h>
 #include <stdint.h>
+#include <stdio.h>
 #include <string.h>
+#include <time.h>
 #include <unistd.h>
 
 int32_t          chpl_nodeID = -1;
@@ -55,7 +59,119 @@ void chpl_comm_register_global_var(int i, wide_ptr_t *ptr_to_wide_ptr) {
 }
 
 
+//
+// Tree distribution of the packed global-variable buffer.  With the
+// flat scheme every node GETs the buffer from node 0, so node 0
+// serves numNodes-1 transfers at startup.  Here the nodes form a
+// binomial tree: each node GETs the buffer from its tree parent,
+// scatters it into its own globals, republishes its local copy, and
+// serves only its ~log(numNodes) children.  A parent announces that
+// its copy is ready by PUTting the buffer's address and then an epoch
+// flag into the child's info record; both PUTs are blocking, so
+// per-sender ordering guarantees the address arrives before the flag.
+// Children ack (an epoch PUT back into the parent's per-child slot)
+// so the parent knows when it can free its buffer.
+//
+#define COMM_GLOB_BCAST_MAX_ROUNDS 32
+
+typedef struct {
+  volatile uint64_t epoch;    // parent's copy is ready
+  uint64_t srcBuf;            // parent-local address of that copy
+  volatile uint64_t acks[COMM_GLOB_BCAST_MAX_ROUNDS];
+} globBcastInfo_t;
+
+// statics, so at the same address in every node's image
+static globBcastInfo_t globBcastInfo;
+static uint64_t globBcastEpoch;
+
+static void broadcastGlobalVarsTree(void) {
+  const uint64_t epoch = ++globBcastEpoch;
+  const size_t size = chpl_numGlobalsOnHeap * sizeof(wide_ptr_t);
+  wide_ptr_t* buf;
+  int i;
+
+  buf = (wide_ptr_t*)
+        chpl_mem_alloc(size, CHPL_RT_MD_COMM_PER_LOC_INFO, 0, 0);
+
+  if (chpl_nodeID == 0) {
+    for (i = 0; i < chpl_numGlobalsOnHeap; i++) {
+      buf[i] = *chpl_globals_registry[i];
+    }
+  } else {
+    while (globBcastInfo.epoch < epoch)
+      chpl_task_yield();
+
+    // figure out our parent: clear our highest set bit
+    c_nodeid_t parent = chpl_nodeID;
+    int myBit = 0;
+    while ((parent >> (myBit + 1)) != 0)
+      myBit++;
+    parent &= ~((c_nodeid_t) 1 << myBit);
+
+    chpl_comm_get(buf, parent,
+                  (void*) (uintptr_t) globBcastInfo.srcBuf, size,
+                  CHPL_COMM_UNKNOWN_ID, 0, -1);
+    for (i = 0; i < chpl_numGlobalsOnHeap; i++) {
+      *chpl_globals_registry[i] = buf[i];
+    }
+
+    // let the parent reclaim its copy
+    chpl_comm_put((void*) &epoch, parent,
+                  (void*) &globBcastInfo.acks[myBit], sizeof(epoch),
+                  CHPL_COMM_UNKNOWN_ID, 0, -1);
+  }
+
+  // forward to our children: nodeID + 2^k for each 2^k > nodeID
+  uint64_t srcBuf = (uint64_t) (uintptr_t) buf;
+  int numKids = 0;
+  for (int k = 0; k < COMM_GLOB_BCAST_MAX_ROUNDS; k++) {
+    c_nodeid_t bit = (c_nodeid_t) 1 << k;
+    if (bit <= chpl_nodeID && chpl_nodeID != 0)
+      continue;
+    c_nodeid_t child = chpl_nodeID + bit;
+    if (child >= chpl_numNodes)
+      break;
+    chpl_comm_put(&srcBuf, child,
+                  (void*) &globBcastInfo.srcBuf, sizeof(srcBuf),
+                  CHPL_COMM_UNKNOWN_ID, 0, -1);
+    chpl_comm_put((void*) &epoch, child,
+                  (void*) &globBcastInfo.epoch, sizeof(epoch),
+                  CHPL_COMM_UNKNOWN_ID, 0, -1);
+    numKids++;
+  }
+
+  // wait until every child has pulled the buffer
+  for (int k = 0, seen = 0; seen < numKids; k++) {
+    c_nodeid_t bit = (c_nodeid_t) 1 << k;
+    if (bit <= chpl_nodeID && chpl_nodeID != 0)
+      continue;
+    if (chpl_nodeID + bit >= chpl_numNodes)
+      break;
+    while (globBcastInfo.acks[k] < epoch)
+      chpl_task_yield();
+    seen++;
+  }
+
+  chpl_mem_free(buf, 0, 0);
+
+  // Nothing may run Chapel code until every node has its globals.
+  chpl_comm_barrier("broadcast global vars");
+}
+
 void chpl_comm_broadcast_global_vars(int numGlobals) {
+  static chpl_bool treeInited = false;
+  static chpl_bool useTree;
+
+  if (!treeInited) {
+    useTree = chpl_env_rt_get_bool("COMM_TREE_GLOBAL_BCAST", true);
+    treeInited = true;
+  }
+
+  if (chpl_numNodes > 1 && useTree) {
+    broadcastGlobalVarsTree();
+    return;
+  }
+
   //
   // On node 0: gather up the global variables' wide pointers into a
   //            buffer; return that buffer if it needs deallocating
@@ -202,10 +318,26 @@ static void *touch_thread(void *mem_region) {
 // be faulted in serially at NIC registration time, which is slow and leads to
 // poor NUMA affinity with memory split evenly in massive chunks across NUMA
 // domains.
+chpl_bool chpl_comm_regMemHeapLazyTouch(void) {
+  static chpl_bool inited = false;
+  static chpl_bool lazy;
+  if (!inited) {
+    // idempotent, so racing first calls are harmless
+    lazy = chpl_env_rt_get_bool("LAZY_HEAP_TOUCH", false);
+    inited = true;
+  }
+  return lazy;
+}
+
 void chpl_comm_regMemHeapTouch(void* start, uintptr_t size) {
   int nthreads = chpl_topo_getNumCPUsPhysical(true);
   pthread_t thread_id[nthreads];
   memory_region mem_regions[nthreads];
+  chpl_bool report = chpl_env_rt_get_bool("HEAP_TOUCH_REPORT", false);
+  struct timespec ts_start, ts_end;
+
+  if (report)
+    clock_gettime(CLOCK_MONOTONIC, &ts_start);
 
   for (int tid=0; tid<nthreads; tid++) {
     mem_regions[tid].start = start;
@@ -218,6 +350,19 @@ void chpl_comm_regMemHeapTouch(void* start, uintptr_t size) {
   for (int tid=0; tid<nthreads; tid++) {
     pthread_join(thread_id[tid], NULL);
   }
+
+  if (report) {
+    clock_gettime(CLOCK_MONOTONIC, &ts_end);
+    double secs = (ts_end.tv_sec - ts_start.tv_sec)
+                  + 1e-9 * (ts_end.tv_nsec - ts_start.tv_nsec);
+    uintptr_t page_size = chpl_comm_regMemHeapPageSize();
+    fprintf(stderr,
+            "%d: heap fault-in: %" PRIuPTR " bytes on %" PRIuPTR "-byte pages"
+            " (~%" PRIuPTR " pages), %d threads, %.3f sec (%.2f GiB/s)\n",
+            (int) chpl_nodeID, size, page_size,
+            (size + page_size - 1) / page_size, nthreads, secs,
+            (secs > 0.0) ? (double) size / (secs * (1 << 30)) : 0.0);
+  }
 }
 
 void* chpl_get_global_serialize_table(int64_t idx) {
@@ -269,3 +414,383 @@ chpl_bool chpl_get_oversubscribed(void) {
   }
   return oversubscribed;
 }
+
+
+//
+// Latency-hiding GET: issue the transfer nonblocking and yield to the
+// tasking layer until it completes, so that other tasks can run (and
+// keep the network busy) during the round trip.  The handle machinery
+// is the comm layer's; this works the same for all of them.
+//
+void chpl_comm_get_yielding(void *addr, c_nodeid_t node, void* raddr,
+                            size_t size, int32_t commID, int ln, int32_t fn) {
+  chpl_comm_nb_handle_t h;
+
+  h = chpl_comm_get_nb(addr, node, raddr, size, commID, ln, fn);
+  if (h == NULL)
+    return;
+
+  while (!chpl_comm_test_nb_complete(h)) {
+    chpl_task_yield();
+    (void) chpl_comm_try_nb_some(&h, 1);
+  }
+}
+
+
+//
+// Pipelined GET for large transfers: issue the range as chunked
+// nonblocking gets with a bounded number in flight, so chunks overlap
+// on the wire instead of completing one round trip at a time.
+//
+#define COMM_PIPELINE_MAX_DEPTH 16
+
+static size_t pipelineChunkSize = 0;
+static size_t pipelineDepth = 0;
+
+void chpl_comm_get_pipelined(void *addr, c_nodeid_t node, void* raddr,
+                             size_t size, int32_t commID, int ln, int32_t fn) {
+  chpl_comm_nb_handle_t h[COMM_PIPELINE_MAX_DEPTH];
+  size_t offset = 0;
+  size_t inFlight = 0;
+
+  if (pipelineChunkSize == 0) {
+    // Racing first calls read the same env values; this is idempotent.
+    pipelineChunkSize = (size_t)
+      chpl_env_rt_get_int("COMM_PIPELINE_CHUNK_SIZE", 1 << 20);
+    if (pipelineChunkSize < 1)
+      pipelineChunkSize = 1 << 20;
+
+    pipelineDepth = (size_t) chpl_env_rt_get_int("COMM_PIPELINE_DEPTH", 4);
+    if (pipelineDepth < 1)
+      pipelineDepth = 1;
+    if (pipelineDepth > COMM_PIPELINE_MAX_DEPTH)
+      pipelineDepth = COMM_PIPELINE_MAX_DEPTH;
+  }
+
+  // Transfers of at most one chunk gain nothing from pipelining.
+  if (size <= pipelineChunkSize) {
+    chpl_comm_get(addr, node, raddr, size, commID, ln, fn);
+    return;
+  }
+
+  while (offset < size || inFlight > 0) {
+    if (offset < size && inFlight < pipelineDepth) {
+      size_t chunk = size - offset;
+      chpl_comm_nb_handle_t hNew;
+
+      if (chunk > pipelineChunkSize)
+        chunk = pipelineChunkSize;
+
+      hNew = chpl_comm_get_nb((char*) addr + offset, node,
+                              (char*) raddr + offset, chunk,
+                              commID, ln, fn);
+      offset += chunk;
+
+      if (hNew != NULL)
+        h[inFlight++] = hNew;
+    } else {
+      size_t kept = 0;
+
+      chpl_comm_wait_nb_some(h, inFlight);
+
+      for (size_t i = 0; i < inFlight; i++) {
+        if (!chpl_comm_test_nb_complete(h[i]))
+          h[kept++] = h[i];
+      }
+
+      inFlight = kept;
+    }
+  }
+}
+
+
+//
+// All-to-all exchange.
+//
+// Each node publishes its send-side buffer and layout in a static
+// struct -- statics are at the same address in every node image, the
+// same assumption the private-broadcast tables rely on -- and then
+// pulls its own segment from every peer.  Pulling lets the receiver
+// pace the exchange: peers are visited in the staggered order
+// (me+1, me+2, ...), so at any moment each node is reading from a
+// different peer and no node is the target of everyone at once, which
+// is exactly the incast that the naive put-to-all loops suffer from.
+//
+// Small segments go through the unordered-GET path so the comm layer
+// can batch them; large ones through the pipelined path so their
+// chunks overlap on the wire.
+//
+typedef struct {
+  void*   src;
+  size_t* sendCounts;
+  size_t* sendDispls;
+} alltoallvInfo_t;
+
+static alltoallvInfo_t alltoallvInfo;
+
+#define COMM_ALLTOALLV_UNORDERED_MAX_DFLT 4096
+
+void chpl_comm_alltoallv(void* recv, const size_t* recvCounts,
+                         const size_t* recvDispls,
+                         const void* send, const size_t* sendCounts,
+                         const size_t* sendDispls,
+                         int32_t commID, int ln, int32_t fn) {
+  static size_t unorderedMax = 0;
+
+  if (unorderedMax == 0) {
+    // Racing first calls read the same env value; this is idempotent.
+    size_t dflt = COMM_ALLTOALLV_UNORDERED_MAX_DFLT;
+    unorderedMax = (size_t)
+      chpl_env_rt_get_int("COMM_ALLTOALLV_UNORDERED_MAX", dflt);
+    if (unorderedMax < 1)
+      unorderedMax = 1;
+  }
+
+  // The local segment doesn't touch the network at all.
+  memmove((char*) recv + recvDispls[chpl_nodeID],
+          (const char*) send + sendDispls[chpl_nodeID],
+          sendCounts[chpl_nodeID]);
+
+  if (chpl_numNodes == 1)
+    return;
+
+  // Publish our send side, and wait until all peers have published.
+  alltoallvInfo.src = (void*) send;
+  alltoallvInfo.sendCounts = (size_t*) sendCounts;
+  alltoallvInfo.sendDispls = (size_t*) sendDispls;
+  chpl_comm_barrier("alltoallv publish");
+
+  for (int32_t phase = 1; phase < chpl_numNodes; phase++) {
+    c_nodeid_t peer = (c_nodeid_t) ((chpl_nodeID + phase) % chpl_numNodes);
+    alltoallvInfo_t peerInfo;
+    size_t cnt;
+    size_t disp;
+
+    chpl_comm_get(&peerInfo, peer, &alltoallvInfo, sizeof(peerInfo),
+                  commID, ln, fn);
+    chpl_comm_get(&cnt, peer, &peerInfo.sendCounts[chpl_nodeID],
+                  sizeof(cnt), commID, ln, fn);
+
+    if (cnt != recvCounts[peer])
+      chpl_internal_error_v("alltoallv: node %d sends %zu bytes to node %d, "
+                            "which expects %zu",
+                            (int) peer, cnt, (int) chpl_nodeID,
+                            recvCounts[peer]);
+
+    if (cnt == 0)
+      continue;
+
+    chpl_comm_get(&disp, peer, &peerInfo.sendDispls[chpl_nodeID],
+                  sizeof(disp), commID, ln, fn);
+
+    if (cnt <= unorderedMax) {
+      chpl_comm_get_unordered((char*) recv + recvDispls[peer], peer,
+                              (char*) peerInfo.src + disp, cnt,
+                              commID, ln, fn);
+    } else {
+      chpl_comm_get_pipelined((char*) recv + recvDispls[peer], peer,
+                              (char*) peerInfo.src + disp, cnt,
+                              commID, ln, fn);
+    }
+  }
+
+  chpl_comm_unordered_task_fence();
+
+  // Peers may still be reading our send buffer; don't return (and let
+  // the caller reuse it) until everyone is done.
+  chpl_comm_barrier("alltoallv drain");
+}
+
+
+//
+// Sum allreduce over a single small scalar.
+//
+// Dissemination pattern: in round r each node PUTs its partial sum to
+// node (me + 2^r) % numNodes and folds in the partial that arrives
+// from node (me - 2^r) % numNodes, so after ceil(log2(numNodes))
+// rounds every node holds the full sum.  Like alltoallv, this leans
+// on statics being at the same address in every node image.
+//
+// A monotonic epoch makes the ready flags reusable without clearing:
+// the round-r sender is always the same node, and its data PUT
+// completes remotely before its flag PUT does, so seeing a flag at or
+// beyond our epoch means our epoch's data has landed.  The payload
+// slots are double-buffered on epoch parity because a peer can run
+// one epoch ahead of us; it cannot run two ahead, since starting
+// epoch e+2 requires finishing e+1, which in turn requires every node
+// (us included) to have finished epoch e and consumed its slots.
+//
+#define COMM_ALLREDUCE_MAX_ROUNDS 32
+
+typedef union {
+  int64_t  i;
+  uint64_t u;
+  float    r32;
+  double   r64;
+} allreduceVal_t;
+
+typedef struct {
+  allreduceVal_t vals[2][COMM_ALLREDUCE_MAX_ROUNDS];
+  volatile uint64_t ready[COMM_ALLREDUCE_MAX_ROUNDS];
+} allreduceInfo_t;
+
+static allreduceInfo_t allreduceInfo;
+static uint64_t allreduceEpoch;
+
+void chpl_comm_allreduce_sum(void* valInOut, chpl_comm_redType_t dt,
+                             int32_t commID, int ln, int32_t fn) {
+  size_t sz = (dt == chpl_comm_red_real32) ? sizeof(float)
+                                           : sizeof(uint64_t);
+
+  if (chpl_numNodes == 1)
+    return;
+
+  allreduceVal_t acc;
+  memset(&acc, 0, sizeof(acc));
+  memcpy(&acc, valInOut, sz);
+
+  uint64_t epoch = ++allreduceEpoch;
+  const int par = (int) (epoch & 1);
+
+  for (int r = 0; (1 << r) < chpl_numNodes; r++) {
+    c_nodeid_t peer = (c_nodeid_t) ((chpl_nodeID + ((int64_t) 1 << r))
+                                    % chpl_numNodes);
+
+    chpl_comm_put(&acc, peer, &allreduceInfo.vals[par][r], sizeof(acc),
+                  commID, ln, fn);
+    chpl_comm_put(&epoch, peer, (void*) &allreduceInfo.ready[r],
+                  sizeof(epoch), commID, ln, fn);
+
+    while (allreduceInfo.ready[r] < epoch)
+      chpl_task_yield();
+
+    const allreduceVal_t* in = &allreduceInfo.vals[par][r];
+    switch (dt) {
+      case chpl_comm_red_int64:  acc.i   += in->i;   break;
+      case chpl_comm_red_uint64: acc.u   += in->u;   break;
+      case chpl_comm_red_real32: acc.r32 += in->r32; break;
+      case chpl_comm_red_real64: acc.r64 += in->r64; break;
+    }
+  }
+
+  memcpy(valInOut, &acc, sz);
+}
+
+
+//
+// Gather/scatter over arbitrary (node, address) pairs.
+//
+// Irregular indexing generates one comm call per element; done
+// directly, each is a full network round trip.  Here the requests are
+// grouped per target node with a stable counting sort, runs that are
+// contiguous on both sides are coalesced into one transfer, and
+// everything is issued through the unordered paths so the comm layer
+// can batch the many small operations that remain.  Grouping matters
+// for that batching: the unordered machinery merges operations with a
+// common target, so presenting each node's requests back to back is
+// what lets it build large wire messages.  (None of our comm layers
+// exposes a true vectored RDMA primitive; if one grows it, this is
+// the one place to call it.)
+//
+// The local node's elements never touch the network.  Both calls
+// return only after all data has landed, so the caller may read dst
+// or overwrite src immediately.
+//
+static size_t* gsOrder(const c_nodeid_t* nodes, size_t n) {
+  size_t* counts;
+  size_t* order;
+  size_t i;
+
+  counts = (size_t*) chpl_mem_allocManyZero(chpl_numNodes + 1,
+                                            sizeof(counts[0]),
+                                            CHPL_RT_MD_COMM_UTIL, 0, 0);
+  order = (size_t*) chpl_mem_allocMany(n, sizeof(order[0]),
+                                       CHPL_RT_MD_COMM_UTIL, 0, 0);
+
+  for (i = 0; i < n; i++)
+    counts[nodes[i] + 1]++;
+  for (i = 1; i <= (size_t) chpl_numNodes; i++)
+    counts[i] += counts[i - 1];
+  for (i = 0; i < n; i++)
+    order[counts[nodes[i]]++] = i;
+
+  chpl_mem_free(counts, 0, 0);
+  return order;
+}
+
+void chpl_comm_gather(void* dst, const c_nodeid_t* nodes,
+                      void* const* raddrs, size_t eltSize, size_t n,
+                      int32_t commID, int ln, int32_t fn) {
+  size_t* order;
+  size_t i;
+
+  if (n == 0 || eltSize == 0)
+    return;
+
+  order = gsOrder(nodes, n);
+
+  for (i = 0; i < n; ) {
+    size_t idx = order[i];
+    c_nodeid_t node = nodes[idx];
+    size_t len = 1;
+
+    // extend over requests contiguous in both source and destination
+    while (i + len < n) {
+      size_t next = order[i + len];
+      if (nodes[next] != node ||
+          next != idx + len ||
+          (char*) raddrs[next] != (char*) raddrs[idx] + len * eltSize)
+        break;
+      len++;
+    }
+
+    if (node == chpl_nodeID)
+      memcpy((char*) dst + idx * eltSize, raddrs[idx], len * eltSize);
+    else
+      chpl_comm_get_unordered((char*) dst + idx * eltSize, node,
+                              raddrs[idx], len * eltSize,
+                              commID, ln, fn);
+    i += len;
+  }
+
+  chpl_comm_unordered_task_fence();
+  chpl_mem_free(order, 0, 0);
+}
+
+void chpl_comm_scatter(const void* src, const c_nodeid_t* nodes,
+                       void* const* raddrs, size_t eltSize, size_t n,
+                       int32_t commID, int ln, int32_t fn) {
+  size_t* order;
+  size_t i;
+
+  if (n == 0 || eltSize == 0)
+    return;
+
+  order = gsOrder(nodes, n);
+
+  for (i = 0; i < n; ) {
+    size_t idx = order[i];
+    c_nodeid_t node = nodes[idx];
+    size_t len = 1;
+
+    while (i + len < n) {
+      size_t next = order[i + len];
+      if (nodes[next] != node ||
+          next != idx + len ||
+          (char*) raddrs[next] != (char*) raddrs[idx] + len * eltSize)
+        break;
+      len++;
+    }
+
+    if (node == chpl_nodeID)
+      memcpy(raddrs[idx], (const char*) src + idx * eltSize, len * eltSize);
+    else
+      chpl_comm_put_unordered((void*) ((const char*) src + idx * eltSize),
+                              node, raddrs[idx], len * eltSize,
+                              commID, ln, fn);
+    i += len;
+  }
+
+  chpl_comm_unordered_task_fence();
+  chpl_mem_free(order, 0, 0);
+}
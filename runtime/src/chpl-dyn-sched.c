@@ -0,0 +1,74 @@
+/*
+ * Copyright 2020-2021 Hewlett Packard Enterprise Development LP
+ * Copyright 2004-2019 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "chplrt.h"
+
+#include "chpl-dyn-sched.h"
+
+void chpl_dynsched_init(chpl_dynsched_t* sched,
+                        int64_t lo, int64_t hi,
+                        int32_t numTasks, int64_t minChunk) {
+  if (numTasks < 1)
+    numTasks = 1;
+  if (minChunk < 1)
+    minChunk = 1;
+
+  atomic_init_int_least64_t(&sched->cursor, lo);
+  sched->hi = hi;
+  sched->minChunk = minChunk;
+  sched->numTasks = numTasks;
+}
+
+chpl_bool chpl_dynsched_next(chpl_dynsched_t* sched,
+                             int64_t* lo, int64_t* hi) {
+  int64_t cur = atomic_load_int_least64_t(&sched->cursor);
+
+  while (cur < sched->hi) {
+    int64_t remaining = sched->hi - cur;
+
+    // Guided sizing: a fraction of what is left, so chunks shrink
+    // exponentially as the range drains, clamped below by minChunk.
+    int64_t chunk = remaining / (2 * (int64_t) sched->numTasks);
+    if (chunk < sched->minChunk)
+      chunk = sched->minChunk;
+    if (chunk > remaining)
+      chunk = remaining;
+
+    // On failure the exchange refreshes cur, so just retry.
+    if (atomic_compare_exchange_strong_int_least64_t(&sched->cursor,
+                                                     &cur, cur + chunk)) {
+      *lo = cur;
+      *hi = cur + chunk;
+      return true;
+    }
+  }
+
+  return false;
+}
+
+int64_t chpl_dynsched_remaining(chpl_dynsched_t* sched) {
+  int64_t cur = atomic_load_int_least64_t(&sched->cursor);
+
+  return (cur < sched->hi) ? sched->hi - cur : 0;
+}
+
+void chpl_dynsched_destroy(chpl_dynsched_t* sched) {
+  atomic_destroy_int_least64_t(&sched->cursor);
+}
@@ -190,3 +190,29 @@ void chpl_env_set_uint(const char* evName, uint64_t evVal, int overwrite) {
   snprintf(buf, sizeof(buf), "%" PRIu64, evVal);
   chpl_env_set(evName, buf, overwrite);
 }
+
+
+uint32_t chpl_env_rt_flags = 0;
+
+static const struct {
+  uint32_t flag;
+  const char* name;
+  chpl_bool dflt;
+} flagTable[] = {
+  { CHPL_ENV_RT_CACHE_QUIET,  "CACHE_QUIET",  false },
+  { CHPL_ENV_RT_COMM_HEATMAP, "COMM_HEATMAP", false },
+  { CHPL_ENV_RT_TASK_PROF,    "TASK_PROF",    false },
+  { CHPL_ENV_RT_PAGE_MIGRATE, "PAGE_MIGRATE", false },
+};
+
+void chpl_env_rt_init(void) {
+  uint32_t flags = CHPL_ENV_RT_FLAGS_PARSED;
+  int i;
+
+  for (i = 0; i < (int) (sizeof(flagTable) / sizeof(flagTable[0])); i++) {
+    if (chpl_env_rt_get_bool(flagTable[i].name, flagTable[i].dflt))
+      flags |= flagTable[i].flag;
+  }
+
+  chpl_env_rt_flags = flags;
+}
@@ -20,7 +20,9 @@
 #include "chplrt.h"
 
 #include "chpl-export-wrappers.h"
+#include "chpl-atomics.h"
 #include "chpl-mem.h"
+#include "chpl-tasks.h"
 
 #include <string.h>
 
@@ -55,3 +57,63 @@ chpl_byte_buffer chpl_byte_buffer_make_len(const char* data, uint64_t size) {
   chpl_byte_buffer result = { 0, (char*) data, size };
   return result;
 }
+
+/************************************* | **************************************
+*                                                                             *
+* Async exported-function support (see chpl-export-wrappers.h)                *
+*                                                                             *
+************************************** | *************************************/
+
+struct chpl_async_handle_s {
+  atomic_bool done;
+  void (*fn)(void* arg);
+  void* arg;
+};
+
+// The bundle carries just the handle; the tasking layer copies it, so
+// it can live on the submitter's stack.
+typedef struct {
+  chpl_task_bundle_t task;
+  chpl_async_handle_t* h;
+} chpl_async_bundle_t;
+
+static
+void chpl_async_task_wrapper(void* arg) {
+  chpl_async_handle_t* h = ((chpl_async_bundle_t*) arg)->h;
+  (*h->fn)(h->arg);
+  atomic_store_bool(&h->done, true);
+}
+
+chpl_async_handle_t* chpl_async_export_submit(void (*fn)(void* arg),
+                                              void* arg) {
+  chpl_async_handle_t* h;
+  chpl_async_bundle_t bundle;
+
+  h = chpl_mem_alloc(sizeof(*h), CHPL_RT_MD_TASK_ARG, 0, 0);
+  atomic_init_bool(&h->done, false);
+  h->fn = fn;
+  h->arg = arg;
+
+  memset(&bundle, 0, sizeof(bundle));
+  bundle.h = h;
+
+  chpl_task_startMovedTask(FID_NONE, chpl_async_task_wrapper,
+                           &bundle, sizeof(bundle),
+                           c_sublocid_any, chpl_nullTaskID);
+
+  return h;
+}
+
+int chpl_async_export_poll(chpl_async_handle_t* h) {
+  return atomic_load_bool(&h->done);
+}
+
+void chpl_async_export_wait(chpl_async_handle_t* h) {
+  while (!atomic_load_bool(&h->done))
+    chpl_task_yield();
+}
+
+void chpl_async_export_free(chpl_async_handle_t* h) {
+  atomic_destroy_bool(&h->done);
+  chpl_mem_free(h, 0, 0);
+}
@@ -0,0 +1,258 @@
+/*
+ * Copyright 2020-2021 Hewlett Packard Enterprise Development LP
+ * Copyright 2004-2019 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//
+// Per-forall instrumentation (--instrument-foralls +
+// CHPL_RT_INSTRUMENT_FORALLS).
+//
+// The compiler brackets each lowered forall with
+// chpl_forall_enter()/chpl_forall_exit() calls carrying the loop's
+// source line and filename index.  Like the visual debug support,
+// the hooks are always present in an instrumented binary but test a
+// runtime flag and return immediately when stats were not requested,
+// so production runs pay only a call and a predictable branch per
+// forall execution (not per iteration).
+//
+// When enabled, we charge each forall execution to its source
+// location: an execution count, wall time, and the number of tasks
+// started while the loop was running.  The task figure comes from a
+// node-wide counter bumped by a tasking callback, so concurrent
+// unrelated activity (including other foralls) is charged to every
+// loop in flight at the time; it is an attribution aid, not an exact
+// count.  Each node prints its table at exit, sorted by total time.
+//
+// The enter/exit pairing is tracked by task ID rather than by thread,
+// so it survives tasks that yield during the join and resume on a
+// different thread.
+//
+
+#include "chplrt.h"
+
+#include "chpl-forall-instrument.h"
+
+#include "chpl-comm.h"
+#include "chpl-env.h"
+#include "chpl-linefile-support.h"
+#include "chpl-mem.h"
+#include "chpl-tasks.h"
+#include "chpl-tasks-callbacks.h"
+#include "error.h"
+
+#include <inttypes.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+int chpl_forall_instrument = 0;
+
+#define FI_TABLE_SIZE 256     // distinct forall sites; must be a power of 2
+#define FI_MAX_FRAMES 1024    // foralls in flight at once, node-wide
+
+typedef struct {
+  int inUse;
+  int32_t ln;                 // forall source line number
+  int32_t fn;                 // forall source filename index
+  uint64_t count;             // executions
+  uint64_t nsecs;             // total wall time
+  uint64_t tasks;             // tasks started while running (approximate)
+} fi_entry_t;
+
+//
+// An in-flight forall execution.  Frames for the same task form a
+// stack (nested foralls), so on exit we match the most recently
+// pushed frame with our task ID.
+//
+typedef struct {
+  chpl_taskID_t id;
+  uint64_t t0;
+  uint64_t tasks0;
+} fi_frame_t;
+
+static fi_entry_t fi_table[FI_TABLE_SIZE];
+static fi_frame_t fi_frames[FI_MAX_FRAMES];
+static int fi_numFrames = 0;
+static uint64_t fi_dropped = 0;
+static uint64_t fi_taskCount = 0;     // tasks started since enabling
+static pthread_mutex_t fi_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static uint64_t fi_now_ns(void) {
+  struct timespec ts;
+  if (clock_gettime(CLOCK_MONOTONIC, &ts) != 0)
+    return 0;
+  return (uint64_t) ts.tv_sec * UINT64_C(1000000000) + (uint64_t) ts.tv_nsec;
+}
+
+static void fi_task_begin(const chpl_task_cb_info_t* info) {
+  pthread_mutex_lock(&fi_lock);
+  fi_taskCount++;
+  pthread_mutex_unlock(&fi_lock);
+}
+
+//
+// Find or claim the table entry for a forall site.  Called with
+// fi_lock held.  Returns NULL when the table is full of other sites.
+//
+static fi_entry_t* fi_find(int32_t ln, int32_t fn) {
+  uint32_t h;
+  int i, probes;
+
+  h = (uint32_t) ln;
+  h = h * 31 + (uint32_t) fn;
+  i = h & (FI_TABLE_SIZE - 1);
+
+  for (probes = 0; probes < FI_TABLE_SIZE; probes++) {
+    fi_entry_t* e = &fi_table[i];
+    if (!e->inUse) {
+      e->inUse = 1;
+      e->ln = ln;
+      e->fn = fn;
+      return e;
+    }
+    if (e->ln == ln && e->fn == fn)
+      return e;
+    i = (i + 1) & (FI_TABLE_SIZE - 1);
+  }
+
+  return NULL;
+}
+
+void chpl_forall_enter(int32_t ln, int32_t fn) {
+  if (!chpl_forall_instrument)
+    return;
+
+  pthread_mutex_lock(&fi_lock);
+  if (fi_numFrames >= FI_MAX_FRAMES) {
+    fi_dropped++;
+  } else {
+    fi_frame_t* f = &fi_frames[fi_numFrames++];
+    f->id = chpl_task_getId();
+    f->tasks0 = fi_taskCount;
+    f->t0 = fi_now_ns();
+  }
+  pthread_mutex_unlock(&fi_lock);
+}
+
+void chpl_forall_exit(int32_t ln, int32_t fn) {
+  uint64_t t1;
+  chpl_taskID_t id;
+  int i;
+
+  if (!chpl_forall_instrument)
+    return;
+
+  t1 = fi_now_ns();
+  id = chpl_task_getId();
+
+  pthread_mutex_lock(&fi_lock);
+
+  // Find our frame: the most recent one pushed by this task.
+  for (i = fi_numFrames - 1; i >= 0; i--) {
+    if (chpl_task_idEquals(fi_frames[i].id, id))
+      break;
+  }
+
+  if (i < 0) {
+    // The matching enter was dropped.
+    fi_dropped++;
+  } else {
+    fi_frame_t frame = fi_frames[i];
+    fi_entry_t* e;
+
+    for ( ; i < fi_numFrames - 1; i++)
+      fi_frames[i] = fi_frames[i + 1];
+    fi_numFrames--;
+
+    if ((e = fi_find(ln, fn)) == NULL) {
+      fi_dropped++;
+    } else {
+      e->count++;
+      e->nsecs += t1 - frame.t0;
+      e->tasks += fi_taskCount - frame.tasks0;
+    }
+  }
+
+  pthread_mutex_unlock(&fi_lock);
+}
+
+static int fi_cmp_entries(const void* a, const void* b) {
+  const fi_entry_t* ea = *(fi_entry_t* const*) a;
+  const fi_entry_t* eb = *(fi_entry_t* const*) b;
+  return (ea->nsecs < eb->nsecs) ? 1 : (ea->nsecs > eb->nsecs) ? -1 : 0;
+}
+
+static void fi_dump(void) {
+  fi_entry_t* ents[FI_TABLE_SIZE];
+  int i, n;
+
+  pthread_mutex_lock(&fi_lock);
+
+  n = 0;
+  for (i = 0; i < FI_TABLE_SIZE; i++) {
+    if (fi_table[i].inUse)
+      ents[n++] = &fi_table[i];
+  }
+  qsort(ents, n, sizeof(ents[0]), fi_cmp_entries);
+
+  fprintf(stderr, "forall stats for node %d:\n", (int) chpl_nodeID);
+  fprintf(stderr, "%12s %15s %12s  %s\n",
+          "execs", "secs", "tasks", "forall loop");
+
+  for (i = 0; i < n; i++) {
+    fi_entry_t* e = ents[i];
+    const char* file = chpl_lookupFilename(e->fn);
+
+    if (file == NULL)
+      file = "<unknown>";
+
+    fprintf(stderr,
+            "%12" PRIu64 " %15.3f %12" PRIu64 "  %s:%" PRId32 "\n",
+            e->count, (double) e->nsecs / 1e9, e->tasks, file, e->ln);
+  }
+
+  if (fi_dropped != 0) {
+    fprintf(stderr,
+            "  (%" PRIu64 " forall execution(s) dropped: "
+            "too many loops or loops in flight)\n", fi_dropped);
+  }
+
+  pthread_mutex_unlock(&fi_lock);
+}
+
+void chpl_forall_instrument_init(void) {
+  if (!chpl_env_rt_get_bool("INSTRUMENT_FORALLS", false))
+    return;
+
+  //
+  // The task-begin callback only feeds the approximate task counts;
+  // timing still works without it.
+  //
+  if (chpl_task_install_callback(chpl_task_cb_event_kind_begin,
+                                 chpl_task_cb_info_kind_id_only,
+                                 fi_task_begin) != 0)
+    chpl_warning("cannot install forall instrumentation callback; "
+                 "task counts will read as 0", 0, 0);
+
+  if (atexit(fi_dump) != 0)
+    chpl_warning("cannot register forall stats dump", 0, 0);
+
+  chpl_forall_instrument = 1;
+}
@@ -19,10 +19,12 @@
 
 #include "sys_basic.h"
 #include "chplrt.h"
+#include "chpl-env.h"
 #include "chpl-linefile-support.h"
 #include "chpl-mem.h"
 #include "chpl-gpu.h"
 #include "chpl-tasks.h"
+#include "chpl-thread-local-storage.h" // CHPL_TLS
 #include "error.h"
 
 #ifdef HAS_GPU_LOCALE
@@ -30,6 +32,8 @@
 #include <cuda.h>
 #include <cuda_runtime.h>
 #include <assert.h>
+#include <pthread.h>
+#include <string.h>
 
 static void CHPL_GPU_LOG(const char *str, ...) {
   if (verbosity >= 2) {
@@ -92,12 +96,130 @@ inline static void chpl_gpu_ensure_context() {
   }
 }
 
+//
+// Loading a fatbin rereads the file and rebuilds the module, which can
+// dwarf the launch itself for short kernels, so cache the CUfunction for
+// each (fatbin, kernel) pair after the first launch.  The cache is tiny
+// (one entry per distinct GPU-ized loop in the program) so a linear scan
+// under a mutex is plenty.
+//
+typedef struct kernel_cache_entry_s {
+  const char* fatbinFile;
+  const char* kernelName;
+  CUfunction  function;
+  struct kernel_cache_entry_s* next;
+} kernel_cache_entry_t;
+
+static kernel_cache_entry_t* kernel_cache = NULL;
+static pthread_mutex_t kernel_cache_lock = PTHREAD_MUTEX_INITIALIZER;
+
+//
+// Each pthread launches and synchronizes on its own stream, so kernels
+// from concurrent tasks can overlap on the device instead of serializing
+// behind a device-wide synchronize.
+//
+#ifdef CHPL_TLS
+static CHPL_TLS CUstream chpl_gpu_thread_stream;
+static CHPL_TLS bool chpl_gpu_thread_stream_created;
+
+static CUstream chpl_gpu_get_stream(void) {
+  if (!chpl_gpu_thread_stream_created) {
+    CUDA_CALL(cuStreamCreate(&chpl_gpu_thread_stream, CU_STREAM_NON_BLOCKING));
+    chpl_gpu_thread_stream_created = true;
+  }
+  return chpl_gpu_thread_stream;
+}
+#endif
+
+//
+// Double-buffered kernel-argument staging.  Argument copies are issued
+// asynchronously on a per-thread staging stream and the kernel is gated
+// on them with an event instead of blocking the host, and the launch
+// itself no longer synchronizes: one launch per thread is left in
+// flight, so in iterative codes the host-to-device copies for the next
+// launch overlap the kernel still executing on the compute stream.
+// Anything that could observe an in-flight kernel's results from the
+// host -- explicit copies, frees, reallocs -- drains the pipeline
+// first.  CHPL_RT_GPU_STAGING=false falls back to the fully synchronous
+// launch path.
+//
+#ifdef CHPL_TLS
+
+// double buffering: the launch just staged plus one still in flight
+#define GPU_PIPELINE_DEPTH 2
+
+typedef struct gpu_pending_launch_s {
+  void*** kernel_params;
+  CUevent done;
+} gpu_pending_launch_t;
+
+static CHPL_TLS CUstream chpl_gpu_thread_staging_stream;
+static CHPL_TLS bool chpl_gpu_thread_staging_created;
+static CHPL_TLS gpu_pending_launch_t
+                  chpl_gpu_thread_pending[GPU_PIPELINE_DEPTH];
+static CHPL_TLS int chpl_gpu_thread_num_pending;
+
+static bool chpl_gpu_staging_enabled(void) {
+  // benign race: every thread computes the same value
+  static volatile int enabled = -1;
+  if (enabled < 0) {
+    enabled = chpl_env_rt_get_bool("GPU_STAGING", true) ? 1 : 0;
+  }
+  return enabled == 1;
+}
+
+static CUstream chpl_gpu_get_staging_stream(void) {
+  if (!chpl_gpu_thread_staging_created) {
+    CUDA_CALL(cuStreamCreate(&chpl_gpu_thread_staging_stream,
+                             CU_STREAM_NON_BLOCKING));
+    chpl_gpu_thread_staging_created = true;
+  }
+  return chpl_gpu_thread_staging_stream;
+}
+
+// Wait for this thread's oldest in-flight launch and release its
+// bookkeeping.
+static void chpl_gpu_retire_oldest_launch(void) {
+  gpu_pending_launch_t* oldest = &chpl_gpu_thread_pending[0];
+
+  CUDA_CALL(cuEventSynchronize(oldest->done));
+  CUDA_CALL(cuEventDestroy(oldest->done));
+
+  // TODO: this should use chpl_mem_free
+  chpl_free(oldest->kernel_params);
+
+  chpl_gpu_thread_num_pending--;
+  memmove(&chpl_gpu_thread_pending[0], &chpl_gpu_thread_pending[1],
+          chpl_gpu_thread_num_pending * sizeof(chpl_gpu_thread_pending[0]));
+}
+
+static void chpl_gpu_drain_pipeline(void) {
+  while (chpl_gpu_thread_num_pending > 0) {
+    chpl_gpu_retire_oldest_launch();
+  }
+}
+
+#else
+
+static void chpl_gpu_drain_pipeline(void) { }
+
+#endif
+
 static void* chpl_gpu_getKernel(const char* fatbinFile, const char* kernelName) {
   chpl_gpu_ensure_context();
 
   CUmodule    cudaModule;
   CUfunction  function;
 
+  pthread_mutex_lock(&kernel_cache_lock);
+  for (kernel_cache_entry_t* ent = kernel_cache; ent != NULL; ent = ent->next) {
+    if (strcmp(ent->fatbinFile, fatbinFile) == 0
+        && strcmp(ent->kernelName, kernelName) == 0) {
+      pthread_mutex_unlock(&kernel_cache_lock);
+      return (void*)ent->function;
+    }
+  }
+
   //read in fatbin and store in buffer
   char * buffer = 0;
   long length;
@@ -125,6 +247,15 @@ static void* chpl_gpu_getKernel(const char* fatbinFile, const char* kernelName)
   // Get kernel function
   CUDA_CALL(cuModuleGetFunction(&function, cudaModule, kernelName));
 
+  // TODO: this should use chpl_mem_alloc
+  kernel_cache_entry_t* ent = chpl_malloc(sizeof(kernel_cache_entry_t));
+  ent->fatbinFile = fatbinFile;
+  ent->kernelName = kernelName;
+  ent->function = function;
+  ent->next = kernel_cache;
+  kernel_cache = ent;
+  pthread_mutex_unlock(&kernel_cache_lock);
+
   return (void*)function;
 }
 
@@ -198,6 +329,10 @@ static void chpl_gpu_launch_kernel_help(const char* fatbinPath,
   assert(function);
   assert(kernel_params);
 
+#ifdef CHPL_TLS
+  const bool staging = chpl_gpu_staging_enabled();
+#endif
+
   CHPL_GPU_LOG("Creating kernel parameters\n");
 
   for (i=0 ; i<nargs ; i++) {
@@ -212,6 +347,15 @@ static void chpl_gpu_launch_kernel_help(const char* fatbinPath,
       // desc
       *kernel_params[i] = chpl_gpu_mem_alloc(cur_arg_size, 0, 0, 0);
 
+#ifdef CHPL_TLS
+      if (staging) {
+        // stage asynchronously; these can overlap a still-running kernel
+        CUDA_CALL(cuMemcpyHtoDAsync((CUdeviceptr)*kernel_params[i], cur_arg,
+                                    cur_arg_size,
+                                    chpl_gpu_get_staging_stream()));
+      }
+      else
+#endif
       chpl_gpu_copy_host_to_device(*kernel_params[i], cur_arg, cur_arg_size);
 
       CHPL_GPU_LOG("\tKernel parameter %d: %p (device ptr)\n",
@@ -226,6 +370,60 @@ static void chpl_gpu_launch_kernel_help(const char* fatbinPath,
 
   CHPL_GPU_LOG("Calling gpu function named %s\n", name);
 
+#ifdef CHPL_TLS
+  // Launch and wait on this thread's own stream, so we only wait for our
+  // kernel and concurrent tasks' kernels can overlap on the device.
+  CUstream stream = chpl_gpu_get_stream();
+
+  if (staging) {
+    // double buffer: keep at most one earlier launch in flight
+    if (chpl_gpu_thread_num_pending == GPU_PIPELINE_DEPTH) {
+      chpl_gpu_retire_oldest_launch();
+    }
+
+    // gate the kernel on its argument copies without blocking the host
+    CUevent copiesDone;
+    CUDA_CALL(cuEventCreate(&copiesDone, CU_EVENT_DISABLE_TIMING));
+    CUDA_CALL(cuEventRecord(copiesDone, chpl_gpu_get_staging_stream()));
+    CUDA_CALL(cuStreamWaitEvent(stream, copiesDone, 0));
+    CUDA_CALL(cuEventDestroy(copiesDone));
+
+    CUDA_CALL(cuLaunchKernel((CUfunction)function,
+                             grd_dim_x, grd_dim_y, grd_dim_z,
+                             blk_dim_x, blk_dim_y, blk_dim_z,
+                             0,  // shared memory in bytes
+                             stream,
+                             (void**)kernel_params,
+                             NULL));  // extra options
+
+    CHPL_GPU_LOG("Call returned %s\n", name);
+
+    // Leave the kernel running instead of synchronizing here; the next
+    // launch's copies will overlap it, and anyone who needs its results
+    // drains the pipeline.
+    gpu_pending_launch_t* slot =
+      &chpl_gpu_thread_pending[chpl_gpu_thread_num_pending++];
+    slot->kernel_params = kernel_params;
+    CUDA_CALL(cuEventCreate(&slot->done, CU_EVENT_DISABLE_TIMING));
+    CUDA_CALL(cuEventRecord(slot->done, stream));
+
+    CHPL_GPU_LOG("Launch left in flight %s\n", name);
+
+    return;
+  }
+
+  CUDA_CALL(cuLaunchKernel((CUfunction)function,
+                           grd_dim_x, grd_dim_y, grd_dim_z,
+                           blk_dim_x, blk_dim_y, blk_dim_z,
+                           0,  // shared memory in bytes
+                           stream,
+                           (void**)kernel_params,
+                           NULL));  // extra options
+
+  CHPL_GPU_LOG("Call returned %s\n", name);
+
+  CUDA_CALL(cuStreamSynchronize(stream));
+#else
   CUDA_CALL(cuLaunchKernel((CUfunction)function,
                            grd_dim_x, grd_dim_y, grd_dim_z,
                            blk_dim_x, blk_dim_y, blk_dim_z,
@@ -235,8 +433,9 @@ static void chpl_gpu_launch_kernel_help(const char* fatbinPath,
                            NULL));  // extra options
 
   CHPL_GPU_LOG("Call returned %s\n", name);
-  
+
   CUDA_CALL(cudaDeviceSynchronize());
+#endif
 
   CHPL_GPU_LOG("Synchronization complete %s\n", name);
 
@@ -247,6 +446,9 @@ static void chpl_gpu_launch_kernel_help(const char* fatbinPath,
 void chpl_gpu_copy_device_to_host(void* dst, void* src, size_t n) {
   chpl_gpu_ensure_context();
 
+  // don't read results out from under an in-flight kernel
+  chpl_gpu_drain_pipeline();
+
   assert(chpl_gpu_is_device_ptr(src));
 
   CHPL_GPU_LOG("Copying %zu bytes from device to host\n", n);
@@ -257,6 +459,9 @@ void chpl_gpu_copy_device_to_host(void* dst, void* src, size_t n) {
 void chpl_gpu_copy_host_to_device(void* dst, void* src, size_t n) {
   chpl_gpu_ensure_context();
 
+  // don't overwrite memory an in-flight kernel may still be using
+  chpl_gpu_drain_pipeline();
+
   assert(chpl_gpu_is_device_ptr(dst));
 
   CHPL_GPU_LOG("Copying %zu bytes from host to device\n", n);
@@ -290,6 +495,238 @@ void chpl_gpu_launch_kernel_flat(const char* fatbinPath, const char* name,
   va_end(args);
 }
 
+//
+// Device-side reductions.  Reducing a GPU-resident buffer used to mean
+// copying it back and combining on the host, erasing the benefit of GPU
+// residency.  These entry points keep the combine on the device: each
+// thread accumulates a strided slice of the input into a register and
+// contributes one grid-level atomic to the result cell, so the data
+// never leaves the device and the host only reads back the final
+// 8-byte result.  The kernels are tiny, so rather than shipping them in
+// the program's fatbin we build them from a PTX template at first use
+// and let the driver JIT them; the CUfunction is cached per op.
+//
+// Floating-point min/max are not provided because there is no 64-bit FP
+// min/max atomic; they would need a multi-pass combine.
+//
+
+typedef struct gpu_reduce_kernel_s {
+  const char* name;     // kernel entry name, also the cache key
+  const char* type;     // PTX type suffix for loads and moves
+  const char* op;       // accumulate instruction
+  const char* red;      // suffix for the grid-level red.global
+  const char* init;     // identity value, as a PTX immediate
+  uint64_t    initBits; // identity value, as stored in the result cell
+  CUfunction  function;
+  bool        loaded;
+} gpu_reduce_kernel_t;
+
+enum {
+  gpu_reduce_add_u64,
+  gpu_reduce_add_s64,
+  gpu_reduce_add_f64,
+  gpu_reduce_min_u64,
+  gpu_reduce_max_u64,
+  gpu_reduce_min_s64,
+  gpu_reduce_max_s64,
+};
+
+static gpu_reduce_kernel_t gpu_reduce_kernels[] = {
+  { "chpl_gpu_kern_add_u64", "u64", "add.u64", "add.u64", "0",
+    0, NULL, false },
+  { "chpl_gpu_kern_add_s64", "s64", "add.s64", "add.u64", "0",
+    0, NULL, false },
+  { "chpl_gpu_kern_add_f64", "f64", "add.f64", "add.f64",
+    "0d0000000000000000", 0, NULL, false },
+  { "chpl_gpu_kern_min_u64", "u64", "min.u64", "min.u64",
+    "0xffffffffffffffff", UINT64_MAX, NULL, false },
+  { "chpl_gpu_kern_max_u64", "u64", "max.u64", "max.u64", "0",
+    0, NULL, false },
+  { "chpl_gpu_kern_min_s64", "s64", "min.s64", "min.s64",
+    "0x7fffffffffffffff", (uint64_t)INT64_MAX, NULL, false },
+  { "chpl_gpu_kern_max_s64", "s64", "max.s64", "max.s64",
+    "0x8000000000000000", (uint64_t)INT64_MIN, NULL, false },
+};
+
+static pthread_mutex_t gpu_reduce_lock = PTHREAD_MUTEX_INITIALIZER;
+
+//
+// The kernel: compute this thread's global index and the grid stride,
+// accumulate data[i] for i = index, index+stride, ... into a register,
+// then combine into the result cell with one grid-level atomic.
+// Placeholders: $N entry name, $T element type, $O accumulate
+// instruction, $R red.global suffix, $I identity immediate.
+//
+static const char* gpu_reduce_ptx_template =
+  ".version 6.0\n"
+  ".target sm_60\n"
+  ".address_size 64\n"
+  ".visible .entry $N(\n"
+  "  .param .u64 p_data, .param .u64 p_n, .param .u64 p_res)\n"
+  "{\n"
+  "  .reg .pred %p1;\n"
+  "  .reg .b32  %r1, %r2, %r3, %r4, %r5, %r6;\n"
+  "  .reg .u64  %i, %n, %stride, %addr, %data, %res;\n"
+  "  .reg .$T   %acc, %val;\n"
+  "  ld.param.u64 %data, [p_data];\n"
+  "  ld.param.u64 %n, [p_n];\n"
+  "  ld.param.u64 %res, [p_res];\n"
+  "  cvta.to.global.u64 %data, %data;\n"
+  "  cvta.to.global.u64 %res, %res;\n"
+  "  mov.u32 %r1, %ctaid.x;\n"
+  "  mov.u32 %r2, %ntid.x;\n"
+  "  mov.u32 %r3, %tid.x;\n"
+  "  mad.lo.s32 %r4, %r1, %r2, %r3;\n"
+  "  mov.u32 %r5, %nctaid.x;\n"
+  "  mul.lo.s32 %r6, %r5, %r2;\n"
+  "  cvt.u64.u32 %i, %r4;\n"
+  "  cvt.u64.u32 %stride, %r6;\n"
+  "  mov.$T %acc, $I;\n"
+  "L_top:\n"
+  "  setp.ge.u64 %p1, %i, %n;\n"
+  "  @%p1 bra L_done;\n"
+  "  shl.b64 %addr, %i, 3;\n"
+  "  add.u64 %addr, %data, %addr;\n"
+  "  ld.global.$T %val, [%addr];\n"
+  "  $O %acc, %acc, %val;\n"
+  "  add.u64 %i, %i, %stride;\n"
+  "  bra L_top;\n"
+  "L_done:\n"
+  "  red.global.$R [%res], %acc;\n"
+  "  ret;\n"
+  "}\n";
+
+static char* gpu_reduce_build_ptx(const gpu_reduce_kernel_t* k) {
+  // TODO: this should use chpl_mem_alloc
+  char* buf = chpl_malloc(strlen(gpu_reduce_ptx_template) + 256);
+  char* out = buf;
+
+  for (const char* in = gpu_reduce_ptx_template; *in != '\0'; in++) {
+    const char* sub = NULL;
+
+    if (*in == '$') {
+      switch (in[1]) {
+        case 'N': sub = k->name; break;
+        case 'T': sub = k->type; break;
+        case 'O': sub = k->op;   break;
+        case 'R': sub = k->red;  break;
+        case 'I': sub = k->init; break;
+      }
+    }
+
+    if (sub != NULL) {
+      size_t len = strlen(sub);
+      memcpy(out, sub, len);
+      out += len;
+      in++;  // also consume the placeholder letter
+    }
+    else {
+      *out++ = *in;
+    }
+  }
+
+  *out = '\0';
+  return buf;
+}
+
+static uint64_t chpl_gpu_reduce_help(int which, void* data, size_t n) {
+  gpu_reduce_kernel_t* k = &gpu_reduce_kernels[which];
+
+  chpl_gpu_ensure_context();
+
+  if (n == 0) {
+    return k->initBits;
+  }
+
+  // in-flight kernels may still be producing the data being reduced
+  chpl_gpu_drain_pipeline();
+
+  assert(chpl_gpu_is_device_ptr(data));
+
+  pthread_mutex_lock(&gpu_reduce_lock);
+  if (!k->loaded) {
+    char* ptx = gpu_reduce_build_ptx(k);
+    CUmodule module;
+
+    CUDA_CALL(cuModuleLoadData(&module, ptx));
+    CUDA_CALL(cuModuleGetFunction(&k->function, module, k->name));
+    k->loaded = true;
+
+    // TODO: this should use chpl_mem_free
+    chpl_free(ptx);
+  }
+  pthread_mutex_unlock(&gpu_reduce_lock);
+
+  // seed the result cell with the identity; the grid combines into it
+  // TODO pass the location info to this function and use a proper mem desc
+  uint64_t* cell = chpl_gpu_mem_alloc(sizeof(uint64_t), 0, 0, 0);
+  *cell = k->initBits;
+
+  int blk_dim = 256;
+  size_t grd_dim = (n + blk_dim - 1) / blk_dim;
+  if (grd_dim > 1024) {
+    grd_dim = 1024;
+  }
+
+  uint64_t n64 = n;
+  void* kernel_params[] = { &data, &n64, &cell };
+
+#ifdef CHPL_TLS
+  CUstream stream = chpl_gpu_get_stream();
+#else
+  CUstream stream = 0;
+#endif
+
+  CHPL_GPU_LOG("Launching reduction kernel %s over %zu elements\n",
+               k->name, n);
+
+  CUDA_CALL(cuLaunchKernel(k->function,
+                           (int)grd_dim, 1, 1,
+                           blk_dim, 1, 1,
+                           0,  // shared memory in bytes
+                           stream,
+                           kernel_params,
+                           NULL));  // extra options
+
+  CUDA_CALL(cuStreamSynchronize(stream));
+
+  uint64_t result = *cell;
+  chpl_gpu_mem_free(cell, 0, 0);
+
+  return result;
+}
+
+uint64_t chpl_gpu_reduce_add_uint64(void* data, size_t n) {
+  return chpl_gpu_reduce_help(gpu_reduce_add_u64, data, n);
+}
+
+int64_t chpl_gpu_reduce_add_int64(void* data, size_t n) {
+  return (int64_t)chpl_gpu_reduce_help(gpu_reduce_add_s64, data, n);
+}
+
+double chpl_gpu_reduce_add_real64(void* data, size_t n) {
+  uint64_t bits = chpl_gpu_reduce_help(gpu_reduce_add_f64, data, n);
+  double result;
+  memcpy(&result, &bits, sizeof(result));
+  return result;
+}
+
+uint64_t chpl_gpu_reduce_min_uint64(void* data, size_t n) {
+  return chpl_gpu_reduce_help(gpu_reduce_min_u64, data, n);
+}
+
+uint64_t chpl_gpu_reduce_max_uint64(void* data, size_t n) {
+  return chpl_gpu_reduce_help(gpu_reduce_max_u64, data, n);
+}
+
+int64_t chpl_gpu_reduce_min_int64(void* data, size_t n) {
+  return (int64_t)chpl_gpu_reduce_help(gpu_reduce_min_s64, data, n);
+}
+
+int64_t chpl_gpu_reduce_max_int64(void* data, size_t n) {
+  return (int64_t)chpl_gpu_reduce_help(gpu_reduce_max_s64, data, n);
+}
+
 bool chpl_gpu_has_context() {
   CUcontext cuda_context = NULL;
 
@@ -339,6 +776,8 @@ void* chpl_gpu_mem_realloc(void* memAlloc, size_t size,
 
   CHPL_GPU_LOG("chpl_gpu_mem_realloc called. Size:%d\n", size);
 
+  chpl_gpu_drain_pipeline();
+
   assert(chpl_gpu_is_device_ptr(memAlloc));
 
   size_t cur_size = chpl_gpu_get_alloc_size(memAlloc);
@@ -380,6 +819,8 @@ void chpl_gpu_mem_free(void* memAlloc, int32_t lineno, int32_t filename) {
 
   CHPL_GPU_LOG("chpl_gpu_mem_free called. Ptr=%p\n", memAlloc);
 
+  chpl_gpu_drain_pipeline();
+
   assert(chpl_gpu_is_device_ptr(memAlloc));
 
   CUDA_CALL(cuMemFree((CUdeviceptr)memAlloc));
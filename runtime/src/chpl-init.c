@@ -26,13 +26,21 @@
 #include "chplcgfns.h"
 #include "chpl-cache.h"
 #include "chpl-comm.h"
+#include "chpl-env.h"
 #include "chplexit.h"
+#include "chpl-forall-instrument.h"
 #include "chplio.h"
 #include "chpl-init.h"
 #include "chpl-mem.h"
 #include "chplmemtrack.h"
+#include "chpl-page-migrate.h"
 #include "chpl-privatization.h"
+#include "chpl-snapshot.h"
+#include "chpl-task-prof.h"
 #include "chpl-tasks.h"
+#include "chpl-telemetry.h"
+#include "chpl-text-prefault.h"
+#include "chpl-trace.h"
 #include "chpl-topo.h"
 #include "chpl-linefile-support.h"
 #include "chplsys.h"
@@ -187,12 +195,32 @@ void chpl_rt_init(int argc, char* argv[]) {
   //
   parseArgs(false, parse_dash_E, &argc, argv);
 
+  chpl_env_rt_init();  // parse hot-path CHPL_RT_* flags once
+
   chpl_error_init();  // This does local-only initialization
+
+  // Prefault the text segment, if requested; done this early so the
+  // streaming read happens before comm and tasking are up and the
+  // first minutes of user code would otherwise demand-fault it.
+  chpl_text_prefault_init();
+
+
   chpl_topo_init();
   chpl_comm_init(&argc, &argv);
   chpl_mem_init();
   chpl_comm_post_mem_init();
 
+  //
+  // If the program was compiled with --packed-wide-pointers, make sure
+  // the node id field is wide enough for this many locales.
+  //
+  if (CHPL_WIDE_POINTERS_NODE_BITS > 0
+      && (uint64_t) chpl_numNodes
+         > ((uint64_t) 1 << CHPL_WIDE_POINTERS_NODE_BITS)) {
+    chpl_error("this program's packed wide pointers cannot address this "
+               "many locales; recompile with more node bits", 0, 0);
+  }
+
   chpl_comm_barrier("about to leave comm init code");
 
   CreateConfigVarTable();      // get ready to start tracking config vars
@@ -233,9 +261,24 @@ void chpl_rt_init(int argc, char* argv[]) {
   //
   chpl_task_init();
 
+  // Task profiling hooks onto the tasking callbacks, if requested.
+  chpl_task_prof_init();
+
+  // Distributed tracing hooks onto the tasking and comm callbacks.
+  chpl_trace_init();
+
+  // Forall instrumentation, if compiled in and requested.
+  chpl_forall_instrument_init();
+
   // Initialize privatization, needs to happen before hitting module init
   chpl_privatization_init();
 
+  // Initialize the asynchronous snapshot service.
+  chpl_snapshot_init();
+
+  // Start the live telemetry endpoint, if requested.
+  chpl_telemetry_init();
+
   //
   // Some comm layer initialization has to wait until after the
   // tasking layer is initialized.
@@ -243,6 +286,8 @@ void chpl_rt_init(int argc, char* argv[]) {
   chpl_comm_post_task_init();
 #ifdef HAS_CHPL_CACHE_FNS
   chpl_cache_init();
+  // The cache's miss path is what feeds the page-migration counters.
+  chpl_pagemigrate_init();
 #endif
   chpl_comm_rollcall();
 
@@ -36,7 +36,7 @@ CHPL_TLS_DECL(fileBuff, unknownFileBuffer);
 // See note in chpl-linefile-support.h
 void chpl_saveFilename(const char *filename) { savedFilename = filename; }
 
-// chpl_filenameTable is defined in chplcgfns.h
+// chpl_filenameTableData/Offsets are declared in chplcgfns.h
 c_string chpl_lookupFilename(const int32_t idx) {
   if (idx < 0) {
     switch (idx) {
@@ -70,7 +70,7 @@ c_string chpl_lookupFilename(const int32_t idx) {
     }
   } else {
     if (idx < chpl_filenameTableSize) {
-      return chpl_filenameTable[idx];
+      return &chpl_filenameTableData[chpl_filenameTableOffsets[idx]];
     } else {
       snprintf(CHPL_TLS_GET(unknownFileBuffer), 48,
                "<unknown file idx %" PRId32 ">", idx);
@@ -0,0 +1,59 @@
+/*
+ * Copyright 2020-2021 Hewlett Packard Enterprise Development LP
+ * Copyright 2004-2019 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "chplrt.h"
+
+#include "chpl-localized-view.h"
+
+#include "chpl-comm.h"
+#include "chpl-comm-compiler-macros.h"
+#include "chpl-linefile-support.h"
+#include "chpl-mem.h"
+
+void chpl_localizedView_pin(chpl_localizedView_t* view,
+                            c_nodeid_t node, void* remoteAddr, size_t size) {
+  view->node = node;
+  view->remoteAddr = remoteAddr;
+  view->size = size;
+
+  if (node == chpl_nodeID) {
+    // Already local; alias the original rather than copying it.
+    view->localData = remoteAddr;
+  } else {
+    view->localData = chpl_mem_alloc(size, CHPL_RT_MD_LOCALIZED_VIEW, 0, 0);
+    chpl_gen_comm_get(view->localData, node, remoteAddr, size,
+                      CHPL_COMM_UNKNOWN_ID, -1, CHPL_FILE_IDX_INTERNAL);
+  }
+}
+
+void chpl_localizedView_refresh(chpl_localizedView_t* view) {
+  if (view->node != chpl_nodeID) {
+    chpl_gen_comm_get(view->localData, view->node, view->remoteAddr,
+                      view->size,
+                      CHPL_COMM_UNKNOWN_ID, -1, CHPL_FILE_IDX_INTERNAL);
+  }
+}
+
+void chpl_localizedView_unpin(chpl_localizedView_t* view) {
+  if (view->node != chpl_nodeID) {
+    chpl_mem_free(view->localData, 0, 0);
+  }
+  view->localData = NULL;
+}
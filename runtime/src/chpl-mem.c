@@ -24,15 +24,19 @@
 #include "chplrt.h"
 
 #include "chpl-mem.h"
+#include "chpl-tasks.h"
+#include "chpl-thread-local-storage.h"
 #include "chpltypes.h"
 #include "error.h"
 #include "chplsys.h"
 
 static int heapInitialized = 0;
 
+CHPL_TLS_DECL(void*, recycleListsTls);
 
 void chpl_mem_init(void) {
   chpl_mem_layerInit();
+  CHPL_TLS_INIT(recycleListsTls);
   heapInitialized = 1;
 }
 
@@ -102,8 +106,203 @@ void* chpl_pvalloc(size_t size)
 {
   size_t page_size = chpl_getHeapPageSize();
   size_t num_pages = (size + page_size - 1) / page_size;
-  size_t rounded_up = num_pages * page_size; 
+  size_t rounded_up = num_pages * page_size;
   return chpl_memalign(chpl_getHeapPageSize(), rounded_up);
 }
 
 
+//
+// Per-task bump arena.  Chunks live on a singly-linked list headed in
+// the current task's chpl_task_infoRuntime_t, which the tasking layer
+// zeroes when each task starts.
+//
+
+#define ARENA_MIN_CHUNK_SIZE ((size_t) 16384)
+
+struct chpl_mem_arenaChunk_s {
+  chpl_mem_arenaChunk_t* next;
+  size_t size;   // usable bytes following the (rounded-up) header
+  size_t used;   // of which, bytes already handed out
+};
+
+// keep returned pointers aligned well enough for any scalar type
+static inline size_t arenaRoundUp(size_t size) {
+  const size_t mask = 2 * sizeof(void*) - 1;
+  return (size + mask) & ~mask;
+}
+
+void* chpl_mem_arena_alloc(size_t size, chpl_mem_descInt_t description,
+                           int32_t lineno, int32_t filename) {
+  chpl_task_infoRuntime_t* infoRuntime = chpl_task_getInfoRuntime();
+  const size_t hdrSize = arenaRoundUp(sizeof(chpl_mem_arenaChunk_t));
+  chpl_mem_arenaChunk_t* chunk;
+  void* p;
+
+  if (infoRuntime == NULL) {
+    // not hosted by a task; fall back to the regular allocator
+    return chpl_mem_alloc(size, description, lineno, filename);
+  }
+
+  size = arenaRoundUp(size);
+
+  chunk = infoRuntime->mem_data.arenaHead;
+  if (chunk == NULL || chunk->size - chunk->used < size) {
+    // Start a new chunk, doubling so that a task making many small
+    // allocations settles into rare refills.
+    size_t chunkSize = ARENA_MIN_CHUNK_SIZE;
+    if (chunk != NULL && 2 * chunk->size > chunkSize)
+      chunkSize = 2 * chunk->size;
+    if (size > chunkSize)
+      chunkSize = size;
+    chunk = chpl_mem_alloc(hdrSize + chunkSize, CHPL_RT_MD_TASK_ARENA_CHUNK,
+                           lineno, filename);
+    chunk->next = infoRuntime->mem_data.arenaHead;
+    chunk->size = chunkSize;
+    chunk->used = 0;
+    infoRuntime->mem_data.arenaHead = chunk;
+  }
+
+  p = (char*) chunk + hdrSize + chunk->used;
+  chunk->used += size;
+  return p;
+}
+
+void chpl_mem_arena_reset(void) {
+  chpl_task_infoRuntime_t* infoRuntime = chpl_task_getInfoRuntime();
+  chpl_mem_arenaChunk_t* chunk;
+
+  if (infoRuntime == NULL)
+    return;
+
+  chunk = infoRuntime->mem_data.arenaHead;
+  while (chunk != NULL) {
+    chpl_mem_arenaChunk_t* next = chunk->next;
+    chpl_mem_free(chunk, 0, 0);
+    chunk = next;
+  }
+  infoRuntime->mem_data.arenaHead = NULL;
+}
+
+
+//
+// Size-classed growth recycler.  Doubling growth patterns walk the
+// power-of-two sizes, and streaming code that repeatedly grows and
+// shrinks frees a class block only to re-request the same class
+// moments later, paying the full allocator path each time.  Freed
+// class blocks are instead cached in short per-thread free lists --
+// each pthread (shepherd) keeps its own, so push and pop never take a
+// lock -- and the next grow on that thread reuses them.  Recycled
+// blocks bypass the memory-tracking hooks, like the task arena above.
+//
+
+#define RECYCLE_MIN_LG 6    // 64 bytes; below this the allocator is cheap
+#define RECYCLE_MAX_LG 20   // 1 MiB; above this caching holds too much
+#define RECYCLE_NUM_CLASSES (RECYCLE_MAX_LG - RECYCLE_MIN_LG + 1)
+#define RECYCLE_DEPTH 8     // blocks cached per class per thread
+
+typedef struct recycleBlock_s {
+  struct recycleBlock_s* next;
+} recycleBlock_t;
+
+typedef struct {
+  recycleBlock_t* head[RECYCLE_NUM_CLASSES];
+  int depth[RECYCLE_NUM_CLASSES];
+} recycleLists_t;
+
+// class whose block size is the smallest power of two >= size,
+// or -1 if out of the recycled range
+static int recycleClassUp(size_t size) {
+  size_t classSize = (size_t) 1 << RECYCLE_MIN_LG;
+  int cls;
+
+  for (cls = 0; cls < RECYCLE_NUM_CLASSES; cls++, classSize <<= 1) {
+    if (size <= classSize)
+      return cls;
+  }
+  return -1;
+}
+
+// largest class whose block size is <= size, or -1; a freed buffer
+// parks in this class so a pop never returns a block that is too small
+static int recycleClassDown(size_t size) {
+  int cls = recycleClassUp(size);
+
+  if (cls < 0)
+    return (size > ((size_t) 1 << RECYCLE_MAX_LG))
+           ? RECYCLE_NUM_CLASSES - 1 : -1;
+  if (((size_t) 1 << (RECYCLE_MIN_LG + cls)) > size)
+    cls--;
+  return cls;
+}
+
+static recycleLists_t* recycleLists(int32_t lineno, int32_t filename) {
+  recycleLists_t* lists = (recycleLists_t*) CHPL_TLS_GET(recycleListsTls);
+
+  if (lists == NULL) {
+    lists = (recycleLists_t*)
+            chpl_mem_allocManyZero(1, sizeof(*lists),
+                                   CHPL_RT_MD_THREAD_PRV_DATA,
+                                   lineno, filename);
+    CHPL_TLS_SET(recycleListsTls, lists);
+  }
+  return lists;
+}
+
+void* chpl_mem_grow(void* ptr, size_t oldSize, size_t newSize,
+                    size_t finalSize, chpl_mem_descInt_t description,
+                    int32_t lineno, int32_t filename) {
+  void* newPtr = NULL;
+  int cls;
+
+  if (finalSize > newSize)
+    newSize = finalSize;
+  if (newSize < oldSize)
+    newSize = oldSize;
+
+  cls = recycleClassUp(newSize);
+  if (cls >= 0) {
+    recycleLists_t* lists = recycleLists(lineno, filename);
+
+    newSize = (size_t) 1 << (RECYCLE_MIN_LG + cls);
+    if (lists->head[cls] != NULL) {
+      recycleBlock_t* block = lists->head[cls];
+      lists->head[cls] = block->next;
+      lists->depth[cls]--;
+      newPtr = block;
+    }
+  }
+
+  if (newPtr == NULL)
+    newPtr = chpl_mem_alloc(newSize, description, lineno, filename);
+
+  if (ptr != NULL) {
+    if (oldSize > 0)
+      chpl_memcpy(newPtr, ptr, oldSize);
+    chpl_mem_grow_free(ptr, oldSize, lineno, filename);
+  }
+
+  return newPtr;
+}
+
+void chpl_mem_grow_free(void* ptr, size_t size,
+                        int32_t lineno, int32_t filename) {
+  int cls;
+
+  if (ptr == NULL)
+    return;
+
+  cls = recycleClassDown(size);
+  if (cls >= 0) {
+    recycleLists_t* lists = recycleLists(lineno, filename);
+
+    if (lists->depth[cls] < RECYCLE_DEPTH) {
+      recycleBlock_t* block = (recycleBlock_t*) ptr;
+      block->next = lists->head[cls];
+      lists->head[cls] = block;
+      lists->depth[cls]++;
+      return;
+    }
+  }
+
+  chpl_mem_free(ptr, lineno, filename);
+}
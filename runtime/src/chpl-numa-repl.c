@@ -0,0 +1,120 @@
+/*
+ * Copyright 2020-2021 Hewlett Packard Enterprise Development LP
+ * Copyright 2004-2019 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "chplrt.h"
+
+#include "chpl-numa-repl.h"
+
+#include "chpl-atomics.h"
+#include "chpl-linefile-support.h"
+#include "chpl-mem.h"
+#include "chpl-topo.h"
+#include "chplsys.h"
+#include "error.h"
+
+#include <string.h>
+
+struct chpl_numa_repl_s {
+  size_t size;              // bytes per replica, the caller's view
+  size_t stride;            // replica spacing, a whole number of pages
+  int nReplicas;            // one per NUMA domain
+  unsigned char* mem;       // the raw allocation, kept for the free
+  unsigned char* replicas;  // page-aligned base of replica 0
+};
+
+static inline unsigned char* replicaAt(chpl_numa_repl_t* r, int i) {
+  return r->replicas + (size_t) i * r->stride;
+}
+
+chpl_numa_repl_t* chpl_numa_repl_create(size_t size, const void* init) {
+  chpl_numa_repl_t* r;
+  const size_t pageSize = chpl_getSysPageSize();
+  int i;
+
+  if (size == 0) {
+    chpl_internal_error("chpl_numa_repl_create: zero size");
+  }
+
+  r = chpl_mem_alloc(sizeof(chpl_numa_repl_t), CHPL_RT_MD_NUMA_REPL_DATA,
+                     0, CHPL_FILE_IDX_INTERNAL);
+  r->size = size;
+  r->stride = (size + pageSize - 1) & ~(pageSize - 1);
+  r->nReplicas = chpl_topo_getNumNumaDomains();
+  if (r->nReplicas < 1) {
+    r->nReplicas = 1;
+  }
+
+  //
+  // Page-align the replicas by hand so each one is a run of whole
+  // pages; that way binding a replica to its domain never drags along
+  // a page shared with a neighboring replica.
+  //
+  r->mem = chpl_mem_alloc((size_t) r->nReplicas * r->stride + pageSize - 1,
+                          CHPL_RT_MD_NUMA_REPL_DATA,
+                          0, CHPL_FILE_IDX_INTERNAL);
+  r->replicas = (unsigned char*)
+                (((uintptr_t) r->mem + pageSize - 1) & ~(uintptr_t)
+                 (pageSize - 1));
+
+  for (i = 0; i < r->nReplicas; i++) {
+    unsigned char* rep = replicaAt(r, i);
+    if (r->nReplicas > 1) {
+      chpl_topo_setMemLocality(rep, r->stride, false /*onlyInside*/,
+                               (c_sublocid_t) i);
+    }
+    if (init != NULL) {
+      memcpy(rep, init, size);
+    } else {
+      memset(rep, 0, size);
+    }
+  }
+
+  chpl_atomic_thread_fence(memory_order_release);
+
+  return r;
+}
+
+void chpl_numa_repl_destroy(chpl_numa_repl_t* r) {
+  chpl_mem_free(r->mem, 0, CHPL_FILE_IDX_INTERNAL);
+  chpl_mem_free(r, 0, CHPL_FILE_IDX_INTERNAL);
+}
+
+void* chpl_numa_repl_localPtr(chpl_numa_repl_t* r) {
+  c_sublocid_t d = chpl_topo_getThreadLocality();
+  if (d < 0 || d >= r->nReplicas) {
+    d = 0;
+  }
+  return replicaAt(r, (int) d);
+}
+
+void chpl_numa_repl_write(chpl_numa_repl_t* r, size_t offset,
+                          const void* src, size_t len) {
+  int i;
+
+  if (offset + len > r->size) {
+    chpl_internal_error("chpl_numa_repl_write: out of bounds");
+  }
+
+  for (i = 0; i < r->nReplicas; i++) {
+    memcpy(replicaAt(r, i) + offset, src, len);
+  }
+
+  chpl_atomic_thread_fence(memory_order_release);
+}
@@ -0,0 +1,188 @@
+/*
+ * Copyright 2020-2021 Hewlett Packard Enterprise Development LP
+ * Copyright 2004-2019 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "chplrt.h"
+
+#include "chpl-page-migrate.h"
+
+#include "chpl-atomics.h"
+#include "chpl-env.h"
+#include "chpl-tasks.h"
+
+#include <string.h>
+
+//
+// Counters live in a fixed open-addressed table so the miss path never
+// allocates.  A slot's key packs the owning node into the top 16 bits
+// and the page number (the cache's pages are 1k, so the low 10 address
+// bits are zero) into the rest; key 0 means empty.  The miss path
+// claims an empty slot with a compare-and-swap and otherwise just
+// increments, so a full table or a lost race only drops a sample --
+// this is telemetry, not accounting.
+//
+#define PM_TABLE_SIZE 4096
+#define PM_MAX_PROBES 8
+#define PM_PAGE_BITS 10
+#define PM_NODE_SHIFT 48
+
+typedef struct {
+  atomic_uint_least64_t key;
+  atomic_uint_least64_t count;
+} pm_slot_t;
+
+static pm_slot_t pm_table[PM_TABLE_SIZE];
+
+static chpl_pagemigrate_cb_t pm_cb = NULL;
+
+static chpl_bool pm_running = false;
+static atomic_bool pm_please_exit;
+static atomic_bool pm_exited;
+
+static uint64_t pm_threshold;
+static double pm_interval;
+
+static inline
+uint64_t pm_key(c_nodeid_t node, uint64_t pageAddr) {
+  return ((uint64_t) node << PM_NODE_SHIFT) | (pageAddr >> PM_PAGE_BITS);
+}
+
+static inline
+uint64_t pm_hash(uint64_t key) {
+  // xor-fold so nearby pages on the same node land in different slots
+  key ^= key >> 33;
+  key *= UINT64_C(0xff51afd7ed558ccd);
+  key ^= key >> 33;
+  return key & (PM_TABLE_SIZE - 1);
+}
+
+void chpl_pagemigrate_note_remote_impl(c_nodeid_t node, uint64_t pageAddr) {
+  uint64_t key = pm_key(node, pageAddr);
+  uint64_t slot = pm_hash(key);
+  int probe;
+
+  for (probe = 0; probe < PM_MAX_PROBES; probe++) {
+    pm_slot_t* s = &pm_table[(slot + probe) & (PM_TABLE_SIZE - 1)];
+    uint64_t seen = atomic_load_uint_least64_t(&s->key);
+
+    if (seen == 0) {
+      uint64_t expected = 0;
+      if (!atomic_compare_exchange_strong_uint_least64_t(&s->key,
+                                                         &expected, key)
+          && expected != key) {
+        continue; // someone else claimed it; keep probing
+      }
+    } else if (seen != key) {
+      continue;
+    }
+
+    (void) atomic_fetch_add_uint_least64_t(&s->count, 1);
+    return;
+  }
+
+  // table section is full; drop the sample
+}
+
+//
+// The sweep runs on the policy task.  Pages past the threshold are
+// reported and reset; the rest decay by half so counts reflect recent
+// traffic rather than job lifetime.
+//
+static
+void pm_sweep(void) {
+  int i;
+
+  for (i = 0; i < PM_TABLE_SIZE; i++) {
+    pm_slot_t* s = &pm_table[i];
+    uint64_t key = atomic_load_uint_least64_t(&s->key);
+    uint64_t count;
+
+    if (key == 0)
+      continue;
+
+    count = atomic_load_uint_least64_t(&s->count);
+    if (count >= pm_threshold) {
+      atomic_store_uint_least64_t(&s->count, 0);
+      if (pm_cb != NULL) {
+        c_nodeid_t node = (c_nodeid_t) (key >> PM_NODE_SHIFT);
+        void* pageAddr =
+          (void*) ((key & ((UINT64_C(1) << PM_NODE_SHIFT) - 1))
+                   << PM_PAGE_BITS);
+        (*pm_cb)(node, pageAddr, count);
+      }
+    } else if (count > 0) {
+      // racing increments during the halving just lose a sample
+      atomic_store_uint_least64_t(&s->count, count / 2);
+    }
+  }
+}
+
+typedef struct {
+  chpl_task_bundle_t task;
+} pm_bundle_t;
+
+static
+void pm_policy_task(void* arg) {
+  while (!atomic_load_bool(&pm_please_exit)) {
+    chpl_task_sleep(pm_interval);
+    pm_sweep();
+  }
+  atomic_store_bool(&pm_exited, true);
+}
+
+void chpl_pagemigrate_init(void) {
+  pm_bundle_t bundle;
+  int i;
+
+  if (!chpl_env_rt_flag(CHPL_ENV_RT_PAGE_MIGRATE))
+    return;
+
+  pm_threshold = chpl_env_rt_get_uint("PAGE_MIGRATE_THRESHOLD", 1024);
+  pm_interval = (double) chpl_env_rt_get_int("PAGE_MIGRATE_INTERVAL", 5);
+  if (pm_interval <= 0.0)
+    pm_interval = 5.0;
+
+  for (i = 0; i < PM_TABLE_SIZE; i++) {
+    atomic_init_uint_least64_t(&pm_table[i].key, 0);
+    atomic_init_uint_least64_t(&pm_table[i].count, 0);
+  }
+
+  atomic_init_bool(&pm_please_exit, false);
+  atomic_init_bool(&pm_exited, false);
+
+  memset(&bundle, 0, sizeof(bundle));
+  chpl_task_startMovedTask(FID_NONE, pm_policy_task,
+                           &bundle, sizeof(bundle),
+                           c_sublocid_any, chpl_nullTaskID);
+  pm_running = true;
+}
+
+void chpl_pagemigrate_exit(void) {
+  if (!pm_running)
+    return;
+  pm_running = false;
+
+  atomic_store_bool(&pm_please_exit, true);
+  while (!atomic_load_bool(&pm_exited))
+    chpl_task_yield();
+}
+
+void chpl_pagemigrate_register(chpl_pagemigrate_cb_t cb) {
+  pm_cb = cb;
+}
@@ -20,8 +20,18 @@
 
 #include "chplrt.h"
 #include "chpl-privatization.h"
-#include "chpl-mem.h"
 #include "chpl-atomics.h"
+#include "chpl-comm.h"
+#include "chpl-comm-compiler-macros.h"
+#include "chpl-linefile-support.h"
+#include "chpl-mem.h"
+#include "chpl-tasks.h"
+#include "chplcgfns.h"
+
+// Don't get warning macros for chpl_comm_put etc.
+#include "chpl-comm-no-warning-macros.h"
+
+#include <string.h>
 
 static int64_t chpl_capPrivateObjects = 0;
 static atomic_spinlock_t lock;
@@ -40,38 +50,60 @@ static inline int64_t max(int64_t a, int64_t b) {
 // called with non-monotonic pid's. e.g. this may be called with pid 27, and
 // then pid 2, so it has to ensure that the privatized array has at least pid+1
 // elements. Be __very__ careful if you have to update it.
+//
+// Readers index chpl_privateObjects directly, without taking the lock
+// (see chpl-privatization.h), so growth is RCU-style: build the larger
+// array, copy the old contents, then publish the new pointer behind a
+// release fence and leak the old array so stale readers stay valid.
 void chpl_newPrivatizedClass(void* v, int64_t pid) {
+  chpl_privateObject_t* tmp = NULL;
+  int64_t newCap = 0;
+
+  // Optimistically allocate any needed larger array before taking the
+  // lock, so concurrent insertions aren't serialized behind the
+  // zeroing of a large allocation.
+  if (pid >= chpl_capPrivateObjects) {
+    newCap = 2*max(pid, max(chpl_capPrivateObjects, 4));
+    tmp = chpl_mem_allocManyZero(newCap,
+                                 sizeof(chpl_privateObject_t),
+                                 CHPL_RT_MD_COMM_PRV_OBJ_ARRAY, 0, 0);
+  }
+
   atomic_lock_spinlock_t(&lock);
 
-  // initialize array to a default size
-  if (chpl_privateObjects == NULL) {
-    chpl_capPrivateObjects = 2*max(pid, 4);
-    chpl_privateObjects =
-        chpl_mem_allocManyZero(chpl_capPrivateObjects,
-                               sizeof(chpl_privateObject_t),
-                               CHPL_RT_MD_COMM_PRV_OBJ_ARRAY, 0, 0);
-  } else {
-    // if we're out of space, double (or more) the array size
-    if (pid >= chpl_capPrivateObjects) {
-      chpl_privateObject_t* tmp;
-      int64_t oldCap;
-
-      oldCap = chpl_capPrivateObjects;
-      chpl_capPrivateObjects = 2*max(pid, oldCap);
-
-      tmp = chpl_mem_allocManyZero(chpl_capPrivateObjects,
-                                   sizeof(chpl_privateObject_t),
-                                   CHPL_RT_MD_COMM_PRV_OBJ_ARRAY, 0, 0);
-      chpl_memcpy((void*)tmp, (void*)chpl_privateObjects,
-                  (oldCap)*sizeof(chpl_privateObject_t));
-      chpl_privateObjects = tmp;
-      // purposely leak old copies of chpl_privateObject to avoid the need to
-      // lock chpl_getPrivatizedClass; TODO: fix with lock free data structure
+  // if we're out of space, install the larger array allocated above
+  // (somebody else may have grown the table since we checked, in which
+  // case ours may no longer be needed, or may still be the bigger one)
+  if (pid >= chpl_capPrivateObjects) {
+    if (tmp == NULL || newCap <= chpl_capPrivateObjects) {
+      atomic_unlock_spinlock_t(&lock);
+      if (tmp != NULL)
+        chpl_mem_free(tmp, 0, 0);
+      chpl_newPrivatizedClass(v, pid);
+      return;
     }
+
+    if (chpl_privateObjects != NULL)
+      chpl_memcpy((void*)tmp, (void*)chpl_privateObjects,
+                  chpl_capPrivateObjects*sizeof(chpl_privateObject_t));
+
+    // make the copied contents visible before the pointer; lock-free
+    // readers that see the new pointer must see the filled-in slots
+    chpl_atomic_thread_fence(memory_order_release);
+    chpl_privateObjects = tmp;
+    chpl_capPrivateObjects = newCap;
+    tmp = NULL;
+    // purposely leak old copies of chpl_privateObject to avoid the need to
+    // lock chpl_getPrivatizedClass
   }
+
   chpl_privateObjects[pid].obj = v;
 
   atomic_unlock_spinlock_t(&lock);
+
+  // free our unused allocation if somebody else grew the table further
+  if (tmp != NULL)
+    chpl_mem_free(tmp, 0, 0);
 }
 
 void chpl_clearPrivatizedClass(int64_t i) {
@@ -91,3 +123,120 @@ int64_t chpl_numPrivatizedClasses(void) {
   atomic_unlock_spinlock_t(&lock);
   return ret;
 }
+
+/************************************* | **************************************
+*                                                                             *
+* Tree-fanout privatization broadcast (see chpl-privatization.h)              *
+*                                                                             *
+************************************** | *************************************/
+
+// enough for 2^30 locales; node ids are 32-bit
+#define PRIV_BCAST_MAX_FANOUT 30
+
+//
+// The on-bundle forwarded down the tree: this header, then the setup
+// function's own bundle at an 8-byte-aligned offset.
+//
+typedef struct {
+  chpl_comm_on_bundle_t on;
+  chpl_fn_int_t treeFid;   // ftable index of the tree on-wrapper
+  chpl_fn_int_t innerFid;  // ftable index of the per-locale setup
+  int32_t innerSize;       // size of the setup bundle that follows
+  c_nodeid_t root;         // the locale that started the broadcast
+  c_nodeid_t parent;       // who to ack when our subtree is done
+  void* parentAck;         // our ack slot in the parent's frame
+} chpl_priv_bcast_hdr_t;
+
+#define PRIV_BCAST_INNER_OFF \
+  ((sizeof(chpl_priv_bcast_hdr_t) + 7) & ~(size_t) 7)
+
+//
+// Forward the request to this locale's binomial-tree children with
+// non-blocking executeOns, giving each child its own ack slot.
+// Returns the number of children started.
+//
+static int privBcastForward(chpl_priv_bcast_hdr_t* req, size_t reqSize,
+                            volatile unsigned char* acks) {
+  // number the locales relative to the root so the tree math is the
+  // same no matter which locale started the broadcast
+  c_nodeid_t rel =
+    (chpl_nodeID - req->root + chpl_numNodes) % chpl_numNodes;
+  int numKids = 0;
+
+  // children: rel + 2^k for each 2^k > rel
+  for (int k = 0; k < PRIV_BCAST_MAX_FANOUT; k++) {
+    c_nodeid_t bit = (c_nodeid_t) 1 << k;
+    if (bit <= rel && rel != 0)
+      continue;
+    c_nodeid_t relChild = rel + bit;
+    if (relChild >= chpl_numNodes)
+      break;
+    acks[numKids] = 0;
+    req->parent = chpl_nodeID;
+    req->parentAck = (void*) &acks[numKids];
+    chpl_comm_execute_on_nb((relChild + req->root) % chpl_numNodes,
+                            c_sublocid_any, req->treeFid,
+                            &req->on, reqSize,
+                            0, CHPL_FILE_IDX_INTERNAL);
+    numKids++;
+  }
+
+  return numKids;
+}
+
+static void privBcastWaitAcks(volatile unsigned char* acks, int numKids) {
+  for (int i = 0; i < numKids; i++) {
+    while (acks[i] == 0)
+      chpl_task_yield();
+  }
+}
+
+void chpl_privatization_bcast_handler(chpl_comm_on_bundle_t* bundle) {
+  chpl_priv_bcast_hdr_t* req = (chpl_priv_bcast_hdr_t*) bundle;
+  size_t reqSize = PRIV_BCAST_INNER_OFF + req->innerSize;
+  c_nodeid_t parent = req->parent;
+  void* parentAck = req->parentAck;
+  volatile unsigned char acks[PRIV_BCAST_MAX_FANOUT];
+  unsigned char one = 1;
+  int numKids;
+
+  // forward first so the subtrees install in parallel with us
+  numKids = privBcastForward(req, reqSize, acks);
+
+  // run the per-locale setup on its own bundle
+  chpl_ftable[req->innerFid]((void*) ((char*) req + PRIV_BCAST_INNER_OFF));
+
+  // once our whole subtree is done, tell the parent
+  privBcastWaitAcks(acks, numKids);
+  chpl_comm_put(&one, parent, parentAck, sizeof(one),
+                CHPL_COMM_UNKNOWN_ID, 0, CHPL_FILE_IDX_INTERNAL);
+}
+
+void chpl_privatization_broadcast(chpl_fn_int_t treeFid,
+                                  chpl_fn_int_t innerFid,
+                                  chpl_comm_on_bundle_t* innerArg,
+                                  size_t innerSize,
+                                  int lineno, int32_t filename) {
+  chpl_priv_bcast_hdr_t* req;
+  size_t reqSize = PRIV_BCAST_INNER_OFF + innerSize;
+  volatile unsigned char acks[PRIV_BCAST_MAX_FANOUT];
+  int numKids;
+
+  if (chpl_numNodes == 1)
+    return;
+
+  req = chpl_mem_alloc(reqSize, CHPL_RT_MD_COMM_PRV_OBJ_ARRAY,
+                       lineno, filename);
+  memset(req, 0, sizeof(*req));
+  req->treeFid = treeFid;
+  req->innerFid = innerFid;
+  req->innerSize = (int32_t) innerSize;
+  req->root = chpl_nodeID;
+  memcpy((char*) req + PRIV_BCAST_INNER_OFF, innerArg, innerSize);
+
+  // the caller installed its own copy already, so just fan out and wait
+  numKids = privBcastForward(req, reqSize, acks);
+  privBcastWaitAcks(acks, numKids);
+
+  chpl_mem_free(req, lineno, filename);
+}
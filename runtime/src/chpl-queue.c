@@ -0,0 +1,191 @@
+/*
+ * Copyright 2020-2021 Hewlett Packard Enterprise Development LP
+ * Copyright 2004-2019 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "chplrt.h"
+
+#include "chpl-queue.h"
+
+#include "chpl-atomics.h"
+#include "chpl-linefile-support.h"
+#include "chpl-mem.h"
+#include "chpl-tasks.h"
+#include "error.h"
+
+#include <string.h>
+
+//
+// Each slot carries a sequence number that says whose turn it is: a
+// slot whose sequence equals an enqueue position is free for that
+// producer, a slot whose sequence is one past a dequeue position holds
+// that consumer's element.  After copying the element in or out, the
+// operation publishes the slot to the other side by advancing the
+// sequence, so the copy itself happens outside any shared state.
+//
+typedef struct chpl_queue_slot_s {
+  atomic_uint_least64_t seq;
+  // the element's bytes follow, within the same padded slot
+} chpl_queue_slot_t;
+
+struct chpl_queue_s {
+  uint64_t capMask;     // capacity - 1; capacity is a power of two
+  size_t eltSize;
+  size_t slotStride;    // slot header + element, padded to cache lines
+  unsigned char* slots;
+
+  // the producer and consumer cursors each get their own cache line so
+  // enqueues and dequeues don't false-share
+  CHPL_CACHELINE_ALIGNED atomic_uint_least64_t enqPos;
+  CHPL_CACHELINE_ALIGNED atomic_uint_least64_t deqPos;
+};
+
+static inline chpl_queue_slot_t* slotAt(chpl_queue_t* q, uint64_t pos) {
+  return (chpl_queue_slot_t*)
+         (q->slots + (pos & q->capMask) * q->slotStride);
+}
+
+static inline void* slotElt(chpl_queue_slot_t* slot) {
+  return (unsigned char*)slot + sizeof(chpl_queue_slot_t);
+}
+
+chpl_queue_t* chpl_queue_create(uint64_t capacity, size_t eltSize) {
+  chpl_queue_t* q;
+  uint64_t cap;
+
+  if (capacity == 0) {
+    chpl_internal_error("chpl_queue_create: zero capacity");
+  }
+
+  for (cap = 1; cap < capacity; cap <<= 1)
+    ;
+
+  q = chpl_mem_alloc(sizeof(chpl_queue_t), CHPL_RT_MD_QUEUE_DATA,
+                     0, CHPL_FILE_IDX_INTERNAL);
+  q->capMask = cap - 1;
+  q->eltSize = eltSize;
+  q->slotStride = (sizeof(chpl_queue_slot_t) + eltSize
+                   + CHPL_CACHE_LINE_SIZE - 1)
+                  / CHPL_CACHE_LINE_SIZE * CHPL_CACHE_LINE_SIZE;
+  q->slots = chpl_mem_allocMany(cap, q->slotStride, CHPL_RT_MD_QUEUE_DATA,
+                                0, CHPL_FILE_IDX_INTERNAL);
+
+  for (uint64_t i = 0; i < cap; i++) {
+    atomic_init_uint_least64_t(&slotAt(q, i)->seq, i);
+  }
+
+  atomic_init_uint_least64_t(&q->enqPos, 0);
+  atomic_init_uint_least64_t(&q->deqPos, 0);
+
+  return q;
+}
+
+void chpl_queue_destroy(chpl_queue_t* q) {
+  chpl_mem_free(q->slots, 0, CHPL_FILE_IDX_INTERNAL);
+  chpl_mem_free(q, 0, CHPL_FILE_IDX_INTERNAL);
+}
+
+chpl_bool chpl_queue_tryEnqueue(chpl_queue_t* q, const void* elt) {
+  uint64_t pos = atomic_load_explicit_uint_least64_t(&q->enqPos,
+                                                     memory_order_relaxed);
+
+  for (;;) {
+    chpl_queue_slot_t* slot = slotAt(q, pos);
+    uint64_t seq = atomic_load_explicit_uint_least64_t(&slot->seq,
+                                                       memory_order_acquire);
+
+    if (seq == pos) {
+      // the slot is free; try to claim this enqueue position
+      if (atomic_compare_exchange_weak_explicit_uint_least64_t(
+              &q->enqPos, &pos, pos + 1,
+              memory_order_relaxed, memory_order_relaxed)) {
+        memcpy(slotElt(slot), elt, q->eltSize);
+        atomic_store_explicit_uint_least64_t(&slot->seq, pos + 1,
+                                             memory_order_release);
+        return true;
+      }
+      // the CAS failure reloaded pos; retry with it
+    }
+    else if ((int64_t)(seq - pos) < 0) {
+      // the slot still holds an element from a lap ago: queue is full
+      return false;
+    }
+    else {
+      // another producer claimed this position; move to the front
+      pos = atomic_load_explicit_uint_least64_t(&q->enqPos,
+                                                memory_order_relaxed);
+    }
+  }
+}
+
+chpl_bool chpl_queue_tryDequeue(chpl_queue_t* q, void* elt) {
+  uint64_t pos = atomic_load_explicit_uint_least64_t(&q->deqPos,
+                                                     memory_order_relaxed);
+
+  for (;;) {
+    chpl_queue_slot_t* slot = slotAt(q, pos);
+    uint64_t seq = atomic_load_explicit_uint_least64_t(&slot->seq,
+                                                       memory_order_acquire);
+
+    if (seq == pos + 1) {
+      // the slot holds an element; try to claim this dequeue position
+      if (atomic_compare_exchange_weak_explicit_uint_least64_t(
+              &q->deqPos, &pos, pos + 1,
+              memory_order_relaxed, memory_order_relaxed)) {
+        memcpy(elt, slotElt(slot), q->eltSize);
+        // free the slot for the producer one lap ahead
+        atomic_store_explicit_uint_least64_t(&slot->seq,
+                                             pos + q->capMask + 1,
+                                             memory_order_release);
+        return true;
+      }
+    }
+    else if ((int64_t)(seq - (pos + 1)) < 0) {
+      // the slot hasn't been filled for this lap: queue is empty
+      return false;
+    }
+    else {
+      pos = atomic_load_explicit_uint_least64_t(&q->deqPos,
+                                                memory_order_relaxed);
+    }
+  }
+}
+
+void chpl_queue_enqueue(chpl_queue_t* q, const void* elt) {
+  while (!chpl_queue_tryEnqueue(q, elt)) {
+    chpl_task_yield();
+  }
+}
+
+void chpl_queue_dequeue(chpl_queue_t* q, void* elt) {
+  while (!chpl_queue_tryDequeue(q, elt)) {
+    chpl_task_yield();
+  }
+}
+
+uint64_t chpl_queue_size(chpl_queue_t* q) {
+  uint64_t enq = atomic_load_explicit_uint_least64_t(&q->enqPos,
+                                                     memory_order_relaxed);
+  uint64_t deq = atomic_load_explicit_uint_least64_t(&q->deqPos,
+                                                     memory_order_relaxed);
+  return enq - deq;
+}
+
+uint64_t chpl_queue_capacity(chpl_queue_t* q) {
+  return q->capMask + 1;
+}
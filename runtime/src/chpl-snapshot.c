@@ -0,0 +1,321 @@
+/*
+ * Copyright 2020-2021 Hewlett Packard Enterprise Development LP
+ * Copyright 2004-2019 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef CHPL_RT_UNIT_TEST
+#include "chplrt.h"
+#endif
+
+#include "chpl-snapshot.h"
+
+#include "chpl-atomics.h"
+#include "chpl-mem.h"
+#include "chpl-tasks.h"
+#include "error.h"
+#include "qio.h"
+
+#include <string.h>
+
+//
+// Snapshot file layout: an 8-byte magic, a format version, and a region
+// count, followed by each region as (base address, length, raw bytes).
+// The base address lets a restore tool rebuild region metadata even if
+// the registration order changes between runs.
+//
+#define SNAP_MAGIC   0x50414e534c504843ULL  // "CHPLSNAP", little-endian
+#define SNAP_VERSION 1
+
+typedef struct snap_region_s {
+  void*                 base;
+  size_t                len;
+  struct snap_region_s* next;
+} snap_region_t;
+
+typedef struct snap_copy_s {
+  void*               base;
+  size_t              len;
+  void*               data;
+  struct snap_copy_s* next;
+} snap_copy_t;
+
+typedef struct snap_op_s {
+  int64_t               handle;
+  char*                 path;
+  snap_copy_t*          copies;
+  uint32_t              numRegions;
+  chpl_snapshot_done_fn done;
+  void*                 doneArg;
+  atomic_int_least32_t  state;  // 0: streaming, 1: finished
+  int32_t               err;
+  struct snap_op_s*     next;
+} snap_op_t;
+
+typedef struct {
+  chpl_task_bundle_t task;
+  snap_op_t*         op;
+} snap_bundle_t;
+
+static snap_region_t*    snapRegions = NULL;
+static snap_op_t*        snapOps = NULL;
+static int64_t           snapNextHandle = 1;
+static atomic_spinlock_t snapLock;
+
+
+void chpl_snapshot_init(void) {
+  atomic_init_spinlock_t(&snapLock);
+}
+
+
+void chpl_snapshot_exit(void) {
+  while (1) {
+    int64_t handle;
+
+    atomic_lock_spinlock_t(&snapLock);
+    handle = (snapOps != NULL) ? snapOps->handle : 0;
+    atomic_unlock_spinlock_t(&snapLock);
+
+    if (handle == 0)
+      break;
+
+    (void) chpl_snapshot_wait(handle);
+  }
+}
+
+
+void chpl_snapshot_region_register(void* base, size_t len) {
+  snap_region_t* region =
+    (snap_region_t*) chpl_mem_alloc(sizeof(*region),
+                                    CHPL_RT_MD_IO_BUFFER, 0, 0);
+
+  region->base = base;
+  region->len = len;
+
+  atomic_lock_spinlock_t(&snapLock);
+  region->next = snapRegions;
+  snapRegions = region;
+  atomic_unlock_spinlock_t(&snapLock);
+}
+
+
+void chpl_snapshot_region_unregister(void* base) {
+  snap_region_t** prev;
+  snap_region_t* region = NULL;
+
+  atomic_lock_spinlock_t(&snapLock);
+  for (prev = &snapRegions; *prev != NULL; prev = &(*prev)->next) {
+    if ((*prev)->base == base) {
+      region = *prev;
+      *prev = region->next;
+      break;
+    }
+  }
+  atomic_unlock_spinlock_t(&snapLock);
+
+  if (region != NULL)
+    chpl_mem_free(region, 0, 0);
+}
+
+
+//
+// Stream one captured snapshot to disk; runs on a background task.
+//
+static void snapshot_stream(snap_op_t* op) {
+  qio_file_t* file = NULL;
+  qio_channel_t* chan = NULL;
+  qioerr err;
+
+  err = qio_file_open_access(&file, op->path, "w", 0, NULL);
+
+  if (err == 0) {
+    err = qio_channel_create(&chan, file, 0, 0, 1, 0, INT64_MAX, NULL);
+  }
+
+  if (err == 0) {
+    uint64_t hdr[2] = { SNAP_MAGIC,
+                        ((uint64_t) SNAP_VERSION << 32) | op->numRegions };
+
+    err = qio_channel_write_amt(false, chan, hdr, sizeof(hdr));
+  }
+
+  if (chan != NULL) {
+    snap_copy_t* copy;
+    qioerr closeErr;
+
+    for (copy = op->copies; copy != NULL && err == 0; copy = copy->next) {
+      uint64_t meta[2] = { (uint64_t) (uintptr_t) copy->base,
+                           (uint64_t) copy->len };
+
+      err = qio_channel_write_amt(false, chan, meta, sizeof(meta));
+      if (err == 0)
+        err = qio_channel_write_amt(false, chan, copy->data, copy->len);
+    }
+
+    closeErr = qio_channel_close(false, chan);
+    if (err == 0)
+      err = closeErr;
+    qio_channel_release(chan);
+  }
+
+  if (file != NULL) {
+    qioerr closeErr = qio_file_close(file);
+    if (err == 0)
+      err = closeErr;
+    qio_file_release(file);
+  }
+
+  while (op->copies != NULL) {
+    snap_copy_t* copy = op->copies;
+    op->copies = copy->next;
+    chpl_mem_free(copy->data, 0, 0);
+    chpl_mem_free(copy, 0, 0);
+  }
+
+  op->err = qio_err_to_int(err);
+  atomic_store_int_least32_t(&op->state, 1);
+
+  if (op->done != NULL)
+    op->done(op->handle, op->err, op->doneArg);
+}
+
+
+static void snapshot_task_wrapper(void* arg) {
+  snap_bundle_t* bundle = (snap_bundle_t*) arg;
+  snapshot_stream(bundle->op);
+}
+
+
+int64_t chpl_snapshot_begin(const char* path,
+                            chpl_snapshot_done_fn done, void* arg) {
+  snap_op_t* op = (snap_op_t*) chpl_mem_alloc(sizeof(*op),
+                                              CHPL_RT_MD_IO_BUFFER, 0, 0);
+  size_t pathLen = strlen(path) + 1;
+  snap_region_t* region;
+  snap_bundle_t bundle;
+
+  op->path = (char*) chpl_mem_allocMany(pathLen, sizeof(char),
+                                        CHPL_RT_MD_IO_BUFFER, 0, 0);
+  memcpy(op->path, path, pathLen);
+  op->copies = NULL;
+  op->numRegions = 0;
+  op->done = done;
+  op->doneArg = arg;
+  op->err = 0;
+  atomic_init_int_least32_t(&op->state, 0);
+
+  //
+  // Capture the registered regions.  This is the only part of a snapshot
+  // that pauses the caller, and it runs at memory speed; the disk traffic
+  // all happens on the background task.
+  //
+  atomic_lock_spinlock_t(&snapLock);
+
+  op->handle = snapNextHandle++;
+
+  for (region = snapRegions; region != NULL; region = region->next) {
+    snap_copy_t* copy =
+      (snap_copy_t*) chpl_mem_alloc(sizeof(*copy),
+                                    CHPL_RT_MD_IO_BUFFER, 0, 0);
+
+    copy->base = region->base;
+    copy->len = region->len;
+    copy->data = chpl_mem_allocMany(region->len, sizeof(char),
+                                    CHPL_RT_MD_IO_BUFFER, 0, 0);
+    memcpy(copy->data, region->base, region->len);
+    copy->next = op->copies;
+    op->copies = copy;
+    op->numRegions++;
+  }
+
+  op->next = snapOps;
+  snapOps = op;
+
+  atomic_unlock_spinlock_t(&snapLock);
+
+  memset(&bundle, 0, sizeof(bundle));
+  bundle.op = op;
+
+  chpl_task_startMovedTask(FID_NONE, snapshot_task_wrapper,
+                           &bundle, sizeof(bundle),
+                           c_sublocid_any, chpl_nullTaskID);
+
+  return op->handle;
+}
+
+
+static snap_op_t* snap_find(int64_t handle) {
+  snap_op_t* op;
+
+  for (op = snapOps; op != NULL; op = op->next) {
+    if (op->handle == handle)
+      break;
+  }
+
+  return op;
+}
+
+
+chpl_bool chpl_snapshot_test(int64_t handle) {
+  snap_op_t* op;
+  chpl_bool finished = true;
+
+  atomic_lock_spinlock_t(&snapLock);
+  op = snap_find(handle);
+  if (op != NULL)
+    finished = (atomic_load_int_least32_t(&op->state) == 1);
+  atomic_unlock_spinlock_t(&snapLock);
+
+  return finished;
+}
+
+
+int32_t chpl_snapshot_wait(int64_t handle) {
+  while (1) {
+    snap_op_t* op;
+    int32_t err;
+
+    atomic_lock_spinlock_t(&snapLock);
+
+    op = snap_find(handle);
+
+    if (op == NULL) {
+      atomic_unlock_spinlock_t(&snapLock);
+      return 0;
+    }
+
+    if (atomic_load_int_least32_t(&op->state) == 1) {
+      snap_op_t** prev;
+
+      for (prev = &snapOps; *prev != op; prev = &(*prev)->next)
+        ;
+      *prev = op->next;
+
+      atomic_unlock_spinlock_t(&snapLock);
+
+      err = op->err;
+      atomic_destroy_int_least32_t(&op->state);
+      chpl_mem_free(op->path, 0, 0);
+      chpl_mem_free(op, 0, 0);
+
+      return err;
+    }
+
+    atomic_unlock_spinlock_t(&snapLock);
+    chpl_task_yield();
+  }
+}
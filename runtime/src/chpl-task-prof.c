@@ -0,0 +1,396 @@
+/*
+ * Copyright 2020-2021 Hewlett Packard Enterprise Development LP
+ * Copyright 2004-2019 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//
+// Task profiling on the tasking callbacks.
+//
+// When enabled (CHPL_RT_TASK_PROF), the begin/end tasking callbacks
+// charge each completed task to its callsite (source file/line from the
+// task bundle): a task count, wall time, and -- on Linux, when perf
+// counters are available -- cycles, instructions, and LLC misses read
+// from a small per-thread perf event group.  Each node prints its table
+// at exit, sorted by cycles (wall time when counters are unavailable),
+// so the dominant task callsites can be found without external tooling.
+//
+// This is a sampling profiler, not an exact one.  The counters are per
+// thread, so a task that blocks and resumes on another thread cannot be
+// matched with its starting counter values; such tasks are dropped from
+// the counter columns (and reported as dropped).  Time a task spends
+// yielded is charged to whatever runs in its place.
+//
+
+#include "chplrt.h"
+
+#include "chpl-task-prof.h"
+
+#include "chpl-atomics.h"
+#include "chpl-comm.h"
+#include "chpl-env.h"
+#include "chpl-linefile-support.h"
+#include "chpl-mem.h"
+#include "chpl-tasks-callbacks.h"
+#include "chpl-thread-local-storage.h"
+#include "error.h"
+
+#include <inttypes.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#define TP_HAVE_PERF 1
+#endif
+
+#define TP_NUM_CTRS 3         // cycles, instructions, LLC misses
+#define TP_TABLE_SIZE 1024    // must be a power of 2
+
+typedef struct {
+  atomic_int_least16_t state;  // 0: free, 2: claimed and ready
+  int32_t ln;                  // task callsite line number
+  int32_t fn;                  // task callsite filename index
+  atomic_uint_least64_t count;
+  atomic_uint_least64_t nsecs;
+  atomic_uint_least64_t ctrs[TP_NUM_CTRS];
+} tp_entry_t;
+
+static int tp_enabled = 0;
+static tp_entry_t* tp_table = NULL;
+static atomic_uint_least64_t tp_dropped;
+static pthread_mutex_t tp_claim_lock = PTHREAD_MUTEX_INITIALIZER;
+
+#ifdef CHPL_TLS
+
+//
+// Per-thread state: the perf event group and the in-flight task sample.
+// A single slot suffices because a thread runs one task at a time; if
+// the task migrates before ending, the end event simply won't match.
+//
+typedef struct {
+  uint64_t id;
+  uint64_t t0;
+  uint64_t c0[TP_NUM_CTRS];
+  int valid;
+} tp_sample_t;
+
+static CHPL_TLS tp_sample_t tp_sample;
+
+#ifdef TP_HAVE_PERF
+
+static CHPL_TLS int tp_perf_fd = -2;  // -2: not yet opened, -1: unavailable
+static CHPL_TLS uint64_t tp_perf_ids[TP_NUM_CTRS];
+
+static int tp_perf_open_one(int group_fd, uint32_t type, uint64_t config,
+                            uint64_t* id) {
+  struct perf_event_attr attr;
+  int fd;
+
+  memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.type = type;
+  attr.config = config;
+  attr.disabled = (group_fd == -1);
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_ID;
+
+  fd = (int) syscall(__NR_perf_event_open, &attr, 0, -1, group_fd, 0);
+  if (fd >= 0 && id != NULL)
+    (void) ioctl(fd, PERF_EVENT_IOC_ID, id);
+  return fd;
+}
+
+static void tp_perf_open(void) {
+  int fd;
+
+  fd = tp_perf_open_one(-1, PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES,
+                        &tp_perf_ids[0]);
+  if (fd >= 0) {
+    if (tp_perf_open_one(fd, PERF_TYPE_HARDWARE,
+                         PERF_COUNT_HW_INSTRUCTIONS,
+                         &tp_perf_ids[1]) < 0 ||
+        tp_perf_open_one(fd, PERF_TYPE_HARDWARE,
+                         PERF_COUNT_HW_CACHE_MISSES,
+                         &tp_perf_ids[2]) < 0) {
+      close(fd);
+      fd = -1;
+    } else {
+      (void) ioctl(fd, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+  }
+
+  // Counters can be unavailable (perf_event_paranoid, VMs, ...); fall
+  // back to count and wall time only.
+  tp_perf_fd = (fd >= 0) ? fd : -1;
+}
+
+static void tp_perf_read(uint64_t ctrs[TP_NUM_CTRS]) {
+  //
+  // PERF_FORMAT_GROUP|PERF_FORMAT_ID layout: nr, then (value, id) pairs.
+  //
+  uint64_t buf[1 + 2 * TP_NUM_CTRS];
+  int i, c;
+
+  for (c = 0; c < TP_NUM_CTRS; c++)
+    ctrs[c] = 0;
+
+  if (tp_perf_fd == -2)
+    tp_perf_open();
+  if (tp_perf_fd < 0)
+    return;
+
+  if (read(tp_perf_fd, buf, sizeof(buf)) < (ssize_t) sizeof(buf[0]))
+    return;
+
+  for (i = 0; i < (int) buf[0] && i < TP_NUM_CTRS; i++) {
+    uint64_t val = buf[1 + 2 * i];
+    uint64_t id = buf[2 + 2 * i];
+    for (c = 0; c < TP_NUM_CTRS; c++) {
+      if (id == tp_perf_ids[c])
+        ctrs[c] = val;
+    }
+  }
+}
+
+#else
+
+static void tp_perf_read(uint64_t ctrs[TP_NUM_CTRS]) {
+  int c;
+  for (c = 0; c < TP_NUM_CTRS; c++)
+    ctrs[c] = 0;
+}
+
+#endif // TP_HAVE_PERF
+
+static uint64_t tp_now_ns(void) {
+  struct timespec ts;
+  if (clock_gettime(CLOCK_MONOTONIC, &ts) != 0)
+    return 0;
+  return (uint64_t) ts.tv_sec * UINT64_C(1000000000) + (uint64_t) ts.tv_nsec;
+}
+
+static void tp_record(int32_t ln, int32_t fn, uint64_t nsecs,
+                      const uint64_t ctrs[TP_NUM_CTRS]) {
+  uint32_t h;
+  int i, c, probes;
+
+  h = (uint32_t) ln;
+  h = h * 31 + (uint32_t) fn;
+  i = h & (TP_TABLE_SIZE - 1);
+
+  for (probes = 0; probes < TP_TABLE_SIZE; probes++) {
+    tp_entry_t* e = &tp_table[i];
+    int_least16_t state = atomic_load_int_least16_t(&e->state);
+
+    if (state == 2 && e->ln == ln && e->fn == fn) {
+      break;
+    }
+
+    if (state != 2) {
+      // Probably free; claim it under the lock, where we can re-check.
+      pthread_mutex_lock(&tp_claim_lock);
+      state = atomic_load_int_least16_t(&e->state);
+      if (state == 0) {
+        e->ln = ln;
+        e->fn = fn;
+        atomic_store_int_least16_t(&e->state, 2);
+        pthread_mutex_unlock(&tp_claim_lock);
+        break;
+      }
+      pthread_mutex_unlock(&tp_claim_lock);
+      // Someone else claimed it; re-examine this slot from the top.
+      probes--;
+      continue;
+    }
+
+    i = (i + 1) & (TP_TABLE_SIZE - 1);
+  }
+
+  if (probes >= TP_TABLE_SIZE) {
+    // Table is full of other callsites; we can only count the loss.
+    (void) atomic_fetch_add_explicit_uint_least64_t(&tp_dropped, 1,
+                                                    memory_order_relaxed);
+    return;
+  }
+
+  (void) atomic_fetch_add_explicit_uint_least64_t(&tp_table[i].count, 1,
+                                                  memory_order_relaxed);
+  (void) atomic_fetch_add_explicit_uint_least64_t(&tp_table[i].nsecs, nsecs,
+                                                  memory_order_relaxed);
+  for (c = 0; c < TP_NUM_CTRS; c++) {
+    (void) atomic_fetch_add_explicit_uint_least64_t(&tp_table[i].ctrs[c],
+                                                    ctrs[c],
+                                                    memory_order_relaxed);
+  }
+}
+
+static void tp_task_begin(const chpl_task_cb_info_t* info) {
+  if (info->info_kind != chpl_task_cb_info_kind_full)
+    return;
+
+  tp_sample.id = info->iu.full.id;
+  tp_sample.t0 = tp_now_ns();
+  tp_perf_read(tp_sample.c0);
+  tp_sample.valid = 1;
+}
+
+static void tp_task_end(const chpl_task_cb_info_t* info) {
+  uint64_t ctrs[TP_NUM_CTRS];
+  uint64_t nsecs;
+  int c;
+
+  if (info->info_kind != chpl_task_cb_info_kind_full)
+    return;
+
+  if (!tp_sample.valid || tp_sample.id != info->iu.full.id) {
+    // The task began on a different thread; drop the sample.
+    (void) atomic_fetch_add_explicit_uint_least64_t(&tp_dropped, 1,
+                                                    memory_order_relaxed);
+    tp_sample.valid = 0;
+    return;
+  }
+
+  tp_sample.valid = 0;
+
+  nsecs = tp_now_ns() - tp_sample.t0;
+  tp_perf_read(ctrs);
+  for (c = 0; c < TP_NUM_CTRS; c++) {
+    ctrs[c] = (ctrs[c] >= tp_sample.c0[c]) ? ctrs[c] - tp_sample.c0[c] : 0;
+  }
+
+  tp_record(info->iu.full.lineno, info->iu.full.filename, nsecs, ctrs);
+}
+
+static int tp_cmp_entries(const void* a, const void* b) {
+  const tp_entry_t* ea = *(tp_entry_t* const*) a;
+  const tp_entry_t* eb = *(tp_entry_t* const*) b;
+  uint64_t ka = atomic_load_uint_least64_t((atomic_uint_least64_t*)
+                                           &ea->ctrs[0]);
+  uint64_t kb = atomic_load_uint_least64_t((atomic_uint_least64_t*)
+                                           &eb->ctrs[0]);
+
+  // Sort by cycles; fall back to wall time when counters were unavailable.
+  if (ka == 0 && kb == 0) {
+    ka = atomic_load_uint_least64_t((atomic_uint_least64_t*) &ea->nsecs);
+    kb = atomic_load_uint_least64_t((atomic_uint_least64_t*) &eb->nsecs);
+  }
+
+  return (ka < kb) ? 1 : (ka > kb) ? -1 : 0;
+}
+
+static void tp_dump(void) {
+  tp_entry_t** ents;
+  int i, n;
+
+  if (!tp_enabled || tp_table == NULL)
+    return;
+
+  ents = chpl_mem_allocMany(TP_TABLE_SIZE, sizeof(ents[0]),
+                            CHPL_RT_MD_TASK_LAYER_UNSPEC, 0, 0);
+  n = 0;
+  for (i = 0; i < TP_TABLE_SIZE; i++) {
+    if (atomic_load_int_least16_t(&tp_table[i].state) == 2)
+      ents[n++] = &tp_table[i];
+  }
+  qsort(ents, n, sizeof(ents[0]), tp_cmp_entries);
+
+  fprintf(stderr, "task profile for node %d:\n", (int) chpl_nodeID);
+  fprintf(stderr, "%12s %15s %15s %15s %12s  %s\n",
+          "tasks", "secs", "cycles", "instructions", "LLC-misses",
+          "callsite");
+
+  for (i = 0; i < n; i++) {
+    tp_entry_t* e = ents[i];
+    const char* file = chpl_lookupFilename(e->fn);
+
+    if (file == NULL)
+      file = "<unknown>";
+
+    fprintf(stderr,
+            "%12" PRIu64 " %15.3f %15" PRIu64 " %15" PRIu64
+            " %12" PRIu64 "  %s:%" PRId32 "\n",
+            (uint64_t) atomic_load_uint_least64_t(&e->count),
+            (double) atomic_load_uint_least64_t(&e->nsecs) / 1e9,
+            (uint64_t) atomic_load_uint_least64_t(&e->ctrs[0]),
+            (uint64_t) atomic_load_uint_least64_t(&e->ctrs[1]),
+            (uint64_t) atomic_load_uint_least64_t(&e->ctrs[2]),
+            file, e->ln);
+  }
+
+  {
+    uint64_t dropped = atomic_load_uint_least64_t(&tp_dropped);
+    if (dropped != 0) {
+      fprintf(stderr,
+              "  (%" PRIu64 " task(s) dropped: migrated across threads "
+              "or table full)\n", dropped);
+    }
+  }
+
+  chpl_mem_free(ents, 0, 0);
+}
+
+void chpl_task_prof_init(void) {
+  int i, c;
+
+  if (!chpl_env_rt_flag(CHPL_ENV_RT_TASK_PROF))
+    return;
+
+  tp_table = chpl_mem_allocManyZero(TP_TABLE_SIZE, sizeof(tp_entry_t),
+                                    CHPL_RT_MD_TASK_LAYER_UNSPEC, 0, 0);
+  for (i = 0; i < TP_TABLE_SIZE; i++) {
+    atomic_init_int_least16_t(&tp_table[i].state, 0);
+    atomic_init_uint_least64_t(&tp_table[i].count, 0);
+    atomic_init_uint_least64_t(&tp_table[i].nsecs, 0);
+    for (c = 0; c < TP_NUM_CTRS; c++)
+      atomic_init_uint_least64_t(&tp_table[i].ctrs[c], 0);
+  }
+  atomic_init_uint_least64_t(&tp_dropped, 0);
+
+  if (chpl_task_install_callback(chpl_task_cb_event_kind_begin,
+                                 chpl_task_cb_info_kind_full,
+                                 tp_task_begin) != 0 ||
+      chpl_task_install_callback(chpl_task_cb_event_kind_end,
+                                 chpl_task_cb_info_kind_full,
+                                 tp_task_end) != 0) {
+    chpl_warning("cannot install task profiling callbacks", 0, 0);
+    return;
+  }
+
+  if (atexit(tp_dump) != 0)
+    chpl_warning("cannot register task profile dump", 0, 0);
+
+  tp_enabled = 1;
+}
+
+#else // no CHPL_TLS
+
+void chpl_task_prof_init(void) {
+  if (chpl_env_rt_flag(CHPL_ENV_RT_TASK_PROF))
+    chpl_warning("task profiling requires compiler thread-local storage "
+                 "support", 0, 0);
+}
+
+#endif // CHPL_TLS
@@ -0,0 +1,168 @@
+/*
+ * Copyright 2020-2021 Hewlett Packard Enterprise Development LP
+ * Copyright 2004-2019 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "chplrt.h"
+
+#include "chpl-taskgraph.h"
+
+#include "chpl-mem.h"
+#include "chpl-tasks.h"
+#include "chplexit.h"
+#include "error.h"
+
+//
+// Ready nodes that cannot continue on the finishing task are spawned
+// through the tasking layer.  The bundle carries just the node; the
+// tasking layer copies it, so it can live on the spawner's stack.
+//
+typedef struct {
+  chpl_task_bundle_t task;
+  chpl_taskgraph_node_t* node;
+} tg_bundle_t;
+
+static void tg_run(chpl_taskgraph_node_t* node);
+
+static
+void tg_task_wrapper(void* arg) {
+  tg_bundle_t* bundle = (tg_bundle_t*) arg;
+  tg_run(bundle->node);
+}
+
+static
+void tg_spawn(chpl_taskgraph_node_t* node) {
+  tg_bundle_t bundle;
+
+  memset(&bundle, 0, sizeof(bundle));
+  bundle.node = node;
+
+  chpl_task_startMovedTask(FID_NONE, tg_task_wrapper,
+                           &bundle, sizeof(bundle),
+                           node->subloc, chpl_nullTaskID);
+}
+
+//
+// Run a ready node, notify its successors, and continue with the
+// first successor made ready, so dependence chains execute without
+// re-entering the spawn path.
+//
+static
+void tg_run(chpl_taskgraph_node_t* node) {
+  while (node != NULL) {
+    chpl_taskgraph_t* graph = node->graph;
+    chpl_taskgraph_node_t* next = NULL;
+    int32_t i;
+
+    (*node->fn)(node->arg);
+
+    for (i = 0; i < node->numSuccs; i++) {
+      chpl_taskgraph_node_t* succ = node->succs[i];
+      if (atomic_fetch_sub_int_least32_t(&succ->waiting, 1) == 1) {
+        if (next == NULL)
+          next = succ;
+        else
+          tg_spawn(succ);
+      }
+    }
+
+    if (node->succs != NULL)
+      chpl_mem_free(node->succs, 0, 0);
+    atomic_destroy_int_least32_t(&node->waiting);
+    chpl_mem_free(node, 0, 0);
+
+    (void) atomic_fetch_sub_int_least32_t(&graph->unfinished, 1);
+
+    node = next;
+  }
+}
+
+chpl_taskgraph_t* chpl_taskgraph_create(void) {
+  chpl_taskgraph_t* graph;
+
+  graph = (chpl_taskgraph_t*)
+          chpl_mem_alloc(sizeof(*graph),
+                         CHPL_RT_MD_TASK_POOL_DESC, 0, 0);
+  atomic_init_int_least32_t(&graph->unfinished, 0);
+  return graph;
+}
+
+chpl_taskgraph_node_t* chpl_taskgraph_node(chpl_taskgraph_t* graph,
+                                           chpl_fn_p fn, void* arg,
+                                           int32_t numDeps) {
+  chpl_taskgraph_node_t* node;
+
+  if (numDeps < 0)
+    chpl_internal_error("taskgraph: negative dependence count");
+
+  node = (chpl_taskgraph_node_t*)
+         chpl_mem_alloc(sizeof(*node), CHPL_RT_MD_TASK_DESC, 0, 0);
+  node->fn = fn;
+  node->arg = arg;
+  node->subloc = chpl_task_getRequestedSubloc();
+  node->graph = graph;
+  // the +1 guard keeps the node from running before start()
+  atomic_init_int_least32_t(&node->waiting, numDeps + 1);
+  node->succs = NULL;
+  node->numSuccs = 0;
+  node->capSuccs = 0;
+
+  (void) atomic_fetch_add_int_least32_t(&graph->unfinished, 1);
+
+  return node;
+}
+
+void chpl_taskgraph_edge(chpl_taskgraph_node_t* pred,
+                         chpl_taskgraph_node_t* succ) {
+  if (pred->numSuccs == pred->capSuccs) {
+    int32_t newCap = (pred->capSuccs == 0) ? 4 : 2 * pred->capSuccs;
+    chpl_taskgraph_node_t** newSuccs;
+
+    newSuccs = (chpl_taskgraph_node_t**)
+               chpl_mem_allocMany(newCap, sizeof(newSuccs[0]),
+                                  CHPL_RT_MD_TASK_DESC_LINK, 0, 0);
+    if (pred->succs != NULL) {
+      chpl_memcpy(newSuccs, pred->succs,
+                  pred->numSuccs * sizeof(newSuccs[0]));
+      chpl_mem_free(pred->succs, 0, 0);
+    }
+    pred->succs = newSuccs;
+    pred->capSuccs = newCap;
+  }
+
+  pred->succs[pred->numSuccs++] = succ;
+}
+
+void chpl_taskgraph_start(chpl_taskgraph_node_t* node) {
+  // drop the creation guard; the node runs once its real
+  // dependences are also satisfied
+  if (atomic_fetch_sub_int_least32_t(&node->waiting, 1) == 1)
+    tg_spawn(node);
+}
+
+void chpl_taskgraph_wait(chpl_taskgraph_t* graph) {
+  while (atomic_load_int_least32_t(&graph->unfinished) != 0)
+    chpl_task_yield();
+}
+
+void chpl_taskgraph_destroy(chpl_taskgraph_t* graph) {
+  if (atomic_load_int_least32_t(&graph->unfinished) != 0)
+    chpl_internal_error("taskgraph: destroyed before wait completed");
+  atomic_destroy_int_least32_t(&graph->unfinished);
+  chpl_mem_free(graph, 0, 0);
+}
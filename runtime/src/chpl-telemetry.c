@@ -0,0 +1,242 @@
+/*
+ * Copyright 2020-2021 Hewlett Packard Enterprise Development LP
+ * Copyright 2004-2019 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "chplrt.h"
+
+#include "chpl-telemetry.h"
+
+#include "chpl-comm.h"
+#include "chpl-comm-diags.h"
+#include "chpl-env.h"
+#include "chpl-tasks.h"
+#include "chplmemtrack.h"
+#include "error.h"
+
+#include <errno.h>
+#include <netinet/in.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <time.h>
+#include <unistd.h>
+
+//
+// Every diagnostic the runtime keeps today prints at exit, which is no
+// help for observing a long job in flight.  This service thread listens
+// on a per-locale socket and answers each connection with one report,
+// then closes: the scrape model monitoring systems already speak.
+//
+// CHPL_RT_TELEMETRY=true enables the service.  By default it listens on
+// a Unix socket named <CHPL_RT_TELEMETRY_SOCKET>.<nodeID> (default
+// prefix /tmp/chpl-telemetry); setting CHPL_RT_TELEMETRY_PORT=<port>
+// listens on TCP port <port>+<nodeID> instead, for scraping across
+// hosts.
+//
+// Report format, all fields little-endian host order, fixed width:
+//
+//   uint64 magic "CHPLTELE"
+//   uint32 version
+//   int32  nodeID
+//   uint64 timestamp (seconds since the epoch)
+//   uint32 numQueuedTasks
+//   int32  numBlockedTasks (-1 if not maintained)
+//   uint32 numThreads
+//   uint32 numIdleThreads
+//   uint64 memoryUsed (0 unless --memTrack)
+//   uint32 commDiagsLen (bytes that follow)
+//   chpl_commDiagnostics, as declared in chpl-comm-diags.h
+//
+// The explicit length field lets scrapers built against one runtime
+// version skip over a differently-sized diagnostics block from another.
+//
+#define TELEMETRY_MAGIC   0x454c45544c504843ULL  // "CHPLTELE", little-endian
+#define TELEMETRY_VERSION 1
+
+typedef struct {
+  uint64_t magic;
+  uint32_t version;
+  int32_t  nodeID;
+  uint64_t timestamp;
+  uint32_t numQueuedTasks;
+  int32_t  numBlockedTasks;
+  uint32_t numThreads;
+  uint32_t numIdleThreads;
+  uint64_t memoryUsed;
+  uint32_t commDiagsLen;
+} telemetry_header_t;
+
+static chpl_bool telemetry_on = false;
+static int listenFd = -1;
+static char sockPath[108];  // matches sizeof(struct sockaddr_un.sun_path)
+static pthread_t serverThread;
+
+static void telemetry_fill_header(telemetry_header_t* hdr) {
+  memset(hdr, 0, sizeof(*hdr));
+  hdr->magic = TELEMETRY_MAGIC;
+  hdr->version = TELEMETRY_VERSION;
+  hdr->nodeID = (int32_t) chpl_nodeID;
+  hdr->timestamp = (uint64_t) time(NULL);
+  hdr->numQueuedTasks = chpl_task_getNumQueuedTasks();
+  hdr->numBlockedTasks = chpl_task_getNumBlockedTasks();
+  hdr->numThreads = chpl_task_getNumThreads();
+  hdr->numIdleThreads = chpl_task_getNumIdleThreads();
+  hdr->memoryUsed = chpl_memTrack ? chpl_memoryUsed(0, 0) : 0;
+  hdr->commDiagsLen = (uint32_t) sizeof(chpl_commDiagnostics);
+}
+
+static void telemetry_write_all(int fd, const void* buf, size_t len) {
+  const char* p = (const char*) buf;
+  while (len > 0) {
+    ssize_t n = write(fd, p, len);
+    if (n < 0) {
+      if (errno == EINTR)
+        continue;
+      return;  // the scraper went away; nothing to clean up
+    }
+    p += n;
+    len -= (size_t) n;
+  }
+}
+
+static void* telemetry_server(void* arg) {
+  while (true) {
+    int fd = accept(listenFd, NULL, NULL);
+    if (fd < 0) {
+      if (errno == EINTR)
+        continue;
+      break;  // listen socket closed at exit (or a real error); stop
+    }
+
+    {
+      telemetry_header_t hdr;
+      chpl_commDiagnostics cd;
+
+      telemetry_fill_header(&hdr);
+      chpl_comm_getDiagnosticsHere(&cd);
+
+      telemetry_write_all(fd, &hdr, sizeof(hdr));
+      telemetry_write_all(fd, &cd, sizeof(cd));
+    }
+
+    (void) close(fd);
+  }
+
+  return NULL;
+}
+
+static int telemetry_listen_tcp(int64_t basePort) {
+  struct sockaddr_in addr;
+  int fd;
+  int one = 1;
+
+  if ((fd = socket(AF_INET, SOCK_STREAM, 0)) < 0)
+    return -1;
+
+  (void) setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_ANY);
+  addr.sin_port = htons((uint16_t) (basePort + chpl_nodeID));
+
+  if (bind(fd, (struct sockaddr*) &addr, sizeof(addr)) != 0
+      || listen(fd, 8) != 0) {
+    (void) close(fd);
+    return -1;
+  }
+
+  return fd;
+}
+
+static int telemetry_listen_unix(const char* prefix) {
+  struct sockaddr_un addr;
+  int fd;
+
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  if (snprintf(addr.sun_path, sizeof(addr.sun_path), "%s.%d",
+               prefix, (int) chpl_nodeID) >= (int) sizeof(addr.sun_path)) {
+    return -1;
+  }
+
+  (void) unlink(addr.sun_path);
+
+  if ((fd = socket(AF_UNIX, SOCK_STREAM, 0)) < 0)
+    return -1;
+
+  if (bind(fd, (struct sockaddr*) &addr, sizeof(addr)) != 0
+      || listen(fd, 8) != 0) {
+    (void) close(fd);
+    return -1;
+  }
+
+  strncpy(sockPath, addr.sun_path, sizeof(sockPath) - 1);
+  return fd;
+}
+
+void chpl_telemetry_init(void) {
+  int64_t port;
+
+  if (!chpl_env_rt_get_bool("TELEMETRY", false))
+    return;
+
+  port = chpl_env_rt_get_int("TELEMETRY_PORT", 0);
+  if (port > 0) {
+    listenFd = telemetry_listen_tcp(port);
+  } else {
+    const char* prefix = chpl_env_rt_get("TELEMETRY_SOCKET",
+                                         "/tmp/chpl-telemetry");
+    listenFd = telemetry_listen_unix(prefix);
+  }
+
+  if (listenFd < 0) {
+    chpl_warning("cannot create telemetry socket; telemetry disabled", 0, 0);
+    return;
+  }
+
+  if (pthread_create(&serverThread, NULL, telemetry_server, NULL) != 0) {
+    chpl_warning("cannot create telemetry thread; telemetry disabled", 0, 0);
+    (void) close(listenFd);
+    listenFd = -1;
+    return;
+  }
+  (void) pthread_detach(serverThread);
+
+  telemetry_on = true;
+}
+
+void chpl_telemetry_exit(void) {
+  if (!telemetry_on)
+    return;
+
+  telemetry_on = false;
+
+  //
+  // Closing the listen socket unblocks the server thread's accept();
+  // it's detached, so there's nothing to join.
+  //
+  (void) close(listenFd);
+  listenFd = -1;
+
+  if (sockPath[0] != '\0')
+    (void) unlink(sockPath);
+}
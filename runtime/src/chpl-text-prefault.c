@@ -0,0 +1,144 @@
+/*
+ * Copyright 2020-2021 Hewlett Packard Enterprise Development LP
+ * Copyright 2004-2019 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "chplrt.h"
+
+#include "chpl-text-prefault.h"
+
+#include "chpl-env.h"
+#include "error.h"
+
+#ifdef __linux__
+
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+//
+// The executable's text mapping, from /proc/self/maps: the r-xp
+// mapping backed by the file /proc/self/exe points to.
+//
+static chpl_bool findTextSegment(uintptr_t* base, size_t* len) {
+  char exe[PATH_MAX];
+  char line[PATH_MAX + 128];
+  chpl_bool found = false;
+  FILE* maps;
+  ssize_t n;
+
+  n = readlink("/proc/self/exe", exe, sizeof(exe) - 1);
+  if (n <= 0) {
+    return false;
+  }
+  exe[n] = '\0';
+
+  maps = fopen("/proc/self/maps", "r");
+  if (maps == NULL) {
+    return false;
+  }
+
+  while (fgets(line, sizeof(line), maps) != NULL) {
+    unsigned long lo, hi, off;
+    char perms[8];
+    char path[PATH_MAX];
+
+    if (sscanf(line, "%lx-%lx %7s %lx %*s %*s %s",
+               &lo, &hi, perms, &off, path) == 5
+        && strcmp(perms, "r-xp") == 0
+        && strcmp(path, exe) == 0) {
+      *base = (uintptr_t) lo;
+      *len = (size_t) (hi - lo);
+      found = true;
+      break;
+    }
+  }
+
+  fclose(maps);
+  return found;
+}
+
+void chpl_text_prefault_init(void) {
+  uintptr_t base;
+  size_t len;
+  size_t pageSize;
+  volatile const unsigned char* text;
+
+  if (!chpl_env_rt_get_bool("TEXT_PREFAULT", false)) {
+    return;
+  }
+
+  if (!findTextSegment(&base, &len)) {
+    chpl_warning("cannot locate text segment; not prefaulting", 0, 0);
+    return;
+  }
+
+  pageSize = (size_t) sysconf(_SC_PAGESIZE);
+  text = (volatile const unsigned char*) base;
+
+  //
+  // Both pieces of advice are best-effort: hugepage backing for
+  // file-backed text depends on kernel support (and is simply refused
+  // where unsupported), and the readahead hint batches the filesystem
+  // reads the touches below would otherwise issue one page at a time.
+  //
+#ifdef MADV_HUGEPAGE
+  (void) madvise((void*) base, len, MADV_HUGEPAGE);
+#endif
+  (void) madvise((void*) base, len, MADV_WILLNEED);
+
+  //
+  // Touch profile-listed pages first, so the hot path recorded by an
+  // earlier run is resident before the sweep gets to the rest.
+  //
+  const char* profPath = chpl_env_rt_get("TEXT_PREFAULT_PROFILE", NULL);
+  if (profPath != NULL) {
+    FILE* prof = fopen(profPath, "r");
+    if (prof == NULL) {
+      chpl_warning("cannot read CHPL_RT_TEXT_PREFAULT_PROFILE; "
+                   "prefaulting sequentially only", 0, 0);
+    } else {
+      char line[64];
+      while (fgets(line, sizeof(line), prof) != NULL) {
+        unsigned long off = strtoul(line, NULL, 16);
+        if (off < len) {
+          (void) text[off - off % pageSize];
+        }
+      }
+      fclose(prof);
+    }
+  }
+
+  // one streaming pass over the whole segment
+  for (size_t off = 0; off < len; off += pageSize) {
+    (void) text[off];
+  }
+}
+
+#else
+
+void chpl_text_prefault_init(void) {
+  if (chpl_env_rt_get_bool("TEXT_PREFAULT", false)) {
+    chpl_warning("text prefault is only supported on Linux", 0, 0);
+  }
+}
+
+#endif
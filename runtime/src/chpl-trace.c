@@ -0,0 +1,256 @@
+/*
+ * Copyright 2020-2021 Hewlett Packard Enterprise Development LP
+ * Copyright 2004-2019 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//
+// Distributed tracing on the tasking and comm callbacks.
+//
+// See chpl-trace.h for the model.  The recording side is deliberately
+// dumb: claim a ring slot with one atomic increment and fill it in.
+// Overwriting the oldest events under overflow (and the theoretical
+// tearing of a slot lapped while being written) is the price of never
+// blocking the traced program; the dump reports how much was dropped.
+//
+
+#include "chplrt.h"
+
+#include "chpl-trace.h"
+
+#include "chpl-atomics.h"
+#include "chpl-comm.h"
+#include "chpl-comm-callbacks.h"
+#include "chpl-env.h"
+#include "chpl-linefile-support.h"
+#include "chpl-mem.h"
+#include "chpl-tasks.h"
+#include "chpl-tasks-callbacks.h"
+#include "error.h"
+
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+typedef enum {
+  ev_spawn,          // a new span was stamped into a bundle
+  ev_task_begin,
+  ev_task_end,
+  ev_put,
+  ev_get,
+  ev_executeOn,
+} trace_ev_kind_t;
+
+static const char* const ev_names[] = {
+  "spawn", "task_begin", "task_end", "put", "get", "executeOn",
+};
+
+typedef struct {
+  uint64_t ns;       // CLOCK_REALTIME
+  uint64_t span;
+  uint64_t parent;   // spawn events only; 0 elsewhere
+  uint64_t size;     // comm events: payload bytes; executeOn: arg bytes
+  int32_t  kind;     // trace_ev_kind_t
+  int32_t  node;     // comm events: remote node; else -1
+  int32_t  lineno;
+  int32_t  fileno;
+} trace_ev_t;
+
+static int trace_on = 0;
+static trace_ev_t* trace_ring = NULL;
+static uint64_t trace_ring_mask;     // ring size - 1; size is a power of 2
+static atomic_uint_least64_t trace_claimed;
+static atomic_uint_least64_t trace_next_span;
+static const char* trace_prefix;
+
+static uint64_t trace_now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_REALTIME, &ts);
+  return (uint64_t) ts.tv_sec * 1000000000ULL + (uint64_t) ts.tv_nsec;
+}
+
+static void trace_record(trace_ev_kind_t kind, uint64_t span, uint64_t parent,
+                         uint64_t size, int32_t node,
+                         int32_t lineno, int32_t fileno) {
+  uint64_t i = atomic_fetch_add_uint_least64_t(&trace_claimed, 1);
+  trace_ev_t* ev = &trace_ring[i & trace_ring_mask];
+
+  ev->ns = trace_now_ns();
+  ev->span = span;
+  ev->parent = parent;
+  ev->size = size;
+  ev->kind = (int32_t) kind;
+  ev->node = node;
+  ev->lineno = lineno;
+  ev->fileno = fileno;
+}
+
+//
+// Span IDs: the locale in the high bits, a counter below, so every
+// locale can mint IDs without coordination and a merged trace never
+// collides.  Span 0 means "untraced".
+//
+static uint64_t trace_mint_span(void) {
+  return ((uint64_t) (chpl_nodeID + 1) << 40)
+         | atomic_fetch_add_uint_least64_t(&trace_next_span, 1);
+}
+
+void chpl_trace_stamp_bundle(struct chpl_task_bundle* b) {
+  if (!trace_on) {
+    b->trace_span = 0;
+    return;
+  }
+
+  uint64_t parent = chpl_task_getTraceSpan();
+  b->trace_span = trace_mint_span();
+  trace_record(ev_spawn, b->trace_span, parent, 0, -1,
+               b->lineno, b->filename);
+}
+
+static void trace_task_cb(const chpl_task_cb_info_t* info) {
+  trace_ev_kind_t kind;
+
+  if (info->event_kind == chpl_task_cb_event_kind_begin) {
+    kind = ev_task_begin;
+  } else {
+    kind = ev_task_end;
+  }
+
+  trace_record(kind, chpl_task_getTraceSpan(), 0, 0, -1,
+               info->iu.full.lineno, info->iu.full.filename);
+}
+
+static void trace_comm_cb(const chpl_comm_cb_info_t* info) {
+  switch (info->event_kind) {
+    case chpl_comm_cb_event_kind_put:
+    case chpl_comm_cb_event_kind_put_nb:
+      trace_record(ev_put, chpl_task_getTraceSpan(), 0,
+                   info->iu.comm.size, info->remoteNodeID,
+                   info->iu.comm.lineno, info->iu.comm.filename);
+      break;
+    case chpl_comm_cb_event_kind_get:
+    case chpl_comm_cb_event_kind_get_nb:
+      trace_record(ev_get, chpl_task_getTraceSpan(), 0,
+                   info->iu.comm.size, info->remoteNodeID,
+                   info->iu.comm.lineno, info->iu.comm.filename);
+      break;
+    case chpl_comm_cb_event_kind_put_strd:
+      trace_record(ev_put, chpl_task_getTraceSpan(), 0,
+                   0, info->remoteNodeID,
+                   info->iu.comm_strd.lineno, info->iu.comm_strd.filename);
+      break;
+    case chpl_comm_cb_event_kind_get_strd:
+      trace_record(ev_get, chpl_task_getTraceSpan(), 0,
+                   0, info->remoteNodeID,
+                   info->iu.comm_strd.lineno, info->iu.comm_strd.filename);
+      break;
+    case chpl_comm_cb_event_kind_executeOn:
+    case chpl_comm_cb_event_kind_executeOn_nb:
+    case chpl_comm_cb_event_kind_executeOn_fast:
+      {
+        //
+        // The on-stmt's span propagation point: the comm layers fire
+        // this callback before sending the active message, with the
+        // live on-bundle in hand, so the span stamped here rides to
+        // the remote side in the bundle bytes the layer transmits.
+        //
+        chpl_comm_on_bundle_t* on = (chpl_comm_on_bundle_t*)
+                                    info->iu.executeOn.arg;
+        chpl_task_bundle_t* b = chpl_comm_on_bundle_task_bundle(on);
+        uint64_t parent = chpl_task_getTraceSpan();
+        b->trace_span = trace_mint_span();
+        trace_record(ev_executeOn, b->trace_span, parent,
+                     info->iu.executeOn.arg_size, info->remoteNodeID,
+                     info->iu.executeOn.lineno,
+                     info->iu.executeOn.filename);
+      }
+      break;
+    default:
+      break;
+  }
+}
+
+void chpl_trace_init(void) {
+  uint64_t nEvents, size;
+
+  if (!chpl_env_rt_get_bool("TRACE", false)) {
+    return;
+  }
+
+  nEvents = chpl_env_rt_get_size("TRACE_EVENTS", 1UL << 20);
+  for (size = 1; size < nEvents; size <<= 1)
+    ;
+  trace_ring = chpl_mem_allocManyZero(size, sizeof(trace_ev_t),
+                                      CHPL_RT_MD_TRACE_BUFFER,
+                                      0, CHPL_FILE_IDX_INTERNAL);
+  trace_ring_mask = size - 1;
+  atomic_init_uint_least64_t(&trace_claimed, 0);
+  atomic_init_uint_least64_t(&trace_next_span, 1);
+  trace_prefix = chpl_env_rt_get("TRACE_FILE", "chpl-trace");
+
+  chpl_task_install_callback(chpl_task_cb_event_kind_begin,
+                             chpl_task_cb_info_kind_full, trace_task_cb);
+  chpl_task_install_callback(chpl_task_cb_event_kind_end,
+                             chpl_task_cb_info_kind_full, trace_task_cb);
+  for (int k = 0; k < chpl_comm_cb_num_event_kinds; k++) {
+    chpl_comm_install_callback((chpl_comm_cb_event_kind_t) k,
+                               trace_comm_cb);
+  }
+
+  trace_on = 1;
+}
+
+void chpl_trace_exit(void) {
+  char path[1024];
+  FILE* out;
+  uint64_t claimed, first, size;
+
+  if (!trace_on) {
+    return;
+  }
+  trace_on = 0;
+
+  claimed = atomic_load_uint_least64_t(&trace_claimed);
+  size = trace_ring_mask + 1;
+  first = (claimed > size) ? claimed - size : 0;
+
+  snprintf(path, sizeof(path), "%s.%d.jsonl", trace_prefix,
+           (int) chpl_nodeID);
+  out = fopen(path, "w");
+  if (out == NULL) {
+    chpl_warning("cannot write trace dump", 0, 0);
+    return;
+  }
+
+  fprintf(out, "{\"node\":%d,\"events\":%" PRIu64 ",\"dropped\":%" PRIu64
+               "}\n",
+          (int) chpl_nodeID, claimed, first);
+
+  for (uint64_t i = first; i < claimed; i++) {
+    const trace_ev_t* ev = &trace_ring[i & trace_ring_mask];
+    fprintf(out, "{\"ns\":%" PRIu64 ",\"kind\":\"%s\",\"span\":%" PRIu64
+                 ",\"parent\":%" PRIu64 ",\"size\":%" PRIu64
+                 ",\"node\":%d,\"loc\":\"%s:%d\"}\n",
+            ev->ns, ev_names[ev->kind], ev->span, ev->parent, ev->size,
+            (int) ev->node,
+            chpl_lookupFilename(ev->fileno), (int) ev->lineno);
+  }
+
+  fclose(out);
+}
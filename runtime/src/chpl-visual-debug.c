@@ -175,14 +175,14 @@ void chpl_vdebug_start (const char *fileroot, double now) {
 
     chpl_dprintf (chpl_vdebug_fd, "Tablesize: %d\n", chpl_filenameTableSize);
     for (ix = 0; ix < chpl_filenameTableSize ; ix++) {
-      if (chpl_filenameTable[ix][0] == 0) {
+      const char* fname =
+        &chpl_filenameTableData[chpl_filenameTableOffsets[ix]];
+      if (fname[0] == 0) {
         chpl_dprintf (chpl_vdebug_fd, "fname: 0 <unknown>\n");
-      } else if (chpl_filenameTable[ix][0] == '<' &&
-                 chpl_filenameTable[ix][1] == 'c') {
+      } else if (fname[0] == '<' && fname[1] == 'c') {
         chpl_dprintf (chpl_vdebug_fd, "fname: %d <command_line>\n", ix);
       } else {
-        chpl_dprintf (chpl_vdebug_fd, "fname: %d %s\n", ix,
-                      chpl_filenameTable[ix]);
+        chpl_dprintf (chpl_vdebug_fd, "fname: %d %s\n", ix, fname);
       }
     }
     for (numFIDnames = 0; chpl_finfo[numFIDnames].name != NULL; numFIDnames++);
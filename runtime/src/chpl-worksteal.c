@@ -0,0 +1,193 @@
+/*
+ * Copyright 2020-2021 Hewlett Packard Enterprise Development LP
+ * Copyright 2004-2019 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "chplrt.h"
+
+#include "chpl-worksteal.h"
+
+#include "chpl-comm.h"
+#include "chpl-comm-compiler-macros.h"
+#include "chpl-linefile-support.h"
+
+// Don't get warning macros for chpl_comm_put etc.
+#include "chpl-comm-no-warning-macros.h"
+
+#include <string.h>
+
+//
+// The wire format of a steal request.  It travels as a fast executeOn
+// bundle, so the comm/task headers must come first, just as they do in
+// compiler-generated bundles.
+//
+typedef struct {
+  int64_t lo;
+  int64_t hi;
+  int32_t gotWork;
+} chpl_worksteal_reply_t;
+
+typedef struct {
+  chpl_comm_on_bundle_t on;
+  int64_t id;                       // engine id on the victim
+  c_nodeid_t thief;
+  chpl_worksteal_reply_t* replyAddr; // on the thief
+} chpl_worksteal_req_t;
+
+//
+// Registry of live engines, so the steal handler can find the engine
+// for a given loop instance.  A handful of engines exist at a time, so
+// a linked list under a spinlock is plenty; zero initialization leaves
+// the lock unlocked for every atomics implementation.
+//
+static atomic_spinlock_t registryLock;
+static chpl_worksteal_t* registry = NULL;
+
+static chpl_worksteal_t* registryLookup(int64_t id) {
+  chpl_worksteal_t* ws;
+
+  atomic_lock_spinlock_t(&registryLock);
+  for (ws = registry; ws != NULL; ws = ws->next) {
+    if (ws->id == id)
+      break;
+  }
+  atomic_unlock_spinlock_t(&registryLock);
+
+  return ws;
+}
+
+void chpl_worksteal_init(chpl_worksteal_t* ws, int64_t id,
+                         int64_t lo, int64_t hi,
+                         int32_t numTasks, int64_t minChunk,
+                         int64_t minSteal, chpl_fn_int_t stealFid) {
+  chpl_dynsched_init(&ws->sched, lo, hi, numTasks, minChunk);
+  ws->id = id;
+  ws->stealFid = stealFid;
+  ws->minSteal = (minSteal < 1) ? 1 : minSteal;
+  ws->lastVictim = -1; // no victim yet; chpl_worksteal_next picks a start
+
+  atomic_lock_spinlock_t(&registryLock);
+  ws->next = registry;
+  registry = ws;
+  atomic_unlock_spinlock_t(&registryLock);
+}
+
+void chpl_worksteal_destroy(chpl_worksteal_t* ws) {
+  chpl_worksteal_t** prev;
+
+  atomic_lock_spinlock_t(&registryLock);
+  for (prev = &registry; *prev != NULL; prev = &(*prev)->next) {
+    if (*prev == ws) {
+      *prev = ws->next;
+      break;
+    }
+  }
+  atomic_unlock_spinlock_t(&registryLock);
+
+  chpl_dynsched_destroy(&ws->sched);
+}
+
+//
+// Ask 'node' for a chunk of its share.  The request runs in the
+// target's AM handler (fast executeOn), which claims a chunk and PUTs
+// the reply back here; the executeOn blocks until the handler is done,
+// so the reply is complete when it returns.
+//
+static chpl_bool trySteal(chpl_worksteal_t* ws, c_nodeid_t node,
+                          int64_t* lo, int64_t* hi,
+                          int lineno, int32_t filename) {
+  chpl_worksteal_req_t req;
+  chpl_worksteal_reply_t reply;
+
+  reply.gotWork = 0;
+
+  memset(&req, 0, sizeof(req));
+  req.id = ws->id;
+  req.thief = chpl_nodeID;
+  req.replyAddr = &reply;
+
+  chpl_comm_execute_on_fast(node, c_sublocid_any, ws->stealFid,
+                            &req.on, sizeof(req), lineno, filename);
+
+  if (reply.gotWork) {
+    *lo = reply.lo;
+    *hi = reply.hi;
+    return true;
+  }
+
+  return false;
+}
+
+chpl_bool chpl_worksteal_next(chpl_worksteal_t* ws,
+                              int64_t* lo, int64_t* hi,
+                              c_nodeid_t* owner,
+                              int lineno, int32_t filename) {
+  if (chpl_dynsched_next(&ws->sched, lo, hi)) {
+    *owner = chpl_nodeID;
+    return true;
+  }
+
+  if (chpl_numNodes == 1)
+    return false;
+
+  // Local share drained: sweep the peers.  Start at the last locale a
+  // steal succeeded on -- a locale that just had spare work is the most
+  // likely to still have some.  The update below is racy, but it is
+  // only a hint.
+  c_nodeid_t start = ws->lastVictim;
+  if (start < 0 || start >= chpl_numNodes)
+    start = (chpl_nodeID + 1) % chpl_numNodes;
+
+  for (int32_t i = 0; i < chpl_numNodes; i++) {
+    c_nodeid_t node = (start + i) % chpl_numNodes;
+    if (node == chpl_nodeID)
+      continue;
+    if (trySteal(ws, node, lo, hi, lineno, filename)) {
+      ws->lastVictim = node;
+      *owner = node;
+      return true;
+    }
+  }
+
+  return false;
+}
+
+void chpl_worksteal_handleSteal(chpl_comm_on_bundle_t* bundle) {
+  chpl_worksteal_req_t* req = (chpl_worksteal_req_t*) bundle;
+  chpl_worksteal_reply_t reply;
+  chpl_worksteal_t* ws;
+
+  memset(&reply, 0, sizeof(reply));
+
+  ws = registryLookup(req->id);
+
+  // Refuse when the remainder is too small to pay for the messages;
+  // whichever local task holds the cursor will finish it faster.  A
+  // missing engine just means this locale already tore its copy down.
+  if (ws != NULL && chpl_dynsched_remaining(&ws->sched) >= ws->minSteal) {
+    int64_t lo, hi;
+    if (chpl_dynsched_next(&ws->sched, &lo, &hi)) {
+      reply.lo = lo;
+      reply.hi = hi;
+      reply.gotWork = 1;
+    }
+  }
+
+  chpl_comm_put(&reply, req->thief, req->replyAddr, sizeof(reply),
+                CHPL_COMM_UNKNOWN_ID, 0, CHPL_FILE_IDX_INTERNAL);
+}
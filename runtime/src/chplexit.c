@@ -24,6 +24,10 @@
 #include "chpl-comm.h"
 #include "chplexit.h"
 #include "chpl-mem.h"
+#include "chpl-page-migrate.h"
+#include "chpl-snapshot.h"
+#include "chpl-telemetry.h"
+#include "chpl-trace.h"
 #include "chplmemtrack.h"
 #include "chpl-topo.h"
 #include "gdb.h"
@@ -37,6 +41,17 @@ static void chpl_exit_common(int status, int all) {
   if (status != 0) {
     gdbShouldBreakHere();
   }
+  if (all) {
+    // Drain any snapshots still streaming before tasking shuts down.
+    chpl_snapshot_exit();
+    // Stop answering telemetry scrapes and remove the socket.
+    chpl_telemetry_exit();
+
+    // Dump trace rings while the filename table is still around.
+    chpl_trace_exit();
+    // Park the page-migration policy task.
+    chpl_pagemigrate_exit();
+  }
   chpl_comm_pre_task_exit(all);
   if (all) {
     chpl_task_exit();
@@ -28,6 +28,7 @@
 #include "chpltypes.h"
 #include "chpl-comm.h"
 #include "chpl-comm-internal.h"
+#include "chpl-env.h"
 #include "chplcgfns.h"
 #include "chpl-linefile-support.h"
 #include "config.h"
@@ -102,6 +103,27 @@ static size_t totalAllocated = 0; /* total memory allocated */
 static size_t totalFreed = 0;     /* total memory freed */
 static size_t totalEntries = 0;     /* number of entries in hash table */
 
+//
+// Sampled tracking (CHPL_RT_MEM_TRACK_SAMPLE=N): record only 1-in-N
+// allocations, with the byte statistics scaled by N so they remain
+// estimates of the true footprint.  The sampling decision is a
+// thread-local countdown, so untracked allocations never touch shared
+// state, and sampled allocations additionally publish their pointers in
+// a small probe table that lets frees of unsampled memory skip the
+// table lock entirely.  The probe table is only a filter: a hit just
+// means "take the lock and look for real", so stale or evicted slots
+// cost accuracy, never correctness.
+//
+static size_t memTrackSample = 0;   /* record 1 in this many; <= 1: all */
+static size_t sampleScale = 1;      /* stat multiplier, == max(sample, 1) */
+
+static __thread size_t sampleCountdown = 0;
+
+#define SAMPLED_PTRS_SIZE 16384     /* must be a power of two */
+#define SAMPLED_PTRS_PROBES 8
+
+static void* volatile sampledPtrs[SAMPLED_PTRS_SIZE];
+
 
 // We can't use a sync var for concurrency control here.  The Qthreads
 // internal memory allocator shim references this memory tracking code
@@ -180,6 +202,11 @@ void chpl_setMemFlags(void) {
   }
 
   if (local_memTrack) {
+    int64_t sample = chpl_env_rt_get_int("MEM_TRACK_SAMPLE", 0);
+    if (sample > 1) {
+      memTrackSample = (size_t) sample;
+      sampleScale = (size_t) sample;
+    }
     hashSizeIndex = 0;
     hashSize = hashSizes[hashSizeIndex];
     memTable = sys_calloc(hashSize, sizeof(memTableEntry*));
@@ -202,6 +229,66 @@ static unsigned hash(void* memAlloc, int hashSize) {
 }
 
 
+static inline unsigned sampledPtrsSlot(void* memAlloc) {
+  uintptr_t p = (uintptr_t) memAlloc;
+  return (unsigned) ((p >> 4) ^ (p >> 18)) & (SAMPLED_PTRS_SIZE - 1);
+}
+
+
+//
+// Called with the memTrack lock held.  If all probe slots are busy we
+// evict one; the displaced allocation's free will then miss the filter
+// and its table entry may linger, which slightly inflates the sampled
+// reports but never corrupts them.
+//
+static void sampledPtrsInsert(void* memAlloc) {
+  unsigned slot = sampledPtrsSlot(memAlloc);
+  unsigned s = slot;
+  int i;
+  for (i = 0; i < SAMPLED_PTRS_PROBES; i++) {
+    s = (slot + i) & (SAMPLED_PTRS_SIZE - 1);
+    if (sampledPtrs[s] == NULL)
+      break;
+  }
+  sampledPtrs[s] = memAlloc;
+  chpl_atomic_thread_fence(memory_order_release);
+}
+
+
+// Called with the memTrack lock held.
+static void sampledPtrsRemove(void* memAlloc) {
+  unsigned slot = sampledPtrsSlot(memAlloc);
+  int i;
+  for (i = 0; i < SAMPLED_PTRS_PROBES; i++) {
+    unsigned s = (slot + i) & (SAMPLED_PTRS_SIZE - 1);
+    if (sampledPtrs[s] == memAlloc) {
+      sampledPtrs[s] = NULL;
+      return;
+    }
+  }
+}
+
+
+//
+// Lock-free filter for the free path.  A miss means the pointer is not
+// in the filter -- never sampled, or sampled and since evicted, in
+// which case its entry lingers as described above.  A hit just means
+// "take the lock and check for real".  Inserts are published with a
+// release fence before the allocation is handed out, so the thread
+// freeing the memory can see them.
+//
+static inline int sampledPtrsMayContain(void* memAlloc) {
+  unsigned slot = sampledPtrsSlot(memAlloc);
+  int i;
+  for (i = 0; i < SAMPLED_PTRS_PROBES; i++) {
+    unsigned s = (slot + i) & (SAMPLED_PTRS_SIZE - 1);
+    if (sampledPtrs[s] == memAlloc)
+      return 1;
+  }
+  return 0;
+}
+
+
 static void increaseMemStat(size_t chunk, int32_t lineno, int32_t filename) {
   totalMem += chunk;
   totalAllocated += chunk;
@@ -270,7 +357,9 @@ static void addMemTableEntry(void *memAlloc, size_t number, size_t size,
   memEntry->filename = filename;
   memEntry->number = number;
   memEntry->size = size;
-  increaseMemStat(number*size, lineno, filename);
+  // under sampled tracking each recorded entry stands for sampleScale
+  // allocations, so the statistics scale accordingly
+  increaseMemStat(sampleScale*number*size, lineno, filename);
   totalEntries += 1;
 }
 
@@ -300,7 +389,7 @@ static memTableEntry* removeMemTableEntry(void* address) {
     }
   }
   if (deletedBucket) {
-    decreaseMemStat(deletedBucket->number * deletedBucket->size);
+    decreaseMemStat(sampleScale * deletedBucket->number * deletedBucket->size);
     totalEntries -= 1;
     if (totalEntries*8 < hashSize && hashSizeIndex > 0)
       resizeTable(-1);
@@ -398,6 +487,11 @@ void chpl_printMemAllocStats(int32_t lineno, int32_t filename) {
   memTrack_unlock();
 
   fputs(buf, memLogFile);
+
+  if (memTrackSample > 1)
+    fprintf(memLogFile,
+            "%s (sampled 1-in-%zu; byte figures are scaled estimates)\n",
+            prefixBuf, memTrackSample);
 }
 
 
@@ -669,9 +763,25 @@ void chpl_track_malloc(void* memAlloc, size_t number, size_t size,
                        int32_t lineno, int32_t filename) {
   if (number * size > memThreshold) {
     if (chpl_memTrack && chpl_mem_descTrack(description)) {
-      memTrack_lock();
-      addMemTableEntry(memAlloc, number, size, description, lineno, filename);
-      memTrack_unlock();
+      chpl_bool record = true;
+      if (memTrackSample > 1) {
+        // Deterministic 1-in-N sampling; skipped allocations touch only
+        // this thread-local countdown.
+        if (sampleCountdown > 0) {
+          sampleCountdown--;
+          record = false;
+        } else {
+          sampleCountdown = memTrackSample - 1;
+        }
+      }
+      if (record) {
+        memTrack_lock();
+        addMemTableEntry(memAlloc, number, size, description, lineno,
+                         filename);
+        if (memTrackSample > 1)
+          sampledPtrsInsert(memAlloc);
+        memTrack_unlock();
+      }
     }
     if (chpl_verbose_mem) {
       fprintf(memLogFile, "%" PRI_c_nodeid_t ": %s:%" PRId32
@@ -698,9 +808,15 @@ void chpl_track_free(void* memAlloc, size_t approximateSize, int32_t lineno,
   if (approximateSize == 0 || approximateSize > memThreshold) {
     memTableEntry* memEntry = NULL;
     if (chpl_memTrack) {
+      // Under sampled tracking, only frees of sampled pointers need the
+      // lock; everything else bails out on the lock-free filter.
+      if (memTrackSample > 1 && !sampledPtrsMayContain(memAlloc))
+        return;
       memTrack_lock();
       memEntry = removeMemTableEntry(memAlloc);
       if (memEntry) {
+        if (memTrackSample > 1)
+          sampledPtrsRemove(memAlloc);
         if (chpl_verbose_mem) {
           fprintf(memLogFile, "%" PRI_c_nodeid_t ": %s:%" PRId32
                               ": free %zuB of %s at %p\n",
@@ -726,11 +842,17 @@ void chpl_track_realloc_pre(void* memAlloc, size_t size,
   memTableEntry* memEntry = NULL;
 
   if (chpl_memTrack && size > memThreshold) {
+    if (memTrackSample > 1
+        && (memAlloc == NULL || !sampledPtrsMayContain(memAlloc)))
+      return;
     memTrack_lock();
     if (memAlloc) {
       memEntry = removeMemTableEntry(memAlloc);
-      if (memEntry)
+      if (memEntry) {
+        if (memTrackSample > 1)
+          sampledPtrsRemove(memAlloc);
         sys_free(memEntry);
+      }
     }
     memTrack_unlock();
   }
@@ -743,9 +865,22 @@ void chpl_track_realloc_post(void* moreMemAlloc,
                          int32_t lineno, int32_t filename) {
   if (size > memThreshold) {
     if (chpl_memTrack && chpl_mem_descTrack(description)) {
-      memTrack_lock();
-      addMemTableEntry(moreMemAlloc, 1, size, description, lineno, filename);
-      memTrack_unlock();
+      chpl_bool record = true;
+      if (memTrackSample > 1) {
+        if (sampleCountdown > 0) {
+          sampleCountdown--;
+          record = false;
+        } else {
+          sampleCountdown = memTrackSample - 1;
+        }
+      }
+      if (record) {
+        memTrack_lock();
+        addMemTableEntry(moreMemAlloc, 1, size, description, lineno, filename);
+        if (memTrackSample > 1)
+          sampledPtrsInsert(moreMemAlloc);
+        memTrack_unlock();
+      }
     }
     if (chpl_verbose_mem) {
       fprintf(memLogFile, "%" PRI_c_nodeid_t ": %s:%" PRId32
@@ -785,3 +785,33 @@ c_string chpl_nodeName(void) {
   }
   return namespace;
 }
+
+
+//
+// CPU feature test for the dispatchers the compiler generates under
+// --target-cpu-versions: at program start they pick the newest kernel
+// version whose gate feature the running CPU supports.  This runs from
+// global constructors, so it must not depend on any runtime
+// initialization.  __builtin_cpu_supports() requires a string literal,
+// hence the dispatch table.  Unknown features, and all features on
+// non-x86 targets, report unsupported, which makes the dispatchers fall
+// back to the default version.
+//
+chpl_bool chpl_sys_cpuSupportsFeature(const char* feature) {
+#if (defined(__x86_64__) || defined(__i386__)) && \
+    (defined(__GNUC__) || defined(__clang__))
+  __builtin_cpu_init();
+#define CHECK_FEATURE(f) \
+  if (strcmp(feature, f) == 0) return __builtin_cpu_supports(f) != 0;
+  CHECK_FEATURE("sse4.2");
+  CHECK_FEATURE("avx");
+  CHECK_FEATURE("avx2");
+  CHECK_FEATURE("fma");
+  CHECK_FEATURE("avx512f");
+  CHECK_FEATURE("avx512bw");
+  CHECK_FEATURE("avx512dq");
+  CHECK_FEATURE("avx512vl");
+#undef CHECK_FEATURE
+#endif
+  return false;
+}
@@ -27,6 +27,7 @@
 #include "error.h"
 #include "chpl-mem.h"
 #include "chpl-tasks.h"
+#include "chpl-trace.h"
 
 #include "chplcgfns.h"
 #include "chpl-gen-includes.h"
@@ -246,6 +247,7 @@ void chpl_comm_execute_on_nb(c_nodeid_t node, c_sublocid_t subloc,
                              int ln, int32_t fn) {
   assert(node==0);
 
+  chpl_trace_stamp_bundle(chpl_comm_on_bundle_task_bundle(arg));
   chpl_task_startMovedTask(fid, chpl_ftable[fid],
                            chpl_comm_on_bundle_task_bundle(arg), arg_size,
                            subloc, chpl_nullTaskID);
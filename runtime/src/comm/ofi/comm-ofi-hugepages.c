@@ -28,8 +28,13 @@
 
 #include <stdint.h>
 #include <sys/types.h>
+#include <sys/mman.h>
 #include <hugetlbfs.h>  // <sys/types.h> must come first
 
+#ifndef MAP_HUGE_SHIFT
+#define MAP_HUGE_SHIFT 26
+#endif
+
 
 void* chpl_comm_ofi_hp_get_huge_pages(size_t size) {
   return get_huge_pages(size, GHP_DEFAULT);
@@ -39,3 +44,54 @@ void* chpl_comm_ofi_hp_get_huge_pages(size_t size) {
 size_t chpl_comm_ofi_hp_gethugepagesize(void) {
   return gethugepagesize();
 }
+
+
+//
+// Pick a hugepage size for a heap of the given size, from among the
+// pools the system actually has configured.  Prefer the largest page
+// size that still leaves us a reasonable number of pages in the heap,
+// so that rounding the heap up to whole pages doesn't waste a large
+// fraction of it.  Returns 0 if no configured pool qualifies.
+//
+#define HP_MIN_PAGES_PER_HEAP 8
+
+size_t chpl_comm_ofi_hp_choose_hugepagesize(size_t heapSize) {
+  int n = gethugepagesizes(NULL, 0);
+  if (n <= 0)
+    return 0;
+
+  long sizes[n];
+  if ((n = gethugepagesizes(sizes, n)) <= 0)
+    return 0;
+
+  size_t best = 0;
+  for (int i = 0; i < n; i++) {
+    size_t sz = (size_t) sizes[i];
+    if (sz > best && heapSize / sz >= HP_MIN_PAGES_PER_HEAP)
+      best = sz;
+  }
+
+  return best;
+}
+
+
+//
+// get_huge_pages() only deals in the default hugepage size, so when
+// we've chosen a size ourselves we go straight to mmap(MAP_HUGETLB)
+// with an explicit page-size request.
+//
+void* chpl_comm_ofi_hp_get_huge_pages_size(size_t size, size_t pageSize) {
+#ifdef MAP_HUGETLB
+  int pageShift = 0;
+  while (((size_t) 1 << pageShift) < pageSize)
+    pageShift++;
+
+  void* p = mmap(NULL, size, PROT_READ | PROT_WRITE,
+                 MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB
+                 | (pageShift << MAP_HUGE_SHIFT),
+                 -1, 0);
+  return (p == MAP_FAILED) ? NULL : p;
+#else
+  return NULL;
+#endif
+}
@@ -275,12 +275,24 @@ void chpl_comm_ofi_oob_bcast(void*, size_t);
 int  chpl_comm_ofi_oob_locales_on_node(void);
 
 
+//
+// Same-node bypass support
+//
+
+void chpl_comm_ofi_shm_init(void);
+void chpl_comm_ofi_shm_fini(void);
+chpl_bool chpl_comm_ofi_shm_get(void*, c_nodeid_t, void*, size_t);
+chpl_bool chpl_comm_ofi_shm_put(void*, c_nodeid_t, void*, size_t);
+
+
 //
 // Hugepage interface
 //
 
 void* chpl_comm_ofi_hp_get_huge_pages(size_t);
 size_t chpl_comm_ofi_hp_gethugepagesize(void);
+size_t chpl_comm_ofi_hp_choose_hugepagesize(size_t);
+void* chpl_comm_ofi_hp_get_huge_pages_size(size_t, size_t);
 
 
 //
@@ -33,3 +33,11 @@ void* chpl_comm_ofi_hp_get_huge_pages(size_t size) { return NULL; }
 
 
 size_t chpl_comm_ofi_hp_gethugepagesize(void) { return 0; }
+
+
+size_t chpl_comm_ofi_hp_choose_hugepagesize(size_t heapSize) { return 0; }
+
+
+void* chpl_comm_ofi_hp_get_huge_pages_size(size_t size, size_t pageSize) {
+  return NULL;
+}
@@ -2,15 +2,15 @@
  * Copyright 2020-2021 Hewlett Packard Enterprise Development LP
  * Copyright 2004-2019 Cray Inc.
  * Other additional copyright holders may be indicated within.
- * 
+ *
  * The entirety of this work is licensed under the Apache License,
  * Version 2.0 (the "License"); you may not use this file except
  * in compliance with the License.
- * 
+ *
  * You may obtain a copy of the License at
- * 
+ *
  *     http://www.apache.org/licenses/LICENSE-2.0
- * 
+ *
  * Unless required by applicable law or agreed to in writing, software
  * distributed under the License is distributed on an "AS IS" BASIS,
  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
@@ -19,27 +19,365 @@
  */
 
 //
-// Sockets-based (really, faked) out-of-band support for the OFI-based
-// Chapel comm layer.
+// Sockets-based out-of-band support for the OFI-based Chapel comm layer.
+//
+// Unlike the MPI and PMI2 variants, which get their collectives from
+// the resource manager, here we have to build them ourselves.  To keep
+// startup from degenerating into every node talking to node 0, we wire
+// the nodes into a binary tree during init and then run the barrier,
+// broadcast, and allgather operations over that tree, so their depth is
+// logarithmic in the number of nodes.
+//
+// Bootstrap works as follows.  Every node opens a listening socket on
+// an ephemeral port, except node 0, which listens on a port all nodes
+// can compute (settable via CHPL_RT_OOB_SOCKET_PORT, defaulting to one
+// derived from the Slurm job id).  Each nonzero node connects to node 0
+// and registers its listening port; node 0 learns the node's address
+// from the connection itself.  Once everyone has registered, node 0
+// tells each node where its tree parent (node (i-1)/2) is listening and
+// drops the registration connections.  Each node then connects to its
+// parent, giving every node a persistent socket to its parent and to
+// each of its (at most two) children.  The registration step is the
+// only all-to-one traffic, and it carries just a few bytes per node;
+// the address tables and barriers exchanged during chpl_comm_init()
+// all flow over the tree.
+//
+// Note that like the rest of the runtime we assume all nodes run the
+// same executable on the same architecture, so scalar fields can cross
+// the wire in host byte order.
 //
 
 #include "chplrt.h"
 #include "chpl-env-gen.h"
 
 #include "chpl-comm.h"
+#include "chpl-env.h"
 #include "chpl-mem.h"
+#include "chpl-mem-sys.h"
 #include "chpl-gen-includes.h"
 #include "chplsys.h"
 #include "error.h"
 
 #include <assert.h>
+#include <errno.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
 
 #include "comm-ofi-internal.h"
 
 
+//
+// Tree state.  Node i's parent is (i-1)/2; its children are 2i+1 and
+// 2i+2, when those are valid node numbers.
+//
+static int parentFd = -1;
+static int childFd[2] = { -1, -1 };
+static int numChildren = 0;
+
+//
+// Bootstrap messages, fixed size, host byte order except that the
+// address field holds an in_addr s_addr and is therefore already in
+// network order.
+//
+enum { msgRegister, msgTreeConn };
+
+typedef struct {
+  uint8_t kind;                 // msgRegister or msgTreeConn
+  uint16_t port;                // sender's listening port (host order)
+  int32_t node;                 // sender's node number
+} bootMsg_t;
+
+typedef struct {
+  uint32_t addr;                // parent's s_addr; 0: use the node 0 host
+  uint16_t port;                // parent's listening port (host order)
+} parentMsg_t;
+
+
+static void oobRead(int fd, void* buf, size_t size) {
+  char* p = (char*) buf;
+  while (size > 0) {
+    ssize_t n = read(fd, p, size);
+    if (n < 0 && errno == EINTR)
+      continue;
+    if (n <= 0) {
+      INTERNAL_ERROR_V("OOB socket read: %s",
+                       (n == 0) ? "peer closed" : strerror(errno));
+    }
+    p += n;
+    size -= n;
+  }
+}
+
+
+static void oobWrite(int fd, const void* buf, size_t size) {
+  const char* p = (const char*) buf;
+  while (size > 0) {
+    ssize_t n = write(fd, p, size);
+    if (n < 0 && errno == EINTR)
+      continue;
+    if (n < 0) {
+      INTERNAL_ERROR_V("OOB socket write: %s", strerror(errno));
+    }
+    p += n;
+    size -= n;
+  }
+}
+
+
+static int oobListen(uint16_t port, uint16_t* portOut) {
+  int fd;
+  CHK_TRUE((fd = socket(AF_INET, SOCK_STREAM, 0)) >= 0);
+
+  int one = 1;
+  (void) setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+  struct sockaddr_in sin;
+  memset(&sin, 0, sizeof(sin));
+  sin.sin_family = AF_INET;
+  sin.sin_addr.s_addr = htonl(INADDR_ANY);
+  sin.sin_port = htons(port);
+  if (bind(fd, (struct sockaddr*) &sin, sizeof(sin)) != 0) {
+    INTERNAL_ERROR_V("OOB bind(port %d): %s (try setting "
+                     "CHPL_RT_OOB_SOCKET_PORT)",
+                     (int) port, strerror(errno));
+  }
+  CHK_TRUE(listen(fd, chpl_numNodes) == 0);
+
+  socklen_t len = sizeof(sin);
+  CHK_TRUE(getsockname(fd, (struct sockaddr*) &sin, &len) == 0);
+  *portOut = ntohs(sin.sin_port);
+  return fd;
+}
+
+
+static int oobConnect(const struct sockaddr_in* sin) {
+  //
+  // Retry for a while, because our peer may not be listening yet.
+  //
+  int64_t timeout = chpl_env_rt_get_int("OOB_CONNECT_TIMEOUT", 60);
+  time_t deadline = time(NULL) + (time_t) timeout;
+
+  while (true) {
+    int fd;
+    CHK_TRUE((fd = socket(AF_INET, SOCK_STREAM, 0)) >= 0);
+    if (connect(fd, (const struct sockaddr*) sin, sizeof(*sin)) == 0) {
+      int one = 1;
+      (void) setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+      return fd;
+    }
+    (void) close(fd);
+    if (errno != ECONNREFUSED && errno != ETIMEDOUT
+        && errno != EHOSTUNREACH && errno != ENETUNREACH) {
+      INTERNAL_ERROR_V("OOB connect: %s", strerror(errno));
+    }
+    if (time(NULL) >= deadline) {
+      INTERNAL_ERROR_V("OOB connect: timed out after %" PRId64 "s",
+                       timeout);
+    }
+    struct timespec ts = { .tv_sec = 0, .tv_nsec = 100 * 1000 * 1000 };
+    (void) nanosleep(&ts, NULL);
+  }
+}
+
+
+//
+// The port node 0 listens on.  All nodes must compute the same value,
+// so default to one derived from the Slurm job id.
+//
+static uint16_t rendezvousPort(void) {
+  int64_t port = chpl_env_rt_get_int("OOB_SOCKET_PORT", 0);
+  if (port == 0) {
+    const char* ev = getenv("SLURM_JOB_ID");
+    int ev_i = 0;
+    if (ev == NULL || sscanf(ev, "%i", &ev_i) != 1) {
+      INTERNAL_ERROR_V("need SLURM_JOB_ID or CHPL_RT_OOB_SOCKET_PORT");
+    }
+    port = 25000 + ev_i % 25000;
+  }
+  CHK_TRUE(port > 0 && port < 65536);
+  return (uint16_t) port;
+}
+
+
+//
+// The host node 0 runs on: CHPL_RT_OOB_SOCKET_HOST if set, otherwise
+// the first entry of the Slurm step nodelist.  We only handle the
+// common nodelist forms here: a comma-separated list and/or a single
+// bracketed range expression, e.g. "nid[001-004],nid007".
+//
+static void rendezvousHost(char* buf, size_t bufSize) {
+  const char* ev = chpl_env_rt_get("OOB_SOCKET_HOST", NULL);
+  if (ev != NULL) {
+    CHK_TRUE(strlen(ev) < bufSize);
+    strcpy(buf, ev);
+    return;
+  }
+
+  if ((ev = getenv("SLURM_STEP_NODELIST")) == NULL) {
+    INTERNAL_ERROR_V("need SLURM_STEP_NODELIST or CHPL_RT_OOB_SOCKET_HOST");
+  }
+
+  size_t i = 0;
+  const char* p = ev;
+  while (*p != '\0' && *p != ',' && *p != '[') {
+    CHK_TRUE(i < bufSize - 1);
+    buf[i++] = *p++;
+  }
+  if (*p == '[') {
+    // Append the first number in the range, preserving zero padding.
+    p++;
+    while (*p != '\0' && *p != '-' && *p != ',' && *p != ']') {
+      CHK_TRUE(i < bufSize - 1);
+      buf[i++] = *p++;
+    }
+  }
+  buf[i] = '\0';
+  CHK_TRUE(i > 0);
+}
+
+
+static void rendezvousAddr(struct sockaddr_in* sin) {
+  char host[256];
+  rendezvousHost(host, sizeof(host));
+
+  struct addrinfo hints;
+  memset(&hints, 0, sizeof(hints));
+  hints.ai_family = AF_INET;
+  hints.ai_socktype = SOCK_STREAM;
+
+  struct addrinfo* ai;
+  int err;
+  if ((err = getaddrinfo(host, NULL, &hints, &ai)) != 0) {
+    INTERNAL_ERROR_V("OOB cannot resolve \"%s\": %s",
+                     host, gai_strerror(err));
+  }
+  memcpy(sin, ai->ai_addr, sizeof(*sin));
+  sin->sin_port = htons(rendezvousPort());
+  freeaddrinfo(ai);
+}
+
+
+//
+// Accept tree connections from our children on our listening socket
+// and file the sockets by child slot.
+//
+static void acceptChildren(int listenFd) {
+  for (int i = 0; i < numChildren; i++) {
+    int fd;
+    CHK_TRUE((fd = accept(listenFd, NULL, NULL)) >= 0);
+    int one = 1;
+    (void) setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+    bootMsg_t msg;
+    oobRead(fd, &msg, sizeof(msg));
+    CHK_TRUE(msg.kind == msgTreeConn);
+    int slot = msg.node - (2 * chpl_nodeID + 1);
+    CHK_TRUE(slot >= 0 && slot < numChildren && childFd[slot] == -1);
+    childFd[slot] = fd;
+  }
+}
+
+
+static void buildTree(void) {
+  for (int i = 0; i < 2; i++) {
+    if (2 * chpl_nodeID + 1 + i < chpl_numNodes)
+      numChildren++;
+  }
+
+  uint16_t listenPort;
+  int listenFd = oobListen((chpl_nodeID == 0) ? rendezvousPort() : 0,
+                           &listenPort);
+
+  if (chpl_nodeID == 0) {
+    //
+    // Collect every other node's listening address, then tell each
+    // where its parent is.
+    //
+    struct sockaddr_in* nodeAddr;
+    int* regFd;
+    CHK_SYS_CALLOC(nodeAddr, chpl_numNodes);
+    CHK_SYS_CALLOC(regFd, chpl_numNodes);
+
+    for (int i = 1; i < (int) chpl_numNodes; i++) {
+      struct sockaddr_in sin;
+      socklen_t len = sizeof(sin);
+      int fd;
+      CHK_TRUE((fd = accept(listenFd, (struct sockaddr*) &sin, &len)) >= 0);
+
+      bootMsg_t msg;
+      oobRead(fd, &msg, sizeof(msg));
+      CHK_TRUE(msg.kind == msgRegister);
+      CHK_TRUE(msg.node > 0 && msg.node < chpl_numNodes);
+      sin.sin_port = htons(msg.port);
+      nodeAddr[msg.node] = sin;
+      regFd[msg.node] = fd;
+    }
+
+    DBG_PRINTF(DBG_OOB, "OOB tree: all %" PRId32 " nodes registered",
+               chpl_numNodes);
+
+    for (int i = 1; i < (int) chpl_numNodes; i++) {
+      int parent = (i - 1) / 2;
+      parentMsg_t msg;
+      if (parent == 0) {
+        msg.addr = 0;           // "connect back to the node 0 host"
+        msg.port = listenPort;
+      } else {
+        msg.addr = nodeAddr[parent].sin_addr.s_addr;
+        msg.port = ntohs(nodeAddr[parent].sin_port);
+      }
+      oobWrite(regFd[i], &msg, sizeof(msg));
+      (void) close(regFd[i]);
+    }
+
+    CHK_SYS_FREE(regFd);
+    CHK_SYS_FREE(nodeAddr);
+  } else {
+    //
+    // Register with node 0 and learn where our parent is.
+    //
+    struct sockaddr_in sin;
+    rendezvousAddr(&sin);
+
+    int fd = oobConnect(&sin);
+    bootMsg_t reg = { .kind = msgRegister,
+                      .port = listenPort,
+                      .node = chpl_nodeID, };
+    oobWrite(fd, &reg, sizeof(reg));
+
+    parentMsg_t pm;
+    oobRead(fd, &pm, sizeof(pm));
+    (void) close(fd);
+
+    if (pm.addr != 0)
+      sin.sin_addr.s_addr = pm.addr;
+    sin.sin_port = htons(pm.port);
+
+    parentFd = oobConnect(&sin);
+    bootMsg_t conn = { .kind = msgTreeConn,
+                       .port = 0,
+                       .node = chpl_nodeID, };
+    oobWrite(parentFd, &conn, sizeof(conn));
+  }
+
+  acceptChildren(listenFd);
+  (void) close(listenFd);
+
+  DBG_PRINTF(DBG_OOB, "OOB tree: parent %d, %d children",
+             (chpl_nodeID == 0) ? -1 : (chpl_nodeID - 1) / 2, numChildren);
+}
+
+
 void chpl_comm_ofi_oob_init(void) {
   char const* ev;
 
@@ -56,32 +394,68 @@ void chpl_comm_ofi_oob_init(void) {
       INTERNAL_ERROR_V("SLURM_NTASKS");
     }
     chpl_numNodes = ev_i;
-
-#if 0
-    // TODO: this is temporary debug code
-    {
-      #define _P(name) printf("%d: %s %s\n", chpl_nodeID, #name, getenv(#name))
-      _P(SLURM_STEP_NODELIST);
-      fflush(stdout);
-      #undef _P
-    }
-#endif
   } else {
     INTERNAL_ERROR_V("need slurm system launcher");
   }
+
+  if (chpl_numNodes > 1) {
+    buildTree();
+  }
+
+  DBG_PRINTF(DBG_OOB, "OOB init: node %" PRI_c_nodeid_t " of %" PRId32,
+             chpl_nodeID, chpl_numNodes);
 }
 
 
 void chpl_comm_ofi_oob_fini(void) {
-  if (chpl_numNodes != 1) {
-    INTERNAL_ERROR_V("multi-locale fini not supported");
+  if (chpl_numNodes > 1) {
+    chpl_comm_ofi_oob_barrier();
+    for (int i = 0; i < numChildren; i++) {
+      (void) close(childFd[i]);
+      childFd[i] = -1;
+    }
+    if (parentFd != -1) {
+      (void) close(parentFd);
+      parentFd = -1;
+    }
   }
 }
 
 
 void chpl_comm_ofi_oob_barrier(void) {
-  if (chpl_numNodes != 1) {
-    INTERNAL_ERROR_V("multi-locale barrier not supported");
+  if (chpl_numNodes == 1)
+    return;
+
+  DBG_PRINTF(DBG_OOB, "OOB barrier");
+
+  //
+  // Sweep a token up the tree and then back down.
+  //
+  char token = 0;
+  for (int i = 0; i < numChildren; i++) {
+    oobRead(childFd[i], &token, sizeof(token));
+  }
+  if (parentFd != -1) {
+    oobWrite(parentFd, &token, sizeof(token));
+    oobRead(parentFd, &token, sizeof(token));
+  }
+  for (int i = 0; i < numChildren; i++) {
+    oobWrite(childFd[i], &token, sizeof(token));
+  }
+}
+
+
+void chpl_comm_ofi_oob_bcast(void* buf, size_t len) {
+  if (chpl_numNodes == 1)
+    return;
+
+  DBG_PRINTF(DBG_OOB, "OOB bcast: %zu", len);
+
+  if (parentFd != -1) {
+    oobRead(parentFd, buf, len);
+  }
+  for (int i = 0; i < numChildren; i++) {
+    oobWrite(childFd[i], buf, len);
   }
 }
 
@@ -89,19 +463,95 @@ void chpl_comm_ofi_oob_barrier(void) {
 void chpl_comm_ofi_oob_allgather(const void* in, void* out, size_t len) {
   if (chpl_numNodes == 1) {
     chpl_memcpy(out, in, len);
-  } else {
-    INTERNAL_ERROR_V("multi-locale allgather not supported");
+    return;
   }
-}
 
+  DBG_PRINTF(DBG_OOB, "OOB allgather: %zu", len);
 
-void chpl_comm_ofi_oob_bcast(void* buf, size_t len) {
-  if (chpl_numNodes != 1) {
-    INTERNAL_ERROR_V("multi-locale bcast not supported");
+  //
+  // Gather (node, payload) records up the tree.  The root drops them
+  // into place and broadcasts the assembled table back down.
+  //
+  const size_t recSize = sizeof(int32_t) + len;
+  char* recs;
+  CHK_SYS_MALLOC_SZ(recs, chpl_numNodes, recSize);
+
+  int32_t count = 0;
+  memcpy(recs, &chpl_nodeID, sizeof(int32_t));
+  memcpy(recs + sizeof(int32_t), in, len);
+  count++;
+
+  for (int i = 0; i < numChildren; i++) {
+    int32_t childCount;
+    oobRead(childFd[i], &childCount, sizeof(childCount));
+    CHK_TRUE(count + childCount <= chpl_numNodes);
+    oobRead(childFd[i], recs + count * recSize, childCount * recSize);
+    count += childCount;
   }
+
+  if (parentFd != -1) {
+    oobWrite(parentFd, &count, sizeof(count));
+    oobWrite(parentFd, recs, count * recSize);
+  } else {
+    CHK_TRUE(count == chpl_numNodes);
+    for (int32_t i = 0; i < count; i++) {
+      int32_t node;
+      memcpy(&node, recs + i * recSize, sizeof(node));
+      CHK_TRUE(node >= 0 && node < chpl_numNodes);
+      memcpy((char*) out + node * len, recs + i * recSize + sizeof(int32_t),
+             len);
+    }
+  }
+
+  CHK_SYS_FREE(recs);
+
+  chpl_comm_ofi_oob_bcast(out, chpl_numNodes * len);
 }
 
+
 int chpl_comm_ofi_oob_locales_on_node(void) {
-  // assume the answer is 1
-  return 1;
+  if (chpl_numNodes == 1)
+    return 1;
+
+  //
+  // Do an allgather of hostname hashes and count the ones that match
+  // ours, as the PMI2 variant does when it has no clique support.
+  //
+  char hostname[HOST_NAME_MAX+1];
+  int rc = gethostname(hostname, sizeof(hostname));
+  CHK_TRUE(rc == 0);
+
+  uint64_t hash = 0;
+  for (int i = 0; i < (int) sizeof(hostname); i++) {
+    char c = hostname[i];
+    if (c == '\0') {
+      break;
+    }
+    // The hash code is borrowed from gasnet including the comment.
+    // See third-party/gasnet/gasnet-src/license.txt.
+
+    /* The "c = ..." squeezes ASCII down to 6 bits, while encoding
+     * all chars valid in hostnames and IP addresses (IPV4 and IPV6).
+     * A unique value is assigned to each of the digits, the lower
+     * case letters, '-', '.' and ':'.  The upper case letters map
+     * to the same values as the corresponding lower-case.
+     */
+    c = ((c & 0x40) >> 1) | (c & 0x1f);
+    hash = ((hash << 6) | ((hash >> 58) & 0x3F)) ^ c;
+  }
+
+  uint64_t *hashes = NULL;
+  CHK_SYS_CALLOC(hashes, chpl_numNodes);
+  chpl_comm_ofi_oob_allgather(&hash, hashes, sizeof(*hashes));
+
+  int count = 0;
+  for (int i = 0; i < chpl_numNodes; i++) {
+    if (hashes[i] == hash) {
+      count++;
+    }
+  }
+  CHK_SYS_FREE(hashes);
+
+  DBG_PRINTF(DBG_OOB, "OOB locales on node: %d", count);
+  return count;
 }
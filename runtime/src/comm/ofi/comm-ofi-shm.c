@@ -0,0 +1,276 @@
+/*
+ * Copyright 2020-2021 Hewlett Packard Enterprise Development LP
+ * Copyright 2004-2019 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//
+// Same-node bypass for the OFI-based Chapel comm layer.
+//
+// When multiple locales run on one node, GETs and PUTs between them
+// otherwise go out through the provider and come back via NIC (or
+// provider-internal) loopback.  Here we detect same-node peers at
+// startup by gathering a host identifier and pid from every locale,
+// and then move qualifying transfers between same-node address spaces
+// directly with process_vm_readv(2)/process_vm_writev(2): a single
+// kernel-mediated copy, no registration, no NIC round trip.  Because
+// the peers share a cache coherence domain, a copy is globally
+// visible when the syscall returns, so these transfers are at least
+// as complete-on-return as the blocking RMA they replace -- the same
+// argument that already justifies the plain memmove() fast path for
+// self-communication in chpl_comm_get()/chpl_comm_put().
+//
+// Only blocking GETs and PUTs at or above a size threshold take this
+// path; small ops stay on the provider, whose inject path is already
+// cheaper than a syscall.  AMOs and AMs always stay on the provider,
+// preserving their ordering story.  Everything is gated by
+// CHPL_RT_COMM_OFI_SHM (default true) and degrades to disabled when
+// the kernel refuses cross-memory attach (e.g. a restrictive
+// ptrace_scope), which we find out with a probe read at startup.
+//
+
+// For process_vm_readv()/process_vm_writev().
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include "chplrt.h"
+#include "chpl-comm.h"
+#include "chpl-env.h"
+#include "chpl-mem.h"
+#include "chpl-mem-sys.h"
+#include "error.h"
+
+#include "comm-ofi-internal.h"
+
+#include <errno.h>
+#include <limits.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <sys/uio.h>
+#endif
+
+
+//
+// Peer table: for each node, the pid to attach to, or -1 if that node
+// is not on our host (or the bypass is off).
+//
+static pid_t* shmPeerPid = NULL;
+static size_t shmThreshold;
+
+//
+// Known-value word peers probe-read at startup to confirm the kernel
+// will let them attach to us.
+//
+static uint64_t shmProbeVal;
+
+struct shmInfo_t {
+  uint64_t hostHash;
+  pid_t pid;
+  uint64_t* probeAddr;
+  uint64_t probeVal;
+};
+
+
+#ifdef __linux__
+
+static
+uint64_t hostNameHash(void) {
+  char name[HOST_NAME_MAX + 1];
+  uint64_t h = UINT64_C(0xcbf29ce484222325);  // FNV-1a
+
+  memset(name, 0, sizeof(name));
+  CHK_TRUE(gethostname(name, sizeof(name) - 1) == 0);
+
+  for (int i = 0; name[i] != '\0'; i++) {
+    h = (h ^ (unsigned char) name[i]) * UINT64_C(0x100000001b3);
+  }
+
+  return h;
+}
+
+
+void chpl_comm_ofi_shm_init(void) {
+  if (!chpl_env_rt_get_bool("COMM_OFI_SHM", true)
+      || chpl_numNodes <= 1) {
+    return;
+  }
+
+  shmThreshold = chpl_env_rt_get_size("COMM_OFI_SHM_THRESHOLD", 512);
+
+  struct shmInfo_t me;
+  struct shmInfo_t* infoMap;
+
+  shmProbeVal = ((uint64_t) getpid() << 32) ^ (uintptr_t) &shmProbeVal;
+
+  me.hostHash = hostNameHash();
+  me.pid = getpid();
+  me.probeAddr = &shmProbeVal;
+  me.probeVal = shmProbeVal;
+
+  CHPL_CALLOC(infoMap, chpl_numNodes);
+  chpl_comm_ofi_oob_allgather(&me, infoMap, sizeof(infoMap[0]));
+
+  pid_t* peerPid;
+  int numPeers = 0;
+
+  CHPL_CALLOC(peerPid, chpl_numNodes);
+  for (int node = 0; node < chpl_numNodes; node++) {
+    if (node != chpl_nodeID && infoMap[node].hostHash == me.hostHash) {
+      peerPid[node] = infoMap[node].pid;
+      numPeers++;
+    } else {
+      peerPid[node] = -1;
+    }
+  }
+
+  //
+  // Probe one peer's known-value word to confirm cross-memory attach
+  // actually works here; a denial takes the whole tier down rather
+  // than surfacing per-transfer.
+  //
+  if (numPeers > 0) {
+    for (int node = 0; node < chpl_numNodes; node++) {
+      if (peerPid[node] < 0) {
+        continue;
+      }
+
+      uint64_t got = 0;
+      struct iovec lIov = { .iov_base = &got, .iov_len = sizeof(got) };
+      struct iovec rIov = { .iov_base = infoMap[node].probeAddr,
+                            .iov_len = sizeof(got) };
+      ssize_t n = process_vm_readv(peerPid[node], &lIov, 1, &rIov, 1, 0);
+
+      if (n != (ssize_t) sizeof(got) || got != infoMap[node].probeVal) {
+        DBG_PRINTF(DBG_CFG,
+                   "same-node bypass disabled: probe of node %d (pid %d) "
+                   "failed (%s)",
+                   node, (int) peerPid[node],
+                   (n < 0) ? strerror(errno) : "value mismatch");
+        numPeers = 0;
+      }
+      break;
+    }
+  }
+
+  if (numPeers > 0) {
+    shmPeerPid = peerPid;
+    DBG_PRINTF(DBG_CFG,
+               "same-node bypass: %d same-node peer%s, threshold %zd",
+               numPeers, (numPeers == 1) ? "" : "s", shmThreshold);
+  } else {
+    CHPL_FREE(peerPid);
+  }
+
+  CHPL_FREE(infoMap);
+}
+
+
+void chpl_comm_ofi_shm_fini(void) {
+  if (shmPeerPid != NULL) {
+    CHPL_FREE(shmPeerPid);
+  }
+}
+
+
+//
+// The kernel may copy less than asked (it stops at iovec granularity
+// on fault); redoing the remainder is safe because the interface ops
+// we serve are idempotent copies.  Any hard error just sends the
+// caller back to the provider path.
+//
+static inline
+chpl_bool shmCopy(pid_t pid, void* lAddr, void* rAddr, size_t size,
+                  chpl_bool isWrite) {
+  while (size > 0) {
+    struct iovec lIov = { .iov_base = lAddr, .iov_len = size };
+    struct iovec rIov = { .iov_base = rAddr, .iov_len = size };
+    ssize_t n;
+
+    if (isWrite) {
+      n = process_vm_writev(pid, &lIov, 1, &rIov, 1, 0);
+    } else {
+      n = process_vm_readv(pid, &lIov, 1, &rIov, 1, 0);
+    }
+
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+
+    lAddr = (char*) lAddr + n;
+    rAddr = (char*) rAddr + n;
+    size -= n;
+  }
+
+  return true;
+}
+
+
+chpl_bool chpl_comm_ofi_shm_get(void* addr, c_nodeid_t node, void* raddr,
+                                size_t size) {
+  if (shmPeerPid == NULL || shmPeerPid[node] < 0 || size < shmThreshold) {
+    return false;
+  }
+
+  DBG_PRINTF(DBG_RMA_READ,
+             "same-node GET %d:%p <= %p, size %zd",
+             (int) node, addr, raddr, size);
+
+  return shmCopy(shmPeerPid[node], addr, raddr, size, false /*isWrite*/);
+}
+
+
+chpl_bool chpl_comm_ofi_shm_put(void* addr, c_nodeid_t node, void* raddr,
+                                size_t size) {
+  if (shmPeerPid == NULL || shmPeerPid[node] < 0 || size < shmThreshold) {
+    return false;
+  }
+
+  DBG_PRINTF(DBG_RMA_WRITE,
+             "same-node PUT %d:%p <= %p, size %zd",
+             (int) node, raddr, addr, size);
+
+  return shmCopy(shmPeerPid[node], addr, raddr, size, true /*isWrite*/);
+}
+
+#else // __linux__
+
+//
+// No cross-memory attach elsewhere; the provider handles everything.
+//
+
+void chpl_comm_ofi_shm_init(void) { }
+
+void chpl_comm_ofi_shm_fini(void) { }
+
+chpl_bool chpl_comm_ofi_shm_get(void* addr, c_nodeid_t node, void* raddr,
+                                size_t size) {
+  return false;
+}
+
+chpl_bool chpl_comm_ofi_shm_put(void* addr, c_nodeid_t node, void* raddr,
+                                size_t size) {
+  return false;
+}
+
+#endif // __linux__
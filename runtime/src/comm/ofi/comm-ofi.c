@@ -40,6 +40,7 @@
 #include "chpl-mem-sys.h"
 #include "chplsys.h"
 #include "chpl-tasks.h"
+#include "chpl-thread-local-storage.h" // CHPL_TLS
 #include "chpl-topo.h"
 #include "chpltypes.h"
 #include "error.h"
@@ -136,6 +137,15 @@ static chpl_bool envPreferScalableTxEp; // env: prefer scalable tx endpoint?
 static int envCommConcurrency;          // env: communication concurrency
 static ssize_t envMaxHeapSize;          // env: max heap size
 static chpl_bool envOversubscribed;     // env over-subscribed?
+static chpl_bool envExecOnBatch;        // env: batch small nonblocking ons?
+static chpl_bool envAmoCombine;         // env: combine buffered AMOs?
+
+static int64_t envAmIdleSpinUs;         // env: AM handler spin before blocking
+
+static chpl_bool envCoopProgress;       // env: progress from task yields?
+static atomic_int_least64_t progressLastStallUs; // last worker comm stall
+
+static chpl_bool envAutoTune;           // env: calibrate injection params?
 
 static int numTxCtxs;
 static int numRxCtxs;
@@ -164,6 +174,19 @@ static chpl_bool tciTabBindTxCtxs;
 
 static size_t txCQLen;
 
+//
+// Auto-tuned communication parameters.  The injection size limit comes
+// from the provider and the CQ drain batch is sized for the worst case,
+// but the values that actually perform best differ from fabric to
+// fabric.  We start from the provider's values, let the environment
+// override them, and can optionally calibrate them at startup; see
+// init_ofiAutoTune() and init_ofiAutoTuneCalibrate().
+//
+static size_t injectSizeLimit;          // inject-vs-send crossover, in bytes
+static size_t txCQBatchSize;            // max CQ events drained per poll
+static chpl_bool injectSizeLimitFixed;  // imported; don't calibrate
+static chpl_bool txCQBatchSizeFixed;    // imported; don't calibrate
+
 //
 // Memory registration support.
 //
@@ -194,6 +217,12 @@ static struct fid_mr* ofiMrTab[MAX_MEM_REGIONS];
 
 #define AM_MAX_EXEC_ON_PAYLOAD_SIZE 1024
 
+//
+// Payloads up to this size are reassembled on the stack of the task
+// that runs a large on-stmt, instead of in a heap-allocated bundle.
+//
+#define AM_MAX_EXEC_ON_LRG_STACK_SPACE 8192
+
 struct amRequest_execOn_t {
   chpl_comm_on_bundle_t hdr;
   char space[AM_MAX_EXEC_ON_PAYLOAD_SIZE];
@@ -271,12 +300,20 @@ static chpl_comm_nb_handle_t ofi_put(const void*, c_nodeid_t, void*, size_t);
 static void ofi_put_lowLevel(const void*, void*, c_nodeid_t,
                              uint64_t, uint64_t, size_t, void*,
                              uint64_t, struct perTxCtxInfo_t*);
+static void ofi_put_V(int, void**, void**, c_nodeid_t*, void**, uint64_t*,
+                      size_t*);
 static void do_remote_put_buff(void*, c_nodeid_t, void*, size_t);
 static chpl_comm_nb_handle_t ofi_get(void*, c_nodeid_t, void*, size_t);
 static void ofi_get_lowLevel(void*, void*, c_nodeid_t,
                              uint64_t, uint64_t, size_t, void*,
                              uint64_t, struct perTxCtxInfo_t*);
+static void ofi_get_V(int, void**, void**, c_nodeid_t*, void**, uint64_t*,
+                      size_t*);
 static void do_remote_get_buff(void*, c_nodeid_t, void*, size_t);
+static chpl_comm_nb_handle_t rmaGetFn_selector(void*, void*, c_nodeid_t,
+                                               uint64_t, uint64_t,
+                                               size_t, void*,
+                                               struct perTxCtxInfo_t*);
 static void do_remote_amo_nf_buff(void*, c_nodeid_t, void*, size_t,
                                   enum fi_op, enum fi_datatype);
 static void amEnsureProgress(struct perTxCtxInfo_t*);
@@ -294,6 +331,8 @@ static void forceMemFxVisAllNodes_noTcip(chpl_bool, chpl_bool);
 static void* allocBounceBuf(size_t);
 static void freeBounceBuf(void*);
 static void local_yield(void);
+static void progressNoteStall(void);
+static chpl_bool workersRecentlyStalled(double);
 
 static void time_init(void);
 
@@ -781,10 +820,18 @@ chpl_comm_taskPrvData_t* get_comm_taskPrvdata(void) {
 #define MAX_CHAINED_PUT_LEN MAX_TXNS_IN_FLIGHT
 #define MAX_CHAINED_GET_LEN MAX_TXNS_IN_FLIGHT
 
+// How many nonblocking on-stmts we'll hold per task before flushing,
+// and how big each one's arg bundle may be.  The worst-case packed
+// batch (see struct amRequest_execOnBatch_t) has to fit in the AM
+// payload limit.
+#define MAX_CHAINED_XO_LEN 7
+#define XO_BATCH_MAX_BUNDLE_SIZE 128
+
 enum BuffType {
   amo_nf_buff = 1 << 0,
   get_buff    = 1 << 1,
-  put_buff    = 1 << 2
+  put_buff    = 1 << 2,
+  xo_buff     = 1 << 3
 };
 
 // Per task information about non-fetching AMO buffers
@@ -826,6 +873,88 @@ typedef struct {
   void*         local_mr_v[MAX_CHAINED_PUT_LEN];
 } put_buff_task_info_t;
 
+// Per task information about buffered nonblocking on-stmts
+typedef struct {
+  chpl_bool     new;
+  int           vi;
+  c_nodeid_t    locale_v[MAX_CHAINED_XO_LEN];
+  size_t        size_v[MAX_CHAINED_XO_LEN];
+  char          bundle_v[MAX_CHAINED_XO_LEN][XO_BATCH_MAX_BUNDLE_SIZE];
+} xo_buff_task_info_t;
+
+//
+// The task-local buffer info structs above are sizable and are
+// allocated when a task first buffers an unordered op, then freed when
+// the task ends.  Sustained-RMA phases that create many short-lived
+// tasks (RA-style patterns) turn that into steady allocator traffic,
+// so recycle the structs through small per-thread free lists instead.
+// The first word of a cached struct holds the free-list link; the
+// struct is zeroed again on reuse, matching CHPL_CALLOC_SZ.
+//
+#define TASK_LOCAL_BUFF_FREE_MAX 8
+
+#ifdef CHPL_TLS
+
+typedef struct {
+  void* head;
+  int cnt;
+} buff_free_list_t;
+
+static CHPL_TLS buff_free_list_t buff_free_lists[4];
+
+static inline
+buff_free_list_t* task_local_buff_free_list(enum BuffType t) {
+  switch (t) {
+    case amo_nf_buff: return &buff_free_lists[0];
+    case get_buff:    return &buff_free_lists[1];
+    case put_buff:    return &buff_free_lists[2];
+    case xo_buff:     return &buff_free_lists[3];
+  }
+  return NULL;
+}
+
+static inline
+void* task_local_buff_alloc(enum BuffType t, size_t size) {
+  buff_free_list_t* fl = task_local_buff_free_list(t);
+  void* p = fl->head;
+  if (p != NULL) {
+    fl->head = *(void**) p;
+    fl->cnt--;
+    memset(p, 0, size);
+  } else {
+    CHPL_CALLOC_SZ(p, 1, size);
+  }
+  return p;
+}
+
+static inline
+void task_local_buff_release(enum BuffType t, void* p) {
+  buff_free_list_t* fl = task_local_buff_free_list(t);
+  if (fl->cnt >= TASK_LOCAL_BUFF_FREE_MAX) {
+    chpl_mem_free(p, 0, 0);
+  } else {
+    *(void**) p = fl->head;
+    fl->head = p;
+    fl->cnt++;
+  }
+}
+
+#else
+
+static inline
+void* task_local_buff_alloc(enum BuffType t, size_t size) {
+  void* p;
+  CHPL_CALLOC_SZ(p, 1, size);
+  return p;
+}
+
+static inline
+void task_local_buff_release(enum BuffType t, void* p) {
+  chpl_mem_free(p, 0, 0);
+}
+
+#endif // CHPL_TLS
+
 // Acquire a task local buffer, initializing if needed
 static inline
 void* task_local_buff_acquire(enum BuffType t) {
@@ -836,7 +965,7 @@ void* task_local_buff_acquire(enum BuffType t) {
   if (t == TLS_NAME) {                                                  \
     TYPE* info = prvData->TLS_NAME;                                     \
     if (info == NULL) {                                                 \
-      CHPL_CALLOC_SZ(prvData->TLS_NAME, 1, sizeof(TYPE));               \
+      prvData->TLS_NAME = task_local_buff_alloc(TLS_NAME, sizeof(TYPE)); \
       info = prvData->TLS_NAME;                                         \
       info->new = true;                                                 \
       info->vi = 0;                                                     \
@@ -847,6 +976,7 @@ void* task_local_buff_acquire(enum BuffType t) {
   DEFINE_INIT(amo_nf_buff_task_info_t, amo_nf_buff);
   DEFINE_INIT(get_buff_task_info_t, get_buff);
   DEFINE_INIT(put_buff_task_info_t, put_buff);
+  DEFINE_INIT(xo_buff_task_info_t, xo_buff);
 
 #undef DEFINE_INIT
   return NULL;
@@ -855,6 +985,7 @@ void* task_local_buff_acquire(enum BuffType t) {
 static void amo_nf_buff_task_info_flush(amo_nf_buff_task_info_t* info);
 static void get_buff_task_info_flush(get_buff_task_info_t* info);
 static void put_buff_task_info_flush(put_buff_task_info_t* info);
+static void xo_buff_task_info_flush(xo_buff_task_info_t* info);
 
 // Flush one or more task local buffers
 static inline
@@ -874,6 +1005,7 @@ void task_local_buff_flush(enum BuffType t) {
                amo_nf_buff_task_info_flush);
   DEFINE_FLUSH(get_buff_task_info_t, get_buff, get_buff_task_info_flush);
   DEFINE_FLUSH(put_buff_task_info_t, put_buff, put_buff_task_info_flush);
+  DEFINE_FLUSH(xo_buff_task_info_t, xo_buff, xo_buff_task_info_flush);
 
 #undef DEFINE_FLUSH
 }
@@ -889,7 +1021,7 @@ void task_local_buff_end(enum BuffType t) {
     TYPE* info = prvData->TLS_NAME;                                     \
     if (info != NULL && info->vi > 0) {                                 \
       FLUSH_NAME(info);                                                 \
-      chpl_mem_free(info, 0, 0);                                        \
+      task_local_buff_release(TLS_NAME, info);                          \
       prvData->TLS_NAME = NULL;                                         \
     }                                                                   \
   }
@@ -898,6 +1030,7 @@ void task_local_buff_end(enum BuffType t) {
              amo_nf_buff_task_info_flush);
   DEFINE_END(get_buff_task_info_t, get_buff, get_buff_task_info_flush);
   DEFINE_END(put_buff_task_info_t, put_buff, put_buff_task_info_flush);
+  DEFINE_END(xo_buff_task_info_t, xo_buff, xo_buff_task_info_flush);
 
 #undef END
 }
@@ -921,6 +1054,8 @@ static void init_ofiForMem(void);
 static void init_ofiForRma(void);
 static void init_ofiForAms(void);
 static void init_ofiConnections(void);
+static void init_ofiAutoTune(void);
+static void init_ofiAutoTuneCalibrate(void);
 
 static void init_bar(void);
 
@@ -933,6 +1068,10 @@ static void init_broadcast_private(void);
 static chpl_bool mrGetKey(uint64_t*, uint64_t*, int, void*, size_t);
 static chpl_bool mrGetLocalKey(void*, size_t);
 static chpl_bool mrGetDesc(void**, void*, size_t);
+static void mrCacheInit(void);
+static void mrCacheFini(void);
+static chpl_bool mrCacheLocalize(void**, void*, size_t);
+static void mrCacheRelease(void*);
 
 void chpl_comm_init(int *argc_p, char ***argv_p) {
   chpl_comm_ofi_abort_on_error =
@@ -958,6 +1097,43 @@ void chpl_comm_init(int *argc_p, char ***argv_p) {
 
   envOversubscribed = chpl_env_rt_get_bool("OVERSUBSCRIBED", false);
 
+  envExecOnBatch = chpl_env_rt_get_bool("COMM_OFI_EXEC_ON_BATCH", false);
+
+  envAmoCombine = chpl_env_rt_get_bool("COMM_OFI_AMO_COMBINE", true);
+
+  //
+  // How long the AM handler keeps spin-polling after its last event
+  // before blocking on the wait set, when one is available.  This is
+  // the latency/CPU tradeoff knob: spinning handles bursty AM traffic
+  // with minimum latency, while blocking frees the core for
+  // co-scheduled work once traffic dies down.  -1 means never block
+  // (always spin); 0 means block as soon as a poll comes up empty.
+  //
+  envAmIdleSpinUs = chpl_env_rt_get_int("COMM_OFI_AM_IDLE_SPIN_US", 100);
+
+  //
+  // Whether tasks make network progress on their own bound transmit
+  // contexts whenever they yield.  Together with the AM handler's
+  // idle blocking (above) this forms an adaptive progress engine:
+  // when comm load is low the handler blocks and yield-driven
+  // progress carries the remaining traffic, and when workers start
+  // stalling on comm resources the handler is promoted back to
+  // dedicated spinning until the network quiets down again.
+  //
+  envCoopProgress = chpl_env_rt_get_bool("COMM_OFI_COOP_PROGRESS", true);
+
+  atomic_init_int_least64_t(&progressLastStallUs, 0);
+
+  //
+  // Whether to spend a short calibration phase at startup measuring the
+  // inject-vs-send crossover and CQ drain cost on this fabric, instead
+  // of accepting the provider's static values.  Calibrated values can
+  // be exported (CHPL_RT_COMM_OFI_AUTOTUNE_REPORT) and then imported
+  // via CHPL_RT_COMM_OFI_INJECT_SIZE and CHPL_RT_COMM_OFI_TX_CQ_BATCH
+  // so that production jobs skip the calibration.
+  //
+  envAutoTune = chpl_env_rt_get_bool("COMM_OFI_AUTOTUNE", false);
+
   //
   // The user can specify the provider by setting either the Chapel
   // CHPL_RT_COMM_OFI_PROVIDER environment variable or the libfabric
@@ -1013,6 +1189,7 @@ void init_ofi(void) {
   init_ofiFabricDomain();
   init_ofiDoProviderChecks();
   init_ofiEp();
+  init_ofiAutoTune();
   init_ofiExchangeAvInfo();
   init_ofiForMem();
   init_ofiForRma();
@@ -1027,6 +1204,9 @@ void init_ofi(void) {
   chpl_comm_ofi_oob_allgather(&odm, orderDummyMap, sizeof(orderDummyMap[0]));
 
   init_ofiConnections();
+  init_ofiAutoTuneCalibrate();
+
+  chpl_comm_ofi_shm_init();
 
   DBG_PRINTF(DBG_CFG,
              "AM config: recv buf size %zd MiB, %s, responses use %s",
@@ -2416,6 +2596,8 @@ void init_ofiForMem(void) {
     CHPL_CALLOC(memTabMap, chpl_numNodes);
     chpl_comm_ofi_oob_allgather(&memTab, memTabMap, sizeof(memTabMap[0]));
   }
+
+  mrCacheInit();
 }
 
 
@@ -2804,6 +2986,7 @@ void chpl_comm_exit(int all, int status) {
 
 static void exit_all(int status) {
   fini_ofi();
+  chpl_comm_ofi_shm_fini();
   chpl_comm_ofi_oob_fini();
 }
 
@@ -2834,6 +3017,8 @@ void fini_ofi(void) {
   if (chpl_numNodes <= 1)
     return;
 
+  mrCacheFini();
+
   for (int i = 0; i < memTabCount; i++) {
     OFI_CHK(fi_close(&ofiMrTab[i]->fid));
   }
@@ -3022,10 +3207,27 @@ void init_fixedHeap(void) {
   //
   size_t page_size;
   chpl_bool have_hugepages;
+  chpl_bool huge_by_size = false;
 
   if ((page_size = get_hugepageSize()) == 0) {
-    page_size = chpl_getSysPageSize();
-    have_hugepages = false;
+    //
+    // No hugetlbfs default is configured via the environment.  See
+    // whether the system has a hugepage pool whose page size suits a
+    // heap this big, so users get hugepages without hand-configuring
+    // HUGETLB_DEFAULT_PAGE_SIZE.  (We've just run get_hugepageSize(),
+    // so storing the choice into hugepageSize here is safe and lets
+    // chpl_comm_impl_regMemHeapPageSize() report it.)
+    //
+    if (chpl_numNodes > 1
+        && chpl_env_rt_get_bool("COMM_OFI_AUTO_HUGEPAGES", true)
+        && (page_size = chpl_comm_ofi_hp_choose_hugepagesize(size)) > 0) {
+      have_hugepages = true;
+      huge_by_size = true;
+      hugepageSize = page_size;
+    } else {
+      page_size = chpl_getSysPageSize();
+      have_hugepages = false;
+    }
   } else {
     have_hugepages = true;
   }
@@ -3056,7 +3258,9 @@ void init_fixedHeap(void) {
     }
 #endif
     if (have_hugepages) {
-      start = chpl_comm_ofi_hp_get_huge_pages(size);
+      start = huge_by_size
+              ? chpl_comm_ofi_hp_get_huge_pages_size(size, page_size)
+              : chpl_comm_ofi_hp_get_huge_pages(size);
     } else {
       CHK_SYS_MEMALIGN(start, page_size, size);
     }
@@ -3065,7 +3269,9 @@ void init_fixedHeap(void) {
   if (start == NULL)
     chpl_error("cannot create fixed heap: cannot get memory", 0, 0);
 
-  chpl_comm_regMemHeapTouch(start, size);
+  if (!chpl_comm_regMemHeapLazyTouch()) {
+    chpl_comm_regMemHeapTouch(start, size);
+  }
 
 #ifdef CHPL_COMM_DEBUG
   if (DBG_TEST_MASK(DBG_HEAP)) {
@@ -3152,6 +3358,189 @@ chpl_bool mrGetDesc(void** pDesc, void* addr, size_t size) {
 }
 
 
+//
+// With non-scalable memory registration only the fixed heap and a few
+// static regions are registered, so local buffers anywhere else have
+// to stage RMA through bounce buffers.  As an alternative, this cache
+// registers (pins) the pages underlying such a buffer on its first
+// RDMA use, letting later GETs and PUTs on it go zero-copy on the
+// initiating side.  When the table is full the least recently used
+// entry with no operations in flight is evicted and its registration
+// dropped.  Enable with CHPL_RT_COMM_OFI_MR_CACHE; the entry count can
+// be adjusted with CHPL_RT_COMM_OFI_MR_CACHE_SIZE.
+//
+
+struct mrcEntry {
+  void* addr;           // page-aligned start; NULL if the slot is free
+  size_t size;          // page-aligned extent
+  struct fid_mr* mr;
+  void* desc;
+  int refCount;         // operations in flight against this entry
+  uint64_t lastUse;     // for LRU replacement
+};
+
+static struct mrcEntry* mrcTab;     // NULL when the cache is disabled
+static int mrcTabLen;
+static uint64_t mrcUseCount;
+static uint64_t mrcKeySeq;
+static pthread_mutex_t mrcLock = PTHREAD_MUTEX_INITIALIZER;
+
+static
+void mrCacheInit(void) {
+  if (scalableMemReg
+      || !chpl_env_rt_get_bool("COMM_OFI_MR_CACHE", false)) {
+    return;
+  }
+
+  int64_t len = chpl_env_rt_get_int("COMM_OFI_MR_CACHE_SIZE", 64);
+  CHK_TRUE(len > 0);
+  mrcTabLen = (int) len;
+  CHPL_CALLOC(mrcTab, mrcTabLen);
+}
+
+
+static
+void mrCacheFini(void) {
+  if (mrcTab == NULL)
+    return;
+
+  for (int i = 0; i < mrcTabLen; i++) {
+    if (mrcTab[i].addr != NULL) {
+      OFI_CHK(fi_close(&mrcTab[i].mr->fid));
+    }
+  }
+  CHPL_FREE(mrcTab);
+}
+
+
+static
+chpl_bool mrCacheRegister(struct mrcEntry* ce, void* addr, size_t size) {
+  //
+  // Pin whole pages, hugepages if the job is set up for those, so that
+  // later accesses nearby land in the same entry.  The rounded span
+  // can extend past the end of the mapping, so if registering it fails
+  // fall back to the exact one.
+  //
+  size_t pgSize = get_hugepageSize();
+  if (pgSize == 0) {
+    pgSize = chpl_getSysPageSize();
+  }
+
+  uint64_t uaddr = (uint64_t) addr;
+  void* regAddr = (void*) ALIGN_DN(uaddr, (uint64_t) pgSize);
+  size_t regSize = ALIGN_UP(uaddr + size, (uint64_t) pgSize)
+                   - (uint64_t) regAddr;
+
+  const chpl_bool prov_key =
+    ((ofi_info->domain_attr->mr_mode & FI_MR_PROV_KEY) != 0);
+  const uint64_t acc = FI_SEND | FI_READ | FI_WRITE;
+  uint64_t key = prov_key ? 0 : (memTabSize + mrcKeySeq++);
+
+  struct fid_mr* mr;
+  if (fi_mr_reg(ofi_domain, regAddr, regSize, acc, 0, key, 0,
+                &mr, NULL) != 0) {
+    regAddr = addr;
+    regSize = size;
+    key = prov_key ? 0 : (memTabSize + mrcKeySeq++);
+    if (fi_mr_reg(ofi_domain, regAddr, regSize, acc, 0, key, 0,
+                  &mr, NULL) != 0) {
+      DBG_PRINTF(DBG_MR, "mrCacheRegister(%p, %#zx): cannot register",
+                 addr, size);
+      return false;
+    }
+  }
+
+  if ((ofi_info->domain_attr->mr_mode & FI_MR_ENDPOINT) != 0) {
+    OFI_CHK(fi_mr_bind(mr, &ofi_rxEp->fid, 0));
+    OFI_CHK(fi_mr_enable(mr));
+  }
+
+  ce->addr = regAddr;
+  ce->size = regSize;
+  ce->mr = mr;
+  ce->desc = fi_mr_desc(mr);
+  DBG_PRINTF(DBG_MR, "mrCacheRegister(%p, %#zx): pinned %p %#zx, desc %p",
+             addr, size, regAddr, regSize, ce->desc);
+  return true;
+}
+
+
+static
+chpl_bool mrCacheLocalize(void** pDesc, void* addr, size_t size) {
+  if (mrcTab == NULL)
+    return false;
+
+  chpl_bool ret = false;
+
+  PTHREAD_CHK(pthread_mutex_lock(&mrcLock));
+
+  struct mrcEntry* hit = NULL;
+  struct mrcEntry* victim = NULL;
+  for (int i = 0; i < mrcTabLen; i++) {
+    struct mrcEntry* ce = &mrcTab[i];
+    if (ce->addr == NULL) {
+      if (victim == NULL || victim->addr != NULL) {
+        victim = ce;
+      }
+    } else if ((char*) addr >= (char*) ce->addr
+               && (char*) addr + size <= (char*) ce->addr + ce->size) {
+      hit = ce;
+      break;
+    } else if (ce->refCount == 0
+               && (victim == NULL
+                   || (victim->addr != NULL
+                       && ce->lastUse < victim->lastUse))) {
+      victim = ce;
+    }
+  }
+
+  if (hit == NULL && victim != NULL) {
+    if (victim->addr != NULL) {
+      DBG_PRINTF(DBG_MR, "MR cache: evict %p %#zx",
+                 victim->addr, victim->size);
+      OFI_CHK(fi_close(&victim->mr->fid));
+      victim->addr = NULL;
+    }
+    if (mrCacheRegister(victim, addr, size)) {
+      hit = victim;
+    }
+  }
+
+  if (hit != NULL) {
+    hit->refCount++;
+    hit->lastUse = ++mrcUseCount;
+    *pDesc = hit->desc;
+    ret = true;
+  }
+
+  PTHREAD_CHK(pthread_mutex_unlock(&mrcLock));
+
+  return ret;
+}
+
+
+static
+void mrCacheRelease(void* addr) {
+  if (mrcTab == NULL)
+    return;
+
+  PTHREAD_CHK(pthread_mutex_lock(&mrcLock));
+
+  for (int i = 0; i < mrcTabLen; i++) {
+    struct mrcEntry* ce = &mrcTab[i];
+    if (ce->addr != NULL
+        && (char*) addr >= (char*) ce->addr
+        && (char*) addr < (char*) ce->addr + ce->size) {
+      CHK_TRUE(ce->refCount > 0);
+      ce->refCount--;
+      break;
+    }
+  }
+
+  PTHREAD_CHK(pthread_mutex_unlock(&mrcLock));
+}
+
+
 static inline
 void* mrLocalize(void** pDesc, const void* addr, size_t size,
                  chpl_bool isSource, const char* what) {
@@ -3159,11 +3548,15 @@ void* mrLocalize(void** pDesc, const void* addr, size_t size,
   if (mrAddr == NULL) {
     *pDesc = NULL;
   } else if (!mrGetDesc(pDesc, mrAddr, size)) {
-    mrAddr = allocBounceBuf(size);
-    DBG_PRINTF(DBG_MR_BB, "%s BB: %p", what, mrAddr);
-    CHK_TRUE(mrGetDesc(pDesc, mrAddr, size));
-    if (isSource) {
-      memcpy(mrAddr, addr, size);
+    if (mrCacheLocalize(pDesc, mrAddr, size)) {
+      DBG_PRINTF(DBG_MR_DESC, "%s MR cache: %p", what, mrAddr);
+    } else {
+      mrAddr = allocBounceBuf(size);
+      DBG_PRINTF(DBG_MR_BB, "%s BB: %p", what, mrAddr);
+      CHK_TRUE(mrGetDesc(pDesc, mrAddr, size));
+      if (isSource) {
+        memcpy(mrAddr, addr, size);
+      }
     }
   }
   return mrAddr;
@@ -3188,6 +3581,8 @@ static inline
 void mrUnLocalizeSource(void* mrAddr, const void* addr) {
   if (mrAddr != NULL && mrAddr != addr) {
     freeBounceBuf(mrAddr);
+  } else if (mrAddr != NULL) {
+    mrCacheRelease(mrAddr);
   }
 }
 
@@ -3197,6 +3592,8 @@ void mrUnLocalizeTarget(void* mrAddr, void* addr, size_t size) {
   if (mrAddr != NULL && mrAddr != addr) {
     memcpy(addr, mrAddr, size);
     freeBounceBuf(mrAddr);
+  } else if (mrAddr != NULL) {
+    mrCacheRelease(mrAddr);
   }
 }
 
@@ -3302,6 +3699,66 @@ void mcmReleaseOneNode(c_nodeid_t node, struct perTxCtxInfo_t* tcip,
 }
 
 
+//
+// Pipelined multi-node release.  Issue the dummy ordering GETs for a
+// batch of nodes before waiting on any of them, so a release across N
+// nodes costs roughly the longest single round trip instead of the
+// sum of them.  (This resolves the old TODO here about allowing
+// multiple release transactions outstanding at once.)
+//
+#define MCM_MAX_RELEASES_IN_FLIGHT 16
+
+struct mcmReleasePipe_t {
+  struct perTxCtxInfo_t* tcip;
+  const char* dbgOrderStr;
+  int n;
+  atomic_bool txnDone_v[MCM_MAX_RELEASES_IN_FLIGHT];
+};
+
+static
+void mcmReleasePipeDrain(struct mcmReleasePipe_t* pipe) {
+  struct perTxCtxInfo_t* tcip = pipe->tcip;
+  if (tcip->txCQ != NULL) {
+    for (int i = 0; i < pipe->n; i++) {
+      waitForTxnComplete(tcip, txnTrkEncodeDone(&pipe->txnDone_v[i]));
+      atomic_destroy_bool(&pipe->txnDone_v[i]);
+    }
+  } else if (pipe->n > 0) {
+    // counter-based completion: one wait covers all issued transactions
+    waitForTxnComplete(tcip, NULL);
+  }
+  pipe->n = 0;
+}
+
+static inline
+void mcmReleaseOneNodePipelined(c_nodeid_t node,
+                                struct mcmReleasePipe_t* pipe) {
+  struct perTxCtxInfo_t* tcip = pipe->tcip;
+
+  DBG_PRINTF(DBG_ORDER,
+             "dummy GET from %d for %s ordering (pipelined)",
+             (int) node, pipe->dbgOrderStr);
+
+  if (pipe->n == MCM_MAX_RELEASES_IN_FLIGHT) {
+    mcmReleasePipeDrain(pipe);
+  }
+
+  // unlike our callers, wrap_fi_read*() doesn't reserve CQ space
+  waitForCQSpace(tcip, 1);
+
+  uint64_t flags = (mcmMode == mcmm_msgOrdFence) ? FI_FENCE : 0;
+  void* ctx = NULL;
+  if (tcip->txCQ != NULL) {
+    atomic_init_bool(&pipe->txnDone_v[pipe->n], false);
+    ctx = txnTrkEncodeDone(&pipe->txnDone_v[pipe->n]);
+  }
+  pipe->n++;
+
+  ofi_get_lowLevel(orderDummy, orderDummyMRDesc, node,
+                   orderDummyMap[node].mrRaddr, orderDummyMap[node].mrKey,
+                   sizeof(*orderDummy), ctx, flags, tcip);
+}
+
 static
 void mcmReleaseAllNodes(struct bitmap_t* b1, struct bitmap_t* b2,
                         c_nodeid_t skipNode,
@@ -3313,9 +3770,9 @@ void mcmReleaseAllNodes(struct bitmap_t* b1, struct bitmap_t* b2,
   // either of two bitmaps.  The effects of the transactions we do
   // here don't matter, only their completions.
   //
-  // TODO: Allow multiple of these transactions outstanding at once,
-  //       instead of waiting for each one before firing the next.
-  //
+  struct mcmReleasePipe_t pipe = { .tcip = tcip,
+                                   .dbgOrderStr = dbgOrderStr,
+                                   .n = 0, };
   if (b1 == NULL) {
     if (b2 == NULL) {
       // Nothing to do.
@@ -3323,7 +3780,7 @@ void mcmReleaseAllNodes(struct bitmap_t* b1, struct bitmap_t* b2,
       BITMAP_FOREACH_SET(b2, node) {
         if (skipNode < 0 || node != skipNode) {
           (*tcip->checkTxCmplsFn)(tcip);
-          mcmReleaseOneNode(node, tcip, dbgOrderStr);
+          mcmReleaseOneNodePipelined(node, &pipe);
         }
       } BITMAP_FOREACH_SET_END
       bitmapZero(b2);
@@ -3333,7 +3790,7 @@ void mcmReleaseAllNodes(struct bitmap_t* b1, struct bitmap_t* b2,
       BITMAP_FOREACH_SET(b1, node) {
         if (skipNode < 0 || node != skipNode) {
           (*tcip->checkTxCmplsFn)(tcip);
-          mcmReleaseOneNode(node, tcip, dbgOrderStr);
+          mcmReleaseOneNodePipelined(node, &pipe);
         }
       } BITMAP_FOREACH_SET_END
       bitmapZero(b1);
@@ -3341,20 +3798,22 @@ void mcmReleaseAllNodes(struct bitmap_t* b1, struct bitmap_t* b2,
       BITMAP_FOREACH_SET_OR(b1, b2, node) {
         if (skipNode < 0 || node != skipNode) {
           (*tcip->checkTxCmplsFn)(tcip);
-          mcmReleaseOneNode(node, tcip, dbgOrderStr);
+          mcmReleaseOneNodePipelined(node, &pipe);
         }
       } BITMAP_FOREACH_SET_END
       bitmapZero(b1);
       bitmapZero(b2);
     }
   }
+
+  mcmReleasePipeDrain(&pipe);
 }
 
 
 void chpl_comm_impl_unordered_task_fence(void) {
   DBG_PRINTF(DBG_IFACE_MCM, "%s()", __func__);
 
-  task_local_buff_end(get_buff | put_buff | amo_nf_buff);
+  task_local_buff_end(get_buff | put_buff | amo_nf_buff | xo_buff);
 }
 
 
@@ -3370,7 +3829,7 @@ void chpl_comm_impl_task_create(void) {
 void chpl_comm_impl_task_end(void) {
   DBG_PRINTF(DBG_IFACE_MCM, "%s()", __func__);
 
-  task_local_buff_end(get_buff | put_buff | amo_nf_buff);
+  task_local_buff_end(get_buff | put_buff | amo_nf_buff | xo_buff);
   retireDelayedAmDone(true /*taskIsEnding*/);
   forceMemFxVisAllNodes_noTcip(true /*checkPuts*/, true /*checkAmos*/);
 }
@@ -3390,6 +3849,7 @@ typedef enum {
   am_opFree,                               // free some memory
   am_opNop,                                // do nothing; for MCM & liveness
   am_opShutdown,                           // signal main process for shutdown
+  am_opExecOnBatch,                        // batched small nonblocking on-stmts
 } amOp_t;
 
 #ifdef CHPL_COMM_DEBUG
@@ -3450,6 +3910,18 @@ struct amRequest_free_t {
   void* p;                      // address to free, on AM target node
 };
 
+//
+// A batch of small nonblocking on-stmt requests for one target node,
+// run there as a loop.  'payload' holds 'numBundles' packed entries,
+// each a size_t argSize followed by that many arg bundle bytes, with
+// the next entry starting at the following 8-byte boundary.
+//
+struct amRequest_execOnBatch_t {
+  struct amRequest_base_t b;
+  size_t numBundles;
+  char payload[AM_MAX_EXEC_ON_PAYLOAD_SIZE];
+};
+
 typedef union {
   struct amRequest_base_t b;
   struct amRequest_execOn_t xo;      // present only to set the max req size
@@ -3457,6 +3929,7 @@ typedef union {
   struct amRequest_RMA_t rma;
   struct amRequest_AMO_t amo;
   struct amRequest_free_t free;
+  struct amRequest_execOnBatch_t xob;
 } amRequest_t;
 
 struct taskArg_RMA_t {
@@ -3563,6 +4036,40 @@ void chpl_comm_execute_on_fast(c_nodeid_t node, c_sublocid_t subloc,
 }
 
 
+//
+// Try to add a small nonblocking on-stmt to the current task's batch
+// buffer instead of sending it right away.  Returns true if the
+// request was buffered; it will go out with the rest of its batch
+// when the buffer fills, on the task's next blocking AM, or at task
+// end.  Returns false if the caller should send it individually.
+//
+static
+chpl_bool amTryBatchExecOn(c_nodeid_t node, chpl_comm_on_bundle_t* arg,
+                           size_t argSize) {
+  xo_buff_task_info_t* info;
+  if ((info = task_local_buff_acquire(xo_buff)) == NULL) {
+    return false;
+  }
+
+  info->new = false;
+
+  int vi = info->vi;
+  info->locale_v[vi] = node;
+  info->size_v[vi] = argSize;
+  memcpy(&info->bundle_v[vi][0], arg, argSize);
+  info->vi++;
+
+  DBG_PRINTF(DBG_AM | DBG_AM_SEND,
+             "amTryBatchExecOn(): buffered on-stmt %d for %d, sz %zd",
+             vi, (int) node, argSize);
+
+  // flush if buffer is full
+  if (info->vi == MAX_CHAINED_XO_LEN) {
+    xo_buff_task_info_flush(info);
+  }
+  return true;
+}
+
 static inline
 void amRequestExecOn(c_nodeid_t node, c_sublocid_t subloc,
                      chpl_fn_int_t fid,
@@ -3579,6 +4086,19 @@ void amRequestExecOn(c_nodeid_t node, c_sublocid_t subloc,
                                          .subloc = subloc,
                                          .argSize = argSize, };
 
+  if (envExecOnBatch) {
+    if (!blocking && argSize <= XO_BATCH_MAX_BUNDLE_SIZE) {
+      arg->kind = am_opExecOn;
+      if (amTryBatchExecOn(node, arg, argSize)) {
+        return;
+      }
+    } else {
+      // Anything we can't batch flushes what we've batched so far, so
+      // the target sees this task's on-stmts in the order it ran them.
+      task_local_buff_flush(xo_buff);
+    }
+  }
+
   if (argSize <= sizeof(amRequest_t)) {
     //
     // The arg bundle will fit in max-sized AM request; just send it.
@@ -3882,6 +4402,7 @@ void amReqFn_msgOrdFence(c_nodeid_t node,
   switch (req->b.op) {
   case am_opExecOn:
   case am_opExecOnLrg:
+  case am_opExecOnBatch:
     forceMemFxVisAllNodes(true /*checkPuts*/, true /*checkAmos*/,
                           node /*skipNode*/, tcip);
     havePutsOut = (tcip->putVisBitmap != NULL
@@ -3920,7 +4441,7 @@ void amReqFn_msgOrdFence(c_nodeid_t node,
     // just collect the completion later.  Otherwise, wait for it here.
     //
     if (!blocking
-        && reqSize <= ofi_info->tx_attr->inject_size) {
+        && reqSize <= injectSizeLimit) {
       void* ctx = txnTrkEncodeId(__LINE__);
       uint64_t flags = FI_FENCE | FI_INJECT;
       (void) wrap_fi_sendmsg(node, req, reqSize, mrDesc, ctx, flags, tcip);
@@ -3972,6 +4493,7 @@ void amReqFn_msgOrd(c_nodeid_t node,
   switch (req->b.op) {
   case am_opExecOn:
   case am_opExecOnLrg:
+  case am_opExecOnBatch:
     forceMemFxVisAllNodes(true /*checkPuts*/, true /*checkAmos*/,
                           -1 /*skipNode*/, tcip);
     break;
@@ -3990,7 +4512,7 @@ void amReqFn_msgOrd(c_nodeid_t node,
   }
 
   if (!blocking
-      && reqSize <= ofi_info->tx_attr->inject_size) {
+      && reqSize <= injectSizeLimit) {
     //
     // Special case: injection is the quickest.  We use that if this is
     // a non-blocking AM and the size doesn't exceed the injection size
@@ -4171,6 +4693,7 @@ static void processRxAmReq(struct perTxCtxInfo_t*);
 static void amHandleExecOn(chpl_comm_on_bundle_t*);
 static void amWrapExecOnBody(void*);
 static void amHandleExecOnLrg(chpl_comm_on_bundle_t*);
+static void amHandleExecOnBatch(struct amRequest_execOnBatch_t*);
 static void amWrapExecOnLrgBody(struct amRequest_execOnLrg_t*);
 static void amWrapGet(struct taskArg_RMA_t*);
 static void amWrapPut(struct taskArg_RMA_t*);
@@ -4253,18 +4776,39 @@ void amHandler(void* argNil) {
   //
   // Process AM requests and watch transmit responses arrive.
   //
+  // Between events we adapt: keep spin-polling for a while after the
+  // last event (envAmIdleSpinUs), so that bursty AM traffic sees only
+  // polling latency, and block on the wait set once traffic has died
+  // down, so that an idle handler doesn't monopolize a core.  The wait
+  // still times out so that liveness checks and the exit flag get
+  // looked at regularly even when the network is quiet.
+  //
+  // Recent worker-side comm stalls (see progressNoteStall()) also
+  // hold us in spin mode: they mean cooperative progress from task
+  // yields isn't keeping up, so this is where a dedicated progress
+  // core pays for itself.
+  //
+  double idleSince = -1.0;
   while (!atomic_load_bool(&amHandlersExit)) {
     chpl_bool hadRxEvent, hadTxEvent;
     amCheckRxTxCmpls(&hadRxEvent, &hadTxEvent, tcip);
     if (hadRxEvent) {
       processRxAmReq(tcip);
-    } else if (!hadTxEvent) {
-      //
-      // No activity; avoid CPU monopolization.
-      //
-      int ret;
-      OFI_CHK_3(fi_wait(ofi_amhWaitSet, 100 /*ms*/), ret,
-                -FI_EINTR, -FI_ETIMEDOUT);
+    }
+    if (hadRxEvent || hadTxEvent) {
+      idleSince = -1.0;
+    } else if (envAmIdleSpinUs >= 0) {
+      double now = chpl_comm_ofi_time_get();
+      if (idleSince < 0.0) {
+        idleSince = now;
+      }
+      if ((now - idleSince) * 1e6 >= (double) envAmIdleSpinUs
+          && !workersRecentlyStalled(now)) {
+        int ret;
+        OFI_CHK_3(fi_wait(ofi_amhWaitSet, 100 /*ms*/), ret,
+                  -FI_EINTR, -FI_ETIMEDOUT);
+        idleSince = -1.0;
+      }
     }
 
     if (amDoLivenessChecks) {
@@ -4329,6 +4873,10 @@ void processRxAmReq(struct perTxCtxInfo_t* tcip) {
         amHandleExecOnLrg(&req->xol.hdr);
         break;
 
+      case am_opExecOnBatch:
+        amHandleExecOnBatch(&req->xob);
+        break;
+
       case am_opGet:
         {
           struct taskArg_RMA_t arg = { .hdr.kind = CHPL_ARG_BUNDLE_KIND_TASK,
@@ -4399,6 +4947,22 @@ void amHandleExecOn(chpl_comm_on_bundle_t* req) {
 }
 
 
+static
+void amHandleExecOnBatch(struct amRequest_execOnBatch_t* batch) {
+  //
+  // Start the batched on-stmts in arrival order.  startMovedTask
+  // copies each arg bundle, so we can process straight out of the AM
+  // landing zone.
+  //
+  char* p = batch->payload;
+  for (size_t i = 0; i < batch->numBundles; i++) {
+    size_t argSize = *(size_t*) p;
+    amHandleExecOn((chpl_comm_on_bundle_t*) (p + sizeof(size_t)));
+    p += sizeof(size_t) + ((argSize + 7) & ~(size_t) 7);
+  }
+}
+
+
 static inline
 void amWrapExecOnBody(void* p) {
   DBG_PRINTF(DBG_AM | DBG_AM_RECV, "%s", am_reqStartStr(p));
@@ -4428,13 +4992,6 @@ static
 void amWrapExecOnLrgBody(struct amRequest_execOnLrg_t* xol) {
   DBG_PRINTF(DBG_AM | DBG_AM_RECV, "%s", am_reqStartStr((amRequest_t*) xol));
 
-  //
-  // TODO: We could stack-allocate "bundle" here, if it was small enough
-  //       (TBD) not to create the potential for stack overflow.  Some
-  //       systems have fast enough networks that saving the dynamic
-  //       alloc should be performance-visible.
-  //
-
   //
   // The bundle header is in our argument, but we have to retrieve the
   // payload from the initiating side.
@@ -4442,8 +4999,24 @@ void amWrapExecOnLrgBody(struct amRequest_execOnLrg_t* xol) {
   chpl_comm_bundleData_t* comm = &xol->hdr.comm;
   c_nodeid_t node = comm->node;
 
+  //
+  // Stack-allocate the bundle if it's small enough not to create the
+  // potential for stack overflow.  We're in a full-fledged task here,
+  // not the AM handler, and some systems have fast enough networks
+  // that saving the dynamic alloc is performance-visible.
+  //
+  struct {
+    chpl_comm_on_bundle_t hdr;
+    char space[AM_MAX_EXEC_ON_LRG_STACK_SPACE];
+  } bundleOnStack;
+  chpl_bool bundleOnHeap = (comm->argSize > sizeof(bundleOnStack));
+
   chpl_comm_on_bundle_t* bundle;
-  CHPL_CALLOC_SZ(bundle, 1, comm->argSize);
+  if (bundleOnHeap) {
+    CHPL_CALLOC_SZ(bundle, 1, comm->argSize);
+  } else {
+    bundle = &bundleOnStack.hdr;
+  }
   *bundle = xol->hdr;
 
   size_t payloadSize = comm->argSize
@@ -4474,7 +5047,9 @@ void amWrapExecOnLrgBody(struct amRequest_execOnLrg_t* xol) {
     amPutDone(node, comm->pAmDone);
   }
 
-  CHPL_FREE(bundle);
+  if (bundleOnHeap) {
+    CHPL_FREE(bundle);
+  }
 }
 
 
@@ -4639,9 +5214,71 @@ void amCheckLiveness(void) {
 // Interface: RMA
 //
 
+//
+// Nonblocking GET handles.  A handle tracks one in-flight RMA GET on a
+// tx context bound to the initiating thread.  The handle's 'txnDone'
+// flag is the transaction's libfabric context; the CQ progress code
+// stores to it exactly once, and only the owning task reads it, with
+// acquire loads, so completion needs no other synchronization.  Handles
+// come from per-thread free lists, making steady-state allocation just
+// a couple of pointer updates.
+//
+struct nbHandle_t {
+  atomic_bool txnDone;          // transaction's network completion flag
+  struct perTxCtxInfo_t* tcip;  // bound tx context the GET went out on
+  void* myAddr;                 // localized target buffer
+  void* addr;                   // caller's target buffer
+  size_t size;
+  struct nbHandle_t* next;      // free list linkage
+};
+
+static __thread struct nbHandle_t* nbHandleFreeList;
+
+static inline
+struct nbHandle_t* nbHandleAlloc(void) {
+  struct nbHandle_t* h;
+  if ((h = nbHandleFreeList) != NULL) {
+    nbHandleFreeList = h->next;
+  } else {
+    h = chpl_mem_alloc(sizeof(*h), CHPL_RT_MD_COMM_PER_LOC_INFO, 0, 0);
+  }
+  return h;
+}
+
+static inline
+void nbHandleFree(struct nbHandle_t* h) {
+  h->next = nbHandleFreeList;
+  nbHandleFreeList = h;
+}
+
+//
+// Retire the given handle if its transaction has completed: deliver
+// the result into the caller's buffer if we had to bounce-buffer it,
+// recycle the handle, and NULL out the caller's handle slot.  Returns
+// whether the transaction had indeed completed.
+//
+static inline
+chpl_bool nbHandleRetire(chpl_comm_nb_handle_t* ph) {
+  struct nbHandle_t* h = (struct nbHandle_t*) *ph;
+  if (!atomic_load_explicit_bool(&h->txnDone, memory_order_acquire)) {
+    return false;
+  }
+  mrUnLocalizeTarget(h->myAddr, h->addr, h->size);
+  atomic_destroy_bool(&h->txnDone);
+  nbHandleFree(h);
+  *ph = NULL;
+  return true;
+}
+
+
 chpl_comm_nb_handle_t chpl_comm_put_nb(void* addr, c_nodeid_t node,
                                        void* raddr, size_t size,
                                        int32_t commID, int ln, int32_t fn) {
+  //
+  // Just do a blocking PUT.  Tracking the memory consistency effects
+  // of unretired nonblocking PUTs would complicate the MCM bookkeeping
+  // considerably, and our latency-hiding idioms are all GET-based.
+  //
   chpl_comm_put(addr, node, raddr, size, commID, ln, fn);
   return NULL;
 }
@@ -4650,15 +5287,70 @@ chpl_comm_nb_handle_t chpl_comm_put_nb(void* addr, c_nodeid_t node,
 chpl_comm_nb_handle_t chpl_comm_get_nb(void* addr, c_nodeid_t node,
                                        void* raddr, size_t size,
                                        int32_t commID, int ln, int32_t fn) {
-  chpl_comm_get(addr, node, raddr, size, commID, ln, fn);
-  return NULL;
+  DBG_PRINTF(DBG_IFACE,
+             "%s(%p, %d, %p, %zd, %d)", __func__,
+             addr, (int) node, raddr, size, (int) commID);
+
+  //
+  // We can only track the transaction on its own if the remote address
+  // is directly accessible, the provider will move the whole thing in
+  // one transfer, and we have a tx context with a completion queue,
+  // bound to this thread so that it outlives our return.  Otherwise,
+  // fall back on a blocking GET and return the always-complete handle.
+  //
+  uint64_t mrKey;
+  uint64_t mrRaddr;
+  if (node != chpl_nodeID
+      && size > 0
+      && size <= ofi_info->ep_attr->max_msg_size
+      && mrGetKey(&mrKey, &mrRaddr, node, raddr, size)) {
+    struct perTxCtxInfo_t* tcip;
+    CHK_TRUE((tcip = tciAlloc()) != NULL);
+    if (tcip->bound && tcip->txCQ != NULL) {
+      retireDelayedAmDone(false /*taskIsEnding*/);
+
+      // Communications callback support
+      if (chpl_comm_have_callbacks(chpl_comm_cb_event_kind_get_nb)) {
+        chpl_comm_cb_info_t cb_data =
+          {chpl_comm_cb_event_kind_get_nb, chpl_nodeID, node,
+           .iu.comm={addr, raddr, size, commID, ln, fn}};
+        chpl_comm_do_callbacks (&cb_data);
+      }
+
+      chpl_comm_diags_verbose_rdma("get_nb", node, size, ln, fn, commID);
+      chpl_comm_diags_incr(get_nb);
+
+      waitForCQSpace(tcip, 1);
+
+      void* mrDesc;
+      void* myAddr = mrLocalizeTarget(&mrDesc, addr, size, "GET tgt");
+
+      struct nbHandle_t* h = nbHandleAlloc();
+      atomic_init_bool(&h->txnDone, false);
+      h->tcip = tcip;
+      h->myAddr = myAddr;
+      h->addr = addr;
+      h->size = size;
+
+      (void) rmaGetFn_selector(myAddr, mrDesc, node, mrRaddr, mrKey, size,
+                               txnTrkEncodeDone(&h->txnDone), tcip);
+      return (chpl_comm_nb_handle_t) h;
+    }
+    tciFree(tcip);
+  }
+
+  chpl_comm_get(addr, node, raddr, size, commID, ln, fn);
+  return NULL;
 }
 
 
 int chpl_comm_test_nb_complete(chpl_comm_nb_handle_t h) {
   chpl_comm_diags_incr(test_nb);
 
-  // fi_cq_readfrom?
+  //
+  // Handles are cleared out by the wait/try interfaces when their
+  // transactions are retired; only those calls make network progress.
+  //
   return ((void*) h) == NULL;
 }
 
@@ -4666,10 +5358,27 @@ int chpl_comm_test_nb_complete(chpl_comm_nb_handle_t h) {
 void chpl_comm_wait_nb_some(chpl_comm_nb_handle_t* h, size_t nhandles) {
   chpl_comm_diags_incr(wait_nb);
 
-  size_t i;
-  // fi_cq_readfrom?
-  for( i = 0; i < nhandles; i++ ) {
-    CHK_TRUE(h[i] == NULL);
+  size_t nOutstanding = 0;
+  for (size_t i = 0; i < nhandles; i++) {
+    if (h[i] != NULL) {
+      nOutstanding++;
+    }
+  }
+  if (nOutstanding == 0) {
+    return;
+  }
+
+  while (true) {
+    for (size_t i = 0; i < nhandles; i++) {
+      if (h[i] != NULL) {
+        (*((struct nbHandle_t*) h[i])->tcip
+           ->ensureProgressFn)(((struct nbHandle_t*) h[i])->tcip);
+        if (nbHandleRetire(&h[i])) {
+          return;
+        }
+      }
+    }
+    local_yield();
   }
 }
 
@@ -4677,12 +5386,17 @@ void chpl_comm_wait_nb_some(chpl_comm_nb_handle_t* h, size_t nhandles) {
 int chpl_comm_try_nb_some(chpl_comm_nb_handle_t* h, size_t nhandles) {
   chpl_comm_diags_incr(try_nb);
 
-  size_t i;
-  // fi_cq_readfrom?
-  for( i = 0; i < nhandles; i++ ) {
-    CHK_TRUE(h[i] == NULL);
+  int anyRetired = 0;
+  for (size_t i = 0; i < nhandles; i++) {
+    if (h[i] != NULL) {
+      (*((struct nbHandle_t*) h[i])->tcip
+         ->ensureProgressFn)(((struct nbHandle_t*) h[i])->tcip);
+      if (nbHandleRetire(&h[i])) {
+        anyRetired = 1;
+      }
+    }
   }
-  return 0;
+  return anyRetired;
 }
 
 
@@ -4720,6 +5434,10 @@ void chpl_comm_put(void* addr, c_nodeid_t node, void* raddr,
   chpl_comm_diags_verbose_rdma("put", node, size, ln, fn, commID);
   chpl_comm_diags_incr(put);
 
+  if (chpl_comm_ofi_shm_put(addr, node, raddr, size)) {
+    return;
+  }
+
   (void) ofi_put(addr, node, raddr, size);
 }
 
@@ -4758,10 +5476,124 @@ void chpl_comm_get(void* addr, int32_t node, void* raddr,
   chpl_comm_diags_verbose_rdma("get", node, size, ln, fn, commID);
   chpl_comm_diags_incr(get);
 
+  if (chpl_comm_ofi_shm_get(addr, node, raddr, size)) {
+    return;
+  }
+
   (void) ofi_get(addr, node, raddr, size);
 }
 
 
+//
+// Native strided transfers.  Instead of issuing each contiguous block
+// of a strided pattern as its own blocking transaction, walk the
+// pattern once with strd_common_call() and inject the blocks in
+// chained groups via the vectored RMA machinery (ofi_put_V() and
+// ofi_get_V()).  Blocks whose remote side we have no RMA key for, or
+// whose local side we have no descriptor for, take the ordinary
+// one-at-a-time path instead; the blocks of a single strided transfer
+// are disjoint, so mixing the two paths is fine.  Both V functions
+// and the fallbacks wait for full completion (and for PUTs, remote
+// visibility) before returning, so the blocking semantics of the
+// interface are preserved.
+//
+
+struct putStrdCtx_t {
+  int        vi;
+  void*      src_addr_v[MAX_CHAINED_PUT_LEN];
+  void*      local_mr_v[MAX_CHAINED_PUT_LEN];
+  c_nodeid_t locale_v[MAX_CHAINED_PUT_LEN];
+  void*      tgt_addr_v[MAX_CHAINED_PUT_LEN];
+  uint64_t   remote_mr_v[MAX_CHAINED_PUT_LEN];
+  size_t     size_v[MAX_CHAINED_PUT_LEN];
+};
+
+static
+void putStrdBlock(void* dstaddr, int32_t node, void* srcaddr, size_t size,
+                  void* ctx, int32_t commID, int ln, int32_t fn) {
+  struct putStrdCtx_t* b = (struct putStrdCtx_t*) ctx;
+  uint64_t mrKey;
+  uint64_t mrRaddr;
+  void* mrDesc;
+
+  if (size == 0) {
+    return;
+  }
+
+  if (node == chpl_nodeID) {
+    memmove(dstaddr, srcaddr, size);
+    return;
+  }
+
+  if (!mrGetKey(&mrKey, &mrRaddr, node, dstaddr, size)
+      || !mrGetDesc(&mrDesc, srcaddr, size)) {
+    (void) ofi_put(srcaddr, node, dstaddr, size);
+    return;
+  }
+
+  int vi = b->vi;
+  b->src_addr_v[vi] = srcaddr;
+  b->local_mr_v[vi] = mrDesc;
+  b->locale_v[vi] = node;
+  b->tgt_addr_v[vi] = (void*) mrRaddr;
+  b->remote_mr_v[vi] = mrKey;
+  b->size_v[vi] = size;
+  if (++b->vi == MAX_CHAINED_PUT_LEN) {
+    ofi_put_V(b->vi, b->src_addr_v, b->local_mr_v, b->locale_v,
+              b->tgt_addr_v, b->remote_mr_v, b->size_v);
+    b->vi = 0;
+  }
+}
+
+
+struct getStrdCtx_t {
+  int        vi;
+  void*      tgt_addr_v[MAX_CHAINED_GET_LEN];
+  void*      local_mr_v[MAX_CHAINED_GET_LEN];
+  c_nodeid_t locale_v[MAX_CHAINED_GET_LEN];
+  void*      src_addr_v[MAX_CHAINED_GET_LEN];
+  uint64_t   remote_mr_v[MAX_CHAINED_GET_LEN];
+  size_t     size_v[MAX_CHAINED_GET_LEN];
+};
+
+static
+void getStrdBlock(void* dstaddr, int32_t node, void* srcaddr, size_t size,
+                  void* ctx, int32_t commID, int ln, int32_t fn) {
+  struct getStrdCtx_t* b = (struct getStrdCtx_t*) ctx;
+  uint64_t mrKey;
+  uint64_t mrRaddr;
+  void* mrDesc;
+
+  if (size == 0) {
+    return;
+  }
+
+  if (node == chpl_nodeID) {
+    memmove(dstaddr, srcaddr, size);
+    return;
+  }
+
+  if (!mrGetKey(&mrKey, &mrRaddr, node, srcaddr, size)
+      || !mrGetDesc(&mrDesc, dstaddr, size)) {
+    (void) ofi_get(dstaddr, node, srcaddr, size);
+    return;
+  }
+
+  int vi = b->vi;
+  b->tgt_addr_v[vi] = dstaddr;
+  b->local_mr_v[vi] = mrDesc;
+  b->locale_v[vi] = node;
+  b->src_addr_v[vi] = (void*) mrRaddr;
+  b->remote_mr_v[vi] = mrKey;
+  b->size_v[vi] = size;
+  if (++b->vi == MAX_CHAINED_GET_LEN) {
+    ofi_get_V(b->vi, b->tgt_addr_v, b->local_mr_v, b->locale_v,
+              b->src_addr_v, b->remote_mr_v, b->size_v);
+    b->vi = 0;
+  }
+}
+
+
 void chpl_comm_put_strd(void* dstaddr_arg, size_t* dststrides,
                         c_nodeid_t dstnode,
                         void* srcaddr_arg, size_t* srcstrides,
@@ -4772,12 +5604,32 @@ void chpl_comm_put_strd(void* dstaddr_arg, size_t* dststrides,
              dstaddr_arg, dststrides, (int) dstnode, srcaddr_arg, srcstrides,
              count, (int) stridelevels, elemSize, (int) commID);
 
-  put_strd_common(dstaddr_arg, dststrides,
-                  dstnode,
-                  srcaddr_arg, srcstrides,
-                  count, stridelevels, elemSize,
-                  1, NULL,
-                  commID, ln, fn);
+  // Communications callback support
+  if (chpl_comm_have_callbacks(chpl_comm_cb_event_kind_put_strd)) {
+      chpl_comm_cb_info_t cb_data =
+        {chpl_comm_cb_event_kind_put_strd, chpl_nodeID, dstnode,
+         .iu.comm_strd={srcaddr_arg, srcstrides, dstaddr_arg, dststrides,
+                        count, stridelevels, elemSize, commID, ln, fn}};
+      chpl_comm_do_callbacks (&cb_data);
+  }
+
+  chpl_comm_diags_verbose_rdmaStrd("put", dstnode, ln, fn, commID);
+  if (dstnode != chpl_nodeID) {
+    chpl_comm_diags_incr(put);
+  }
+
+  struct putStrdCtx_t ctx;
+  ctx.vi = 0;
+  strd_common_call(dstaddr_arg, dststrides,
+                   dstnode,
+                   srcaddr_arg, srcstrides,
+                   count, stridelevels, elemSize,
+                   &ctx, putStrdBlock,
+                   commID, ln, fn);
+  if (ctx.vi > 0) {
+    ofi_put_V(ctx.vi, ctx.src_addr_v, ctx.local_mr_v, ctx.locale_v,
+              ctx.tgt_addr_v, ctx.remote_mr_v, ctx.size_v);
+  }
 }
 
 
@@ -4791,12 +5643,32 @@ void chpl_comm_get_strd(void* dstaddr_arg, size_t* dststrides,
              dstaddr_arg, dststrides, (int) srcnode, srcaddr_arg, srcstrides,
              count, (int) stridelevels, elemSize, (int) commID);
 
-  get_strd_common(dstaddr_arg, dststrides,
-                  srcnode,
-                  srcaddr_arg, srcstrides,
-                  count, stridelevels, elemSize,
-                  1, NULL,
-                  commID, ln, fn);
+  // Communications callback support
+  if (chpl_comm_have_callbacks(chpl_comm_cb_event_kind_get_strd)) {
+      chpl_comm_cb_info_t cb_data =
+        {chpl_comm_cb_event_kind_get_strd, chpl_nodeID, srcnode,
+         .iu.comm_strd={srcaddr_arg, srcstrides, dstaddr_arg, dststrides,
+                        count, stridelevels, elemSize, commID, ln, fn}};
+      chpl_comm_do_callbacks (&cb_data);
+  }
+
+  chpl_comm_diags_verbose_rdmaStrd("get", srcnode, ln, fn, commID);
+  if (srcnode != chpl_nodeID) {
+    chpl_comm_diags_incr(get);
+  }
+
+  struct getStrdCtx_t ctx;
+  ctx.vi = 0;
+  strd_common_call(dstaddr_arg, dststrides,
+                   srcnode,
+                   srcaddr_arg, srcstrides,
+                   count, stridelevels, elemSize,
+                   &ctx, getStrdBlock,
+                   commID, ln, fn);
+  if (ctx.vi > 0) {
+    ofi_get_V(ctx.vi, ctx.tgt_addr_v, ctx.local_mr_v, ctx.locale_v,
+              ctx.src_addr_v, ctx.remote_mr_v, ctx.size_v);
+  }
 }
 
 
@@ -5061,6 +5933,66 @@ void tciFree(struct perTxCtxInfo_t* tcip) {
 }
 
 
+////////////////////////////////////////
+//
+// Adaptive comm progress
+//
+
+//
+// Workers record a timestamp whenever they stall on a comm resource
+// (a full transmit CQ, or a transaction that has to be waited out).
+// A recent stall means yield-driven cooperative progress isn't
+// keeping up with the comm load, and holds the AM handler in
+// dedicated spin-polling; once the stalls age out past the idle-spin
+// window the handler blocks again and its core is recovered for
+// compute.
+//
+static
+void progressNoteStall(void) {
+  if (chpl_numNodes > 1) {
+    atomic_store_int_least64_t(&progressLastStallUs,
+                               (int_least64_t)
+                               (chpl_comm_ofi_time_get() * 1.0e6));
+  }
+}
+
+static
+chpl_bool workersRecentlyStalled(double now) {
+  int_least64_t lastUs = atomic_load_int_least64_t(&progressLastStallUs);
+  return (now * 1.0e6 - (double) lastUs) < (double) envAmIdleSpinUs;
+}
+
+//
+// Cooperative progress from task yield points, via the tasking
+// layer's chpl_comm_task_yield() hook.  Only this thread's bound
+// transmit context may be touched here: bound tciTab[] entries belong
+// to their thread for good, while unbound ones can be handed between
+// threads, and we may be running in the middle of someone else's
+// tciAlloc()/tciFree() window.  Reading our own CQ retires our
+// outstanding transactions (including nonblocking-GET handles) and,
+// for manual-progress providers, drives the provider's progress
+// engine as well.
+//
+void chpl_comm_impl_task_yield(void) {
+  static __thread chpl_bool inYieldProgress;
+
+  if (chpl_numNodes <= 1 || !envCoopProgress || isAmHandler
+      || ofi_info == NULL || inYieldProgress)
+    return;
+
+  struct perTxCtxInfo_t* tcip = _ttcip;
+  if (tcip == NULL || !tcip->bound)
+    return;
+
+  if (tcip->numTxnsOut > 0
+      || ofi_info->domain_attr->data_progress == FI_PROGRESS_MANUAL) {
+    inYieldProgress = true;
+    (*tcip->ensureProgressFn)(tcip);
+    inYieldProgress = false;
+  }
+}
+
+
 static inline
 void waitForCQSpace(struct perTxCtxInfo_t* tcip, size_t len) {
   //
@@ -5069,6 +6001,7 @@ void waitForCQSpace(struct perTxCtxInfo_t* tcip, size_t len) {
   if (tcip->txCQ != NULL && txCQLen - tcip->numTxnsOut < len) {
     (*tcip->checkTxCmplsFn)(tcip);
     while (txCQLen - tcip->numTxnsOut < len) {
+      progressNoteStall();
       sched_yield();
       (*tcip->checkTxCmplsFn)(tcip);
     }
@@ -5203,7 +6136,7 @@ chpl_comm_nb_handle_t rmaPutFn_msgOrdFence(void* myAddr, void* mrDesc,
                                            size_t size,
                                            struct perTxCtxInfo_t* tcip) {
   if (tcip->bound
-      && size <= ofi_info->tx_attr->inject_size
+      && size <= injectSizeLimit
       && (tcip->amoVisBitmap == NULL
           || !bitmapTest(tcip->amoVisBitmap, node))) {
     //
@@ -5227,7 +6160,7 @@ chpl_comm_nb_handle_t rmaPutFn_msgOrdFence(void* myAddr, void* mrDesc,
       // be able to inject the PUT, though.
       //
       uint64_t flags = FI_FENCE;
-      if (size <= ofi_info->tx_attr->inject_size) {
+      if (size <= injectSizeLimit) {
         flags |= FI_INJECT;
       }
       (void) wrap_fi_writemsg(myAddr, mrDesc, node, mrRaddr, mrKey, size,
@@ -5279,7 +6212,7 @@ chpl_comm_nb_handle_t rmaPutFn_msgOrd(void* myAddr, void* mrDesc,
   //
 
   if (tcip->bound
-      && size <= ofi_info->tx_attr->inject_size) {
+      && size <= injectSizeLimit) {
     //
     // Special case: write injection has the least latency.  We can use
     // that if this PUT's size doesn't exceed the injection size limit
@@ -5400,13 +6333,184 @@ ssize_t wrap_fi_writemsg(const void* addr, void* mrDesc,
 }
 
 
+////////////////////////////////////////
+//
+// Injection-parameter auto-tuning
+//
+
+//
+// Establish the tunable injection parameters: the provider's values by
+// default, overridden by imported settings from the environment.  This
+// runs as soon as the endpoints exist, so that the parameters are valid
+// for all subsequent communication, including the calibration phase
+// itself.
+//
+static
+void init_ofiAutoTune(void) {
+  injectSizeLimit = ofi_info->tx_attr->inject_size;
+  txCQBatchSize = txCQLen;
+
+  int64_t ev;
+  if ((ev = chpl_env_rt_get_int("COMM_OFI_INJECT_SIZE", -1)) >= 0) {
+    if ((size_t) ev < injectSizeLimit) {
+      injectSizeLimit = (size_t) ev;
+    }
+    injectSizeLimitFixed = true;
+  }
+  if ((ev = chpl_env_rt_get_int("COMM_OFI_TX_CQ_BATCH", -1)) > 0) {
+    if ((size_t) ev < txCQBatchSize) {
+      txCQBatchSize = (size_t) ev;
+    }
+    txCQBatchSizeFixed = true;
+  }
+}
+
+
+//
+// Time a run of loopback PUTs, either injected or sent normally with a
+// wait for each completion, and return the elapsed time.
+//
+static
+double autoTunePutTime(chpl_bool doInject, void* buf, void* mrDesc,
+                       uint64_t mrRaddr, uint64_t mrKey, size_t size,
+                       int reps, struct perTxCtxInfo_t* tcip) {
+  double tStart = chpl_comm_ofi_time_get();
+  for (int i = 0; i < reps; i++) {
+    if (doInject) {
+      (void) wrap_fi_inject_write(buf, chpl_nodeID, mrRaddr, mrKey,
+                                  size, tcip);
+    } else {
+      atomic_bool txnDone;
+      atomic_init_bool(&txnDone, false);
+      void* ctx = txnTrkEncodeDone(&txnDone);
+      (void) wrap_fi_write(buf, mrDesc, chpl_nodeID, mrRaddr, mrKey,
+                           size, ctx, tcip);
+      waitForTxnComplete(tcip, ctx);
+      atomic_destroy_bool(&txnDone);
+    }
+  }
+  while (tcip->numTxnsOut > 0) {
+    (*tcip->checkTxCmplsFn)(tcip);
+  }
+  return chpl_comm_ofi_time_get() - tStart;
+}
+
+
+//
+// The calibration phase proper, run at the end of initialization when
+// auto-tuning is enabled.  Calibration traffic is loopback: NIC-level
+// PUTs into a scratch buffer in our own registered memory.  That
+// exercises the same injection and completion machinery as remote
+// traffic, without involving other nodes that may still be
+// initializing.  Each node tunes itself; with the report turned on,
+// node 0 prints its resulting values in importable form.
+//
+static
+void init_ofiAutoTuneCalibrate(void) {
+  if (!envAutoTune
+      || (injectSizeLimitFixed && txCQBatchSizeFixed)) {
+    return;
+  }
+
+  const int calReps = 64;
+  const size_t provInjSize = ofi_info->tx_attr->inject_size;
+
+  struct perTxCtxInfo_t* tcip;
+  CHK_TRUE((tcip = tciAlloc()) != NULL);
+
+  size_t bufSize = (provInjSize > 0) ? provInjSize : 1;
+  void* buf = chpl_mem_alloc(bufSize, CHPL_RT_MD_COMM_PER_LOC_INFO, 0, 0);
+  void* mrDesc;
+  uint64_t mrKey;
+  uint64_t mrRaddr;
+  if (!mrGetDesc(&mrDesc, buf, bufSize)
+      || !mrGetKey(&mrKey, &mrRaddr, chpl_nodeID, buf, bufSize)) {
+    DBG_PRINTF_NODE0(DBG_CFG, "autotune: scratch buffer not registered; "
+                     "keeping provider defaults");
+    chpl_mem_free(buf, 0, 0);
+    tciFree(tcip);
+    return;
+  }
+
+  if (!injectSizeLimitFixed) {
+    //
+    // Find the inject-vs-send crossover: the largest size at which
+    // injecting is still at least as fast as a regular send.  Injection
+    // copies the payload out of the source buffer up front, so past
+    // some size that copy outweighs the completion wait it saves.
+    //
+    size_t best = 0;
+    for (size_t size = 16; size <= provInjSize; size <<= 1) {
+      double tInj = autoTunePutTime(true, buf, mrDesc, mrRaddr, mrKey,
+                                    size, calReps, tcip);
+      double tSend = autoTunePutTime(false, buf, mrDesc, mrRaddr, mrKey,
+                                     size, calReps, tcip);
+      DBG_PRINTF_NODE0(DBG_CFG,
+                       "autotune: size %zd, inject %.3g us, send %.3g us",
+                       size, tInj * 1e6 / calReps, tSend * 1e6 / calReps);
+      if (tInj > tSend) {
+        break;
+      }
+      best = size;
+    }
+    if (best > 0) {
+      injectSizeLimit = best;
+    }
+  }
+
+  if (!txCQBatchSizeFixed) {
+    //
+    // Size the CQ drain batch: post a burst of tracked PUTs, then time
+    // draining their completions at various batch depths.  Smaller
+    // batches cost more CQ reads for a backlog; larger ones use more
+    // stack and delay handling of the first completion reaped.
+    //
+    const int burst = (MAX_TXNS_IN_FLIGHT < (int) txCQLen)
+                      ? MAX_TXNS_IN_FLIGHT
+                      : (int) txCQLen;
+    size_t bestBatch = txCQLen;
+    double bestTime = -1.0;
+    for (size_t batch = 8; batch <= txCQLen; batch <<= 1) {
+      txCQBatchSize = batch;
+      for (int i = 0; i < burst; i++) {
+        (void) wrap_fi_write(buf, mrDesc, chpl_nodeID, mrRaddr, mrKey,
+                             1, txnTrkEncodeId(__LINE__), tcip);
+      }
+      double tStart = chpl_comm_ofi_time_get();
+      while (tcip->numTxnsOut > 0) {
+        (*tcip->checkTxCmplsFn)(tcip);
+      }
+      double t = chpl_comm_ofi_time_get() - tStart;
+      if (bestTime < 0.0 || t < bestTime) {
+        bestTime = t;
+        bestBatch = batch;
+      }
+    }
+    txCQBatchSize = bestBatch;
+  }
+
+  chpl_mem_free(buf, 0, 0);
+  tciFree(tcip);
+
+  DBG_PRINTF_NODE0(DBG_CFG,
+                   "autotune: inject size limit %zd, tx CQ batch %zd",
+                   injectSizeLimit, txCQBatchSize);
+
+  if (chpl_nodeID == 0
+      && chpl_env_rt_get_bool("COMM_OFI_AUTOTUNE_REPORT", false)) {
+    printf("CHPL_RT_COMM_OFI_INJECT_SIZE=%zd\n", injectSizeLimit);
+    printf("CHPL_RT_COMM_OFI_TX_CQ_BATCH=%zd\n", txCQBatchSize);
+  }
+}
+
+
 static inline
 void ofi_put_lowLevel(const void* addr, void* mrDesc, c_nodeid_t node,
                       uint64_t mrRaddr, uint64_t mrKey, size_t size,
                       void* ctx, uint64_t flags,
                       struct perTxCtxInfo_t* tcip) {
   if (flags == FI_INJECT
-      && size <= ofi_info->tx_attr->inject_size) {
+      && size <= injectSizeLimit) {
     (void) wrap_fi_inject_write(addr, node, mrRaddr, mrKey, size, tcip);
   } else if (flags == 0) {
     (void) wrap_fi_write(addr, mrDesc, node, mrRaddr, mrKey, size, ctx, tcip);
@@ -5526,6 +6630,56 @@ void do_remote_put_buff(void* addr, c_nodeid_t node, void* raddr,
 /*** END OF BUFFERED PUT OPERATIONS ***/
 
 
+// Send the buffered on-stmts for the specified task info, one batch
+// AM per distinct target node, and reset the counter.
+static
+void xo_buff_task_info_flush(xo_buff_task_info_t* info) {
+  while (info->vi > 0) {
+    amRequest_t req = { .xob = { .b = { .op = am_opExecOnBatch,
+                                        .node = chpl_nodeID,
+                                        .pAmDone = NULL, }, }, };
+    c_nodeid_t node = info->locale_v[0];
+    size_t off = 0;
+    size_t numBundles = 0;
+    int viKeep = 0;
+
+    //
+    // Pack this node's requests into the batch, preserving order, and
+    // compact the others down so we can take another pass for them.
+    //
+    for (int vi = 0; vi < info->vi; vi++) {
+      if (info->locale_v[vi] == node) {
+        *(size_t*) &req.xob.payload[off] = info->size_v[vi];
+        memcpy(&req.xob.payload[off + sizeof(size_t)],
+               &info->bundle_v[vi][0], info->size_v[vi]);
+        off += sizeof(size_t) + ((info->size_v[vi] + 7) & ~(size_t) 7);
+        numBundles++;
+      } else {
+        if (viKeep != vi) {
+          info->locale_v[viKeep] = info->locale_v[vi];
+          info->size_v[viKeep] = info->size_v[vi];
+          memcpy(&info->bundle_v[viKeep][0], &info->bundle_v[vi][0],
+                 info->size_v[vi]);
+        }
+        viKeep++;
+      }
+    }
+
+    info->vi = viKeep;
+    req.xob.numBundles = numBundles;
+
+    DBG_PRINTF(DBG_AM | DBG_AM_SEND,
+               "xo_buff_task_info_flush(): %zd on-stmts to %d, sz %zd",
+               numBundles, (int) node,
+               offsetof(struct amRequest_execOnBatch_t, payload) + off);
+
+    amRequestCommon(node, &req,
+                    offsetof(struct amRequest_execOnBatch_t, payload) + off,
+                    NULL, false /*yieldDuringTxnWait*/, NULL);
+  }
+}
+
+
 typedef chpl_comm_nb_handle_t (rmaGetFn_t)(void* myAddr, void* mrDesc,
                                            c_nodeid_t node,
                                            uint64_t mrRaddr, uint64_t mrKey,
@@ -5860,14 +7014,51 @@ void ofi_get_V(int v_len, void** addr_v, void** local_mr_v,
  * then initiate them all at once for increased transaction rate.
  */
 
+// Coalesce buffered GETs whose remote and local addresses are both
+// contiguous with the previous entry into single larger transfers.
+// Index-gather kernels often GET runs of consecutive remote elements
+// into consecutive local elements, and each entry we merge here is one
+// less network transaction at injection time.  Returns the compacted
+// entry count.
+static
+int get_buff_task_info_coalesce(get_buff_task_info_t* info) {
+  int out = 0;
+
+  for (int vi = 1; vi < info->vi; vi++) {
+    if (info->locale_v[vi] == info->locale_v[out]
+        && info->remote_mr_v[vi] == info->remote_mr_v[out]
+        && (char*) info->src_addr_v[vi] == ((char*) info->src_addr_v[out]
+                                            + info->size_v[out])
+        && (char*) info->tgt_addr_v[vi] == ((char*) info->tgt_addr_v[out]
+                                            + info->size_v[out])) {
+      info->size_v[out] += info->size_v[vi];
+    } else {
+      out++;
+      if (out != vi) {
+        info->tgt_addr_v[out] = info->tgt_addr_v[vi];
+        info->locale_v[out] = info->locale_v[vi];
+        info->remote_mr_v[out] = info->remote_mr_v[vi];
+        info->src_addr_v[out] = info->src_addr_v[vi];
+        info->size_v[out] = info->size_v[vi];
+        info->local_mr_v[out] = info->local_mr_v[vi];
+      }
+    }
+  }
+
+  return out + 1;
+}
+
+
 // Flush buffered GETs for the specified task info and reset the counter.
 static inline
 void get_buff_task_info_flush(get_buff_task_info_t* info) {
   if (info->vi > 0) {
+    int v_len = get_buff_task_info_coalesce(info);
     DBG_PRINTF(DBG_RMA_UNORD,
-               "get_buff_task_info_flush(): info has %d entries",
-               info->vi);
-    ofi_get_V(info->vi, info->tgt_addr_v, info->local_mr_v,
+               "get_buff_task_info_flush(): info has %d entries "
+               "(%d after coalescing)",
+               info->vi, v_len);
+    ofi_get_V(v_len, info->tgt_addr_v, info->local_mr_v,
               info->locale_v, info->src_addr_v, info->remote_mr_v,
               info->size_v);
     info->vi = 0;
@@ -6040,7 +7231,7 @@ chpl_comm_nb_handle_t amoFn_msgOrdFence(struct amoBundle_t *ab,
                                         struct perTxCtxInfo_t* tcip) {
   if (ab->iovRes.addr == NULL
       && tcip->bound
-      && ab->size <= ofi_info->tx_attr->inject_size
+      && ab->size <= injectSizeLimit
       && (tcip->putVisBitmap == NULL
           || !bitmapTest(tcip->putVisBitmap, ab->node))) {
     //
@@ -6074,7 +7265,7 @@ chpl_comm_nb_handle_t amoFn_msgOrdFence(struct amoBundle_t *ab,
       // AMO.  We may still be able to inject the AMO, however.
       //
       uint64_t flags = FI_FENCE;
-      if (ab->size <= ofi_info->tx_attr->inject_size) {
+      if (ab->size <= injectSizeLimit) {
         flags |= FI_INJECT;
       }
       (void) wrap_fi_atomicmsg(ab, flags, tcip);
@@ -6122,7 +7313,7 @@ chpl_comm_nb_handle_t amoFn_msgOrd(struct amoBundle_t *ab,
 
   if (tcip->bound
       && ab->iovRes.addr == NULL
-      && ab->size <= ofi_info->tx_attr->inject_size) {
+      && ab->size <= injectSizeLimit) {
     //
     // Special case: injection is the quickest.  We can use that if this
     // is a non-fetching operation, we have a bound tx context so we can
@@ -6392,7 +7583,7 @@ void amCheckRxTxCmpls(chpl_bool* pHadRxEvent, chpl_bool* pHadTxEvent,
 
 static
 void checkTxCmplsCQ(struct perTxCtxInfo_t* tcip) {
-  struct fi_cq_msg_entry cqes[txCQLen];
+  struct fi_cq_msg_entry cqes[txCQBatchSize];
   const size_t cqesSize = sizeof(cqes) / sizeof(cqes[0]);
   const size_t numEvents = readCQ(tcip->txCQ, cqes, cqesSize);
 
@@ -6587,6 +7778,11 @@ void local_yield(void) {
   //         to the chpl_task_yield(), we can end up with two threads
   //         using the same tciTab[] entry simultaneously.
   //
+  // Note the stall for the adaptive progress engine; the yield itself
+  // will also drive cooperative progress for this thread's bound
+  // transmit context, if it has one.
+  //
+  progressNoteStall();
   chpl_task_yield();
 
 #ifdef CHPL_COMM_DEBUG
@@ -7142,6 +8338,40 @@ void amo_nf_buff_task_info_flush(amo_nf_buff_task_info_t* info) {
 }
 
 
+//
+// Can two buffered ops on the same object be merged into one by
+// combining their operands locally?  True for the ops where applying
+// the operands o1 then o2 equals applying one combined operand:
+// integer sums (two's complement makes signed wrap match) and the
+// bitwise ops.  Floating-point sums are excluded because combining
+// changes rounding.
+//
+static inline
+chpl_bool amoCanCombine(enum fi_op ofiOp, enum fi_datatype ofiType) {
+  if (ofiOp == FI_BAND || ofiOp == FI_BOR || ofiOp == FI_BXOR)
+    return true;
+  return ofiOp == FI_SUM
+         && (ofiType == FI_INT32 || ofiType == FI_UINT32
+             || ofiType == FI_INT64 || ofiType == FI_UINT64);
+}
+
+static inline
+void amoCombine(uint64_t* tgt, uint64_t opnd,
+                enum fi_op ofiOp, size_t size) {
+  switch (ofiOp) {
+  case FI_SUM:
+    if (size == 4)
+      *tgt = (uint32_t) (*tgt + opnd);
+    else
+      *tgt += opnd;
+    break;
+  case FI_BAND: *tgt &= opnd; break;
+  case FI_BOR:  *tgt |= opnd; break;
+  case FI_BXOR: *tgt ^= opnd; break;
+  default: chpl_internal_error("unexpected ofiOp"); break;
+  }
+}
+
 static inline
 void do_remote_amo_nf_buff(void* opnd, c_nodeid_t node,
                            void* object, size_t size,
@@ -7184,6 +8414,30 @@ void do_remote_amo_nf_buff(void* opnd, c_nodeid_t node,
     info->new = false;
   }
 
+  //
+  // Software combining: PageRank-style accumulations hammer a few hot
+  // counters, so if an op with the same target and kind is already
+  // buffered, fold this operand into it locally instead of spending a
+  // network op on it.  Ordering is unaffected -- these are unordered
+  // ops, and the buffer is flushed by the same fences as before.
+  //
+  if (envAmoCombine && amoCanCombine(ofiOp, ofiType)) {
+    for (int ci = 0; ci < info->vi; ci++) {
+      if (info->object_v[ci] == (void*) mrRaddr
+          && info->locale_v[ci] == node
+          && info->cmd_v[ci] == ofiOp
+          && info->type_v[ci] == ofiType
+          && info->size_v[ci] == size) {
+        amoCombine(&info->opnd_v[ci],
+                   size == 4 ? *(uint32_t*) opnd : *(uint64_t*) opnd,
+                   ofiOp, size);
+        DBG_PRINTF(DBG_AMO_UNORD,
+                   "do_remote_amo_nf_buff(): combined into info[%d]", ci);
+        return;
+      }
+    }
+  }
+
   int vi = info->vi;
   info->opnd_v[vi]      = size == 4 ? *(uint32_t*) opnd:
                                       *(uint64_t*) opnd;
@@ -7258,16 +8512,32 @@ int32_t chpl_comm_getMaxThreads(void) {
 //
 // TODO: vectorize the child PUTs.
 //
+// There is also a dissemination barrier, selected by setting
+// CHPL_RT_COMM_OFI_DISSEM_BARRIER.  In round r (0 <= r <
+// ceil(log2(numNodes))) each locale PUTs the current barrier epoch
+// into slot r of locale (self + 2^r) % numNodes and then waits for
+// its own slot r to reach that epoch.  Every locale has arrived once
+// the last round completes, so there is no separate release phase,
+// and because the epoch only ever grows the flags never need to be
+// cleared between barriers.  This trades the tree's two phases of
+// log64(n) levels with 64-way flag fan-in for log2(n) rounds of one
+// small PUT each, which can win on latency-bound barriers at scale.
+//
 #define BAR_TREE_NUM_CHILDREN 64
+#define BAR_DISSEM_MAX_ROUNDS 32
 
 typedef struct {
   volatile int child_notify[BAR_TREE_NUM_CHILDREN];
   volatile int parent_release;
+  volatile uint64_t dissem_notify[BAR_DISSEM_MAX_ROUNDS];
 }  bar_info_t;
 
 static c_nodeid_t bar_childFirst;
 static c_nodeid_t bar_numChildren;
 static c_nodeid_t bar_parent;
+static int bar_numRounds;
+static chpl_bool bar_useDissem;
+static uint64_t bar_dissemEpoch;
 
 static bar_info_t bar_info;
 static bar_info_t** bar_infoMap;
@@ -7285,6 +8555,12 @@ void init_bar(void) {
   }
   bar_parent = (chpl_nodeID - 1) / BAR_TREE_NUM_CHILDREN;
 
+  bar_numRounds = 0;
+  while (((c_nodeid_t) 1 << bar_numRounds) < chpl_numNodes)
+    bar_numRounds++;
+
+  bar_useDissem = chpl_env_rt_get_bool("COMM_OFI_DISSEM_BARRIER", false);
+
   CHPL_CALLOC(bar_infoMap, chpl_numNodes);
   const bar_info_t* p = &bar_info;
   chpl_comm_ofi_oob_allgather(&p, bar_infoMap, sizeof(p));
@@ -7324,6 +8600,31 @@ void chpl_comm_barrier(const char *msg) {
   retireDelayedAmDone(false /*taskIsEnding*/);
   forceMemFxVisAllNodes_noTcip(true /*checkPuts*/, true /*checkAmos*/);
 
+  if (bar_useDissem) {
+    //
+    // Only one barrier can be in flight on a node at a time, so the
+    // plain increment here is safe, as is comparing against flags a
+    // peer running one epoch ahead may already have re-notified.
+    //
+    const uint64_t epoch = ++bar_dissemEpoch;
+    for (int r = 0; r < bar_numRounds; r++) {
+      c_nodeid_t peer = (c_nodeid_t) ((chpl_nodeID + ((c_nodeid_t) 1 << r))
+                                      % chpl_numNodes);
+      DBG_PRINTF(DBG_BARRIER, "BAR dissem round %d notify %d",
+                 r, (int) peer);
+      ofi_put(&epoch, peer,
+              (void*) &bar_infoMap[peer]->dissem_notify[r],
+              sizeof(epoch));
+      while (bar_info.dissem_notify[r] < epoch) {
+        local_yield();
+      }
+    }
+
+    DBG_PRINTF(DBG_BARRIER, "barrier '%s' done via dissemination",
+               (msg == NULL) ? "" : msg);
+    return;
+  }
+
   //
   // Wait for our child locales to notify us that they have reached the
   // barrier.
@@ -7649,6 +8950,7 @@ const char* am_opName(amOp_t op) {
   case am_opFree: return "opFree";
   case am_opNop: return "opNop";
   case am_opShutdown: return "opShutdown";
+  case am_opExecOnBatch: return "opExecOnBatch";
   default: return "op???";
   }
 }
@@ -7719,6 +9021,11 @@ const char* am_reqStr(c_nodeid_t tgtNode, amRequest_t* req, size_t reqSize) {
                     req->xol.hdr.comm.argSize);
     break;
 
+  case am_opExecOnBatch:
+    len += snprintf(buf + len, sizeof(buf) - len, ", %zd bundles",
+                    req->xob.numBundles);
+    break;
+
   case am_opGet:
     len += snprintf(buf + len, sizeof(buf) - len, ", %d:%p <- %d:%p, sz %zd",
                     (int) tgtNode, req->rma.addr,
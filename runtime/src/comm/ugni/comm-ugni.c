@@ -3095,7 +3095,9 @@ void make_registered_heap(void)
     }
   }
 
-  chpl_comm_regMemHeapTouch(start, size);
+  if (!chpl_comm_regMemHeapLazyTouch()) {
+    chpl_comm_regMemHeapTouch(start, size);
+  }
 
   registered_heap_size  = size;
   registered_heap_start = start;
@@ -38,6 +38,7 @@
 #include "error.h"
 
 static chpl_bool interleave_mem = false;
+static chpl_bool numa_local_chunks = false;
 static chpl_bool merge_split_chunks = false;
 
 // The dedicated arena to use for large allocations (this is important to
@@ -131,6 +132,34 @@ static void* chunk_alloc(void *chunk, size_t size, size_t alignment, bool *zero,
 
     if (interleave_mem && arena_ind == CHPL_JE_LG_ARENA) {
       chpl_topo_interleaveMemLocality(cur_chunk_base, size);
+    } else if (numa_local_chunks && arena_ind != CHPL_JE_LG_ARENA) {
+      //
+      // Bind the chunk to the NUMA domain of the thread requesting it.
+      // Threads stick with their jemalloc arenas, and with qthreads
+      // tasking the underlying workers are pinned, so the thread that
+      // forces a new chunk into its arena is a good predictor of where
+      // allocations from that chunk will be touched.
+      //
+      c_sublocid_t subloc = chpl_topo_getThreadLocality();
+      if (isActualSublocID(subloc)) {
+        chpl_topo_setMemLocality(cur_chunk_base, size, false, subloc);
+      }
+    }
+
+    //
+    // When the comm layer skipped the whole-heap fault-in at startup
+    // (CHPL_RT_LAZY_HEAP_TOUCH), fault each chunk in as jemalloc maps
+    // it, so startup cost is proportional to memory actually used.
+    // Touch serially, like the dynamic-heap path below: chunks are
+    // small enough that spinning up the parallel toucher would cost
+    // more than it saves, and the NUMA placement calls just above
+    // have already decided where the pages should land.
+    //
+    if (chpl_comm_regMemHeapLazyTouch()) {
+      const size_t heap_page_size = chpl_comm_regMemHeapPageSize();
+      for (size_t i = 0; i < size; i += heap_page_size) {
+        ((volatile char*) cur_chunk_base)[i] = 0;
+      }
     }
   } else if (heap.type == DYNAMIC) {
     // jemalloc 4.5.0 man: "If chunk is not NULL, the returned pointer must be
@@ -402,6 +431,7 @@ void chpl_mem_layerInit(void) {
   size_t heap_size;
 
   interleave_mem = chpl_env_rt_get_bool("INTERLEAVE_MEMORY", CHPL_INTERLEAVE_MEM);
+  numa_local_chunks = chpl_env_rt_get_bool("NUMA_LOCAL_CHUNKS", false);
   merge_split_chunks = chpl_env_rt_get_bool("MERGE_SPLIT_CHUNKS", true);
   CHPL_JE_LG_ARENA = get_num_arenas()-1;
 
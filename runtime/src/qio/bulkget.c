@@ -62,6 +62,124 @@ qbytes_t* bulk_get_bytes(int64_t src_locale, qbytes_t* src_addr)
   return ret; 
 }
 
+// Merge extents separated by up to a page by default: pulling the gap
+// along with the data is cheaper than paying another operation's
+// latency.
+#define BULK_GET_ENGINE_DEFAULT_MAX_GAP 4096
+
+// Don't let one merged operation (and its bounce buffer) grow without
+// bound.
+#define BULK_GET_ENGINE_DEFAULT_MAX_MERGED (8*1024*1024)
+
+void bulk_get_engine_init(bulk_get_engine_t* eng,
+                          int64_t src_locale, void* src_base)
+{
+  eng->src_locale = src_locale;
+  eng->src_base = src_base;
+  eng->max_gap = BULK_GET_ENGINE_DEFAULT_MAX_GAP;
+  eng->max_merged = BULK_GET_ENGINE_DEFAULT_MAX_MERGED;
+  eng->reqs = NULL;
+  eng->num = 0;
+  eng->cap = 0;
+}
+
+qioerr bulk_get_engine_add(bulk_get_engine_t* eng,
+                           void* dst, int64_t offset, int64_t len)
+{
+  bulk_get_request_t* req;
+
+  if( len < 0 || offset < 0 ) QIO_RETURN_CONSTANT_ERROR(EINVAL, "bad request");
+  if( len == 0 ) return 0;
+
+  if( eng->num == eng->cap ) {
+    ssize_t newcap = (eng->cap == 0) ? 16 : 2*eng->cap;
+    bulk_get_request_t* newreqs =
+      (bulk_get_request_t*) qio_realloc(eng->reqs,
+                                        newcap*sizeof(bulk_get_request_t));
+    if( ! newreqs ) return QIO_ENOMEM;
+    eng->reqs = newreqs;
+    eng->cap = newcap;
+  }
+
+  req = &eng->reqs[eng->num++];
+  req->offset = offset;
+  req->dst = dst;
+  req->len = len;
+  return 0;
+}
+
+static int bulk_get_request_cmp(const void* av, const void* bv)
+{
+  const bulk_get_request_t* a = (const bulk_get_request_t*) av;
+  const bulk_get_request_t* b = (const bulk_get_request_t*) bv;
+  if( a->offset < b->offset ) return -1;
+  if( a->offset > b->offset ) return 1;
+  return 0;
+}
+
+qioerr bulk_get_engine_finish(bulk_get_engine_t* eng)
+{
+  ssize_t i, j;
+
+  if( eng->num == 0 ) return 0;
+
+  qsort(eng->reqs, eng->num, sizeof(bulk_get_request_t),
+        bulk_get_request_cmp);
+
+  for( i = 0; i < eng->num; i = j ) {
+    int64_t lo = eng->reqs[i].offset;
+    int64_t hi = lo + eng->reqs[i].len;
+
+    // Extend the run while the next request starts within max_gap of
+    // the run's end and the merged span stays bounded.  Overlapping
+    // requests merge too.
+    for( j = i + 1; j < eng->num; j++ ) {
+      int64_t next_lo = eng->reqs[j].offset;
+      int64_t next_hi = next_lo + eng->reqs[j].len;
+      if( next_lo - hi > eng->max_gap ) break;
+      if( (next_hi > hi ? next_hi : hi) - lo > eng->max_merged ) break;
+      if( next_hi > hi ) hi = next_hi;
+    }
+
+    if( j == i + 1 ) {
+      // A lone request: get it straight into its destination.
+      chpl_gen_comm_get(eng->reqs[i].dst, eng->src_locale,
+                        PTR_ADDBYTES(eng->src_base, lo),
+                        sizeof(uint8_t)*eng->reqs[i].len,
+                        CHPL_COMM_UNKNOWN_ID, -1, CHPL_FILE_IDX_INTERNAL);
+    } else {
+      // Get the merged extent in one operation and scatter it back.
+      int64_t span = hi - lo;
+      void* bounce = qio_malloc(span);
+      if( ! bounce ) return QIO_ENOMEM;
+
+      chpl_gen_comm_get(bounce, eng->src_locale,
+                        PTR_ADDBYTES(eng->src_base, lo),
+                        sizeof(uint8_t)*span,
+                        CHPL_COMM_UNKNOWN_ID, -1, CHPL_FILE_IDX_INTERNAL);
+
+      for( ; i < j; i++ ) {
+        chpl_memcpy(eng->reqs[i].dst,
+                    PTR_ADDBYTES(bounce, eng->reqs[i].offset - lo),
+                    eng->reqs[i].len);
+      }
+
+      qio_free(bounce);
+    }
+  }
+
+  eng->num = 0;
+  return 0;
+}
+
+void bulk_get_engine_destroy(bulk_get_engine_t* eng)
+{
+  qio_free(eng->reqs);
+  eng->reqs = NULL;
+  eng->num = 0;
+  eng->cap = 0;
+}
+
 qioerr bulk_put_buffer(int64_t dst_locale, void* dst_addr, int64_t dst_len,
                       qbuffer_t* buf, qbuffer_iter_t start, qbuffer_iter_t end)
 {
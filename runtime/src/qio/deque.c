@@ -82,3 +82,220 @@ qioerr _deque_reallocate_map(const ssize_t item_size, const ssize_t buf_size, de
 }
 
 
+
+
+/************** bounded deque **************/
+
+#include <fcntl.h>
+#include <unistd.h>
+
+qioerr bounded_deque_init(const ssize_t item_size, bounded_deque_t* d,
+                          ssize_t max_items, int mode)
+{
+  qioerr err;
+
+  if( max_items <= 0 )
+    QIO_RETURN_CONSTANT_ERROR(EINVAL, "nonpositive max_items");
+  if( mode != DEQUE_BOUND_BLOCK && mode != DEQUE_BOUND_SPILL )
+    QIO_RETURN_CONSTANT_ERROR(EINVAL, "bad bounded deque mode");
+
+  err = deque_init(item_size, & d->deque, 0);
+  if( err ) return err;
+
+  d->max_items = max_items;
+  // Spill half the bound at a time: large enough to amortize the
+  // syscall, small enough that the deque refills while the spilled
+  // half drains.
+  d->chunk_items = _DEQUE_MAX(max_items/2, 1);
+  d->mode = mode;
+  d->spill_fd = -1;
+  d->spill_read = 0;
+  d->spill_write = 0;
+  d->refill = NULL;
+  d->refill_pos = 0;
+  d->refill_cnt = 0;
+
+  return 0;
+}
+
+void bounded_deque_destroy(bounded_deque_t* d)
+{
+  if( d->spill_fd >= 0 ) close(d->spill_fd);
+  if( d->refill ) deque_free(d->refill);
+  deque_destroy(& d->deque);
+  memset(d, 0, sizeof(bounded_deque_t));
+  d->spill_fd = -1;
+}
+
+ssize_t bounded_deque_size(const ssize_t item_size, bounded_deque_t* d)
+{
+  return (d->refill_cnt - d->refill_pos) +
+         (ssize_t) ((d->spill_write - d->spill_read) / item_size) +
+         deque_size(item_size, & d->deque);
+}
+
+// Create the (immediately unlinked) temp file backing the spill.
+static qioerr _bounded_deque_open_spill(bounded_deque_t* d)
+{
+  char path[FILENAME_MAX];
+  const char* tmp = getenv("TMPDIR");
+  int fd;
+
+  if( tmp == NULL ) tmp = "/tmp";
+  if( snprintf(path, sizeof(path), "%s/qio-deque-XXXXXX", tmp) >=
+      (int) sizeof(path) )
+    QIO_RETURN_CONSTANT_ERROR(ENAMETOOLONG, "TMPDIR too long");
+
+  fd = mkstemp(path);
+  if( fd < 0 ) return qio_mkerror_errno();
+  unlink(path);
+
+  d->spill_fd = fd;
+  return 0;
+}
+
+static qioerr _bounded_deque_pwrite(int fd, const void* buf, size_t count,
+                                    int64_t offset)
+{
+  const char* p = (const char*) buf;
+  while( count > 0 ) {
+    ssize_t got = pwrite(fd, p, count, (off_t) offset);
+    if( got < 0 ) {
+      if( errno == EINTR ) continue;
+      return qio_mkerror_errno();
+    }
+    p += got;
+    offset += got;
+    count -= got;
+  }
+  return 0;
+}
+
+static qioerr _bounded_deque_pread(int fd, void* buf, size_t count,
+                                   int64_t offset)
+{
+  char* p = (char*) buf;
+  while( count > 0 ) {
+    ssize_t got = pread(fd, p, count, (off_t) offset);
+    if( got <= 0 ) {
+      if( got < 0 && errno == EINTR ) continue;
+      // A short read means we lost part of the spill file.
+      return got < 0 ? qio_mkerror_errno() : QIO_ESHORT;
+    }
+    p += got;
+    offset += got;
+    count -= got;
+  }
+  return 0;
+}
+
+// Move the oldest chunk_items items from the deque to the spill file.
+static qioerr _bounded_deque_spill(const ssize_t item_size, bounded_deque_t* d)
+{
+  ssize_t n = d->chunk_items;
+  void* buf;
+  deque_iterator_t it;
+  ssize_t i;
+  qioerr err;
+
+  if( deque_size(item_size, & d->deque) < n )
+    n = deque_size(item_size, & d->deque);
+  if( n == 0 ) return 0;
+
+  if( d->spill_fd < 0 ) {
+    err = _bounded_deque_open_spill(d);
+    if( err ) return err;
+  }
+
+  buf = deque_calloc(n, item_size);
+  if( ! buf ) return QIO_ENOMEM;
+
+  it = deque_begin(& d->deque);
+  for( i = 0; i < n; i++ ) {
+    deque_it_get_cur(item_size, it, PTR_ADDBYTES(buf, i*item_size));
+    deque_it_forward_one(item_size, &it);
+  }
+
+  err = _bounded_deque_pwrite(d->spill_fd, buf, n*item_size, d->spill_write);
+  deque_free(buf);
+  if( err ) return err;
+
+  d->spill_write += n*item_size;
+  for( i = 0; i < n; i++ ) {
+    deque_pop_front(item_size, & d->deque);
+  }
+
+  return 0;
+}
+
+qioerr bounded_deque_push_back(const ssize_t item_size, bounded_deque_t* d,
+                               void* value)
+{
+  qioerr err;
+
+  if( deque_size(item_size, & d->deque) >= d->max_items ) {
+    if( d->mode == DEQUE_BOUND_BLOCK )
+      QIO_RETURN_CONSTANT_ERROR(EAGAIN, "bounded deque is full");
+    err = _bounded_deque_spill(item_size, d);
+    if( err ) return err;
+  }
+
+  return deque_push_back(item_size, & d->deque, value);
+}
+
+// Read the next chunk of spilled items back into the refill buffer.
+static qioerr _bounded_deque_refill(const ssize_t item_size, bounded_deque_t* d)
+{
+  ssize_t n = d->chunk_items;
+  ssize_t avail = (ssize_t) ((d->spill_write - d->spill_read) / item_size);
+  qioerr err;
+
+  if( n > avail ) n = avail;
+
+  if( ! d->refill ) {
+    d->refill = deque_calloc(d->chunk_items, item_size);
+    if( ! d->refill ) return QIO_ENOMEM;
+  }
+
+  err = _bounded_deque_pread(d->spill_fd, d->refill, n*item_size,
+                             d->spill_read);
+  if( err ) return err;
+
+  d->spill_read += n*item_size;
+  if( d->spill_read == d->spill_write ) {
+    // Drained the file; reuse it from the beginning next time.
+    d->spill_read = 0;
+    d->spill_write = 0;
+  }
+
+  d->refill_pos = 0;
+  d->refill_cnt = n;
+
+  return 0;
+}
+
+qioerr bounded_deque_pop_front(const ssize_t item_size, bounded_deque_t* d,
+                               void* out)
+{
+  qioerr err;
+
+  if( d->refill_pos == d->refill_cnt && d->spill_read < d->spill_write ) {
+    err = _bounded_deque_refill(item_size, d);
+    if( err ) return err;
+  }
+
+  if( d->refill_pos < d->refill_cnt ) {
+    deque_memcpy(out, PTR_ADDBYTES(d->refill, d->refill_pos*item_size),
+                 item_size);
+    d->refill_pos++;
+    return 0;
+  }
+
+  if( deque_size(item_size, & d->deque) > 0 ) {
+    deque_it_get_cur(item_size, deque_begin(& d->deque), out);
+    deque_pop_front(item_size, & d->deque);
+    return 0;
+  }
+
+  return QIO_EEOF;
+}
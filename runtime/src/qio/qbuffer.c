@@ -28,6 +28,8 @@
 
 #include "error.h"
 
+#include "chpl-thread-local-storage.h" // CHPL_TLS
+
 #include "sys.h"
 
 #include <limits.h>
@@ -86,7 +88,54 @@ void qbytes_free_qio_free(qbytes_t* b) {
   qio_free(b->data);
   _qbytes_free_qbytes(b);
 }
+
+// Cache freed iobufs -- the qbytes_t header together with its data
+// buffer -- per thread, so that steady-state channel refills do not go
+// through the global allocator.  The tasking layers run tasks on a
+// fixed set of worker threads, so a per-thread free list amounts to a
+// per-shepherd one and needs no locking.  It is only a cache: an iobuf
+// may well be freed on a different thread than the one that allocated
+// it, and each list is bounded so that no thread holds on to more than
+// QBYTES_IOBUF_CACHE_MAX buffers; anything beyond that is freed as
+// before.  The list is threaded through the first word of each (dead)
+// data buffer.  If the platform has no compiler-supported thread-local
+// storage, we just always use the allocator.
+#define QBYTES_IOBUF_CACHE_MAX 4
+
+#ifdef CHPL_TLS
+static CHPL_TLS qbytes_t* qbytes_iobuf_cache = NULL;
+static CHPL_TLS int qbytes_iobuf_cache_cnt = 0;
+
+static qbytes_t* qbytes_iobuf_cache_get(void)
+{
+  qbytes_t* ret = qbytes_iobuf_cache;
+  if( ret != NULL ) {
+    qbytes_iobuf_cache = *(qbytes_t**) ret->data;
+    qbytes_iobuf_cache_cnt--;
+  }
+  return ret;
+}
+
+static int qbytes_iobuf_cache_put(qbytes_t* b)
+{
+  // Don't cache if the list is full, or if qbytes_iobuf_size has
+  // changed since this buffer was allocated.
+  if( qbytes_iobuf_cache_cnt >= QBYTES_IOBUF_CACHE_MAX ||
+      b->len != (int64_t) qbytes_iobuf_size )
+    return 0;
+  DO_DESTROY_REFCNT(b);
+  *(qbytes_t**) b->data = qbytes_iobuf_cache;
+  qbytes_iobuf_cache = b;
+  qbytes_iobuf_cache_cnt++;
+  return 1;
+}
+#else
+static qbytes_t* qbytes_iobuf_cache_get(void) { return NULL; }
+static int qbytes_iobuf_cache_put(qbytes_t* b) { return 0; }
+#endif
+
 void qbytes_free_iobuf(qbytes_t* b) {
+  if( qbytes_iobuf_cache_put(b) ) return;
   // iobuf is just something to be freed with free()
   qbytes_free_qio_free(b);
 }
@@ -172,6 +221,17 @@ qioerr qbytes_create_iobuf(qbytes_t** out)
   qbytes_t* ret = NULL;
   qioerr err;
 
+  // Reuse a cached iobuf if this thread has one.
+  ret = qbytes_iobuf_cache_get();
+  if( ret ) {
+    void* data = ret->data;
+    memset(data, 0, qbytes_iobuf_size);
+    // The ref count in ret is initially 1.
+    _qbytes_init_generic(ret, data, qbytes_iobuf_size, qbytes_free_iobuf);
+    *out = ret;
+    return 0;
+  }
+
   ret = (qbytes_t*) qio_calloc(1, sizeof(qbytes_t));
   if( ! ret ) {
     *out = NULL;
@@ -884,6 +944,28 @@ qioerr qbuffer_to_iov(qbuffer_t* buf, qbuffer_iter_t start, qbuffer_iter_t end,
     }
   }
 
+  // Coalesce entries that refer to adjacent memory -- common when many
+  // small appends land in consecutive regions of the same allocation --
+  // so the syscall layer sees fewer iovecs and fewer IOV_MAX batches.
+  // Skipped when the caller asked for bytes_out, since merging entries
+  // would break the pairing between the two arrays.
+  if( bytes_out == NULL && i > 1 ) {
+    size_t j = 0;
+    size_t k;
+
+    for( k = 1; k < i; k++ ) {
+      if( PTR_ADDBYTES(iov_out[j].iov_base, iov_out[j].iov_len) ==
+          iov_out[k].iov_base ) {
+        iov_out[j].iov_len += iov_out[k].iov_len;
+      } else {
+        j++;
+        if( j != k ) iov_out[j] = iov_out[k];
+      }
+    }
+
+    i = j + 1;
+  }
+
   *iovcnt_out = i;
   return 0;
 
@@ -38,12 +38,16 @@
 
 #include "qio.h"
 #include "qbuffer.h"
+#include "qio_codec.h"
 #include "qio_plugin_api.h"
 
+#include "chpl-env.h"
 #include "error.h"
 
 #include <stdio.h>
 #include <stdarg.h>
+#include <pthread.h>
+#include <sched.h>
 #include <sys/uio.h>
 #include <unistd.h>
 #include <errno.h>
@@ -135,6 +139,41 @@ void qio_unlock(qio_lock_t* x) {
   x->owner = NULL_OWNER;
   atomic_unlock_spinlock_t(&x->lock);
 }
+
+//
+// A reserved owner for qio_lock_extern_thread(): never NULL_OWNER,
+// never an ID the tasking layer hands out, and distinct from the
+// value chpl_task_getId() reports for a non-task thread, so two such
+// threads can never mistake each other's hold for their own.
+//
+#define EXTERN_THREAD_OWNER ((chpl_taskID_t) -2)
+
+qioerr qio_lock_extern_thread(qio_lock_t* x) {
+  // chpl_task_yield() is off limits here -- the calling thread is not
+  // a task -- so wait on the OS scheduler instead.
+  while( ! atomic_try_lock_spinlock_t(&x->lock) ) {
+    sched_yield();
+  }
+
+  assert( chpl_task_idEquals(x->owner, NULL_OWNER) );
+  x->count = 1;
+  x->owner = EXTERN_THREAD_OWNER;
+
+  return 0;
+}
+
+void qio_unlock_extern_thread(qio_lock_t* x) {
+  if( ! chpl_task_idEquals(x->owner, EXTERN_THREAD_OWNER) ) {
+    abort();
+  }
+
+  if( --x->count != 0 ) {
+    return;
+  }
+
+  x->owner = NULL_OWNER;
+  atomic_unlock_spinlock_t(&x->lock);
+}
 #endif
 
 #ifdef CHPL_RT_UNIT_TEST
@@ -264,6 +303,136 @@ error:
 
 }
 
+// One stream's slice of a parallel positional read.
+typedef struct qio_pread_work_s {
+  fd_t fd;
+  void* buf;       // where this stream's bytes land
+  int64_t offset;  // file offset of this stream's range
+  int64_t len;     // bytes this stream should read
+  int64_t nread;   // out: bytes actually read (short at EOF)
+  qioerr err;      // out: first error, or 0
+  int spawned;     // did this range get its own thread?
+} qio_pread_work_t;
+
+static void* qio_do_pread_work(void* arg)
+{
+  qio_pread_work_t* w = (qio_pread_work_t*) arg;
+  int64_t got = 0;
+
+  while( got < w->len ) {
+    ssize_t amt = 0;
+    err_t rc = sys_pread(w->fd, PTR_ADDBYTES(w->buf, got),
+                         w->len - got, w->offset + got, &amt);
+    if( rc ) {
+      if( rc == EINTR ) continue;
+      w->err = qio_int_to_err(rc);
+      break;
+    }
+    if( amt == 0 ) break; // end of file
+    got += amt;
+  }
+
+  w->nread = got;
+  return NULL;
+}
+
+// Reads len bytes at offset into ptr using nstreams concurrent preads,
+// partitioning the range on elem_size boundaries so no element's bytes
+// are split between streams.  Writes the number of bytes read -- counting
+// only the contiguous run from offset, should a stream stop short at end
+// of file -- to *num_read_out.  Returns the error from the lowest-offset
+// stream that failed, or 0.
+//
+// This exists so bulk binary reads can keep several preads in flight and
+// use the full bandwidth of the device rather than one stream's worth;
+// callers hand-rolling the offset math should use this instead.
+qioerr qio_file_pread_parallel(qio_file_t* file, int64_t offset, void* ptr,
+                               int64_t len, int64_t elem_size,
+                               int64_t nstreams, int64_t* num_read_out)
+{
+  qio_pread_work_t* work = NULL;
+  pthread_t* threads = NULL;
+  int64_t nelems, per_stream, start_elem;
+  int64_t i, nread;
+  qioerr err = 0;
+
+  *num_read_out = 0;
+
+  if( len < 0 || offset < 0 || elem_size <= 0 || len % elem_size != 0 )
+    QIO_RETURN_CONSTANT_ERROR(EINVAL, "bad parallel read request");
+
+  if( file->fd == -1 )
+    QIO_RETURN_CONSTANT_ERROR(EINVAL, "invalid file descriptor");
+
+  if( len == 0 ) return 0;
+
+  // Never use more streams than there are elements; degenerate requests
+  // just run on the calling thread.
+  nelems = len / elem_size;
+  if( nstreams > nelems ) nstreams = nelems;
+  if( nstreams < 1 ) nstreams = 1;
+
+  work = (qio_pread_work_t*) qio_calloc(nstreams, sizeof(qio_pread_work_t));
+  if( ! work ) return QIO_ENOMEM;
+
+  if( nstreams > 1 ) {
+    threads = (pthread_t*) qio_malloc((nstreams-1)*sizeof(pthread_t));
+    if( ! threads ) {
+      qio_free(work);
+      return QIO_ENOMEM;
+    }
+  }
+
+  // Divide the elements evenly; early streams take the remainder.
+  per_stream = nelems / nstreams;
+  start_elem = 0;
+  for( i = 0; i < nstreams; i++ ) {
+    int64_t n = per_stream + (i < nelems % nstreams ? 1 : 0);
+    work[i].fd = file->fd;
+    work[i].buf = PTR_ADDBYTES(ptr, start_elem*elem_size);
+    work[i].offset = offset + start_elem*elem_size;
+    work[i].len = n*elem_size;
+    start_elem += n;
+  }
+
+  STARTING_SLOW_SYSCALL;
+
+  for( i = 1; i < nstreams; i++ ) {
+    if( pthread_create(&threads[i-1], NULL, qio_do_pread_work, &work[i]) == 0 ) {
+      work[i].spawned = 1;
+    } else {
+      // Couldn't start it; read its range on this thread instead.
+      qio_do_pread_work(&work[i]);
+    }
+  }
+
+  qio_do_pread_work(&work[0]);
+
+  for( i = 1; i < nstreams; i++ ) {
+    if( work[i].spawned ) pthread_join(threads[i-1], NULL);
+  }
+
+  DONE_SLOW_SYSCALL;
+
+  // Count bytes up to the first hole or error.
+  nread = 0;
+  for( i = 0; i < nstreams; i++ ) {
+    nread += work[i].nread;
+    if( work[i].err ) {
+      err = work[i].err;
+      break;
+    }
+    if( work[i].nread < work[i].len ) break; // hit end of file
+  }
+
+  *num_read_out = nread;
+
+  qio_free(threads);
+  qio_free(work);
+
+  return err;
+}
+
 qioerr qio_freadv(FILE* fp, qbuffer_t* buf, qbuffer_iter_t start, qbuffer_iter_t end, ssize_t* num_read)
 {
   int64_t total_read = 0;
@@ -312,6 +481,25 @@ error:
 
 }
 
+// Size of the bounce buffer qio_fwritev uses to batch up small
+// buffer parts into a single fwrite call.
+#define QIO_FWRITE_GATHER_BYTES 4096
+
+static qioerr qio_fwrite_gathered(FILE* fp, const char* data, size_t len,
+                                  ssize_t* total_written)
+{
+  size_t nwritten;
+
+  if( len == 0 ) return 0;
+
+  nwritten = fwrite(data, 1, len, fp);
+  *total_written += nwritten;
+
+  if( nwritten != len ) return qio_int_to_err(ferror(fp));
+
+  return 0;
+}
+
 qioerr qio_fwritev(FILE* fp, qbuffer_t* buf, qbuffer_iter_t start, qbuffer_iter_t end, ssize_t* num_written)
 {
   ssize_t total_written = 0;
@@ -321,6 +509,8 @@ qioerr qio_fwritev(FILE* fp, qbuffer_t* buf, qbuffer_iter_t start, qbuffer_iter_
   struct iovec* iov = NULL;
   size_t iovcnt;
   size_t i;
+  char gather[QIO_FWRITE_GATHER_BYTES];
+  size_t gathered = 0;
   MAYBE_STACK_SPACE(struct iovec, iov_onstack);
   qioerr err;
 
@@ -339,16 +529,37 @@ qioerr qio_fwritev(FILE* fp, qbuffer_t* buf, qbuffer_iter_t start, qbuffer_iter_
   err = qbuffer_to_iov(buf, start, end, num_parts, iov, NULL, &iovcnt);
   if( err ) goto error;
 
+  // Gather runs of small parts into one fwrite each; fragmented buffers
+  // from many small appends would otherwise turn into a stdio call (and
+  // frequently a syscall) per part.
   for( i = 0; i < iovcnt; i++ ) {
-    nwritten = fwrite(iov[i].iov_base, 1, iov[i].iov_len, fp);
-    err = 0;
-    if( nwritten == 0 ) {
-      err = qio_int_to_err(ferror(fp));
+    size_t len = iov[i].iov_len;
+
+    if( len < QIO_FWRITE_GATHER_BYTES ) {
+      if( gathered + len > sizeof(gather) ) {
+        err = qio_fwrite_gathered(fp, gather, gathered, &total_written);
+        gathered = 0;
+        if( err ) goto error;
+      }
+      memcpy(&gather[gathered], iov[i].iov_base, len);
+      gathered += len;
+      continue;
     }
-    total_written += nwritten;
+
+    err = qio_fwrite_gathered(fp, gather, gathered, &total_written);
+    gathered = 0;
     if( err ) goto error;
+
+    nwritten = fwrite(iov[i].iov_base, 1, len, fp);
+    total_written += nwritten;
+    if( nwritten != len ) {
+      err = qio_int_to_err(ferror(fp));
+      goto error;
+    }
   }
 
+  err = qio_fwrite_gathered(fp, gather, gathered, &total_written);
+
 error:
   MAYBE_STACK_FREE(iov, iov_onstack);
 
@@ -1560,6 +1771,60 @@ qioerr qio_channel_create(qio_channel_t** ch_out, qio_file_t* file, qio_hint_t h
 }
 
 
+qioerr qio_channel_set_codec(const int threadsafe, qio_channel_t* ch, const char* name)
+{
+  qioerr err = 0;
+  qio_method_t method = (qio_method_t) (ch->hints & QIO_METHODMASK);
+  const qio_codec_fns_t* codec;
+  ssize_t bound;
+
+  if( threadsafe ) {
+    err = qio_lock(&ch->lock);
+    if( err ) return err;
+  }
+
+  codec = qio_codec_lookup(name);
+  if( codec == NULL ) {
+    QIO_GET_CONSTANT_ERROR(err, EINVAL, "unknown codec");
+    goto unlock;
+  }
+
+  if( method != QIO_METHOD_READWRITE || ch->chan_info != NULL ) {
+    QIO_GET_CONSTANT_ERROR(err, EINVAL, "codec requires a sequential channel");
+    goto unlock;
+  }
+
+  // The encoded stream has no notion of data that already moved
+  // uncompressed; require a fresh channel.
+  if( ch->codec != NULL ||
+      ( qbuffer_is_initialized(&ch->buf) && qbuffer_len(&ch->buf) != 0 ) ) {
+    QIO_GET_CONSTANT_ERROR(err, EINVAL, "codec must be set before any I/O");
+    goto unlock;
+  }
+
+  bound = codec->encode_bound((ssize_t) qbytes_iobuf_size);
+
+  ch->codec_raw = qio_malloc(qbytes_iobuf_size);
+  ch->codec_enc = qio_malloc(bound);
+  if( ch->codec_raw == NULL || ch->codec_enc == NULL ) {
+    if( ch->codec_raw ) qio_free(ch->codec_raw);
+    if( ch->codec_enc ) qio_free(ch->codec_enc);
+    ch->codec_raw = NULL;
+    ch->codec_enc = NULL;
+    err = QIO_ENOMEM;
+    goto unlock;
+  }
+
+  ch->codec = codec;
+
+unlock:
+  if( threadsafe ) {
+    qio_unlock(&ch->lock);
+  }
+
+  return err;
+}
+
 // This routine always returns a malloc'd string in the path_out pointer.
 // The caller must free the passed-back pointer.
 qioerr qio_relative_path(const char** path_out, const char* cwd, const char* path)
@@ -1820,6 +2085,19 @@ qioerr _qio_channel_final_flush_unlocked(qio_channel_t* ch)
   return err;
 }
 
+// Asynchronous readahead state; one per eligible channel, created
+// lazily by qio_readahead_start() below.
+typedef struct qio_readahead_s {
+  atomic_bool busy;   // a fill task is running
+  atomic_bool valid;  // bytes[0..len) holds file data starting at offset
+  int64_t offset;     // file offset of the prefetched window
+  int64_t want;       // bytes the fill task should read
+  int64_t len;        // bytes it actually read
+  int64_t window;     // configured window size
+  qbytes_t* bytes;
+  qio_channel_t* ch;  // back-pointer for the fill task
+} qio_readahead_t;
+
 void _qio_channel_destroy(qio_channel_t* ch)
 {
   qioerr err;
@@ -1837,6 +2115,19 @@ void _qio_channel_destroy(qio_channel_t* ch)
     abort();
   }
 
+  if( ch->codec_raw ) qio_free(ch->codec_raw);
+  if( ch->codec_enc ) qio_free(ch->codec_enc);
+
+  if( ch->readahead ) {
+    qio_readahead_t* ra = ch->readahead;
+    // a running fill task holds a channel reference, so none is running
+    if( ra->bytes ) qbytes_release(ra->bytes);
+    atomic_destroy_bool(&ra->busy);
+    atomic_destroy_bool(&ra->valid);
+    qio_free(ra);
+    ch->readahead = NULL;
+  }
+
   qio_lock_destroy(&ch->lock);
 
   qio_file_release(ch->file);
@@ -2179,6 +2470,17 @@ qioerr _buffered_get_mmap(qio_channel_t* ch, int64_t amt_in, int writing)
     err = qio_int_to_err(sys_mmap(NULL, len, prot, MAP_SHARED, ch->file->fd, map_start, &data));
     if( err ) return err;
 
+    // Apply the access-pattern hints to the new mapping the same way
+    // qio_mmap_initial does for the initial one.  Large files are read
+    // through these chunked mappings rather than the initial map, so
+    // without this a sequential scan got no kernel readahead on any
+    // chunk past the first.
+    err = qio_madvise_for_hints(data, len, ch->hints);
+    if( err ) {
+      sys_munmap(data, len);
+      return err;
+    }
+
     err = qbytes_create_generic(&bytes, data, len, qbytes_free_munmap);
     if( err ) {
       sys_munmap(data, len);
@@ -2198,6 +2500,244 @@ qioerr _buffered_get_mmap(qio_channel_t* ch, int64_t amt_in, int writing)
   else return 0;
 }
 
+/************** channel codec support **************/
+
+// Write len bytes, retrying short writes and EINTR.
+static
+qioerr _qio_codec_write_all(fd_t fd, const void* ptr, ssize_t len)
+{
+  const char* p = (const char*) ptr;
+  ssize_t wrote;
+  err_t errcode;
+
+  while( len > 0 ) {
+    wrote = 0;
+    errcode = sys_write(fd, p, len, &wrote);
+    if( errcode == EINTR ) continue;
+    if( errcode ) return qio_int_to_err(errcode);
+    if( wrote == 0 ) QIO_RETURN_CONSTANT_ERROR(EIO, "write returned zero");
+    p += wrote;
+    len -= wrote;
+  }
+
+  return 0;
+}
+
+// Read exactly len bytes; EOF before the first byte is QIO_EEOF, EOF
+// in the middle is QIO_ESHORT.
+static
+qioerr _qio_codec_read_all(fd_t fd, void* ptr, ssize_t len)
+{
+  char* p = (char*) ptr;
+  ssize_t sofar = 0;
+  ssize_t got;
+  err_t errcode;
+
+  while( sofar < len ) {
+    got = 0;
+    errcode = sys_read(fd, p + sofar, len - sofar, &got);
+    if( errcode == EINTR ) continue;
+    if( errcode ) return qio_int_to_err(errcode);
+    if( got == 0 ) {
+      if( sofar == 0 ) return QIO_EEOF;
+      return QIO_ESHORT;
+    }
+    sofar += got;
+  }
+
+  return 0;
+}
+
+// Encode everything in [*start,end) and write it out as framed
+// chunks (see qio_codec.h).  Advances *start past what was consumed,
+// so the caller trims exactly the raw bytes whose frames reached the
+// file.  Chunks are at most one I/O buffer, so each part of the
+// buffer is encoded independently of the others.
+static
+qioerr _qio_codec_write_frames(qio_channel_t* ch,
+                               qbuffer_iter_t* start, qbuffer_iter_t end)
+{
+  ssize_t bound = ch->codec->encode_bound((ssize_t) qbytes_iobuf_size);
+  qioerr err;
+
+  while( qbuffer_iter_num_bytes(*start, end) > 0 ) {
+    qbuffer_iter_t chunk_end = *start;
+    ssize_t raw = qbuffer_iter_num_bytes(*start, end);
+    ssize_t enc_len = 0;
+    qio_codec_frame_t frame;
+
+    if( raw > (ssize_t) qbytes_iobuf_size ) raw = qbytes_iobuf_size;
+    qbuffer_iter_advance(&ch->buf, &chunk_end, raw);
+
+    err = qbuffer_copyout(&ch->buf, *start, chunk_end, ch->codec_raw, raw);
+    if( err ) return err;
+
+    err = ch->codec->encode(ch->codec_raw, raw,
+                            ch->codec_enc, bound, &enc_len);
+    if( err ) return err;
+
+    frame.enc_len = (uint32_t) enc_len;
+    frame.raw_len = (uint32_t) raw;
+
+    err = _qio_codec_write_all(ch->file->fd, &frame, sizeof(frame));
+    if( ! err )
+      err = _qio_codec_write_all(ch->file->fd, ch->codec_enc, enc_len);
+    if( err ) return err;
+
+    *start = chunk_end;
+  }
+
+  return 0;
+}
+
+// Refill the channel buffer with at least amt decoded bytes.  Clean
+// EOF at a frame boundary is QIO_EEOF; data already appended before
+// that still counts, through av_end, just as in the plain read path.
+static
+qioerr _qio_codec_read_frames(qio_channel_t* ch, int64_t amt)
+{
+  ssize_t bound = ch->codec->encode_bound((ssize_t) qbytes_iobuf_size);
+  qioerr err;
+
+  while( amt > 0 ) {
+    qio_codec_frame_t frame;
+    ssize_t raw_len = 0;
+    qbytes_t* bytes = NULL;
+
+    err = _qio_codec_read_all(ch->file->fd, &frame, sizeof(frame));
+    if( err ) return err;
+
+    if( frame.enc_len > (uint32_t) bound ||
+        frame.raw_len > (uint32_t) qbytes_iobuf_size )
+      QIO_RETURN_CONSTANT_ERROR(EINVAL, "corrupt codec frame");
+
+    err = _qio_codec_read_all(ch->file->fd, ch->codec_enc,
+                              (ssize_t) frame.enc_len);
+    if( err ) {
+      // a frame header with no payload is truncation, not clean EOF.
+      if( qio_err_to_int(err) == EEOF ) return QIO_ESHORT;
+      return err;
+    }
+
+    err = ch->codec->decode(ch->codec_enc, (ssize_t) frame.enc_len,
+                            ch->codec_raw, (ssize_t) qbytes_iobuf_size,
+                            &raw_len);
+    if( err ) return err;
+    if( raw_len != (ssize_t) frame.raw_len )
+      QIO_RETURN_CONSTANT_ERROR(EINVAL, "corrupt codec frame");
+
+    err = qbytes_create_iobuf(&bytes);
+    if( err ) return err;
+
+    qio_memcpy(bytes->data, ch->codec_raw, raw_len);
+
+    err = qbuffer_append(&ch->buf, bytes, 0, raw_len);
+    qbytes_release(bytes);
+    if( err ) return err;
+
+    ch->av_end = qbuffer_end_offset(&ch->buf);
+    amt -= raw_len;
+  }
+
+  return 0;
+}
+
+//
+// Asynchronous readahead.  Reactive refills stall a sequential scan
+// for a full round trip per buffer on network filesystems like
+// Lustre.  When enabled (CHPL_RT_QIO_READAHEAD=<window bytes>; 0, the
+// default, disables it), every pread-method refill also starts a
+// background task that reads the next window at av_end into a side
+// qbytes buffer; a later refill that finds that window lined up with
+// its append point splices it into the channel's buffer zero-copy
+// instead of issuing a blocking read, so the network round trip
+// overlaps with the consumer.  Only the plain pread path prefetches:
+// positional reads leave the fd offset alone (pread on one fd from
+// two tasks is safe), mmap channels already get kernel readahead
+// through madvise, and codec/plugin channels have their own framing.
+// The fill task holds a channel reference, so the channel cannot be
+// destroyed under it.
+//
+typedef struct {
+  chpl_task_bundle_t task;
+  qio_readahead_t* ra;
+} qio_readahead_bundle_t;
+
+static
+void qio_readahead_fill(void* arg)
+{
+  qio_readahead_t* ra = ((qio_readahead_bundle_t*) arg)->ra;
+  qio_channel_t* ch = ra->ch;
+  qbytes_t* bytes = NULL;
+  int64_t got = 0;
+
+  if( !qbytes_create_calloc(&bytes, ra->want) ) {
+    while( got < ra->want ) {
+      ssize_t num_read = 0;
+      err_t err = sys_pread(ch->file->fd, (char*) bytes->data + got,
+                            ra->want - got, ra->offset + got, &num_read);
+      if( err == EINTR ) continue;
+      if( err || num_read == 0 ) break;
+      got += num_read;
+    }
+  }
+
+  if( got > 0 ) {
+    ra->bytes = bytes;
+    ra->len = got;
+    atomic_store_bool(&ra->valid, true);
+  } else {
+    if( bytes ) qbytes_release(bytes);
+  }
+
+  atomic_store_bool(&ra->busy, false);
+  qio_channel_release(ch);
+}
+
+static
+void qio_readahead_start(qio_channel_t* ch)
+{
+  qio_readahead_t* ra = ch->readahead;
+  qio_readahead_bundle_t bundle;
+  int64_t want;
+
+  if( ra == NULL ) {
+    int64_t window = chpl_env_rt_get_int("QIO_READAHEAD", 0);
+    if( window <= 0 ) return;
+    if( ch->codec || ch->chan_info ) return;
+    if( (ch->hints & QIO_METHODMASK) != QIO_METHOD_PREADPWRITE ) return;
+
+    ra = (qio_readahead_t*) qio_calloc(1, sizeof(qio_readahead_t));
+    if( ra == NULL ) return;
+    atomic_init_bool(&ra->busy, false);
+    atomic_init_bool(&ra->valid, false);
+    ra->window = window;
+    ra->ch = ch;
+    ch->readahead = ra;
+  }
+
+  // one window in flight or waiting at a time
+  if( atomic_load_bool(&ra->busy) || atomic_load_bool(&ra->valid) ) return;
+
+  want = ra->window;
+  if( ch->end_pos < INT64_MAX ) {
+    if( ch->av_end >= ch->end_pos ) return;
+    if( want > ch->end_pos - ch->av_end ) want = ch->end_pos - ch->av_end;
+  }
+
+  ra->offset = ch->av_end;
+  ra->want = want;
+
+  atomic_store_bool(&ra->busy, true);
+  qio_channel_retain(ch);
+
+  memset(&bundle, 0, sizeof(bundle));
+  bundle.ra = ra;
+  chpl_task_startMovedTask(FID_NONE, qio_readahead_fill,
+                           &bundle, sizeof(bundle),
+                           c_sublocid_any, chpl_nullTaskID);
+}
+
 // Runs read or pread, whichever is appropriate,
 // to read into the buffer.
 static
@@ -2231,6 +2771,39 @@ qioerr _buffered_read_atleast(qio_channel_t* ch, int64_t amt)
     return chpl_qio_read_atleast(ch->chan_info, amt);
   }
 
+  if( ch->codec ) {
+    err = _qio_codec_read_frames(ch, amt);
+    if( err ) return err;
+    if( return_eof ) return QIO_EEOF;
+    return 0;
+  }
+
+  // Splice in the asynchronously prefetched window if it lines up
+  // with the append point; a window that does not (after a seek, say)
+  // is just dropped.
+  if( ch->readahead ) {
+    qio_readahead_t* ra = ch->readahead;
+    if( !atomic_load_bool(&ra->busy) && atomic_load_bool(&ra->valid) ) {
+      if( ra->offset == ch->av_end && ra->len <= max_amt ) {
+        err = qbuffer_append(&ch->buf, ra->bytes, 0, ra->len);
+        if( err ) return err;
+        ch->av_end = qbuffer_end_offset(&ch->buf);
+        amt -= ra->len;
+        max_amt -= ra->len;
+      }
+      qbytes_release(ra->bytes);
+      ra->bytes = NULL;
+      atomic_store_bool(&ra->valid, false);
+    }
+  }
+
+  if( amt <= 0 ) {
+    // the prefetched window covered the request; keep the pipe full
+    qio_readahead_start(ch);
+    if( return_eof ) return QIO_EEOF;
+    return 0;
+  }
+
   //printf("Allocating bufferspace %lli\n", (long long int) amt);
   err = _buffered_allocate_bufferspace(ch, amt, max_amt);
   if( err ) return err;
@@ -2278,6 +2851,9 @@ qioerr _buffered_read_atleast(qio_channel_t* ch, int64_t amt)
 
   if( err ) return err;
 
+  // start prefetching the window after what we just read
+  qio_readahead_start(ch);
+
   if( return_eof ) return QIO_EEOF;
   else return 0;
 }
@@ -2664,6 +3240,10 @@ qioerr _qio_buffered_behind(qio_channel_t* ch, int flushall)
   }
 
   if(ch->flags & QIO_FDFLAG_WRITEABLE) {
+    if( ch->codec ) {
+      err = _qio_codec_write_frames(ch, &write_start, write_end);
+      if( err ) goto error;
+    } else
     while( qbuffer_iter_num_bytes(write_start, write_end) > 0 ) {
       QIO_GET_CONSTANT_ERROR(err, EINVAL, "write method not implemented");
       num_written = 0;
@@ -3502,6 +4082,110 @@ qioerr qio_channel_put_buffer(const int threadsafe, qio_channel_t* ch, qbuffer_t
   return err;
 }
 
+/* Write a large contiguous block of binary data, streaming it straight
+ * from the caller's memory.
+ *
+ * Writing big numeric arrays through qio_channel_write copies every byte
+ * through the channel's I/O buffers before it reaches writev()/pwritev().
+ * This routine instead appends the caller's memory to the channel buffer
+ * as a borrowed qbytes part, so the write-behind machinery hands it to
+ * the vectored write alongside whatever was already buffered, without an
+ * intermediate copy.
+ *
+ * The borrowed part never outlives the call: the buffer is flushed
+ * through the current offset before returning, and if the flush stops
+ * early the unwritten remainder of the block is trimmed back out of the
+ * buffer and reported as not written. Small blocks, unbuffered channels,
+ * MMAP/MEMORY/plugin channels, marked channels (which must retain data
+ * for revert), and O_DIRECT channels with unaligned data all fall back
+ * to a plain buffered write.
+ */
+qioerr qio_channel_write_block_stream(const int threadsafe, qio_channel_t* restrict ch, const void* restrict ptr, ssize_t len, ssize_t* restrict amt_written)
+{
+  qioerr err;
+  qioerr flush_err;
+  qbytes_t* bytes = NULL;
+  qio_method_t method = (qio_method_t) (ch->hints & QIO_METHODMASK);
+  int64_t start_offset;
+  int64_t flushed_offset;
+  int64_t keep_offset;
+  int64_t trim;
+
+  *amt_written = 0;
+
+  if( len < 0 ) QIO_RETURN_CONSTANT_ERROR(EINVAL, "negative length");
+  if( len == 0 ) return 0;
+
+  if( threadsafe ) {
+    err = qio_lock(&ch->lock);
+    if( err ) return err;
+  }
+
+  if( len < (ssize_t) (2*qbytes_iobuf_size) ||
+      !_use_buffered(ch, len) ||
+      method == QIO_METHOD_MMAP ||
+      method == QIO_METHOD_MEMORY ||
+      ch->chan_info != NULL ||
+      ch->mark_cur > 0 ||
+      ((ch->hints & QIO_HINT_DIRECT) &&
+       (((uintptr_t) ptr) & 511) != 0) ) {
+    err = qio_channel_write(false, ch, ptr, len, amt_written);
+    goto unlock;
+  }
+
+  if( ! (ch->flags & QIO_FDFLAG_WRITEABLE) ) {
+    QIO_GET_CONSTANT_ERROR(err, EBADF, "not writeable");
+    goto unlock;
+  }
+
+  // Sync the position from the fast-path pointer and flush any
+  // partial bits before we measure where the block starts.
+  _qio_buffered_advance_cached(ch);
+
+  start_offset = _right_mark_start(ch);
+
+  err = qbytes_create_generic(&bytes, (void*) ptr, len, qbytes_free_null);
+  if( err ) goto unlock;
+
+  err = _qio_channel_put_bytes_unlocked(ch, bytes, 0, len);
+
+  // The buffer retains the part (if it was appended); in any case we
+  // are done with our reference.
+  qbytes_release(bytes);
+
+  // Push the borrowed part all the way out; it must not stay in the
+  // buffer once we return.
+  flush_err = _qio_buffered_behind(ch, true);
+  if( err == 0 ) err = flush_err;
+
+  // If the flush stopped early, un-append whatever portion of the block
+  // is still sitting in the buffer, so that no reference to the caller's
+  // memory survives the call. Anything in the buffer past
+  // max(start_offset, flushed offset) is unwritten borrowed data.
+  flushed_offset = qbuffer_start_offset(&ch->buf);
+  keep_offset = (flushed_offset > start_offset) ? flushed_offset : start_offset;
+  trim = qbuffer_end_offset(&ch->buf) - keep_offset;
+  if( trim > 0 ) {
+    qbuffer_trim_back(&ch->buf, trim);
+    ch->av_end = qbuffer_end_offset(&ch->buf);
+    _set_right_mark_start(ch, ch->av_end);
+  }
+
+  *amt_written = _right_mark_start(ch) - start_offset;
+
+  // report EOF if the channel's region cut the block short.
+  if( err == 0 && *amt_written < len ) err = QIO_EEOF;
+
+  _qio_channel_set_error_unlocked(ch, err);
+
+unlock:
+  if( threadsafe ) {
+    qio_unlock(&ch->lock);
+  }
+
+  return err;
+}
+
 // you don't have to call end_peek_buffer if this returns an error
 qioerr qio_channel_begin_peek_buffer(const int threadsafe, qio_channel_t* ch, int64_t require, int writing, qbuffer_t** buf_out, qbuffer_iter_t* start_out, qbuffer_iter_t* end_out)
 {
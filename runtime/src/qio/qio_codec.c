@@ -0,0 +1,178 @@
+/*
+ * Copyright 2020-2021 Hewlett Packard Enterprise Development LP
+ * Copyright 2004-2019 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef CHPL_RT_UNIT_TEST
+#include "chplrt.h"
+#endif
+
+#include "qio_codec.h"
+
+#include <errno.h>
+
+/************** built-in "rle" codec **************/
+
+/* PackBits-style byte run-length coding.  A control byte c is
+ * followed by either c+1 literal bytes (c in 0..127) or one byte to
+ * be repeated 257-c times (c in 129..255); 128 is a no-op.  Runs of
+ * three or more identical bytes are worth encoding; shorter ones ride
+ * along in literal groups.  Worst case adds one control byte per 128
+ * literals.
+ */
+
+static
+ssize_t qio_codec_rle_bound(ssize_t in_len)
+{
+  return in_len + (in_len + 127) / 128 + 1;
+}
+
+static
+qioerr qio_codec_rle_encode(const void* in_v, ssize_t in_len,
+                            void* out_v, ssize_t out_max, ssize_t* out_len)
+{
+  const unsigned char* in = (const unsigned char*) in_v;
+  unsigned char* out = (unsigned char*) out_v;
+  ssize_t i = 0;
+  ssize_t o = 0;
+
+  while( i < in_len ) {
+    ssize_t run = 1;
+    while( i + run < in_len && run < 128 && in[i+run] == in[i] ) run++;
+
+    if( run >= 3 ) {
+      if( o + 2 > out_max )
+        QIO_RETURN_CONSTANT_ERROR(ESHORT, "rle output full");
+      out[o++] = (unsigned char) (257 - run);
+      out[o++] = in[i];
+      i += run;
+    } else {
+      // gather literals until the next worthwhile run (or 128 bytes)
+      ssize_t lit = 0;
+      while( i + lit < in_len && lit < 128 ) {
+        if( i + lit + 2 < in_len &&
+            in[i+lit] == in[i+lit+1] &&
+            in[i+lit] == in[i+lit+2] )
+          break;
+        lit++;
+      }
+      if( o + 1 + lit > out_max )
+        QIO_RETURN_CONSTANT_ERROR(ESHORT, "rle output full");
+      out[o++] = (unsigned char) (lit - 1);
+      memcpy(&out[o], &in[i], lit);
+      o += lit;
+      i += lit;
+    }
+  }
+
+  *out_len = o;
+  return 0;
+}
+
+static
+qioerr qio_codec_rle_decode(const void* in_v, ssize_t in_len,
+                            void* out_v, ssize_t out_max, ssize_t* out_len)
+{
+  const unsigned char* in = (const unsigned char*) in_v;
+  unsigned char* out = (unsigned char*) out_v;
+  ssize_t i = 0;
+  ssize_t o = 0;
+
+  while( i < in_len ) {
+    unsigned char c = in[i++];
+
+    if( c == 128 ) continue;
+
+    if( c < 128 ) {
+      ssize_t lit = (ssize_t) c + 1;
+      if( i + lit > in_len )
+        QIO_RETURN_CONSTANT_ERROR(EINVAL, "corrupt rle input");
+      if( o + lit > out_max )
+        QIO_RETURN_CONSTANT_ERROR(ESHORT, "rle output full");
+      memcpy(&out[o], &in[i], lit);
+      o += lit;
+      i += lit;
+    } else {
+      ssize_t rep = 257 - (ssize_t) c;
+      if( i >= in_len )
+        QIO_RETURN_CONSTANT_ERROR(EINVAL, "corrupt rle input");
+      if( o + rep > out_max )
+        QIO_RETURN_CONSTANT_ERROR(ESHORT, "rle output full");
+      memset(&out[o], in[i++], rep);
+      o += rep;
+    }
+  }
+
+  *out_len = o;
+  return 0;
+}
+
+static const qio_codec_fns_t qio_codec_rle = {
+  "rle",
+  &qio_codec_rle_bound,
+  &qio_codec_rle_encode,
+  &qio_codec_rle_decode,
+};
+
+/************** registry **************/
+
+#define QIO_CODEC_MAX_REGISTERED 8
+
+static const qio_codec_fns_t* qio_codecs[QIO_CODEC_MAX_REGISTERED];
+static int qio_num_codecs = 0;
+
+static
+void qio_codec_register_builtin(void)
+{
+  if( qio_num_codecs == 0 )
+    qio_codecs[qio_num_codecs++] = &qio_codec_rle;
+}
+
+qioerr qio_codec_register(const qio_codec_fns_t* fns)
+{
+  if( !fns || !fns->name ||
+      !fns->encode_bound || !fns->encode || !fns->decode )
+    QIO_RETURN_CONSTANT_ERROR(EINVAL, "incomplete codec");
+
+  qio_codec_register_builtin();
+
+  if( qio_codec_lookup(fns->name) != NULL )
+    QIO_RETURN_CONSTANT_ERROR(EINVAL, "duplicate codec name");
+
+  if( qio_num_codecs >= QIO_CODEC_MAX_REGISTERED )
+    return QIO_ENOMEM;
+
+  qio_codecs[qio_num_codecs++] = fns;
+  return 0;
+}
+
+const qio_codec_fns_t* qio_codec_lookup(const char* name)
+{
+  int i;
+
+  if( !name ) return NULL;
+
+  qio_codec_register_builtin();
+
+  for( i = 0; i < qio_num_codecs; i++ ) {
+    if( strcmp(qio_codecs[i]->name, name) == 0 )
+      return qio_codecs[i];
+  }
+
+  return NULL;
+}
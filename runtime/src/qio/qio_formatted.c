@@ -3025,6 +3025,37 @@ static inline int _ltoa_convert(char *tmp, int tmplen, uint64_t num, int base, i
   return at;
 }
 
+// digit pairs 00..99, used to emit decimal digits two at a time
+static const char qio_two_digits[201] =
+  "00010203040506070809101112131415161718192021222324"
+  "25262728293031323334353637383940414243444546474849"
+  "50515253545556575859606162636465666768697071727374"
+  "75767778798081828384858687888990919293949596979899";
+
+// decimal specialization of _ltoa_convert.
+// Emits two digits per divide through the pair table above, halving
+// the number of divisions on the common base-10 path.  tmp must have
+// room for the largest 64-bit decimal number plus '\0' (21 bytes), so
+// unlike _ltoa_convert this cannot overflow.
+static inline int _ltoa_convert_decimal(char *tmp, int tmplen, uint64_t num)
+{
+  int at = tmplen - 1;
+  tmp[at] = '\0';
+  while( num >= 100 ) {
+    unsigned int rem = num % 100;
+    num /= 100;
+    tmp[--at] = qio_two_digits[2*rem+1];
+    tmp[--at] = qio_two_digits[2*rem];
+  }
+  if( num >= 10 ) {
+    tmp[--at] = qio_two_digits[2*num+1];
+    tmp[--at] = qio_two_digits[2*num];
+  } else {
+    tmp[--at] = '0' + num;
+  }
+  return at;
+}
+
 // dst must have room (at most 65 bytes for binary + '\0')
 // Returns the number of characters written (not including '\0')
 // or >= size if there wasn't room in the buffer (returns amt needed)
@@ -3050,7 +3081,7 @@ int _ltoa(char* restrict dst, size_t size, uint64_t num, int isnegative,
   else if( base == 8 )
     tmp_skip = _ltoa_convert(tmp, sizeof(tmp), num, 8, 0);
   else if( base == 10 )
-    tmp_skip = _ltoa_convert(tmp, sizeof(tmp), num, 10, 0);
+    tmp_skip = _ltoa_convert_decimal(tmp, sizeof(tmp), num);
   else if( base == 16 )
     tmp_skip = _ltoa_convert(tmp, sizeof(tmp), num, 16, style->uppercase);
   else
@@ -18,6 +18,13 @@
  * limitations under the License.
  */
 
+// For splice(); must come before the first libc header.
+#ifdef __linux__
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#endif
+
 #include "sys_basic.h"
 
 #ifndef CHPL_RT_UNIT_TEST
@@ -30,6 +37,7 @@
 
 #include "qio_popen.h"
 
+#include <fcntl.h>
 #include <sys/select.h>
 #include <sys/types.h>
 #include <sys/wait.h>
@@ -431,6 +439,217 @@ qioerr qio_waitpid(int64_t pid,
   return 0;
 }
 
+// Bounce-buffer fallback for qio_proc_forward_fds, used when splice
+// is unavailable. Copies through a small stack buffer, yielding to
+// other tasks whenever the pipe would block.
+static
+qioerr qio_proc_forward_copy(int from_fd, int to_fd,
+                             int64_t max_bytes, int64_t* amt_forwarded)
+{
+  char buf[16*1024];
+  int64_t total = 0;
+  ssize_t got, wrote, sofar;
+
+  while( max_bytes < 0 || total < max_bytes ) {
+    size_t n = sizeof(buf);
+    if( max_bytes >= 0 && max_bytes - total < (int64_t) n )
+      n = max_bytes - total;
+
+    got = read(from_fd, buf, n);
+    if( got == 0 ) break; // EOF
+    if( got < 0 ) {
+      if( errno == EINTR ) continue;
+      if( errno == EAGAIN || errno == EWOULDBLOCK ) {
+        chpl_task_yield();
+        continue;
+      }
+      *amt_forwarded = total;
+      return qio_int_to_err(errno);
+    }
+
+    for( sofar = 0; sofar < got; sofar += wrote ) {
+      wrote = write(to_fd, buf + sofar, got - sofar);
+      if( wrote < 0 ) {
+        wrote = 0;
+        if( errno == EINTR ) continue;
+        if( errno == EAGAIN || errno == EWOULDBLOCK ) {
+          chpl_task_yield();
+          continue;
+        }
+        *amt_forwarded = total + sofar;
+        return qio_int_to_err(errno);
+      }
+    }
+
+    total += got;
+  }
+
+  *amt_forwarded = total;
+  return 0;
+}
+
+// Forward up to max_bytes (or to EOF, if max_bytes is negative) from
+// from_fd to to_fd. On Linux the bytes move with splice(), which works
+// without copying to userspace as long as one side is a pipe -- always
+// the case for the subprocess descriptors created by qio_openproc.
+// Elsewhere, or if splice refuses this pair of descriptors, fall back
+// to a read/write loop.
+static
+qioerr qio_proc_forward_fds(int from_fd, int to_fd,
+                            int64_t max_bytes, int64_t* amt_forwarded)
+{
+#if defined(__linux__) && defined(SPLICE_F_MOVE)
+  int64_t total = 0;
+  ssize_t got;
+
+  while( max_bytes < 0 || total < max_bytes ) {
+    size_t n = 1024*1024;
+    if( max_bytes >= 0 && max_bytes - total < (int64_t) n )
+      n = max_bytes - total;
+
+    got = splice(from_fd, NULL, to_fd, NULL, n,
+                 SPLICE_F_MOVE|SPLICE_F_MORE);
+    if( got == 0 ) break; // EOF
+    if( got < 0 ) {
+      if( errno == EINTR ) continue;
+      if( errno == EAGAIN || errno == EWOULDBLOCK ) {
+        chpl_task_yield();
+        continue;
+      }
+      if( errno == EINVAL && total == 0 ) {
+        // neither descriptor is a pipe; copy through userspace instead
+        return qio_proc_forward_copy(from_fd, to_fd, max_bytes,
+                                     amt_forwarded);
+      }
+      *amt_forwarded = total;
+      return qio_int_to_err(errno);
+    }
+    total += got;
+  }
+
+  *amt_forwarded = total;
+  return 0;
+#else
+  return qio_proc_forward_copy(from_fd, to_fd, max_bytes, amt_forwarded);
+#endif
+}
+
+// Forward data between two descriptor-backed files without passing it
+// through channel buffers, e.g. from a plain file straight into a
+// subprocess's stdin pipe or from its stdout pipe into a file. This is
+// only correct when no transformation is applied, so the caller must
+// not have channels with buffered data open on either file; data moves
+// from/to the files' current descriptor offsets.
+qioerr qio_proc_forward(qio_file_t* from, qio_file_t* to,
+                        int64_t max_bytes, int64_t* amt_forwarded)
+{
+  *amt_forwarded = 0;
+
+  if( !from || !to || from->fd == -1 || to->fd == -1 )
+    QIO_RETURN_CONSTANT_ERROR(EINVAL,
+        "qio_proc_forward requires descriptor-backed files");
+
+  return qio_proc_forward_fds(from->fd, to->fd, max_bytes, amt_forwarded);
+}
+
+// The drain thread does for one output pipe what the error arm of
+// qio_proc_communicate's select loop does: buffer everything the
+// subprocess writes until EOF, then close the file (not the channel)
+// and cap end_pos so later reads come from the buffer. Because it is a
+// plain pthread it can just sleep in read(2) between bursts instead of
+// occupying a task that polls.
+//
+// The thread has no task context, so it takes the channel lock with
+// the extern-thread entry points rather than inheriting it from the
+// task that called qio_proc_drain_async: the task-owned lock would
+// re-enter for that task (racing the drain) and could not be released
+// from this thread at all. While the drain holds the lock, tasks
+// trying to read the channel wait in qio_lock until EOF.
+static
+void* qio_proc_drain_thread(void* arg)
+{
+  qio_channel_t* ch = (qio_channel_t*) arg;
+  qioerr err = 0;
+
+  qio_lock_extern_thread(&ch->lock);
+
+  while( true ) {
+    err = qio_channel_advance(false, ch, qbytes_iobuf_size);
+    if( qio_err_to_int(err) == EEOF ) {
+      qio_file_t* file = qio_channel_get_file(ch);
+
+      // close the file (not the channel), leaving the buffered
+      // data readable.
+      if( file )
+        qio_file_close(file);
+      ch->end_pos = qio_channel_offset_unlocked(ch);
+      break;
+    }
+    if( err ) break;
+  }
+
+  qio_channel_revert_unlocked(ch);
+  qio_unlock_extern_thread(&ch->lock);
+  qio_channel_release(ch);
+
+  return NULL;
+}
+
+// Start draining a subprocess output channel (normally stderr) on a
+// background thread, so that qio_proc_communicate need not be handed
+// the channel and no task is tied up watching the pipe. The drain
+// thread holds the channel lock until the subprocess closes its end,
+// so reads of the buffered data block until then. (There is a window
+// between this function returning and the drain thread taking the
+// lock in which a reader can slip in; that only consumes buffered
+// data early and is harmless, since the mark below keeps everything
+// buffered and the drain's final revert restores the position.)
+qioerr qio_proc_drain_async(qio_channel_t* ch)
+{
+  qioerr err = 0;
+  pthread_t thread;
+  int rc;
+
+  if( ch == NULL ) return 0;
+
+  err = qio_lock(&ch->lock);
+  if( err ) return err;
+
+  if( qio_channel_isclosed(false, ch) ) {
+    qio_unlock(&ch->lock);
+    return 0;
+  }
+
+  // mark so that all of the data read stays buffered, as in
+  // qio_proc_communicate.
+  err = qio_channel_mark(false, ch);
+  if( err ) {
+    qio_unlock(&ch->lock);
+    return err;
+  }
+
+  qio_channel_retain(ch);
+
+  // The drain thread takes the lock itself; a task-owned lock cannot
+  // be handed across threads.
+  qio_unlock(&ch->lock);
+
+  rc = pthread_create(&thread, NULL, qio_proc_drain_thread, ch);
+  if( rc ) {
+    err = qio_lock(&ch->lock);
+    if( ! err ) {
+      qio_channel_revert_unlocked(ch);
+      qio_unlock(&ch->lock);
+    }
+    qio_channel_release(ch);
+    QIO_RETURN_CONSTANT_ERROR(EAGAIN,
+        "failed pthread_create in qio_proc_drain_async");
+  }
+  pthread_detach(thread);
+
+  return 0;
+}
+
 // commit input, sending any data to the subprocess.
 // once input is sent, close input channel and file.
 // While sending that data, read output and error channels,
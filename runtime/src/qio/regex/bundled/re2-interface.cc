@@ -310,6 +310,35 @@ qio_bool qio_regex_match(qio_regex_t* regex, const char* text, int64_t text_len,
   return ret;
 }
 
+int64_t qio_regex_match_all(qio_regex_t* regex, const char* text, int64_t text_len, int64_t startpos, int64_t endpos, qio_regex_string_piece_t* matches, int64_t maxmatches)
+{
+  StringPiece textp(text, text_len);
+  RE2* re = (RE2*) regex->regex;
+  int64_t n = 0;
+  int64_t pos = startpos;
+
+  // No prefilter here on purpose: RE2's search already accelerates
+  // literal prefixes with memchr internally, so the win of this routine
+  // is batching and reporting spans instead of copies.
+  while( n < maxmatches && pos <= endpos ) {
+    StringPiece m;
+    int64_t off;
+
+    if( ! re->Match(textp, pos, endpos, RE2::UNANCHORED, &m, 1) ) break;
+
+    off = qio_ptr_diff((void*) m.data(), (void*) textp.data());
+    matches[n].offset = off;
+    matches[n].len = m.length();
+    n++;
+
+    // Step past the match; an empty match must not match again in place.
+    if( m.length() == 0 ) pos = off + 1;
+    else pos = off + m.length();
+  }
+
+  return n;
+}
+
 int64_t qio_regex_replace(qio_regex_t* regex, const char* repl, int64_t repl_len, const char* str, int64_t str_len, int64_t startpos, int64_t endpos, qio_bool global, const char** str_out, int64_t* len_out)
 {
   // This could make fewer copies of everything...
@@ -1068,6 +1068,274 @@ int64_t sys_iov_total_bytes(const struct iovec* iov, int iovcnt)
   return tot;
 }
 
+#if defined(__linux__) && !defined(CHPL_RT_UNIT_TEST)
+#include <sys/syscall.h>
+#ifdef __NR_io_uring_setup
+#include <linux/io_uring.h>
+#include <pthread.h>
+#define SYS_HAS_IO_URING 1
+#endif
+#endif
+
+#ifdef SYS_HAS_IO_URING
+
+/* Optional io_uring engine for positional vector I/O.
+ *
+ * A qthread blocked in preadv/pwritev stalls its shepherd for the
+ * duration of the system call.  When CHPL_RT_QIO_IO_URING is set we
+ * instead submit the operation to a kernel io_uring and let the
+ * Chapel task yield until the completion arrives, so other tasks can
+ * run on the shepherd while the kernel does the I/O.
+ *
+ * This talks to the ring directly via the raw system calls rather
+ * than through liburing, to avoid a new third-party dependency.  One
+ * process-wide ring is shared by all tasks; the ring itself is only
+ * touched under a mutex, and waiters poll their own completion flag,
+ * yielding between polls.  If the kernel lacks io_uring, or a
+ * submission cannot be queued, callers silently fall back to the
+ * blocking path.
+ */
+
+extern void chpl_task_yield(void);
+
+#define URING_QUEUE_DEPTH 64
+
+static struct {
+  int ring_fd;
+  // submission queue (pointers into the SQ ring mapping)
+  unsigned* sq_head;
+  unsigned* sq_tail;
+  unsigned* sq_mask;
+  unsigned* sq_array;
+  struct io_uring_sqe* sqes;
+  // completion queue (pointers into the CQ ring mapping)
+  unsigned* cq_head;
+  unsigned* cq_tail;
+  unsigned* cq_mask;
+  struct io_uring_cqe* cqes;
+  pthread_mutex_t lock;
+} uring;
+
+// One per in-flight operation, owned by the waiting task's stack.
+// The reaper fills in res and then publishes done.
+struct uring_waiter_s {
+  int done;
+  int res;
+};
+
+// 0 = not available or not requested, 1 = ready
+static int uring_enabled = 0;
+static pthread_once_t uring_once = PTHREAD_ONCE_INIT;
+
+static void uring_init(void)
+{
+  struct io_uring_params p;
+  void* sq_ptr;
+  void* cq_ptr;
+  void* sqe_ptr;
+  size_t sq_sz;
+  size_t cq_sz;
+  size_t sqe_sz;
+  int fd;
+  const char* ev;
+
+  ev = getenv("CHPL_RT_QIO_IO_URING");
+  if( ev == NULL || *ev == '\0' ||
+      *ev == '0' || *ev == 'n' || *ev == 'N' || *ev == 'f' || *ev == 'F' ) {
+    return;
+  }
+
+  memset(&p, 0, sizeof(p));
+  fd = syscall(__NR_io_uring_setup, URING_QUEUE_DEPTH, &p);
+  if( fd < 0 ) {
+    // kernel without io_uring; stay on the blocking path
+    return;
+  }
+
+  sq_sz = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+  cq_sz = p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+  sqe_sz = p.sq_entries * sizeof(struct io_uring_sqe);
+
+  sq_ptr = mmap(NULL, sq_sz, PROT_READ|PROT_WRITE, MAP_SHARED|MAP_POPULATE,
+                fd, IORING_OFF_SQ_RING);
+  cq_ptr = mmap(NULL, cq_sz, PROT_READ|PROT_WRITE, MAP_SHARED|MAP_POPULATE,
+                fd, IORING_OFF_CQ_RING);
+  sqe_ptr = mmap(NULL, sqe_sz, PROT_READ|PROT_WRITE, MAP_SHARED|MAP_POPULATE,
+                 fd, IORING_OFF_SQES);
+  if( sq_ptr == MAP_FAILED || cq_ptr == MAP_FAILED || sqe_ptr == MAP_FAILED ) {
+    if( sq_ptr != MAP_FAILED ) munmap(sq_ptr, sq_sz);
+    if( cq_ptr != MAP_FAILED ) munmap(cq_ptr, cq_sz);
+    if( sqe_ptr != MAP_FAILED ) munmap(sqe_ptr, sqe_sz);
+    close(fd);
+    return;
+  }
+
+  uring.ring_fd = fd;
+  uring.sq_head = (unsigned*) ((char*) sq_ptr + p.sq_off.head);
+  uring.sq_tail = (unsigned*) ((char*) sq_ptr + p.sq_off.tail);
+  uring.sq_mask = (unsigned*) ((char*) sq_ptr + p.sq_off.ring_mask);
+  uring.sq_array = (unsigned*) ((char*) sq_ptr + p.sq_off.array);
+  uring.sqes = (struct io_uring_sqe*) sqe_ptr;
+  uring.cq_head = (unsigned*) ((char*) cq_ptr + p.cq_off.head);
+  uring.cq_tail = (unsigned*) ((char*) cq_ptr + p.cq_off.tail);
+  uring.cq_mask = (unsigned*) ((char*) cq_ptr + p.cq_off.ring_mask);
+  uring.cqes = (struct io_uring_cqe*) ((char*) cq_ptr + p.cq_off.cqes);
+  if( pthread_mutex_init(&uring.lock, NULL) != 0 ) {
+    munmap(sq_ptr, sq_sz);
+    munmap(cq_ptr, cq_sz);
+    munmap(sqe_ptr, sqe_sz);
+    close(fd);
+    return;
+  }
+
+  uring_enabled = 1;
+}
+
+// Queue one SQE and tell the kernel about it.  Returns 0 on success,
+// -1 if the ring is full or the submission failed (caller falls back).
+static int uring_submit(int opcode, fd_t fd,
+                        const struct iovec* iov, int iovcnt, off_t offset,
+                        struct uring_waiter_s* waiter)
+{
+  unsigned tail;
+  unsigned idx;
+  struct io_uring_sqe* sqe;
+  int got;
+
+  pthread_mutex_lock(&uring.lock);
+
+  tail = *uring.sq_tail;
+  if( tail - __atomic_load_n(uring.sq_head, __ATOMIC_ACQUIRE) >
+      *uring.sq_mask ) {
+    pthread_mutex_unlock(&uring.lock);
+    return -1;
+  }
+
+  idx = tail & *uring.sq_mask;
+  sqe = &uring.sqes[idx];
+  memset(sqe, 0, sizeof(*sqe));
+  sqe->opcode = opcode;
+  sqe->fd = fd;
+  sqe->addr = (uintptr_t) iov;
+  sqe->len = iovcnt;
+  sqe->off = offset;
+  sqe->user_data = (uintptr_t) waiter;
+
+  uring.sq_array[idx] = idx;
+  __atomic_store_n(uring.sq_tail, tail + 1, __ATOMIC_RELEASE);
+
+  got = syscall(__NR_io_uring_enter, uring.ring_fd, 1, 0, 0, NULL, 0);
+
+  if( got <= 0 ) {
+    // The kernel did not consume our SQE (EINTR/EAGAIN/EBUSY, or it
+    // consumed nothing). The entry was published by the tail store
+    // above, and if it were left there, the next enter from any later
+    // submission would run it against an iovec and waiter whose
+    // operation the caller is about to retire through the blocking
+    // fallback. Submissions are serialized under the ring lock and
+    // the kernel only reads the tail during enter, so unpublish the
+    // entry by putting the tail back.
+    __atomic_store_n(uring.sq_tail, tail, __ATOMIC_RELEASE);
+    pthread_mutex_unlock(&uring.lock);
+    return -1;
+  }
+
+  pthread_mutex_unlock(&uring.lock);
+
+  return 0;
+}
+
+// Hand finished CQEs to their waiters.  Call with the ring lock held.
+static void uring_reap(void)
+{
+  unsigned head = *uring.cq_head;
+
+  while( head != __atomic_load_n(uring.cq_tail, __ATOMIC_ACQUIRE) ) {
+    struct io_uring_cqe* cqe = &uring.cqes[head & *uring.cq_mask];
+    struct uring_waiter_s* waiter =
+      (struct uring_waiter_s*) (uintptr_t) cqe->user_data;
+    waiter->res = cqe->res;
+    __atomic_store_n(&waiter->done, 1, __ATOMIC_RELEASE);
+    head++;
+  }
+
+  __atomic_store_n(uring.cq_head, head, __ATOMIC_RELEASE);
+}
+
+// Wait for our completion, yielding this task between polls.
+// Returns the CQE result: bytes transferred, or a negative errno.
+static int uring_wait(struct uring_waiter_s* waiter)
+{
+  while( ! __atomic_load_n(&waiter->done, __ATOMIC_ACQUIRE) ) {
+    if( pthread_mutex_trylock(&uring.lock) == 0 ) {
+      uring_reap();
+      pthread_mutex_unlock(&uring.lock);
+    }
+    if( ! __atomic_load_n(&waiter->done, __ATOMIC_ACQUIRE) ) {
+      chpl_task_yield();
+    }
+  }
+  return waiter->res;
+}
+
+// Run one preadv/pwritev-shaped operation through the ring.  Returns
+// the byte count like preadv/pwritev, setting errno on -1.  Returns
+// -1 with errno == ENOSYS if the caller should use the blocking path.
+static ssize_t uring_iov_op(int opcode, fd_t fd,
+                            const struct iovec* iov, int iovcnt, off_t offset)
+{
+  struct uring_waiter_s waiter;
+  int res;
+
+  pthread_once(&uring_once, uring_init);
+  if( ! uring_enabled ) {
+    errno = ENOSYS;
+    return -1;
+  }
+
+  waiter.done = 0;
+  waiter.res = 0;
+  if( uring_submit(opcode, fd, iov, iovcnt, offset, &waiter) != 0 ) {
+    errno = ENOSYS;
+    return -1;
+  }
+
+  res = uring_wait(&waiter);
+  if( res < 0 ) {
+    errno = -res;
+    return -1;
+  }
+  return res;
+}
+
+#endif // SYS_HAS_IO_URING
+
+// preadv/pwritev through the io_uring engine when it's available and
+// enabled, and directly otherwise.  Same interface as preadv/pwritev.
+#ifdef HAS_PREADV
+static ssize_t do_preadv_yielding(fd_t fd, struct iovec* iov, int iovcnt,
+                                  off_t offset)
+{
+#ifdef SYS_HAS_IO_URING
+  ssize_t got = uring_iov_op(IORING_OP_READV, fd, iov, iovcnt, offset);
+  if( ! (got == -1 && errno == ENOSYS) ) return got;
+#endif
+  return preadv(fd, iov, iovcnt, offset);
+}
+#endif
+
+#ifdef HAS_PWRITEV
+static ssize_t do_pwritev_yielding(fd_t fd, struct iovec* iov, int iovcnt,
+                                   off_t offset)
+{
+#ifdef SYS_HAS_IO_URING
+  ssize_t got = uring_iov_op(IORING_OP_WRITEV, fd, iov, iovcnt, offset);
+  if( ! (got == -1 && errno == ENOSYS) ) return got;
+#endif
+  return pwritev(fd, iov, iovcnt, offset);
+}
+#endif
+
 err_t sys_readv(fd_t fd, const struct iovec* iov, int iovcnt, ssize_t* num_read_out)
 {
   ssize_t got;
@@ -1160,7 +1428,8 @@ err_t sys_preadv(fd_t fd, const struct iovec* iov, int iovcnt, off_t seek_to_off
     if( niovs > IOV_MAX ) niovs = IOV_MAX;
 
     // Some systems preadv doesn't take a const struct iovec*, hence the cast
-    got = preadv(fd, (struct iovec*) &iov[i], niovs, seek_to_offset + got_total);
+    got = do_preadv_yielding(fd, (struct iovec*) &iov[i], niovs,
+                             seek_to_offset + got_total);
     #ifdef __CYGWIN__
     if( got == -1 && errno == ENODATA ) got = 0;
     #endif
@@ -1238,7 +1507,8 @@ err_t sys_pwritev(fd_t fd, const struct iovec* iov, int iovcnt, off_t seek_to_of
     if( niovs > IOV_MAX ) niovs = IOV_MAX;
 
     // Some systems pwritev doesn't take a const struct iovec*, hence the cast
-    got = pwritev(fd, (struct iovec*) &iov[i], niovs, seek_to_offset + got_total);
+    got = do_pwritev_yielding(fd, (struct iovec*) &iov[i], niovs,
+                              seek_to_offset + got_total);
     if( got != -1 ) {
       got_total += got;
     } else {
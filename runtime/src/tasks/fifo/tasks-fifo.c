@@ -28,11 +28,13 @@
 #include "chpl-arg-bundle.h"
 #include "chpl-atomics.h"
 #include "chpl-comm.h"
+#include "chpl-env.h"
 #include "chplexit.h"
 #include "chpl-locale-model.h"
 #include "chpl-mem.h"
 #include "chpl-tasks.h"
 #include "chpl-tasks-callbacks-internal.h"
+#include "chpl-trace.h"
 #include "chpl-topo.h"
 #include "chpltypes.h"
 #include "chpl-linefile-support.h"
@@ -64,6 +66,8 @@ typedef struct task_pool_struct {
 
   chpl_task_prvDataImpl_t chpl_data;
 
+  chpl_bool        onFiberPool;  // is this a fiber-pool descriptor?
+
   chpl_task_bundle_t* taskBundle; // addr of task bundle in bundle below
   chpl_any_arg_bundle_t bundle[0];
 } task_pool_t;
@@ -84,6 +88,24 @@ static volatile task_pool_p
 static volatile task_pool_p
                            task_pool_tail;     // tail of task pool
 
+//
+// fiber pool: a fixed set of preallocated task descriptors for tasks
+// the compiler marked non-blocking (see chpl_ftableNonBlocking).  Such
+// tasks are expected to run to completion on a worker thread, so their
+// descriptors can be recycled without a chpl_mem_alloc()/chpl_mem_free()
+// round trip per task, and they are dispatched ahead of the general
+// pool to keep their latency low.
+//
+#define FIBER_POOL_ARG_SIZE 320  // inline arg-bundle capacity per descriptor
+
+static int                 fiber_pool_size;    // number of descriptors
+                                               //   (0: pool disabled)
+static task_pool_p         fiber_free_head;    // free descriptors (LIFO)
+static volatile task_pool_p
+                           fiber_run_head;     // queued fiber tasks
+static volatile task_pool_p
+                           fiber_run_tail;
+
 static int                 queued_task_cnt;    // number of tasks in task pool
 static atomic_uint_least64_t
                            blocked_task_cnt;   // number of blocked tasks
@@ -100,6 +122,8 @@ static chpl_fn_p comm_task_fn;
 //
 static void                    enqueue_task(task_pool_p);
 static void                    dequeue_task(task_pool_p);
+static void                    fiber_pool_init(void);
+static void                    fiber_blocked_fallback(void);
 static void                    comm_task_wrapper(void*);
 static void                    taskCallBody(chpl_fn_int_t, chpl_fn_p,
                                             void*, size_t,
@@ -160,6 +184,7 @@ static void sync_wait_and_lock(chpl_sync_aux_t *s,
     if (!waited) {
       waited = true;
       (void) atomic_fetch_add_uint_least64_t(&blocked_task_cnt, 1);
+      fiber_blocked_fallback();
     }
   }
 
@@ -294,6 +319,9 @@ void chpl_task_init(void) {
   atomic_init_uint_least64_t(&blocked_task_cnt, 0);
   idle_thread_cnt = 0;
   task_pool_head = task_pool_tail = NULL;
+  fiber_free_head = NULL;
+  fiber_run_head = fiber_run_tail = NULL;
+  fiber_pool_init();
 
   chpl_thread_init(thread_begin, thread_end);
 
@@ -501,6 +529,93 @@ void dequeue_task(task_pool_p ptask) {
 }
 
 
+//
+// Set up the fiber pool: carve a single slab into fixed-size
+// descriptors and thread them onto the free list.  The pool size can
+// be adjusted, or the pool disabled entirely, via
+// CHPL_RT_FIBER_POOL_SIZE.
+//
+static void fiber_pool_init(void) {
+  const size_t desc_size = offsetof(task_pool_t, bundle)
+                           + FIBER_POOL_ARG_SIZE;
+  char* slab;
+  int i;
+
+  fiber_pool_size = (int) chpl_env_rt_get_int("FIBER_POOL_SIZE", 128);
+  if (fiber_pool_size <= 0) {
+    fiber_pool_size = 0;
+    return;
+  }
+
+  slab = (char*) chpl_mem_allocMany(fiber_pool_size, desc_size,
+                                    CHPL_RT_MD_TASK_POOL_DESC, 0, 0);
+  for (i = 0; i < fiber_pool_size; i++) {
+    task_pool_p ptask = (task_pool_p) (slab + i * desc_size);
+    ptask->next = fiber_free_head;
+    fiber_free_head = ptask;
+  }
+}
+
+
+//
+// Enqueue and dequeue tasks from the fiber run queue.  As with the
+// general pool, the caller must hold threading_lock.
+//
+static inline
+void fiber_enqueue_task(task_pool_p ptask) {
+  queued_task_cnt++;
+
+  ptask->next = NULL;
+  ptask->prev = fiber_run_tail;
+  if (fiber_run_tail)
+    fiber_run_tail->next = ptask;
+  else
+    fiber_run_head = ptask;
+  fiber_run_tail = ptask;
+}
+
+
+static inline
+task_pool_p fiber_dequeue_task(void) {
+  task_pool_p ptask = fiber_run_head;
+
+  assert(queued_task_cnt > 0);
+  queued_task_cnt--;
+
+  if ((fiber_run_head = ptask->next) == NULL)
+    fiber_run_tail = NULL;
+  else
+    fiber_run_head->prev = NULL;
+  ptask->next = NULL;
+  ptask->prev = NULL;
+
+  return ptask;
+}
+
+
+//
+// A task running on a fiber-pool descriptor was expected to run to
+// completion, but it is blocking after all.  It already owns a full
+// thread, so it simply keeps it; the fallback is to backfill the
+// worker pool so that any tasks queued behind it still make progress.
+//
+static void fiber_blocked_fallback(void) {
+  task_pool_p ptask = get_current_ptask(false /*must_be_task*/);
+
+  if (ptask == NULL || !ptask->onFiberPool)
+    return;
+
+  // begin critical section
+  chpl_thread_mutexLock(&threading_lock);
+
+  if (queued_task_cnt > idle_thread_cnt)
+    maybe_add_thread();
+
+  // end critical section
+  chpl_thread_mutexUnlock(&threading_lock);
+}
+
+
 void chpl_task_addTask(chpl_fn_int_t fid,
                        chpl_task_bundle_t* arg, size_t arg_size,
                        c_sublocid_t subloc,
@@ -508,6 +623,7 @@ void chpl_task_addTask(chpl_fn_int_t fid,
   assert(subloc == c_sublocid_any);
 
   arg->kind = CHPL_ARG_BUNDLE_KIND_TASK;
+  chpl_trace_stamp_bundle(arg);
 
   // begin critical section
   chpl_thread_mutexLock(&threading_lock);
@@ -520,10 +636,38 @@ void chpl_task_addTask(chpl_fn_int_t fid,
 }
 
 
+void chpl_task_addTasksBulk(chpl_fn_int_t fid,
+                            chpl_task_bundle_t* args, size_t arg_size,
+                            int64_t num_tasks,
+                            c_sublocid_t subloc,
+                            int lineno, int32_t filename) {
+  int64_t i;
+
+  assert(subloc == c_sublocid_any);
+
+  // Add all of the tasks under a single acquisition of the pool lock.
+  // begin critical section
+  chpl_thread_mutexLock(&threading_lock);
+
+  for (i = 0; i < num_tasks; i++) {
+    chpl_task_bundle_t* arg = (chpl_task_bundle_t*)
+                              ((char*) args + (size_t) i * arg_size);
+    arg->kind = CHPL_ARG_BUNDLE_KIND_TASK;
+    chpl_trace_stamp_bundle(arg);
+    (void) add_to_task_pool(fid, chpl_ftable[fid], arg, arg_size,
+                            false, lineno, filename);
+  }
+
+  // end critical section
+  chpl_thread_mutexUnlock(&threading_lock);
+}
+
+
 void chpl_task_taskCallFTable(chpl_fn_int_t fid,
                         void* arg, size_t arg_size,
                         c_sublocid_t subloc,
                         int lineno, int32_t filename) {
+  chpl_trace_stamp_bundle(chpl_argBundleTaskArgBundle(arg));
   taskCallBody(fid, chpl_ftable[fid], arg, arg_size, subloc, lineno, filename);
 }
 
@@ -650,6 +794,11 @@ chpl_task_infoChapel_t* chpl_task_getInfoChapel(void) {
   return & get_current_ptask(true /*must_be_task*/)->taskBundle->infoChapel;
 }
 
+uint64_t chpl_task_getTraceSpan(void) {
+  task_pool_p ptask = get_current_ptask(false /*must_be_task*/);
+  return ptask ? ptask->taskBundle->trace_span : 0;
+}
+
 
 size_t chpl_task_getCallStackSize(void) {
   return chpl_thread_getCallStackSize();
@@ -723,13 +872,20 @@ task_pool_p get_current_ptask(chpl_bool must_be_task) {
 // pending tasks and those that are running.
 //
 static void report_all_tasks(void) {
-  task_pool_p pendingTask = task_pool_head;
+  task_pool_p pendingTask;
 
   printf("Task report\n");
   printf("--------------------------------\n");
 
   // print out pending tasks
   printf("Pending tasks:\n");
+  pendingTask = fiber_run_head;  // fiber-pool tasks are dispatched first
+  while (pendingTask != NULL) {
+    printf("- %s:%d\n", chpl_lookupFilename(pendingTask->taskBundle->filename),
+           pendingTask->taskBundle->lineno);
+    pendingTask = pendingTask->next;
+  }
+  pendingTask = task_pool_head;
   while (pendingTask != NULL) {
     printf("- %s:%d\n", chpl_lookupFilename(pendingTask->taskBundle->filename),
            pendingTask->taskBundle->lineno);
@@ -763,6 +919,7 @@ static void SIGINT_handler(int sig) {
 static void
 thread_begin(void* ptask_void) {
   task_pool_p ptask;
+  chpl_bool onFiberPool;
   thread_private_data_t *tp;
 
   tp = (thread_private_data_t*) chpl_mem_alloc(sizeof(thread_private_data_t),
@@ -787,10 +944,10 @@ thread_begin(void* ptask_void) {
     // that were waiting on the signal, but since there was a performance
     // impact from keeping it as a hybrid as opposed to merely yielding,
     // it was decided that we would return to the simple yield case.
-    while (!task_pool_head) {
+    while (!task_pool_head && !fiber_run_head) {
       do {
         chpl_thread_yield();
-      } while (!task_pool_head);
+      } while (!task_pool_head && !fiber_run_head);
     }
 
     //
@@ -798,13 +955,15 @@ thread_begin(void* ptask_void) {
     // there's something still there.
     //
     chpl_thread_mutexLock(&threading_lock);
-    if (!task_pool_head) {
+    if (!task_pool_head && !fiber_run_head) {
       chpl_thread_mutexUnlock(&threading_lock);
       continue;
     }
 
     //
-    // We've found a task to run.
+    // We've found a task to run.  Fiber-pool tasks go first: they are
+    // expected to be short and non-blocking, so draining them promptly
+    // keeps their latency low.
     //
 
     //
@@ -812,10 +971,15 @@ thread_begin(void* ptask_void) {
     // (structure in ChapelRuntime that keeps track of currently running tasks
     // for task-reports on deadlock or Ctrl+C).
     //
-    ptask = task_pool_head;
     idle_thread_cnt--;
 
-    dequeue_task(ptask);
+    if (fiber_run_head) {
+      ptask = fiber_dequeue_task();
+    }
+    else {
+      ptask = task_pool_head;
+      dequeue_task(ptask);
+    }
 
     // end critical section
     chpl_thread_mutexUnlock(&threading_lock);
@@ -837,6 +1001,8 @@ thread_begin(void* ptask_void) {
 
     (ptask->taskBundle->requested_fn)(&ptask->bundle);
 
+    chpl_mem_arena_reset();
+
     chpl_task_do_callbacks(chpl_task_cb_event_kind_end,
                            ptask->taskBundle->requested_fid,
                            ptask->taskBundle->filename,
@@ -851,14 +1017,22 @@ thread_begin(void* ptask_void) {
     }
 
     tp->ptask = NULL;
-    chpl_mem_free(ptask, 0, 0);
+
+    onFiberPool = ptask->onFiberPool;
+    if (!onFiberPool)
+      chpl_mem_free(ptask, 0, 0);
 
     // begin critical section
     chpl_thread_mutexLock(&threading_lock);
 
     //
-    // finished task; increment idle count
+    // finished task; recycle its descriptor if it came from the fiber
+    // pool, and increment idle count
     //
+    if (onFiberPool) {
+      ptask->next = fiber_free_head;
+      fiber_free_head = ptask;
+    }
     idle_thread_cnt++;
 
     // end critical section
@@ -924,6 +1098,7 @@ task_pool_p add_to_task_pool(chpl_fn_int_t fid, chpl_fn_p fp,
 
 
   task_pool_p ptask;
+  chpl_bool onFiberPool = false;
   chpl_task_prvDataImpl_t pv;
 
   memset(&pv, 0, sizeof(pv));
@@ -933,9 +1108,26 @@ task_pool_p add_to_task_pool(chpl_fn_int_t fid, chpl_fn_p fp,
   // could be either a comm or a task one.
   //
   assert(a_size >= chpl_argBundleSizeofHdr(a));
-  ptask = (task_pool_p) chpl_mem_alloc(offsetof(task_pool_t, bundle) + a_size,
-                                       CHPL_RT_MD_TASK_ARG_AND_POOL_DESC,
-                                       lineno, filename);
+
+  //
+  // Tasks the compiler marked non-blocking are expected to run to
+  // completion on a worker thread, so when one fits, carry it on a
+  // recycled descriptor from the fiber pool instead of a fresh heap
+  // allocation.
+  //
+  if (fiber_free_head != NULL
+      && fid != FID_NONE
+      && a_size <= FIBER_POOL_ARG_SIZE
+      && chpl_ftableNonBlocking[fid]) {
+    ptask = fiber_free_head;
+    fiber_free_head = ptask->next;
+    onFiberPool = true;
+  }
+  else {
+    ptask = (task_pool_p) chpl_mem_alloc(offsetof(task_pool_t, bundle) + a_size,
+                                         CHPL_RT_MD_TASK_ARG_AND_POOL_DESC,
+                                         lineno, filename);
+  }
 
   memcpy(&ptask->bundle, a, a_size);
   ptask->taskBundle = chpl_argBundleTaskArgBundle(&ptask->bundle);
@@ -943,6 +1135,7 @@ task_pool_p add_to_task_pool(chpl_fn_int_t fid, chpl_fn_p fp,
   ptask->next                   = NULL;
   ptask->prev                   = NULL;
   ptask->chpl_data              = pv;
+  ptask->onFiberPool            = onFiberPool;
 
   *ptask->taskBundle =
     (chpl_task_bundle_t)
@@ -953,10 +1146,14 @@ task_pool_p add_to_task_pool(chpl_fn_int_t fid, chpl_fn_p fp,
       .requested_fid   = fid,
       .requested_fn    = fp,
       .id              = get_next_task_id(),
+      .trace_span      = ptask->taskBundle->trace_span,// retain; see chpl-trace.h
       .infoChapel      = ptask->taskBundle->infoChapel,// retain; set by caller
     };
 
-  enqueue_task(ptask);
+  if (onFiberPool)
+    fiber_enqueue_task(ptask);
+  else
+    enqueue_task(ptask);
 
   chpl_task_do_callbacks(chpl_task_cb_event_kind_create,
                          ptask->taskBundle->requested_fid,
@@ -48,6 +48,7 @@
 #include "chpl-tasks-callbacks-internal.h"
 #include "chpl-tasks-impl.h"
 #include "chpl-topo.h"
+#include "chpl-trace.h"
 #include "chpltypes.h"
 
 #include "qthread.h"
@@ -128,6 +129,24 @@ volatile int chpl_qthread_done_initializing;
 static aligned_t canexit = 0;
 static pthread_mutex_t init_mutex = PTHREAD_MUTEX_INITIALIZER;
 
+//
+// When true, tasks that may run anywhere are pushed onto the spawning
+// shepherd's own queue and idle shepherds acquire them by stealing,
+// instead of being distributed round-robin at spawn time.  Set from
+// CHPL_RT_TASK_SPAWN_LOCAL; see chpl_task_init().
+//
+static chpl_bool localSpawn = false;
+
+//
+// When positive, chpl_task_addTask() runs new tasks inline on the
+// spawning task once the queue depth passes this watermark, bounding
+// the queue instead of letting a wide fan-out queue millions of task
+// bundles.  Set from CHPL_RT_TASK_QUEUE_WATERMARK; see
+// chpl_task_init().
+//
+static int64_t taskQueueWatermark = 0;
+static aligned_t numThrottledTasks = 0;
+
 // Make qt env sizes uniform. Same as qt, but they use the literal everywhere
 #define QT_ENV_S 100
 
@@ -175,6 +194,11 @@ static chpl_bool guardPagesInUse = true;
 void chpl_task_yield(void)
 {
     PROFILE_INCR(profile_task_yield,1);
+
+    // Let the comm layer make network progress off this yield before
+    // the processor moves on to another task.
+    chpl_comm_task_yield();
+
     if (qthread_shep() == NO_SHEPHERD) {
         sched_yield();
     } else {
@@ -183,18 +207,48 @@ void chpl_task_yield(void)
 }
 
 // Sync variables
+//
+// The sync lock is adaptive: the lock word holds 0 (unlocked), 1
+// (locked, no waiters), or 2 (locked, there may be waiters), so an
+// uncontended lock/unlock is one CAS and never enters the qthreads
+// FEB hash.  Contended lockers mark the state 2 and block on the
+// signal_lock FEB word, which carries one wakeup "token" per
+// unlock-with-waiters.  Likewise, the full/empty waiter counts (which
+// the lock protects) let markAndSignalFull/Empty skip the FEB fill
+// when no task is waiting for the transition.
+//
+// A fresh FEB word is full, so the first blocking readFE on a given
+// sync variable can consume a token that was never handed off and
+// wake spuriously; all of the retry loops here absorb that.
+
 void chpl_sync_lock(chpl_sync_aux_t *s)
 {
     PROFILE_INCR(profile_sync_lock, 1);
 
-    qthread_lock(&s->lock);
+    if (qthread_cas(&s->lock, 0, 1) == 0)
+        return;
+
+    while (1) {
+        aligned_t old = qthread_cas(&s->lock, 0, 2);
+        if (old == 0)
+            return;
+        if (old == 1 && qthread_cas(&s->lock, 1, 2) != 1)
+            continue;  // state changed under us; re-examine it
+        qthread_readFE(NULL, &s->signal_lock);
+    }
 }
 
 void chpl_sync_unlock(chpl_sync_aux_t *s)
 {
     PROFILE_INCR(profile_sync_unlock, 1);
 
-    qthread_unlock(&s->lock);
+    if (qthread_cas(&s->lock, 1, 0) == 1)
+        return;
+
+    // We hold the lock, so the state must have been 2: release the
+    // lock and hand a token to one waiter.
+    (void) qthread_cas(&s->lock, 2, 0);
+    qthread_fill(&s->signal_lock);
 }
 
 void chpl_sync_waitFullAndLock(chpl_sync_aux_t *s,
@@ -205,9 +259,11 @@ void chpl_sync_waitFullAndLock(chpl_sync_aux_t *s,
 
     chpl_sync_lock(s);
     while (s->is_full == 0) {
+        s->num_waiters_full++;
         chpl_sync_unlock(s);
         qthread_readFE(NULL, &(s->signal_full));
         chpl_sync_lock(s);
+        s->num_waiters_full--;
     }
 }
 
@@ -219,9 +275,11 @@ void chpl_sync_waitEmptyAndLock(chpl_sync_aux_t *s,
 
     chpl_sync_lock(s);
     while (s->is_full != 0) {
+        s->num_waiters_empty++;
         chpl_sync_unlock(s);
         qthread_readFE(NULL, &(s->signal_empty));
         chpl_sync_lock(s);
+        s->num_waiters_empty--;
     }
 }
 
@@ -229,8 +287,9 @@ void chpl_sync_markAndSignalFull(chpl_sync_aux_t *s)         // and unlock
 {
     PROFILE_INCR(profile_sync_markAndSignalFull, 1);
 
-    qthread_fill(&(s->signal_full));
     s->is_full = 1;
+    if (s->num_waiters_full > 0)
+        qthread_fill(&(s->signal_full));
     chpl_sync_unlock(s);
 }
 
@@ -238,8 +297,9 @@ void chpl_sync_markAndSignalEmpty(chpl_sync_aux_t *s)         // and unlock
 {
     PROFILE_INCR(profile_sync_markAndSignalEmpty, 1);
 
-    qthread_fill(&(s->signal_empty));
     s->is_full = 0;
+    if (s->num_waiters_empty > 0)
+        qthread_fill(&(s->signal_empty));
     chpl_sync_unlock(s);
 }
 
@@ -255,10 +315,13 @@ void chpl_sync_initAux(chpl_sync_aux_t *s)
 {
     PROFILE_INCR(profile_sync_initAux, 1);
 
-    s->lock         = 0;
-    s->is_full      = 0;
-    s->signal_empty = 0;
-    s->signal_full  = 0;
+    s->lock              = 0;
+    s->signal_lock       = 0;
+    s->is_full           = 0;
+    s->num_waiters_full  = 0;
+    s->num_waiters_empty = 0;
+    s->signal_empty      = 0;
+    s->signal_full       = 0;
 }
 
 void chpl_sync_destroyAux(chpl_sync_aux_t *s)
@@ -527,6 +590,8 @@ static chpl_bool setupGuardPages(void) {
     // under the following conditions (Precedence high-to-low):
     //  - Guard pages disabled at configure time
     //  - Guard pages not supported because of huge pages
+    //  - Hugepage-backed task stacks requested (guard pages cannot be
+    //    carved out of a hugetlb mapping at system page granularity)
     //  - Guard pages not supported by processor
     //  - QT_GUARD_PAGES set to a 'false' value
     //  - CHPL_STACK_CHECKS set (--no-stack-checks thrown at compilation time)
@@ -534,6 +599,8 @@ static chpl_bool setupGuardPages(void) {
         guardPagesEnabled = false;
     } else if (chpl_getHeapPageSize() != chpl_getSysPageSize()) {
         guardPagesEnabled = false;
+    } else if (chpl_env_rt_get_bool("TASK_STACK_HUGEPAGES", false)) {
+        guardPagesEnabled = false;
     } else if (strncmp(armArch, CHPL_TARGET_CPU, strlen(armArch)) == 0) {
         guardPagesEnabled = false;
     } else {
@@ -618,6 +685,15 @@ static void setupCallStacks(void) {
     }
     snprintf(newenv_alloc, sizeof(newenv_alloc), "%zu", maxPoolAllocSize);
     chpl_qt_setenv("MAX_POOL_ALLOC_SIZE", newenv_alloc, 0);
+
+    // Optionally back the task-stack pool's slabs with hugepages
+    // (CHPL_RT_TASK_STACK_HUGEPAGES).  This trades guard pages (see
+    // setupGuardPages()) for less TLB pressure with large stacks; if
+    // no hugepages are available at run time, Qthreads quietly falls
+    // back to ordinary heap allocation.
+    if (chpl_env_rt_get_bool("TASK_STACK_HUGEPAGES", false)) {
+        chpl_qt_setenv("STACK_HUGE_PAGES", "true", 0);
+    }
 }
 
 static void setupTasklocalStorage(void) {
@@ -639,7 +715,10 @@ static void setupWorkStealing(void) {
     // try working stealing out by setting {QT,QTHREAD}_STEAL_RATIO. Also note
     // that not all schedulers support work stealing, but it doesn't hurt to
     // set this env var for those configs anyways.
-    chpl_qt_setenv("STEAL_RATIO", "0", 0);
+    //
+    // Local spawning depends on stealing to distribute work, so in that
+    // mode use the Qthreads default steal ratio rather than disabling it.
+    chpl_qt_setenv("STEAL_RATIO", localSpawn ? "8" : "0", 0);
 }
 
 static void setupSpinWaiting(void) {
@@ -661,6 +740,16 @@ static void setupAffinity(void) {
   chpl_qt_setenv("LAYOUT", "BALANCED", 0);
 }
 
+static void report_throttled_tasks(void)
+{
+    if (numThrottledTasks > 0) {
+        fprintf(stderr,
+                "qthreads tasking: ran %" PRIu64 " task(s) inline "
+                "(queue watermark %" PRId64 ")\n",
+                (uint64_t) numThrottledTasks, taskQueueWatermark);
+    }
+}
+
 void chpl_task_init(void)
 {
     int32_t   commMaxThreads;
@@ -670,6 +759,17 @@ void chpl_task_init(void)
 
     commMaxThreads = chpl_comm_getMaxThreads();
 
+    // Local spawning only helps when shepherds have their own queues
+    // and can steal from each other; with a single-worker-per-shepherd
+    // (central queue) scheduler it would just serialize execution.
+    localSpawn = !CHPL_QTHREAD_SCHEDULER_ONE_WORKER_PER_SHEPHERD &&
+                 chpl_env_rt_get_bool("TASK_SPAWN_LOCAL", false);
+
+    // Bound the task queue by running excess tasks inline; 0 disables.
+    taskQueueWatermark = chpl_env_rt_get_int("TASK_QUEUE_WATERMARK", 0);
+    if (taskQueueWatermark > 0)
+        atexit(report_throttled_tasks);
+
     // Set up hardware parallelism, the stack size and stack guards,
     // tasklocal storage, and work stealing
     setupAvailableParallelism(commMaxThreads);
@@ -739,11 +839,59 @@ static aligned_t chapel_wrapper(void *arg)
 
     (bundle->requested_fn)(arg);
 
+    chpl_mem_arena_reset();
+
     wrap_callbacks(chpl_task_cb_event_kind_end, bundle);
 
     return 0;
 }
 
+//
+// Run a task's body inline on the spawning task, for admission control
+// in chpl_task_addTask().  Mirrors chapel_wrapper(), except that the
+// spawner's task-local state is saved and restored around the body and
+// the memory arena is left alone -- it belongs to the spawning task.
+//
+static void run_task_inline(void *arg)
+{
+    chpl_qthread_tls_t    *tls = chpl_qthread_get_tasklocal();
+    chpl_task_bundle_t *bundle = chpl_argBundleTaskArgBundle(arg);
+    chpl_qthread_tls_t   saved = *tls;
+    chpl_qthread_tls_t      pv = {.bundle = bundle};
+
+    *tls = pv;
+
+    wrap_callbacks(chpl_task_cb_event_kind_begin, bundle);
+
+    (bundle->requested_fn)(arg);
+
+    wrap_callbacks(chpl_task_cb_event_kind_end, bundle);
+
+    *tls = saved;
+
+    qthread_incr(&numThrottledTasks, 1);
+}
+
+//
+// Spawn a task that may execute on any sublocale.  By default let
+// Qthreads pick a destination, which round-robins across shepherds
+// through a shared counter.  In local-spawn mode push onto the current
+// shepherd's queue instead, so fan-out spawns don't contend on that
+// counter or on remote queues; idle shepherds steal the excess.
+//
+static inline void fork_unbound(void *arg, size_t arg_size)
+{
+    if (localSpawn) {
+        qthread_shepherd_id_t shep = qthread_shep();
+        if (shep != NO_SHEPHERD) {
+            qthread_fork_copyargs_to(chapel_wrapper, arg, arg_size, NULL,
+                                     shep);
+            return;
+        }
+    }
+    qthread_fork_copyargs(chapel_wrapper, arg, arg_size, NULL);
+}
+
 typedef struct {
     chpl_fn_p fn;
     void *arg;
@@ -828,16 +976,155 @@ void chpl_task_addTask(chpl_fn_int_t       fid,
              .infoChapel      = arg->infoChapel, // retain; set by caller
            };
 
+    chpl_trace_stamp_bundle(arg);
+
     wrap_callbacks(chpl_task_cb_event_kind_create, arg);
 
+    // Admission control: past the watermark, run the task here rather
+    // than queueing it.  Task context only, so spawns from the comm
+    // handler's pthread are never absorbed into their spawner.
+    if (taskQueueWatermark > 0 && qthread_shep() != NO_SHEPHERD &&
+        (int64_t) chpl_task_getNumQueuedTasks() > taskQueueWatermark) {
+        run_task_inline(arg);
+        return;
+    }
+
     if (execution_subloc == c_sublocid_any) {
-        qthread_fork_copyargs(chapel_wrapper, arg, arg_size, NULL);
+        fork_unbound(arg, arg_size);
     } else {
         qthread_fork_copyargs_to(chapel_wrapper, arg, arg_size, NULL,
                                  (qthread_shepherd_id_t) execution_subloc);
     }
 }
 
+//
+// Bulk task creation, as a spawn tree.  The bundles are copied into a
+// refcounted staging block up front (we cannot assume anything about
+// the caller's memory once we return), then a tree of helper qthreads
+// halves the index range until at most BULK_SPAWN_LEAF_MAX leaves
+// remain per node and forks those.  Each level of the tree doubles the
+// number of tasks doing the forking, so ramp-up for an n-task coforall
+// is O(log n) instead of n serial trips through qthread_fork.
+//
+#define BULK_SPAWN_LEAF_MAX 8
+
+typedef struct {
+    aligned_t    remaining;        // leaves not yet forked
+    size_t       arg_size;
+    c_sublocid_t execution_subloc;
+    // the initialized bundles follow, num_tasks * arg_size bytes
+} bulk_spawn_t;
+
+typedef struct {
+    bulk_spawn_t *spawn;
+    int64_t       lo;
+    int64_t       hi;
+} bulk_spawn_node_t;
+
+static inline chpl_task_bundle_t *bulk_spawn_arg(bulk_spawn_t *spawn,
+                                                 int64_t i)
+{
+    return (chpl_task_bundle_t *)
+           ((char *) (spawn + 1) + (size_t) i * spawn->arg_size);
+}
+
+static aligned_t bulk_spawn_tree(void *arg)
+{
+    bulk_spawn_node_t node = *(bulk_spawn_node_t *) arg;
+    bulk_spawn_t *spawn = node.spawn;
+    int64_t nleaves;
+    int64_t i;
+
+    while (node.hi - node.lo > BULK_SPAWN_LEAF_MAX) {
+        bulk_spawn_node_t right = node;
+        right.lo = node.lo + (node.hi - node.lo) / 2;
+        node.hi = right.lo;
+        qthread_fork_copyargs(bulk_spawn_tree, &right, sizeof(right), NULL);
+    }
+
+    for (i = node.lo; i < node.hi; i++) {
+        void *leafArg = bulk_spawn_arg(spawn, i);
+        if (spawn->execution_subloc == c_sublocid_any) {
+            fork_unbound(leafArg, spawn->arg_size);
+        } else {
+            qthread_fork_copyargs_to(chapel_wrapper, leafArg,
+                                     spawn->arg_size, NULL,
+                                     (qthread_shepherd_id_t)
+                                     spawn->execution_subloc);
+        }
+    }
+
+    // free the staging block once every leaf has been forked (and so
+    // copied by Qthreads)
+    nleaves = node.hi - node.lo;
+    if (qthread_incr(&spawn->remaining, -nleaves) == (aligned_t) nleaves)
+        chpl_mem_free(spawn, 0, 0);
+
+    return 0;
+}
+
+void chpl_task_addTasksBulk(chpl_fn_int_t       fid,
+                            chpl_task_bundle_t *args,
+                            size_t              arg_size,
+                            int64_t             num_tasks,
+                            c_sublocid_t        full_subloc,
+                            int                 lineno,
+                            int32_t             filename)
+{
+    chpl_fn_p requested_fn = chpl_ftable[fid];
+    bulk_spawn_t *spawn;
+    bulk_spawn_node_t root;
+    int64_t i;
+
+    assert(isActualSublocID(full_subloc) || full_subloc == c_sublocid_any);
+
+    if (num_tasks <= 0)
+        return;
+
+    PROFILE_INCR(profile_task_addTask, num_tasks);
+
+    c_sublocid_t execution_subloc =
+      chpl_localeModel_sublocToExecutionSubloc(full_subloc);
+
+    spawn = chpl_mem_alloc(sizeof(*spawn) + (size_t) num_tasks * arg_size,
+                           CHPL_RT_MD_TASK_ARG, lineno, filename);
+    spawn->remaining = (aligned_t) num_tasks;
+    spawn->arg_size = arg_size;
+    spawn->execution_subloc = execution_subloc;
+
+    // Initialize all of the bundles here, mirroring chpl_task_addTask,
+    // so the creation callbacks fire on the caller and in order.
+    for (i = 0; i < num_tasks; i++) {
+        chpl_task_bundle_t *src = (chpl_task_bundle_t *)
+                                  ((char *) args + (size_t) i * arg_size);
+        chpl_task_bundle_t *dst = bulk_spawn_arg(spawn, i);
+
+        memcpy(dst, src, arg_size);
+        dst->kind            = CHPL_ARG_BUNDLE_KIND_TASK;
+        dst->is_executeOn    = false;
+        dst->lineno          = lineno;
+        dst->filename        = filename;
+        dst->requestedSubloc = full_subloc;
+        dst->requested_fid   = fid;
+        dst->requested_fn    = requested_fn;
+        dst->id              = chpl_nullTaskID;
+        chpl_trace_stamp_bundle(dst);
+
+        wrap_callbacks(chpl_task_cb_event_kind_create, dst);
+    }
+
+    root.spawn = spawn;
+    root.lo = 0;
+    root.hi = num_tasks;
+
+    if (num_tasks <= BULK_SPAWN_LEAF_MAX) {
+        // too small for a tree; fork the leaves directly
+        (void) bulk_spawn_tree(&root);
+    } else {
+        qthread_fork_copyargs(bulk_spawn_tree, &root, sizeof(root), NULL);
+    }
+}
+
 static inline void taskCallBody(chpl_fn_int_t fid, chpl_fn_p fp,
                                 void *arg, size_t arg_size,
                                 c_sublocid_t full_subloc,
@@ -856,13 +1143,14 @@ static inline void taskCallBody(chpl_fn_int_t fid, chpl_fn_p fp,
                 .requested_fid   = fid,
                 .requested_fn    = fp,
                 .id              = chpl_nullTaskID,
+                .trace_span      = bundle->trace_span, // retain; see chpl-trace.h
                 .infoChapel      = bundle->infoChapel, // retain; set by caller
               };
 
     wrap_callbacks(chpl_task_cb_event_kind_create, bundle);
 
     if (execution_subloc < 0) {
-        qthread_fork_copyargs(chapel_wrapper, arg, arg_size, NULL);
+        fork_unbound(arg, arg_size);
     } else {
         qthread_fork_copyargs_to(chapel_wrapper, arg, arg_size, NULL,
                                  (qthread_shepherd_id_t) execution_subloc);
@@ -876,6 +1164,7 @@ void chpl_task_taskCallFTable(chpl_fn_int_t fid,
 {
     PROFILE_INCR(profile_task_taskCallFTable,1);
 
+    chpl_trace_stamp_bundle(chpl_argBundleTaskArgBundle(arg));
     taskCallBody(fid, chpl_ftable[fid], arg, arg_size, subloc, lineno, filename);
 }
 
@@ -931,6 +1220,16 @@ chpl_taskID_t chpl_task_getId(void)
     return *id_ptr;
 }
 
+uint64_t chpl_task_getTraceSpan(void)
+{
+    chpl_qthread_tls_t *tls = chpl_qthread_get_tasklocal();
+
+    if (tls == NULL || tls->bundle == NULL)
+        return 0;
+
+    return tls->bundle->trace_span;
+}
+
 chpl_bool chpl_task_idEquals(chpl_taskID_t id1, chpl_taskID_t id2) {
   return id1 == id2;
 }
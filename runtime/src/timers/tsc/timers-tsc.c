@@ -0,0 +1,136 @@
+/*
+ * Copyright 2020-2021 Hewlett Packard Enterprise Development LP
+ * Copyright 2004-2019 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//
+// TSC-based timers (CHPL_TIMERS=tsc).
+//
+// The generic timer implementation calls gettimeofday() and localtime()
+// on every chpl_now_time() read, which is far too slow for code that
+// reads stopwatches inside hot loops.  Here we instead read the
+// processor timestamp counter and scale it by a frequency calibrated
+// once, on first use, against CLOCK_MONOTONIC, so a read is just a
+// couple of instructions.  The localtime() conversion that establishes
+// the microseconds-since-local-midnight base also runs only at
+// calibration time, which we redo when the day rolls over (this also
+// picks up DST changes).
+//
+// We assume the TSC is invariant (constant rate, synchronized across
+// cores), which holds on the x86 processors Chapel targets; on other
+// architectures we fall back to clock_gettime() against the cached
+// midnight base, which still avoids the per-read localtime().
+//
+
+#include "chplrt.h"
+
+#include "chpltimers.h"
+
+#include <stdint.h>
+#include <sys/time.h>
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define CHPL_TIMERS_HAVE_TSC 1
+#endif
+
+#define USEC_PER_DAY 86400.0e+6
+
+//
+// Calibration state.  The calibration is idempotent, so if multiple
+// tasks race to do it on first use, they all just compute equivalent
+// values.
+//
+static volatile int calibrated = 0;
+
+static _real64 usecBase;        // usec since local midnight, at the base
+#ifdef CHPL_TIMERS_HAVE_TSC
+static uint64_t tscBase;        // TSC reading at the base
+static _real64 usecPerTick;     // calibrated TSC period
+#else
+static struct timespec monoBase; // CLOCK_MONOTONIC reading at the base
+#endif
+
+//
+// Microseconds since local midnight right now, the way the generic
+// implementation computes it on every read.
+//
+static _real64 usecSinceMidnight(void) {
+  struct tm* now;
+  _timevalue t;
+  gettimeofday(&t, NULL);
+  now = localtime(&t.tv_sec);
+  return (_real64)(now->tm_hour)*3600.0e+6 +
+    (_real64)(now->tm_min)*60.0e+6 +
+    (_real64)(now->tm_sec)*1.0e+6 +
+    (_real64)(t.tv_usec);
+}
+
+static void calibrate(void) {
+#ifdef CHPL_TIMERS_HAVE_TSC
+  //
+  // Measure the TSC rate against CLOCK_MONOTONIC over a short sleep.
+  // This runs only at first use and at day rollover, so the pause is
+  // not a per-read cost.
+  //
+  struct timespec ts0, ts1;
+  uint64_t tsc0, tsc1;
+
+  tsc0 = __rdtsc();
+  clock_gettime(CLOCK_MONOTONIC, &ts0);
+
+  struct timespec pause = { .tv_sec = 0, .tv_nsec = 2 * 1000 * 1000 };
+  (void) nanosleep(&pause, NULL);
+
+  tsc1 = __rdtsc();
+  clock_gettime(CLOCK_MONOTONIC, &ts1);
+
+  _real64 usec = (_real64) (ts1.tv_sec - ts0.tv_sec) * 1.0e+6
+                 + (_real64) (ts1.tv_nsec - ts0.tv_nsec) * 1.0e-3;
+  usecPerTick = usec / (_real64) (tsc1 - tsc0);
+  tscBase = __rdtsc();
+#else
+  clock_gettime(CLOCK_MONOTONIC, &monoBase);
+#endif
+  usecBase = usecSinceMidnight();
+  calibrated = 1;
+}
+
+_real64 chpl_now_time(void) {
+  if (!calibrated)
+    calibrate();
+
+#ifdef CHPL_TIMERS_HAVE_TSC
+  _real64 t = usecBase + (_real64) (__rdtsc() - tscBase) * usecPerTick;
+#else
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  _real64 t = usecBase
+              + (_real64) (ts.tv_sec - monoBase.tv_sec) * 1.0e+6
+              + (_real64) (ts.tv_nsec - monoBase.tv_nsec) * 1.0e-3;
+#endif
+
+  if (t >= USEC_PER_DAY) {
+    // The day rolled over; rebase against the wall clock.
+    calibrate();
+    t = usecBase;
+  }
+
+  return t;
+}
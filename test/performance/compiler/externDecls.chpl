@@ -0,0 +1,73 @@
+// Compiler-performance pinned test: a large surface of extern
+// declarations.  Exercises scope resolution and codegen handling of
+// extern procs and types without requiring a C compiler beyond libc.
+
+extern proc strlen(s: c_string): size_t;
+extern proc strcmp(a: c_string, b: c_string): c_int;
+extern proc strncmp(a: c_string, b: c_string, n: size_t): c_int;
+extern proc memcmp(a: c_void_ptr, b: c_void_ptr, n: size_t): c_int;
+extern proc abs(x: c_int): c_int;
+extern proc labs(x: c_long): c_long;
+extern proc llabs(x: c_longlong): c_longlong;
+extern proc atoi(s: c_string): c_int;
+extern proc atol(s: c_string): c_long;
+extern proc atof(s: c_string): c_double;
+extern proc toupper(ch: c_int): c_int;
+extern proc tolower(ch: c_int): c_int;
+extern proc isalpha(ch: c_int): c_int;
+extern proc isdigit(ch: c_int): c_int;
+extern proc isspace(ch: c_int): c_int;
+extern proc isupper(ch: c_int): c_int;
+extern proc islower(ch: c_int): c_int;
+extern proc isalnum(ch: c_int): c_int;
+extern proc ispunct(ch: c_int): c_int;
+extern proc isprint(ch: c_int): c_int;
+extern proc rand(): c_int;
+extern proc srand(seed: c_uint): void;
+extern proc exit(status: c_int): void;
+extern proc getpid(): c_int;
+extern proc sqrt(x: c_double): c_double;
+extern proc cbrt(x: c_double): c_double;
+extern proc hypot(x: c_double, y: c_double): c_double;
+extern proc floor(x: c_double): c_double;
+extern proc ceil(x: c_double): c_double;
+extern proc round(x: c_double): c_double;
+extern proc trunc(x: c_double): c_double;
+extern proc fmod(x: c_double, y: c_double): c_double;
+extern proc pow(x: c_double, y: c_double): c_double;
+extern proc exp(x: c_double): c_double;
+extern proc exp2(x: c_double): c_double;
+extern proc expm1(x: c_double): c_double;
+extern proc log(x: c_double): c_double;
+extern proc log2(x: c_double): c_double;
+extern proc log10(x: c_double): c_double;
+extern proc log1p(x: c_double): c_double;
+extern proc sin(x: c_double): c_double;
+extern proc cos(x: c_double): c_double;
+extern proc tan(x: c_double): c_double;
+extern proc asin(x: c_double): c_double;
+extern proc acos(x: c_double): c_double;
+extern proc atan(x: c_double): c_double;
+extern proc atan2(y: c_double, x: c_double): c_double;
+extern proc sinh(x: c_double): c_double;
+extern proc cosh(x: c_double): c_double;
+extern proc tanh(x: c_double): c_double;
+extern proc asinh(x: c_double): c_double;
+extern proc acosh(x: c_double): c_double;
+extern proc atanh(x: c_double): c_double;
+extern proc erf(x: c_double): c_double;
+extern proc erfc(x: c_double): c_double;
+extern proc tgamma(x: c_double): c_double;
+extern proc lgamma(x: c_double): c_double;
+
+proc main() {
+  var acc = 0.0;
+  for i in 1..8 {
+    const x = i: c_double;
+    acc += sqrt(x) + cbrt(x) + floor(x) + ceil(x);
+    acc += sin(x) + cos(x) + tan(x / 8);
+    acc += exp(x / 8) + log(x) + hypot(x, x);
+  }
+  writeln(acc > 0.0);
+  writeln(strlen("compiler-perf".c_str()) == 13);
+}
@@ -0,0 +1,40 @@
+// Compiler-performance pinned test: many parallel loops.
+// Exercises forall/reduce lowering, task function creation, and the
+// parallel-loop optimization passes.
+
+config const n = 8;
+
+proc kernel(param k: int) {
+  var A: [1..n] real;
+  var B: [1..n] real;
+
+  forall i in 1..n do
+    A[i] = i * k;
+
+  forall (a, b) in zip(A, B) do
+    b = a + k;
+
+  var s = 0.0;
+  forall i in 1..n with (+ reduce s) do
+    s += A[i] * B[i];
+
+  var mx = min(real);
+  forall i in 1..n with (max reduce mx) do
+    mx = max(mx, A[i] - B[i]);
+
+  coforall t in 1..4 {
+    var local0 = 0.0;
+    for i in 1..n do
+      local0 += A[i] + t;
+    B[t % n + 1] = local0;
+  }
+
+  return s + mx + B[1];
+}
+
+proc main() {
+  var total = 0.0;
+  for param k in 1..24 do
+    total += kernel(k);
+  writeln(total != 0.0);
+}
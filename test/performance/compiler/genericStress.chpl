@@ -0,0 +1,51 @@
+// Compiler-performance pinned test: heavy generic instantiation.
+// Exercises resolution by instantiating a small set of generic
+// records and procedures across many concrete types and depths.
+
+record Wrap {
+  type t;
+  var x: t;
+}
+
+proc mix(a, b) {
+  return (a, b);
+}
+
+proc level0(x) {
+  return mix(x, x);
+}
+
+proc level1(x) {
+  return mix(level0(x), level0((x, x)));
+}
+
+proc level2(x) {
+  return mix(level1(x), level1((x, 1)));
+}
+
+proc level3(x) {
+  return mix(level2(x), level2((x, 1.0)));
+}
+
+proc poke(type t) {
+  var w: Wrap(t);
+  var v: Wrap(Wrap(t));
+  v.x = w;
+  return level3(w.x);
+}
+
+proc main() {
+  var r1 = poke(int(8));
+  var r2 = poke(int(16));
+  var r3 = poke(int(32));
+  var r4 = poke(int(64));
+  var r5 = poke(uint(8));
+  var r6 = poke(uint(16));
+  var r7 = poke(uint(32));
+  var r8 = poke(uint(64));
+  var r9 = poke(real(32));
+  var r10 = poke(real(64));
+  var r11 = poke(bool);
+  var r12 = poke(string);
+  writeln((r1, r2, r3, r4, r5, r6, r7, r8, r9, r10, r11, r12));
+}
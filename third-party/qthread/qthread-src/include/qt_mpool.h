@@ -14,6 +14,7 @@ void qt_mpool_free(qt_mpool pool,
 
 qt_mpool qt_mpool_create_aligned(size_t       item_size,
                                  const size_t alignment);
+void qt_mpool_set_guarded(qt_mpool pool);
 void qt_mpool_destroy(qt_mpool pool);
 
 void qt_mpool_subsystem_init(void);
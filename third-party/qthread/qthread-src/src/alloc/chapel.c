@@ -13,8 +13,14 @@ static QINLINE int getpagesize()
 }
 #endif
 
+#include <pthread.h>
+#include <string.h>
+#include <sys/mman.h>
+
 #include <qthread/qthread-int.h> /* for uint_fast16_t */
 
+#include "qt_envariables.h"
+
 #include "chpl-mem.h"
 #include "chpl-linefile-support.h"
 
@@ -40,17 +46,99 @@ void *qt_realloc(void *ptr, size_t size) {
 /* local constants */
 size_t _pagesize = 0;
 
+/* Optional hugepage backing for large aligned allocations.  With
+ * QT_STACK_HUGE_PAGES set, allocations of at least one hugepage --
+ * in practice the task-stack pool's slabs -- are mmap'd with
+ * MAP_HUGETLB instead of going through the Chapel heap, cutting TLB
+ * pressure for large-stack configurations.  Slabs live until qthreads
+ * tears its pools down, so frees are rare; a small locked list maps a
+ * pointer back to its mapping length for munmap().  If no hugepages
+ * are available the allocation silently falls back to the heap. */
+#define HUGEPAGE_SIZE ((size_t)2 << 20)
+
+typedef struct huge_alloc_s {
+  struct huge_alloc_s *next;
+  void                *ptr;
+  size_t               len;
+} huge_alloc_t;
+
+static huge_alloc_t   *huge_allocs = NULL;
+static pthread_mutex_t huge_alloc_lock = PTHREAD_MUTEX_INITIALIZER;
+static int             use_huge_allocs = 0;
+
 void qt_internal_alignment_init(void) {
   _pagesize = getpagesize();
+#ifdef MAP_HUGETLB
+  use_huge_allocs = qt_internal_get_env_bool("STACK_HUGE_PAGES", 0);
+#endif
+}
+
+#ifdef MAP_HUGETLB
+static void *huge_alloc(size_t alloc_size) {
+  size_t len = (alloc_size + HUGEPAGE_SIZE - 1) & ~(HUGEPAGE_SIZE - 1);
+  void *p = mmap(NULL, len, PROT_READ | PROT_WRITE,
+                 MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+  huge_alloc_t *node;
+
+  if (p == MAP_FAILED) {
+    return NULL;
+  }
+
+  node = chpl_mem_alloc(sizeof(*node), CHPL_RT_MD_TASK_LAYER_UNSPEC,
+                        0, CHPL_FILE_IDX_INTERNAL);
+  node->ptr = p;
+  node->len = len;
+  pthread_mutex_lock(&huge_alloc_lock);
+  node->next = huge_allocs;
+  huge_allocs = node;
+  pthread_mutex_unlock(&huge_alloc_lock);
+  return p;
 }
 
+static int huge_free(void *ptr) {
+  huge_alloc_t **cur;
+  huge_alloc_t *node = NULL;
+
+  pthread_mutex_lock(&huge_alloc_lock);
+  for (cur = &huge_allocs; *cur != NULL; cur = &(*cur)->next) {
+    if ((*cur)->ptr == ptr) {
+      node = *cur;
+      *cur = node->next;
+      break;
+    }
+  }
+  pthread_mutex_unlock(&huge_alloc_lock);
+
+  if (node == NULL) {
+    return 0;
+  }
+  munmap(node->ptr, node->len);
+  chpl_mem_free(node, 0, CHPL_FILE_IDX_INTERNAL);
+  return 1;
+}
+#endif
+
 void *qt_internal_aligned_alloc(size_t        alloc_size,
                                      uint_fast16_t alignment) {
+#ifdef MAP_HUGETLB
+  if (use_huge_allocs && alloc_size >= HUGEPAGE_SIZE) {
+    // hugepage-aligned, so any smaller alignment is satisfied too
+    void *p = huge_alloc(alloc_size);
+    if (p != NULL) {
+      return p;
+    }
+  }
+#endif
   return chpl_mem_memalign(alignment, alloc_size, CHPL_RT_MD_TASK_LAYER_UNSPEC,
                            0, CHPL_FILE_IDX_INTERNAL);
 }
 
 void qt_internal_aligned_free(void         *ptr,
                                    uint_fast16_t alignment) {
+#ifdef MAP_HUGETLB
+  if (use_huge_allocs && huge_free(ptr)) {
+    return;
+  }
+#endif
   chpl_mem_free(ptr, 0, CHPL_FILE_IDX_INTERNAL);
 }
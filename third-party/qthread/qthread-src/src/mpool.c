@@ -8,6 +8,7 @@
 #include <stddef.h>                    /* for size_t (according to C89) */
 #include <stdlib.h>                    /* for calloc() and malloc() */
 #include <string.h>
+#include <sys/mman.h>                  /* for mprotect() */
 
 /* External Headers */
 #ifdef QTHREAD_USE_VALGRIND
@@ -55,6 +56,7 @@ struct qt_mpool_s {
     size_t alloc_size;
     size_t items_per_alloc;
     size_t alignment;
+    int    guarded; // items may hold PROT_NONE pages; reopen before freeing
 
 #ifdef TLS
     size_t                        offset;
@@ -217,7 +219,8 @@ qt_mpool INTERNAL qt_mpool_create_aligned(size_t item_size,
     memset(pool->alloc_list, 0, pagesize);
     pool->alloc_list_pos = 0;
 
-    pool->caches = NULL;
+    pool->guarded = 0;
+    pool->caches  = NULL;
     return pool;
 
     qgoto(errexit);
@@ -445,6 +448,18 @@ void INTERNAL qt_mpool_free(qt_mpool pool,
     VALGRIND_MEMPOOL_FREE(pool, mem);
 } /*}}}*/
 
+/* Tell the pool that its items may contain PROT_NONE guard pages that
+ * stay armed while the items sit on free lists (see ALLOC_STACK() /
+ * FREE_STACK() in qthread.c).  The pool never touches anything past an
+ * item's leading free-list node, so this only matters at destroy time,
+ * when each block must be made writable again before it is handed back
+ * to the underlying allocator. */
+void INTERNAL qt_mpool_set_guarded(qt_mpool pool)
+{                                      /*{{{ */
+    qassert_retvoid((pool != NULL));
+    pool->guarded = 1;
+}                                      /*}}} */
+
 void INTERNAL qt_mpool_destroy(qt_mpool pool)
 {                                      /*{{{ */
     qthread_debug(MPOOL_CALLS, "pool:%p\n", pool);
@@ -455,6 +470,12 @@ void INTERNAL qt_mpool_destroy(qt_mpool pool)
         void *p = pool->alloc_list[0];
 
         while (p && i < (pagesize / sizeof(void *) - 1)) {
+            if (pool->guarded) {
+                if (mprotect(p, pool->alloc_size,
+                             PROT_READ | PROT_WRITE) != 0) {
+                    perror("mprotect in qt_mpool_destroy");
+                }
+            }
             qt_mpool_internal_aligned_free(p,
                                            pool->alignment);
             i++;
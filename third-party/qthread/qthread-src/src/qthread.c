@@ -222,6 +222,22 @@ static QINLINE void FREE_STACK(void *t)
 #else /* if defined(UNPOOLED_STACKS) || defined(UNPOOLED) */
 static qt_mpool generic_stack_pool = NULL;
 # ifdef QTHREAD_GUARD_PAGES
+/* Pooled stacks recycle through the mpool without ever going back to
+ * the OS, so the top guard page can stay armed (PROT_NONE) while a
+ * stack sits on a free list; only the bottom guard page has to be
+ * reopened on free, because the mpool stores its free-list node in the
+ * first bytes of the item.  A marker word just above the bottom guard
+ * page, written at free time, tells the next allocation that the top
+ * guard is already armed, so a recycled stack costs two mprotect()
+ * calls per alloc/free cycle instead of four.  If a fresh stack's
+ * uninitialized contents happen to match the marker, the only effect
+ * is that that one stack runs without a top guard.  Memory scribbling
+ * writes over the whole item, armed guard included, so this is
+ * disabled when scribbling is enabled (qt_mpool_destroy() reopens the
+ * armed pages before blocks are handed back to the allocator). */
+#  ifndef QTHREAD_MEMORY_SCRIBBLING
+#   define GUARD_ARMED_MARKER UINT64_C(0x677561726465642e)
+#  endif
 static QINLINE void *ALLOC_STACK(void)
 {                      /*{{{ */
     if (GUARD_PAGES) {
@@ -234,10 +250,15 @@ static QINLINE void *ALLOC_STACK(void)
         if (mprotect(tmp, getpagesize(), PROT_NONE) != 0) {
             perror("mprotect in ALLOC_STACK (1)");
         }
-        if (mprotect(tmp + qlib->qthread_stack_size + getpagesize(),
-                    getpagesize(),
-                    PROT_NONE) != 0) {
-            perror("mprotect in ALLOC_STACK (2)");
+#  ifdef GUARD_ARMED_MARKER
+        if (*(uint64_t *)(tmp + getpagesize()) != GUARD_ARMED_MARKER)
+#  endif
+        {
+            if (mprotect(tmp + qlib->qthread_stack_size + getpagesize(),
+                        getpagesize(),
+                        PROT_NONE) != 0) {
+                perror("mprotect in ALLOC_STACK (2)");
+            }
         }
         return tmp + getpagesize();
     } else {
@@ -253,11 +274,15 @@ static QINLINE void FREE_STACK(void *t)
         if (mprotect(t, getpagesize(), PROT_READ | PROT_WRITE) != 0) {
             perror("mprotect in FREE_STACK (1)");
         }
+#  ifdef GUARD_ARMED_MARKER
+        *(uint64_t *)((uint8_t *)t + getpagesize()) = GUARD_ARMED_MARKER;
+#  else
         if (mprotect(((uint8_t*)t) + qlib->qthread_stack_size + getpagesize(),
                     getpagesize(),
                     PROT_READ | PROT_WRITE) != 0) {
             perror("mprotect in FREE_STACK (2)");
         }
+#  endif
     }
     qt_mpool_free(generic_stack_pool, t);
 }                      /*}}} */
@@ -967,6 +992,7 @@ int API_FUNC qthread_initialize(void)
         generic_stack_pool =
             qt_mpool_create_aligned(qlib->qthread_stack_size + sizeof(struct qthread_runtime_data_s) +
                                     (2 * getpagesize()), getpagesize());
+        qt_mpool_set_guarded(generic_stack_pool);
     } else {
         generic_stack_pool = qt_mpool_create_aligned(qlib->qthread_stack_size + sizeof(struct qthread_runtime_data_s), QTHREAD_STACK_ALIGNMENT);     // stacks on most platforms must be 16-byte aligned (or less)
     }
@@ -0,0 +1,205 @@
+#!/usr/bin/env python3
+
+"""Compiler macro-benchmark harness.
+
+Compiles the pinned programs under test/performance/compiler/ with
+--print-passes-file, collects the per-pass times, AST node counts, and
+memory high-water marks that PhaseTracker reports, writes them out as
+JSON, and compares the totals against a checked-in baseline with
+regression thresholds.
+
+Run via 'make compiler-perf' from $CHPL_HOME, or directly:
+
+    util/test/compilerPerf.py [--update-baseline] [--output results.json]
+
+A compile total or per-pass time is flagged as a regression when it
+exceeds the baseline by both --threshold-pct percent and
+--threshold-secs seconds; the absolute floor keeps jitter in
+sub-second passes from tripping the percentage check.  Exits non-zero
+if any program regressed (or failed to compile).
+"""
+
+import argparse
+import json
+import os
+import re
+import subprocess
+import sys
+import tempfile
+
+# One row of PhaseTracker's --print-passes table: optional pass id, pass
+# name, main/check/clean seconds, time/%, accumulated time/%, AST node
+# count, and resident-set high-water mark in megabytes.
+PASS_ROW_RE = re.compile(
+    r'^\s*(?:\d+\s+)?(\S.*?)\s+'
+    r'(\d+\.\d+)\s+(\d+\.\d+)\s+(\d+\.\d+)\s+'
+    r'(\d+\.\d+)\s+\d+\.\d+\s+'
+    r'(\d+\.\d+)\s+\d+\.\d+\s+'
+    r'(\d+)\s+(\d+\.\d+)\s*$')
+
+TOTAL_ROW_RE = re.compile(
+    r'^\s*total time\s+'
+    r'(\d+\.\d+)\s+(\d+\.\d+)\s+(\d+\.\d+)\s+(\d+\.\d+)\s*$')
+
+
+def find_chpl(chpl_home):
+  chpl = os.environ.get('CHPL')
+  if chpl:
+    return chpl
+  bin_dir = os.path.join(chpl_home, 'bin')
+  if os.path.isdir(bin_dir):
+    for sub in sorted(os.listdir(bin_dir)):
+      cand = os.path.join(bin_dir, sub, 'chpl')
+      if os.access(cand, os.X_OK):
+        return cand
+  return None
+
+
+def parse_passes_file(path):
+  """Parse a --print-passes-file report into the result dict for one
+     program: total seconds, peak RSS, final AST node count, and a
+     per-pass breakdown keyed by pass name."""
+  result = {'total_seconds': None, 'max_rss_mb': 0.0,
+            'ast_nodes': 0, 'passes': {}}
+  with open(path) as f:
+    for line in f:
+      m = TOTAL_ROW_RE.match(line)
+      if m:
+        result['total_seconds'] = float(m.group(4))
+        continue
+      m = PASS_ROW_RE.match(line)
+      if m:
+        name = m.group(1).strip()
+        seconds = float(m.group(5))
+        nodes = int(m.group(7))
+        rss = float(m.group(8))
+        # a pass name can repeat (e.g. parse); accumulate its time
+        entry = result['passes'].setdefault(name, {'seconds': 0.0})
+        entry['seconds'] += seconds
+        result['max_rss_mb'] = max(result['max_rss_mb'], rss)
+        result['ast_nodes'] = max(result['ast_nodes'], nodes)
+  return result
+
+
+def run_one(chpl, src, tmp_dir):
+  base = os.path.splitext(os.path.basename(src))[0]
+  passes_file = os.path.join(tmp_dir, base + '.passes')
+  binary = os.path.join(tmp_dir, base)
+  cmd = [chpl, '--print-passes-file', passes_file, '-o', binary, src]
+  proc = subprocess.run(cmd, stdout=subprocess.PIPE,
+                        stderr=subprocess.STDOUT)
+  if proc.returncode != 0:
+    sys.stderr.write(proc.stdout.decode(errors='replace'))
+    return None
+  return parse_passes_file(passes_file)
+
+
+def check_regression(name, new, old, pct, floor, failures):
+  if old is None or new is None:
+    return
+  if new > old * (1.0 + pct / 100.0) and new - old > floor:
+    failures.append('%s: %.3f -> %.3f (+%.1f%%)'
+                    % (name, old, new, 100.0 * (new - old) / old))
+
+
+def compare(results, baseline, pct, floor):
+  failures = []
+  for prog, new in sorted(results.items()):
+    old = baseline.get('programs', {}).get(prog)
+    if old is None:
+      print('%-24s %8.3f s  %8.1f MB  (no baseline)'
+            % (prog, new['total_seconds'] or 0.0, new['max_rss_mb']))
+      continue
+    print('%-24s %8.3f s  %8.1f MB  (baseline %.3f s)'
+          % (prog, new['total_seconds'] or 0.0, new['max_rss_mb'],
+             old.get('total_seconds') or 0.0))
+    check_regression(prog + ' total', new['total_seconds'],
+                     old.get('total_seconds'), pct, floor, failures)
+    for pname, pnew in new['passes'].items():
+      pold = old.get('passes', {}).get(pname)
+      if pold is not None:
+        check_regression('%s pass %s' % (prog, pname),
+                         pnew['seconds'], pold.get('seconds'),
+                         pct, floor, failures)
+  return failures
+
+
+def main():
+  parser = argparse.ArgumentParser(description=__doc__)
+  parser.add_argument('--threshold-pct', type=float, default=10.0,
+                      help='flag passes that slow down by more than '
+                           'this percentage (default: 10)')
+  parser.add_argument('--threshold-secs', type=float, default=0.5,
+                      help='...and by more than this many seconds '
+                           '(default: 0.5)')
+  parser.add_argument('--output', default=None,
+                      help='also write the collected results as JSON')
+  parser.add_argument('--update-baseline', action='store_true',
+                      help='overwrite the checked-in baseline with '
+                           'this run instead of diffing against it')
+  args = parser.parse_args()
+
+  chpl_home = os.environ.get('CHPL_HOME')
+  if not chpl_home:
+    chpl_home = os.path.abspath(
+        os.path.join(os.path.dirname(__file__), '..', '..'))
+
+  chpl = find_chpl(chpl_home)
+  if chpl is None:
+    sys.stderr.write('compilerPerf: no chpl binary found under %s/bin; '
+                     'build the compiler first (make compiler) or set '
+                     '$CHPL\n' % chpl_home)
+    return 2
+
+  bench_dir = os.path.join(chpl_home, 'test', 'performance', 'compiler')
+  baseline_path = os.path.join(bench_dir, 'baseline.json')
+  programs = sorted(f for f in os.listdir(bench_dir)
+                    if f.endswith('.chpl'))
+  if not programs:
+    sys.stderr.write('compilerPerf: no .chpl programs in %s\n' % bench_dir)
+    return 2
+
+  baseline = {}
+  if os.path.exists(baseline_path):
+    with open(baseline_path) as f:
+      baseline = json.load(f)
+
+  results = {}
+  failed_compiles = []
+  with tempfile.TemporaryDirectory(prefix='chpl-compiler-perf-') as tmp:
+    for prog in programs:
+      name = os.path.splitext(prog)[0]
+      r = run_one(chpl, os.path.join(bench_dir, prog), tmp)
+      if r is None:
+        failed_compiles.append(name)
+      else:
+        results[name] = r
+
+  if args.output:
+    with open(args.output, 'w') as f:
+      json.dump({'programs': results}, f, indent=2, sort_keys=True)
+      f.write('\n')
+
+  if args.update_baseline:
+    with open(baseline_path, 'w') as f:
+      json.dump({'programs': results}, f, indent=2, sort_keys=True)
+      f.write('\n')
+    print('compilerPerf: baseline updated (%s)' % baseline_path)
+    return 1 if failed_compiles else 0
+
+  failures = compare(results, baseline, args.threshold_pct,
+                     args.threshold_secs)
+
+  for name in failed_compiles:
+    failures.append('%s: failed to compile' % name)
+  if failures:
+    print('\ncompilerPerf: REGRESSIONS:')
+    for f in failures:
+      print('  ' + f)
+    return 1
+  print('\ncompilerPerf: no regressions')
+  return 0
+
+
+if __name__ == '__main__':
+  sys.exit(main())